@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <string>
+
+#include <RED4ext/Memory/AllocationTracker.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+using namespace RED4ext::Memory;
+
+constexpr uint32_t Count = 1000;
+
+void AllocateAndFree(IAllocator* aAllocator)
+{
+    AllocationResult allocations[Count];
+    for (uint32_t i = 0; i < Count; ++i)
+    {
+        allocations[i] = aAllocator->Alloc(16 + i % 256);
+        Benchmarks::DoNotOptimize(allocations[i].memory);
+    }
+
+    for (auto& allocation : allocations)
+    {
+        aAllocator->Free(allocation);
+    }
+}
+} // namespace
+
+RED4EXT_BENCHMARK(AllocationTracker_Overhead)
+{
+    auto allocator = Allocator<PoolEngine>::Get();
+
+    // The items are allocations, every one is freed too.
+#ifdef RED4EXT_ALLOCATION_TRACKING
+    Benchmarks::Run("Alloc + Free, not tracked", Count, [allocator] { AllocateAndFree(allocator); });
+
+    AllocationTracker::Enable(0);
+    Benchmarks::Run("Alloc + Free, counted", Count, [allocator] { AllocateAndFree(allocator); });
+
+    for (uint32_t sampleRate : {4096u, 256u, 16u, 1u})
+    {
+        AllocationTracker::SetSampleRate(sampleRate);
+        Benchmarks::Run(("Alloc + Free, sampled 1/" + std::to_string(sampleRate)).c_str(), Count,
+                        [allocator] { AllocateAndFree(allocator); });
+    }
+
+    Benchmarks::Run("Snapshot", 1, [] { Benchmarks::DoNotOptimize(AllocationTracker::Snapshot().sites.size()); });
+
+    AllocationTracker::Disable();
+#else
+    // Without RED4EXT_ALLOCATION_TRACKING the allocators are the baseline, compare with a build that defines it.
+    Benchmarks::Run("Alloc + Free, not built in", Count, [allocator] { AllocateAndFree(allocator); });
+#endif
+}
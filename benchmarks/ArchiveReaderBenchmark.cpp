@@ -0,0 +1,201 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <RED4ext/ArchiveReader.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// The archive is 256 MB by default, set RED4EXT_BENCHMARK_ARCHIVE_MB for larger archives (e.g. 4096).
+uint64_t GetArchiveSize()
+{
+    auto megabytes = std::getenv("RED4EXT_BENCHMARK_ARCHIVE_MB");
+    auto size = megabytes ? std::strtoull(megabytes, nullptr, 10) : 0;
+    return (size ? size : 256) * 1024 * 1024;
+}
+
+ResourcePath GetPath(uint32_t aIndex)
+{
+    return ResourcePath(("base\\benchmark\\file_" + std::to_string(aIndex) + ".mesh").c_str());
+}
+
+// Writes an archive of aFileCount stored files that together hold aSize bytes. The data is streamed to the file, the
+// archive never has to fit into memory.
+bool WriteArchive(const std::filesystem::path& aPath, uint32_t aFileCount, uint64_t aSize)
+{
+    auto file = std::fopen(aPath.string().c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    ArchiveReader::Header header{};
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    std::mt19937 random(1);
+    std::vector<uint8_t> data(2 * aSize / aFileCount, 0xCD);
+
+    std::vector<ArchiveReader::FileEntry> entries(aFileCount);
+    std::vector<ArchiveReader::Segment> segments;
+    segments.reserve(aFileCount);
+
+    uint64_t offset = sizeof(header);
+    for (uint32_t i = 0; i < aFileCount; ++i)
+    {
+        // Sizes vary around the average like the meshes and textures of a real archive.
+        auto size = static_cast<uint32_t>(random() % data.size()) + 1;
+
+        auto& entry = entries[i];
+        entry.path = GetPath(i);
+        entry.inlineSegmentCount = 1;
+        entry.segmentsStart = i;
+        entry.segmentsEnd = i + 1;
+
+        segments.push_back({offset, size, size});
+        std::fwrite(data.data(), 1, size, file);
+        offset += size;
+    }
+
+    header.magic = ArchiveReader::Magic;
+    header.version = 12;
+    header.indexPosition = offset;
+
+    ArchiveReader::IndexHeader index{};
+    index.fileCount = aFileCount;
+    index.segmentCount = aFileCount;
+
+    std::fwrite(&index, sizeof(index), 1, file);
+    std::fwrite(entries.data(), sizeof(ArchiveReader::FileEntry), entries.size(), file);
+    std::fwrite(segments.data(), sizeof(ArchiveReader::Segment), segments.size(), file);
+
+    // ftell is limited to 2 GB on Windows.
+    header.fileSize = offset + sizeof(index) + entries.size() * sizeof(ArchiveReader::FileEntry) +
+                      segments.size() * sizeof(ArchiveReader::Segment);
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    return std::fclose(file) == 0;
+}
+} // namespace
+
+RED4EXT_BENCHMARK(ArchiveReader_SyntheticArchive)
+{
+    constexpr uint32_t FileCount = 100000;
+
+    auto size = GetArchiveSize();
+    auto path = std::filesystem::temp_directory_path() / "RED4ext.ArchiveReaderBenchmark.archive";
+    if (!WriteArchive(path, FileCount, size))
+    {
+        std::printf("Could not write %s\n", path.string().c_str());
+        return;
+    }
+
+    auto name = [&](const char* aName)
+    {
+        return std::string(aName) + ", " + std::to_string(size / (1024 * 1024)) + " MB";
+    };
+
+    Benchmarks::Run(name("Open (map, validate and index 100k files)").c_str(), FileCount,
+                    [&]
+                    {
+                        ArchiveReader reader(path);
+                        Benchmarks::DoNotOptimize(reader.IsOpen());
+                    });
+
+    ArchiveReader reader(path);
+
+    std::mt19937 random(2);
+    std::vector<ResourcePath> hits;
+    std::vector<ResourcePath> misses;
+    for (uint32_t i = 0; i < FileCount; ++i)
+    {
+        hits.push_back(GetPath(static_cast<uint32_t>(random() % FileCount)));
+        misses.push_back(GetPath(FileCount + i));
+    }
+
+    Benchmarks::Run("ArchiveReader::Find, hits", FileCount,
+                    [&]
+                    {
+                        for (auto hit : hits)
+                        {
+                            Benchmarks::DoNotOptimize(reader.Find(hit));
+                        }
+                    });
+
+    Benchmarks::Run("ArchiveReader::Find, misses", FileCount,
+                    [&]
+                    {
+                        for (auto miss : misses)
+                        {
+                            Benchmarks::DoNotOptimize(reader.Find(miss));
+                        }
+                    });
+
+    std::unordered_map<uint64_t, uint32_t> map;
+    for (uint32_t i = 0; i < FileCount; ++i)
+    {
+        map.emplace(GetPath(i).hash, i);
+    }
+
+    Benchmarks::Run("std::unordered_map::find, hits", FileCount,
+                    [&]
+                    {
+                        for (auto hit : hits)
+                        {
+                            Benchmarks::DoNotOptimize(map.find(hit.hash));
+                        }
+                    });
+
+    std::vector<ResourcePath> all;
+    uint64_t extractedSize = 0;
+    for (uint32_t i = 0; i < FileCount; ++i)
+    {
+        all.push_back(GetPath(i));
+        extractedSize += reader.GetExtractedSize(reader.GetFiles().begin()[i]);
+    }
+
+    StoredArchiveDecompressor decompressor;
+
+    Benchmarks::Run(name("ArchiveReader::Extract, all files").c_str(), FileCount,
+                    [&]
+                    {
+                        std::vector<uint8_t> data;
+                        for (auto file : all)
+                        {
+                            reader.Extract(file, decompressor, data);
+                            Benchmarks::DoNotOptimize(data.data());
+                        }
+                    },
+                    extractedSize);
+
+    for (auto threadCount : {2u, 4u, 8u})
+    {
+        auto parallelName = name("ArchiveReader::ExtractParallel, all files") + ", " + std::to_string(threadCount) +
+                            " threads";
+        Benchmarks::Run(parallelName.c_str(), FileCount,
+                        [&]
+                        {
+                            reader.ExtractParallel(
+                                all.data(), all.size(), decompressor,
+                                [](const ArchiveReader::FileEntry&, const uint8_t* aData, size_t)
+                                {
+                                    Benchmarks::DoNotOptimize(aData);
+                                },
+                                threadCount);
+                        },
+                        extractedSize);
+    }
+
+    reader.Close();
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
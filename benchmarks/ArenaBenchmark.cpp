@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <RED4ext/CString.hpp>
+#include <RED4ext/DynArray.hpp>
+#include <RED4ext/HashMap.hpp>
+#include <RED4ext/Memory/Arena.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+using namespace RED4ext::Memory;
+
+// The baseline, every allocation goes to the C runtime. Containers only keep the vtable, the allocator has no state.
+struct MallocAllocator : IAllocator
+{
+    static MallocAllocator* Get()
+    {
+        static MallocAllocator allocator;
+        return &allocator;
+    }
+
+    virtual AllocationResult Alloc(uint64_t aSize) const override
+    {
+        return {std::malloc(aSize), aSize};
+    }
+
+    // The containers ask for at most 8 bytes, what malloc returns is aligned enough.
+    virtual AllocationResult AllocAligned(uint64_t aSize, uint32_t) const override
+    {
+        return Alloc(aSize);
+    }
+
+    virtual AllocationResult Realloc(AllocationResult& aAllocation, uint64_t aSize) const override
+    {
+        return {std::realloc(aAllocation.memory, aSize), aSize};
+    }
+
+    virtual AllocationResult ReallocAligned(AllocationResult& aAllocation, uint64_t aSize, uint32_t) const override
+    {
+        return Realloc(aAllocation, aSize);
+    }
+
+    virtual void Free(AllocationResult& aAllocation) const override
+    {
+        std::free(aAllocation.memory);
+    }
+
+    virtual void sub_28(void*) const override
+    {
+    }
+
+    virtual const uint32_t GetHandle() const override
+    {
+        return 0xFFFFFFFD;
+    }
+
+    using IAllocator::Alloc;
+    using IAllocator::Free;
+};
+
+// The scratch data of a frame: lists of entities, a lookup table and some formatted names.
+constexpr uint32_t ArrayCount = 16;
+constexpr uint32_t ArraySize = 64;
+constexpr uint32_t MapSize = 128;
+constexpr uint32_t StringCount = 32;
+
+struct Names
+{
+    Names()
+    {
+        for (uint32_t i = 0; i < StringCount; ++i)
+        {
+            std::snprintf(values[i], sizeof(values[i]), "base\\characters\\entity_%u.ent", i);
+        }
+    }
+
+    char values[StringCount][64];
+};
+
+const Names g_names;
+
+void RunFrame(IAllocator* aAllocator)
+{
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < ArrayCount; ++i)
+    {
+        DynArray<uint32_t> array(aAllocator);
+        for (uint32_t j = 0; j < ArraySize; ++j)
+        {
+            array.PushBack(i * j);
+        }
+
+        sum += array[ArraySize - 1];
+    }
+
+    HashMap<uint64_t, uint32_t> map(aAllocator);
+    for (uint32_t i = 0; i < MapSize; ++i)
+    {
+        map.Insert(i * 7919, i);
+    }
+
+    sum += *map.Get(7919);
+
+    for (const auto& text : g_names.values)
+    {
+        CString name(text, aAllocator);
+        sum += name.Length();
+    }
+
+    Benchmarks::DoNotOptimize(sum);
+}
+} // namespace
+
+RED4EXT_BENCHMARK(Arena_Frame)
+{
+    // The items are frames.
+    Benchmarks::Run("Frame, MallocAllocator", 1, [] { RunFrame(MallocAllocator::Get()); });
+    Benchmarks::Run("Frame, NativeBackend pool", 1, [] { RunFrame(Memory::DefaultAllocator::Get()); });
+
+    auto& arena = Arena::GetThreadArena();
+    arena.SetPoisoning(false);
+
+    Benchmarks::Run("Frame, ArenaAllocator", 1,
+                    [&]
+                    {
+                        RunFrame(ArenaAllocator::Get());
+                        arena.Reset();
+                    });
+
+    arena.SetPoisoning(true);
+    Benchmarks::Run("Frame, ArenaAllocator, poisoned", 1,
+                    [&]
+                    {
+                        RunFrame(ArenaAllocator::Get());
+                        arena.Reset();
+                    });
+
+    arena.SetPoisoning(false);
+}
+
+RED4EXT_BENCHMARK(Arena_Allocate)
+{
+    constexpr uint32_t Count = 1000;
+
+    Arena arena;
+    Benchmarks::Run("Arena::Allocate, 48 bytes", Count,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            Benchmarks::DoNotOptimize(arena.Allocate(48));
+                        }
+
+                        arena.Reset();
+                    });
+
+    Benchmarks::Run("malloc + free, 48 bytes", Count,
+                    [&]
+                    {
+                        void* blocks[Count];
+                        for (auto& block : blocks)
+                        {
+                            block = std::malloc(48);
+                            Benchmarks::DoNotOptimize(block);
+                        }
+
+                        for (auto block : blocks)
+                        {
+                            std::free(block);
+                        }
+                    });
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/AsyncLogger.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the loader's sink, it only looks at the message so that the formatting is not optimized away.
+std::atomic<uint64_t> g_written = 0;
+
+void Write(PluginHandle, const char* aMessage)
+{
+    g_written.fetch_add(static_cast<uint8_t>(aMessage[0]), std::memory_order_relaxed);
+}
+
+// What v0::Logger::InfoF() does on the calling thread.
+void WriteFormatted(PluginHandle aHandle, const char* aFormat, ...)
+{
+    char message[2048];
+
+    va_list args;
+    va_start(args, aFormat);
+    std::vsnprintf(message, sizeof(message), aFormat, args);
+    va_end(args);
+
+    Write(aHandle, message);
+}
+
+const v0::Logger* GetLogger()
+{
+    static const v0::Logger logger = []
+    {
+        v0::Logger functions{};
+        functions.Info = &Write;
+        functions.InfoF = &WriteFormatted;
+        functions.Warn = &Write;
+        return functions;
+    }();
+
+    return &logger;
+}
+} // namespace
+
+RED4EXT_BENCHMARK(AsyncLogger_Producer)
+{
+    // Per-frame diagnostics of a job worker, a handful of numbers and a name.
+    constexpr uint32_t Count = 1000;
+
+    const char* name = "vehicle_physics";
+    auto handle = PluginHandle{};
+
+    // The ring holds every message of a round, the calls are timed without the consumer's work. It runs on another
+    // thread, or while the logging thread waits in Flush() between the rounds.
+    AsyncLogger logger(GetLogger(), handle, AsyncLogger::OverflowPolicy::Drop, 4 * 1024 * 1024);
+
+    auto measureCalls = [&](const char* aName, auto&& aLog)
+    {
+        constexpr uint32_t Rounds = 50;
+
+        double best = 0.0;
+        for (uint32_t round = 0; round < Rounds; ++round)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < Count; ++i)
+            {
+                aLog(i);
+            }
+
+            auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = round == 0 ? seconds : (std::min)(best, seconds);
+
+            logger.Flush();
+        }
+
+        Benchmarks::Report(aName, best, Count);
+    };
+
+    measureCalls("AsyncLogger::Info, no arguments", [&](uint32_t) { logger.Info("frame finished"); });
+    measureCalls("AsyncLogger::Info, 3 numbers and a string",
+                 [&](uint32_t aIndex) { logger.Info("%s: job %u took %.3f ms (%d items)", name, aIndex, 0.125, 42); });
+
+    if (logger.GetDroppedCount() != 0)
+    {
+        std::printf("%llu messages were dropped, the results are not valid\n",
+                    static_cast<unsigned long long>(logger.GetDroppedCount()));
+    }
+
+    Benchmarks::Run("v0::Logger::InfoF, 3 numbers and a string", Count,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            GetLogger()->InfoF(handle, "%s: job %u took %.3f ms (%d items)", name, i, 0.125, 42);
+                        }
+                    });
+
+    Benchmarks::DoNotOptimize(g_written);
+}
+
+RED4EXT_BENCHMARK(AsyncLogger_Throughput)
+{
+    // The most messages the consumer writes, from logging them until the last one reached the sink.
+    constexpr uint32_t Count = 100000;
+
+    for (uint32_t threadCount : {1u, 4u})
+    {
+        AsyncLogger logger(GetLogger(), PluginHandle{}, AsyncLogger::OverflowPolicy::Block, 64 * 1024);
+
+        Benchmarks::Run(("AsyncLogger, " + std::to_string(threadCount) + " producer(s)").c_str(), Count,
+                        [&]
+                        {
+                            std::vector<std::thread> threads;
+                            for (uint32_t thread = 0; thread < threadCount; ++thread)
+                            {
+                                threads.emplace_back(
+                                    [&logger, threadCount]
+                                    {
+                                        for (uint32_t i = 0; i < Count / threadCount; ++i)
+                                        {
+                                            logger.Info("job %u took %.3f ms (%d items)", i, 0.125, 42);
+                                        }
+                                    });
+                            }
+
+                            for (auto& thread : threads)
+                            {
+                                thread.join();
+                            }
+
+                            logger.Flush();
+                        });
+
+        Benchmarks::DoNotOptimize(logger.GetDroppedCount());
+    }
+}
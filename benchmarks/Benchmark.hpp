@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace RED4ext::Benchmarks
+{
+using BenchmarkFunc = void (*)();
+
+struct BenchmarkInfo
+{
+    const char* name;
+    BenchmarkFunc func;
+};
+
+std::vector<BenchmarkInfo>& GetBenchmarks();
+
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char* aName, BenchmarkFunc aFunc)
+    {
+        GetBenchmarks().push_back({aName, aFunc});
+    }
+};
+
+/**
+ * @brief Writes a result line, the time per item and the throughput.
+ * @param aName The name of the measurement.
+ * @param aSecondsPerCall The time of one call of the measured function.
+ * @param aItemsPerCall The items processed by one call, e.g. the elements of a loop.
+ * @param aBytesPerCall The bytes processed by one call, 0 if the throughput in bytes does not matter.
+ */
+void Report(const char* aName, double aSecondsPerCall, uint64_t aItemsPerCall, uint64_t aBytesPerCall = 0);
+
+/**
+ * @brief Forces the compiler to materialize the value, the computation of an unused result is not optimized away.
+ */
+void Escape(const void* aPointer);
+
+template<typename T>
+void DoNotOptimize(const T& aValue)
+{
+    Escape(&aValue);
+}
+
+/**
+ * @brief Calls the function repeatedly and returns the best time of a call.
+ *
+ * The calls are timed in rounds of at least MinRoundTime, the fastest of the rounds is used to filter out noise from
+ * other processes.
+ */
+template<typename F>
+double Measure(F&& aFunc)
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto MinRoundTime = std::chrono::milliseconds(50);
+    constexpr auto Rounds = 5;
+
+    uint64_t calls = 1;
+    auto best = 0.0;
+
+    for (auto round = 0; round < Rounds;)
+    {
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < calls; ++i)
+        {
+            aFunc();
+        }
+        auto elapsed = Clock::now() - start;
+
+        if (elapsed < MinRoundTime)
+        {
+            // Too short to be measured reliably, the first rounds find the number of calls.
+            calls *= 2;
+            continue;
+        }
+
+        auto seconds = std::chrono::duration<double>(elapsed).count() / static_cast<double>(calls);
+        best = round == 0 ? seconds : (seconds < best ? seconds : best);
+        ++round;
+    }
+
+    return best;
+}
+
+/**
+ * @brief Measures the function and reports the result.
+ */
+template<typename F>
+void Run(const char* aName, uint64_t aItemsPerCall, F&& aFunc, uint64_t aBytesPerCall = 0)
+{
+    Report(aName, Measure(aFunc), aItemsPerCall, aBytesPerCall);
+}
+} // namespace RED4ext::Benchmarks
+
+/**
+ * @brief Defines a benchmark, it is run by the benchmark executable the file is linked into.
+ *
+ * @example
+ *
+ * RED4EXT_BENCHMARK(DynArray_PushBack)
+ * {
+ *     RED4ext::Benchmarks::Run("PushBack x1000", 1000,
+ *                              []
+ *                              {
+ *                                  RED4ext::DynArray<int32_t> array;
+ *                                  for (int32_t i = 0; i < 1000; ++i)
+ *                                  {
+ *                                      array.PushBack(i);
+ *                                  }
+ *
+ *                                  RED4ext::Benchmarks::DoNotOptimize(array);
+ *                              });
+ * }
+ */
+#define RED4EXT_BENCHMARK(aName)                                                                                       \
+    static void aName();                                                                                               \
+    static const RED4ext::Benchmarks::BenchmarkRegistrar aName##_Registrar(#aName, &aName);                            \
+    static void aName()
@@ -0,0 +1,157 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include <RED4ext/Callback.hpp>
+#include <RED4ext/CallbackArena.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// The state a plugin captures for a load callback, too large for the inline buffer.
+struct Context
+{
+    std::array<int64_t, 12> values;
+};
+
+template<SpillPolicy Policy>
+using Sum = Callback<int64_t (*)(int64_t), DefaultFixedCallbackBufferSize, Policy>;
+
+auto MakeClosure(const Context& aContext)
+{
+    return [aContext](int64_t aValue) { return aValue + aContext.values[11]; };
+}
+
+constexpr uint32_t Count = 1000;
+} // namespace
+
+RED4EXT_BENCHMARK(Callback_Spill)
+{
+    Context context{};
+    context.values[11] = 1;
+
+    // What plugins do without a spill policy: box the state by hand and capture the pointer.
+    Benchmarks::Run("Manual heap box, create + invoke + destroy", 1,
+                    [&]
+                    {
+                        auto box = std::make_unique<Context>(context);
+                        Sum<SpillPolicy::Forbid> callback([box = box.get()](int64_t aValue)
+                                                          { return aValue + box->values[11]; });
+                        Benchmarks::DoNotOptimize(callback(1));
+                    });
+
+    Benchmarks::Run("SpillPolicy::Heap, create + invoke + destroy", 1,
+                    [&]
+                    {
+                        Sum<SpillPolicy::Heap> callback(MakeClosure(context));
+                        Benchmarks::DoNotOptimize(callback(1));
+                    });
+
+    Benchmarks::Run("SpillPolicy::Pool, create + invoke + destroy", 1,
+                    [&]
+                    {
+                        Sum<SpillPolicy::Pool> callback(MakeClosure(context));
+                        Benchmarks::DoNotOptimize(callback(1));
+                    });
+
+    // A frame's worth of registrations, released by one reset.
+    CallbackArena arena;
+    Benchmarks::Run("CallbackArena, create + invoke + destroy", Count,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            auto callback = arena.Create<Sum<SpillPolicy::Forbid>>(MakeClosure(context));
+                            Benchmarks::DoNotOptimize(callback(1));
+                        }
+
+                        arena.Reset();
+                    });
+
+    // Creating and invoking callbacks that stay alive, e.g. the registrations of one frame.
+    Benchmarks::Run("Manual heap box, 1000 alive", Count,
+                    [&]
+                    {
+                        std::unique_ptr<Context> boxes[Count];
+                        alignas(Sum<SpillPolicy::Forbid>) uint8_t storage[Count][sizeof(Sum<SpillPolicy::Forbid>)];
+
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            boxes[i] = std::make_unique<Context>(context);
+                            new (storage[i]) Sum<SpillPolicy::Forbid>([box = boxes[i].get()](int64_t aValue)
+                                                                      { return aValue + box->values[11]; });
+                        }
+
+                        for (auto& callback : storage)
+                        {
+                            auto& typed = *reinterpret_cast<Sum<SpillPolicy::Forbid>*>(callback);
+                            Benchmarks::DoNotOptimize(typed(1));
+                            typed.~Sum<SpillPolicy::Forbid>();
+                        }
+                    });
+
+    auto runAlive = [&](const char* aName, auto aCreate)
+    {
+        using C = decltype(aCreate());
+
+        Benchmarks::Run(aName, Count,
+                        [&]
+                        {
+                            alignas(C) uint8_t storage[Count][sizeof(C)];
+                            for (uint32_t i = 0; i < Count; ++i)
+                            {
+                                new (storage[i]) C(aCreate());
+                            }
+
+                            for (auto& callback : storage)
+                            {
+                                auto& typed = *reinterpret_cast<C*>(callback);
+                                Benchmarks::DoNotOptimize(typed(1));
+                                typed.~C();
+                            }
+
+                            arena.Reset();
+                        });
+    };
+
+    runAlive("SpillPolicy::Heap, 1000 alive", [&] { return Sum<SpillPolicy::Heap>(MakeClosure(context)); });
+    runAlive("SpillPolicy::Pool, 1000 alive", [&] { return Sum<SpillPolicy::Pool>(MakeClosure(context)); });
+    runAlive("CallbackArena, 1000 alive",
+             [&] { return arena.Create<Sum<SpillPolicy::Forbid>>(MakeClosure(context)); });
+}
+
+RED4EXT_BENCHMARK(Callback_Invoke)
+{
+    Context context{};
+    context.values[11] = 1;
+
+    int64_t bias = 1;
+    Sum<SpillPolicy::Forbid> inlined([bias](int64_t aValue) { return aValue + bias; });
+
+    auto box = std::make_unique<Context>(context);
+    Sum<SpillPolicy::Forbid> boxed([box = box.get()](int64_t aValue) { return aValue + box->values[11]; });
+
+    Sum<SpillPolicy::Pool> pooled(MakeClosure(context));
+
+    auto invoke = [](const char* aName, const auto& aCallback)
+    {
+        Benchmarks::Run(aName, Count,
+                        [&]
+                        {
+                            int64_t sum = 0;
+                            for (uint32_t i = 0; i < Count; ++i)
+                            {
+                                sum += aCallback(static_cast<int64_t>(i));
+                            }
+
+                            Benchmarks::DoNotOptimize(sum);
+                        });
+    };
+
+    invoke("Invoke, inline closure", inlined);
+    invoke("Invoke, manual heap box", boxed);
+    invoke("Invoke, SpillPolicy::Pool", pooled);
+}
@@ -0,0 +1,180 @@
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <RED4ext/CharConv.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+std::vector<ItemID> MakeItemIDs(size_t aCount)
+{
+    std::mt19937_64 random(1);
+
+    std::vector<ItemID> ids(aCount);
+    for (auto& id : ids)
+    {
+        id.tdbid = TweakDBID(random());
+        id.rngSeed = static_cast<uint32_t>(random());
+        id.uniqueCounter = static_cast<uint16_t>(random());
+        id.structure = static_cast<uint8_t>(random());
+        id.flags = static_cast<uint8_t>(random());
+    }
+
+    return ids;
+}
+
+// What loot logging did before, a std::string per ID that is appended to the output.
+std::string FormatToString(const ItemID& aID)
+{
+    uint32_t offset = (aID.tdbid.name.tdbOffsetBE[0] << 16) | (aID.tdbid.name.tdbOffsetBE[1] << 8) |
+                      aID.tdbid.name.tdbOffsetBE[2];
+
+    char buffer[64];
+    auto length = std::snprintf(buffer, sizeof(buffer), "%08" PRIX32 ":%02X:%06" PRIX32 ":%08" PRIX32 ":%04X:%02X:%02X",
+                                aID.tdbid.name.hash, aID.tdbid.name.length, offset, aID.rngSeed, aID.uniqueCounter,
+                                aID.structure, aID.flags);
+
+    return std::string(buffer, static_cast<size_t>(length));
+}
+} // namespace
+
+RED4EXT_BENCHMARK(CharConv_ItemID)
+{
+    // About what a busy frame of loot and telemetry logging formats.
+    constexpr size_t Count = 10000;
+
+    auto ids = MakeItemIDs(Count);
+    std::vector<char> text((CharsSize<ItemID> + 1) * Count);
+
+    Benchmarks::Run("ToChars batch, ItemID", Count,
+                    [&]
+                    {
+                        auto result = ToChars(text.data(), text.data() + text.size(),
+                                              Span<const ItemID>(ids.data(), ids.size()));
+                        Benchmarks::DoNotOptimize(result.ptr);
+                    },
+                    text.size());
+
+    Benchmarks::Run("ToChars per value, ItemID", Count,
+                    [&]
+                    {
+                        auto out = text.data();
+                        auto last = text.data() + text.size();
+
+                        for (const auto& id : ids)
+                        {
+                            out = ToChars(out, last, id).ptr;
+                            *out++ = '\n';
+                        }
+
+                        Benchmarks::DoNotOptimize(out);
+                    },
+                    text.size());
+
+    Benchmarks::Run("snprintf and std::string, ItemID", Count,
+                    [&]
+                    {
+                        std::string output;
+                        for (const auto& id : ids)
+                        {
+                            output += FormatToString(id);
+                            output += '\n';
+                        }
+
+                        Benchmarks::DoNotOptimize(output.data());
+                    },
+                    text.size());
+
+    ToChars(text.data(), text.data() + text.size(), Span<const ItemID>(ids.data(), ids.size()));
+    std::vector<ItemID> parsed(Count);
+
+    Benchmarks::Run("FromChars batch, ItemID", Count,
+                    [&]
+                    {
+                        auto result = FromChars(text.data(), text.data() + text.size(),
+                                                Span<ItemID>(parsed.data(), parsed.size()));
+                        Benchmarks::DoNotOptimize(result.ptr);
+                    },
+                    text.size());
+
+    Benchmarks::Run("sscanf, ItemID", Count,
+                    [&]
+                    {
+                        uint32_t sum = 0;
+                        for (size_t i = 0; i < Count; ++i)
+                        {
+                            // sscanf() measures the length of its input, give it one line at a time.
+                            char line[CharsSize<ItemID> + 1] = {};
+                            std::memcpy(line, text.data() + i * (CharsSize<ItemID> + 1), CharsSize<ItemID>);
+
+                            uint32_t hash, length, offset, seed, counter, structure, flags;
+                            std::sscanf(line,
+                                        "%8" SCNx32 ":%2" SCNx32 ":%6" SCNx32 ":%8" SCNx32 ":%4" SCNx32 ":%2" SCNx32
+                                        ":%2" SCNx32,
+                                        &hash, &length, &offset, &seed, &counter, &structure, &flags);
+                            sum += hash + seed + flags;
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    },
+                    text.size());
+}
+
+RED4EXT_BENCHMARK(CharConv_Hashes)
+{
+    constexpr size_t Count = 10000;
+
+    std::mt19937_64 random(2);
+    std::vector<TweakDBID> tdbids(Count);
+    std::vector<CName> names(Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        tdbids[i] = TweakDBID(random());
+        names[i] = CName(random());
+    }
+
+    std::vector<char> text((CharsSize<TweakDBID> + 1) * Count);
+
+    Benchmarks::Run("ToChars batch, TweakDBID", Count,
+                    [&]
+                    {
+                        auto result = ToChars(text.data(), text.data() + text.size(),
+                                              Span<const TweakDBID>(tdbids.data(), tdbids.size()));
+                        Benchmarks::DoNotOptimize(result.ptr);
+                    });
+
+    Benchmarks::Run("ToChars batch, CName", Count,
+                    [&]
+                    {
+                        auto result = ToChars(text.data(), text.data() + text.size(),
+                                              Span<const CName>(names.data(), names.size()));
+                        Benchmarks::DoNotOptimize(result.ptr);
+                    });
+
+    Benchmarks::Run("snprintf, CName", Count,
+                    [&]
+                    {
+                        auto out = text.data();
+                        for (const auto& name : names)
+                        {
+                            out += std::snprintf(out, CharsSize<CName> + 2, "%016" PRIX64 "\n", name.hash);
+                        }
+
+                        Benchmarks::DoNotOptimize(out);
+                    });
+
+    Benchmarks::Run("FromChars batch, CName", Count,
+                    [&]
+                    {
+                        auto result =
+                            FromChars(text.data(), text.data() + text.size(), Span<CName>(names.data(), names.size()));
+                        Benchmarks::DoNotOptimize(result.ptr);
+                    });
+}
@@ -0,0 +1,227 @@
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <RED4ext/ClassLayout.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/RTTITypes.hpp>
+#include <RED4ext/Relocation.hpp>
+#include <RED4ext/Scripting/CProperty.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Properties add their names to the name pool, only the hash is needed here.
+CName* NamePoolAdd(CName& aResult, const char* aText)
+{
+    aResult = aText ? CName(aText) : CName();
+    return &aResult;
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveNamePool(uint32_t aHash)
+{
+    if (aHash == Detail::AddressHashes::CNamePool_AddCstr)
+    {
+        return reinterpret_cast<uintptr_t>(&NamePoolAdd);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// Compares bytewise through a virtual call, like the game's fundamental types.
+struct StandInType : CBaseRTTIType
+{
+    StandInType(ERTTIType aType, uint32_t aSize, CName aName = {})
+        : type(aType)
+        , size(aSize)
+        , name(aName)
+    {
+    }
+
+    CName GetName() const override
+    {
+        return name;
+    }
+
+    uint32_t GetSize() const override
+    {
+        return size;
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return 1;
+    }
+
+    ERTTIType GetType() const override
+    {
+        return type;
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance aLhs, const ScriptInstance aRhs, uint32_t) override
+    {
+        return std::memcmp(aLhs, aRhs, size) == 0;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+
+    ERTTIType type;
+    uint32_t size;
+    CName name;
+};
+
+struct StandInClass : CClass
+{
+    explicit StandInClass(size_t aSize)
+        : CClass(CName(), static_cast<uint32_t>(aSize), {})
+    {
+    }
+
+    void AddProperty(CBaseRTTIType* aType, const char* aName, size_t aOffset)
+    {
+        properties.emplace_back(new CProperty(aType, aName, this, static_cast<uint32_t>(aOffset)));
+        props.PushBack(properties.back().get());
+    }
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+    void ConstructCls(ScriptInstance) const override {}
+    void DestructCls(ScriptInstance) const override {}
+
+    void* AllocMemory() const override
+    {
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<CProperty>> properties;
+};
+
+// 24 numbers, 4 names, 2 handles and 2 strings, a typical gameplay component.
+struct Object
+{
+    float numbers[24];
+    uint64_t names[4];
+    void* handles[2][2];
+    uint8_t strings[2][24];
+};
+
+// Compares every property through its type, the way the game does without a layout.
+bool EqualPerProperty(const CClass& aClass, uint8_t* aLhs, uint8_t* aRhs)
+{
+    for (auto prop : aClass.props)
+    {
+        if (!prop->type->IsEqual(aLhs + prop->valueOffset, aRhs + prop->valueOffset))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint32_t DiffPerProperty(const CClass& aClass, uint8_t* aLhs, uint8_t* aRhs, std::vector<uint32_t>& aFields)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < aClass.props.size; ++i)
+    {
+        auto prop = aClass.props[i];
+        if (!prop->type->IsEqual(aLhs + prop->valueOffset, aRhs + prop->valueOffset))
+        {
+            aFields.push_back(i);
+            ++count;
+        }
+    }
+
+    return count;
+}
+} // namespace
+
+RED4EXT_BENCHMARK(ClassLayout_Compare)
+{
+    g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveNamePool);
+
+    StandInType number(ERTTIType::Fundamental, 4);
+    StandInType name(ERTTIType::Name, 8);
+    StandInType handle(ERTTIType::Handle, 16);
+    StandInType string(ERTTIType::Simple, 24, "String");
+
+    StandInClass cls(sizeof(Object));
+    for (auto i = 0; i < 24; ++i)
+    {
+        cls.AddProperty(&number, ("number" + std::to_string(i)).c_str(), offsetof(Object, numbers) + i * sizeof(float));
+    }
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        cls.AddProperty(&name, ("name" + std::to_string(i)).c_str(), offsetof(Object, names) + i * sizeof(uint64_t));
+    }
+
+    cls.AddProperty(&handle, "handle0", offsetof(Object, handles));
+    cls.AddProperty(&handle, "handle1", offsetof(Object, handles) + sizeof(Object::handles[0]));
+    cls.AddProperty(&string, "string0", offsetof(Object, strings));
+    cls.AddProperty(&string, "string1", offsetof(Object, strings) + sizeof(Object::strings[0]));
+
+    auto layout = ClassLayout::Get(&cls);
+
+    Object lhs{};
+    Object equal{};
+    Object changed{};
+    changed.numbers[20] = 1.0f;
+
+    auto lhsPtr = reinterpret_cast<uint8_t*>(&lhs);
+    auto equalPtr = reinterpret_cast<uint8_t*>(&equal);
+    auto changedPtr = reinterpret_cast<uint8_t*>(&changed);
+
+    Benchmarks::Run("Equal per property, equal instances", cls.props.size,
+                    [&]
+                    {
+                        Benchmarks::DoNotOptimize(EqualPerProperty(cls, lhsPtr, equalPtr));
+                    });
+
+    Benchmarks::Run("ClassLayout::Equal, equal instances", cls.props.size,
+                    [&]
+                    {
+                        Benchmarks::DoNotOptimize(layout->Equal(lhsPtr, equalPtr));
+                    });
+
+    std::vector<uint32_t> fields;
+    fields.reserve(cls.props.size);
+
+    Benchmarks::Run("Diff per property, one field changed", cls.props.size,
+                    [&]
+                    {
+                        fields.clear();
+                        Benchmarks::DoNotOptimize(DiffPerProperty(cls, lhsPtr, changedPtr, fields));
+                    });
+
+    Benchmarks::Run("ClassLayout::Diff, one field changed", cls.props.size,
+                    [&]
+                    {
+                        fields.clear();
+                        Benchmarks::DoNotOptimize(layout->Diff(lhsPtr, changedPtr, fields));
+                    });
+
+    Benchmarks::Run("ClassLayout::Hash", cls.props.size,
+                    [&]
+                    {
+                        Benchmarks::DoNotOptimize(layout->Hash(lhsPtr));
+                    });
+}
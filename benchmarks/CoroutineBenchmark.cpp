@@ -0,0 +1,254 @@
+#include <string>
+#include <vector>
+
+// ResourceLoader.hpp is not self-contained, its CResource include needs the loader already.
+#include <RED4ext/RED4ext.hpp>
+
+#include <RED4ext/Coroutine.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// What code does without coroutines: every step is a closure dispatched on a new queue that waits for the job.
+struct CallbackStep
+{
+    void operator()() const;
+
+    JobHandle job;
+    uint32_t remaining;
+    uint32_t* finished;
+};
+
+void CallbackStep::operator()() const
+{
+    if (remaining == 0)
+    {
+        ++*finished;
+        return;
+    }
+
+    JobQueue queue;
+    queue.Wait(job);
+    queue.Dispatch(CallbackStep{job, remaining - 1, finished});
+}
+
+// The game's handler also sets a job parameter in the game's thread local storage, which does not exist here. Run the
+// closure directly and release it like the handler does.
+template<typename L>
+bool RunClosure(const JobInstance& aJob)
+{
+    using Closure = JobClosure<L>;
+
+    if (aJob.handler != reinterpret_cast<JobInstance::HandleFunc<void>>(&Closure::HandleTarget))
+    {
+        return false;
+    }
+
+    auto closure = static_cast<L*>(aJob.target);
+    (*closure)();
+    Memory::Delete<typename Closure::AllocatorType>(closure);
+
+    return true;
+}
+
+// Stands in for the game's job system. Handles are reference counted through unk1C like in the game and every handle
+// counts as completed, dispatched jobs are queued and run by Drain() in order. The scheduling of the job system is not
+// part of the measurement.
+std::vector<JobInstance> g_jobs;
+
+void Drain()
+{
+    for (size_t i = 0; i < g_jobs.size(); ++i)
+    {
+        auto job = g_jobs[i];
+        [[maybe_unused]] auto isKnown = RunClosure<Detail::ResumeJob>(job) || RunClosure<CallbackStep>(job);
+    }
+
+    g_jobs.clear();
+}
+
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->internal->unk1C, static_cast<uint32_t>(-1)) == 1)
+    {
+        delete aHandle->internal;
+    }
+
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle&)
+{
+    ++aHandle->internal->unk00;
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    return aQueue;
+}
+
+void DestructJobQueue(JobQueue*)
+{
+}
+
+uint32_t DispatchJob(void*, const JobInstance& aJob, uint8_t, JobInternalHandle*, JobInternalHandle*)
+{
+    g_jobs.push_back(aJob);
+    return 0;
+}
+
+void SyncWaitJobQueue(JobQueue*)
+{
+}
+
+void* g_jobDispatcher = nullptr;
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveScheduler(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_SyncWait:
+        return reinterpret_cast<uintptr_t>(&SyncWaitJobQueue);
+    case JobDispatcher_DispatchJob:
+        return reinterpret_cast<uintptr_t>(&DispatchJob);
+    case JobDispatcher:
+        return reinterpret_cast<uintptr_t>(&g_jobDispatcher);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+void InstallScheduler()
+{
+    [[maybe_unused]] static const auto isInstalled = []
+    {
+        g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveScheduler);
+        return true;
+    }();
+}
+
+Task<uint32_t> Increment(uint32_t aValue)
+{
+    co_return aValue + 1;
+}
+
+Task<void> AwaitSteps(const JobHandle& aJob, uint32_t aSteps, uint32_t& aFinished)
+{
+    for (uint32_t i = 0; i < aSteps; ++i)
+    {
+        co_await aJob;
+    }
+
+    ++aFinished;
+}
+
+Task<void> AwaitTasks(uint32_t aCount, uint32_t& aResult)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        value = co_await Increment(value);
+    }
+
+    aResult = value;
+}
+
+Task<void> AwaitAll(uint32_t aCount, uint32_t& aFinished)
+{
+    std::vector<Task<uint32_t>> tasks;
+    tasks.reserve(aCount);
+
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        tasks.push_back(Increment(i));
+    }
+
+    auto values = co_await WhenAll(std::move(tasks));
+    aFinished += static_cast<uint32_t>(values.size());
+}
+} // namespace
+
+RED4EXT_BENCHMARK(Coroutine_Steps)
+{
+    InstallScheduler();
+
+    // A loading pipeline that waits on a job between each of its steps.
+    constexpr uint32_t Steps = 16;
+
+    JobHandle job;
+    uint32_t finished = 0;
+
+    Benchmarks::Run("co_await JobHandle, per step", Steps,
+                    [&]
+                    {
+                        Spawn(AwaitSteps(job, Steps, finished));
+                        Drain();
+                    });
+
+    Benchmarks::Run("Nested job closures, per step", Steps,
+                    [&]
+                    {
+                        JobQueue queue;
+                        queue.Dispatch(CallbackStep{job, Steps, &finished});
+                        Drain();
+                    });
+
+    Benchmarks::DoNotOptimize(finished);
+}
+
+RED4EXT_BENCHMARK(Coroutine_Tasks)
+{
+    InstallScheduler();
+
+    // Awaiting a task runs it inline, this is the cost of its frame and of the symmetric transfers.
+    constexpr uint32_t Count = 1000;
+
+    uint32_t result = 0;
+    Benchmarks::Run("co_await Task<uint32_t>, per task", Count,
+                    [&]
+                    {
+                        Spawn(AwaitTasks(Count, result));
+                        Drain();
+                    });
+
+    // Every task is started from its own job.
+    constexpr uint32_t TaskCount = 64;
+
+    uint32_t finished = 0;
+    Benchmarks::Run((std::string("WhenAll, ") + std::to_string(TaskCount) + " tasks, per task").c_str(), TaskCount,
+                    [&]
+                    {
+                        Spawn(AwaitAll(TaskCount, finished));
+                        Drain();
+                    });
+
+    Benchmarks::DoNotOptimize(result);
+    Benchmarks::DoNotOptimize(finished);
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <RED4ext/NativeTypes.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// What a mod does without Evaluate(): walk the keys from the front and interpolate linearly.
+float EvaluateByScan(const CurveData<float>& aCurve, float aPoint)
+{
+    auto size = aCurve.GetSize();
+    auto first = aCurve.GetPoint(0);
+    if (aPoint <= first.point)
+    {
+        return first.value;
+    }
+
+    for (uint32_t i = 1; i < size; ++i)
+    {
+        auto next = aCurve.GetPoint(i);
+        if (aPoint < next.point)
+        {
+            auto previous = aCurve.GetPoint(i - 1);
+            auto t = (aPoint - previous.point) / (next.point - previous.point);
+            return previous.value + (next.value - previous.value) * t;
+        }
+    }
+
+    return aCurve.GetPoint(size - 1).value;
+}
+
+void FillCurve(CurveData<float>& aCurve, uint32_t aSize)
+{
+    std::mt19937 random(aSize);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    aCurve.Resize(aSize);
+    for (uint32_t i = 0; i < aSize; ++i)
+    {
+        aCurve.SetPoint(i, static_cast<float>(i), value(random));
+    }
+}
+} // namespace
+
+RED4EXT_BENCHMARK(CurveData_Evaluate)
+{
+    constexpr uint32_t QueryCount = 4096;
+
+    // From a short easing curve to a long recorded animation track.
+    for (uint32_t size : {4u, 64u, 4096u})
+    {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> distribution(0.0f, static_cast<float>(size - 1));
+
+        std::vector<float> randomPoints(QueryCount);
+        for (auto& point : randomPoints)
+        {
+            point = distribution(random);
+        }
+
+        // Sequential sampling, e.g. a curve played back frame by frame.
+        auto sortedPoints = randomPoints;
+        std::sort(sortedPoints.begin(), sortedPoints.end());
+
+        std::vector<float> results(QueryCount);
+
+        for (auto type : {curve::EInterpolationType::EIT_Linear, curve::EInterpolationType::EIT_Hermite})
+        {
+            CurveData<float> curve{};
+            curve.interpolationType = type;
+            FillCurve(curve, size);
+
+            auto suffix = std::string(type == curve::EInterpolationType::EIT_Linear ? ", linear, " : ", hermite, ") +
+                          std::to_string(size) + " keys";
+
+            for (const auto* points : {&randomPoints, &sortedPoints})
+            {
+                auto name = (points == &randomPoints ? " random" : " sorted") + suffix;
+
+                Benchmarks::Run(("Evaluate," + name).c_str(), QueryCount,
+                                [&]
+                                {
+                                    for (uint32_t i = 0; i < QueryCount; ++i)
+                                    {
+                                        results[i] = curve.Evaluate((*points)[i]);
+                                    }
+
+                                    Benchmarks::DoNotOptimize(results.data());
+                                });
+
+                Benchmarks::Run(("Evaluate with hint," + name).c_str(), QueryCount,
+                                [&]
+                                {
+                                    uint32_t hint = 0;
+                                    for (uint32_t i = 0; i < QueryCount; ++i)
+                                    {
+                                        results[i] = curve.Evaluate((*points)[i], hint);
+                                    }
+
+                                    Benchmarks::DoNotOptimize(results.data());
+                                });
+
+                Benchmarks::Run(("EvaluateMany," + name).c_str(), QueryCount,
+                                [&]
+                                {
+                                    curve.EvaluateMany(Span<const float>(points->data(), QueryCount),
+                                                       Span<float>(results.data(), QueryCount));
+                                    Benchmarks::DoNotOptimize(results.data());
+                                });
+
+                if (type == curve::EInterpolationType::EIT_Linear)
+                {
+                    Benchmarks::Run(("Linear scan," + name).c_str(), QueryCount,
+                                    [&]
+                                    {
+                                        for (uint32_t i = 0; i < QueryCount; ++i)
+                                        {
+                                            results[i] = EvaluateByScan(curve, (*points)[i]);
+                                        }
+
+                                        Benchmarks::DoNotOptimize(results.data());
+                                    });
+                }
+            }
+        }
+    }
+}
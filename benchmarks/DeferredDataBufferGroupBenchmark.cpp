@@ -0,0 +1,208 @@
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/DeferredDataBufferGroup.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// What DeferredDataBufferToken::OnLoaded() dispatches, with a name so the stand-in dispatcher can run it.
+struct OnLoadedJob
+{
+    void operator()() const
+    {
+        callback(self->buffer);
+    }
+
+    SharedPtr<DeferredDataBufferToken> self;
+    DeferredDataBufferToken::LoadedCallback callback;
+};
+
+// The game's handler also sets a job parameter in the game's thread local storage, which does not exist here. Run the
+// closure directly and release it like the handler does.
+template<typename L>
+bool RunClosure(const JobInstance& aJob)
+{
+    using Closure = JobClosure<L>;
+
+    if (aJob.handler != reinterpret_cast<JobInstance::HandleFunc<void>>(&Closure::HandleTarget))
+    {
+        return false;
+    }
+
+    auto closure = static_cast<L*>(aJob.target);
+    (*closure)();
+    Memory::Delete<typename Closure::AllocatorType>(closure);
+
+    return true;
+}
+
+// Stands in for the game's job system. Handles are reference counted through unk1C like in the game, the loads finish
+// right away and dispatched jobs run on the spot, the scheduling of the job system is not part of the measurement.
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->internal->unk1C, static_cast<uint32_t>(-1)) == 1)
+    {
+        delete aHandle->internal;
+    }
+
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle&)
+{
+    ++aHandle->internal->unk00;
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    return aQueue;
+}
+
+void DestructJobQueue(JobQueue*)
+{
+}
+
+JobHandle* CaptureJobQueue(JobQueue* aQueue, JobHandle* aHandle)
+{
+    ReleaseJobHandle(aHandle);
+
+    aHandle->internal = aQueue->unk18.internal;
+    InterlockedExchangeAdd(&aHandle->internal->unk1C, static_cast<uint32_t>(1));
+
+    return aHandle;
+}
+
+uint32_t DispatchJob(void*, const JobInstance& aJob, uint8_t, JobInternalHandle*, JobInternalHandle*)
+{
+    [[maybe_unused]] auto isKnown = RunClosure<Detail::DeferredDataBufferCountDown>(aJob) ||
+                                    RunClosure<DeferredDataBufferGroup::LoadedCallback>(aJob) ||
+                                    RunClosure<OnLoadedJob>(aJob);
+    return 0;
+}
+
+void SyncWaitJobQueue(JobQueue*)
+{
+}
+
+void* g_jobDispatcher = nullptr;
+
+JobHandle* LoadBufferAsync(DeferredDataBuffer*, JobHandle* aJob, int64_t)
+{
+    return aJob;
+}
+
+void DecWeakRef(SharedPtrBase<void>* aPtr)
+{
+    if (InterlockedExchangeAdd(&aPtr->refCount->weakRefs, static_cast<uint32_t>(-1)) == 1)
+    {
+        Memory::Delete(aPtr->refCount);
+    }
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveLoader(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_Capture:
+        return reinterpret_cast<uintptr_t>(&CaptureJobQueue);
+    case JobQueue_SyncWait:
+        return reinterpret_cast<uintptr_t>(&SyncWaitJobQueue);
+    case JobDispatcher_DispatchJob:
+        return reinterpret_cast<uintptr_t>(&DispatchJob);
+    case JobDispatcher:
+        return reinterpret_cast<uintptr_t>(&g_jobDispatcher);
+    case DeferredDataBuffer_LoadAsync:
+        return reinterpret_cast<uintptr_t>(&LoadBufferAsync);
+    case Handle_DecWeakRef:
+        return reinterpret_cast<uintptr_t>(&DecWeakRef);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// What a mod does without the group: one token and one OnLoaded() job per buffer, and a counter of its own to find the
+// last one.
+void LoadEach(std::vector<DeferredDataBuffer>& aBuffers, std::atomic<uint32_t>& aPending, uint32_t& aCalls)
+{
+    aPending.store(static_cast<uint32_t>(aBuffers.size()));
+
+    for (auto& buffer : aBuffers)
+    {
+        auto token = buffer.LoadAsync();
+
+        JobQueue queue;
+        queue.Wait(token->job);
+        queue.Dispatch(OnLoadedJob{token,
+                                   [&aPending, &aCalls](DeferredDataBuffer&)
+                                   {
+                                       if (aPending.fetch_sub(1) == 1)
+                                       {
+                                           ++aCalls;
+                                       }
+                                   }});
+    }
+}
+} // namespace
+
+RED4EXT_BENCHMARK(DeferredDataBufferGroup_Load)
+{
+    g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveLoader);
+
+    // A small mesh and a mesh with its textures and morph targets.
+    for (uint32_t count : {8u, 64u})
+    {
+        std::vector<DeferredDataBuffer> buffers(count);
+        uint32_t calls = 0;
+
+        auto report = [count](const std::string& aName, double aSeconds)
+        {
+            auto name = aName + ", " + std::to_string(count) + " buffers";
+            Benchmarks::Report((name + ", per buffer").c_str(), aSeconds, count);
+            Benchmarks::Report((name + ", per group").c_str(), aSeconds, 1);
+        };
+
+        DeferredDataBufferGroup group;
+        report("DeferredDataBufferGroup::Load",
+               Benchmarks::Measure(
+                   [&]
+                   {
+                       group.Load(Span<DeferredDataBuffer>(buffers.data(), buffers.size()),
+                                  [&calls]() { ++calls; });
+                   }));
+
+        std::atomic<uint32_t> pending = 0;
+        report("LoadAsync and OnLoaded per buffer", Benchmarks::Measure([&] { LoadEach(buffers, pending, calls); }));
+
+        Benchmarks::DoNotOptimize(calls);
+    }
+}
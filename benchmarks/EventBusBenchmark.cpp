@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <RED4ext/EventBus.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+struct DamageEvent
+{
+    int32_t amount;
+};
+
+// What plugins build by hand today.
+using FunctionList = std::vector<std::function<void(const DamageEvent&)>>;
+
+constexpr uint32_t BatchSize = 64;
+} // namespace
+
+RED4EXT_BENCHMARK(EventBus_Publish)
+{
+    std::vector<DamageEvent> events(BatchSize);
+    for (uint32_t i = 0; i < BatchSize; ++i)
+    {
+        events[i].amount = static_cast<int32_t>(i);
+    }
+
+    for (uint32_t count : {1u, 10u, 100u, 1000u})
+    {
+        // Every subscriber adds to its own total, like a plugin that keeps its own state.
+        std::vector<int64_t> totals(count);
+
+        EventBus<DamageEvent> bus;
+        FunctionList functions;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto total = &totals[i];
+            bus.Subscribe([total](const DamageEvent& aEvent) { *total += aEvent.amount; });
+            functions.push_back([total](const DamageEvent& aEvent) { *total += aEvent.amount; });
+        }
+
+        auto suffix = ", " + std::to_string(count) + " subscribers";
+
+        Benchmarks::Run(("std::vector<std::function>, 1 event" + suffix).c_str(), count,
+                        [&]
+                        {
+                            for (const auto& function : functions)
+                            {
+                                function(events[0]);
+                            }
+                        });
+
+        Benchmarks::Run(("EventBus::Publish" + suffix).c_str(), count, [&] { bus.Publish(events[0]); });
+
+        Benchmarks::Run(("std::vector<std::function>, 64 events" + suffix).c_str(), count * BatchSize,
+                        [&]
+                        {
+                            for (const auto& event : events)
+                            {
+                                for (const auto& function : functions)
+                                {
+                                    function(event);
+                                }
+                            }
+                        });
+
+        Benchmarks::Run(("EventBus::PublishBatch, 64 events" + suffix).c_str(), count * BatchSize,
+                        [&] { bus.PublishBatch({events.data(), events.size()}); });
+
+        bus.SetProfiling(true);
+        Benchmarks::Run(("EventBus::PublishBatch, 64 events, profiled" + suffix).c_str(), count * BatchSize,
+                        [&] { bus.PublishBatch({events.data(), events.size()}); });
+
+        Benchmarks::DoNotOptimize(totals.data());
+    }
+}
+
+RED4EXT_BENCHMARK(EventBus_Subscribe)
+{
+    // Subscribing copies the table, its cost grows with the number of subscribers.
+    for (uint32_t count : {10u, 1000u})
+    {
+        EventBus<DamageEvent> bus;
+        int64_t total = 0;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            bus.Subscribe([&total](const DamageEvent& aEvent) { total += aEvent.amount; });
+        }
+
+        auto name = "Subscribe and Unsubscribe, " + std::to_string(count) + " subscribers";
+        Benchmarks::Run(name.c_str(), 1,
+                        [&]
+                        {
+                            auto id = bus.Subscribe([&total](const DamageEvent& aEvent) { total += aEvent.amount; });
+                            bus.Unsubscribe(id);
+                        });
+
+        Benchmarks::DoNotOptimize(total);
+    }
+}
@@ -0,0 +1,130 @@
+#include <mutex>
+#include <shared_mutex>
+
+#include <RED4ext/GameEngine.hpp>
+#include <RED4ext/GameSystemCache.hpp>
+#include <RED4ext/HashMap.hpp>
+#include <RED4ext/SharedSpinLock.hpp>
+
+#include "Benchmark.hpp"
+
+// The game defines the destructor, the mock below needs one to link.
+RED4ext::GameInstance::~GameInstance()
+{
+}
+
+namespace
+{
+using namespace RED4ext;
+
+constexpr uint32_t SystemCount = 12;
+
+// Types and systems are only compared by address, they are never dereferenced.
+alignas(16) uint8_t g_types[SystemCount][64];
+alignas(16) uint8_t g_systems[SystemCount][64];
+
+struct MockGameInstance : GameInstance
+{
+    MockGameInstance()
+    {
+        // The game creates the maps with an allocator.
+        systemMap = decltype(systemMap)(Memory::DefaultAllocator::Get());
+        systemImplementations = decltype(systemImplementations)(Memory::DefaultAllocator::Get());
+    }
+
+    IScriptable* GetSystem(const CBaseRTTIType* aType) override
+    {
+        auto type = const_cast<CBaseRTTIType*>(aType);
+        if (auto implementation = systemImplementations.Get(type))
+        {
+            type = *implementation;
+        }
+
+        auto system = systemMap.Get(type);
+        return system ? system->GetPtr() : nullptr;
+    }
+
+    void Unk_10() override {}
+    void Unk_18() override {}
+    void Unk_20() override {}
+    void Unk_28() override {}
+    void Unk_30() override {}
+    void Unk_38() override {}
+    void Unk_40() override {}
+    void Unk_48() override {}
+    void Unk_50() override {}
+    void Unk_58() override {}
+    void Unk_60() override {}
+    void Unk_68() override {}
+};
+
+// Stands in for CRTTISystem::GetClass, a shared lock and a lookup in the type map.
+struct MockRTTI
+{
+    CBaseRTTIType* GetClass(CName aName)
+    {
+        std::shared_lock<SharedSpinLock> _(typesLock);
+
+        auto type = types.Get(aName);
+        return type ? *type : nullptr;
+    }
+
+    HashMap<CName, CBaseRTTIType*> types{Memory::DefaultAllocator::Get()};
+    SharedSpinLock typesLock;
+};
+
+CName GetSystemName(uint32_t aIndex)
+{
+    return CName(0x1000ull + aIndex);
+}
+} // namespace
+
+RED4EXT_BENCHMARK(GameSystemCache_Lookup)
+{
+    MockGameInstance instance;
+    MockRTTI rtti;
+
+    for (uint32_t i = 0; i < SystemCount; ++i)
+    {
+        auto type = reinterpret_cast<CBaseRTTIType*>(g_types[i]);
+
+        Handle<IScriptable> handle;
+        handle.instance = reinterpret_cast<IScriptable*>(g_systems[i]);
+
+        instance.systemMap.Insert(type, handle);
+        rtti.types.Insert(GetSystemName(i), type);
+    }
+
+    GameInstance* gameInstance = &instance;
+
+    Benchmarks::Run("Uncached, GetClass + GetSystem", SystemCount,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < SystemCount; ++i)
+                        {
+                            auto system = gameInstance->GetSystem(rtti.GetClass(GetSystemName(i)));
+                            Benchmarks::DoNotOptimize(system);
+                        }
+                    });
+
+    Benchmarks::Run("Uncached, GetSystem with a resolved type", SystemCount,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < SystemCount; ++i)
+                        {
+                            auto system = gameInstance->GetSystem(reinterpret_cast<CBaseRTTIType*>(g_types[i]));
+                            Benchmarks::DoNotOptimize(system);
+                        }
+                    });
+
+    Benchmarks::Run("GameSystemCache::Get", SystemCount,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < SystemCount; ++i)
+                        {
+                            auto type = reinterpret_cast<CBaseRTTIType*>(g_types[i]);
+                            auto system = GameSystemCache::Get(gameInstance, type);
+                            Benchmarks::DoNotOptimize(system);
+                        }
+                    });
+}
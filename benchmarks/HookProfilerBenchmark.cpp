@@ -0,0 +1,72 @@
+#include <cstdint>
+
+#include <RED4ext/HookProfiler.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// A detour that does almost nothing, the profiler's cost is all that is left.
+__declspec(noinline) uint64_t Accumulate(uint64_t aSum, uint64_t aValue)
+{
+    return aSum + aValue;
+}
+
+using AccumulateHook = ProfiledHook<decltype(Accumulate), &Accumulate>;
+} // namespace
+
+RED4EXT_BENCHMARK(HookProfiler_Overhead)
+{
+    constexpr uint32_t Count = 10000;
+
+    Benchmarks::Run("Detail::ReadCycleCounter", Count,
+                    [&]
+                    {
+                        uint64_t sum = 0;
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            sum += Detail::ReadCycleCounter();
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    });
+
+    Benchmarks::Run("Detour, not profiled", Count,
+                    [&]
+                    {
+                        uint64_t sum = 0;
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            sum = Accumulate(sum, i);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    });
+
+    Benchmarks::Run("Detour, ProfiledHook", Count,
+                    [&]
+                    {
+                        uint64_t sum = 0;
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            sum = AccumulateHook::Call(sum, i);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    });
+
+    HookProfile profile("record");
+    Benchmarks::Run("HookProfile::Record", Count,
+                    [&]
+                    {
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            profile.Record(i);
+                        }
+                    });
+
+    Benchmarks::DoNotOptimize(AccumulateHook::GetProfile().Snapshot().calls);
+    Benchmarks::DoNotOptimize(profile.Snapshot().calls);
+}
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <cstring>
+
+#include <RED4ext/Memory/NativeBackend.hpp>
+
+#include "Benchmark.hpp"
+
+std::vector<RED4ext::Benchmarks::BenchmarkInfo>& RED4ext::Benchmarks::GetBenchmarks()
+{
+    static std::vector<BenchmarkInfo> benchmarks;
+    return benchmarks;
+}
+
+void RED4ext::Benchmarks::Report(const char* aName, double aSecondsPerCall, uint64_t aItemsPerCall,
+                                 uint64_t aBytesPerCall)
+{
+    auto items = static_cast<double>(aItemsPerCall ? aItemsPerCall : 1);
+    auto nanosecondsPerItem = aSecondsPerCall * 1e9 / items;
+    auto itemsPerSecond = items / aSecondsPerCall;
+
+    if (aBytesPerCall)
+    {
+        auto gigabytesPerSecond = static_cast<double>(aBytesPerCall) / aSecondsPerCall / 1e9;
+        std::printf("%-64s %12.2f ns/item %14.0f items/s %10.2f GB/s\n", aName, nanosecondsPerItem, itemsPerSecond,
+                    gigabytesPerSecond);
+    }
+    else
+    {
+        std::printf("%-64s %12.2f ns/item %14.0f items/s\n", aName, nanosecondsPerItem, itemsPerSecond);
+    }
+
+    std::fflush(stdout);
+}
+
+void RED4ext::Benchmarks::Escape(const void* aPointer)
+{
+    static const void* volatile sink;
+    sink = aPointer;
+}
+
+int main(int aArgc, char** aArgv)
+{
+    // Benchmarks run outside of the game, containers and allocators go through the emulated memory.
+    RED4ext::Memory::NativeBackend::Install();
+
+    // An optional argument selects the benchmarks whose name contains it.
+    auto filter = aArgc > 1 ? aArgv[1] : nullptr;
+
+    for (const auto& benchmark : RED4ext::Benchmarks::GetBenchmarks())
+    {
+        if (filter && !std::strstr(benchmark.name, filter))
+        {
+            continue;
+        }
+
+        std::printf("%s\n", benchmark.name);
+        benchmark.func();
+        std::printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include <RED4ext/CString.hpp>
+#include <RED4ext/DynArray.hpp>
+#include <RED4ext/HashMap.hpp>
+#include <RED4ext/Memory/NativeBackend.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+using namespace RED4ext::Memory;
+
+constexpr uint32_t Count = 1000;
+} // namespace
+
+RED4EXT_BENCHMARK(NativeBackend_Allocate)
+{
+    auto allocator = DefaultAllocator::Get();
+
+    // Allocated all at once and then freed, the way a container's elements come and go.
+    for (uint64_t size : {16ull, 256ull, 4096ull, 65536ull})
+    {
+        auto suffix = ", " + std::to_string(size) + " bytes";
+
+        Benchmarks::Run(("Alloc + Free" + suffix).c_str(), Count,
+                        [&]
+                        {
+                            void* blocks[Count];
+                            for (auto& block : blocks)
+                            {
+                                block = allocator->Alloc(size).memory;
+                                Benchmarks::DoNotOptimize(block);
+                            }
+
+                            for (auto block : blocks)
+                            {
+                                allocator->Free(block);
+                            }
+                        });
+
+        Benchmarks::Run(("malloc + free" + suffix).c_str(), Count,
+                        [&]
+                        {
+                            void* blocks[Count];
+                            for (auto& block : blocks)
+                            {
+                                block = std::malloc(size);
+                                Benchmarks::DoNotOptimize(block);
+                            }
+
+                            for (auto block : blocks)
+                            {
+                                std::free(block);
+                            }
+                        });
+    }
+}
+
+RED4EXT_BENCHMARK(NativeBackend_Containers)
+{
+    Benchmarks::Run("DynArray::PushBack, 1000 elements", Count,
+                    []
+                    {
+                        DynArray<uint32_t> array;
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            array.PushBack(i);
+                        }
+
+                        Benchmarks::DoNotOptimize(array.entries);
+                    });
+
+    Benchmarks::Run("DynArray::PushBack, 1000 elements, reserved", Count,
+                    []
+                    {
+                        DynArray<uint32_t> array;
+                        array.Reserve(Count);
+
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            array.PushBack(i);
+                        }
+
+                        Benchmarks::DoNotOptimize(array.entries);
+                    });
+
+    Benchmarks::Run("HashMap::Insert, 1000 entries", Count,
+                    []
+                    {
+                        HashMap<uint64_t, uint32_t> map;
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            map.Insert(i * 7919ull, i);
+                        }
+
+                        Benchmarks::DoNotOptimize(map.size);
+                    });
+
+    HashMap<uint64_t, uint32_t> map;
+    for (uint32_t i = 0; i < Count; ++i)
+    {
+        map.Insert(i * 7919ull, i);
+    }
+
+    Benchmarks::Run("HashMap::Get, 1000 entries", Count,
+                    [&]
+                    {
+                        uint64_t sum = 0;
+                        for (uint32_t i = 0; i < Count; ++i)
+                        {
+                            sum += *map.Get(i * 7919ull);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    });
+
+    const std::string longText(100, 'x');
+
+    Benchmarks::Run("CString, inline", 1,
+                    []
+                    {
+                        CString text("short");
+                        Benchmarks::DoNotOptimize(text.Length());
+                    });
+
+    Benchmarks::Run("CString, 100 characters", 1,
+                    [&]
+                    {
+                        CString text(longText);
+                        Benchmarks::DoNotOptimize(text.Length());
+                    });
+
+    Benchmarks::Run("CString, 100 characters, copied", 1,
+                    [&]
+                    {
+                        CString text(longText);
+                        CString copy(text);
+                        Benchmarks::DoNotOptimize(copy.Length());
+                    });
+}
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <RED4ext/PackageParser.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+template<typename T>
+void Append(std::vector<uint8_t>& aData, const T& aValue)
+{
+    auto bytes = reinterpret_cast<const uint8_t*>(&aValue);
+    aData.insert(aData.end(), bytes, bytes + sizeof(T));
+}
+
+// A package without imports in the layout described in PackageParser.hpp, every chunk has aFieldCount fields of 16
+// bytes, like the small structs and handles of an entity template.
+std::vector<uint8_t> MakePackage(uint32_t aChunkCount, uint16_t aFieldCount)
+{
+    const std::vector<std::string> names = {"entEntity", "entMeshComponent", "name", "CName", "transform", "Vector4"};
+
+    std::vector<uint8_t> data;
+
+    auto nameDescOffset = static_cast<uint32_t>(data.size());
+    auto nameOffset = static_cast<uint32_t>(names.size() * sizeof(PackageHeader::Name));
+    for (const auto& name : names)
+    {
+        PackageHeader::Name descriptor{};
+        descriptor.offset = nameOffset;
+        descriptor.size = static_cast<uint32_t>(name.size() + 1);
+        Append(data, descriptor);
+        nameOffset += static_cast<uint32_t>(name.size() + 1);
+    }
+
+    auto nameDataOffset = static_cast<uint32_t>(data.size());
+    for (const auto& name : names)
+    {
+        data.insert(data.end(), name.c_str(), name.c_str() + name.size() + 1);
+    }
+
+    constexpr uint32_t ValueSize = 16;
+    auto chunkSize = static_cast<uint32_t>(sizeof(uint16_t) + aFieldCount * (8 + ValueSize));
+
+    auto chunkDescOffset = static_cast<uint32_t>(data.size());
+    auto chunkDataOffset = chunkDescOffset + aChunkCount * static_cast<uint32_t>(sizeof(PackageHeader::Chunk));
+    for (uint32_t i = 0; i < aChunkCount; ++i)
+    {
+        Append(data, PackageHeader::Chunk{i == 0 ? 0u : 1u, chunkDataOffset + i * chunkSize});
+    }
+
+    for (uint32_t i = 0; i < aChunkCount; ++i)
+    {
+        Append(data, aFieldCount);
+
+        auto valueOffset = static_cast<uint32_t>(sizeof(uint16_t) + aFieldCount * 8);
+        for (uint16_t j = 0; j < aFieldCount; ++j)
+        {
+            Append(data, static_cast<uint16_t>(j % 2 ? 4 : 2));
+            Append(data, static_cast<uint16_t>(j % 2 ? 5 : 3));
+            Append(data, valueOffset + j * ValueSize);
+        }
+
+        data.resize(data.size() + aFieldCount * ValueSize, static_cast<uint8_t>(i));
+    }
+
+    std::vector<uint8_t> package = {PackageParser::SupportedVersion, 0};
+    Append(package, static_cast<uint16_t>(6));
+    Append(package, static_cast<uint32_t>(1));
+
+    for (auto offset : {nameDescOffset, nameDataOffset, chunkDescOffset, chunkDataOffset})
+    {
+        Append(package, offset);
+    }
+
+    package.insert(package.end(), data.begin(), data.end());
+    return package;
+}
+
+thread_local uint64_t t_chunkSum = 0;
+
+// Does a little work per field, like an indexer that records the names and sizes of the values. The sums are
+// combined once per chunk so that the threads of VisitParallel do not contend on every field.
+struct SummingVisitor : PackageParser::Visitor
+{
+    void OnField(uint32_t, uint32_t, const PackageParser::Field& aField) override
+    {
+        t_chunkSum += aField.size + aField.name.Length() + aField.data[0];
+    }
+
+    bool OnChunkEnd(uint32_t) override
+    {
+        sum.fetch_add(t_chunkSum, std::memory_order_relaxed);
+        t_chunkSum = 0;
+        return true;
+    }
+
+    std::atomic<uint64_t> sum = 0;
+};
+} // namespace
+
+RED4EXT_BENCHMARK(PackageParser_Throughput)
+{
+    constexpr uint32_t ChunkCount = 100000;
+    constexpr uint16_t FieldCount = 8;
+
+    auto package = MakePackage(ChunkCount, FieldCount);
+    auto size = static_cast<uint32_t>(package.size());
+
+    // Only the tables are validated, the chunk data is not touched.
+    Benchmarks::Run("ParseHeader, 100k chunks", ChunkCount,
+                    [&]
+                    {
+                        PackageParser parser(package.data(), size);
+                        PackageHeader header{};
+                        Benchmarks::DoNotOptimize(parser.ParseHeader(header));
+                    });
+
+    Benchmarks::Run("ParseHeader and Visit, 100k chunks, 800k fields", ChunkCount,
+                    [&]
+                    {
+                        PackageParser parser(package.data(), size);
+                        PackageHeader header{};
+                        parser.ParseHeader(header);
+
+                        SummingVisitor visitor;
+                        parser.Visit(visitor);
+                        Benchmarks::DoNotOptimize(visitor.sum);
+                    },
+                    size);
+
+    for (auto threadCount : {2u, 4u, 8u})
+    {
+        auto name = "ParseHeader and VisitParallel, " + std::to_string(threadCount) + " threads";
+        Benchmarks::Run(name.c_str(), ChunkCount,
+                        [&]
+                        {
+                            PackageParser parser(package.data(), size);
+                            PackageHeader header{};
+                            parser.ParseHeader(header);
+
+                            SummingVisitor visitor;
+                            parser.VisitParallel(visitor, threadCount);
+                            Benchmarks::DoNotOptimize(visitor.sum);
+                        },
+                        size);
+    }
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/Parallel.hpp>
+#include <RED4ext/ThreadPool.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// A little work per entity, about what a transform or a distance check costs.
+float Work(float aValue)
+{
+    return std::sqrt(aValue) * std::sin(aValue);
+}
+
+int32_t GetGrain(int32_t aCount, uint32_t aThreadCount)
+{
+    // Four chunks per thread to balance the load, but not so small that dispatching dominates.
+    return (std::max)(aCount / static_cast<int32_t>(4 * (aThreadCount + 1)), 256);
+}
+} // namespace
+
+RED4EXT_BENCHMARK(Parallel_Scaling)
+{
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+
+    for (int32_t count : {1000, 10000, 100000, 1000000})
+    {
+        std::vector<float> input(static_cast<size_t>(count));
+        for (int32_t i = 0; i < count; ++i)
+        {
+            input[i] = static_cast<float>(i % 1000) + 0.5f;
+        }
+
+        std::vector<float> output(input.size());
+
+        auto suffix = " x" + std::to_string(count);
+        Benchmarks::Run(("Serial" + suffix).c_str(), count,
+                        [&]
+                        {
+                            for (int32_t i = 0; i < count; ++i)
+                            {
+                                output[i] = Work(input[i]);
+                            }
+
+                            Benchmarks::DoNotOptimize(output.data());
+                        });
+
+        for (uint32_t threadCount : {1u, 3u, 7u})
+        {
+            ThreadPool pool(threadCount);
+            auto grain = GetGrain(count, threadCount);
+            auto name = "ParallelFor, " + std::to_string(threadCount + 1) + " threads" + suffix;
+
+            Benchmarks::Run(name.c_str(), count,
+                            [&]
+                            {
+                                ParallelFor(pool, 0, count, grain,
+                                            [&](int32_t aIndex) { output[aIndex] = Work(input[aIndex]); });
+                                Benchmarks::DoNotOptimize(output.data());
+                            });
+        }
+
+        ThreadPool pool(3);
+        Benchmarks::Run(("ParallelReduce, 4 threads" + suffix).c_str(), count,
+                        [&]
+                        {
+                            auto sum = ParallelReduce(
+                                pool, 0, count, GetGrain(count, 3), 0.0f,
+                                [&](int32_t aIndex) { return Work(input[aIndex]); },
+                                [](float aLhs, float aRhs) { return aLhs + aRhs; });
+                            Benchmarks::DoNotOptimize(sum);
+                        });
+    }
+}
+
+RED4EXT_BENCHMARK(Parallel_Overhead)
+{
+    // The cost of a loop that does nothing, it is what a loop has to amortize.
+    ThreadPool pool(3);
+
+    Benchmarks::Run("ParallelFor, 1 chunk, empty body", 1,
+                    [&] { ParallelFor(pool, 0, 1, 256, [](int32_t aIndex) { Benchmarks::DoNotOptimize(aIndex); }); });
+
+    Benchmarks::Run("ParallelFor, 16 chunks, empty body", 16,
+                    [&] { ParallelFor(pool, 0, 16, 1, [](int32_t aIndex) { Benchmarks::DoNotOptimize(aIndex); }); });
+}
@@ -0,0 +1,166 @@
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/RTTINameCache.hpp>
+#include <RED4ext/RTTITypes.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's name pool, a lock and a lookup for every string added or read.
+struct NamePool
+{
+    std::mutex lock;
+    std::unordered_map<uint64_t, std::string> names;
+};
+
+NamePool& GetNamePool()
+{
+    static NamePool pool;
+    return pool;
+}
+
+const char* NamePoolGet(const CName& aName)
+{
+    auto& pool = GetNamePool();
+    std::lock_guard<std::mutex> _(pool.lock);
+
+    auto it = pool.names.find(aName.hash);
+    return it != pool.names.end() ? it->second.c_str() : nullptr;
+}
+
+CName NamePoolAdd(const std::string& aText)
+{
+    CName name(aText.c_str());
+
+    auto& pool = GetNamePool();
+    std::lock_guard<std::mutex> _(pool.lock);
+    pool.names.try_emplace(name.hash, aText);
+
+    return name;
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveNamePool(uint32_t aHash)
+{
+    if (aHash == Detail::AddressHashes::CNamePool_Get)
+    {
+        return reinterpret_cast<uintptr_t>(&NamePoolGet);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// Computes its name like the game's array and handle types do, by formatting the inner type's name and adding the
+// result to the name pool on every call.
+struct StandInType : CBaseRTTIType
+{
+    StandInType(const char* aPrefix, const CBaseRTTIType* aInner)
+        : prefix(aPrefix)
+        , inner(aInner)
+    {
+    }
+
+    CName GetName() const override
+    {
+        return {};
+    }
+
+    uint32_t GetSize() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return 1;
+    }
+
+    ERTTIType GetType() const override
+    {
+        return inner ? ERTTIType::Array : ERTTIType::Class;
+    }
+
+    CName GetComputedName() const override
+    {
+        std::string name = prefix;
+        if (inner)
+        {
+            name += NamePoolGet(inner->GetComputedName());
+        }
+
+        return NamePoolAdd(name);
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+
+    const char* prefix;
+    const CBaseRTTIType* inner;
+};
+} // namespace
+
+RED4EXT_BENCHMARK(RTTINameCache_GetComputedName)
+{
+    g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveNamePool);
+
+    StandInType gameObject("gameObject", nullptr);
+    StandInType handle("handle:", &gameObject);
+    StandInType array("array:", &handle);
+    StandInType nestedArray("array:", &array);
+
+    const CBaseRTTIType* types[] = {&gameObject, &handle, &array, &nestedArray};
+    const char* names[] = {"gameObject", "handle:gameObject", "array:handle:gameObject",
+                           "array:array:handle:gameObject"};
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        auto type = types[i];
+
+        std::string name = "Uncached, ";
+        name += names[i];
+        Benchmarks::Run(name.c_str(), 1,
+                        [&]
+                        {
+                            auto computed = type->GetComputedName();
+                            Benchmarks::DoNotOptimize(computed);
+                        });
+
+        name = "RTTINameCache::GetComputedName, ";
+        name += names[i];
+        Benchmarks::Run(name.c_str(), 1,
+                        [&]
+                        {
+                            auto computed = RTTINameCache::GetComputedName(type);
+                            Benchmarks::DoNotOptimize(computed);
+                        });
+
+        name = "RTTINameCache::GetComputedNameView, ";
+        name += names[i];
+        Benchmarks::Run(name.c_str(), 1,
+                        [&]
+                        {
+                            auto view = RTTINameCache::GetComputedNameView(type);
+                            Benchmarks::DoNotOptimize(view);
+                        });
+    }
+}
@@ -0,0 +1,86 @@
+#include <cstring>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/RawBufferBuilder.hpp>
+
+#include "Benchmark.hpp"
+
+RED4EXT_BENCHMARK(RawBufferBuilder_Append)
+{
+    using namespace RED4ext;
+
+    // 100 MB from 64 byte records, e.g. a serialized stream of small structures.
+    constexpr uint32_t ChunkSize = 64;
+    constexpr uint32_t TotalSize = 100 * 1024 * 1024;
+    constexpr uint32_t ChunkCount = TotalSize / ChunkSize;
+
+    uint8_t chunk[ChunkSize];
+    for (uint32_t i = 0; i < ChunkSize; ++i)
+    {
+        chunk[i] = static_cast<uint8_t>(i);
+    }
+
+    Benchmarks::Run("RawBufferBuilder::Append, 64 B", ChunkCount,
+                    [&]
+                    {
+                        RawBufferBuilder builder;
+                        for (uint32_t i = 0; i < ChunkCount; ++i)
+                        {
+                            builder.Append(chunk, ChunkSize);
+                        }
+
+                        DataBuffer buffer{};
+                        builder.MoveTo(buffer);
+                        Benchmarks::DoNotOptimize(buffer.buffer.data);
+                    },
+                    TotalSize);
+
+    Benchmarks::Run("RawBufferBuilder::Append after Reserve, 64 B", ChunkCount,
+                    [&]
+                    {
+                        RawBufferBuilder builder;
+                        builder.Reserve(TotalSize);
+                        for (uint32_t i = 0; i < ChunkCount; ++i)
+                        {
+                            builder.Append(chunk, ChunkSize);
+                        }
+
+                        DataBuffer buffer{};
+                        builder.MoveTo(buffer);
+                        Benchmarks::DoNotOptimize(buffer.buffer.data);
+                    },
+                    TotalSize);
+
+    // What appending looked like without the builder, a resize of the buffer for every record.
+    Benchmarks::Run("RawBuffer::Resize and copy, 64 B", ChunkCount,
+                    [&]
+                    {
+                        DataBuffer buffer{};
+                        buffer.buffer.Initialize(nullptr, ChunkSize);
+                        std::memcpy(buffer.buffer.data, chunk, ChunkSize);
+
+                        for (uint32_t i = 1; i < ChunkCount; ++i)
+                        {
+                            auto size = buffer.buffer.size;
+                            buffer.buffer.Resize(size + ChunkSize);
+                            std::memcpy(static_cast<uint8_t*>(buffer.buffer.data) + size, chunk, ChunkSize);
+                        }
+
+                        Benchmarks::DoNotOptimize(buffer.buffer.data);
+                    },
+                    TotalSize);
+
+    Benchmarks::Run("std::vector::insert, 64 B", ChunkCount,
+                    [&]
+                    {
+                        std::vector<uint8_t> buffer;
+                        for (uint32_t i = 0; i < ChunkCount; ++i)
+                        {
+                            buffer.insert(buffer.end(), chunk, chunk + ChunkSize);
+                        }
+
+                        Benchmarks::DoNotOptimize(buffer.data());
+                    },
+                    TotalSize);
+}
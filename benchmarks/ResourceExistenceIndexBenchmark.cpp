@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <RED4ext/ArchiveReader.hpp>
+#include <RED4ext/ResourceDepot.hpp>
+#include <RED4ext/ResourceExistenceIndex.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+std::vector<ResourcePath> MakePaths(size_t aCount, uint64_t aSeed)
+{
+    std::mt19937_64 random(aSeed);
+
+    std::vector<ResourcePath> paths;
+    paths.reserve(aCount);
+    for (size_t i = 0; i < aCount; ++i)
+    {
+        paths.push_back(random());
+    }
+
+    return paths;
+}
+
+// Writes an archive that lists the paths without any data.
+bool WriteArchive(const std::filesystem::path& aPath, const ResourcePath* aPaths, size_t aCount)
+{
+    ArchiveReader::Header header{};
+    header.magic = ArchiveReader::Magic;
+    header.version = 12;
+    header.indexPosition = sizeof(header);
+
+    ArchiveReader::IndexHeader index{};
+    index.fileCount = static_cast<uint32_t>(aCount);
+
+    std::vector<ArchiveReader::FileEntry> entries(aCount);
+    for (size_t i = 0; i < aCount; ++i)
+    {
+        entries[i].path = aPaths[i];
+    }
+
+    header.fileSize = sizeof(header) + sizeof(index) + entries.size() * sizeof(ArchiveReader::FileEntry);
+
+    auto file = std::fopen(aPath.string().c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(&index, sizeof(index), 1, file);
+    std::fwrite(entries.data(), sizeof(ArchiveReader::FileEntry), entries.size(), file);
+
+    return std::fclose(file) == 0;
+}
+
+// ResourceDepot cannot be implemented outside of the game, AddDepot() only reads the archive groups and this has the
+// same layout.
+struct StandInDepot
+{
+    void* vftable = nullptr;       // 00
+    uint64_t unk08 = 0;            // 08
+    DynArray<ArchiveGroup> groups; // 10
+    DynArray<void*> unk20;         // 20
+    CString rootPath;              // 30
+    bool hasModArchives = false;   // 50
+};
+RED4EXT_ASSERT_OFFSET(StandInDepot, groups, 0x10);
+} // namespace
+
+RED4EXT_BENCHMARK(ResourceExistenceIndex_Queries)
+{
+    // About the number of files in the game's archives.
+    constexpr size_t PathCount = 520000;
+    constexpr size_t QueryCount = 100000;
+
+    auto paths = MakePaths(PathCount, 1);
+    auto others = MakePaths(QueryCount, 2);
+
+    ResourceExistenceIndex index;
+    index.Add(Span<const ResourcePath>(paths.data(), paths.size()));
+
+    auto megabytes = static_cast<double>(index.GetMemoryUsage()) / (1024.0 * 1024.0);
+    std::printf("%zu paths, %.2f MB, estimated false positive rate %.3f%%\n", index.GetSize(), megabytes,
+                index.EstimateFalsePositiveRate() * 100.0);
+
+    std::mt19937_64 random(3);
+    std::vector<ResourcePath> hits;
+    for (size_t i = 0; i < QueryCount; ++i)
+    {
+        hits.push_back(paths[random() % PathCount]);
+    }
+
+    // What mods look up: mostly paths that exist, some that were removed or mistyped.
+    std::vector<ResourcePath> mixed;
+    for (size_t i = 0; i < QueryCount; ++i)
+    {
+        mixed.push_back(i % 4 == 0 ? others[i] : hits[i]);
+    }
+
+    std::unordered_set<uint64_t> set;
+    for (auto path : paths)
+    {
+        set.insert(path.hash);
+    }
+
+    auto runQueries = [&](const char* aName, const std::vector<ResourcePath>& aQueries)
+    {
+        Benchmarks::Run((std::string("Contains, ") + aName).c_str(), QueryCount,
+                        [&]
+                        {
+                            size_t count = 0;
+                            for (auto query : aQueries)
+                            {
+                                count += index.Contains(query);
+                            }
+
+                            Benchmarks::DoNotOptimize(count);
+                        });
+
+        std::unique_ptr<bool[]> results(new bool[QueryCount]);
+        Benchmarks::Run((std::string("Contains batch, ") + aName).c_str(), QueryCount,
+                        [&] { Benchmarks::DoNotOptimize(index.Contains(aQueries.data(), results.get(), QueryCount)); });
+
+        Benchmarks::Run((std::string("std::unordered_set::count, ") + aName).c_str(), QueryCount,
+                        [&]
+                        {
+                            size_t count = 0;
+                            for (auto query : aQueries)
+                            {
+                                count += set.count(query.hash);
+                            }
+
+                            Benchmarks::DoNotOptimize(count);
+                        });
+    };
+
+    runQueries("hits", hits);
+    runQueries("misses", others);
+    runQueries("75% hits", mixed);
+}
+
+RED4EXT_BENCHMARK(ResourceExistenceIndex_AddDepot)
+{
+    // The game mounts about 200 archives, most of them small.
+    constexpr uint32_t ArchiveCount = 200;
+    constexpr size_t PathsPerArchive = 2600;
+
+    auto paths = MakePaths(ArchiveCount * PathsPerArchive, 4);
+    auto directory = std::filesystem::temp_directory_path();
+
+    std::vector<std::filesystem::path> archives;
+    for (uint32_t i = 0; i < ArchiveCount; ++i)
+    {
+        archives.push_back(directory / ("RED4ext.ResourceExistenceIndexBenchmark." + std::to_string(i) + ".archive"));
+        if (!WriteArchive(archives.back(), paths.data() + i * PathsPerArchive, PathsPerArchive))
+        {
+            std::printf("Could not write %s\n", archives.back().string().c_str());
+            return;
+        }
+    }
+
+    StandInDepot depot;
+    ArchiveGroup group{};
+    for (const auto& path : archives)
+    {
+        Archive archive{};
+        archive.path = CString(path.string().c_str());
+        group.archives.PushBack(archive);
+    }
+
+    depot.groups.PushBack(group);
+
+    Benchmarks::Run("AddDepot, 200 archives", ArchiveCount * PathsPerArchive,
+                    [&]
+                    {
+                        ResourceExistenceIndex index;
+                        index.AddDepot(reinterpret_cast<const ResourceDepot*>(&depot));
+                        Benchmarks::DoNotOptimize(index.GetSize());
+                    });
+
+    Benchmarks::Run("AddArchive per archive, 200 archives", ArchiveCount * PathsPerArchive,
+                    [&]
+                    {
+                        ResourceExistenceIndex index;
+                        for (const auto& path : archives)
+                        {
+                            index.AddArchive(path);
+                        }
+
+                        Benchmarks::DoNotOptimize(index.GetSize());
+                    });
+
+    for (const auto& path : archives)
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+}
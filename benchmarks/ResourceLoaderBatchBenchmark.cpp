@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// ResourceLoader.hpp is not self-contained, its CResource include needs the loader already.
+#include <RED4ext/RED4ext.hpp>
+
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Relocation.hpp>
+#include <RED4ext/ResourceLoader.hpp>
+#include <RED4ext/ResourceTokenCache.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's job handles. They are reference counted through unk1C like in the game, joins are only
+// counted and nothing runs, the cost of the job system itself is not part of the measurement.
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->internal->unk1C, static_cast<uint32_t>(-1)) == 1)
+    {
+        delete aHandle->internal;
+    }
+
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle&)
+{
+    ++aHandle->internal->unk00;
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    return aQueue;
+}
+
+void DestructJobQueue(JobQueue*)
+{
+}
+
+JobHandle* CaptureJobQueue(JobQueue* aQueue, JobHandle* aHandle)
+{
+    ReleaseJobHandle(aHandle);
+
+    aHandle->internal = aQueue->unk18.internal;
+    InterlockedExchangeAdd(&aHandle->internal->unk1C, static_cast<uint32_t>(1));
+
+    return aHandle;
+}
+
+// Stands in for the game's loader, a request creates a token and registers it in the token map.
+uintptr_t IssueLoadingRequest(ResourceLoader* aLoader, SharedPtr<ResourceToken<>>& aToken, ResourcePath aPath)
+{
+    aToken = MakeShared<ResourceToken<>>();
+    aToken->path = aPath;
+    aLoader->tokens.InsertOrAssign(aPath, WeakPtr<ResourceToken<>>(aToken));
+
+    return 0;
+}
+
+uintptr_t FindTokenFast(ResourceLoader* aLoader, SharedPtr<ResourceToken<>>* aToken, ResourcePath aPath)
+{
+    auto weak = aLoader->tokens.Get(aPath);
+    if (weak)
+    {
+        *aToken = weak->Lock();
+    }
+
+    return 0;
+}
+
+void CancelTokenJob(void*)
+{
+}
+
+void DestructTokenJob(void**)
+{
+}
+
+void DecWeakRef(SharedPtrBase<void>* aPtr)
+{
+    if (InterlockedExchangeAdd(&aPtr->refCount->weakRefs, static_cast<uint32_t>(-1)) == 1)
+    {
+        Memory::Delete(aPtr->refCount);
+    }
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveLoader(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_Capture:
+        return reinterpret_cast<uintptr_t>(&CaptureJobQueue);
+    case ResourceLoader_IssueLoadingRequestByPath:
+        return reinterpret_cast<uintptr_t>(&IssueLoadingRequest);
+    case ResourceLoader_FindTokenFast:
+        return reinterpret_cast<uintptr_t>(&FindTokenFast);
+    case ResourceToken_CancelUnk38:
+        return reinterpret_cast<uintptr_t>(&CancelTokenJob);
+    case ResourceToken_DestructUnk38:
+        return reinterpret_cast<uintptr_t>(&DestructTokenJob);
+    case Handle_DecWeakRef:
+        return reinterpret_cast<uintptr_t>(&DecWeakRef);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// What a mod does without LoadBatch: one FindToken() per path, a load request for the missing ones and a wait for
+// every unfinished token.
+JobHandle LoadEach(ResourceLoader& aLoader, const std::vector<ResourcePath>& aPaths,
+                   std::vector<SharedPtr<ResourceToken<>>>& aTokens)
+{
+    JobQueue queue;
+
+    aTokens.clear();
+    for (auto path : aPaths)
+    {
+        auto token = aLoader.FindToken(path);
+        if (!token)
+        {
+            token = aLoader.LoadAsync(path);
+        }
+
+        if (!token->IsFinished())
+        {
+            queue.Wait(token->job);
+        }
+
+        aTokens.push_back(std::move(token));
+    }
+
+    return queue.Capture();
+}
+} // namespace
+
+RED4EXT_BENCHMARK(ResourceLoader_LoadBatch)
+{
+    g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveLoader);
+
+    ResourceLoader loader{};
+    loader.tokens = HashMap<ResourcePath, WeakPtr<ResourceToken<>>>(Memory::DefaultAllocator::Get());
+
+    // The resources of a streaming sector, about a third of the requests are duplicates of shared meshes and
+    // materials.
+    constexpr uint32_t RequestCount = 512;
+    constexpr uint32_t UniqueCount = 352;
+
+    std::mt19937 random(1);
+    std::vector<ResourcePath> paths;
+    for (uint32_t i = 0; i < RequestCount; ++i)
+    {
+        auto index = i < UniqueCount ? i : static_cast<uint32_t>(random() % UniqueCount);
+        paths.push_back(ResourcePath(("base\\benchmark\\sector\\resource_" + std::to_string(index) + ".mesh").c_str()));
+    }
+
+    std::shuffle(paths.begin(), paths.end(), random);
+    Span<const ResourcePath> span(paths.data(), paths.size());
+
+    auto report = [](const char* aName, double aSeconds)
+    {
+        Benchmarks::Report((std::string(aName) + ", per path").c_str(), aSeconds, RequestCount);
+        Benchmarks::Report((std::string(aName) + ", per batch").c_str(), aSeconds, 1);
+    };
+
+    // Cold, every token is released after the call, the next call requests everything again.
+    report("Cold, LoadBatch",
+           Benchmarks::Measure(
+               [&]
+               {
+                   auto batch = loader.LoadBatch(span);
+                   Benchmarks::DoNotOptimize(batch.job.internal);
+               }));
+
+    std::vector<SharedPtr<ResourceToken<>>> tokens;
+    report("Cold, FindToken and LoadAsync per path",
+           Benchmarks::Measure(
+               [&]
+               {
+                   auto job = LoadEach(loader, paths, tokens);
+                   tokens.clear();
+                   Benchmarks::DoNotOptimize(job.internal);
+               }));
+
+    // Warm, the resources are loaded and kept alive by another batch.
+    auto loaded = loader.LoadBatch(span);
+    for (auto& token : loaded.tokens)
+    {
+        token->finished = 1;
+    }
+
+    report("Warm, LoadBatch",
+           Benchmarks::Measure(
+               [&]
+               {
+                   auto batch = loader.LoadBatch(span);
+                   Benchmarks::DoNotOptimize(batch.job.internal);
+               }));
+
+    report("Warm, FindToken per path",
+           Benchmarks::Measure(
+               [&]
+               {
+                   auto job = LoadEach(loader, paths, tokens);
+                   Benchmarks::DoNotOptimize(job.internal);
+               }));
+
+    tokens.clear();
+    loaded = {};
+
+    // The slots hold weak references, release them while the loader's memory is still there.
+    ResourceTokenCache::Invalidate();
+}
@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <RED4ext/IO/BufferedWriteStream.hpp>
+#include <RED4ext/IO/MappedFileStream.hpp>
+#include <RED4ext/IO/MemoryStream.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// A small record of a save or a CR2W export, serialized field by field.
+struct Record
+{
+    uint32_t id;
+    uint32_t flags;
+    float x;
+    float y;
+};
+
+// The file is 64 MB by default, set RED4EXT_BENCHMARK_STREAM_MB to read larger files (e.g. 500).
+size_t GetFileSize()
+{
+    auto megabytes = std::getenv("RED4EXT_BENCHMARK_STREAM_MB");
+    auto size = megabytes ? std::strtoull(megabytes, nullptr, 10) : 0;
+    return (size ? size : 64) * 1024 * 1024;
+}
+
+// Reads the record the way the game's serializers do, one virtual call per field.
+void ReadFields(BaseStream& aStream, Record& aRecord)
+{
+    aStream.ReadWriteEx(&aRecord.id);
+    aStream.ReadWriteEx(&aRecord.flags);
+    aStream.ReadWriteEx(&aRecord.x);
+    aStream.ReadWriteEx(&aRecord.y);
+}
+
+uint64_t Sum(const Record& aRecord)
+{
+    return aRecord.id + aRecord.flags + static_cast<uint64_t>(aRecord.x + aRecord.y);
+}
+} // namespace
+
+RED4EXT_BENCHMARK(Stream_SmallRecords)
+{
+    auto fileSize = GetFileSize();
+    auto count = fileSize / sizeof(Record);
+    auto path = std::filesystem::temp_directory_path() / "RED4ext.StreamBenchmark.bin";
+
+    auto name = [&](const char* aName)
+    {
+        return std::string(aName) + ", " + std::to_string(fileSize / (1024 * 1024)) + " MB";
+    };
+
+    Benchmarks::Run(name("std::fwrite per record").c_str(), count,
+                    [&]
+                    {
+                        auto file = std::fopen(path.string().c_str(), "wb");
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            Record record{static_cast<uint32_t>(i), 1, 2.0f, 3.0f};
+                            std::fwrite(&record, sizeof(record), 1, file);
+                        }
+
+                        std::fclose(file);
+                    },
+                    fileSize);
+
+    Benchmarks::Run(name("BufferedWriteStream per field").c_str(), count,
+                    [&]
+                    {
+                        BufferedWriteStream stream(path);
+                        BaseStream& base = stream;
+
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            Record record{static_cast<uint32_t>(i), 1, 2.0f, 3.0f};
+                            base.ReadWriteEx(&record.id);
+                            base.ReadWriteEx(&record.flags);
+                            base.ReadWriteEx(&record.x);
+                            base.ReadWriteEx(&record.y);
+                        }
+                    },
+                    fileSize);
+
+    Benchmarks::Run(name("std::fread per field").c_str(), count,
+                    [&]
+                    {
+                        auto file = std::fopen(path.string().c_str(), "rb");
+                        uint64_t sum = 0;
+
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            Record record{};
+                            std::fread(&record.id, sizeof(record.id), 1, file);
+                            std::fread(&record.flags, sizeof(record.flags), 1, file);
+                            std::fread(&record.x, sizeof(record.x), 1, file);
+                            std::fread(&record.y, sizeof(record.y), 1, file);
+                            sum += Sum(record);
+                        }
+
+                        std::fclose(file);
+                        Benchmarks::DoNotOptimize(sum);
+                    },
+                    fileSize);
+
+    MappedFileStream mapped(path);
+
+    Benchmarks::Run(name("MappedFileStream per field").c_str(), count,
+                    [&]
+                    {
+                        mapped.Seek(0);
+                        uint64_t sum = 0;
+
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            Record record{};
+                            ReadFields(mapped, record);
+                            sum += Sum(record);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    },
+                    fileSize);
+
+    Benchmarks::Run(name("MappedFileStream::ReadSpan").c_str(), count,
+                    [&]
+                    {
+                        mapped.Seek(0);
+                        uint64_t sum = 0;
+
+                        for (const auto& record : mapped.ReadSpan<Record>(static_cast<uint32_t>(count)))
+                        {
+                            sum += Sum(record);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    },
+                    fileSize);
+
+    std::vector<uint8_t> bytes(mapped.GetData(), mapped.GetData() + mapped.GetLength());
+    MemoryStream memory(bytes.data(), bytes.size());
+
+    Benchmarks::Run(name("MemoryStream per field").c_str(), count,
+                    [&]
+                    {
+                        memory.Seek(0);
+                        uint64_t sum = 0;
+
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            Record record{};
+                            ReadFields(memory, record);
+                            sum += Sum(record);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    },
+                    fileSize);
+
+    Benchmarks::Run(name("MemoryStream::ReadSpan").c_str(), count,
+                    [&]
+                    {
+                        memory.Seek(0);
+                        uint64_t sum = 0;
+
+                        for (const auto& record : memory.ReadSpan<Record>(static_cast<uint32_t>(count)))
+                        {
+                            sum += Sum(record);
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    },
+                    fileSize);
+
+    mapped.Close();
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
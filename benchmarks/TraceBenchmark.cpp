@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/IO/MemoryStream.hpp>
+#include <RED4ext/Trace/TraceDecoder.hpp>
+#include <RED4ext/Trace/TraceWriter.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the trace file, only the number of bytes is kept so that the encoding is measured on its own.
+struct NullStream : BaseStream
+{
+    void* ReadWrite(void* aBuffer, uint32_t aLength) override
+    {
+        written += aLength;
+        return aBuffer;
+    }
+
+    size_t GetPointerPosition() override
+    {
+        return written;
+    }
+
+    size_t GetLength() override
+    {
+        return written;
+    }
+
+    bool Seek(size_t) override
+    {
+        return false;
+    }
+
+    bool Flush() override
+    {
+        return true;
+    }
+
+    size_t written = 0;
+};
+
+// A job worker's events: a scope around the job and an event with a few numbers and a name.
+template<typename F>
+void RecordFrame(uint32_t aCount, F&& aRecord)
+{
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        aRecord(i, CName(0x6E5F2C1B0A9D3E47ull + i % 16), 0.125f * static_cast<float>(i));
+    }
+}
+} // namespace
+
+RED4EXT_BENCHMARK(Trace_Encode)
+{
+    constexpr uint32_t Count = 1000;
+
+    NullStream stream;
+    TraceWriter writer(stream, TraceWriter::DefaultChunkSize, false);
+
+    Benchmarks::Run("TraceWriter::Event, no arguments", Count,
+                    [&] { RecordFrame(Count, [&](uint32_t, CName, float) { writer.Event("frame finished"); }); });
+
+    Benchmarks::Run("TraceWriter::Event, 2 numbers and a name", Count,
+                    [&]
+                    {
+                        RecordFrame(Count, [&](uint32_t aIndex, CName aName, float aMs)
+                                    { writer.Event("job {} of {} took {} ms", aIndex, aName, aMs); });
+                    });
+
+    Benchmarks::Run("TraceScope, 1 number", Count,
+                    [&]
+                    {
+                        RecordFrame(Count, [&](uint32_t aIndex, CName, float)
+                                    { TraceScope scope(writer, "job {}", aIndex); });
+                    });
+
+    char line[256];
+    Benchmarks::Run("snprintf, 2 numbers and a name", Count,
+                    [&]
+                    {
+                        RecordFrame(Count,
+                                    [&](uint32_t aIndex, CName aName, float aMs)
+                                    {
+                                        std::snprintf(line, sizeof(line), "job %u of %016llX took %f ms", aIndex,
+                                                      static_cast<unsigned long long>(aName.hash),
+                                                      static_cast<double>(aMs));
+                                        Benchmarks::DoNotOptimize(line);
+                                    });
+                    });
+
+    if (writer.GetDroppedCount() != 0)
+    {
+        std::printf("%llu events were dropped, the results are not valid\n",
+                    static_cast<unsigned long long>(writer.GetDroppedCount()));
+    }
+
+    writer.Flush();
+    Benchmarks::DoNotOptimize(stream.written);
+}
+
+RED4EXT_BENCHMARK(Trace_Decode)
+{
+    constexpr uint32_t Count = 100000;
+
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+        TraceWriter writer(stream, TraceWriter::DefaultChunkSize, false);
+
+        RecordFrame(Count, [&](uint32_t aIndex, CName aName, float aMs)
+                    { writer.Event("job {} of {} took {} ms", aIndex, aName, aMs); });
+    }
+
+    auto data = static_cast<const uint8_t*>(buffer.buffer.data);
+    auto size = buffer.buffer.size;
+
+    TraceDecoder decoder;
+    if (!decoder.Load(data, size))
+    {
+        std::printf("The trace could not be loaded\n");
+        return;
+    }
+
+    std::printf("%u events, %u bytes, %.1f bytes per event\n", Count, size, static_cast<double>(size) / Count);
+
+    for (auto [name, format] : {std::pair{"TraceDecoder::Decode, text", TraceDecoder::OutputFormat::Text},
+                                std::pair{"TraceDecoder::Decode, JSON lines", TraceDecoder::OutputFormat::JsonLines},
+                                std::pair{"TraceDecoder::Decode, Chrome", TraceDecoder::OutputFormat::ChromeTrace}})
+    {
+        Benchmarks::Run(name, Count,
+                        [&]
+                        {
+                            std::ostringstream out;
+                            decoder.Decode(out, format);
+                            Benchmarks::DoNotOptimize(out.tellp());
+                        },
+                        size);
+    }
+}
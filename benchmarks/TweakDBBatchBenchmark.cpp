@@ -0,0 +1,150 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <RED4ext/TweakDB.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+std::vector<TweakDBID> MakeFlats(uint32_t aCount, uint32_t aSeed)
+{
+    std::mt19937 random(aSeed);
+
+    std::vector<TweakDBID> flats;
+    flats.reserve(aCount);
+
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        TweakDBID dbid(static_cast<uint32_t>(random()) | 1, static_cast<uint8_t>(16 + random() % 48));
+        dbid.SetTDBOffset(static_cast<int32_t>(i * 16));
+        flats.push_back(dbid);
+    }
+
+    return flats;
+}
+
+// Stands in for the game's TweakDB, only the flats are used.
+TweakDB* MakeTweakDB(const std::vector<TweakDBID>& aExisting)
+{
+    auto tweakDB = new TweakDB{};
+    tweakDB->flats = SortedUniqueArray<TweakDBID>(Memory::DefaultAllocator::Get());
+
+    TweakDB::Batch batch(tweakDB);
+    for (const auto& dbid : aExisting)
+    {
+        batch.AddFlat(dbid);
+    }
+
+    batch.Commit();
+    return tweakDB;
+}
+
+std::string GetCountName(uint32_t aCount)
+{
+    return aCount >= 1000000 ? std::to_string(aCount / 1000000) + "M" : std::to_string(aCount / 1000) + "k";
+}
+
+// Inserting one by one moves the tail of the array for every flat, the large sizes take minutes. They are timed once
+// instead of in repeated rounds.
+template<typename F>
+void RunOnce(const std::string& aName, uint32_t aCount, F&& aFunc)
+{
+    auto start = std::chrono::steady_clock::now();
+    aFunc();
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Benchmarks::Report(aName.c_str(), seconds, aCount);
+}
+} // namespace
+
+RED4EXT_BENCHMARK(TweakDBBatch_EmptyTweakDB)
+{
+    auto tweakDB = MakeTweakDB({});
+
+    for (auto count : {10000u, 100000u, 1000000u})
+    {
+        auto flats = MakeFlats(count, count);
+        auto name = GetCountName(count);
+
+        tweakDB->flats.Clear();
+        RunOnce("TweakDB::AddFlat, " + name + " flats, once", count,
+                [&]
+                {
+                    for (const auto& dbid : flats)
+                    {
+                        tweakDB->AddFlat(dbid);
+                    }
+                });
+
+        Benchmarks::Run(("TweakDB::Batch, " + name + " flats").c_str(), count,
+                        [&]
+                        {
+                            tweakDB->flats.Clear();
+
+                            TweakDB::Batch batch(tweakDB);
+                            batch.Reserve(count, 0);
+                            for (const auto& dbid : flats)
+                            {
+                                batch.AddFlat(dbid);
+                            }
+
+                            batch.Commit();
+                        });
+    }
+}
+
+RED4EXT_BENCHMARK(TweakDBBatch_FullTweakDB)
+{
+    // The game's TweakDB holds about a million flats.
+    auto existing = MakeFlats(1000000, 0);
+    auto tweakDB = MakeTweakDB(existing);
+    std::vector<TweakDBID> snapshot(tweakDB->flats.begin(), tweakDB->flats.end());
+
+    auto restore = [&]
+    {
+        tweakDB->flats.Clear();
+        tweakDB->flats.InsertSorted(snapshot.data(), static_cast<uint32_t>(snapshot.size()));
+    };
+
+    Benchmarks::Run("Restoring 1M flats (included below)", 1,
+                    [&]
+                    {
+                        restore();
+                    });
+
+    for (auto count : {10000u, 100000u, 1000000u})
+    {
+        auto flats = MakeFlats(count, count);
+        auto name = GetCountName(count);
+
+        restore();
+        RunOnce("TweakDB::AddFlat, " + name + " into 1M flats, once", count,
+                [&]
+                {
+                    for (const auto& dbid : flats)
+                    {
+                        tweakDB->AddFlat(dbid);
+                    }
+                });
+
+        Benchmarks::Run(("TweakDB::Batch, " + name + " into 1M flats").c_str(), count,
+                        [&]
+                        {
+                            restore();
+
+                            TweakDB::Batch batch(tweakDB);
+                            batch.Reserve(count, 0);
+                            for (const auto& dbid : flats)
+                            {
+                                batch.AddFlat(dbid);
+                            }
+
+                            batch.Commit();
+                        });
+    }
+}
@@ -0,0 +1,246 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <RED4ext/TweakDB.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+struct StandInType : CBaseRTTIType
+{
+    StandInType(CName aName, uint32_t aSize, uint32_t aAlignment)
+        : name(aName)
+        , size(aSize)
+        , alignment(aAlignment)
+    {
+    }
+
+    CName GetName() const override
+    {
+        return name;
+    }
+
+    uint32_t GetSize() const override
+    {
+        return size;
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return alignment;
+    }
+
+    ERTTIType GetType() const override
+    {
+        return ERTTIType::Fundamental;
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+
+    CName name;
+    uint32_t size;
+    uint32_t alignment;
+};
+
+// Stands in for the game's TweakDB, only the flats and the flat data buffer are used.
+struct StandInTweakDB
+{
+    static constexpr uint32_t BufferSize = 16 * 1024 * 1024;
+
+    StandInTweakDB()
+        : buffer(BufferSize / sizeof(uint64_t))
+    {
+        db.flats = SortedUniqueArray<TweakDBID>(Memory::DefaultAllocator::Get());
+        db.defaultValues = decltype(db.defaultValues)(Memory::DefaultAllocator::Get());
+
+        db.flatDataBuffer = reinterpret_cast<uintptr_t>(buffer.data());
+        db.staticFlatDataBuffer = db.flatDataBuffer;
+        db.flatDataBufferEnd = db.flatDataBuffer;
+        db.flatDataBufferCapacity = BufferSize;
+    }
+
+    std::vector<uint64_t> buffer;
+    TweakDB db{};
+};
+
+enum class ValueKind
+{
+    Int32,
+    Float,
+    CName,
+    TweakDBID,
+    TweakDBIDArray
+};
+
+struct ModValue
+{
+    ValueKind kind;
+    uint32_t index;
+};
+
+// The flats a set of mods writes, the values are drawn from aDistinct values per type. Mods mostly write the same
+// numbers, names and records, a small aDistinct gives the typical mostly duplicated set.
+std::vector<ModValue> MakeModSet(uint32_t aCount, uint32_t aDistinct)
+{
+    std::mt19937 random(aCount);
+
+    std::vector<ModValue> values;
+    values.reserve(aCount);
+
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        auto kind = static_cast<ValueKind>(random() % 5);
+        auto index = aDistinct ? static_cast<uint32_t>(random()) % aDistinct : i;
+        values.push_back({kind, index});
+    }
+
+    return values;
+}
+
+struct ModSetCreator
+{
+    ModSetCreator()
+        : int32("Int32", 4, 4)
+        , float32("Float", 4, 4)
+        , cname("CName", 8, 8)
+        , tweakDBID("TweakDBID", 8, 8)
+        , tweakDBIDArray("array:TweakDBID", sizeof(DynArray<TweakDBID>), 8)
+    {
+    }
+
+    void Create(TweakDB& aTweakDB, const std::vector<ModValue>& aValues)
+    {
+        for (const auto& value : aValues)
+        {
+            int32_t offset;
+            switch (value.kind)
+            {
+            case ValueKind::Int32:
+            {
+                auto data = static_cast<int32_t>(value.index);
+                offset = aTweakDB.CreateFlatValue({&int32, &data});
+                break;
+            }
+            case ValueKind::Float:
+            {
+                auto data = static_cast<float>(value.index) * 0.25f;
+                offset = aTweakDB.CreateFlatValue({&float32, &data});
+                break;
+            }
+            case ValueKind::CName:
+            {
+                CName data(static_cast<uint64_t>(value.index) * 0x9E3779B97F4A7C15ull + 1);
+                offset = aTweakDB.CreateFlatValue({&cname, &data});
+                break;
+            }
+            case ValueKind::TweakDBID:
+            {
+                TweakDBID data(value.index + 1, 24);
+                offset = aTweakDB.CreateFlatValue({&tweakDBID, &data});
+                break;
+            }
+            default:
+            {
+                // Creating the value takes over the array's storage, a new array is built for every value.
+                DynArray<TweakDBID> data(Memory::DefaultAllocator::Get());
+                for (uint32_t i = 0; i < 1 + value.index % 4; ++i)
+                {
+                    data.PushBack(TweakDBID(value.index + i + 1, 24));
+                }
+
+                auto bufferEnd = aTweakDB.flatDataBufferEnd;
+                offset = aTweakDB.CreateFlatValue({&tweakDBIDArray, &data});
+                if (aTweakDB.flatDataBufferEnd != bufferEnd)
+                {
+                    arrays.push_back(offset);
+                }
+                break;
+            }
+            }
+
+            Benchmarks::DoNotOptimize(offset);
+        }
+    }
+
+    // Frees the storage of the arrays in the buffer before the buffer is reused.
+    void Reset(TweakDB& aTweakDB)
+    {
+        for (auto offset : arrays)
+        {
+            auto flatValue = reinterpret_cast<TweakDB::FlatValue*>(aTweakDB.flatDataBuffer + offset);
+            static_cast<DynArray<TweakDBID>*>(flatValue->GetDataPtr())->~DynArray();
+        }
+
+        arrays.clear();
+        aTweakDB.flatDataBufferEnd = aTweakDB.flatDataBuffer;
+    }
+
+    StandInType int32;
+    StandInType float32;
+    StandInType cname;
+    StandInType tweakDBID;
+    StandInType tweakDBIDArray;
+    std::vector<int32_t> arrays;
+};
+} // namespace
+
+RED4EXT_BENCHMARK(TweakDBFlatValuePool_CreateModSet)
+{
+    constexpr uint32_t Count = 100000;
+
+    static StandInTweakDB tweakDB;
+    static StandInTweakDB other;
+    ModSetCreator creator;
+
+    // Empties the buffer, touching another TweakDB drops the pool so it is rebuilt for the empty buffer.
+    auto reset = [&]
+    {
+        creator.Reset(tweakDB.db);
+        other.db.GetFlatValuePoolStats();
+    };
+
+    struct ModSet
+    {
+        const char* name;
+        uint32_t distinct;
+    };
+
+    for (auto modSet : {ModSet{"typical mod set", 200}, ModSet{"all unique values", 0}})
+    {
+        auto values = MakeModSet(Count, modSet.distinct);
+
+        reset();
+        creator.Create(tweakDB.db, values);
+
+        auto stats = tweakDB.db.GetFlatValuePoolStats();
+        auto bufferSize = tweakDB.db.flatDataBufferEnd - tweakDB.db.flatDataBuffer;
+        std::printf("%s: %u values, %u reused, %llu bytes used, %llu bytes saved\n", modSet.name, Count,
+                    stats.reusedValues, static_cast<unsigned long long>(bufferSize),
+                    static_cast<unsigned long long>(stats.bytesSaved));
+
+        Benchmarks::Run(("TweakDB::CreateFlatValue, " + std::string(modSet.name)).c_str(), Count,
+                        [&]
+                        {
+                            reset();
+                            creator.Create(tweakDB.db, values);
+                        });
+    }
+}
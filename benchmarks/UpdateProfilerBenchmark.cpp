@@ -0,0 +1,155 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/UpdateProfiler.hpp>
+
+#include "Benchmark.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the trace file, only the number of bytes is kept.
+struct NullStream : BaseStream
+{
+    void* ReadWrite(void* aBuffer, uint32_t aLength) override
+    {
+        written += aLength;
+        return aBuffer;
+    }
+
+    size_t GetPointerPosition() override
+    {
+        return written;
+    }
+
+    size_t GetLength() override
+    {
+        return written;
+    }
+
+    bool Seek(size_t) override
+    {
+        return false;
+    }
+
+    bool Flush() override
+    {
+        return true;
+    }
+
+    size_t written = 0;
+};
+
+// The registered updates of a busy frame: group updates and bucket updates that run for every bucket.
+constexpr uint32_t GroupUpdates = 40;
+constexpr uint32_t BucketUpdates = 20;
+constexpr uint32_t BucketCount = static_cast<uint32_t>(UpdateBucketEnum::BucketCount);
+constexpr uint32_t CallsPerFrame = GroupUpdates + BucketUpdates * BucketCount;
+
+struct Frame
+{
+    std::vector<GroupUpdateCallback> groups;
+    std::vector<BucketUpdateCallback> buckets;
+};
+
+uint64_t g_work = 0;
+
+Frame MakeFrame(bool aIsProfiled)
+{
+    Frame frame;
+
+    for (uint32_t i = 0; i < GroupUpdates; ++i)
+    {
+        GroupUpdateCallback callback = [](FrameInfo& aFrame, JobQueue&)
+        { g_work += static_cast<uint64_t>(aFrame.deltaTime > 0.0f); };
+
+        frame.groups.push_back(aIsProfiled ? UpdateProfiler::Wrap(UpdateTickGroup::EntityUpdateState, "group update",
+                                                                  std::move(callback))
+                                           : std::move(callback));
+    }
+
+    for (uint32_t i = 0; i < BucketUpdates; ++i)
+    {
+        BucketUpdateCallback callback = [](UpdateBucketEnum aBucket, FrameInfo&, JobQueue&)
+        { g_work += static_cast<uint64_t>(aBucket); };
+
+        frame.buckets.push_back(aIsProfiled ? UpdateProfiler::Wrap(UpdateBucketMask::Everything,
+                                                                   UpdateBucketStage::PrePhysicsTick, "bucket update",
+                                                                   std::move(callback))
+                                            : std::move(callback));
+    }
+
+    return frame;
+}
+
+void RunFrame(Frame& aFrame, FrameInfo& aInfo, JobQueue& aJobQueue)
+{
+    UpdateProfiler::NextFrame();
+
+    for (auto& callback : aFrame.groups)
+    {
+        callback(aInfo, aJobQueue);
+    }
+
+    for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        for (auto& callback : aFrame.buckets)
+        {
+            callback(static_cast<UpdateBucketEnum>(bucket), aInfo, aJobQueue);
+        }
+    }
+}
+} // namespace
+
+RED4EXT_BENCHMARK(UpdateProfiler_Frame)
+{
+    FrameDetailedInfo details{};
+    details.deltaTime = 1.0f / 60.0f;
+    details.timeDilation = 1.0f;
+
+    FrameInfo info{};
+    info.deltaTime = details.deltaTime;
+    info.details = &details;
+
+    // The callbacks do not use the queue, it only has to be a reference.
+    alignas(JobQueue) std::byte storage[sizeof(JobQueue)] = {};
+    auto& jobQueue = *reinterpret_cast<JobQueue*>(storage);
+
+    auto plain = MakeFrame(false);
+    auto profiled = MakeFrame(true);
+
+    Benchmarks::Run("Frame, not wrapped", CallsPerFrame, [&] { RunFrame(plain, info, jobQueue); });
+
+    UpdateProfiler::SetEnabled(false);
+    Benchmarks::Run("Frame, wrapped, disabled", CallsPerFrame, [&] { RunFrame(profiled, info, jobQueue); });
+
+    UpdateProfiler::SetEnabled(true);
+    Benchmarks::Run("Frame, wrapped, enabled", CallsPerFrame, [&] { RunFrame(profiled, info, jobQueue); });
+
+    {
+        NullStream stream;
+        TraceWriter writer(stream, TraceWriter::DefaultChunkSize, false);
+
+        UpdateProfiler::SetTraceWriter(&writer);
+        Benchmarks::Run("Frame, wrapped, enabled, traced", CallsPerFrame, [&] { RunFrame(profiled, info, jobQueue); });
+        UpdateProfiler::SetTraceWriter(nullptr);
+    }
+
+    Benchmarks::Run("Detail::ReadCycleCounter", 1000,
+                    [&]
+                    {
+                        uint64_t sum = 0;
+                        for (uint32_t i = 0; i < 1000; ++i)
+                        {
+                            sum += Detail::ReadCycleCounter();
+                        }
+
+                        Benchmarks::DoNotOptimize(sum);
+                    });
+
+    Benchmarks::DoNotOptimize(UpdateProfiler::GetGroupStats(UpdateTickGroup::EntityUpdateState).frames);
+    Benchmarks::DoNotOptimize(g_work);
+}
@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <RED4ext/PackageParser.hpp>
+
+namespace
+{
+using namespace RED4ext;
+
+// Touches every byte handed out by the parser, reads outside of the input are caught by the sanitizers.
+struct TouchingVisitor : PackageParser::Visitor
+{
+    void Touch(const void* aData, size_t aSize)
+    {
+        auto data = static_cast<const uint8_t*>(aData);
+        for (size_t i = 0; i < aSize; ++i)
+        {
+            sum += data[i];
+        }
+    }
+
+    bool OnChunk(uint32_t, StringView aTypeName, const uint8_t* aData, uint32_t aSize) override
+    {
+        Touch(aTypeName.Data(), aTypeName.Length());
+        Touch(aData, aSize);
+        return true;
+    }
+
+    void OnField(uint32_t, uint32_t, const PackageParser::Field& aField) override
+    {
+        Touch(aField.name.Data(), aField.name.Length());
+        Touch(aField.typeName.Data(), aField.typeName.Length());
+        Touch(aField.data, aField.size);
+    }
+
+    uint32_t sum = 0;
+};
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* aData, size_t aSize)
+{
+    if (aSize > UINT32_MAX)
+    {
+        return 0;
+    }
+
+    // Copy the input so that the buffer ends exactly at the end of the input.
+    std::vector<uint8_t> buffer(aData, aData + aSize);
+    PackageParser parser(buffer.data(), static_cast<uint32_t>(buffer.size()));
+
+    PackageHeader header{};
+    if (parser.ParseHeader(header) != PackageParseError::None)
+    {
+        return 0;
+    }
+
+    TouchingVisitor visitor;
+    parser.Visit(visitor);
+
+    for (uint32_t i = 0; i < header.names.GetSize(); ++i)
+    {
+        auto name = parser.GetName(i);
+        visitor.Touch(name.Data(), name.Length());
+    }
+
+    for (uint32_t i = 0; i < header.imports.GetSize(); ++i)
+    {
+        auto path = parser.GetImportPath(i);
+        visitor.Touch(path.Data(), path.Length());
+    }
+
+    return 0;
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/ArchiveReader.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace RED4ext::Detail
+{
+inline uint64_t GetArchiveSlot(uint64_t aHash, uint64_t aMask)
+{
+    // The paths are FNV hashes, mix them once more so that the low bits are usable as an index.
+    auto hash = aHash * 0x9E3779B97F4A7C15ull;
+    return (hash ^ (hash >> 32)) & aMask;
+}
+} // namespace RED4ext::Detail
+
+RED4EXT_INLINE bool RED4ext::StoredArchiveDecompressor::Decompress(const uint8_t* aSrc, uint32_t aSrcSize,
+                                                                   uint8_t* aDst, uint32_t aDstSize) const
+{
+    if (aSrcSize != aDstSize)
+    {
+        return false;
+    }
+
+    std::memcpy(aDst, aSrc, aDstSize);
+    return true;
+}
+
+RED4EXT_INLINE RED4ext::ArchiveReader::ArchiveReader()
+    : m_dependencies(nullptr)
+    , m_dependencyCount(0)
+    , m_slotMask(0)
+{
+}
+
+RED4EXT_INLINE RED4ext::ArchiveReader::ArchiveReader(const std::filesystem::path& aPath)
+    : ArchiveReader()
+{
+    Open(aPath);
+}
+
+RED4EXT_INLINE bool RED4ext::ArchiveReader::Open(const std::filesystem::path& aPath)
+{
+    Close();
+
+    if (!m_file.Open(aPath) || !ReadTables())
+    {
+        Close();
+        return false;
+    }
+
+    BuildIndex();
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::ArchiveReader::Close()
+{
+    m_file.Close();
+    m_files.clear();
+    m_files.shrink_to_fit();
+    m_segments.clear();
+    m_segments.shrink_to_fit();
+    m_dependencies = nullptr;
+    m_dependencyCount = 0;
+    m_slots.clear();
+    m_slots.shrink_to_fit();
+    m_slotMask = 0;
+}
+
+RED4EXT_INLINE bool RED4ext::ArchiveReader::IsOpen() const
+{
+    return m_file.IsOpen();
+}
+
+RED4EXT_INLINE const RED4ext::ArchiveReader::FileEntry* RED4ext::ArchiveReader::Find(ResourcePath aPath) const
+{
+    if (m_slots.empty())
+    {
+        return nullptr;
+    }
+
+    for (auto i = Detail::GetArchiveSlot(aPath.hash, m_slotMask);; i = (i + 1) & m_slotMask)
+    {
+        const auto& slot = m_slots[i];
+        if (slot.index == EmptySlot)
+        {
+            return nullptr;
+        }
+
+        if (slot.hash == aPath.hash)
+        {
+            return &m_files[slot.index];
+        }
+    }
+}
+
+RED4EXT_INLINE bool RED4ext::ArchiveReader::Contains(ResourcePath aPath) const
+{
+    return Find(aPath) != nullptr;
+}
+
+RED4EXT_INLINE RED4ext::Span<const RED4ext::ArchiveReader::FileEntry> RED4ext::ArchiveReader::GetFiles() const
+{
+    return {m_files.data(), m_files.size()};
+}
+
+RED4EXT_INLINE RED4ext::Span<const RED4ext::ArchiveReader::Segment> RED4ext::ArchiveReader::GetSegments(
+    const FileEntry& aEntry) const
+{
+    return {m_segments.data() + aEntry.segmentsStart, m_segments.data() + aEntry.segmentsEnd};
+}
+
+RED4EXT_INLINE uint32_t RED4ext::ArchiveReader::GetDependencyCount(const FileEntry& aEntry) const
+{
+    return aEntry.dependenciesEnd - aEntry.dependenciesStart;
+}
+
+RED4EXT_INLINE RED4ext::ResourcePath RED4ext::ArchiveReader::GetDependency(const FileEntry& aEntry,
+                                                                           uint32_t aIndex) const
+{
+    ResourcePath path;
+    std::memcpy(&path, m_dependencies + (aEntry.dependenciesStart + aIndex) * sizeof(ResourcePath),
+                sizeof(ResourcePath));
+    return path;
+}
+
+RED4EXT_INLINE size_t RED4ext::ArchiveReader::GetExtractedSize(const FileEntry& aEntry) const
+{
+    size_t size = 0;
+    for (const auto& segment : GetSegments(aEntry))
+    {
+        size += segment.size;
+    }
+
+    return size;
+}
+
+RED4EXT_INLINE bool RED4ext::ArchiveReader::Extract(const FileEntry& aEntry,
+                                                    const IArchiveDecompressor& aDecompressor, uint8_t* aOut) const
+{
+    auto data = m_file.GetData();
+    for (const auto& segment : GetSegments(aEntry))
+    {
+        auto src = data + segment.offset;
+        if (segment.zSize == segment.size)
+        {
+            std::memcpy(aOut, src, segment.size);
+        }
+        else if (!aDecompressor.Decompress(src, segment.zSize, aOut, segment.size))
+        {
+            return false;
+        }
+
+        aOut += segment.size;
+    }
+
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::ArchiveReader::Extract(ResourcePath aPath, const IArchiveDecompressor& aDecompressor,
+                                                    std::vector<uint8_t>& aOut) const
+{
+    auto entry = Find(aPath);
+    if (!entry)
+    {
+        return false;
+    }
+
+    aOut.resize(GetExtractedSize(*entry));
+    return Extract(*entry, aDecompressor, aOut.data());
+}
+
+RED4EXT_INLINE size_t RED4ext::ArchiveReader::ExtractParallel(const ResourcePath* aPaths, size_t aCount,
+                                                              const IArchiveDecompressor& aDecompressor,
+                                                              const ExtractCallback& aCallback,
+                                                              uint32_t aThreadCount) const
+{
+    if (aThreadCount == 0)
+    {
+        aThreadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    aThreadCount = static_cast<uint32_t>((std::min)(static_cast<size_t>(aThreadCount), aCount));
+
+    std::atomic<size_t> next = 0;
+    std::atomic<size_t> extracted = 0;
+
+    auto worker = [&]()
+    {
+        // The buffer is reused for every file handled by this thread.
+        std::vector<uint8_t> buffer;
+
+        for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < aCount;
+             i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            auto entry = Find(aPaths[i]);
+            if (!entry)
+            {
+                continue;
+            }
+
+            auto size = GetExtractedSize(*entry);
+            if (buffer.size() < size)
+            {
+                buffer.resize(size);
+            }
+
+            if (Extract(*entry, aDecompressor, buffer.data()))
+            {
+                aCallback(*entry, buffer.data(), size);
+                extracted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    if (aThreadCount > 1)
+    {
+        threads.reserve(aThreadCount - 1);
+    }
+
+    for (auto i = 1u; i < aThreadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return extracted.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE bool RED4ext::ArchiveReader::ReadTables()
+{
+    auto data = m_file.GetData();
+    auto size = m_file.GetLength();
+
+    if (size < sizeof(Header))
+    {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != Magic || header.indexPosition > size || size - header.indexPosition < sizeof(IndexHeader))
+    {
+        return false;
+    }
+
+    IndexHeader index;
+    std::memcpy(&index, data + header.indexPosition, sizeof(IndexHeader));
+
+    // The tables follow the index header, validate them all before anything is read.
+    auto tablesOffset = header.indexPosition + sizeof(IndexHeader);
+    auto tablesSize = static_cast<uint64_t>(index.fileCount) * sizeof(FileEntry) +
+                      static_cast<uint64_t>(index.segmentCount) * sizeof(Segment) +
+                      static_cast<uint64_t>(index.dependencyCount) * sizeof(ResourcePath);
+    if (tablesSize > size - tablesOffset)
+    {
+        return false;
+    }
+
+    // The tables are not aligned in the file, the file and segment tables are copied out once. Empty tables are
+    // skipped, memcpy must not be given the null pointer of an empty vector.
+    auto tables = data + tablesOffset;
+    m_files.resize(index.fileCount);
+    if (!m_files.empty())
+    {
+        std::memcpy(m_files.data(), tables, m_files.size() * sizeof(FileEntry));
+        tables += m_files.size() * sizeof(FileEntry);
+    }
+
+    m_segments.resize(index.segmentCount);
+    if (!m_segments.empty())
+    {
+        std::memcpy(m_segments.data(), tables, m_segments.size() * sizeof(Segment));
+        tables += m_segments.size() * sizeof(Segment);
+    }
+
+    m_dependencies = tables;
+    m_dependencyCount = index.dependencyCount;
+
+    for (const auto& segment : m_segments)
+    {
+        if (segment.offset > size || segment.zSize > size - segment.offset)
+        {
+            return false;
+        }
+    }
+
+    for (const auto& entry : m_files)
+    {
+        if (entry.segmentsStart > entry.segmentsEnd || entry.segmentsEnd > m_segments.size() ||
+            entry.dependenciesStart > entry.dependenciesEnd || entry.dependenciesEnd > m_dependencyCount)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::ArchiveReader::BuildIndex()
+{
+    // Keep the load factor at or below 50% so that probe sequences stay short.
+    uint64_t capacity = 16;
+    while (capacity < m_files.size() * 2)
+    {
+        capacity *= 2;
+    }
+
+    m_slots.assign(capacity, {0, EmptySlot});
+    m_slotMask = capacity - 1;
+
+    for (uint32_t i = 0; i < m_files.size(); ++i)
+    {
+        auto hash = m_files[i].path.hash;
+        for (auto j = Detail::GetArchiveSlot(hash, m_slotMask);; j = (j + 1) & m_slotMask)
+        {
+            auto& slot = m_slots[j];
+            if (slot.index == EmptySlot)
+            {
+                slot = {hash, i};
+                break;
+            }
+
+            // Keep the first entry if the archive lists a path twice.
+            if (slot.hash == hash)
+            {
+                break;
+            }
+        }
+    }
+}
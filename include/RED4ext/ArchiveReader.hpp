@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/IO/MappedFileStream.hpp>
+#include <RED4ext/ResourcePath.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Decompresses archive segments, implementations must be thread-safe.
+ */
+class IArchiveDecompressor
+{
+public:
+    virtual ~IArchiveDecompressor() = default;
+
+    /**
+     * @brief Decompresses a segment.
+     * @param aSrc The stored data.
+     * @param aSrcSize The size of the stored data.
+     * @param aDst Receives exactly aDstSize bytes.
+     * @param aDstSize The uncompressed size of the segment.
+     * @return True on success.
+     */
+    virtual bool Decompress(const uint8_t* aSrc, uint32_t aSrcSize, uint8_t* aDst, uint32_t aDstSize) const = 0;
+};
+
+/**
+ * @brief Handles segments that are stored without compression, fails for everything else.
+ */
+class StoredArchiveDecompressor : public IArchiveDecompressor
+{
+public:
+    bool Decompress(const uint8_t* aSrc, uint32_t aSrcSize, uint8_t* aDst, uint32_t aDstSize) const override;
+};
+
+/**
+ * @brief Reads .archive files without the game, the file is mapped into memory and looked up by resource path.
+ *
+ * The file and segment tables are copied out of the mapping when the archive is opened, the entries returned by
+ * Find(), GetFiles() and GetSegments() are aligned and stay valid until the archive is closed.
+ */
+class ArchiveReader
+{
+public:
+    static constexpr uint32_t Magic = 0x52414452; // RDAR
+
+#pragma pack(push, 1)
+    struct Header
+    {
+        uint32_t magic;         // 00
+        uint32_t version;       // 04
+        uint64_t indexPosition; // 08
+        uint32_t indexSize;     // 10
+        uint64_t debugPosition; // 14
+        uint32_t debugSize;     // 1C
+        uint64_t fileSize;      // 20
+    };
+    RED4EXT_ASSERT_SIZE(Header, 0x28);
+
+    struct IndexHeader
+    {
+        uint32_t fileTableOffset; // 00
+        uint32_t fileTableSize;   // 04
+        uint64_t crc;             // 08
+        uint32_t fileCount;       // 10
+        uint32_t segmentCount;    // 14
+        uint32_t dependencyCount; // 18
+    };
+    RED4EXT_ASSERT_SIZE(IndexHeader, 0x1C);
+
+    struct FileEntry
+    {
+        ResourcePath path;           // 00
+        int64_t timestamp;           // 08
+        uint32_t inlineSegmentCount; // 10
+        uint32_t segmentsStart;      // 14
+        uint32_t segmentsEnd;        // 18
+        uint32_t dependenciesStart;  // 1C
+        uint32_t dependenciesEnd;    // 20
+        uint8_t sha1[20];            // 24
+    };
+    RED4EXT_ASSERT_SIZE(FileEntry, 0x38);
+
+    struct Segment
+    {
+        uint64_t offset; // 00
+        uint32_t zSize;  // 08 - Stored size
+        uint32_t size;   // 0C - Uncompressed size
+    };
+    RED4EXT_ASSERT_SIZE(Segment, 0x10);
+#pragma pack(pop)
+
+    using ExtractCallback = std::function<void(const FileEntry&, const uint8_t*, size_t)>;
+
+    ArchiveReader();
+    explicit ArchiveReader(const std::filesystem::path& aPath);
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    /**
+     * @brief Maps the archive, validates the file and segment tables and builds the index.
+     * @return True on success.
+     */
+    bool Open(const std::filesystem::path& aPath);
+    void Close();
+    bool IsOpen() const;
+
+    const FileEntry* Find(ResourcePath aPath) const;
+    bool Contains(ResourcePath aPath) const;
+
+    Span<const FileEntry> GetFiles() const;
+    Span<const Segment> GetSegments(const FileEntry& aEntry) const;
+
+    uint32_t GetDependencyCount(const FileEntry& aEntry) const;
+
+    /**
+     * @brief Returns a dependency of a file. The dependency table is not aligned in the file, it is read by value.
+     * @param aEntry The file.
+     * @param aIndex The index of the dependency, must be less than GetDependencyCount().
+     */
+    ResourcePath GetDependency(const FileEntry& aEntry, uint32_t aIndex) const;
+
+    /**
+     * @brief Returns the size of the extracted file, the sum of the uncompressed size of all segments.
+     */
+    size_t GetExtractedSize(const FileEntry& aEntry) const;
+
+    /**
+     * @brief Extracts a file into a buffer.
+     * @param aEntry The file.
+     * @param aDecompressor The decompressor for compressed segments.
+     * @param aOut The buffer, must hold GetExtractedSize() bytes.
+     * @return True on success.
+     */
+    bool Extract(const FileEntry& aEntry, const IArchiveDecompressor& aDecompressor, uint8_t* aOut) const;
+    bool Extract(ResourcePath aPath, const IArchiveDecompressor& aDecompressor, std::vector<uint8_t>& aOut) const;
+
+    /**
+     * @brief Extracts multiple files across multiple threads.
+     * @param aPaths The files to extract, unknown paths are skipped.
+     * @param aCount The number of paths.
+     * @param aDecompressor The decompressor for compressed segments.
+     * @param aCallback Called from the worker threads for every extracted file, the data is only valid during the call.
+     * @param aThreadCount The number of threads, 0 to use the hardware concurrency.
+     * @return The number of files extracted.
+     */
+    size_t ExtractParallel(const ResourcePath* aPaths, size_t aCount, const IArchiveDecompressor& aDecompressor,
+                           const ExtractCallback& aCallback, uint32_t aThreadCount = 0) const;
+
+private:
+    static constexpr uint32_t EmptySlot = UINT32_MAX;
+
+    struct Slot
+    {
+        uint64_t hash;
+        uint32_t index;
+    };
+
+    bool ReadTables();
+    void BuildIndex();
+
+    MappedFileStream m_file;
+    std::vector<FileEntry> m_files; // Copied out of the mapping, the table is not aligned in the file.
+    std::vector<Segment> m_segments;
+    const uint8_t* m_dependencies; // Not aligned, use GetDependency().
+    uint32_t m_dependencyCount;
+    std::vector<Slot> m_slots;
+    uint64_t m_slotMask;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/ArchiveReader-inl.hpp>
+#endif
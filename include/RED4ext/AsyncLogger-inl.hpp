@@ -0,0 +1,315 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/AsyncLogger.hpp>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+RED4EXT_INLINE RED4ext::AsyncLogger::Ring::Ring(uint32_t aCapacity)
+    : head(0)
+    , tail(0)
+    , cachedTail(0)
+    , pending(0)
+    , capacity(aCapacity)
+    , data(new uint8_t[aCapacity])
+    , isAbandoned(false)
+{
+}
+
+RED4EXT_INLINE RED4ext::AsyncLogger::ThreadRings::~ThreadRings()
+{
+    // Publishes the producer's state of the ring to the thread that takes it over.
+    for (const auto& entry : entries)
+    {
+        entry.ring->isAbandoned.store(true, std::memory_order_release);
+    }
+}
+
+RED4EXT_INLINE RED4ext::AsyncLogger::AsyncLogger(const v0::Logger* aLogger, PluginHandle aHandle,
+                                                 OverflowPolicy aPolicy, uint32_t aRingSize)
+    : m_logger(aLogger)
+    , m_handle(aHandle)
+    , m_policy(aPolicy)
+    , m_ringSize(std::bit_ceil((std::max)(aRingSize, static_cast<uint32_t>(4096))))
+    , m_ringCount(0)
+    , m_dropped(0)
+    , m_reported(0)
+    , m_isRunning(true)
+{
+    static std::atomic<uint64_t> nextId = 1;
+    m_id = nextId.fetch_add(1, std::memory_order_relaxed);
+
+    m_thread = std::thread(&AsyncLogger::Run, this);
+}
+
+RED4EXT_INLINE RED4ext::AsyncLogger::~AsyncLogger()
+{
+    m_isRunning.store(false, std::memory_order_release);
+    m_thread.join();
+
+    // The consumer drained the rings before it stopped, forget about them on this thread too.
+    auto& threadRings = GetThreadRings();
+    std::erase_if(threadRings, [this](const ThreadRing& aEntry) { return aEntry.loggerId == m_id; });
+}
+
+RED4EXT_INLINE void RED4ext::AsyncLogger::Flush()
+{
+    std::vector<std::pair<Ring*, uint64_t>> targets;
+    {
+        std::lock_guard<std::mutex> _(m_ringsLock);
+        for (const auto& ring : m_rings)
+        {
+            targets.emplace_back(ring.get(), ring->head.load(std::memory_order_acquire));
+        }
+    }
+
+    for (auto [ring, head] : targets)
+    {
+        while (ring->tail.load(std::memory_order_acquire) < head)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+RED4EXT_INLINE uint64_t RED4ext::AsyncLogger::GetDroppedCount() const noexcept
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE size_t RED4ext::AsyncLogger::GetRingCount() const noexcept
+{
+    return m_ringCount.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE std::vector<RED4ext::AsyncLogger::ThreadRing>& RED4ext::AsyncLogger::GetThreadRings()
+{
+    static thread_local ThreadRings rings;
+    return rings.entries;
+}
+
+RED4EXT_INLINE void* RED4ext::AsyncLogger::Reserve(size_t aSize)
+{
+    auto ring = GetRing();
+
+    // Keep the records aligned, and large enough that the ring can always hold one next to padding.
+    aSize = (aSize + 7) & ~static_cast<size_t>(7);
+    if (aSize > ring->capacity / 4)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto head = ring->head.load(std::memory_order_relaxed);
+    auto offset = static_cast<uint32_t>(head & (ring->capacity - 1));
+
+    // A record does not wrap, skip the end of the ring if it does not fit there.
+    auto padding = ring->capacity - offset < aSize ? ring->capacity - offset : 0;
+    auto required = padding + aSize;
+
+    while (head + required - ring->cachedTail > ring->capacity)
+    {
+        ring->cachedTail = ring->tail.load(std::memory_order_acquire);
+        if (head + required - ring->cachedTail <= ring->capacity)
+        {
+            break;
+        }
+
+        if (m_policy != OverflowPolicy::Block || !m_isRunning.load(std::memory_order_relaxed))
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        std::this_thread::yield();
+    }
+
+    if (padding)
+    {
+        uint32_t marker = padding | PaddingFlag;
+        std::memcpy(ring->data.get() + offset, &marker, sizeof(marker));
+        offset = 0;
+    }
+
+    auto record = reinterpret_cast<Record*>(ring->data.get() + offset);
+    record->size = static_cast<uint32_t>(aSize);
+
+    ring->pending = head + required;
+    return record;
+}
+
+RED4EXT_INLINE void RED4ext::AsyncLogger::Commit()
+{
+    // Reserve() was called on this thread right before, the ring is the first one.
+    auto ring = GetThreadRings().front().ring.get();
+    ring->head.store(ring->pending, std::memory_order_release);
+}
+
+RED4EXT_INLINE RED4ext::AsyncLogger::Ring* RED4ext::AsyncLogger::GetRing()
+{
+    auto& threadRings = GetThreadRings();
+    if (!threadRings.empty() && threadRings.front().loggerId == m_id)
+    {
+        return threadRings.front().ring.get();
+    }
+
+    // Threads usually log to a single logger, keep the last one used in front.
+    auto it = std::find_if(threadRings.begin(), threadRings.end(),
+                           [this](const ThreadRing& aEntry) { return aEntry.loggerId == m_id; });
+
+    if (it == threadRings.end())
+    {
+        std::shared_ptr<Ring> ring;
+        {
+            std::lock_guard<std::mutex> _(m_ringsLock);
+
+            // Take over the ring of a thread that exited, the consumer keeps draining it in order.
+            for (const auto& candidate : m_rings)
+            {
+                auto isAbandoned = true;
+                if (candidate->isAbandoned.compare_exchange_strong(isAbandoned, false, std::memory_order_acquire))
+                {
+                    ring = candidate;
+                    break;
+                }
+            }
+
+            if (!ring)
+            {
+                ring = std::make_shared<Ring>(m_ringSize);
+                m_rings.push_back(ring);
+                m_ringCount.store(m_rings.size(), std::memory_order_release);
+            }
+        }
+
+        threadRings.push_back({m_id, std::move(ring)});
+        it = threadRings.end() - 1;
+    }
+
+    std::rotate(threadRings.begin(), it, it + 1);
+    return threadRings.front().ring.get();
+}
+
+RED4EXT_INLINE void RED4ext::AsyncLogger::Run()
+{
+    auto idle = std::chrono::microseconds(100);
+
+    while (m_isRunning.load(std::memory_order_acquire))
+    {
+        if (Drain())
+        {
+            idle = std::chrono::microseconds(100);
+            continue;
+        }
+
+        // Back off while nothing is logged, producers never have to wake the thread up.
+        std::this_thread::sleep_for(idle);
+        idle = (std::min)(idle * 2, std::chrono::microseconds(5000));
+    }
+
+    while (Drain())
+    {
+    }
+}
+
+RED4EXT_INLINE bool RED4ext::AsyncLogger::Drain()
+{
+    // Only pick up the rings of new threads, the list rarely changes.
+    if (m_consumerRings.size() != m_ringCount.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> _(m_ringsLock);
+        m_consumerRings.clear();
+
+        for (const auto& ring : m_rings)
+        {
+            m_consumerRings.push_back(ring.get());
+        }
+    }
+
+    char message[MaxMessageLength];
+    bool hasDrained = false;
+
+    for (auto ring : m_consumerRings)
+    {
+        auto tail = ring->tail.load(std::memory_order_relaxed);
+        auto head = ring->head.load(std::memory_order_acquire);
+
+        while (tail < head)
+        {
+            auto offset = static_cast<uint32_t>(tail & (ring->capacity - 1));
+            auto record = reinterpret_cast<const Record*>(ring->data.get() + offset);
+
+            uint32_t size;
+            std::memcpy(&size, record, sizeof(size));
+
+            if ((size & PaddingFlag) == 0)
+            {
+                record->formatter(record->format, reinterpret_cast<const uint8_t*>(record + 1), message,
+                                  sizeof(message));
+                Write(record->level, message);
+            }
+
+            tail += size & ~PaddingFlag;
+
+            // Give the memory back right away, a blocked producer might be waiting for it.
+            ring->tail.store(tail, std::memory_order_release);
+            hasDrained = true;
+        }
+    }
+
+    if (m_policy == OverflowPolicy::Count)
+    {
+        ReportDropped();
+    }
+
+    return hasDrained;
+}
+
+RED4EXT_INLINE void RED4ext::AsyncLogger::Write(LogLevel aLevel, const char* aMessage) const
+{
+    if (!m_logger)
+    {
+        return;
+    }
+
+    switch (aLevel)
+    {
+    case LogLevel::Trace:
+        m_logger->Trace(m_handle, aMessage);
+        break;
+    case LogLevel::Debug:
+        m_logger->Debug(m_handle, aMessage);
+        break;
+    case LogLevel::Info:
+        m_logger->Info(m_handle, aMessage);
+        break;
+    case LogLevel::Warn:
+        m_logger->Warn(m_handle, aMessage);
+        break;
+    case LogLevel::Error:
+        m_logger->Error(m_handle, aMessage);
+        break;
+    case LogLevel::Critical:
+        m_logger->Critical(m_handle, aMessage);
+        break;
+    }
+}
+
+RED4EXT_INLINE void RED4ext::AsyncLogger::ReportDropped()
+{
+    auto dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_reported)
+    {
+        return;
+    }
+
+    char message[64];
+    std::snprintf(message, sizeof(message), "%llu log message(s) were dropped",
+                  static_cast<unsigned long long>(dropped - m_reported));
+
+    Write(LogLevel::Warn, message);
+    m_reported = dropped;
+}
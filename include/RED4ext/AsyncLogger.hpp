@@ -0,0 +1,352 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <RED4ext/Api/PluginHandle.hpp>
+#include <RED4ext/Api/v0/Logger.hpp>
+#include <RED4ext/Common.hpp>
+
+/**
+ * @brief Messages below this level are removed at compile time, see RED4ext::LogLevel for the values.
+ */
+#ifndef RED4EXT_ASYNC_LOG_LEVEL
+#define RED4EXT_ASYNC_LOG_LEVEL 0
+#endif
+
+namespace RED4ext
+{
+enum class LogLevel : uint8_t
+{
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Critical = 5
+};
+
+namespace Detail
+{
+template<typename T>
+inline constexpr bool IsLogString =
+    std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+
+template<typename T>
+inline constexpr bool IsLogValue = std::is_arithmetic_v<std::decay_t<T>> || std::is_enum_v<std::decay_t<T>> ||
+                                   std::is_pointer_v<std::decay_t<T>>;
+
+// Strings are copied with their length in front, a null string is marked by the largest length.
+inline constexpr uint32_t NullLogString = UINT32_MAX;
+
+template<typename T>
+bool IsNullLogString(const T& aArg) noexcept
+{
+    // Arrays are never null, comparing them warns.
+    if constexpr (std::is_array_v<T>)
+    {
+        return false;
+    }
+    else
+    {
+        return aArg == nullptr;
+    }
+}
+
+template<typename T>
+size_t GetLogArgSize(const T& aArg) noexcept
+{
+    if constexpr (IsLogString<T>)
+    {
+        return sizeof(uint32_t) + (IsNullLogString(aArg) ? 0 : std::strlen(aArg) + 1);
+    }
+    else
+    {
+        return sizeof(std::decay_t<T>);
+    }
+}
+
+template<typename T>
+uint8_t* WriteLogArg(uint8_t* aOut, const T& aArg) noexcept
+{
+    if constexpr (IsLogString<T>)
+    {
+        auto isNull = IsNullLogString(aArg);
+        uint32_t length = isNull ? NullLogString : static_cast<uint32_t>(std::strlen(aArg));
+        std::memcpy(aOut, &length, sizeof(length));
+        aOut += sizeof(length);
+
+        if (!isNull)
+        {
+            std::memcpy(aOut, aArg, length + 1);
+            aOut += length + 1;
+        }
+
+        return aOut;
+    }
+    else
+    {
+        std::decay_t<T> value = aArg;
+        std::memcpy(aOut, &value, sizeof(value));
+        return aOut + sizeof(value);
+    }
+}
+
+template<typename T>
+auto ReadLogArg(const uint8_t*& aIn) noexcept
+{
+    if constexpr (IsLogString<T>)
+    {
+        uint32_t length;
+        std::memcpy(&length, aIn, sizeof(length));
+        aIn += sizeof(length);
+
+        if (length == NullLogString)
+        {
+            return "(null)";
+        }
+
+        auto string = reinterpret_cast<const char*>(aIn);
+        aIn += length + 1;
+        return string;
+    }
+    else
+    {
+        std::decay_t<T> value;
+        std::memcpy(&value, aIn, sizeof(value));
+        aIn += sizeof(value);
+        return value;
+    }
+}
+
+/**
+ * @brief Formats the captured arguments of a message, one instantiation per argument list.
+ */
+template<typename... Args>
+int FormatLogArgs(const char* aFormat, const uint8_t* aArgs, char* aOut, size_t aSize) noexcept
+{
+    // The arguments of a braced initializer are evaluated in order.
+    const uint8_t* in = aArgs;
+    std::tuple<decltype(ReadLogArg<Args>(in))...> values{ReadLogArg<Args>(in)...};
+
+    return std::apply([aFormat, aOut, aSize](auto... aValues)
+                      { return std::snprintf(aOut, aSize, aFormat, aValues...); },
+                      values);
+}
+} // namespace Detail
+
+/**
+ * @brief A logging front-end that formats and writes messages on a background thread.
+ *
+ * A call captures the format string and copies the raw arguments into a ring buffer owned by the calling thread, no
+ * lock is taken and nothing is formatted. A consumer thread drains the rings, formats the messages and passes them to
+ * the loader's logger. Messages of one thread keep their order, messages of different threads might be interleaved
+ * differently than they were logged.
+ *
+ * Format strings must outlive the logger (e.g. string literals). The arguments must be arithmetic values, enums,
+ * pointers or C strings, strings are copied.
+ *
+ * The ring of a thread that exits is taken over by the next thread that logs for the first time, the number of rings
+ * is bounded by the number of threads logging at the same time. The rings of other threads are freed when those
+ * threads exit, not with the logger.
+ */
+class AsyncLogger
+{
+public:
+    static constexpr LogLevel MinLevel = static_cast<LogLevel>(RED4EXT_ASYNC_LOG_LEVEL);
+
+    enum class OverflowPolicy : uint8_t
+    {
+        Drop,  // Discard the message.
+        Block, // Wait until the consumer made room.
+        Count  // Discard the message, the consumer logs how many were discarded.
+    };
+
+    /**
+     * @param aLogger The loader's logger.
+     * @param aHandle The plugin's handle.
+     * @param aPolicy What to do when the ring of a thread is full.
+     * @param aRingSize The size of the ring of each thread in bytes, rounded up to a power of two.
+     */
+    AsyncLogger(const v0::Logger* aLogger, PluginHandle aHandle, OverflowPolicy aPolicy = OverflowPolicy::Count,
+                uint32_t aRingSize = 64 * 1024);
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief Writes the pending messages and stops the consumer thread. No thread may log anymore.
+     */
+    ~AsyncLogger();
+
+    /**
+     * @brief Captures a message.
+     * @return False if the message was discarded.
+     */
+    template<LogLevel L, typename... Args>
+    bool Log(const char* aFormat, const Args&... aArgs)
+    {
+        static_assert((... && (Detail::IsLogString<Args> || Detail::IsLogValue<Args>)),
+                      "Arguments must be arithmetic values, enums, pointers or C strings");
+
+        if constexpr (L < MinLevel)
+        {
+            return true;
+        }
+        else
+        {
+            auto size = sizeof(Record) + (size_t{0} + ... + Detail::GetLogArgSize(aArgs));
+
+            auto record = static_cast<Record*>(Reserve(size));
+            if (!record)
+            {
+                return false;
+            }
+
+            record->level = L;
+            record->format = aFormat;
+            record->formatter = &Detail::FormatLogArgs<Args...>;
+
+            auto out = reinterpret_cast<uint8_t*>(record + 1);
+            ((out = Detail::WriteLogArg(out, aArgs)), ...);
+
+            Commit();
+            return true;
+        }
+    }
+
+    template<typename... Args>
+    bool Trace(const char* aFormat, const Args&... aArgs)
+    {
+        return Log<LogLevel::Trace>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    bool Debug(const char* aFormat, const Args&... aArgs)
+    {
+        return Log<LogLevel::Debug>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    bool Info(const char* aFormat, const Args&... aArgs)
+    {
+        return Log<LogLevel::Info>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    bool Warn(const char* aFormat, const Args&... aArgs)
+    {
+        return Log<LogLevel::Warn>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    bool Error(const char* aFormat, const Args&... aArgs)
+    {
+        return Log<LogLevel::Error>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    bool Critical(const char* aFormat, const Args&... aArgs)
+    {
+        return Log<LogLevel::Critical>(aFormat, aArgs...);
+    }
+
+    /**
+     * @brief Waits until every message captured before the call has been written.
+     */
+    void Flush();
+
+    /**
+     * @brief Returns the number of messages that were discarded because a ring was full.
+     */
+    [[nodiscard]] uint64_t GetDroppedCount() const noexcept;
+
+    /**
+     * @brief Returns the number of rings, including the ones of exited threads that wait to be taken over.
+     */
+    [[nodiscard]] size_t GetRingCount() const noexcept;
+
+private:
+    static constexpr size_t MaxMessageLength = 2048;
+
+    using Formatter = int (*)(const char* aFormat, const uint8_t* aArgs, char* aOut, size_t aSize);
+
+    struct Record
+    {
+        uint32_t size; // Including the header and the arguments, the high bit marks padding up to the end of the ring.
+        LogLevel level;
+        const char* format;
+        Formatter formatter;
+        // Arguments.
+    };
+
+    struct Ring
+    {
+        explicit Ring(uint32_t aCapacity);
+
+        alignas(64) std::atomic<uint64_t> head; // Written by the producer.
+        alignas(64) std::atomic<uint64_t> tail; // Written by the consumer.
+        alignas(64) uint64_t cachedTail;        // The producer's last view of the tail.
+        uint64_t pending;                       // The head after the reserved record.
+        uint32_t capacity;
+        std::unique_ptr<uint8_t[]> data;
+        std::atomic<bool> isAbandoned; // Set when the producing thread exits.
+    };
+
+    struct ThreadRing
+    {
+        uint64_t loggerId;
+        std::shared_ptr<Ring> ring; // Shared, the thread might outlive the logger.
+    };
+
+    // Gives the rings back when the thread exits.
+    struct ThreadRings
+    {
+        ~ThreadRings();
+
+        std::vector<ThreadRing> entries;
+    };
+
+    static constexpr uint32_t PaddingFlag = 0x80000000;
+
+    static std::vector<ThreadRing>& GetThreadRings();
+
+    void* Reserve(size_t aSize);
+    void Commit();
+    Ring* GetRing();
+
+    void Run();
+    bool Drain();
+    void Write(LogLevel aLevel, const char* aMessage) const;
+    void ReportDropped();
+
+    const v0::Logger* m_logger;
+    PluginHandle m_handle;
+    OverflowPolicy m_policy;
+    uint32_t m_ringSize;
+    uint64_t m_id; // Unique per logger, the address could be reused by another one.
+
+    std::mutex m_ringsLock;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+    std::atomic<size_t> m_ringCount;
+    std::vector<Ring*> m_consumerRings; // Only used by the consumer.
+
+    std::atomic<uint64_t> m_dropped;
+    uint64_t m_reported; // Only used by the consumer.
+
+    std::atomic<bool> m_isRunning;
+    std::thread m_thread;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/AsyncLogger-inl.hpp>
+#endif
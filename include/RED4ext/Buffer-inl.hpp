@@ -4,6 +4,12 @@
 #include <RED4ext/Buffer.hpp>
 #endif
 
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 RED4EXT_INLINE RED4ext::RawBufferAllocator::RawBufferAllocator(Memory::IAllocator* aAllocator)
     : allocator(aAllocator ? *reinterpret_cast<uintptr_t*>(aAllocator) : 0)
 {
@@ -36,6 +42,31 @@ RED4EXT_INLINE RED4ext::Memory::IAllocator* RED4ext::RawBufferAllocator::GetAllo
     return reinterpret_cast<Memory::IAllocator*>(const_cast<uintptr_t*>(&allocator));
 }
 
+RED4EXT_INLINE RED4ext::MappedRawBufferAllocator::MappedRawBufferAllocator(size_t aSize)
+    : RawBufferAllocator(nullptr)
+{
+    allocator = aSize;
+}
+
+RED4EXT_INLINE void* RED4ext::MappedRawBufferAllocator::ReallocAligned(void*, uint32_t, uint32_t) const
+{
+    return nullptr;
+}
+
+RED4EXT_INLINE void RED4ext::MappedRawBufferAllocator::Free(void* aData) const
+{
+#if defined(_WIN32) || defined(_WIN64)
+    UnmapViewOfFile(aData);
+#else
+    munmap(aData, allocator);
+#endif
+}
+
+RED4EXT_INLINE RED4ext::Memory::IAllocator* RED4ext::MappedRawBufferAllocator::GetAllocator() const
+{
+    return nullptr;
+}
+
 RED4EXT_INLINE RED4ext::RawBuffer::RawBuffer()
     : data(nullptr)
     , size(0)
@@ -96,10 +127,48 @@ RED4EXT_INLINE void RED4ext::RawBuffer::Resize(uint32_t aSize)
         return;
     }
 
-    data = reinterpret_cast<RawBufferAllocator*>(&allocator)->ReallocAligned(data, aSize, alignment);
+    // Keep the old memory if it could not be reallocated, e.g. when the buffer owns a mapped view.
+    auto newData = reinterpret_cast<RawBufferAllocator*>(&allocator)->ReallocAligned(data, aSize, alignment);
+    if (!newData)
+    {
+        return;
+    }
+
+    data = newData;
     size = aSize;
 }
 
+RED4EXT_INLINE bool RED4ext::RawBuffer::TakeOwnership(void* aData, uint32_t aSize, Memory::IAllocator* aAllocator,
+                                                      uint32_t aAlignment)
+{
+    if (data || !aData || !aAllocator)
+    {
+        return false;
+    }
+
+    data = aData;
+    size = aSize;
+    alignment = aAlignment;
+
+    new (reinterpret_cast<RawBufferAllocator*>(&allocator)) RawBufferAllocator(aAllocator);
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::RawBuffer::TakeMappingOwnership(void* aView, uint32_t aSize)
+{
+    if (data || !aView)
+    {
+        return false;
+    }
+
+    data = aView;
+    size = aSize;
+    alignment = 8;
+
+    new (reinterpret_cast<MappedRawBufferAllocator*>(&allocator)) MappedRawBufferAllocator(aSize);
+    return true;
+}
+
 RED4EXT_INLINE RED4ext::RawBuffer::operator bool() const noexcept
 {
     return data;
@@ -21,6 +21,22 @@ struct RawBufferAllocator
 };
 RED4EXT_ASSERT_SIZE(RawBufferAllocator, 0x10);
 
+/**
+ * @brief Releases a memory mapped view instead of returning the memory to an allocator.
+ *
+ * The mapping can not be reallocated, a buffer that owns it can not be resized. The size of the view is kept in place
+ * of the allocator's vtable.
+ */
+struct MappedRawBufferAllocator : RawBufferAllocator
+{
+    MappedRawBufferAllocator(size_t aSize);
+
+    void* ReallocAligned(void* aData, uint32_t aSize, uint32_t aAlignment) const override;
+    void Free(void* aData) const override;
+    Memory::IAllocator* GetAllocator() const override;
+};
+RED4EXT_ASSERT_SIZE(MappedRawBufferAllocator, 0x10);
+
 struct RawBuffer
 {
     using AllocatorType = Memory::EngineAllocator;
@@ -35,6 +51,24 @@ struct RawBuffer
     void Initialize(Memory::IAllocator* aAllocator, uint32_t aSize, uint32_t aAlignment = 8);
     void Resize(uint32_t aSize);
 
+    /**
+     * @brief Adopts memory that was allocated by the allocator, nothing is copied.
+     * @param aData The memory.
+     * @param aSize The size of the memory.
+     * @param aAllocator The allocator that allocated the memory, it is used to resize and free it.
+     * @param aAlignment The alignment of the memory.
+     * @return False if the buffer already holds data.
+     */
+    bool TakeOwnership(void* aData, uint32_t aSize, Memory::IAllocator* aAllocator, uint32_t aAlignment = 8);
+
+    /**
+     * @brief Adopts a memory mapped view, nothing is copied. The view is unmapped when the buffer is destroyed.
+     * @param aView The start of the view, as returned by mmap() or MapViewOfFile().
+     * @param aSize The size of the view.
+     * @return False if the buffer already holds data.
+     */
+    bool TakeMappingOwnership(void* aView, uint32_t aSize);
+
     operator bool() const noexcept;
 
     void* data;            // 00
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <new>
 #include <type_traits>
 
 #include <RED4ext/Common.hpp>
@@ -12,6 +13,16 @@ namespace RED4ext
 constexpr size_t DefaultFixedCallbackBufferSize = 32;
 constexpr size_t DefaultFlexCallbackBufferSize = 24;
 
+/**
+ * @brief What a Callback does with a closure that does not fit into its buffer.
+ */
+enum class SpillPolicy : uint8_t
+{
+    Forbid, // Fail to compile.
+    Pool,   // Move the closure into a block of the per-thread pool of the creating thread.
+    Heap    // Move the closure to the heap.
+};
+
 template<typename R, typename... Args>
 struct CallbackHandler
 {
@@ -56,14 +67,22 @@ RED4EXT_ASSERT_OFFSET(CallbackHandler<void>, copy, 0x08);
 RED4EXT_ASSERT_OFFSET(CallbackHandler<void>, move, 0x10);
 RED4EXT_ASSERT_OFFSET(CallbackHandler<void>, destruct, 0x18);
 
-template<typename T, size_t InlineSize = DefaultFixedCallbackBufferSize>
+/**
+ * @brief A callback that stores its target inline.
+ *
+ * A spilled closure (see SpillPolicy) leaves a pointer to it in the buffer and uses a handler that owns the pointer,
+ * the layout stays the same as the game's.
+ */
+template<typename T, size_t InlineSize = DefaultFixedCallbackBufferSize, SpillPolicy Policy = SpillPolicy::Forbid>
 class Callback;
 
-template<typename R, typename... Args, size_t InlineSize>
-class Callback<R (*)(Args...), InlineSize>
+template<typename R, typename... Args, size_t InlineSize, SpillPolicy Policy>
+class Callback<R (*)(Args...), InlineSize, Policy>
 {
 public:
     using HandlerPtr = CallbackHandler<R, Args...>*;
+    using SpillStorage = std::conditional_t<Policy == SpillPolicy::Pool, Detail::CallbackPoolStorage,
+                                            Detail::CallbackHeapStorage>;
 
     static_assert(InlineSize >= sizeof(void*), "Buffer size can't be less than pointer size");
 
@@ -100,9 +119,29 @@ public:
     {
         using TargetType = Detail::ClosureTarget<L, R, Args...>;
 
-        static_assert(sizeof(TargetType) <= InlineSize, "Closure size is too big for this callback");
+        if constexpr (sizeof(TargetType) <= InlineSize)
+        {
+            InitializeHandler(reinterpret_cast<TargetType*>(&aClosure));
+        }
+        else
+        {
+            static_assert(Policy != SpillPolicy::Forbid, "Closure size is too big for this callback");
 
-        InitializeHandler(reinterpret_cast<TargetType*>(&aClosure));
+            using SpilledType = Detail::SpilledClosureTarget<L, SpillStorage, R, Args...>;
+            InitializeSpilled<SpilledType>(SpillStorage::template Create<L>(std::move(aClosure)));
+        }
+    }
+
+    /**
+     * @brief Creates a callback that owns a closure created by the storage, see CallbackArena.
+     */
+    template<typename Storage, typename L>
+    requires Detail::IsClosure<L, R, Args...>
+    static Callback Adopt(L* aClosure) noexcept
+    {
+        Callback callback;
+        callback.template InitializeSpilled<Detail::SpilledClosureTarget<L, Storage, R, Args...>>(aClosure);
+        return callback;
     }
 
     Callback(const Callback& aOther) noexcept
@@ -166,6 +205,18 @@ private:
         handler->copy(buffer, aSrc);
     }
 
+    template<class TargetType>
+    void InitializeSpilled(decltype(TargetType::closure) aClosure) noexcept
+    {
+        using HandlerImpl = Detail::CallbackHandlerImpl<TargetType>;
+        using HandlerFactory = Detail::CallbackHandlerFactory<HandlerImpl, R, Args...>;
+
+        static_assert(sizeof(TargetType) <= InlineSize);
+
+        handler = HandlerFactory::Get();
+        new (buffer) TargetType{aClosure};
+    }
+
     void CopyHandlerFrom(HandlerPtr aHandler) noexcept
     {
         handler = aHandler;
@@ -187,11 +238,12 @@ private:
         return handler->invoke(buffer, std::forward<Args>(aArgs)...);
     }
 
-    void CopyTargetFrom(void* aTarget)
+    void CopyTargetFrom(const void* aTarget)
     {
         if (handler)
         {
-            handler->copy(buffer, aTarget);
+            // The copy handler takes the source as non-const, it does not modify it.
+            handler->copy(buffer, const_cast<void*>(aTarget));
         }
     }
 
@@ -0,0 +1,79 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/CallbackArena.hpp>
+#endif
+
+RED4EXT_INLINE RED4ext::CallbackArena::CallbackArena(size_t aChunkSize)
+    : m_chunkSize(aChunkSize)
+    , m_current(0)
+    , m_offset(0)
+    , m_createdCount(0)
+    , m_destroyedCount(0)
+{
+}
+
+RED4EXT_INLINE RED4ext::CallbackArena::~CallbackArena()
+{
+    for (auto& chunk : m_chunks)
+    {
+        ::operator delete(chunk.data);
+    }
+}
+
+RED4EXT_INLINE bool RED4ext::CallbackArena::Reset() noexcept
+{
+    if (m_destroyedCount.load(std::memory_order_acquire) != m_createdCount)
+    {
+        return false;
+    }
+
+    m_createdCount = 0;
+    m_destroyedCount.store(0, std::memory_order_relaxed);
+
+    m_current = 0;
+    m_offset = 0;
+    return true;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::CallbackArena::GetLiveCount() const noexcept
+{
+    return m_createdCount - m_destroyedCount.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE size_t RED4ext::CallbackArena::GetCapacity() const noexcept
+{
+    size_t capacity = 0;
+    for (const auto& chunk : m_chunks)
+    {
+        capacity += chunk.size;
+    }
+
+    return capacity;
+}
+
+RED4EXT_INLINE void* RED4ext::CallbackArena::Allocate(size_t aSize, size_t aAlignment)
+{
+    for (; m_current < m_chunks.size(); ++m_current, m_offset = 0)
+    {
+        const auto& chunk = m_chunks[m_current];
+
+        auto begin = reinterpret_cast<uintptr_t>(chunk.data);
+        auto address = (begin + m_offset + aAlignment - 1) & ~static_cast<uintptr_t>(aAlignment - 1);
+
+        if (address + aSize <= begin + chunk.size)
+        {
+            m_offset = address + aSize - begin;
+            return reinterpret_cast<void*>(address);
+        }
+    }
+
+    // A closure larger than a chunk gets a chunk of its own, the space for the alignment is added to it.
+    auto size = (std::max)(m_chunkSize, aSize + aAlignment);
+    m_chunks.push_back({static_cast<uint8_t*>(::operator new(size)), size});
+
+    m_current = m_chunks.size() - 1;
+    m_offset = 0;
+
+    return Allocate(aSize, aAlignment);
+}
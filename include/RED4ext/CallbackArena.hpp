@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <RED4ext/Callback.hpp>
+#include <RED4ext/Common.hpp>
+
+namespace RED4ext
+{
+namespace Detail
+{
+struct CallbackArenaStorage;
+}
+
+/**
+ * @brief Stores the closures of short-lived callbacks, e.g. the ones registered for a single frame, and releases them
+ * all at once.
+ *
+ * Closures that fit into the callback stay inline, larger ones are placed in the arena's chunks by bumping a pointer.
+ * Destroying such a callback runs the closure's destructor but keeps the memory, Reset() makes all of it available
+ * again. Copies of a callback are placed in the same arena.
+ *
+ * Creating and copying callbacks is not thread-safe, destroying them is. The callbacks must not outlive the arena, keep
+ * that in mind when passing them to the game.
+ *
+ * @example
+ *
+ * RED4ext::CallbackArena arena;
+ *
+ * auto callback = arena.Create<RED4ext::DeferredDataBufferGroup::LoadedCallback>([state = std::move(state)]() {});
+ * // ...
+ * if (arena.Reset()) { ... }
+ */
+class CallbackArena
+{
+public:
+    static constexpr size_t DefaultChunkSize = 16 * 1024;
+
+    explicit CallbackArena(size_t aChunkSize = DefaultChunkSize);
+    CallbackArena(const CallbackArena&) = delete;
+    CallbackArena& operator=(const CallbackArena&) = delete;
+
+    /**
+     * @brief Releases the memory. No callback created by the arena may be alive.
+     */
+    ~CallbackArena();
+
+    /**
+     * @brief Creates a callback of the given type, the closure is placed in the arena if it does not fit inline.
+     * @tparam C The callback type, e.g. Callback<void (*)()>.
+     */
+    template<typename C, typename L>
+    requires std::is_class_v<L>
+    C Create(L&& aClosure)
+    {
+        if constexpr (sizeof(L) <= sizeof(C::buffer))
+        {
+            return C(std::forward<L>(aClosure));
+        }
+        else
+        {
+            return C::template Adopt<Detail::CallbackArenaStorage>(New<L>(std::forward<L>(aClosure)));
+        }
+    }
+
+    /**
+     * @brief Makes the whole memory available again, keeping the chunks.
+     * @return false if callbacks created by the arena are still alive, nothing is released then.
+     */
+    bool Reset() noexcept;
+
+    [[nodiscard]] uint32_t GetLiveCount() const noexcept;
+
+    /**
+     * @brief Returns the size of all chunks in bytes.
+     */
+    [[nodiscard]] size_t GetCapacity() const noexcept;
+
+private:
+    friend struct Detail::CallbackArenaStorage;
+
+    struct Chunk
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    // Every closure is preceded by a pointer to its arena.
+    template<typename L>
+    static constexpr size_t ClosureOffset = (sizeof(CallbackArena*) + alignof(L) - 1) / alignof(L) * alignof(L);
+
+    template<typename L, typename T>
+    L* New(T&& aClosure)
+    {
+        constexpr auto alignment = (std::max)(alignof(L), alignof(CallbackArena*));
+
+        auto block = static_cast<uint8_t*>(Allocate(ClosureOffset<L> + sizeof(L), alignment));
+        auto closure = new (block + ClosureOffset<L>) L(std::forward<T>(aClosure));
+
+        *(reinterpret_cast<CallbackArena**>(closure) - 1) = this;
+        ++m_createdCount;
+
+        return closure;
+    }
+
+    static CallbackArena* GetOwner(const void* aClosure) noexcept
+    {
+        return *(reinterpret_cast<CallbackArena* const*>(aClosure) - 1);
+    }
+
+    void* Allocate(size_t aSize, size_t aAlignment);
+
+    size_t m_chunkSize;
+    std::vector<Chunk> m_chunks;
+    size_t m_current; // The chunk that is being filled.
+    size_t m_offset;  // The used bytes of the current chunk.
+    uint32_t m_createdCount;                 // Only changed by the thread that creates the callbacks.
+    std::atomic<uint32_t> m_destroyedCount; // Changed by any thread.
+};
+
+namespace Detail
+{
+struct CallbackArenaStorage
+{
+    template<typename L>
+    static L* Clone(const L* aClosure)
+    {
+        return CallbackArena::GetOwner(aClosure)->template New<L>(*aClosure);
+    }
+
+    template<typename L>
+    static void Destroy(L* aClosure) noexcept
+    {
+        auto arena = CallbackArena::GetOwner(aClosure);
+        aClosure->~L();
+
+        arena->m_destroyedCount.fetch_add(1, std::memory_order_release);
+    }
+};
+} // namespace Detail
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/CallbackArena-inl.hpp>
+#endif
@@ -0,0 +1,236 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/CharConv.hpp>
+#endif
+
+#include <array>
+
+namespace RED4ext::Detail
+{
+inline constexpr auto HexPairs = []()
+{
+    constexpr char digits[] = "0123456789ABCDEF";
+
+    std::array<char, 512> pairs{};
+    for (size_t i = 0; i < 256; ++i)
+    {
+        pairs[i * 2] = digits[i >> 4];
+        pairs[i * 2 + 1] = digits[i & 0xF];
+    }
+
+    return pairs;
+}();
+
+inline constexpr auto HexValues = []()
+{
+    std::array<uint8_t, 256> values{};
+    values.fill(0xFF);
+
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        values['0' + i] = i;
+    }
+
+    for (uint8_t i = 0; i < 6; ++i)
+    {
+        values['A' + i] = 10 + i;
+        values['a' + i] = 10 + i;
+    }
+
+    return values;
+}();
+
+/**
+ * @brief Writes the lowest aDigits hex digits of the value, aDigits must be even.
+ */
+inline char* WriteHex(char* aOut, uint64_t aValue, uint32_t aDigits) noexcept
+{
+    // Two digits per lookup, from the last pair to the first.
+    for (auto i = aDigits; i > 0; i -= 2)
+    {
+        auto pair = &HexPairs[(aValue & 0xFF) * 2];
+        aOut[i - 2] = pair[0];
+        aOut[i - 1] = pair[1];
+        aValue >>= 8;
+    }
+
+    return aOut + aDigits;
+}
+
+/**
+ * @brief Reads exactly aDigits hex digits.
+ * @return False if one of the characters is not a hex digit.
+ */
+inline bool ReadHex(const char* aIn, uint32_t aDigits, uint64_t& aValue) noexcept
+{
+    uint64_t value = 0;
+    uint8_t invalid = 0;
+
+    for (uint32_t i = 0; i < aDigits; ++i)
+    {
+        auto digit = HexValues[static_cast<uint8_t>(aIn[i])];
+        invalid |= digit;
+        value = (value << 4) | (digit & 0xF);
+    }
+
+    // Only the invalid marker has the high bits set.
+    if (invalid & 0xF0)
+    {
+        return false;
+    }
+
+    aValue = value;
+    return true;
+}
+
+inline bool HasRoom(const char* aFirst, const char* aLast, size_t aSize) noexcept
+{
+    return aFirst <= aLast && static_cast<size_t>(aLast - aFirst) >= aSize;
+}
+
+inline char* WriteTweakDBID(char* aOut, TweakDBID aValue) noexcept
+{
+    aOut = WriteHex(aOut, aValue.name.hash, 8);
+    *aOut++ = ':';
+    aOut = WriteHex(aOut, aValue.name.length, 2);
+    *aOut++ = ':';
+
+    uint32_t offset = (aValue.name.tdbOffsetBE[0] << 16) | (aValue.name.tdbOffsetBE[1] << 8) |
+                      aValue.name.tdbOffsetBE[2];
+    return WriteHex(aOut, offset, 6);
+}
+
+inline bool ReadTweakDBID(const char* aIn, TweakDBID& aValue) noexcept
+{
+    uint64_t hash, length, offset;
+    if (!ReadHex(aIn, 8, hash) || aIn[8] != ':' || !ReadHex(aIn + 9, 2, length) || aIn[11] != ':' ||
+        !ReadHex(aIn + 12, 6, offset))
+    {
+        return false;
+    }
+
+    aValue.name.hash = static_cast<uint32_t>(hash);
+    aValue.name.length = static_cast<uint8_t>(length);
+    aValue.name.tdbOffsetBE[0] = static_cast<uint8_t>(offset >> 16);
+    aValue.name.tdbOffsetBE[1] = static_cast<uint8_t>(offset >> 8);
+    aValue.name.tdbOffsetBE[2] = static_cast<uint8_t>(offset);
+
+    return true;
+}
+} // namespace RED4ext::Detail
+
+RED4EXT_INLINE std::to_chars_result RED4ext::ToChars(char* aFirst, char* aLast, CName aValue) noexcept
+{
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<CName>))
+    {
+        return {aLast, std::errc::value_too_large};
+    }
+
+    return {Detail::WriteHex(aFirst, aValue.hash, 16), std::errc{}};
+}
+
+RED4EXT_INLINE std::to_chars_result RED4ext::ToChars(char* aFirst, char* aLast, NodeRef aValue) noexcept
+{
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<NodeRef>))
+    {
+        return {aLast, std::errc::value_too_large};
+    }
+
+    return {Detail::WriteHex(aFirst, aValue.hash, 16), std::errc{}};
+}
+
+RED4EXT_INLINE std::to_chars_result RED4ext::ToChars(char* aFirst, char* aLast, TweakDBID aValue) noexcept
+{
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<TweakDBID>))
+    {
+        return {aLast, std::errc::value_too_large};
+    }
+
+    return {Detail::WriteTweakDBID(aFirst, aValue), std::errc{}};
+}
+
+RED4EXT_INLINE std::to_chars_result RED4ext::ToChars(char* aFirst, char* aLast, const ItemID& aValue) noexcept
+{
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<ItemID>))
+    {
+        return {aLast, std::errc::value_too_large};
+    }
+
+    auto out = Detail::WriteTweakDBID(aFirst, aValue.tdbid);
+    *out++ = ':';
+    out = Detail::WriteHex(out, aValue.rngSeed, 8);
+    *out++ = ':';
+    out = Detail::WriteHex(out, aValue.uniqueCounter, 4);
+    *out++ = ':';
+    out = Detail::WriteHex(out, aValue.structure, 2);
+    *out++ = ':';
+    out = Detail::WriteHex(out, aValue.flags, 2);
+
+    return {out, std::errc{}};
+}
+
+RED4EXT_INLINE std::from_chars_result RED4ext::FromChars(const char* aFirst, const char* aLast, CName& aValue) noexcept
+{
+    uint64_t hash;
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<CName>) || !Detail::ReadHex(aFirst, 16, hash))
+    {
+        return {aFirst, std::errc::invalid_argument};
+    }
+
+    aValue.hash = hash;
+    return {aFirst + CharsSize<CName>, std::errc{}};
+}
+
+RED4EXT_INLINE std::from_chars_result RED4ext::FromChars(const char* aFirst, const char* aLast,
+                                                         NodeRef& aValue) noexcept
+{
+    uint64_t hash;
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<NodeRef>) || !Detail::ReadHex(aFirst, 16, hash))
+    {
+        return {aFirst, std::errc::invalid_argument};
+    }
+
+    aValue.hash = hash;
+    return {aFirst + CharsSize<NodeRef>, std::errc{}};
+}
+
+RED4EXT_INLINE std::from_chars_result RED4ext::FromChars(const char* aFirst, const char* aLast,
+                                                         TweakDBID& aValue) noexcept
+{
+    TweakDBID value;
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<TweakDBID>) || !Detail::ReadTweakDBID(aFirst, value))
+    {
+        return {aFirst, std::errc::invalid_argument};
+    }
+
+    aValue = value;
+    return {aFirst + CharsSize<TweakDBID>, std::errc{}};
+}
+
+RED4EXT_INLINE std::from_chars_result RED4ext::FromChars(const char* aFirst, const char* aLast, ItemID& aValue) noexcept
+{
+    if (!Detail::HasRoom(aFirst, aLast, CharsSize<ItemID>))
+    {
+        return {aFirst, std::errc::invalid_argument};
+    }
+
+    TweakDBID tdbid;
+    uint64_t rngSeed, uniqueCounter, structure, flags;
+
+    auto in = aFirst;
+    if (!Detail::ReadTweakDBID(in, tdbid) || in[18] != ':' || !Detail::ReadHex(in + 19, 8, rngSeed) || in[27] != ':' ||
+        !Detail::ReadHex(in + 28, 4, uniqueCounter) || in[32] != ':' || !Detail::ReadHex(in + 33, 2, structure) ||
+        in[35] != ':' || !Detail::ReadHex(in + 36, 2, flags))
+    {
+        return {aFirst, std::errc::invalid_argument};
+    }
+
+    aValue.tdbid = tdbid;
+    aValue.rngSeed = static_cast<uint32_t>(rngSeed);
+    aValue.uniqueCounter = static_cast<uint16_t>(uniqueCounter);
+    aValue.structure = static_cast<uint8_t>(structure);
+    aValue.flags = static_cast<uint8_t>(flags);
+
+    return {aFirst + CharsSize<ItemID>, std::errc{}};
+}
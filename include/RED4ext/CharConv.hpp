@@ -0,0 +1,111 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include <RED4ext/CName.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/NativeTypes.hpp>
+#include <RED4ext/NodeRef.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+/*
+ * Text conversions in the style of std::to_chars / std::from_chars, they write into the caller's buffer and never
+ * allocate. Every value has a fixed width, upper case hex representation that converts back to the same value:
+ *
+ *  CName     HHHHHHHHHHHHHHHH                        (hash)
+ *  NodeRef   HHHHHHHHHHHHHHHH                        (hash)
+ *  TweakDBID HHHHHHHH:LL:OOOOOO                      (hash, length, TweakDB offset)
+ *  ItemID    HHHHHHHH:LL:OOOOOO:SSSSSSSS:CCCC:TT:FF  (TweakDBID, rng seed, unique counter, structure, flags)
+ *
+ * Parsing accepts upper and lower case digits. A failed conversion returns std::errc::value_too_large (output) or
+ * std::errc::invalid_argument (input) and leaves the value untouched.
+ */
+
+template<typename T>
+inline constexpr size_t CharsSize = 0;
+
+template<>
+inline constexpr size_t CharsSize<CName> = 16;
+
+template<>
+inline constexpr size_t CharsSize<NodeRef> = 16;
+
+template<>
+inline constexpr size_t CharsSize<TweakDBID> = 18;
+
+template<>
+inline constexpr size_t CharsSize<ItemID> = 38;
+
+std::to_chars_result ToChars(char* aFirst, char* aLast, CName aValue) noexcept;
+std::to_chars_result ToChars(char* aFirst, char* aLast, NodeRef aValue) noexcept;
+std::to_chars_result ToChars(char* aFirst, char* aLast, TweakDBID aValue) noexcept;
+std::to_chars_result ToChars(char* aFirst, char* aLast, const ItemID& aValue) noexcept;
+
+std::from_chars_result FromChars(const char* aFirst, const char* aLast, CName& aValue) noexcept;
+std::from_chars_result FromChars(const char* aFirst, const char* aLast, NodeRef& aValue) noexcept;
+std::from_chars_result FromChars(const char* aFirst, const char* aLast, TweakDBID& aValue) noexcept;
+std::from_chars_result FromChars(const char* aFirst, const char* aLast, ItemID& aValue) noexcept;
+
+/**
+ * @brief Converts multiple values, each one is followed by the separator.
+ * @param aFirst The start of the output.
+ * @param aLast The end of the output.
+ * @param aValues The values.
+ * @param aSeparator The separator.
+ * @return The end of the written text, or aLast and std::errc::value_too_large if it does not fit. Check the size
+ *         up front with (CharsSize<T> + 1) * count.
+ */
+template<typename T>
+std::to_chars_result ToChars(char* aFirst, char* aLast, Span<const T> aValues, char aSeparator = '\n') noexcept
+{
+    if (static_cast<size_t>(aLast - aFirst) < (CharsSize<T> + 1) * aValues.GetSize())
+    {
+        return {aLast, std::errc::value_too_large};
+    }
+
+    for (const auto& value : aValues)
+    {
+        // The size was checked for the whole batch, the conversion can not fail.
+        aFirst = ToChars(aFirst, aLast, value).ptr;
+        *aFirst++ = aSeparator;
+    }
+
+    return {aFirst, std::errc{}};
+}
+
+/**
+ * @brief Parses multiple values, each one must be followed by the separator.
+ * @param aFirst The start of the input.
+ * @param aLast The end of the input.
+ * @param aValues Receives the values, one per element.
+ * @param aSeparator The separator.
+ * @return The end of the parsed text, or the position of the first value that could not be parsed. The values in
+ *         front of it are set.
+ */
+template<typename T>
+std::from_chars_result FromChars(const char* aFirst, const char* aLast, Span<T> aValues,
+                                 char aSeparator = '\n') noexcept
+{
+    for (auto& value : aValues)
+    {
+        auto result = FromChars(aFirst, aLast, value);
+        if (result.ec != std::errc{} || result.ptr == aLast || *result.ptr != aSeparator)
+        {
+            return {aFirst, std::errc::invalid_argument};
+        }
+
+        aFirst = result.ptr + 1;
+    }
+
+    return {aFirst, std::errc{}};
+}
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/CharConv-inl.hpp>
+#endif
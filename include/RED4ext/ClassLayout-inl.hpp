@@ -0,0 +1,444 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/ClassLayout.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+
+#include <RED4ext/Hashing/FNV1a.hpp>
+#include <RED4ext/RTTITypes.hpp>
+#include <RED4ext/Scripting/CProperty.hpp>
+#include <RED4ext/Scripting/IScriptable.hpp>
+
+RED4EXT_INLINE const RED4ext::ClassLayout* RED4ext::ClassLayout::Get(const CClass* aClass)
+{
+    if (!aClass)
+    {
+        return nullptr;
+    }
+
+    auto& storage = GetStorage();
+
+    {
+        std::shared_lock<SharedSpinLock> _(storage.lock);
+
+        auto it = storage.layouts.find(aClass);
+        if (it != storage.layouts.end())
+        {
+            return it->second.get();
+        }
+    }
+
+    // Build outside of the lock, walking the properties calls into RTTI.
+    std::unique_ptr<ClassLayout> layout(new ClassLayout(aClass));
+
+    std::lock_guard<SharedSpinLock> _(storage.lock);
+    return storage.layouts.try_emplace(aClass, std::move(layout)).first->second.get();
+}
+
+RED4EXT_INLINE void RED4ext::ClassLayout::Invalidate(const CClass* aClass)
+{
+    auto& storage = GetStorage();
+
+    // Layouts are handed out as raw pointers, keep them alive until Clear(). Invalidation is rare, retiring is cheaper
+    // than reference counting every lookup.
+    std::lock_guard<SharedSpinLock> _(storage.lock);
+
+    auto it = storage.layouts.find(aClass);
+    if (it != storage.layouts.end())
+    {
+        storage.retired.push_back(std::move(it->second));
+        storage.layouts.erase(it);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::ClassLayout::Clear()
+{
+    auto& storage = GetStorage();
+
+    std::lock_guard<SharedSpinLock> _(storage.lock);
+    storage.layouts.clear();
+    storage.retired.clear();
+}
+
+RED4EXT_INLINE bool RED4ext::ClassLayout::Equal(ScriptInstance aLhs, ScriptInstance aRhs) const
+{
+    if (aLhs == aRhs)
+    {
+        return true;
+    }
+
+    uint8_t* lhsBases[] = {GetBase(aLhs, Region::Instance), nullptr};
+    uint8_t* rhsBases[] = {GetBase(aRhs, Region::Instance), nullptr};
+
+    auto getBases = [&](Region aRegion)
+    {
+        auto index = static_cast<uint8_t>(aRegion);
+        if (!lhsBases[index])
+        {
+            lhsBases[index] = GetBase(aLhs, aRegion);
+            rhsBases[index] = GetBase(aRhs, aRegion);
+        }
+
+        return index;
+    };
+
+    for (const auto& span : m_spans)
+    {
+        auto index = getBases(span.region);
+        if (std::memcmp(lhsBases[index] + span.offset, rhsBases[index] + span.offset, span.size) != 0)
+        {
+            return false;
+        }
+    }
+
+    for (auto fieldIndex : m_slowFields)
+    {
+        const auto& field = m_fields[fieldIndex];
+
+        auto index = getBases(field.region);
+        if (!IsFieldEqual(field, lhsBases[index], rhsBases[index]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::ClassLayout::CopyPod(ScriptInstance aDst, ScriptInstance aSrc) const
+{
+    if (aDst == aSrc)
+    {
+        return;
+    }
+
+    uint8_t* dstBases[] = {GetBase(aDst, Region::Instance), nullptr};
+    uint8_t* srcBases[] = {GetBase(aSrc, Region::Instance), nullptr};
+
+    for (const auto& span : m_spans)
+    {
+        auto index = static_cast<uint8_t>(span.region);
+        if (!dstBases[index])
+        {
+            dstBases[index] = GetBase(aDst, span.region);
+            srcBases[index] = GetBase(aSrc, span.region);
+        }
+
+        std::memcpy(dstBases[index] + span.offset, srcBases[index] + span.offset, span.size);
+    }
+}
+
+RED4EXT_INLINE uint64_t RED4ext::ClassLayout::Hash(ScriptInstance aInstance, uint64_t aSeed) const
+{
+    uint8_t* bases[] = {GetBase(aInstance, Region::Instance), nullptr};
+
+    auto getBase = [&](Region aRegion)
+    {
+        auto index = static_cast<uint8_t>(aRegion);
+        if (!bases[index])
+        {
+            bases[index] = GetBase(aInstance, aRegion);
+        }
+
+        return bases[index];
+    };
+
+    auto hash = aSeed;
+    for (const auto& span : m_spans)
+    {
+        hash = FNV1a64(getBase(span.region) + span.offset, span.size, hash);
+    }
+
+    for (auto fieldIndex : m_slowFields)
+    {
+        const auto& field = m_fields[fieldIndex];
+        if (field.kind == FieldKind::Handle)
+        {
+            // Handles compare by instance, which is the first member.
+            hash = FNV1a64(getBase(field.region) + field.offset, sizeof(void*), hash);
+        }
+    }
+
+    return hash;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::ClassLayout::Diff(ScriptInstance aLhs, ScriptInstance aRhs,
+                                                   std::vector<uint32_t>& aFields) const
+{
+    uint32_t count = 0;
+    if (aLhs == aRhs)
+    {
+        return count;
+    }
+
+    uint8_t* lhsBases[] = {GetBase(aLhs, Region::Instance), nullptr};
+    uint8_t* rhsBases[] = {GetBase(aRhs, Region::Instance), nullptr};
+
+    auto getBases = [&](Region aRegion)
+    {
+        auto index = static_cast<uint8_t>(aRegion);
+        if (!lhsBases[index])
+        {
+            lhsBases[index] = GetBase(aLhs, aRegion);
+            rhsBases[index] = GetBase(aRhs, aRegion);
+        }
+
+        return index;
+    };
+
+    auto first = aFields.size();
+
+    // Equal spans are skipped with one memcmp, the fields are only compared one by one inside the differing spans.
+    for (const auto& span : m_spans)
+    {
+        auto index = getBases(span.region);
+        if (std::memcmp(lhsBases[index] + span.offset, rhsBases[index] + span.offset, span.size) == 0)
+        {
+            continue;
+        }
+
+        for (auto i = span.firstField; i <= span.lastField; i++)
+        {
+            const auto& field = m_fields[i];
+            if (field.kind != FieldKind::Pod && field.kind != FieldKind::Name)
+            {
+                continue;
+            }
+
+            if (!IsFieldEqual(field, lhsBases[index], rhsBases[index]))
+            {
+                aFields.push_back(i);
+                count++;
+            }
+        }
+    }
+
+    for (auto fieldIndex : m_slowFields)
+    {
+        const auto& field = m_fields[fieldIndex];
+
+        auto index = getBases(field.region);
+        if (!IsFieldEqual(field, lhsBases[index], rhsBases[index]))
+        {
+            aFields.push_back(fieldIndex);
+            count++;
+        }
+    }
+
+    // The slow fields are interleaved with the spans, keep the indexes in field order.
+    std::sort(aFields.begin() + static_cast<std::ptrdiff_t>(first), aFields.end());
+    return count;
+}
+
+RED4EXT_INLINE const RED4ext::CClass* RED4ext::ClassLayout::GetClass() const
+{
+    return m_class;
+}
+
+RED4EXT_INLINE const std::vector<RED4ext::ClassLayout::Field>& RED4ext::ClassLayout::GetFields() const
+{
+    return m_fields;
+}
+
+RED4EXT_INLINE const std::vector<RED4ext::ClassLayout::MemcmpSpan>& RED4ext::ClassLayout::GetSpans() const
+{
+    return m_spans;
+}
+
+RED4EXT_INLINE bool RED4ext::ClassLayout::IsPod() const
+{
+    return m_slowFields.empty();
+}
+
+RED4EXT_INLINE RED4ext::ClassLayout::Storage& RED4ext::ClassLayout::GetStorage()
+{
+    static Storage storage;
+    return storage;
+}
+
+RED4EXT_INLINE RED4ext::ClassLayout::ClassLayout(const CClass* aClass)
+    : m_class(aClass)
+{
+    AddFields(aClass, nullptr, 0, Region::Instance);
+    Build();
+}
+
+RED4EXT_INLINE void RED4ext::ClassLayout::AddFields(const CClass* aClass, const CProperty* aOwner,
+                                                    uint32_t aBaseOffset, Region aRegion)
+{
+    for (auto cls = aClass; cls; cls = cls->parent)
+    {
+        for (auto prop : cls->props)
+        {
+            if (!prop || !prop->type)
+            {
+                continue;
+            }
+
+            auto region = aRegion;
+            if (!aOwner && prop->flags.inValueHolder)
+            {
+                region = Region::ValueHolder;
+            }
+
+            AddField(aOwner ? aOwner : prop, prop->type, aBaseOffset + prop->valueOffset, region);
+        }
+    }
+}
+
+RED4EXT_INLINE void RED4ext::ClassLayout::AddField(const CProperty* aOwner, CBaseRTTIType* aType, uint32_t aOffset,
+                                                   Region aRegion)
+{
+    if (aType->GetType() == ERTTIType::Class)
+    {
+        // Embedded structs are flattened, their fields are stored inline.
+        auto cls = static_cast<const CClass*>(aType);
+        if (cls->props.size != 0 || cls->parent)
+        {
+            AddFields(cls, aOwner, aOffset, aRegion);
+            return;
+        }
+    }
+
+    Field field{};
+    field.property = aOwner;
+    field.type = aType;
+    field.offset = aOffset;
+    field.size = aType->GetSize();
+    field.kind = Classify(aType);
+    field.region = aRegion;
+
+    m_fields.push_back(field);
+}
+
+RED4EXT_INLINE void RED4ext::ClassLayout::Build()
+{
+    std::stable_sort(m_fields.begin(), m_fields.end(),
+                     [](const Field& aLhs, const Field& aRhs)
+                     {
+                         if (aLhs.region != aRhs.region)
+                         {
+                             return aLhs.region < aRhs.region;
+                         }
+
+                         return aLhs.offset < aRhs.offset;
+                     });
+
+    for (uint32_t i = 0; i < m_fields.size(); i++)
+    {
+        const auto& field = m_fields[i];
+        if (field.kind != FieldKind::Pod && field.kind != FieldKind::Name)
+        {
+            m_slowFields.push_back(i);
+            continue;
+        }
+
+        if (field.size == 0)
+        {
+            continue;
+        }
+
+        if (!m_spans.empty())
+        {
+            auto& last = m_spans.back();
+            if (last.region == field.region && last.offset + last.size == field.offset)
+            {
+                last.size += field.size;
+                last.lastField = i;
+                continue;
+            }
+        }
+
+        m_spans.push_back({field.offset, field.size, field.region, i, i});
+    }
+}
+
+RED4EXT_INLINE RED4ext::ClassLayout::FieldKind RED4ext::ClassLayout::Classify(const CBaseRTTIType* aType)
+{
+    switch (aType->GetType())
+    {
+    case ERTTIType::Fundamental:
+    case ERTTIType::Enum:
+    case ERTTIType::BitField:
+    case ERTTIType::ResourceAsyncReference:
+    {
+        return FieldKind::Pod;
+    }
+    case ERTTIType::Name:
+    {
+        return FieldKind::Name;
+    }
+    case ERTTIType::Handle:
+    case ERTTIType::WeakHandle:
+    {
+        return FieldKind::Handle;
+    }
+    case ERTTIType::Array:
+    case ERTTIType::StaticArray:
+    case ERTTIType::NativeArray:
+    case ERTTIType::FixedArray:
+    {
+        return FieldKind::Array;
+    }
+    case ERTTIType::Simple:
+    {
+        // Most simple types own memory (strings, variants, ...), only the plain value types are safe to memcmp.
+        constexpr CName podSimpleTypes[] = {"TweakDBID", "CRUID",      "CGUID",
+                                            "NodeRef",   "CDateTime",  "EngineTime",
+                                            "gamedataLocKeyWrapper"};
+
+        auto name = aType->GetName();
+        for (const auto& podName : podSimpleTypes)
+        {
+            if (name == podName)
+            {
+                return FieldKind::Pod;
+            }
+        }
+
+        return FieldKind::Complex;
+    }
+    default:
+    {
+        return FieldKind::Complex;
+    }
+    }
+}
+
+RED4EXT_INLINE uint8_t* RED4ext::ClassLayout::GetBase(ScriptInstance aInstance, Region aRegion)
+{
+    if (aRegion == Region::ValueHolder)
+    {
+        return static_cast<uint8_t*>(static_cast<IScriptable*>(aInstance)->GetValueHolder());
+    }
+
+    return static_cast<uint8_t*>(aInstance);
+}
+
+RED4EXT_INLINE bool RED4ext::ClassLayout::IsFieldEqual(const Field& aField, uint8_t* aLhs, uint8_t* aRhs)
+{
+    auto lhs = aLhs + aField.offset;
+    auto rhs = aRhs + aField.offset;
+
+    switch (aField.kind)
+    {
+    case FieldKind::Pod:
+    case FieldKind::Name:
+    {
+        return std::memcmp(lhs, rhs, aField.size) == 0;
+    }
+    case FieldKind::Handle:
+    {
+        return *reinterpret_cast<void**>(lhs) == *reinterpret_cast<void**>(rhs);
+    }
+    default:
+    {
+        return aField.type->IsEqual(lhs, rhs);
+    }
+    }
+}
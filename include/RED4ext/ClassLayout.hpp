@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/InstanceType.hpp>
+#include <RED4ext/SharedSpinLock.hpp>
+
+namespace RED4ext
+{
+struct CBaseRTTIType;
+struct CClass;
+struct CProperty;
+
+/**
+ * @brief Precomputed field layout of a class.
+ *
+ * The layout contains every property of the class, including the inherited ones and the fields of embedded structs,
+ * sorted by offset. Fields that can be compared and copied bytewise are coalesced into memcmp spans, so instances can
+ * be compared, copied and hashed with a few memcmp/memcpy runs instead of one virtual call per property.
+ *
+ * The layout is built from the properties registered at the time of the first request. Call Invalidate() after the
+ * class' properties change (e.g. after scripts are reloaded).
+ */
+class ClassLayout
+{
+public:
+    enum class FieldKind : uint8_t
+    {
+        Pod,     // Trivially copyable, compared bytewise.
+        Name,    // CName, compared bytewise.
+        Handle,  // Handle or WeakHandle, compared by instance.
+        Array,   // Any kind of array, compared through RTTI.
+        Complex, // Everything else, compared through RTTI.
+    };
+
+    enum class Region : uint8_t
+    {
+        Instance,   // The field is stored in the instance itself.
+        ValueHolder // The field is stored in the value holder of a scripted object.
+    };
+
+    struct Field
+    {
+        const CProperty* property; // The top-level property this field belongs to.
+        CBaseRTTIType* type;
+        uint32_t offset;
+        uint32_t size;
+        FieldKind kind;
+        Region region;
+    };
+
+    struct MemcmpSpan
+    {
+        uint32_t offset;
+        uint32_t size;
+        Region region;
+        uint32_t firstField; // Index (into GetFields()) of the first field covered by the span.
+        uint32_t lastField;  // Index (into GetFields()) of the last field covered by the span.
+    };
+
+    /**
+     * @brief Returns the layout of the class, building it on the first call.
+     * @param aClass The class.
+     * @return The layout, or nullptr if the class is null.
+     */
+    static const ClassLayout* Get(const CClass* aClass);
+
+    /**
+     * @brief Drops the cached layout of the class, the next Get() builds a new one.
+     * @note The old layout stays valid for callers that still hold it, it is freed by Clear() or at shutdown.
+     */
+    static void Invalidate(const CClass* aClass);
+
+    /**
+     * @brief Frees every cached and invalidated layout.
+     * @warning All pointers returned by Get() become dangling, only call this when no layout is in use (e.g. when the
+     * plugin is unloaded).
+     */
+    static void Clear();
+
+    /**
+     * @brief Checks if all fields of the two instances are equal.
+     * @param aLhs The first instance.
+     * @param aRhs The second instance.
+     * @return True if every field is equal.
+     */
+    bool Equal(ScriptInstance aLhs, ScriptInstance aRhs) const;
+
+    /**
+     * @brief Copies all POD and name fields from one instance to another. Other fields are left untouched.
+     * @param aDst The destination instance.
+     * @param aSrc The source instance.
+     */
+    void CopyPod(ScriptInstance aDst, ScriptInstance aSrc) const;
+
+    /**
+     * @brief Hashes the POD, name and handle fields of the instance. Arrays and complex fields are not included, so
+     * equal instances always produce the same hash.
+     * @param aInstance The instance.
+     * @param aSeed The seed.
+     * @return The hash.
+     */
+    uint64_t Hash(ScriptInstance aInstance, uint64_t aSeed = 0xCBF29CE484222325) const;
+
+    /**
+     * @brief Collects the fields that differ between two instances.
+     * @param aLhs The first instance.
+     * @param aRhs The second instance.
+     * @param aFields Receives the indexes (into GetFields()) of the differing fields.
+     * @return The number of differing fields.
+     */
+    uint32_t Diff(ScriptInstance aLhs, ScriptInstance aRhs, std::vector<uint32_t>& aFields) const;
+
+    const CClass* GetClass() const;
+    const std::vector<Field>& GetFields() const;
+    const std::vector<MemcmpSpan>& GetSpans() const;
+
+    /**
+     * @brief Checks if the class only contains POD and name fields.
+     */
+    bool IsPod() const;
+
+private:
+    struct Storage
+    {
+        SharedSpinLock lock;
+        std::unordered_map<const CClass*, std::unique_ptr<ClassLayout>> layouts;
+        std::vector<std::unique_ptr<ClassLayout>> retired; // Invalidated layouts, kept alive until Clear().
+    };
+
+    static Storage& GetStorage();
+
+    explicit ClassLayout(const CClass* aClass);
+
+    void AddFields(const CClass* aClass, const CProperty* aOwner, uint32_t aBaseOffset, Region aRegion);
+    void AddField(const CProperty* aOwner, CBaseRTTIType* aType, uint32_t aOffset, Region aRegion);
+    void Build();
+
+    static FieldKind Classify(const CBaseRTTIType* aType);
+    static uint8_t* GetBase(ScriptInstance aInstance, Region aRegion);
+    static bool IsFieldEqual(const Field& aField, uint8_t* aLhs, uint8_t* aRhs);
+
+    const CClass* m_class;
+    std::vector<Field> m_fields;
+    std::vector<MemcmpSpan> m_spans;
+    std::vector<uint32_t> m_slowFields; // Indexes of the fields not covered by the spans.
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/ClassLayout-inl.hpp>
+#endif
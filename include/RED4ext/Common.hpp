@@ -67,3 +67,15 @@
 #define RED4EXT_CALL
 #endif
 #endif
+
+/**
+ * @brief Returns the address the current function returns to, i.e. its call site.
+ */
+#ifndef RED4EXT_RETURN_ADDRESS
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RED4EXT_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define RED4EXT_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+#endif
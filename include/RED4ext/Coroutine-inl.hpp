@@ -0,0 +1,19 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/Coroutine.hpp>
+#endif
+
+RED4EXT_INLINE void RED4ext::Detail::ScheduleResume(std::coroutine_handle<> aHandle)
+{
+    JobQueue queue;
+    queue.Dispatch(ResumeJob{aHandle});
+}
+
+RED4EXT_INLINE void RED4ext::Detail::ScheduleResume(std::coroutine_handle<> aHandle, const JobHandle& aJob)
+{
+    // The queue holds the job back until the handle completes, no thread is blocked in the meantime.
+    JobQueue queue;
+    queue.Wait(aJob);
+    queue.Dispatch(ResumeJob{aHandle});
+}
@@ -0,0 +1,665 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/DeferredDataBufferGroup.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+#include <RED4ext/Memory/SharedPtr.hpp>
+#include <RED4ext/ResourceLoader.hpp>
+
+namespace RED4ext
+{
+template<typename T = void>
+class Task;
+
+namespace Detail
+{
+/**
+ * @brief Resumes the coroutine from a job thread.
+ * @param aHandle The coroutine.
+ */
+void ScheduleResume(std::coroutine_handle<> aHandle);
+
+/**
+ * @brief Resumes the coroutine from a job thread once the job has completed.
+ * @param aHandle The coroutine.
+ * @param aJob The job to wait for.
+ */
+void ScheduleResume(std::coroutine_handle<> aHandle, const JobHandle& aJob);
+
+/**
+ * @brief The job that resumes a coroutine, every resumption is dispatched as this job.
+ */
+struct ResumeJob
+{
+    void operator()() const
+    {
+        handle.resume();
+    }
+
+    std::coroutine_handle<> handle;
+};
+
+struct ScheduleAwaiter
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> aHandle) const
+    {
+        ScheduleResume(aHandle);
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+struct TaskPromiseBase
+{
+    using AllocatorType = Memory::Jobs2DataAllocator;
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> aHandle) const noexcept
+        {
+            // Continue the awaiting coroutine on this thread without growing the stack.
+            auto continuation = aHandle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    // The frames are short lived and have the same lifetime pattern as job closures, allocate them from the same pool.
+    static void* operator new(size_t aSize)
+    {
+        return AllocatorType::Get()->Alloc(aSize).memory;
+    }
+
+    static void operator delete(void* aMemory)
+    {
+        AllocatorType::Get()->Free(aMemory);
+    }
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        exception = std::current_exception();
+    }
+
+    void RethrowIfFailed()
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    requires std::is_convertible_v<U&&, T>
+    void return_value(U&& aValue)
+    {
+        value.emplace(std::forward<U>(aValue));
+    }
+
+    T TakeResult()
+    {
+        RethrowIfFailed();
+        return std::move(*value);
+    }
+
+    std::optional<T> value;
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept
+    {
+    }
+
+    void TakeResult()
+    {
+        RethrowIfFailed();
+    }
+};
+
+/**
+ * @brief A coroutine that starts right away and destroys itself when it finishes, used to run tasks nobody awaits.
+ */
+struct DetachedTask
+{
+    struct promise_type : TaskPromiseBase
+    {
+        DetachedTask get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            // Nobody is left to observe it.
+            std::terminate();
+        }
+    };
+};
+
+/**
+ * @brief Suspends a coroutine until a number of tasks have signaled it.
+ *
+ * The count includes the awaiting coroutine, so whichever of the tasks and the awaiter arrives last continues, the
+ * awaiter never has to be resumed before it is suspended.
+ */
+class TaskLatch
+{
+public:
+    explicit TaskLatch(size_t aCount) noexcept
+        : m_count(aCount + 1)
+    {
+    }
+
+    void CountDown() noexcept
+    {
+        if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_awaiter.resume();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return m_count.load(std::memory_order_acquire) == 1;
+    }
+
+    bool await_suspend(std::coroutine_handle<> aHandle) noexcept
+    {
+        m_awaiter = aHandle;
+        return m_count.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    std::atomic<size_t> m_count;
+    std::coroutine_handle<> m_awaiter;
+};
+
+template<typename T, typename F>
+DetachedTask RunTask(Task<T> aTask, F aOnFinished)
+{
+    co_await ScheduleAwaiter{};
+
+    if constexpr (std::is_void_v<T>)
+    {
+        co_await std::move(aTask);
+        aOnFinished();
+    }
+    else
+    {
+        aOnFinished(co_await std::move(aTask));
+    }
+}
+} // namespace Detail
+
+/**
+ * @brief A lazily started coroutine that produces a value.
+ *
+ * The body runs when the task is awaited, the awaiting coroutine is continued directly when the task finishes. The
+ * frame is allocated from the job pool. Use Spawn() to start a task from code that is not a coroutine.
+ *
+ * An empty task, default constructed or moved from, is finished. Awaiting it continues right away, unless it should
+ * produce a value, then std::logic_error is thrown into the awaiting coroutine.
+ *
+ * @tparam T The type of the value, can be void.
+ */
+template<typename T>
+class Task
+{
+public:
+    using promise_type = Detail::TaskPromise<T>;
+    using HandleType = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+
+    explicit Task(HandleType aHandle) noexcept
+        : m_handle(aHandle)
+    {
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& aOther) noexcept
+        : m_handle(std::exchange(aOther.m_handle, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& aOther) noexcept
+    {
+        if (this != &aOther)
+        {
+            Destroy();
+            m_handle = std::exchange(aOther.m_handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~Task()
+    {
+        Destroy();
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept
+    {
+        return m_handle != nullptr;
+    }
+
+    [[nodiscard]] bool IsFinished() const noexcept
+    {
+        return !m_handle || m_handle.done();
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return !handle || handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> aHandle) const noexcept
+            {
+                // Start the task on this thread, it continues the awaiter when it finishes.
+                handle.promise().continuation = aHandle;
+                return handle;
+            }
+
+            T await_resume() const
+            {
+                if (!handle)
+                {
+                    // An empty task has nothing to run, but it has no value to return either.
+                    if constexpr (std::is_void_v<T>)
+                    {
+                        return;
+                    }
+                    else
+                    {
+                        throw std::logic_error("An empty RED4ext::Task<T> was awaited");
+                    }
+                }
+
+                return handle.promise().TakeResult();
+            }
+
+            HandleType handle;
+        };
+
+        return Awaiter{m_handle};
+    }
+
+private:
+    void Destroy() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    HandleType m_handle;
+};
+
+template<typename T>
+Task<T> Detail::TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(Task<T>::HandleType::from_promise(*this));
+}
+
+inline Task<void> Detail::TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(Task<void>::HandleType::from_promise(*this));
+}
+
+/**
+ * @brief Returns an awaitable that continues the coroutine from a job thread.
+ */
+inline Detail::ScheduleAwaiter Schedule() noexcept
+{
+    return {};
+}
+
+/**
+ * @brief Runs the task from a job thread, its result is discarded. The task must not throw.
+ * @param aTask The task.
+ */
+template<typename T>
+void Spawn(Task<T>&& aTask)
+{
+    if (aTask.IsValid())
+    {
+        Detail::RunTask(std::move(aTask), [](auto&&...) {});
+    }
+}
+
+/**
+ * @brief Suspends the coroutine until the job has completed, it is continued from a job thread.
+ */
+inline auto operator co_await(const JobHandle& aJob)
+{
+    struct Awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> aHandle) const
+        {
+            Detail::ScheduleResume(aHandle, job);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+        JobHandle job;
+    };
+
+    return Awaiter{aJob};
+}
+
+/**
+ * @brief Suspends the coroutine until the resource has finished loading, it is continued from a job thread.
+ *
+ * The result is the token, check IsLoaded() or IsFailed() before using the resource.
+ */
+template<typename T>
+auto operator co_await(const SharedPtr<ResourceToken<T>>& aToken)
+{
+    struct Awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return !token || token->IsFinished();
+        }
+
+        void await_suspend(std::coroutine_handle<> aHandle) const
+        {
+            Detail::ScheduleResume(aHandle, token->job);
+        }
+
+        SharedPtr<ResourceToken<T>> await_resume() noexcept
+        {
+            return std::move(token);
+        }
+
+        SharedPtr<ResourceToken<T>> token;
+    };
+
+    return Awaiter{aToken};
+}
+
+/**
+ * @brief Suspends the coroutine until the buffer has finished loading, it is continued from a job thread.
+ */
+inline auto operator co_await(const SharedPtr<DeferredDataBufferToken>& aToken)
+{
+    struct Awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return !token;
+        }
+
+        void await_suspend(std::coroutine_handle<> aHandle) const
+        {
+            Detail::ScheduleResume(aHandle, token->job);
+        }
+
+        SharedPtr<DeferredDataBufferToken> await_resume() noexcept
+        {
+            return std::move(token);
+        }
+
+        SharedPtr<DeferredDataBufferToken> token;
+    };
+
+    return Awaiter{aToken};
+}
+
+/**
+ * @brief Suspends the coroutine until every buffer of the group has finished loading.
+ */
+inline auto operator co_await(const DeferredDataBufferGroup& aGroup)
+{
+    struct Awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return group.IsReady();
+        }
+
+        void await_suspend(std::coroutine_handle<> aHandle) const
+        {
+            Detail::ScheduleResume(aHandle, group.GetJob());
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+        const DeferredDataBufferGroup& group;
+    };
+
+    return Awaiter{aGroup};
+}
+
+/**
+ * @brief Runs the tasks concurrently on job threads and finishes when all of them have finished.
+ *
+ * The tasks must not throw.
+ */
+inline Task<void> WhenAll(std::vector<Task<void>> aTasks)
+{
+    Detail::TaskLatch latch(aTasks.size());
+
+    for (auto& task : aTasks)
+    {
+        Detail::RunTask(std::move(task), [&latch]() { latch.CountDown(); });
+    }
+
+    co_await latch;
+}
+
+/**
+ * @brief Runs the tasks concurrently on job threads and finishes when all of them have finished.
+ *
+ * The tasks must not throw.
+ *
+ * @return The values, in the order of the tasks.
+ */
+template<typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> aTasks)
+{
+    std::vector<std::optional<T>> values(aTasks.size());
+    Detail::TaskLatch latch(aTasks.size());
+
+    for (size_t i = 0; i < aTasks.size(); ++i)
+    {
+        Detail::RunTask(std::move(aTasks[i]),
+                        [&latch, value = &values[i]](T&& aValue)
+                        {
+                            value->emplace(std::move(aValue));
+                            latch.CountDown();
+                        });
+    }
+
+    co_await latch;
+
+    std::vector<T> result;
+    result.reserve(values.size());
+
+    for (auto& value : values)
+    {
+        result.push_back(std::move(*value));
+    }
+
+    co_return result;
+}
+
+/**
+ * @brief Runs the tasks concurrently on job threads and finishes when the first of them has finished.
+ *
+ * The other tasks cannot be cancelled, they keep running until they finish on their own. The tasks must not throw.
+ *
+ * @return The index of the first task that finished, or -1 if there are no tasks.
+ */
+inline Task<size_t> WhenAny(std::vector<Task<void>> aTasks)
+{
+    if (aTasks.empty())
+    {
+        co_return static_cast<size_t>(-1);
+    }
+
+    struct State
+    {
+        State()
+            : latch(1)
+            , index(-1)
+        {
+        }
+
+        Detail::TaskLatch latch;
+        std::atomic<size_t> index;
+    };
+
+    // The tasks that lose outlive this frame, they share the state with it.
+    auto state = std::make_shared<State>();
+
+    for (size_t i = 0; i < aTasks.size(); ++i)
+    {
+        Detail::RunTask(std::move(aTasks[i]),
+                        [state, i]()
+                        {
+                            size_t expected = -1;
+                            if (state->index.compare_exchange_strong(expected, i, std::memory_order_acq_rel))
+                            {
+                                state->latch.CountDown();
+                            }
+                        });
+    }
+
+    co_await state->latch;
+    co_return state->index.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Runs the tasks concurrently on job threads and finishes when the first of them has finished.
+ *
+ * The other tasks cannot be cancelled, they keep running until they finish on their own. The tasks must not throw.
+ *
+ * @return The index and the value of the first task that finished. The task list must not be empty.
+ */
+template<typename T>
+Task<std::pair<size_t, T>> WhenAny(std::vector<Task<T>> aTasks)
+{
+    struct State
+    {
+        State()
+            : latch(1)
+            , index(-1)
+        {
+        }
+
+        Detail::TaskLatch latch;
+        std::atomic<size_t> index;
+        std::optional<T> value;
+    };
+
+    auto state = std::make_shared<State>();
+
+    for (size_t i = 0; i < aTasks.size(); ++i)
+    {
+        Detail::RunTask(std::move(aTasks[i]),
+                        [state, i](T&& aValue)
+                        {
+                            size_t expected = -1;
+                            if (state->index.compare_exchange_strong(expected, i, std::memory_order_acq_rel))
+                            {
+                                state->value.emplace(std::move(aValue));
+                                state->latch.CountDown();
+                            }
+                        });
+    }
+
+    co_await state->latch;
+    co_return std::pair<size_t, T>(state->index.load(std::memory_order_acquire), std::move(*state->value));
+}
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/Coroutine-inl.hpp>
+#endif
@@ -0,0 +1,146 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/DeferredDataBufferGroup.hpp>
+#endif
+
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include <atomic>
+
+namespace RED4ext::Detail
+{
+inline DeferredDataBufferState LoadBufferState(DeferredDataBuffer& aBuffer)
+{
+    // The state is a single byte written by the loader, it can be read atomically without taking the buffer's lock.
+    return std::atomic_ref<DeferredDataBufferState>(aBuffer.state).load(std::memory_order_acquire);
+}
+} // namespace RED4ext::Detail
+
+RED4EXT_INLINE void RED4ext::Detail::DeferredDataBufferCountDown::operator()() const
+{
+    pending->fetch_sub(count, std::memory_order_release);
+}
+
+RED4EXT_INLINE RED4ext::DeferredDataBufferGroup::DeferredDataBufferGroup()
+    : m_pending(std::make_shared<std::atomic<uint32_t>>(0u))
+    , m_loadCount(0)
+{
+}
+
+RED4EXT_INLINE bool RED4ext::DeferredDataBufferGroup::Load(Span<DeferredDataBuffer> aBuffers,
+                                                           LoadedCallback&& aCallback)
+{
+    if (!Begin())
+    {
+        return false;
+    }
+
+    JobQueue queue;
+    for (auto& buffer : aBuffers)
+    {
+        Add(buffer, queue);
+    }
+
+    Finish(queue, std::move(aCallback));
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::DeferredDataBufferGroup::Load(Span<DeferredDataBuffer*> aBuffers,
+                                                           LoadedCallback&& aCallback)
+{
+    if (!Begin())
+    {
+        return false;
+    }
+
+    JobQueue queue;
+    for (auto buffer : aBuffers)
+    {
+        if (buffer)
+        {
+            Add(*buffer, queue);
+        }
+    }
+
+    Finish(queue, std::move(aCallback));
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::DeferredDataBufferGroup::IsReady() const noexcept
+{
+    return m_pending->load(std::memory_order_acquire) == 0;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::DeferredDataBufferGroup::GetPendingCount() const noexcept
+{
+    return m_pending->load(std::memory_order_acquire);
+}
+
+RED4EXT_INLINE const RED4ext::JobHandle& RED4ext::DeferredDataBufferGroup::GetJob() const noexcept
+{
+    return m_job;
+}
+
+RED4EXT_INLINE bool RED4ext::DeferredDataBufferGroup::Begin()
+{
+    if (!IsReady())
+    {
+        return false;
+    }
+
+    // Hold the counter above zero while the loads are started, the group must not look ready before the last one was
+    // added.
+    m_pending->store(1, std::memory_order_relaxed);
+    m_loadCount = 0;
+    m_job = {};
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::DeferredDataBufferGroup::Add(DeferredDataBuffer& aBuffer, JobQueue& aQueue)
+{
+    if (Detail::LoadBufferState(aBuffer) == DeferredDataBufferState::Loaded)
+    {
+        return;
+    }
+
+    // Same as DeferredDataBuffer::LoadAsync() without the token, only the job is needed.
+    using LoadBufferAsync_t = JobHandle* (*)(DeferredDataBuffer*, JobHandle*, int64_t);
+    static UniversalRelocFunc<LoadBufferAsync_t> loadAsync(Detail::AddressHashes::DeferredDataBuffer_LoadAsync);
+
+    JobHandle loadingJob;
+    loadAsync(&aBuffer, &loadingJob, 0);
+
+    m_pending->fetch_add(1, std::memory_order_relaxed);
+    m_loadCount++;
+
+    aQueue.Wait(loadingJob);
+}
+
+RED4EXT_INLINE void RED4ext::DeferredDataBufferGroup::Finish(JobQueue& aQueue, LoadedCallback&& aCallback)
+{
+    if (m_loadCount == 0)
+    {
+        m_pending->store(0, std::memory_order_release);
+
+        if (aCallback.handler)
+        {
+            aCallback();
+        }
+
+        return;
+    }
+
+    // The queue waits for every load, a single job counts all of them down before the callback runs.
+    aQueue.Dispatch(Detail::DeferredDataBufferCountDown{m_pending, m_loadCount});
+
+    if (aCallback.handler)
+    {
+        aQueue.Dispatch(std::move(aCallback));
+    }
+
+    m_job = aQueue.Capture();
+    m_pending->fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/Callback.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+namespace Detail
+{
+/**
+ * @brief The job that counts the loads of a DeferredDataBufferGroup down once all of them have finished.
+ */
+struct DeferredDataBufferCountDown
+{
+    void operator()() const;
+
+    std::shared_ptr<std::atomic<uint32_t>> pending;
+    uint32_t count;
+};
+} // namespace Detail
+
+/**
+ * @brief Loads a set of deferred data buffers and reports their completion once.
+ *
+ * Instead of one token and one OnLoaded() callback per buffer, a single job queue waits for every load, then counts all
+ * of them down at once and fires one callback. Completion is tracked by a single atomic counter, so IsReady() and
+ * GetPendingCount() can be polled from any thread without locking the buffers. Load() and GetJob() must be called from
+ * one thread at a time.
+ */
+class DeferredDataBufferGroup
+{
+public:
+    using LoadedCallback = Callback<void (*)()>;
+
+    DeferredDataBufferGroup();
+    DeferredDataBufferGroup(const DeferredDataBufferGroup&) = delete;
+    DeferredDataBufferGroup& operator=(const DeferredDataBufferGroup&) = delete;
+
+    /**
+     * @brief Starts loading the buffers.
+     *
+     * Buffers that are already loaded are skipped. If nothing has to be loaded the callback is called right away, on
+     * the calling thread, otherwise it is called from a job thread. The buffers must outlive the load.
+     *
+     * @param aBuffers The buffers.
+     * @param aCallback The callback, called once when all buffers have finished loading.
+     * @return False if a previous load of this group is still in progress.
+     */
+    bool Load(Span<DeferredDataBuffer> aBuffers, LoadedCallback&& aCallback = {});
+    bool Load(Span<DeferredDataBuffer*> aBuffers, LoadedCallback&& aCallback = {});
+
+    /**
+     * @brief Returns true when every buffer of the last Load() has finished loading, does not lock anything.
+     */
+    [[nodiscard]] bool IsReady() const noexcept;
+
+    /**
+     * @brief Returns the number of buffers of the last Load() that are still pending, does not lock anything. The loads
+     * are counted down together once the last one has finished.
+     */
+    [[nodiscard]] uint32_t GetPendingCount() const noexcept;
+
+    /**
+     * @brief Returns a job handle that completes when every buffer of the last Load() has finished loading.
+     */
+    [[nodiscard]] const JobHandle& GetJob() const noexcept;
+
+private:
+    bool Begin();
+    void Add(DeferredDataBuffer& aBuffer, JobQueue& aQueue);
+    void Finish(JobQueue& aQueue, LoadedCallback&& aCallback);
+
+    // Shared with the count down job, it is created once and reused by every Load().
+    const std::shared_ptr<std::atomic<uint32_t>> m_pending;
+    uint32_t m_loadCount;
+    JobHandle m_job;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/DeferredDataBufferGroup-inl.hpp>
+#endif
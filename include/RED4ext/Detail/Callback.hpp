@@ -1,7 +1,11 @@
 #pragma once
 
+#include <functional>
+#include <new>
 #include <type_traits>
+#include <utility>
 
+#include <RED4ext/Detail/CallbackPool.hpp>
 #include <RED4ext/Detail/Function.hpp>
 
 namespace RED4ext
@@ -36,6 +40,80 @@ struct ClosureTarget : L
     using ClosureType = L;
 };
 
+/**
+ * @brief A closure that did not fit into the callback's buffer, the buffer holds a pointer to it.
+ *
+ * @tparam Storage Creates, copies and destroys the closure, see CallbackHeapStorage.
+ */
+template<typename L, typename Storage, typename R, typename... Args>
+requires IsClosure<L, R, Args...>
+struct SpilledClosureTarget
+{
+    L* closure;
+};
+
+struct CallbackHeapStorage
+{
+    template<typename L, typename T>
+    static L* Create(T&& aClosure)
+    {
+        return new L(std::forward<T>(aClosure));
+    }
+
+    template<typename L>
+    static L* Clone(const L* aClosure)
+    {
+        return new L(*aClosure);
+    }
+
+    template<typename L>
+    static void Destroy(L* aClosure) noexcept
+    {
+        delete aClosure;
+    }
+};
+
+struct CallbackPoolStorage
+{
+    // Over-aligned closures are left to the heap, the pool's blocks have the default alignment.
+    template<typename L>
+    static constexpr bool IsPooled = alignof(L) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    template<typename L, typename T>
+    static L* Create(T&& aClosure)
+    {
+        if constexpr (IsPooled<L>)
+        {
+            auto block = CallbackPool::Allocate(sizeof(L));
+            return new (block) L(std::forward<T>(aClosure));
+        }
+        else
+        {
+            return CallbackHeapStorage::Create<L>(std::forward<T>(aClosure));
+        }
+    }
+
+    template<typename L>
+    static L* Clone(const L* aClosure)
+    {
+        return Create<L>(*aClosure);
+    }
+
+    template<typename L>
+    static void Destroy(L* aClosure) noexcept
+    {
+        if constexpr (IsPooled<L>)
+        {
+            aClosure->~L();
+            CallbackPool::Free(aClosure, sizeof(L));
+        }
+        else
+        {
+            CallbackHeapStorage::Destroy(aClosure);
+        }
+    }
+};
+
 template<typename T>
 struct CallbackHandlerImpl;
 
@@ -46,7 +124,7 @@ struct CallbackHandlerImpl<UnboundFunctionTarget<R, Args...>>
 
     static R Invoke(const TargetType* aTarget, Args&&... aArgs)
     {
-        std::invoke(aTarget->func, std::forward<Args>(aArgs)...);
+        return std::invoke(aTarget->func, std::forward<Args>(aArgs)...);
     }
 
     static void Copy(TargetType* aDst, TargetType* aSrc)
@@ -73,7 +151,7 @@ struct CallbackHandlerImpl<MemberFunctionTarget<C, R, Args...>>
 
     static R Invoke(const TargetType* aTarget, Args&&... aArgs)
     {
-        std::invoke(aTarget->func, aTarget->context, std::forward<Args>(aArgs)...);
+        return std::invoke(aTarget->func, aTarget->context, std::forward<Args>(aArgs)...);
     }
 
     static void Copy(TargetType* aDst, TargetType* aSrc)
@@ -105,7 +183,7 @@ struct CallbackHandlerImpl<ClosureTarget<L, R, Args...>>
 
     static R Invoke(const TargetType* aTarget, Args&&... aArgs)
     {
-        (*aTarget)(std::forward<Args>(aArgs)...);
+        return (*aTarget)(std::forward<Args>(aArgs)...);
     }
 
     static void Copy(TargetType* aDst, TargetType* aSrc)
@@ -125,6 +203,38 @@ struct CallbackHandlerImpl<ClosureTarget<L, R, Args...>>
     }
 };
 
+template<typename L, typename Storage, typename R, typename... Args>
+struct CallbackHandlerImpl<SpilledClosureTarget<L, Storage, R, Args...>>
+{
+    using TargetType = SpilledClosureTarget<L, Storage, R, Args...>;
+
+    static R Invoke(const TargetType* aTarget, Args&&... aArgs)
+    {
+        return (*aTarget->closure)(std::forward<Args>(aArgs)...);
+    }
+
+    static void Copy(TargetType* aDst, TargetType* aSrc)
+    {
+        new (aDst) TargetType{Storage::Clone(aSrc->closure)};
+    }
+
+    static void Move(TargetType* aDst, TargetType* aSrc)
+    {
+        // The closure stays where it is, only the pointer moves.
+        new (aDst) TargetType{aSrc->closure};
+        aSrc->closure = nullptr;
+    }
+
+    static void Destruct(TargetType* aTarget)
+    {
+        if (aTarget->closure)
+        {
+            Storage::Destroy(aTarget->closure);
+            aTarget->closure = nullptr;
+        }
+    }
+};
+
 template<typename Impl, typename R, typename... Args>
 struct CallbackHandlerFactory
 {
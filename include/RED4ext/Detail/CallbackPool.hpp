@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace RED4ext::Detail
+{
+/**
+ * @brief A per-thread cache of blocks for closures that do not fit into a callback.
+ *
+ * Blocks are grouped into size classes of 64, 128, 256, 512 and 1024 bytes, larger closures go to the heap directly.
+ * Every block is a heap allocation of its own, a block that is freed on another thread than the one that allocated it
+ * simply moves to the cache of that thread. A thread caches up to MaxCachedBlocks blocks per class, they are released
+ * when the thread exits.
+ */
+class CallbackPool
+{
+public:
+    static constexpr size_t MinBlockSize = 64;
+    static constexpr size_t MaxBlockSize = 1024;
+    static constexpr uint32_t ClassCount = 5;
+    static constexpr uint32_t MaxCachedBlocks = 64;
+
+    static constexpr uint32_t GetClass(size_t aSize) noexcept
+    {
+        uint32_t index = 0;
+        for (auto size = MinBlockSize; size < aSize; size <<= 1)
+        {
+            ++index;
+        }
+
+        return index;
+    }
+
+    static void* Allocate(size_t aSize)
+    {
+        if (aSize > MaxBlockSize || IsCacheDestroyed())
+        {
+            return ::operator new(aSize);
+        }
+
+        auto index = GetClass(aSize);
+        auto& cache = GetCache();
+
+        if (auto block = cache.heads[index])
+        {
+            cache.heads[index] = block->next;
+            --cache.counts[index];
+            return block;
+        }
+
+        return ::operator new(MinBlockSize << index);
+    }
+
+    static void Free(void* aBlock, size_t aSize) noexcept
+    {
+        if (aSize > MaxBlockSize || IsCacheDestroyed())
+        {
+            ::operator delete(aBlock);
+            return;
+        }
+
+        auto index = GetClass(aSize);
+        auto& cache = GetCache();
+
+        if (cache.counts[index] >= MaxCachedBlocks)
+        {
+            ::operator delete(aBlock);
+            return;
+        }
+
+        auto block = static_cast<FreeBlock*>(aBlock);
+        block->next = cache.heads[index];
+        cache.heads[index] = block;
+        ++cache.counts[index];
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Cache
+    {
+        ~Cache()
+        {
+            for (auto head : heads)
+            {
+                while (head)
+                {
+                    auto next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+
+            // Callbacks destroyed by other thread locals after this point free their blocks directly.
+            IsCacheDestroyed() = true;
+        }
+
+        FreeBlock* heads[ClassCount]{};
+        uint32_t counts[ClassCount]{};
+    };
+
+    static Cache& GetCache() noexcept
+    {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    static bool& IsCacheDestroyed() noexcept
+    {
+        static thread_local bool isDestroyed = false;
+        return isDestroyed;
+    }
+};
+} // namespace RED4ext::Detail
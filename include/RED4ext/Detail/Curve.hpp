@@ -0,0 +1,282 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+
+#include <RED4ext/Scripting/Natives/Generated/curve/EInterpolationType.hpp>
+
+#if defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// The SIMD kernels only match the scalar reference if neither of them fuses a multiplication and an addition. Clang
+// and GCC do that by default on ARM64, where every CPU has FMA, and on x64 when FMA is enabled. MSVC does not contract
+// under /fp:precise.
+#if defined(__clang__)
+#define RED4EXT_CURVE_KERNEL
+#define RED4EXT_CURVE_NO_CONTRACT _Pragma("clang fp contract(off)")
+#elif defined(__GNUC__)
+#define RED4EXT_CURVE_KERNEL __attribute__((optimize("fp-contract=off")))
+#define RED4EXT_CURVE_NO_CONTRACT
+#else
+#define RED4EXT_CURVE_KERNEL
+#define RED4EXT_CURVE_NO_CONTRACT
+#endif
+
+namespace RED4ext::Detail
+{
+// clang-format off
+template<typename T>
+concept IsCurveInterpolable = requires(const T& a, const T& b, float t)
+{
+    { a + b } -> std::convertible_to<T>;
+    { a - b } -> std::convertible_to<T>;
+    { a * t } -> std::convertible_to<T>;
+};
+// clang-format on
+
+/**
+ * @brief Returns the index of the segment [aPoints[i], aPoints[i + 1]) that contains the point.
+ *
+ * The point must be inside the curve. The hinted segment and the one after it are checked first, sequential queries
+ * do not have to search.
+ */
+inline uint32_t FindCurveSegment(const float* aPoints, uint32_t aSize, float aPoint, uint32_t aHint) noexcept
+{
+    if (aHint + 1 < aSize && aPoints[aHint] <= aPoint)
+    {
+        if (aPoint < aPoints[aHint + 1])
+        {
+            return aHint;
+        }
+
+        if (aHint + 2 < aSize && aPoint < aPoints[aHint + 2])
+        {
+            return aHint + 1;
+        }
+    }
+
+    // Branchless binary search for the last key in front of the point, random queries would mispredict most branches.
+    auto base = aPoints;
+    auto length = aSize - 1;
+
+    while (length > 1)
+    {
+        auto half = length / 2;
+        base = base[half] <= aPoint ? base + half : base;
+        length -= half;
+    }
+
+    return static_cast<uint32_t>(base - aPoints);
+}
+
+/**
+ * @brief Returns the slope of the curve at a key, estimated from its neighbours.
+ */
+template<typename T>
+T GetCurveSlope(const float* aPoints, const T* aValues, uint32_t aSize, uint32_t aKey) noexcept
+{
+    auto left = aKey > 0 ? aKey - 1 : aKey;
+    auto right = aKey + 1 < aSize ? aKey + 1 : aKey;
+
+    auto width = aPoints[right] - aPoints[left];
+    if (!(width > 0.0f))
+    {
+        return T();
+    }
+
+    return (aValues[right] - aValues[left]) * (1.0f / width);
+}
+
+/**
+ * @brief Loads the interpolation inputs of a segment.
+ *
+ * The curve buffer does not store tangents, they are derived from the neighbouring keys. The Bézier control points are
+ * placed on these tangents, which lets every cubic type be evaluated in Hermite form.
+ */
+template<typename T>
+void LoadCurveSegment(const float* aPoints, const T* aValues, uint32_t aSize, curve::EInterpolationType aType,
+                      uint32_t aSegment, float aPoint, float& aT, T& aV0, T& aV1, T& aM0, T& aM1) noexcept
+{
+    auto width = aPoints[aSegment + 1] - aPoints[aSegment];
+    aT = width > 0.0f ? (aPoint - aPoints[aSegment]) / width : 0.0f;
+
+    aV0 = aValues[aSegment];
+    aV1 = aValues[aSegment + 1];
+
+    if (aType == curve::EInterpolationType::EIT_Linear)
+    {
+        return;
+    }
+
+    aM0 = GetCurveSlope(aPoints, aValues, aSize, aSegment) * width;
+
+    if (aType == curve::EInterpolationType::EIT_BezierQuadratic)
+    {
+        // The single control point is v0 + m0 / 2, the tangent at the end follows from it.
+        aM1 = (aV1 - aV0) * 2.0f - aM0;
+    }
+    else
+    {
+        aM1 = GetCurveSlope(aPoints, aValues, aSize, aSegment + 1) * width;
+    }
+}
+
+// The kernels below are the reference, the SIMD versions must perform the same operations in the same order to give
+// the same results.
+
+template<typename T>
+RED4EXT_CURVE_KERNEL T LerpCurve(const T& aV0, const T& aV1, float aT) noexcept
+{
+    RED4EXT_CURVE_NO_CONTRACT
+    return aV0 + (aV1 - aV0) * aT;
+}
+
+template<typename T>
+RED4EXT_CURVE_KERNEL T HermiteCurve(const T& aV0, const T& aV1, const T& aM0, const T& aM1, float aT) noexcept
+{
+    RED4EXT_CURVE_NO_CONTRACT
+    float t2 = aT * aT;
+    float t3 = t2 * aT;
+
+    float h00 = (2.0f * t3 - 3.0f * t2) + 1.0f;
+    float h10 = (t3 - 2.0f * t2) + aT;
+    float h01 = 3.0f * t2 - 2.0f * t3;
+    float h11 = t3 - t2;
+
+    return ((aV0 * h00 + aM0 * h10) + aV1 * h01) + aM1 * h11;
+}
+
+template<typename T>
+RED4EXT_CURVE_KERNEL void LerpCurve(const T* aV0, const T* aV1, const float* aT, T* aResults, uint32_t aCount) noexcept
+{
+    RED4EXT_CURVE_NO_CONTRACT
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        aResults[i] = LerpCurve(aV0[i], aV1[i], aT[i]);
+    }
+}
+
+RED4EXT_CURVE_KERNEL inline void LerpCurve(const float* aV0, const float* aV1, const float* aT, float* aResults,
+                                           uint32_t aCount) noexcept
+{
+    RED4EXT_CURVE_NO_CONTRACT
+    uint32_t i = 0;
+
+#if defined(_M_X64) || defined(__SSE__)
+    for (; i + 4 <= aCount; i += 4)
+    {
+        auto v0 = _mm_loadu_ps(aV0 + i);
+        auto v1 = _mm_loadu_ps(aV1 + i);
+        auto t = _mm_loadu_ps(aT + i);
+
+        _mm_storeu_ps(aResults + i, _mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), t)));
+    }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    for (; i + 4 <= aCount; i += 4)
+    {
+        auto v0 = vld1q_f32(aV0 + i);
+        auto v1 = vld1q_f32(aV1 + i);
+        auto t = vld1q_f32(aT + i);
+
+        vst1q_f32(aResults + i, vaddq_f32(v0, vmulq_f32(vsubq_f32(v1, v0), t)));
+    }
+#endif
+
+    for (; i < aCount; ++i)
+    {
+        aResults[i] = LerpCurve(aV0[i], aV1[i], aT[i]);
+    }
+}
+
+template<typename T>
+RED4EXT_CURVE_KERNEL void HermiteCurve(const T* aV0, const T* aV1, const T* aM0, const T* aM1, const float* aT,
+                                       T* aResults, uint32_t aCount) noexcept
+{
+    RED4EXT_CURVE_NO_CONTRACT
+    for (uint32_t i = 0; i < aCount; ++i)
+    {
+        aResults[i] = HermiteCurve(aV0[i], aV1[i], aM0[i], aM1[i], aT[i]);
+    }
+}
+
+RED4EXT_CURVE_KERNEL inline void HermiteCurve(const float* aV0, const float* aV1, const float* aM0, const float* aM1,
+                                              const float* aT, float* aResults, uint32_t aCount) noexcept
+{
+    RED4EXT_CURVE_NO_CONTRACT
+    uint32_t i = 0;
+
+#if defined(_M_X64) || defined(__SSE__)
+    const auto one = _mm_set1_ps(1.0f);
+    const auto two = _mm_set1_ps(2.0f);
+    const auto three = _mm_set1_ps(3.0f);
+
+    for (; i + 4 <= aCount; i += 4)
+    {
+        auto t = _mm_loadu_ps(aT + i);
+        auto t2 = _mm_mul_ps(t, t);
+        auto t3 = _mm_mul_ps(t2, t);
+
+        auto h00 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, t3), _mm_mul_ps(three, t2)), one);
+        auto h10 = _mm_add_ps(_mm_sub_ps(t3, _mm_mul_ps(two, t2)), t);
+        auto h01 = _mm_sub_ps(_mm_mul_ps(three, t2), _mm_mul_ps(two, t3));
+        auto h11 = _mm_sub_ps(t3, t2);
+
+        auto result = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(aV0 + i), h00), _mm_mul_ps(_mm_loadu_ps(aM0 + i), h10));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(aV1 + i), h01));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(aM1 + i), h11));
+
+        _mm_storeu_ps(aResults + i, result);
+    }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    const auto one = vdupq_n_f32(1.0f);
+    const auto two = vdupq_n_f32(2.0f);
+    const auto three = vdupq_n_f32(3.0f);
+
+    for (; i + 4 <= aCount; i += 4)
+    {
+        auto t = vld1q_f32(aT + i);
+        auto t2 = vmulq_f32(t, t);
+        auto t3 = vmulq_f32(t2, t);
+
+        auto h00 = vaddq_f32(vsubq_f32(vmulq_f32(two, t3), vmulq_f32(three, t2)), one);
+        auto h10 = vaddq_f32(vsubq_f32(t3, vmulq_f32(two, t2)), t);
+        auto h01 = vsubq_f32(vmulq_f32(three, t2), vmulq_f32(two, t3));
+        auto h11 = vsubq_f32(t3, t2);
+
+        auto result = vaddq_f32(vmulq_f32(vld1q_f32(aV0 + i), h00), vmulq_f32(vld1q_f32(aM0 + i), h10));
+        result = vaddq_f32(result, vmulq_f32(vld1q_f32(aV1 + i), h01));
+        result = vaddq_f32(result, vmulq_f32(vld1q_f32(aM1 + i), h11));
+
+        vst1q_f32(aResults + i, result);
+    }
+#endif
+
+    for (; i < aCount; ++i)
+    {
+        aResults[i] = HermiteCurve(aV0[i], aV1[i], aM0[i], aM1[i], aT[i]);
+    }
+}
+
+/**
+ * @brief The interpolation inputs of a batch of queries, stored per component so they can be processed in parallel.
+ */
+template<typename T>
+struct CurveBatch
+{
+    static constexpr uint32_t Capacity = 64;
+
+    uint32_t targets[Capacity]; // Index of the result of each query.
+    float t[Capacity];
+    T v0[Capacity];
+    T v1[Capacity];
+    T m0[Capacity];
+    T m1[Capacity];
+    T results[Capacity];
+};
+} // namespace RED4ext::Detail
+
+#undef RED4EXT_CURVE_KERNEL
+#undef RED4EXT_CURVE_NO_CONTRACT
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace RED4ext::Detail
+{
+#if defined(_MSC_VER) && defined(_M_ARM64) && !defined(__clang__)
+// ARM64_SYSREG(3, 3, 14, 0, 2) and ARM64_SYSREG(3, 3, 14, 0, 0) of winnt.h.
+inline constexpr int32_t CntvctEl0 = 0x5F02;
+inline constexpr int32_t CntfrqEl0 = 0x5F00;
+#endif
+
+/**
+ * @brief Returns the current value of a cheap monotonic counter: the time stamp counter on x86-64, the virtual counter
+ * (CNTVCT_EL0) on ARM64 and steady clock nanoseconds otherwise.
+ *
+ * The ticks are not CPU cycles on every platform, see GetCycleCounterFrequency().
+ */
+inline uint64_t ReadCycleCounter() noexcept
+{
+#if (defined(_MSC_VER) && defined(_M_X64)) || defined(__x86_64__)
+    return __rdtsc();
+#elif defined(_MSC_VER) && defined(_M_ARM64) && !defined(__clang__)
+    return static_cast<uint64_t>(_ReadStatusReg(CntvctEl0));
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/**
+ * @brief Returns the ticks per second of ReadCycleCounter(), or 0 if the frequency is not known.
+ *
+ * The time stamp counter does not expose its frequency, it is 0 on x86-64. Convert its ticks by comparing them with
+ * the steady clock over an interval.
+ */
+inline uint64_t GetCycleCounterFrequency() noexcept
+{
+#if (defined(_MSC_VER) && defined(_M_X64)) || defined(__x86_64__)
+    return 0;
+#elif defined(_MSC_VER) && defined(_M_ARM64) && !defined(__clang__)
+    return static_cast<uint64_t>(_ReadStatusReg(CntfrqEl0));
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(value));
+    return value;
+#else
+    return 1000000000;
+#endif
+}
+} // namespace RED4ext::Detail
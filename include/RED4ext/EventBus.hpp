@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <RED4ext/Callback.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/HookProfiler.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Delivers events of one type to any number of subscribers.
+ *
+ * The subscribers are stored contiguously in a table of callbacks, callbacks of the same closure type share one handler
+ * table. Publishing takes no lock and does not allocate, it only registers the thread as a reader of the current
+ * table. Subscribing and unsubscribing copy the table and swap it in, the old table is released once no reader that
+ * might still use it is left (epoch based reclamation). Both are allowed from inside a subscriber, a publish that is in
+ * progress keeps calling the subscribers of the table it started with.
+ *
+ * With profiling enabled every subscriber gets a HookProfile, its calls show up in HookProfiler::Dump().
+ *
+ * @tparam Event The event type, subscribers are called with a const reference to it.
+ * @tparam InlineSize The inline size of the callbacks.
+ *
+ * @example
+ *
+ * RED4ext::EventBus<DamageEvent> bus;
+ *
+ * auto id = bus.Subscribe([this](const DamageEvent& aEvent) { m_total += aEvent.amount; }, "MyPlugin/Damage");
+ * bus.Publish(DamageEvent{10.0f});
+ * bus.PublishBatch({events.data(), events.size()});
+ * bus.Unsubscribe(id);
+ */
+template<typename Event, size_t InlineSize = DefaultFixedCallbackBufferSize>
+class EventBus
+{
+public:
+    using CallbackType = Callback<void (*)(const Event&), InlineSize>;
+    using SubscriptionId = uint32_t;
+
+    static constexpr SubscriptionId InvalidSubscription = 0;
+
+    EventBus()
+        : m_table(new Table())
+        , m_epoch(0)
+        , m_nextId(1)
+        , m_isProfiling(false)
+    {
+    }
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @brief Destroys the subscribers. No publish may be in progress.
+     */
+    ~EventBus()
+    {
+        delete m_table.load(std::memory_order_relaxed);
+
+        for (auto& retired : m_retired)
+        {
+            delete retired.table;
+        }
+    }
+
+    /**
+     * @brief Adds a subscriber, it is called by every publish that starts afterwards.
+     * @param aName The name of the subscriber's profile, the string has to outlive the subscription.
+     * @return The id that removes the subscriber again.
+     */
+    SubscriptionId Subscribe(CallbackType aCallback, const char* aName = nullptr)
+    {
+        std::lock_guard<std::mutex> _(m_lock);
+
+        auto table = new Table(*m_table.load(std::memory_order_relaxed));
+
+        auto id = m_nextId++;
+
+        table->callbacks.push_back(std::move(aCallback));
+        table->subscribers.push_back({id, aName, m_isProfiling ? CreateProfile(aName) : nullptr});
+
+        Replace(table);
+        return id;
+    }
+
+    /**
+     * @brief Removes a subscriber. Publishes that are in progress on other threads might still call it.
+     * @return true if the subscriber was found.
+     */
+    bool Unsubscribe(SubscriptionId aId)
+    {
+        std::lock_guard<std::mutex> _(m_lock);
+
+        const auto& subscribers = m_table.load(std::memory_order_relaxed)->subscribers;
+        auto it = std::find_if(subscribers.begin(), subscribers.end(),
+                               [aId](const Subscriber& aSubscriber) { return aSubscriber.id == aId; });
+
+        if (it == subscribers.end())
+        {
+            return false;
+        }
+
+        auto index = it - subscribers.begin();
+
+        auto table = new Table(*m_table.load(std::memory_order_relaxed));
+        table->callbacks.erase(table->callbacks.begin() + index);
+        table->subscribers.erase(table->subscribers.begin() + index);
+
+        Replace(table);
+        return true;
+    }
+
+    /**
+     * @brief Calls every subscriber with the event, in the order they subscribed.
+     */
+    void Publish(const Event& aEvent) const
+    {
+        ReadGuard guard(*this);
+        Dispatch(*guard.table, Span<const Event>(&aEvent, 1));
+    }
+
+    /**
+     * @brief Calls every subscriber with all events before moving on to the next subscriber. A subscriber that is
+     * called with the whole batch keeps its code and data in the cache.
+     */
+    void PublishBatch(Span<const Event> aEvents) const
+    {
+        ReadGuard guard(*this);
+        Dispatch(*guard.table, aEvents);
+    }
+
+    [[nodiscard]] size_t GetSubscriberCount() const
+    {
+        ReadGuard guard(*this);
+        return guard.table->callbacks.size();
+    }
+
+    /**
+     * @brief Creates or destroys a HookProfile for every subscriber, named by the name given to Subscribe().
+     */
+    void SetProfiling(bool aEnabled)
+    {
+        std::lock_guard<std::mutex> _(m_lock);
+
+        if (m_isProfiling == aEnabled)
+        {
+            return;
+        }
+
+        m_isProfiling = aEnabled;
+
+        auto table = new Table(*m_table.load(std::memory_order_relaxed));
+        table->isProfiling = aEnabled;
+
+        for (auto& subscriber : table->subscribers)
+        {
+            subscriber.profile = aEnabled ? CreateProfile(subscriber.name) : nullptr;
+        }
+
+        Replace(table);
+    }
+
+    [[nodiscard]] bool IsProfiling() const
+    {
+        std::lock_guard<std::mutex> _(m_lock);
+        return m_isProfiling;
+    }
+
+private:
+    struct Subscriber
+    {
+        SubscriptionId id;
+        const char* name;
+        std::shared_ptr<HookProfile> profile; // Shared with the copies of the table, only set when profiling.
+    };
+
+    // The callbacks are kept apart from the rest, dispatching only walks through them.
+    struct Table
+    {
+        std::vector<CallbackType> callbacks;
+        std::vector<Subscriber> subscribers;
+        bool isProfiling = false;
+    };
+
+    struct Retired
+    {
+        Table* table;
+        uint64_t epoch;
+    };
+
+    // The readers of even and odd epochs, each on its own cache line.
+    struct alignas(64) ReaderCount
+    {
+        std::atomic<uint32_t> value{0};
+    };
+
+    struct ReadGuard
+    {
+        explicit ReadGuard(const EventBus& aBus) noexcept
+            : readers(aBus.m_readers[aBus.m_epoch.load() & 1].value)
+        {
+            // The table is loaded after registering, a writer that did not see this reader swapped the table first.
+            readers.fetch_add(1);
+            table = aBus.m_table.load();
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard()
+        {
+            readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        std::atomic<uint32_t>& readers;
+        const Table* table;
+    };
+
+    static void Dispatch(const Table& aTable, Span<const Event> aEvents)
+    {
+        if (!aTable.isProfiling)
+        {
+            for (const auto& callback : aTable.callbacks)
+            {
+                Invoke(callback, aEvents);
+            }
+
+            return;
+        }
+
+        for (size_t i = 0; i < aTable.callbacks.size(); ++i)
+        {
+            // The profile measures the whole batch as one call.
+            HookProfile::Scope _(*aTable.subscribers[i].profile);
+            Invoke(aTable.callbacks[i], aEvents);
+        }
+    }
+
+    static void Invoke(const CallbackType& aCallback, Span<const Event> aEvents)
+    {
+        // The target and its handler do not change while the table is in use.
+        auto invoke = aCallback.handler->invoke;
+        auto target = aCallback.buffer;
+
+        for (const auto& event : aEvents)
+        {
+            invoke(target, event);
+        }
+    }
+
+    static std::shared_ptr<HookProfile> CreateProfile(const char* aName)
+    {
+        return std::make_shared<HookProfile>(aName ? aName : "EventBus subscriber");
+    }
+
+    /**
+     * @brief Publishes the table and releases the old tables that no reader can use anymore. Requires the lock.
+     */
+    void Replace(Table* aTable)
+    {
+        auto old = m_table.exchange(aTable);
+        m_retired.push_back({old, m_epoch.load()});
+
+        // A table retired in epoch E might be used by readers of E and E - 1. Moving from E to E + 1 waits for the
+        // readers of E - 1, moving on to E + 2 waits for the readers of E. Readers that register later load the new
+        // table.
+        for (int i = 0; i < 2; ++i)
+        {
+            auto epoch = m_epoch.load();
+            if (m_readers[(epoch + 1) & 1].value.load() != 0)
+            {
+                break;
+            }
+
+            m_epoch.store(epoch + 1);
+        }
+
+        auto epoch = m_epoch.load();
+        std::erase_if(m_retired,
+                      [epoch](const Retired& aRetired)
+                      {
+                          if (aRetired.epoch + 2 > epoch)
+                          {
+                              return false;
+                          }
+
+                          delete aRetired.table;
+                          return true;
+                      });
+    }
+
+    std::atomic<Table*> m_table;
+    std::atomic<uint64_t> m_epoch;
+    mutable ReaderCount m_readers[2];
+
+    mutable std::mutex m_lock; // Guards the fields below and serializes writers.
+    std::vector<Retired> m_retired;
+    SubscriptionId m_nextId;
+    bool m_isProfiling;
+};
+} // namespace RED4ext
@@ -46,6 +46,14 @@ struct GameInstance
     virtual void Unk_60() = 0;                                      // 60
     virtual void Unk_68() = 0;                                      // 68
 
+    /**
+     * @brief Returns the system of the given type, the result is cached, see GameSystemCache.
+     * @tparam T The generated system class, e.g. game::TimeSystem.
+     * @return The system, or nullptr if the game instance does not have it.
+     */
+    template<typename T>
+    T* GetSystem();
+
     HashMap<CBaseRTTIType*, Handle<IScriptable>> systemMap;        // 08 - Maps implementation type to instance
     DynArray<Handle<IScriptable>> systemInstances;                 // 38
     HashMap<CBaseRTTIType*, CBaseRTTIType*> systemImplementations; // 48 - Maps interface type to implementation type
@@ -240,6 +248,15 @@ RED4EXT_ASSERT_SIZE(CGameEngine, 0x350);
 RED4EXT_ASSERT_OFFSET(CGameEngine, framework, 0x308);
 } // namespace RED4ext
 
+// Included after GameInstance is complete, the cache's implementation uses it in header-only builds.
+#include <RED4ext/GameSystemCache.hpp>
+
+template<typename T>
+T* RED4ext::GameInstance::GetSystem()
+{
+    return static_cast<T*>(GameSystemCache::Get(this, GameSystemCache::ResolveType<T>()));
+}
+
 #ifdef RED4EXT_HEADER_ONLY
 #include <RED4ext/GameEngine-inl.hpp>
 #endif
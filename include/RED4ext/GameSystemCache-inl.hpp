@@ -0,0 +1,127 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/GameSystemCache.hpp>
+#endif
+
+#include <RED4ext/GameEngine.hpp>
+#include <RED4ext/RTTISystem.hpp>
+#include <RED4ext/RTTITypes.hpp>
+
+RED4EXT_INLINE RED4ext::IScriptable* RED4ext::GameSystemCache::Get(GameInstance* aInstance,
+                                                                   const CBaseRTTIType* aType)
+{
+    if (!aInstance || !aType)
+    {
+        return nullptr;
+    }
+
+    auto& slot = GetSlots()[GetSlotIndex(aInstance, aType)];
+    auto generation = GetGeneration().load(std::memory_order_acquire);
+
+    IScriptable* system;
+    if (TryRead(slot, generation, aInstance, aType, system))
+    {
+        return system;
+    }
+
+    system = aInstance->GetSystem(aType);
+    if (system)
+    {
+        // Do not cache misses, the system might be registered later.
+        Write(slot, generation, aInstance, aType, system);
+    }
+
+    return system;
+}
+
+RED4EXT_INLINE void RED4ext::GameSystemCache::Invalidate()
+{
+    GetGeneration().fetch_add(1, std::memory_order_acq_rel);
+}
+
+RED4EXT_INLINE const RED4ext::CBaseRTTIType* RED4ext::GameSystemCache::ResolveType(CName aName)
+{
+    auto rtti = CRTTISystem::Get();
+    if (!rtti)
+    {
+        return nullptr;
+    }
+
+    return rtti->GetClass(aName);
+}
+
+RED4EXT_INLINE RED4ext::GameSystemCache::Slot* RED4ext::GameSystemCache::GetSlots()
+{
+    static Slot slots[SlotCount]{};
+    return slots;
+}
+
+RED4EXT_INLINE std::atomic<uint32_t>& RED4ext::GameSystemCache::GetGeneration()
+{
+    // Start at 1 so zero-initialized slots never match.
+    static std::atomic<uint32_t> generation = 1;
+    return generation;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::GameSystemCache::GetSlotIndex(const GameInstance* aInstance,
+                                                               const CBaseRTTIType* aType)
+{
+    // Types and instances are heap allocated, drop the low bits that are always zero due to the alignment.
+    auto key = (reinterpret_cast<uintptr_t>(aType) >> 4) ^ (reinterpret_cast<uintptr_t>(aInstance) >> 6);
+    key ^= key >> 17;
+    key *= 0x9E3779B97F4A7C15ull;
+
+    return static_cast<uint32_t>(key >> 58) & (SlotCount - 1);
+}
+
+RED4EXT_INLINE bool RED4ext::GameSystemCache::TryRead(Slot& aSlot, uint32_t aGeneration,
+                                                      const GameInstance* aInstance, const CBaseRTTIType* aType,
+                                                      IScriptable*& aSystem)
+{
+    auto sequence = aSlot.sequence.load(std::memory_order_acquire);
+    if (sequence & 1)
+    {
+        return false;
+    }
+
+    auto generation = aSlot.generation.load(std::memory_order_relaxed);
+    auto instance = aSlot.instance.load(std::memory_order_relaxed);
+    auto type = aSlot.type.load(std::memory_order_relaxed);
+    auto system = aSlot.system.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (aSlot.sequence.load(std::memory_order_relaxed) != sequence)
+    {
+        return false;
+    }
+
+    if (generation != aGeneration || instance != aInstance || type != aType)
+    {
+        return false;
+    }
+
+    aSystem = system;
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::GameSystemCache::Write(Slot& aSlot, uint32_t aGeneration, const GameInstance* aInstance,
+                                                    const CBaseRTTIType* aType, IScriptable* aSystem)
+{
+    auto sequence = aSlot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) ||
+        !aSlot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire))
+    {
+        // Another thread is filling the slot, skip it, the next lookup will try again.
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    aSlot.generation.store(aGeneration, std::memory_order_relaxed);
+    aSlot.instance.store(aInstance, std::memory_order_relaxed);
+    aSlot.type.store(aType, std::memory_order_relaxed);
+    aSlot.system.store(aSystem, std::memory_order_relaxed);
+
+    aSlot.sequence.store(sequence + 2, std::memory_order_release);
+}
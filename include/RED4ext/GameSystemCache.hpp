@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <RED4ext/CName.hpp>
+#include <RED4ext/Common.hpp>
+
+namespace RED4ext
+{
+struct CBaseRTTIType;
+struct GameInstance;
+struct IScriptable;
+
+/**
+ * @brief Direct-mapped cache in front of GameInstance::GetSystem.
+ *
+ * Entries are keyed by the game instance and the requested type. A hit is returned as is, without asking the instance
+ * again. When the game instance is torn down and rebuilt (e.g. on session changes) the new instance and its systems can
+ * reuse the old addresses, call Invalidate() whenever a session ends, e.g. from the exit callback of the running game
+ * state, otherwise stale systems are returned.
+ */
+class GameSystemCache
+{
+public:
+    static constexpr uint32_t SlotCount = 64;
+
+    /**
+     * @brief Returns the system registered for the given type, resolving it through the game instance on a miss.
+     * @param aInstance The game instance.
+     * @param aType The system type, either the interface or the implementation type.
+     * @return The system, or nullptr if the game instance does not have it.
+     */
+    static IScriptable* Get(GameInstance* aInstance, const CBaseRTTIType* aType);
+
+    /**
+     * @brief Drops every cached entry, the entries of every game instance are looked up again afterwards.
+     */
+    static void Invalidate();
+
+    /**
+     * @brief Resolves a type by name, returns nullptr if RTTI does not know it (yet).
+     */
+    static const CBaseRTTIType* ResolveType(CName aName);
+
+    template<typename T>
+    static const CBaseRTTIType* ResolveType()
+    {
+        // Resolved types are never unregistered, so it is safe to keep them for the lifetime of the process. Misses are
+        // not remembered since the type might not be registered yet.
+        static std::atomic<const CBaseRTTIType*> type = nullptr;
+
+        auto result = type.load(std::memory_order_relaxed);
+        if (!result)
+        {
+            result = ResolveType(T::NAME);
+            type.store(result, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence; // Odd while a writer is updating the slot.
+        std::atomic<uint32_t> generation;
+        std::atomic<const GameInstance*> instance;
+        std::atomic<const CBaseRTTIType*> type;
+        std::atomic<IScriptable*> system;
+    };
+
+    static Slot* GetSlots();
+    static std::atomic<uint32_t>& GetGeneration();
+
+    static uint32_t GetSlotIndex(const GameInstance* aInstance, const CBaseRTTIType* aType);
+
+    static bool TryRead(Slot& aSlot, uint32_t aGeneration, const GameInstance* aInstance, const CBaseRTTIType* aType,
+                        IScriptable*& aSystem);
+    static void Write(Slot& aSlot, uint32_t aGeneration, const GameInstance* aInstance, const CBaseRTTIType* aType,
+                      IScriptable* aSystem);
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/GameSystemCache-inl.hpp>
+#endif
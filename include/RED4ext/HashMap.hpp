@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <functional>
 
 #include <RED4ext/Common.hpp>
@@ -119,11 +120,18 @@ struct HashMap
         , capacity(0)
     {
         // vftable because IMemoryAllocator is abstract
-        allocator = aAllocator ? *reinterpret_cast<uintptr_t*>(aAllocator) : 0;
+        allocator = 0;
+        if (aAllocator)
+        {
+            std::memcpy(&allocator, aAllocator, sizeof(allocator));
+        }
     }
 
     HashMap(const HashMap& aOther)
-        : HashMap(aOther.GetAllocator())
+        : indexTable(nullptr)
+        , size(0)
+        , capacity(0)
+        , allocator(aOther.allocator)
     {
         CopyFrom(aOther);
     }
@@ -379,6 +387,12 @@ struct HashMap
 
     const Memory::IAllocator* GetAllocator() const
     {
+        // Without an allocator the default pool is used, like the game's DynArray does.
+        if (!allocator)
+        {
+            return Memory::DefaultAllocator::Get();
+        }
+
         return reinterpret_cast<const Memory::IAllocator*>(&allocator);
     }
 
@@ -0,0 +1,226 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/HookProfiler.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+
+RED4EXT_INLINE uint64_t RED4ext::HookStats::GetPercentile(double aFraction) const noexcept
+{
+    if (calls == 0)
+    {
+        return 0;
+    }
+
+    auto target = static_cast<uint64_t>(aFraction * static_cast<double>(calls));
+    target = (std::max)(target, uint64_t{1});
+
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < Detail::LatencyBucketCount; ++i)
+    {
+        count += histogram[i];
+        if (count >= target)
+        {
+            // The bucket's limit might be larger than anything that was recorded.
+            return (std::min)(Detail::GetLatencyBucketLimit(i), maxCycles);
+        }
+    }
+
+    return maxCycles;
+}
+
+RED4EXT_INLINE uint64_t RED4ext::HookStats::GetAverage() const noexcept
+{
+    return calls ? cycles / calls : 0;
+}
+
+RED4EXT_INLINE RED4ext::HookProfile::HookProfile(const char* aName)
+    : m_name(aName)
+    , m_epoch(0)
+    , m_untrackedCalls(0)
+    , m_threads{}
+{
+    HookProfiler::Register(*this);
+}
+
+RED4EXT_INLINE RED4ext::HookProfile::~HookProfile()
+{
+    HookProfiler::Unregister(*this);
+
+    for (auto& stats : m_threads)
+    {
+        delete stats.load(std::memory_order_relaxed);
+    }
+}
+
+RED4EXT_INLINE RED4ext::HookStats RED4ext::HookProfile::Snapshot() const
+{
+    HookStats result;
+    result.name = GetName();
+    result.untrackedCalls = m_untrackedCalls.load(std::memory_order_relaxed);
+
+    auto epoch = m_epoch.load(std::memory_order_acquire);
+
+    for (const auto& slot : m_threads)
+    {
+        auto stats = slot.load(std::memory_order_acquire);
+
+        // Threads that did not reset their counters yet have not made a call since the reset.
+        if (!stats || stats->epoch.load(std::memory_order_acquire) != epoch)
+        {
+            continue;
+        }
+
+        result.calls += stats->calls.load(std::memory_order_relaxed);
+        result.cycles += stats->cycles.load(std::memory_order_relaxed);
+        result.maxCycles = (std::max)(result.maxCycles, stats->maxCycles.load(std::memory_order_relaxed));
+
+        for (uint32_t i = 0; i < Detail::LatencyBucketCount; ++i)
+        {
+            result.histogram[i] += stats->histogram[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return result;
+}
+
+RED4EXT_INLINE void RED4ext::HookProfile::Reset() noexcept
+{
+    m_untrackedCalls.store(0, std::memory_order_relaxed);
+    m_epoch.fetch_add(1, std::memory_order_release);
+}
+
+RED4EXT_INLINE void RED4ext::HookProfile::SetName(const char* aName) noexcept
+{
+    m_name.store(aName, std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE const char* RED4ext::HookProfile::GetName() const noexcept
+{
+    return m_name.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE uint32_t RED4ext::HookProfile::GetThreadIndex() noexcept
+{
+    // Shared by all profiles, indices are not reused when a thread exits.
+    static std::atomic<uint32_t> nextIndex = 0;
+    static thread_local uint32_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+RED4EXT_INLINE RED4ext::HookProfile::ThreadStats* RED4ext::HookProfile::CreateThreadStats(uint32_t aIndex) noexcept
+{
+    // The slot belongs to the calling thread, nobody else writes it.
+    auto stats = new ThreadStats{};
+    stats->epoch.store(m_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    m_threads[aIndex].store(stats, std::memory_order_release);
+    return stats;
+}
+
+RED4EXT_INLINE void RED4ext::HookProfile::Clear(ThreadStats& aStats, uint32_t aEpoch) noexcept
+{
+    aStats.calls.store(0, std::memory_order_relaxed);
+    aStats.cycles.store(0, std::memory_order_relaxed);
+    aStats.maxCycles.store(0, std::memory_order_relaxed);
+
+    for (auto& bucket : aStats.histogram)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    // Publish the cleared counters together with the epoch.
+    aStats.epoch.store(aEpoch, std::memory_order_release);
+}
+
+RED4EXT_INLINE void RED4ext::HookProfiler::Register(HookProfile& aProfile)
+{
+    auto& registry = GetRegistry();
+
+    std::lock_guard<std::mutex> _(registry.lock);
+    registry.profiles.push_back(&aProfile);
+}
+
+RED4EXT_INLINE void RED4ext::HookProfiler::Unregister(HookProfile& aProfile)
+{
+    auto& registry = GetRegistry();
+
+    std::lock_guard<std::mutex> _(registry.lock);
+    std::erase(registry.profiles, &aProfile);
+}
+
+RED4EXT_INLINE std::vector<RED4ext::HookStats> RED4ext::HookProfiler::Snapshot()
+{
+    auto& registry = GetRegistry();
+    std::vector<HookStats> result;
+
+    std::lock_guard<std::mutex> _(registry.lock);
+    result.reserve(registry.profiles.size());
+
+    for (auto profile : registry.profiles)
+    {
+        result.push_back(profile->Snapshot());
+    }
+
+    return result;
+}
+
+RED4EXT_INLINE void RED4ext::HookProfiler::Reset()
+{
+    auto& registry = GetRegistry();
+
+    std::lock_guard<std::mutex> _(registry.lock);
+    for (auto profile : registry.profiles)
+    {
+        profile->Reset();
+    }
+}
+
+RED4EXT_INLINE void RED4ext::HookProfiler::Dump(std::ostream& aOut)
+{
+    auto stats = Snapshot();
+    std::sort(stats.begin(), stats.end(),
+              [](const HookStats& aLhs, const HookStats& aRhs) { return aLhs.cycles > aRhs.cycles; });
+
+    char line[256];
+    if (auto frequency = Detail::GetCycleCounterFrequency())
+    {
+        std::snprintf(line, sizeof(line), "durations in ticks of %.3f ns\n", 1e9 / static_cast<double>(frequency));
+    }
+    else
+    {
+        std::snprintf(line, sizeof(line), "durations in cycles of the time stamp counter\n");
+    }
+    aOut << line;
+
+    std::snprintf(line, sizeof(line), "%-40s %12s %16s %10s %10s %10s %12s\n", "hook", "calls", "total ticks",
+                  "avg", "p50", "p99", "max");
+    aOut << line;
+
+    for (const auto& entry : stats)
+    {
+        std::snprintf(line, sizeof(line), "%-40s %12llu %16llu %10llu %10llu %10llu %12llu\n",
+                      entry.name ? entry.name : "(unnamed)", static_cast<unsigned long long>(entry.calls),
+                      static_cast<unsigned long long>(entry.cycles),
+                      static_cast<unsigned long long>(entry.GetAverage()),
+                      static_cast<unsigned long long>(entry.GetPercentile(0.5)),
+                      static_cast<unsigned long long>(entry.GetPercentile(0.99)),
+                      static_cast<unsigned long long>(entry.maxCycles));
+        aOut << line;
+
+        if (entry.untrackedCalls)
+        {
+            std::snprintf(line, sizeof(line), "%-40s %12llu calls of threads without a slot\n", "",
+                          static_cast<unsigned long long>(entry.untrackedCalls));
+            aOut << line;
+        }
+    }
+}
+
+RED4EXT_INLINE RED4ext::HookProfiler::Registry& RED4ext::HookProfiler::GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include <RED4ext/Api/PluginHandle.hpp>
+#include <RED4ext/Api/v0/Hooking.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Detail/Cycles.hpp>
+
+namespace RED4ext
+{
+namespace Detail
+{
+// Durations below 8 ticks have a bucket each, every power of two above is split into 4 buckets. Everything from 2^40
+// ticks (minutes of CPU cycles, hours of a 24 MHz ARM64 counter) on ends up in the last bucket.
+inline constexpr uint32_t LatencyLinearBuckets = 8;
+inline constexpr uint32_t LatencySubBuckets = 4;
+inline constexpr uint32_t LatencyMaxExponent = 40;
+inline constexpr uint32_t LatencyBucketCount = LatencyLinearBuckets + (LatencyMaxExponent - 3) * LatencySubBuckets;
+
+inline uint32_t GetLatencyBucket(uint64_t aCycles) noexcept
+{
+    if (aCycles < LatencyLinearBuckets)
+    {
+        return static_cast<uint32_t>(aCycles);
+    }
+
+    auto exponent = static_cast<uint32_t>(std::bit_width(aCycles)) - 1;
+    if (exponent >= LatencyMaxExponent)
+    {
+        return LatencyBucketCount - 1;
+    }
+
+    auto sub = static_cast<uint32_t>(aCycles >> (exponent - 2)) & (LatencySubBuckets - 1);
+    return LatencyLinearBuckets + (exponent - 3) * LatencySubBuckets + sub;
+}
+
+/**
+ * @brief Returns the largest duration that falls into the bucket.
+ */
+inline uint64_t GetLatencyBucketLimit(uint32_t aBucket) noexcept
+{
+    if (aBucket < LatencyLinearBuckets)
+    {
+        return aBucket;
+    }
+
+    if (aBucket >= LatencyBucketCount - 1)
+    {
+        return UINT64_MAX;
+    }
+
+    auto exponent = (aBucket - LatencyLinearBuckets) / LatencySubBuckets + 3;
+    auto sub = (aBucket - LatencyLinearBuckets) % LatencySubBuckets;
+    return ((uint64_t{LatencySubBuckets} + sub + 1) << (exponent - 2)) - 1;
+}
+} // namespace Detail
+
+/**
+ * @brief The statistics of a hook, see HookProfile::Snapshot().
+ */
+struct HookStats
+{
+    /**
+     * @brief Returns an upper bound of the given percentile of the call durations.
+     * @param aFraction The percentile as a fraction, e.g. 0.99.
+     */
+    [[nodiscard]] uint64_t GetPercentile(double aFraction) const noexcept;
+
+    [[nodiscard]] uint64_t GetAverage() const noexcept;
+
+    const char* name = nullptr;
+    uint64_t calls = 0;
+    uint64_t cycles = 0;
+    uint64_t maxCycles = 0;
+    uint64_t untrackedCalls = 0; // Calls of threads that did not get a slot, they are not part of the other values.
+    std::array<uint64_t, Detail::LatencyBucketCount> histogram{};
+};
+
+/**
+ * @brief Counts the calls of a hook and their inclusive duration in ticks of Detail::ReadCycleCounter(), CPU cycles
+ * of the time stamp counter on x86-64 and ticks of the virtual counter on ARM64, see
+ * Detail::GetCycleCounterFrequency().
+ *
+ * Every thread writes to its own counters with plain stores, recording a call takes no lock and no atomic
+ * read-modify-write. Snapshots sum the counters of all threads, they are not atomic with respect to calls that are in
+ * progress. A reset is performed lazily by each thread on its next call, snapshots skip the threads that did not reset
+ * yet.
+ */
+class HookProfile
+{
+public:
+    static constexpr uint32_t MaxThreads = 256;
+
+    /**
+     * @brief Records the duration of a call on destruction.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(HookProfile& aProfile) noexcept
+            : m_profile(aProfile)
+            , m_start(Detail::ReadCycleCounter())
+        {
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            m_profile.Record(Detail::ReadCycleCounter() - m_start);
+        }
+
+    private:
+        HookProfile& m_profile;
+        uint64_t m_start;
+    };
+
+    HookProfile(const char* aName = nullptr);
+    HookProfile(const HookProfile&) = delete;
+    HookProfile& operator=(const HookProfile&) = delete;
+    ~HookProfile();
+
+    void Record(uint64_t aCycles) noexcept
+    {
+        auto stats = GetThreadStats();
+        if (!stats)
+        {
+            m_untrackedCalls.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto epoch = m_epoch.load(std::memory_order_relaxed);
+        if (stats->epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            Clear(*stats, epoch);
+        }
+
+        // Only this thread writes the counters, a load and a store are enough.
+        Add(stats->calls, 1);
+        Add(stats->cycles, aCycles);
+        Add(stats->histogram[Detail::GetLatencyBucket(aCycles)], 1);
+
+        if (aCycles > stats->maxCycles.load(std::memory_order_relaxed))
+        {
+            stats->maxCycles.store(aCycles, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] HookStats Snapshot() const;
+    void Reset() noexcept;
+
+    void SetName(const char* aName) noexcept;
+    [[nodiscard]] const char* GetName() const noexcept;
+
+private:
+    struct alignas(64) ThreadStats
+    {
+        std::atomic<uint32_t> epoch;
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> cycles;
+        std::atomic<uint64_t> maxCycles;
+        std::atomic<uint64_t> histogram[Detail::LatencyBucketCount];
+    };
+
+    static uint32_t GetThreadIndex() noexcept;
+
+    static void Add(std::atomic<uint64_t>& aCounter, uint64_t aValue) noexcept
+    {
+        aCounter.store(aCounter.load(std::memory_order_relaxed) + aValue, std::memory_order_relaxed);
+    }
+
+    ThreadStats* GetThreadStats() noexcept
+    {
+        auto index = GetThreadIndex();
+        if (index >= MaxThreads)
+        {
+            return nullptr;
+        }
+
+        auto stats = m_threads[index].load(std::memory_order_acquire);
+        return stats ? stats : CreateThreadStats(index);
+    }
+
+    ThreadStats* CreateThreadStats(uint32_t aIndex) noexcept;
+    void Clear(ThreadStats& aStats, uint32_t aEpoch) noexcept;
+
+    std::atomic<const char*> m_name;
+    std::atomic<uint32_t> m_epoch;
+    std::atomic<uint64_t> m_untrackedCalls;
+    std::atomic<ThreadStats*> m_threads[MaxThreads];
+};
+
+/**
+ * @brief The registry of all hook profiles of the plugin.
+ */
+class HookProfiler
+{
+public:
+    static void Register(HookProfile& aProfile);
+    static void Unregister(HookProfile& aProfile);
+
+    [[nodiscard]] static std::vector<HookStats> Snapshot();
+    static void Reset();
+
+    /**
+     * @brief Writes a table of the statistics of all profiles, sorted by their total time. The durations are in ticks,
+     * the first line states their length if the counter's frequency is known.
+     */
+    static void Dump(std::ostream& aOut);
+
+private:
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<HookProfile*> profiles;
+    };
+
+    static Registry& GetRegistry();
+};
+
+template<typename Sig, Sig* Detour>
+class ProfiledHook;
+
+/**
+ * @brief A detour that profiles another detour, attach it instead of the profiled one.
+ *
+ * The recorded duration of a call includes everything the detour does, usually calling the original function. The
+ * added cost per call is two reads of the cycle counter, a thread local lookup and a few stores to counters owned by
+ * the calling thread. Calls of a recursive detour are counted each time.
+ *
+ * @example
+ *
+ * bool _CInitializationState_Init(RED4ext::CInitializationState* aThis, RED4ext::CGameApplication* aApp);
+ * decltype(&_CInitializationState_Init) _CInitializationState_Init_Original;
+ *
+ * using InitHook = RED4ext::ProfiledHook<decltype(_CInitializationState_Init), &_CInitializationState_Init>;
+ *
+ * InitHook::Attach(aRED4ext->hooking, aHandle, target, reinterpret_cast<void**>(&_CInitializationState_Init_Original),
+ *                  "CInitializationState::Init");
+ */
+template<typename R, typename... Args, R (*Detour)(Args...)>
+class ProfiledHook<R(Args...), Detour>
+{
+public:
+    static bool Attach(const v0::Hooking* aHooking, PluginHandle aHandle, void* aTarget, void** aOriginal,
+                       const char* aName)
+    {
+        GetProfile().SetName(aName);
+        return aHooking->Attach(aHandle, aTarget, reinterpret_cast<void*>(&Call), aOriginal);
+    }
+
+    static bool Detach(const v0::Hooking* aHooking, PluginHandle aHandle, void* aTarget)
+    {
+        return aHooking->Detach(aHandle, aTarget);
+    }
+
+    static R Call(Args... aArgs)
+    {
+        HookProfile::Scope _(GetProfile());
+        return Detour(static_cast<Args>(aArgs)...);
+    }
+
+    static HookProfile& GetProfile()
+    {
+        static HookProfile profile;
+        return profile;
+    }
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/HookProfiler-inl.hpp>
+#endif
@@ -2,6 +2,7 @@
 
 #include <RED4ext/Detail/WinCompat.hpp>
 #include <cstdint>
+#include <type_traits>
 
 #include <RED4ext/Common.hpp>
 
@@ -14,6 +15,15 @@ struct EngineAllocator;
 
 struct BaseStream
 {
+    /**
+     * @brief The mode bits in `flags`, the game's serializers check them to tell loading from saving.
+     */
+    enum Flags : int32_t
+    {
+        Reading = 1 << 0,
+        Writing = 1 << 1
+    };
+
     BaseStream(int32_t aFlags = 0);
 
     virtual Memory::EngineAllocator* GetAllocator(); // 00
@@ -33,6 +43,28 @@ struct BaseStream
         return ReadWrite(aBuffer, sizeof(T));
     }
 
+    /**
+     * @brief Reads or writes a contiguous range of trivially copyable values with a single virtual call.
+     * @param aBuffer The values.
+     * @param aCount The number of values.
+     */
+    template<typename T>
+    inline void* ReadWriteSpan(T* aBuffer, uint32_t aCount)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        return ReadWrite(aBuffer, static_cast<uint32_t>(sizeof(T) * aCount));
+    }
+
+    inline bool IsReading() const
+    {
+        return (flags & Flags::Reading) != 0;
+    }
+
+    inline bool IsWriting() const
+    {
+        return (flags & Flags::Writing) != 0;
+    }
+
     int32_t flags; // 08
     int32_t unkC;  // 0C
     int64_t unk10; // 10
@@ -0,0 +1,188 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/IO/BufferedWriteStream.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+RED4EXT_INLINE RED4ext::BufferedWriteStream::BufferedWriteStream(BaseStream& aTarget, size_t aCapacity)
+    : BaseStream(Flags::Writing)
+    , m_target(&aTarget)
+    , m_file(nullptr)
+    , m_buffer(new uint8_t[aCapacity])
+    , m_capacity(aCapacity)
+    , m_used(0)
+    , m_flushed(0)
+    , m_hasError(false)
+{
+}
+
+RED4EXT_INLINE RED4ext::BufferedWriteStream::BufferedWriteStream(const std::filesystem::path& aPath,
+                                                                 size_t aCapacity)
+    : BaseStream(Flags::Writing)
+    , m_target(nullptr)
+    , m_file(nullptr)
+    , m_buffer(new uint8_t[aCapacity])
+    , m_capacity(aCapacity)
+    , m_used(0)
+    , m_flushed(0)
+    , m_hasError(false)
+    , m_fileName(aPath.string())
+{
+#if defined(_WIN32) || defined(_WIN64)
+    m_file = _wfopen(aPath.c_str(), L"wb");
+#else
+    m_file = std::fopen(aPath.c_str(), "wb");
+#endif
+
+    if (m_file)
+    {
+        // The stream does its own buffering.
+        std::setvbuf(m_file, nullptr, _IONBF, 0);
+    }
+    else
+    {
+        m_hasError = true;
+    }
+}
+
+RED4EXT_INLINE RED4ext::BufferedWriteStream::~BufferedWriteStream()
+{
+    Flush();
+
+    if (m_file)
+    {
+        std::fclose(m_file);
+    }
+}
+
+RED4EXT_INLINE void* RED4ext::BufferedWriteStream::ReadWrite(void* aBuffer, uint32_t aLength)
+{
+    if (m_hasError)
+    {
+        return nullptr;
+    }
+
+    if (m_used + aLength > m_capacity)
+    {
+        // Only hand the buffer to the target, flushing the target to the disk is left to Flush() and the destructor.
+        if (!WriteBuffer())
+        {
+            return nullptr;
+        }
+
+        // Large writes go straight to the target, copying them into the buffer first gains nothing.
+        if (aLength >= m_capacity)
+        {
+            return WriteToTarget(aBuffer, aLength) ? aBuffer : nullptr;
+        }
+    }
+
+    std::memcpy(m_buffer.get() + m_used, aBuffer, aLength);
+    m_used += aLength;
+
+    return aBuffer;
+}
+
+RED4EXT_INLINE size_t RED4ext::BufferedWriteStream::GetPointerPosition()
+{
+    return m_flushed + m_used;
+}
+
+RED4EXT_INLINE size_t RED4ext::BufferedWriteStream::GetLength()
+{
+    return m_flushed + m_used;
+}
+
+RED4EXT_INLINE bool RED4ext::BufferedWriteStream::Seek(size_t aDistance)
+{
+    // Only "seeking" to the current position is supported, the stream is append-only.
+    return aDistance == GetPointerPosition();
+}
+
+RED4EXT_INLINE bool RED4ext::BufferedWriteStream::Flush()
+{
+    if (!WriteBuffer())
+    {
+        return false;
+    }
+
+    if (m_target)
+    {
+        return m_target->Flush();
+    }
+
+    return m_file && std::fflush(m_file) == 0;
+}
+
+RED4EXT_INLINE const char* RED4ext::BufferedWriteStream::GetFileName()
+{
+    if (m_target)
+    {
+        return m_target->GetFileName();
+    }
+
+    return m_fileName.c_str();
+}
+
+RED4EXT_INLINE bool RED4ext::BufferedWriteStream::IsOpen() const
+{
+    return m_target || m_file;
+}
+
+RED4EXT_INLINE bool RED4ext::BufferedWriteStream::HasError() const
+{
+    return m_hasError;
+}
+
+RED4EXT_INLINE bool RED4ext::BufferedWriteStream::WriteBuffer()
+{
+    if (m_hasError)
+    {
+        return false;
+    }
+
+    if (m_used == 0)
+    {
+        return true;
+    }
+
+    auto isWritten = WriteToTarget(m_buffer.get(), m_used);
+    m_used = 0;
+
+    return isWritten;
+}
+
+RED4EXT_INLINE bool RED4ext::BufferedWriteStream::WriteToTarget(const void* aData, size_t aLength)
+{
+    auto data = static_cast<const uint8_t*>(aData);
+    auto remaining = aLength;
+
+    while (remaining != 0 && !m_hasError)
+    {
+        // BaseStream takes 32-bit lengths.
+        auto length = static_cast<uint32_t>((std::min)(remaining, static_cast<size_t>(UINT32_MAX)));
+
+        if (m_target)
+        {
+            // The return value of ReadWrite is not meaningful for every stream, assume the write succeeded.
+            m_target->ReadWrite(const_cast<uint8_t*>(data), length);
+        }
+        else
+        {
+            m_hasError = !m_file || std::fwrite(data, 1, length, m_file) != length;
+        }
+
+        data += length;
+        remaining -= length;
+    }
+
+    if (!m_hasError)
+    {
+        m_flushed += aLength;
+    }
+
+    return !m_hasError;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/IO/BaseStream.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief A write-only stream that combines small writes into a large buffer.
+ *
+ * The buffer is written to the target (another stream or a file) only when it is full or when Flush() is called, so
+ * many small writes turn into a few large ones. Writes larger than the buffer bypass it. The target itself is only
+ * flushed by Flush() and the destructor, a full buffer is written through without forcing the target to the disk.
+ */
+class BufferedWriteStream : public BaseStream
+{
+public:
+    static constexpr size_t DefaultCapacity = 1024 * 1024;
+
+    BufferedWriteStream(BaseStream& aTarget, size_t aCapacity = DefaultCapacity);
+    BufferedWriteStream(const std::filesystem::path& aPath, size_t aCapacity = DefaultCapacity);
+    BufferedWriteStream(const BufferedWriteStream&) = delete;
+    BufferedWriteStream& operator=(const BufferedWriteStream&) = delete;
+    ~BufferedWriteStream() override;
+
+    void* ReadWrite(void* aBuffer, uint32_t aLength) override;
+    size_t GetPointerPosition() override;
+    size_t GetLength() override;
+    bool Seek(size_t aDistance) override;
+    bool Flush() override;
+    const char* GetFileName() override;
+
+    bool IsOpen() const;
+    bool HasError() const;
+
+private:
+    bool WriteBuffer();
+    bool WriteToTarget(const void* aData, size_t aLength);
+
+    BaseStream* m_target;
+    std::FILE* m_file;
+    std::unique_ptr<uint8_t[]> m_buffer;
+    size_t m_capacity;
+    size_t m_used;
+    size_t m_flushed; // Number of bytes already written to the target.
+    bool m_hasError;
+    std::string m_fileName;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/IO/BufferedWriteStream-inl.hpp>
+#endif
@@ -0,0 +1,213 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/IO/MappedFileStream.hpp>
+#endif
+
+#include <cstring>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+RED4EXT_INLINE RED4ext::MappedFileStream::MappedFileStream()
+    : BaseStream(Flags::Reading)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_position(0)
+    , m_hasError(false)
+{
+}
+
+RED4EXT_INLINE RED4ext::MappedFileStream::MappedFileStream(const std::filesystem::path& aPath)
+    : MappedFileStream()
+{
+    Open(aPath);
+}
+
+RED4EXT_INLINE RED4ext::MappedFileStream::~MappedFileStream()
+{
+    Close();
+}
+
+RED4EXT_INLINE bool RED4ext::MappedFileStream::Open(const std::filesystem::path& aPath)
+{
+    Close();
+
+#if defined(_WIN32) || defined(_WIN64)
+    auto file = CreateFileW(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    auto size = static_cast<size_t>(fileSize.QuadPart);
+    void* data = nullptr;
+    if (size != 0)
+    {
+        auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+        // The view keeps the mapping and the file alive.
+        CloseHandle(mapping);
+        if (!data)
+        {
+            CloseHandle(file);
+            return false;
+        }
+    }
+
+    CloseHandle(file);
+#else
+    auto fd = open(aPath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    auto size = static_cast<size_t>(info.st_size);
+    void* data = nullptr;
+    if (size != 0)
+    {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+
+        // Most reads are sequential.
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    // The mapping keeps the file alive.
+    close(fd);
+#endif
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = size;
+    m_position = 0;
+    m_hasError = false;
+    m_fileName = aPath.string();
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::MappedFileStream::Close()
+{
+    if (m_data)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+    m_fileName.clear();
+}
+
+RED4EXT_INLINE bool RED4ext::MappedFileStream::IsOpen() const
+{
+    return !m_fileName.empty();
+}
+
+RED4EXT_INLINE void* RED4ext::MappedFileStream::ReadWrite(void* aBuffer, uint32_t aLength)
+{
+    auto data = Peek(aLength);
+    if (!data)
+    {
+        m_hasError = true;
+        return nullptr;
+    }
+
+    std::memcpy(aBuffer, data, aLength);
+    m_position += aLength;
+
+    return aBuffer;
+}
+
+RED4EXT_INLINE size_t RED4ext::MappedFileStream::GetPointerPosition()
+{
+    return m_position;
+}
+
+RED4EXT_INLINE size_t RED4ext::MappedFileStream::GetLength()
+{
+    return m_size;
+}
+
+RED4EXT_INLINE bool RED4ext::MappedFileStream::Seek(size_t aDistance)
+{
+    if (aDistance > m_size)
+    {
+        return false;
+    }
+
+    m_position = aDistance;
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::MappedFileStream::Flush()
+{
+    return true;
+}
+
+RED4EXT_INLINE const char* RED4ext::MappedFileStream::GetFileName()
+{
+    return m_fileName.empty() ? BaseStream::GetFileName() : m_fileName.c_str();
+}
+
+RED4EXT_INLINE const uint8_t* RED4ext::MappedFileStream::Peek(size_t aLength) const
+{
+    if (aLength > m_size - m_position)
+    {
+        return nullptr;
+    }
+
+    return m_data + m_position;
+}
+
+RED4EXT_INLINE const uint8_t* RED4ext::MappedFileStream::GetData() const
+{
+    return m_data;
+}
+
+RED4EXT_INLINE bool RED4ext::MappedFileStream::HasError() const
+{
+    return m_hasError;
+}
+
+RED4EXT_INLINE size_t RED4ext::MappedFileStream::GetRemaining() const
+{
+    return m_size - m_position;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/IO/BaseStream.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief A read-only stream over a file mapped into memory.
+ *
+ * Reads are plain memory copies, Peek() and ReadSpan() give direct access to the mapping without copying.
+ */
+class MappedFileStream : public BaseStream
+{
+public:
+    MappedFileStream();
+    explicit MappedFileStream(const std::filesystem::path& aPath);
+    MappedFileStream(const MappedFileStream&) = delete;
+    MappedFileStream& operator=(const MappedFileStream&) = delete;
+    ~MappedFileStream() override;
+
+    bool Open(const std::filesystem::path& aPath);
+    void Close();
+    bool IsOpen() const;
+
+    void* ReadWrite(void* aBuffer, uint32_t aLength) override;
+    size_t GetPointerPosition() override;
+    size_t GetLength() override;
+    bool Seek(size_t aDistance) override;
+    bool Flush() override;
+    const char* GetFileName() override;
+
+    /**
+     * @brief Returns a pointer to the next bytes without advancing the stream.
+     * @param aLength The number of bytes that must be available.
+     * @return The pointer into the mapping, or nullptr if there are not enough bytes left.
+     */
+    const uint8_t* Peek(size_t aLength) const;
+
+    /**
+     * @brief Returns a view to the next values and advances the stream, nothing is copied.
+     * @param aCount The number of values.
+     * @return The values, or an empty span if there are not enough bytes left. The values might be unaligned.
+     */
+    template<typename T>
+    Span<const T> ReadSpan(uint32_t aCount)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        auto length = sizeof(T) * aCount;
+        auto data = Peek(length);
+        if (!data)
+        {
+            m_hasError = true;
+            return {};
+        }
+
+        m_position += length;
+        return {reinterpret_cast<const T*>(data), aCount};
+    }
+
+    const uint8_t* GetData() const;
+    bool HasError() const;
+    size_t GetRemaining() const;
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_position;
+    bool m_hasError;
+    std::string m_fileName;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/IO/MappedFileStream-inl.hpp>
+#endif
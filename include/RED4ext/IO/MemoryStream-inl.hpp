@@ -0,0 +1,170 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/IO/MemoryStream.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#include <RED4ext/Buffer.hpp>
+
+RED4EXT_INLINE RED4ext::MemoryStream::MemoryStream(const void* aData, size_t aSize)
+    : BaseStream(Flags::Reading)
+    , m_data(static_cast<uint8_t*>(const_cast<void*>(aData)))
+    , m_length(aSize)
+    , m_capacity(aSize)
+    , m_position(0)
+    , m_buffer(nullptr)
+    , m_hasError(false)
+{
+}
+
+RED4EXT_INLINE RED4ext::MemoryStream::MemoryStream(RawBuffer& aBuffer, bool aIsWriting)
+    : BaseStream(aIsWriting ? Flags::Writing : Flags::Reading)
+    , m_data(static_cast<uint8_t*>(aBuffer.data))
+    , m_length(aIsWriting ? 0 : aBuffer.size)
+    , m_capacity(aBuffer.size)
+    , m_position(0)
+    , m_buffer(&aBuffer)
+    , m_hasError(false)
+{
+}
+
+RED4EXT_INLINE RED4ext::MemoryStream::MemoryStream(DataBuffer& aBuffer, bool aIsWriting)
+    : MemoryStream(aBuffer.buffer, aIsWriting)
+{
+}
+
+RED4EXT_INLINE void* RED4ext::MemoryStream::ReadWrite(void* aBuffer, uint32_t aLength)
+{
+    if (IsWriting())
+    {
+        auto end = m_position + aLength;
+        if (end > m_capacity && !Reserve(end))
+        {
+            m_hasError = true;
+            return nullptr;
+        }
+
+        std::memcpy(m_data + m_position, aBuffer, aLength);
+        m_position = end;
+        m_length = (std::max)(m_length, end);
+
+        return aBuffer;
+    }
+
+    auto data = Peek(aLength);
+    if (!data)
+    {
+        m_hasError = true;
+        return nullptr;
+    }
+
+    std::memcpy(aBuffer, data, aLength);
+    m_position += aLength;
+
+    return aBuffer;
+}
+
+RED4EXT_INLINE size_t RED4ext::MemoryStream::GetPointerPosition()
+{
+    return m_position;
+}
+
+RED4EXT_INLINE size_t RED4ext::MemoryStream::GetLength()
+{
+    return m_length;
+}
+
+RED4EXT_INLINE bool RED4ext::MemoryStream::Seek(size_t aDistance)
+{
+    if (aDistance > m_length)
+    {
+        return false;
+    }
+
+    m_position = aDistance;
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::MemoryStream::Flush()
+{
+    if (!IsWriting() || !m_buffer || m_capacity == m_length || m_length == 0)
+    {
+        return true;
+    }
+
+    m_buffer->Resize(static_cast<uint32_t>(m_length));
+    if (m_buffer->size != m_length)
+    {
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(m_buffer->data);
+    m_capacity = m_length;
+
+    return true;
+}
+
+RED4EXT_INLINE const char* RED4ext::MemoryStream::GetFileName()
+{
+    return "<memory>";
+}
+
+RED4EXT_INLINE const uint8_t* RED4ext::MemoryStream::Peek(size_t aLength) const
+{
+    if (aLength > m_length - m_position)
+    {
+        return nullptr;
+    }
+
+    return m_data + m_position;
+}
+
+RED4EXT_INLINE bool RED4ext::MemoryStream::HasError() const
+{
+    return m_hasError;
+}
+
+RED4EXT_INLINE size_t RED4ext::MemoryStream::GetRemaining() const
+{
+    return m_length - m_position;
+}
+
+RED4EXT_INLINE bool RED4ext::MemoryStream::Reserve(size_t aCapacity)
+{
+    // RawBuffer stores its size as 32 bits.
+    if (!m_buffer || aCapacity > UINT32_MAX)
+    {
+        return false;
+    }
+
+    auto capacity = (std::max)(aCapacity, m_capacity + (m_capacity / 2));
+    capacity = (std::min)(capacity, static_cast<size_t>(UINT32_MAX));
+
+    if (m_buffer->data)
+    {
+        // Buffers that wrap external memory do not have an allocator and can not grow.
+        if (!m_buffer->GetAllocator())
+        {
+            return false;
+        }
+
+        m_buffer->Resize(static_cast<uint32_t>(capacity));
+    }
+    else
+    {
+        m_buffer->Initialize(nullptr, static_cast<uint32_t>(capacity));
+    }
+
+    if (!m_buffer->data || m_buffer->size < aCapacity)
+    {
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(m_buffer->data);
+    m_capacity = m_buffer->size;
+
+    return true;
+}
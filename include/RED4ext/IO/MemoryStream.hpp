@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/IO/BaseStream.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+struct RawBuffer;
+struct DataBuffer;
+
+/**
+ * @brief A stream over a block of memory.
+ *
+ * The stream either reads from the memory or writes into it. When writing into a RawBuffer the buffer grows
+ * geometrically as needed, call Flush() to trim it to the written length.
+ */
+class MemoryStream : public BaseStream
+{
+public:
+    MemoryStream(const void* aData, size_t aSize);
+    MemoryStream(RawBuffer& aBuffer, bool aIsWriting = false);
+    MemoryStream(DataBuffer& aBuffer, bool aIsWriting = false);
+    ~MemoryStream() override = default;
+
+    void* ReadWrite(void* aBuffer, uint32_t aLength) override;
+    size_t GetPointerPosition() override;
+    size_t GetLength() override;
+    bool Seek(size_t aDistance) override;
+    bool Flush() override;
+    const char* GetFileName() override;
+
+    /**
+     * @brief Returns a pointer to the next bytes without advancing the stream.
+     * @param aLength The number of bytes that must be available.
+     * @return The pointer, or nullptr if there are not enough bytes left.
+     */
+    const uint8_t* Peek(size_t aLength) const;
+
+    /**
+     * @brief Returns a view to the next values and advances the stream, nothing is copied.
+     * @param aCount The number of values.
+     * @return The values, or an empty span if there are not enough bytes left. The values might be unaligned.
+     */
+    template<typename T>
+    Span<const T> ReadSpan(uint32_t aCount)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+        auto length = sizeof(T) * aCount;
+        auto data = IsWriting() ? nullptr : Peek(length);
+        if (!data)
+        {
+            m_hasError = true;
+            return {};
+        }
+
+        m_position += length;
+        return {reinterpret_cast<const T*>(data), aCount};
+    }
+
+    bool HasError() const;
+    size_t GetRemaining() const;
+
+private:
+    bool Reserve(size_t aCapacity);
+
+    uint8_t* m_data;
+    size_t m_length;
+    size_t m_capacity;
+    size_t m_position;
+    RawBuffer* m_buffer; // Only set when the stream can grow the memory.
+    bool m_hasError;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/IO/MemoryStream-inl.hpp>
+#endif
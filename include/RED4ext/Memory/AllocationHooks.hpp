@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace RED4ext::Memory
+{
+struct PoolInfo;
+
+/**
+ * @brief The functions Allocator<T> calls after every allocation, reallocation and before every free.
+ *
+ * Installed by AllocationTracker::Enable(). Allocator<T> only calls them when RED4EXT_ALLOCATION_TRACKING is defined,
+ * without it the allocators are the same as the game's and installing hooks has no effect.
+ */
+struct AllocationHooks
+{
+    using Alloc_t = void (*)(const PoolInfo* aPool, void* aMemory, uint64_t aSize, void* aSite) noexcept;
+    using Realloc_t = void (*)(const PoolInfo* aPool, void* aOldMemory, void* aMemory, uint64_t aSize,
+                               void* aSite) noexcept;
+    using Free_t = void (*)(const PoolInfo* aPool, void* aMemory, void* aSite) noexcept;
+
+    Alloc_t onAlloc;
+    Realloc_t onRealloc;
+    Free_t onFree;
+
+    /**
+     * @brief Returns the installed hooks, or nullptr while nothing is tracked.
+     */
+    [[nodiscard]] static const AllocationHooks* Get() noexcept
+    {
+        // Every allocator call checks this, only the calls that find hooks pay for the ordering.
+        auto hooks = GetInstalled().load(std::memory_order_relaxed);
+        if (hooks)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+
+        return hooks;
+    }
+
+    /**
+     * @brief Installs the hooks, nullptr removes them. The hooks must outlive every allocator call.
+     */
+    static void Set(const AllocationHooks* aHooks) noexcept
+    {
+        GetInstalled().store(aHooks, std::memory_order_release);
+    }
+
+private:
+    static std::atomic<const AllocationHooks*>& GetInstalled() noexcept
+    {
+        static std::atomic<const AllocationHooks*> hooks{nullptr};
+        return hooks;
+    }
+};
+} // namespace RED4ext::Memory
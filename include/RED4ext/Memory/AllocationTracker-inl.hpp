@@ -0,0 +1,545 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/Memory/AllocationTracker.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+struct RED4ext::Memory::AllocationTracker::State
+{
+    static constexpr uintptr_t Empty = 0;
+    static constexpr uintptr_t Reserved = 1; // A sample is being written.
+    static constexpr uintptr_t Removed = 2;  // The sample was freed, the slot can be reused.
+    static constexpr uint32_t MaxProbes = 64;
+
+    std::atomic<uint32_t> sampleRate;
+    std::atomic<uint32_t> liveSamples;
+    std::atomic<uint64_t> untrackedCalls;
+    std::atomic<uint64_t> droppedSamples;
+
+    Site sites[MaxSites];
+    Sample samples[MaxSamples];
+
+    // Guards the reported values of the sites and the pools.
+    std::mutex lock;
+    std::unordered_map<const PoolInfo*, uint64_t> reportedPoolBytes;
+};
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::Enable(uint32_t aSampleRate)
+{
+    static std::mutex lock;
+
+    {
+        std::lock_guard<std::mutex> _(lock);
+
+        // Never freed, other threads might still be recording when tracking is disabled.
+        auto& state = GetState();
+        if (!state.load(std::memory_order_acquire))
+        {
+            state.store(new State(), std::memory_order_release);
+        }
+    }
+
+    SetSampleRate(aSampleRate);
+    AllocationHooks::Set(&GetHooks());
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::Disable() noexcept
+{
+    AllocationHooks::Set(nullptr);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::SetSampleRate(uint32_t aSampleRate) noexcept
+{
+    if (auto state = GetState().load(std::memory_order_acquire))
+    {
+        state->sampleRate.store(aSampleRate, std::memory_order_relaxed);
+    }
+}
+
+RED4EXT_INLINE uint32_t RED4ext::Memory::AllocationTracker::GetSampleRate() noexcept
+{
+    auto state = GetState().load(std::memory_order_acquire);
+    return state ? state->sampleRate.load(std::memory_order_relaxed) : 0;
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationSnapshot RED4ext::Memory::AllocationTracker::Snapshot()
+{
+    AllocationSnapshot result;
+
+    auto state = GetState().load(std::memory_order_acquire);
+    if (!state)
+    {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> _(state->lock);
+
+    result.untrackedCalls = state->untrackedCalls.load(std::memory_order_relaxed);
+    result.droppedSamples = state->droppedSamples.load(std::memory_order_relaxed);
+
+    std::unordered_map<const PoolInfo*, AllocationPoolStats> pools;
+
+    for (auto& site : state->sites)
+    {
+        auto pool = site.pool.load(std::memory_order_acquire);
+        if (!pool)
+        {
+            continue;
+        }
+
+        auto allocations = site.allocations.load(std::memory_order_relaxed);
+        auto bytes = site.bytes.load(std::memory_order_relaxed);
+        auto frees = site.frees.load(std::memory_order_relaxed);
+
+        AllocationSiteStats stats;
+        stats.pool = pool;
+        stats.site = site.address.load(std::memory_order_relaxed);
+        stats.allocations = allocations - site.reportedAllocations;
+        stats.bytes = bytes - site.reportedBytes;
+        stats.frees = frees - site.reportedFrees;
+
+        site.reportedAllocations = allocations;
+        site.reportedBytes = bytes;
+        site.reportedFrees = frees;
+
+        auto& poolStats = pools[pool];
+        poolStats.pool = pool;
+        poolStats.allocations += stats.allocations;
+        poolStats.bytes += stats.bytes;
+        poolStats.frees += stats.frees;
+
+        if (stats.allocations || stats.frees)
+        {
+            result.sites.push_back(stats);
+        }
+    }
+
+    const auto sampleRate = (std::max)(state->sampleRate.load(std::memory_order_relaxed), 1u);
+    for (auto& sample : state->samples)
+    {
+        if (sample.memory.load(std::memory_order_acquire) <= State::Removed)
+        {
+            continue;
+        }
+
+        auto it = pools.find(sample.pool.load(std::memory_order_relaxed));
+        if (it != pools.end())
+        {
+            it->second.sampledLiveBytes += sample.size.load(std::memory_order_relaxed) * sampleRate;
+        }
+    }
+
+    result.pools.reserve(pools.size());
+    for (auto& [pool, stats] : pools)
+    {
+        if (pool->storage)
+        {
+            auto storage = pool->storage;
+            stats.poolBytes = std::atomic_ref<uint64_t>(storage->bytesAllocated).load(std::memory_order_relaxed);
+            stats.poolMaxBytes = std::atomic_ref<uint64_t>(storage->maxBytesAllocated).load(std::memory_order_relaxed);
+
+            // The first snapshot of a pool has nothing to compare with.
+            auto [it, isNew] = state->reportedPoolBytes.try_emplace(pool, stats.poolBytes);
+            stats.poolBytesDelta = isNew ? 0 : static_cast<int64_t>(stats.poolBytes - it->second);
+            it->second = stats.poolBytes;
+        }
+
+        result.pools.push_back(stats);
+    }
+
+    std::sort(result.pools.begin(), result.pools.end(),
+              [](const AllocationPoolStats& aLhs, const AllocationPoolStats& aRhs) { return aLhs.bytes > aRhs.bytes; });
+    std::sort(result.sites.begin(), result.sites.end(),
+              [](const AllocationSiteStats& aLhs, const AllocationSiteStats& aRhs) { return aLhs.bytes > aRhs.bytes; });
+
+    return result;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::Dump(const AllocationSnapshot& aSnapshot, std::ostream& aOut)
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-32s %10s %14s %10s %14s %14s %14s %14s\n", "pool", "allocs", "bytes", "frees",
+                  "sampled live", "pool bytes", "pool delta", "pool max");
+    aOut << line;
+
+    for (const auto& entry : aSnapshot.pools)
+    {
+        std::snprintf(line, sizeof(line), "%-32.32s %10llu %14llu %10llu %14llu %14llu %14lld %14llu\n",
+                      entry.pool->name, static_cast<unsigned long long>(entry.allocations),
+                      static_cast<unsigned long long>(entry.bytes), static_cast<unsigned long long>(entry.frees),
+                      static_cast<unsigned long long>(entry.sampledLiveBytes),
+                      static_cast<unsigned long long>(entry.poolBytes), static_cast<long long>(entry.poolBytesDelta),
+                      static_cast<unsigned long long>(entry.poolMaxBytes));
+        aOut << line;
+    }
+
+    std::snprintf(line, sizeof(line), "\n%-32s %-40s %10s %14s %10s\n", "pool", "site", "allocs", "bytes", "frees");
+    aOut << line;
+
+    for (const auto& entry : aSnapshot.sites)
+    {
+        std::snprintf(line, sizeof(line), "%-32.32s ", entry.pool->name);
+        aOut << line;
+
+        WriteAddress(aOut, entry.site);
+
+        std::snprintf(line, sizeof(line), " %10llu %14llu %10llu\n", static_cast<unsigned long long>(entry.allocations),
+                      static_cast<unsigned long long>(entry.bytes), static_cast<unsigned long long>(entry.frees));
+        aOut << line;
+    }
+
+    if (aSnapshot.untrackedCalls || aSnapshot.droppedSamples)
+    {
+        std::snprintf(line, sizeof(line), "\n%llu calls were not tracked, %llu samples were dropped\n",
+                      static_cast<unsigned long long>(aSnapshot.untrackedCalls),
+                      static_cast<unsigned long long>(aSnapshot.droppedSamples));
+        aOut << line;
+    }
+}
+
+RED4EXT_INLINE uint32_t RED4ext::Memory::AllocationTracker::ReportLeaks(std::ostream& aOut)
+{
+    auto state = GetState().load(std::memory_order_acquire);
+    if (!state)
+    {
+        return 0;
+    }
+
+    struct Leak
+    {
+        const Sample* sample;
+        uint32_t count;
+        uint64_t bytes;
+    };
+
+    // Samples with the same pool and call stack are reported together.
+    std::unordered_map<uint64_t, Leak> leaks;
+    uint32_t total = 0;
+
+    for (const auto& sample : state->samples)
+    {
+        if (sample.memory.load(std::memory_order_acquire) <= State::Removed)
+        {
+            continue;
+        }
+
+        auto key = reinterpret_cast<uintptr_t>(sample.pool.load(std::memory_order_relaxed)) * 0x9E3779B97F4A7C15ull;
+        for (uint32_t i = 0; i < sample.frameCount; ++i)
+        {
+            key = (key ^ reinterpret_cast<uintptr_t>(sample.frames[i])) * 0x100000001B3ull;
+        }
+
+        auto& leak = leaks.try_emplace(key, Leak{&sample, 0, 0}).first->second;
+        ++leak.count;
+        leak.bytes += sample.size.load(std::memory_order_relaxed);
+
+        ++total;
+    }
+
+    std::vector<Leak> sorted;
+    sorted.reserve(leaks.size());
+    for (const auto& [key, leak] : leaks)
+    {
+        sorted.push_back(leak);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const Leak& aLhs, const Leak& aRhs) { return aLhs.bytes > aRhs.bytes; });
+
+    const auto sampleRate = (std::max)(state->sampleRate.load(std::memory_order_relaxed), 1u);
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%u sampled allocations were not freed, about %llu allocations in total\n", total,
+                  static_cast<unsigned long long>(total) * sampleRate);
+    aOut << line;
+
+    for (const auto& leak : sorted)
+    {
+        std::snprintf(line, sizeof(line), "\n%.32s: %u sampled, %llu bytes, about %llu bytes in total\n",
+                      leak.sample->pool.load(std::memory_order_relaxed)->name, leak.count,
+                      static_cast<unsigned long long>(leak.bytes),
+                      static_cast<unsigned long long>(leak.bytes) * sampleRate);
+        aOut << line;
+
+        for (uint32_t i = 0; i < leak.sample->frameCount; ++i)
+        {
+            aOut << "    ";
+            WriteAddress(aOut, reinterpret_cast<uintptr_t>(leak.sample->frames[i]));
+            aOut << "\n";
+        }
+
+        if (leak.sample->frameCount == 0)
+        {
+            aOut << "    ";
+            WriteAddress(aOut, leak.sample->site);
+            aOut << "\n";
+        }
+    }
+
+    return total;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::OnAlloc(const PoolInfo* aPool, void* aMemory, uint64_t aSize,
+                                                               void* aSite) noexcept
+{
+    auto state = GetState().load(std::memory_order_relaxed);
+    if (!state || !aMemory)
+    {
+        return;
+    }
+
+    if (auto site = FindSite(aPool, aSite))
+    {
+        site->allocations.fetch_add(1, std::memory_order_relaxed);
+        site->bytes.fetch_add(aSize, std::memory_order_relaxed);
+    }
+
+    if (ShouldSample(state->sampleRate.load(std::memory_order_relaxed)))
+    {
+        AddSample(aPool, aMemory, aSize, aSite);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::OnRealloc(const PoolInfo* aPool, void* aOldMemory,
+                                                                 void* aMemory, uint64_t aSize, void* aSite) noexcept
+{
+    // The new memory can be the old one, forget it before it might be sampled again.
+    OnFree(aPool, aOldMemory, aSite);
+    OnAlloc(aPool, aMemory, aSize, aSite);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::OnFree(const PoolInfo* aPool, void* aMemory,
+                                                              void* aSite) noexcept
+{
+    auto state = GetState().load(std::memory_order_relaxed);
+    if (!state || !aMemory)
+    {
+        return;
+    }
+
+    if (auto site = FindSite(aPool, aSite))
+    {
+        site->frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (state->liveSamples.load(std::memory_order_relaxed))
+    {
+        RemoveSample(aMemory);
+    }
+}
+
+RED4EXT_INLINE std::atomic<RED4ext::Memory::AllocationTracker::State*>& RED4ext::Memory::AllocationTracker::
+    GetState() noexcept
+{
+    static std::atomic<State*> state{nullptr};
+    return state;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::Memory::AllocationTracker::GetNextInterval(uint32_t aSampleRate) noexcept
+{
+    // A random interval with the sample rate as mean, fixed intervals would only ever see every Nth allocation of a
+    // loop.
+    static thread_local uint64_t random = reinterpret_cast<uintptr_t>(&random) | 1;
+
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+
+    return 1 + static_cast<uint32_t>(random % (uint64_t{aSampleRate} * 2 - 1));
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationTracker::Site* RED4ext::Memory::AllocationTracker::FindSite(
+    const PoolInfo* aPool, void* aSite) noexcept
+{
+    auto state = GetState().load(std::memory_order_relaxed);
+
+    auto key = (reinterpret_cast<uintptr_t>(aSite) * 0x9E3779B97F4A7C15ull) ^ reinterpret_cast<uintptr_t>(aPool);
+    key ^= key >> 31;
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 29;
+    key = key ? key : 1;
+
+    auto index = static_cast<uint32_t>(key >> 32);
+    for (uint32_t probe = 0; probe < MaxSites; ++probe)
+    {
+        auto& site = state->sites[(index + probe) & (MaxSites - 1)];
+
+        auto current = site.key.load(std::memory_order_acquire);
+        if (current == 0)
+        {
+            if (site.key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+            {
+                // Published last, snapshots skip the site until then.
+                site.address.store(reinterpret_cast<uintptr_t>(aSite), std::memory_order_relaxed);
+                site.pool.store(aPool, std::memory_order_release);
+                return &site;
+            }
+        }
+
+        if (current == key)
+        {
+            return &site;
+        }
+    }
+
+    state->untrackedCalls.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+RED4EXT_INLINE bool RED4ext::Memory::AllocationTracker::ShouldSample(uint32_t aSampleRate) noexcept
+{
+    static thread_local uint32_t countdown = 0;
+
+    if (aSampleRate == 0)
+    {
+        return false;
+    }
+
+    if (countdown == 0)
+    {
+        countdown = GetNextInterval(aSampleRate);
+    }
+
+    if (--countdown != 0)
+    {
+        return false;
+    }
+
+    countdown = GetNextInterval(aSampleRate);
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::AddSample(const PoolInfo* aPool, void* aMemory,
+                                                                 uint64_t aSize, void* aSite) noexcept
+{
+    auto state = GetState().load(std::memory_order_relaxed);
+
+    auto index = static_cast<uint32_t>((reinterpret_cast<uintptr_t>(aMemory) >> 4) * 0x9E3779B97F4A7C15ull >> 40);
+    for (uint32_t probe = 0; probe < State::MaxProbes; ++probe)
+    {
+        auto& sample = state->samples[(index + probe) & (MaxSamples - 1)];
+
+        auto current = sample.memory.load(std::memory_order_relaxed);
+        if (current != State::Empty && current != State::Removed)
+        {
+            continue;
+        }
+
+        if (!sample.memory.compare_exchange_strong(current, State::Reserved, std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        sample.pool.store(aPool, std::memory_order_relaxed);
+        sample.size.store(aSize, std::memory_order_relaxed);
+        sample.site = reinterpret_cast<uintptr_t>(aSite);
+        sample.frameCount = CaptureStack(sample.frames, aSite);
+
+        // Counted before it is published, a free that finds the sample must not see zero live samples.
+        state->liveSamples.fetch_add(1, std::memory_order_relaxed);
+        sample.memory.store(reinterpret_cast<uintptr_t>(aMemory), std::memory_order_release);
+        return;
+    }
+
+    state->droppedSamples.fetch_add(1, std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::RemoveSample(void* aMemory) noexcept
+{
+    auto state = GetState().load(std::memory_order_relaxed);
+
+    auto memory = reinterpret_cast<uintptr_t>(aMemory);
+    auto index = static_cast<uint32_t>((memory >> 4) * 0x9E3779B97F4A7C15ull >> 40);
+
+    for (uint32_t probe = 0; probe < State::MaxProbes; ++probe)
+    {
+        auto& sample = state->samples[(index + probe) & (MaxSamples - 1)];
+
+        auto current = sample.memory.load(std::memory_order_relaxed);
+        if (current == State::Empty)
+        {
+            return;
+        }
+
+        if (current == memory && sample.memory.compare_exchange_strong(current, State::Removed,
+                                                                       std::memory_order_relaxed))
+        {
+            state->liveSamples.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+RED4EXT_INLINE uint32_t RED4ext::Memory::AllocationTracker::CaptureStack(void** aFrames, void* aSite) noexcept
+{
+    constexpr uint32_t maxSkippedFrames = 8;
+    void* frames[MaxFrames + maxSkippedFrames];
+
+#if defined(_WIN32) || defined(_WIN64)
+    auto count = static_cast<uint32_t>(RtlCaptureStackBackTrace(0, MaxFrames + maxSkippedFrames, frames, nullptr));
+#else
+    auto count = static_cast<uint32_t>((std::max)(backtrace(frames, MaxFrames + maxSkippedFrames), 0));
+#endif
+
+    // Start at the call site, the frames before it belong to the tracker and the allocator.
+    uint32_t first = 0;
+    for (uint32_t i = 0; i < count && i < maxSkippedFrames; ++i)
+    {
+        if (frames[i] == aSite)
+        {
+            first = i;
+            break;
+        }
+    }
+
+    count = (std::min)(count - first, MaxFrames);
+    std::copy_n(frames + first, count, aFrames);
+
+    return count;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::AllocationTracker::WriteAddress(std::ostream& aOut, uintptr_t aAddress)
+{
+    char text[128];
+
+#if defined(_WIN32) || defined(_WIN64)
+    HMODULE module = nullptr;
+    char path[MAX_PATH];
+
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           reinterpret_cast<LPCSTR>(aAddress), &module) &&
+        GetModuleFileNameA(module, path, MAX_PATH))
+    {
+        auto name = std::strrchr(path, '\\');
+        std::snprintf(text, sizeof(text), "%-24s+0x%-13llx", name ? name + 1 : path,
+                      static_cast<unsigned long long>(aAddress - reinterpret_cast<uintptr_t>(module)));
+        aOut << text;
+        return;
+    }
+#else
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(aAddress), &info) && info.dli_fname)
+    {
+        auto name = std::strrchr(info.dli_fname, '/');
+        std::snprintf(text, sizeof(text), "%-24s+0x%-13llx", name ? name + 1 : info.dli_fname,
+                      static_cast<unsigned long long>(aAddress - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+        aOut << text;
+        return;
+    }
+#endif
+
+    std::snprintf(text, sizeof(text), "0x%-38llx", static_cast<unsigned long long>(aAddress));
+    aOut << text;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Memory/AllocationHooks.hpp>
+#include <RED4ext/Memory/Pool.hpp>
+
+namespace RED4ext::Memory
+{
+/**
+ * @brief The allocations of a call site in a pool, see AllocationTracker::Snapshot().
+ */
+struct AllocationSiteStats
+{
+    const PoolInfo* pool = nullptr;
+    uintptr_t site = 0; // The return address of the allocator's function.
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+};
+
+/**
+ * @brief The allocations of a pool, see AllocationTracker::Snapshot().
+ */
+struct AllocationPoolStats
+{
+    const PoolInfo* pool = nullptr;
+    uint64_t allocations = 0; // Tracked since the previous snapshot, like the bytes and frees.
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+    uint64_t sampledLiveBytes = 0; // The live bytes of the samples, multiplied by the sample rate.
+    uint64_t poolBytes = 0;        // The pool's bytesAllocated, including the allocations of the game.
+    uint64_t poolMaxBytes = 0;
+    int64_t poolBytesDelta = 0; // The change of the pool's bytesAllocated since the previous snapshot.
+};
+
+struct AllocationSnapshot
+{
+    std::vector<AllocationPoolStats> pools;
+    std::vector<AllocationSiteStats> sites;
+    uint64_t untrackedCalls = 0; // Calls that did not get a site because the table was full.
+    uint64_t droppedSamples = 0; // Samples that did not fit into the table.
+};
+
+/**
+ * @brief Records the allocations made through Allocator<T> by the plugin, grouped by pool and call site.
+ *
+ * Tracking is opt-in twice. Allocator<T> only reports to the tracker when RED4EXT_ALLOCATION_TRACKING is defined for
+ * every translation unit, e.g. through the CMake option of the same name, otherwise Enable() records nothing. Built
+ * with it, every allocator function only checks a pointer while tracking is disabled. Enabled, every call counts
+ * the allocation, its bytes or the free at its call site in a lock-free table. Every Nth allocation of a thread, with
+ * some jitter, is sampled: its call stack is captured and kept until it is freed, which makes it possible to estimate
+ * the live bytes per pool and to report the allocations that were never freed.
+ *
+ * Only allocations of the plugin are seen. The game, and DynArray and CString that grow through the game's functions,
+ * are not tracked. Sizes are not known when memory is freed, hence frees are counted without bytes. Compare the
+ * tracked bytes with the pool's own counters in a snapshot to see the plugin's share.
+ *
+ * @example
+ *
+ * RED4ext::Memory::AllocationTracker::Enable(256);
+ *
+ * // Periodically, e.g. every few seconds.
+ * RED4ext::Memory::AllocationTracker::Dump(RED4ext::Memory::AllocationTracker::Snapshot(), stream);
+ *
+ * // In Main, when the reason is EMainReason::Unload.
+ * RED4ext::Memory::AllocationTracker::ReportLeaks(stream);
+ * RED4ext::Memory::AllocationTracker::Disable();
+ */
+class AllocationTracker
+{
+public:
+    static constexpr uint32_t DefaultSampleRate = 1024;
+    static constexpr uint32_t MaxSites = 4096;
+    static constexpr uint32_t MaxSamples = 8192;
+    static constexpr uint32_t MaxFrames = 16;
+
+    /**
+     * @brief Starts tracking, the counters of a previous run are kept.
+     * @param aSampleRate Samples one in this many allocations, 0 disables sampling.
+     */
+    static void Enable(uint32_t aSampleRate = DefaultSampleRate);
+    static void Disable() noexcept;
+
+    [[nodiscard]] static bool IsEnabled() noexcept
+    {
+        return AllocationHooks::Get() == &GetHooks();
+    }
+
+    static void SetSampleRate(uint32_t aSampleRate) noexcept;
+    [[nodiscard]] static uint32_t GetSampleRate() noexcept;
+
+    /**
+     * @brief Returns what was allocated since the previous snapshot.
+     */
+    [[nodiscard]] static AllocationSnapshot Snapshot();
+
+    /**
+     * @brief Writes a snapshot as a table, pools with the most allocated bytes first.
+     */
+    static void Dump(const AllocationSnapshot& aSnapshot, std::ostream& aOut);
+
+    /**
+     * @brief Writes the sampled allocations that were not freed yet, grouped by pool and call stack.
+     * @note Allocations made while tracking is enabled and freed afterwards are reported too.
+     * @return The number of sampled allocations that were reported.
+     */
+    static uint32_t ReportLeaks(std::ostream& aOut);
+
+    // Installed as the AllocationHooks while tracking is enabled.
+    static void OnAlloc(const PoolInfo* aPool, void* aMemory, uint64_t aSize, void* aSite) noexcept;
+    static void OnRealloc(const PoolInfo* aPool, void* aOldMemory, void* aMemory, uint64_t aSize,
+                          void* aSite) noexcept;
+    static void OnFree(const PoolInfo* aPool, void* aMemory, void* aSite) noexcept;
+
+private:
+    struct Site
+    {
+        std::atomic<uint64_t> key; // A hash of the pool and the address, 0 while the site is free.
+        std::atomic<const PoolInfo*> pool;
+        std::atomic<uintptr_t> address;
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> frees;
+
+        // What the previous snapshot saw, guarded by the snapshot lock.
+        uint64_t reportedAllocations;
+        uint64_t reportedBytes;
+        uint64_t reportedFrees;
+    };
+
+    struct Sample
+    {
+        std::atomic<uintptr_t> memory; // Empty, Reserved, Removed or the sampled memory.
+        std::atomic<const PoolInfo*> pool;
+        std::atomic<uint64_t> size;
+
+        // Only read by ReportLeaks().
+        uintptr_t site;
+        uint32_t frameCount;
+        void* frames[MaxFrames];
+    };
+
+    struct State;
+
+    static const AllocationHooks& GetHooks() noexcept
+    {
+        static constexpr AllocationHooks hooks{&OnAlloc, &OnRealloc, &OnFree};
+        return hooks;
+    }
+
+    static std::atomic<State*>& GetState() noexcept;
+    static uint32_t GetNextInterval(uint32_t aSampleRate) noexcept;
+
+    static Site* FindSite(const PoolInfo* aPool, void* aSite) noexcept;
+    static bool ShouldSample(uint32_t aSampleRate) noexcept;
+    static void AddSample(const PoolInfo* aPool, void* aMemory, uint64_t aSize, void* aSite) noexcept;
+    static void RemoveSample(void* aMemory) noexcept;
+
+    static uint32_t CaptureStack(void** aFrames, void* aSite) noexcept;
+    static void WriteAddress(std::ostream& aOut, uintptr_t aAddress);
+};
+} // namespace RED4ext::Memory
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/Memory/AllocationTracker-inl.hpp>
+#endif
@@ -9,6 +9,10 @@
 #include <RED4ext/Memory/Pools.hpp>
 #include <RED4ext/Relocation.hpp>
 
+#ifdef RED4EXT_ALLOCATION_TRACKING
+#include <RED4ext/Memory/AllocationHooks.hpp>
+#endif
+
 #include <cstdint>
 #include <type_traits>
 
@@ -94,6 +98,13 @@ struct Allocator : IAllocator
             OOM(aSize, 8);
         }
 
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        if (auto hooks = AllocationHooks::Get())
+        {
+            hooks->onAlloc(pool, result.memory, aSize, RED4EXT_RETURN_ADDRESS());
+        }
+#endif
+
         return result;
     }
 
@@ -112,6 +123,13 @@ struct Allocator : IAllocator
             OOM(aSize, aAlignment);
         }
 
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        if (auto hooks = AllocationHooks::Get())
+        {
+            hooks->onAlloc(pool, result.memory, aSize, RED4EXT_RETURN_ADDRESS());
+        }
+#endif
+
         return result;
     }
 
@@ -122,6 +140,9 @@ struct Allocator : IAllocator
 
         auto pool = T::Get();
         auto storage = pool->storage->template GetAllocatorStorage<Vault>();
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        auto memory = aAllocation.memory;
+#endif
 
         AllocationResult result = {};
         realloc(storage, &result, aAllocation, aSize);
@@ -130,6 +151,13 @@ struct Allocator : IAllocator
             OOM(aSize, 8);
         }
 
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        if (auto hooks = AllocationHooks::Get())
+        {
+            hooks->onRealloc(pool, memory, result.memory, aSize, RED4EXT_RETURN_ADDRESS());
+        }
+#endif
+
         return result;
     }
 
@@ -141,6 +169,9 @@ struct Allocator : IAllocator
 
         auto pool = T::Get();
         auto storage = pool->storage->template GetAllocatorStorage<Vault>();
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        auto memory = aAllocation.memory;
+#endif
 
         AllocationResult result = {};
         realloc(storage, &result, aAllocation, aSize, aAlignment);
@@ -149,6 +180,13 @@ struct Allocator : IAllocator
             OOM(aSize, aAlignment);
         }
 
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        if (auto hooks = AllocationHooks::Get())
+        {
+            hooks->onRealloc(pool, memory, result.memory, aSize, RED4EXT_RETURN_ADDRESS());
+        }
+#endif
+
         return result;
     }
 
@@ -159,6 +197,14 @@ struct Allocator : IAllocator
 
         auto pool = T::Get();
         auto storage = pool->storage->template GetAllocatorStorage<Vault>();
+
+#ifdef RED4EXT_ALLOCATION_TRACKING
+        if (auto hooks = AllocationHooks::Get())
+        {
+            hooks->onFree(pool, aAllocation.memory, RED4EXT_RETURN_ADDRESS());
+        }
+#endif
+
         func(storage, aAllocation);
     }
 
@@ -0,0 +1,310 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/Memory/Arena.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include <RED4ext/Utils.hpp>
+
+RED4EXT_INLINE RED4ext::Memory::Arena::Arena(size_t aChunkSize)
+    : m_chunkSize(aChunkSize)
+    , m_current(0)
+    , m_offset(0)
+    , m_last(nullptr)
+#ifdef _DEBUG
+    , m_isPoisoning(true)
+#else
+    , m_isPoisoning(false)
+#endif
+{
+}
+
+RED4EXT_INLINE RED4ext::Memory::Arena::~Arena()
+{
+    for (auto& chunk : m_chunks)
+    {
+        ::operator delete(chunk.data);
+    }
+
+    // Do not leave a dangling pointer behind if the arena is destroyed while it is the current one.
+    auto& current = GetCurrentSlot();
+    if (current == this)
+    {
+        current = nullptr;
+    }
+}
+
+RED4EXT_INLINE void* RED4ext::Memory::Arena::Allocate(size_t aSize, size_t aAlignment)
+{
+    aAlignment = (std::max)(aAlignment, alignof(Header));
+
+    while (true)
+    {
+        if (m_current < m_chunks.size())
+        {
+            const auto& chunk = m_chunks[m_current];
+
+            auto begin = reinterpret_cast<uintptr_t>(chunk.data);
+            auto address = AlignUp<uintptr_t>(begin + m_offset + sizeof(Header), aAlignment);
+
+            if (address + aSize <= begin + chunk.size)
+            {
+                auto memory = reinterpret_cast<uint8_t*>(address);
+                reinterpret_cast<Header*>(memory)[-1].size = aSize;
+
+                m_offset = address + aSize - begin;
+                m_last = memory;
+
+                if (m_isPoisoning)
+                {
+                    std::memset(memory, AllocatedPattern, aSize);
+                }
+
+                return memory;
+            }
+
+            // Chunks that were kept by a reset are reused before a new one is added.
+            if (m_current + 1 < m_chunks.size())
+            {
+                ++m_current;
+                m_offset = 0;
+                continue;
+            }
+        }
+
+        AddChunk(sizeof(Header) + aAlignment + aSize);
+    }
+}
+
+RED4EXT_INLINE void* RED4ext::Memory::Arena::Reallocate(void* aMemory, size_t aSize, size_t aAlignment)
+{
+    if (!aMemory)
+    {
+        return Allocate(aSize, aAlignment);
+    }
+
+    if (aSize == 0)
+    {
+        Free(aMemory);
+        return nullptr;
+    }
+
+    auto header = static_cast<Header*>(aMemory) - 1;
+    auto oldSize = static_cast<size_t>(header->size);
+
+    if (aMemory == m_last && (reinterpret_cast<uintptr_t>(aMemory) & (aAlignment - 1)) == 0)
+    {
+        const auto& chunk = m_chunks[m_current];
+        auto offset = static_cast<size_t>(static_cast<uint8_t*>(aMemory) - chunk.data);
+
+        if (offset + aSize <= chunk.size)
+        {
+            if (m_isPoisoning && aSize > oldSize)
+            {
+                std::memset(static_cast<uint8_t*>(aMemory) + oldSize, AllocatedPattern, aSize - oldSize);
+            }
+
+            header->size = aSize;
+            Release(m_current, offset + aSize);
+            m_last = static_cast<uint8_t*>(aMemory);
+
+            return aMemory;
+        }
+    }
+
+    auto memory = Allocate(aSize, aAlignment);
+    std::memcpy(memory, aMemory, (std::min)(oldSize, aSize));
+
+    return memory;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::Free(void* aMemory) noexcept
+{
+    if (!aMemory || aMemory != m_last)
+    {
+        return;
+    }
+
+    auto offset = static_cast<uint8_t*>(aMemory) - sizeof(Header) - m_chunks[m_current].data;
+    Release(m_current, static_cast<size_t>(offset));
+}
+
+RED4EXT_INLINE RED4ext::Memory::Arena::Marker RED4ext::Memory::Arena::GetMarker() const noexcept
+{
+    return {m_current, m_offset};
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::Rewind(const Marker& aMarker) noexcept
+{
+    // A marker from after the current position was taken before an earlier rewind.
+    if (aMarker.chunk > m_current || (aMarker.chunk == m_current && aMarker.offset > m_offset))
+    {
+        return;
+    }
+
+    Release(aMarker.chunk, aMarker.offset);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::Reset() noexcept
+{
+    Release(0, 0);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::Trim() noexcept
+{
+    Reset();
+
+    for (size_t i = 1; i < m_chunks.size(); ++i)
+    {
+        ::operator delete(m_chunks[i].data);
+    }
+
+    if (m_chunks.size() > 1)
+    {
+        m_chunks.resize(1);
+    }
+}
+
+RED4EXT_INLINE size_t RED4ext::Memory::Arena::GetSize(const void* aMemory) noexcept
+{
+    return aMemory ? static_cast<size_t>((static_cast<const Header*>(aMemory) - 1)->size) : 0;
+}
+
+RED4EXT_INLINE size_t RED4ext::Memory::Arena::GetUsedBytes() const noexcept
+{
+    size_t used = m_offset;
+    for (size_t i = 0; i < m_current && i < m_chunks.size(); ++i)
+    {
+        used += m_chunks[i].size;
+    }
+
+    return used;
+}
+
+RED4EXT_INLINE size_t RED4ext::Memory::Arena::GetCapacity() const noexcept
+{
+    size_t capacity = 0;
+    for (const auto& chunk : m_chunks)
+    {
+        capacity += chunk.size;
+    }
+
+    return capacity;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::SetPoisoning(bool aEnabled) noexcept
+{
+    m_isPoisoning = aEnabled;
+}
+
+RED4EXT_INLINE bool RED4ext::Memory::Arena::IsPoisoning() const noexcept
+{
+    return m_isPoisoning;
+}
+
+RED4EXT_INLINE RED4ext::Memory::Arena& RED4ext::Memory::Arena::GetCurrent() noexcept
+{
+    auto current = GetCurrentSlot();
+    return current ? *current : GetThreadArena();
+}
+
+RED4EXT_INLINE RED4ext::Memory::Arena* RED4ext::Memory::Arena::SetCurrent(Arena* aArena) noexcept
+{
+    auto& current = GetCurrentSlot();
+
+    auto previous = current;
+    current = aArena;
+
+    return previous;
+}
+
+RED4EXT_INLINE RED4ext::Memory::Arena& RED4ext::Memory::Arena::GetThreadArena() noexcept
+{
+    static thread_local Arena arena;
+    return arena;
+}
+
+RED4EXT_INLINE RED4ext::Memory::Arena*& RED4ext::Memory::Arena::GetCurrentSlot() noexcept
+{
+    static thread_local Arena* current = nullptr;
+    return current;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::AddChunk(size_t aMinSize)
+{
+    auto size = (std::max)(m_chunkSize, aMinSize);
+    m_chunks.push_back({static_cast<uint8_t*>(::operator new(size)), size});
+
+    m_current = m_chunks.size() - 1;
+    m_offset = 0;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::Arena::Release(size_t aChunk, size_t aOffset) noexcept
+{
+    if (m_isPoisoning)
+    {
+        for (auto i = aChunk; i <= m_current && i < m_chunks.size(); ++i)
+        {
+            auto begin = i == aChunk ? aOffset : 0;
+            auto end = i == m_current ? m_offset : m_chunks[i].size;
+
+            if (end > begin)
+            {
+                std::memset(m_chunks[i].data + begin, ReleasedPattern, end - begin);
+            }
+        }
+    }
+
+    m_current = aChunk;
+    m_offset = aOffset;
+    m_last = nullptr;
+}
+
+RED4EXT_INLINE RED4ext::Memory::ArenaAllocator* RED4ext::Memory::ArenaAllocator::Get()
+{
+    static ArenaAllocator allocator;
+    return &allocator;
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::ArenaAllocator::Alloc(uint64_t aSize) const
+{
+    return {Arena::GetCurrent().Allocate(aSize), aSize};
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::ArenaAllocator::AllocAligned(
+    uint64_t aSize, uint32_t aAlignment) const
+{
+    return {Arena::GetCurrent().Allocate(aSize, aAlignment), aSize};
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::ArenaAllocator::Realloc(
+    AllocationResult& aAllocation, uint64_t aSize) const
+{
+    auto memory = Arena::GetCurrent().Reallocate(aAllocation.memory, aSize);
+    return {memory, memory ? aSize : 0};
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::ArenaAllocator::ReallocAligned(
+    AllocationResult& aAllocation, uint64_t aSize, uint32_t aAlignment) const
+{
+    auto memory = Arena::GetCurrent().Reallocate(aAllocation.memory, aSize, aAlignment);
+    return {memory, memory ? aSize : 0};
+}
+
+RED4EXT_INLINE void RED4ext::Memory::ArenaAllocator::Free(AllocationResult& aAllocation) const
+{
+    Arena::GetCurrent().Free(aAllocation.memory);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::ArenaAllocator::sub_28(void*) const
+{
+}
+
+RED4EXT_INLINE const uint32_t RED4ext::Memory::ArenaAllocator::GetHandle() const
+{
+    return Handle;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+
+namespace RED4ext::Memory
+{
+/**
+ * @brief A bump allocator for data that only lives for a short time, e.g. a frame.
+ *
+ * Memory is taken from chunks by moving an offset forward, nothing is released individually except for the last
+ * allocation. Reset() or Rewind() release everything allocated after a point at once and keep the chunks for reuse.
+ * Every allocation is preceded by its size, which lets Reallocate() copy the right amount and grow the last allocation
+ * in place.
+ *
+ * An arena is not thread-safe. Every thread has an arena of its own (see GetThreadArena()), a Scope replaces it with
+ * another one for a while. The ArenaAllocator allocates from the current arena of the calling thread.
+ *
+ * With poisoning enabled (the default in debug builds), new memory is filled with 0xCD and released memory with 0xDD.
+ */
+class Arena
+{
+public:
+    static constexpr size_t DefaultChunkSize = 256 * 1024;
+    static constexpr size_t DefaultAlignment = 8;
+    static constexpr uint8_t AllocatedPattern = 0xCD;
+    static constexpr uint8_t ReleasedPattern = 0xDD;
+
+    /**
+     * @brief A point in the arena to rewind to, see GetMarker().
+     */
+    struct Marker
+    {
+        size_t chunk;
+        size_t offset;
+    };
+
+    /**
+     * @brief Makes an arena the current one of the thread while it exists.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(Arena& aArena) noexcept
+            : m_previous(SetCurrent(&aArena))
+        {
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            SetCurrent(m_previous);
+        }
+
+    private:
+        Arena* m_previous;
+    };
+
+    explicit Arena(size_t aChunkSize = DefaultChunkSize);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+
+    /**
+     * @brief Allocates memory, a new chunk is added if the current one is full.
+     * @param aAlignment The alignment, a power of two.
+     */
+    [[nodiscard]] void* Allocate(size_t aSize, size_t aAlignment = DefaultAlignment);
+
+    /**
+     * @brief Resizes an allocation, the last allocation grows or shrinks in place. Anything else is copied into a new
+     * allocation. A null pointer allocates, a size of zero frees.
+     * @param aMemory An allocation of any arena, or nullptr.
+     */
+    [[nodiscard]] void* Reallocate(void* aMemory, size_t aSize, size_t aAlignment = DefaultAlignment);
+
+    /**
+     * @brief Releases the allocation if it was the last one of this arena, other allocations are kept until the arena
+     * is reset.
+     */
+    void Free(void* aMemory) noexcept;
+
+    [[nodiscard]] Marker GetMarker() const noexcept;
+
+    /**
+     * @brief Releases everything that was allocated after the marker was taken.
+     */
+    void Rewind(const Marker& aMarker) noexcept;
+
+    /**
+     * @brief Releases everything, the chunks are kept.
+     */
+    void Reset() noexcept;
+
+    /**
+     * @brief Releases everything and frees all chunks except for the first one.
+     */
+    void Trim() noexcept;
+
+    /**
+     * @brief Returns the size that was requested for an allocation of any arena.
+     */
+    [[nodiscard]] static size_t GetSize(const void* aMemory) noexcept;
+
+    /**
+     * @brief Returns the number of bytes from the beginning of the first chunk to the current position, including the
+     * unused ends of full chunks.
+     */
+    [[nodiscard]] size_t GetUsedBytes() const noexcept;
+    [[nodiscard]] size_t GetCapacity() const noexcept;
+
+    void SetPoisoning(bool aEnabled) noexcept;
+    [[nodiscard]] bool IsPoisoning() const noexcept;
+
+    /**
+     * @brief Returns the arena that the ArenaAllocator uses on this thread.
+     */
+    [[nodiscard]] static Arena& GetCurrent() noexcept;
+
+    /**
+     * @brief Makes the arena the current one of the thread, nullptr restores the thread's own arena.
+     * @return The previously set arena, nullptr if it was the thread's own arena.
+     */
+    static Arena* SetCurrent(Arena* aArena) noexcept;
+
+    /**
+     * @brief Returns the arena that belongs to the calling thread, it is created on first use.
+     */
+    [[nodiscard]] static Arena& GetThreadArena() noexcept;
+
+private:
+    struct Chunk
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    struct Header
+    {
+        uint64_t size;
+    };
+
+    static Arena*& GetCurrentSlot() noexcept;
+
+    void AddChunk(size_t aMinSize);
+    void Release(size_t aChunk, size_t aOffset) noexcept;
+
+    size_t m_chunkSize;
+    std::vector<Chunk> m_chunks;
+    size_t m_current; // The chunk that is being filled.
+    size_t m_offset;  // The used bytes of the current chunk.
+    uint8_t* m_last;  // The last allocation, as long as it was not released.
+    bool m_isPoisoning;
+};
+
+/**
+ * @brief An allocator that allocates from the calling thread's current arena.
+ *
+ * The allocator has no state, which lets containers copy it the way they copy the game's allocators. Freeing is a no-op
+ * unless the memory is the last allocation of the current arena. The memory is not tracked by a pool of the game, it
+ * should not be handed to the game when the game might free or grow it.
+ *
+ * @example
+ *
+ * RED4ext::Memory::Arena::GetThreadArena().Reset(); // At the beginning of the frame.
+ *
+ * RED4ext::HashMap<uint64_t, float> scratch(RED4ext::Memory::ArenaAllocator::Get());
+ */
+struct ArenaAllocator : IAllocator
+{
+    static constexpr uint32_t Handle = 0xFFFFFFFE;
+
+    static ArenaAllocator* Get();
+
+    virtual AllocationResult Alloc(uint64_t aSize) const override;
+    virtual AllocationResult AllocAligned(uint64_t aSize, uint32_t aAlignment) const override;
+    virtual AllocationResult Realloc(AllocationResult& aAllocation, uint64_t aSize) const override;
+    virtual AllocationResult ReallocAligned(AllocationResult& aAllocation, uint64_t aSize,
+                                            uint32_t aAlignment) const override;
+    virtual void Free(AllocationResult& aAllocation) const override;
+    virtual void sub_28(void* a1) const override;
+    virtual const uint32_t GetHandle() const override;
+
+    using IAllocator::Alloc;
+    using IAllocator::Free;
+};
+} // namespace RED4ext::Memory
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/Memory/Arena-inl.hpp>
+#endif
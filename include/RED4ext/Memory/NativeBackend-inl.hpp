@@ -0,0 +1,691 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/Memory/NativeBackend.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <RED4ext/CString.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/Hashing/FNV1a.hpp>
+#include <RED4ext/Memory/Vault.hpp>
+#include <RED4ext/Relocation.hpp>
+#include <RED4ext/Utils.hpp>
+
+struct RED4ext::Memory::NativeBackend::State
+{
+    std::mutex lock;
+    std::atomic<bool> isInstalled{false};
+    Mode mode{Mode::SizeClasses};
+
+    Vault* vault{nullptr};
+    PoolStorage storages[PoolRegistry::MaxPoolCount]{};
+    uint32_t poolCount{0};
+
+    // Blocks of exited threads and of caches that exceeded their limit, guarded by the lock.
+    FreeBlock* heads[ClassCount]{};
+    std::vector<void*> pages;
+};
+
+RED4EXT_INLINE RED4ext::Memory::NativeBackend::Cache::~Cache()
+{
+    auto& state = GetState();
+
+    {
+        std::lock_guard<std::mutex> _(state.lock);
+        for (uint32_t i = 0; i < ClassCount; ++i)
+        {
+            while (auto block = heads[i])
+            {
+                heads[i] = block->next;
+
+                block->next = state.heads[i];
+                state.heads[i] = block;
+            }
+        }
+    }
+
+    // Blocks freed by other thread locals after this point go to the shared lists directly.
+    IsCacheDestroyed() = true;
+}
+
+RED4EXT_INLINE bool RED4ext::Memory::NativeBackend::Install(Mode aMode)
+{
+    auto& state = GetState();
+
+    {
+        std::lock_guard<std::mutex> _(state.lock);
+        if (state.isInstalled.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        state.mode = aMode;
+        state.vault = new Vault();
+        state.isInstalled.store(true, std::memory_order_release);
+    }
+
+    // The root is the first pool, every other pool becomes its child.
+    AddPool(PoolRoot::Name);
+
+    Detail::GetPoolFactory() = &AddPool;
+    UniversalRelocBase::SetResolveOverride(&Resolve);
+
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::Memory::NativeBackend::IsInstalled() noexcept
+{
+    return GetState().isInstalled.load(std::memory_order_acquire);
+}
+
+RED4EXT_INLINE RED4ext::Memory::NativeBackend::Mode RED4ext::Memory::NativeBackend::GetMode() noexcept
+{
+    return GetState().mode;
+}
+
+RED4EXT_INLINE uintptr_t RED4ext::Memory::NativeBackend::Resolve(uint32_t aHash) noexcept
+{
+    namespace Hashes = Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case Hashes::Memory_Vault:
+        return reinterpret_cast<uintptr_t>(GetState().vault);
+    case Hashes::Memory_Vault_Alloc:
+        return reinterpret_cast<uintptr_t>(&VaultAlloc);
+    case Hashes::Memory_Vault_AllocAligned:
+        return reinterpret_cast<uintptr_t>(&VaultAllocAligned);
+    case Hashes::Memory_Vault_Realloc:
+        return reinterpret_cast<uintptr_t>(&VaultRealloc);
+    case Hashes::Memory_Vault_ReallocAligned:
+        return reinterpret_cast<uintptr_t>(&VaultReallocAligned);
+    case Hashes::Memory_Vault_Free:
+        return reinterpret_cast<uintptr_t>(&VaultFree);
+    case Hashes::Memory_Vault_Unk1:
+        return reinterpret_cast<uintptr_t>(&VaultUnk1);
+    case Hashes::Memory_PoolStorage_OOM:
+        return reinterpret_cast<uintptr_t>(&PoolStorageOOM);
+    case Hashes::DynArray_Realloc:
+        return reinterpret_cast<uintptr_t>(&DynArrayRealloc);
+    case Hashes::CString_ctor_str:
+        return reinterpret_cast<uintptr_t>(&CStringCtorStr);
+    case Hashes::CString_ctor_span:
+        return reinterpret_cast<uintptr_t>(&CStringCtorSpan);
+    case Hashes::CString_copy:
+        return reinterpret_cast<uintptr_t>(&CStringCopy);
+    case Hashes::CString_dtor:
+        return reinterpret_cast<uintptr_t>(&CStringDtor);
+    default:
+        return 0;
+    }
+}
+
+RED4EXT_INLINE RED4ext::Memory::PoolInfo* RED4ext::Memory::NativeBackend::AddPool(const char* aName)
+{
+    auto& state = GetState();
+    if (!state.isInstalled.load(std::memory_order_acquire) || !aName)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> _(state.lock);
+
+    auto& registry = state.vault->poolRegistry;
+    if (auto pool = registry.Get(aName))
+    {
+        return pool;
+    }
+
+    if (state.poolCount == PoolRegistry::MaxPoolCount)
+    {
+        return nullptr;
+    }
+
+    const auto index = state.poolCount;
+    const auto handle = FNV1a32(aName);
+
+    // The storage is passed to the vault's functions instead of the vault, see GetAllocatorStorage.
+    auto& storage = state.storages[index];
+    storage.allocatorStorage = reinterpret_cast<uint64_t>(&storage);
+    storage.allocatorhandle = handle;
+    storage.allocatorId = index;
+
+    std::unique_lock<SharedSpinLock> lock(registry.nodesLock);
+
+    auto& pool = registry.nodes[index];
+    std::strncpy(pool.name, aName, sizeof(pool.name) - 1);
+    pool.storage = &storage;
+    pool.handle = handle;
+    pool.contributeToParentMetrics = true;
+
+    if (index != 0)
+    {
+        auto& root = registry.nodes[0];
+        pool.sibling = root.child;
+        root.child = &pool;
+    }
+
+    ++state.poolCount;
+    return &pool;
+}
+
+RED4EXT_INLINE size_t RED4ext::Memory::NativeBackend::GetSize(const void* aMemory) noexcept
+{
+    return aMemory ? static_cast<size_t>((static_cast<const Header*>(aMemory) - 1)->size) : 0;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::Memory::NativeBackend::GetClass(size_t aSize) noexcept
+{
+    // 16 byte steps up to 128 bytes, four classes per power of two after that.
+    if (aSize <= 128)
+    {
+        return aSize <= 16 ? 0 : static_cast<uint32_t>((aSize + 15) / 16 - 1);
+    }
+
+    const auto bits = static_cast<uint32_t>(std::bit_width(aSize - 1));
+    const auto quarter = static_cast<uint32_t>((aSize - 1 - (size_t(1) << (bits - 1))) >> (bits - 3));
+
+    return 8 + (bits - 8) * 4 + quarter;
+}
+
+RED4EXT_INLINE size_t RED4ext::Memory::NativeBackend::GetClassSize(uint32_t aClass) noexcept
+{
+    if (aClass < 8)
+    {
+        return (aClass + 1) * 16;
+    }
+
+    const auto base = size_t(128) << ((aClass - 8) / 4);
+    return base + ((aClass - 8) % 4 + 1) * (base / 4);
+}
+
+RED4EXT_INLINE RED4ext::Memory::NativeBackend::State& RED4ext::Memory::NativeBackend::GetState() noexcept
+{
+    // Never destroyed, blocks can still be freed by thread locals and other static objects.
+    static auto state = new State();
+    return *state;
+}
+
+RED4EXT_INLINE RED4ext::Memory::NativeBackend::Cache& RED4ext::Memory::NativeBackend::GetCache() noexcept
+{
+    static thread_local Cache cache;
+    return cache;
+}
+
+RED4EXT_INLINE bool& RED4ext::Memory::NativeBackend::IsCacheDestroyed() noexcept
+{
+    static thread_local bool isDestroyed = false;
+    return isDestroyed;
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::NativeBackend::Allocate(PoolStorage* aStorage,
+                                                                                         uint64_t aSize,
+                                                                                         uint32_t aAlignment)
+{
+    const auto alignment = (std::max)(static_cast<size_t>(aAlignment), sizeof(Header));
+    const auto total = sizeof(Header) + (alignment - sizeof(Header)) + aSize;
+
+    uint8_t* block;
+    uint32_t sizeClass;
+
+    if (GetState().mode == Mode::SizeClasses && total <= MaxSmallSize)
+    {
+        sizeClass = GetClass(total);
+        block = static_cast<uint8_t*>(AllocateBlock(sizeClass));
+    }
+    else
+    {
+        sizeClass = LargeClass;
+        block = static_cast<uint8_t*>(std::malloc(total));
+    }
+
+    if (!block)
+    {
+        return {};
+    }
+
+    auto memory = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<uintptr_t>(block) + sizeof(Header), alignment));
+
+    auto header = reinterpret_cast<Header*>(memory) - 1;
+    header->size = aSize;
+    header->offset = static_cast<uint32_t>(memory - block);
+    header->sizeClass = sizeClass;
+
+    AddBytes(aStorage, aSize);
+    return {memory, aSize};
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::NativeBackend::Reallocate(
+    PoolStorage* aStorage, AllocationResult& aAllocation, uint64_t aSize, uint32_t aAlignment)
+{
+    auto memory = static_cast<uint8_t*>(aAllocation.memory);
+    if (!memory)
+    {
+        return Allocate(aStorage, aSize, aAlignment);
+    }
+
+    if (aSize == 0)
+    {
+        Free(aStorage, memory);
+        return {};
+    }
+
+    const auto alignment = (std::max)(static_cast<size_t>(aAlignment), sizeof(Header));
+
+    auto header = reinterpret_cast<Header*>(memory) - 1;
+    const auto oldSize = header->size;
+
+    if ((reinterpret_cast<uintptr_t>(memory) & (alignment - 1)) == 0)
+    {
+        if (header->sizeClass != LargeClass)
+        {
+            // Stay in the block while it fits, unless it shrinks into a smaller class.
+            const auto total = header->offset + aSize;
+            if (total <= GetClassSize(header->sizeClass) && (aSize >= oldSize || GetClass(total) == header->sizeClass))
+            {
+                header->size = aSize;
+
+                RemoveBytes(aStorage, oldSize);
+                AddBytes(aStorage, aSize);
+                return {memory, aSize};
+            }
+        }
+        else if (header->offset == sizeof(Header) && alignment == sizeof(Header))
+        {
+            auto block = static_cast<uint8_t*>(std::realloc(memory - sizeof(Header), sizeof(Header) + aSize));
+            if (!block)
+            {
+                return {};
+            }
+
+            memory = block + sizeof(Header);
+            reinterpret_cast<Header*>(block)->size = aSize;
+
+            RemoveBytes(aStorage, oldSize);
+            AddBytes(aStorage, aSize);
+            return {memory, aSize};
+        }
+    }
+
+    auto result = Allocate(aStorage, aSize, aAlignment);
+    if (result.memory)
+    {
+        std::memcpy(result.memory, memory, (std::min)(oldSize, aSize));
+        Free(aStorage, memory);
+    }
+
+    return result;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::Free(PoolStorage* aStorage, void* aMemory) noexcept
+{
+    if (!aMemory)
+    {
+        return;
+    }
+
+    auto header = static_cast<Header*>(aMemory) - 1;
+    auto block = static_cast<uint8_t*>(aMemory) - header->offset;
+
+    RemoveBytes(aStorage, header->size);
+
+    if (header->sizeClass == LargeClass)
+    {
+        std::free(block);
+    }
+    else
+    {
+        ReleaseBlock(block, header->sizeClass);
+    }
+}
+
+RED4EXT_INLINE void* RED4ext::Memory::NativeBackend::AllocateBlock(uint32_t aClass)
+{
+    const auto size = GetClassSize(aClass);
+
+    if (IsCacheDestroyed())
+    {
+        auto& state = GetState();
+
+        std::lock_guard<std::mutex> _(state.lock);
+        if (auto block = state.heads[aClass])
+        {
+            state.heads[aClass] = block->next;
+            return block;
+        }
+
+        // Reachable as long as it is used or cached, like any other block.
+        return ::operator new(size, std::nothrow);
+    }
+
+    auto& cache = GetCache();
+    if (auto block = cache.heads[aClass])
+    {
+        cache.heads[aClass] = block->next;
+        --cache.counts[aClass];
+        return block;
+    }
+
+    auto& state = GetState();
+
+    if (static_cast<size_t>(cache.ends[aClass] - cache.cursors[aClass]) < size)
+    {
+        std::lock_guard<std::mutex> _(state.lock);
+
+        // Take all blocks released by other threads before carving a new page.
+        if (auto block = state.heads[aClass])
+        {
+            state.heads[aClass] = nullptr;
+
+            cache.heads[aClass] = block->next;
+            for (auto next = block->next; next; next = next->next)
+            {
+                ++cache.counts[aClass];
+            }
+
+            return block;
+        }
+
+        const auto pageSize = (std::max)(PageSize, size * 8);
+
+        auto page = static_cast<uint8_t*>(::operator new(pageSize, std::nothrow));
+        if (!page)
+        {
+            return nullptr;
+        }
+
+        state.pages.push_back(page);
+
+        cache.cursors[aClass] = page;
+        cache.ends[aClass] = page + pageSize;
+    }
+
+    auto block = cache.cursors[aClass];
+    cache.cursors[aClass] += size;
+
+    return block;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::ReleaseBlock(void* aBlock, uint32_t aClass) noexcept
+{
+    auto block = static_cast<FreeBlock*>(aBlock);
+
+    if (!IsCacheDestroyed())
+    {
+        auto& cache = GetCache();
+        if (cache.counts[aClass] * GetClassSize(aClass) < MaxCachedBytes)
+        {
+            block->next = cache.heads[aClass];
+            cache.heads[aClass] = block;
+            ++cache.counts[aClass];
+            return;
+        }
+
+        // The cache is full, hand all of its blocks of the class to the other threads.
+        auto& state = GetState();
+
+        std::lock_guard<std::mutex> _(state.lock);
+        block->next = cache.heads[aClass];
+
+        while (auto next = block->next)
+        {
+            block->next = next->next;
+
+            next->next = state.heads[aClass];
+            state.heads[aClass] = next;
+        }
+
+        block->next = state.heads[aClass];
+        state.heads[aClass] = block;
+
+        cache.heads[aClass] = nullptr;
+        cache.counts[aClass] = 0;
+        return;
+    }
+
+    auto& state = GetState();
+
+    std::lock_guard<std::mutex> _(state.lock);
+    block->next = state.heads[aClass];
+    state.heads[aClass] = block;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::AddBytes(PoolStorage* aStorage, uint64_t aSize) noexcept
+{
+    std::atomic_ref<uint64_t> bytesAllocated(aStorage->bytesAllocated);
+    std::atomic_ref<uint64_t> maxBytesAllocated(aStorage->maxBytesAllocated);
+
+    const auto bytes = bytesAllocated.fetch_add(aSize, std::memory_order_relaxed) + aSize;
+
+    auto maxBytes = maxBytesAllocated.load(std::memory_order_relaxed);
+    while (maxBytes < bytes && !maxBytesAllocated.compare_exchange_weak(maxBytes, bytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::RemoveBytes(PoolStorage* aStorage, uint64_t aSize) noexcept
+{
+    std::atomic_ref<uint64_t>(aStorage->bytesAllocated).fetch_sub(aSize, std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::VaultAlloc(Vault* aVault, AllocationResult* aResult,
+                                                              uint64_t aSize)
+{
+    *aResult = Allocate(reinterpret_cast<PoolStorage*>(aVault), aSize, 8);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::VaultAllocAligned(Vault* aVault, AllocationResult* aResult,
+                                                                     uint64_t aSize, uint32_t aAlignment)
+{
+    *aResult = Allocate(reinterpret_cast<PoolStorage*>(aVault), aSize, aAlignment);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::VaultRealloc(Vault* aVault, AllocationResult* aResult,
+                                                                AllocationResult& aAllocation, uint64_t aSize)
+{
+    *aResult = Reallocate(reinterpret_cast<PoolStorage*>(aVault), aAllocation, aSize, 8);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::VaultReallocAligned(Vault* aVault, AllocationResult* aResult,
+                                                                       AllocationResult& aAllocation, uint64_t aSize,
+                                                                       uint32_t aAlignment)
+{
+    *aResult = Reallocate(reinterpret_cast<PoolStorage*>(aVault), aAllocation, aSize, aAlignment);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::VaultFree(Vault* aVault, AllocationResult& aAllocation)
+{
+    Free(reinterpret_cast<PoolStorage*>(aVault), aAllocation.memory);
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::VaultUnk1(Vault*, void*)
+{
+}
+
+RED4EXT_INLINE RED4ext::Memory::AllocationResult RED4ext::Memory::NativeBackend::PoolStorageOOM(PoolStorage*,
+                                                                                               uint64_t, uint32_t)
+{
+    // Unlike the game, there is nothing to evict. The allocation fails.
+    return {};
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::DynArrayRealloc(void* aArray, uint32_t aCapacity,
+                                                                   uint32_t aElementSize, uint32_t aAlignment,
+                                                                   void* aMoveFunc)
+{
+    struct Array
+    {
+        uint8_t* entries;
+        uint32_t capacity;
+        uint32_t size;
+    };
+
+    using MoveFunc_t = void (*)(void* aDstBuffer, void* aSrcBuffer, int32_t aSrcSize, void* aSrcArray);
+
+    auto array = static_cast<Array*>(aArray);
+
+    // The allocator is stored instead of the entries while there are none, after the entries otherwise.
+    auto slot = reinterpret_cast<uintptr_t*>(&array->entries);
+    if (array->capacity)
+    {
+        auto end = reinterpret_cast<uintptr_t>(array->entries) + static_cast<uintptr_t>(array->capacity) * aElementSize;
+        slot = reinterpret_cast<uintptr_t*>(AlignUp(end, sizeof(void*)));
+    }
+
+    auto vftable = *slot;
+    if (!vftable)
+    {
+        vftable = *reinterpret_cast<uintptr_t*>(DefaultAllocator::Get());
+    }
+
+    auto allocator = reinterpret_cast<IAllocator*>(&vftable);
+
+    if (aCapacity == 0)
+    {
+        if (array->capacity)
+        {
+            allocator->Free(array->entries);
+        }
+
+        array->entries = reinterpret_cast<uint8_t*>(vftable);
+        array->capacity = 0;
+        return;
+    }
+
+    const auto size = AlignUp<size_t>(static_cast<size_t>(aCapacity) * aElementSize, sizeof(void*)) + sizeof(void*);
+
+    AllocationResult result;
+    if (array->capacity && !aMoveFunc)
+    {
+        AllocationResult allocation{array->entries, 0};
+        result = allocator->ReallocAligned(allocation, size, aAlignment);
+    }
+    else
+    {
+        result = allocator->AllocAligned(size, aAlignment);
+        if (result.memory && array->capacity)
+        {
+            if (aMoveFunc)
+            {
+                reinterpret_cast<MoveFunc_t>(aMoveFunc)(result.memory, array->entries,
+                                                        static_cast<int32_t>(array->size), array);
+            }
+            else
+            {
+                std::memcpy(result.memory, array->entries, static_cast<size_t>(array->size) * aElementSize);
+            }
+
+            allocator->Free(array->entries);
+        }
+    }
+
+    if (!result.memory)
+    {
+        return;
+    }
+
+    array->entries = static_cast<uint8_t*>(result.memory);
+    array->capacity = aCapacity;
+
+    auto end = reinterpret_cast<uintptr_t>(array->entries) + static_cast<uintptr_t>(aCapacity) * aElementSize;
+    *reinterpret_cast<uintptr_t*>(AlignUp(end, sizeof(void*))) = vftable;
+}
+
+RED4EXT_INLINE RED4ext::CString* RED4ext::Memory::NativeBackend::CStringCtorStr(CString* aThis, const char* aText)
+{
+    AssignString(aThis, aText, aText ? static_cast<uint32_t>(std::strlen(aText)) : 0);
+    return aThis;
+}
+
+RED4EXT_INLINE RED4ext::CString* RED4ext::Memory::NativeBackend::CStringCtorSpan(CString* aThis, const char* aText,
+                                                                                uint32_t aLength)
+{
+    AssignString(aThis, aText, aText ? aLength : 0);
+    return aThis;
+}
+
+RED4EXT_INLINE RED4ext::CString* RED4ext::Memory::NativeBackend::CStringCopy(CString* aThis, const CString& aOther)
+{
+    if (aThis != &aOther)
+    {
+        AssignString(aThis, aOther.c_str(), aOther.Length());
+    }
+
+    return aThis;
+}
+
+RED4EXT_INLINE RED4ext::CString* RED4ext::Memory::NativeBackend::CStringDtor(CString* aThis)
+{
+    if (!aThis->IsInline())
+    {
+        auto allocator = aThis->allocator ? reinterpret_cast<IAllocator*>(&aThis->allocator) : DefaultAllocator::Get();
+        allocator->Free(aThis->text.str.ptr);
+    }
+
+    std::memset(&aThis->text, 0, sizeof(aThis->text));
+    aThis->length = 0;
+
+    return aThis;
+}
+
+RED4EXT_INLINE void RED4ext::Memory::NativeBackend::AssignString(CString* aThis, const char* aText, uint32_t aLength)
+{
+    constexpr uint32_t heapFlag = 0x40000000;
+
+    auto allocator = aThis->allocator ? reinterpret_cast<IAllocator*>(&aThis->allocator) : DefaultAllocator::Get();
+    const auto isInline = aThis->IsInline();
+
+    if (aLength < sizeof(aThis->text.inline_str))
+    {
+        if (!isInline)
+        {
+            allocator->Free(aThis->text.str.ptr);
+        }
+
+        if (aLength)
+        {
+            std::memmove(aThis->text.inline_str, aText, aLength);
+        }
+
+        aThis->text.inline_str[aLength] = '\0';
+        aThis->length = aLength;
+        return;
+    }
+
+    if (isInline || static_cast<uint32_t>(aThis->text.str.capacity) <= aLength)
+    {
+        auto result = allocator->Alloc(aLength + 1);
+        if (!result.memory)
+        {
+            return;
+        }
+
+        // The text might be a part of the current one, copy it before freeing the old buffer.
+        auto buffer = static_cast<char*>(result.memory);
+        std::memcpy(buffer, aText, aLength);
+
+        if (!isInline)
+        {
+            allocator->Free(aThis->text.str.ptr);
+        }
+
+        aThis->text.str.ptr = buffer;
+        aThis->text.str.capacity = static_cast<int32_t>(aLength + 1);
+    }
+    else
+    {
+        std::memmove(aThis->text.str.ptr, aText, aLength);
+    }
+
+    aThis->text.str.ptr[aLength] = '\0';
+    aThis->length = aLength | heapFlag;
+}
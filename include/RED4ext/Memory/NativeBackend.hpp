@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+#include <RED4ext/Memory/Pool.hpp>
+
+namespace RED4ext
+{
+struct CString;
+
+namespace Memory
+{
+struct Vault;
+
+/**
+ * @brief Emulates the game's memory outside of the game, e.g. in unit tests and benchmarks of the containers.
+ *
+ * Once installed, the addresses of the vault, its allocation functions, the pool's out of memory handler and the
+ * native functions used by DynArray and CString resolve to implementations of this class. Every pool is registered in
+ * an emulated PoolRegistry when it is first used, its PoolStorage counts the allocated bytes like the game does.
+ *
+ * In the SizeClasses mode, blocks up to MaxSmallSize bytes are taken from per-thread free lists of size classes, four
+ * per power of two, that are carved from larger pages. Freed blocks are cached by the thread that frees them and are
+ * never returned to the system. Larger blocks and all blocks in the System mode are allocated by the C runtime.
+ *
+ * @note Resolved addresses are cached, install the backend before anything from the SDK is used. Nothing else is
+ * emulated, other native functions still need the game.
+ *
+ * @example
+ *
+ * int main()
+ * {
+ *     RED4ext::Memory::NativeBackend::Install();
+ *
+ *     RED4ext::DynArray<int32_t> array(RED4ext::Memory::DefaultAllocator::Get());
+ *     array.PushBack(1);
+ * }
+ */
+class NativeBackend
+{
+public:
+    enum class Mode : uint8_t
+    {
+        SizeClasses,
+        System
+    };
+
+    static constexpr size_t MaxSmallSize = 32 * 1024;
+    static constexpr size_t PageSize = 64 * 1024;
+
+    /**
+     * @brief Selects the backend for the rest of the process.
+     * @return false if the backend is already installed, the mode is not changed then.
+     */
+    static bool Install(Mode aMode = Mode::SizeClasses);
+
+    [[nodiscard]] static bool IsInstalled() noexcept;
+    [[nodiscard]] static Mode GetMode() noexcept;
+
+    /**
+     * @brief Returns the address of the emulated object or function for the hash, 0 for anything else.
+     */
+    [[nodiscard]] static uintptr_t Resolve(uint32_t aHash) noexcept;
+
+    /**
+     * @brief Registers a pool, returns the existing one if the name is already known.
+     * @return The pool, or nullptr if the registry is full.
+     */
+    static PoolInfo* AddPool(const char* aName);
+
+    /**
+     * @brief Returns the requested size of a block allocated by the backend.
+     */
+    [[nodiscard]] static size_t GetSize(const void* aMemory) noexcept;
+
+private:
+    struct Header
+    {
+        uint64_t size;      // The requested size.
+        uint32_t offset;    // From the beginning of the block to the memory.
+        uint32_t sizeClass; // LargeClass for blocks of the C runtime.
+    };
+
+    static constexpr uint32_t ClassCount = 40;
+    static constexpr uint32_t LargeClass = static_cast<uint32_t>(-1);
+    static constexpr size_t MaxCachedBytes = 1024 * 1024; // Per class and thread.
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // The blocks of a thread, moved to the shared lists when the thread exits.
+    struct Cache
+    {
+        ~Cache();
+
+        FreeBlock* heads[ClassCount]{};
+        uint32_t counts[ClassCount]{};
+        uint8_t* cursors[ClassCount]{}; // The unused part of the last page of a class.
+        uint8_t* ends[ClassCount]{};
+    };
+
+    struct State;
+
+    static uint32_t GetClass(size_t aSize) noexcept;
+    static size_t GetClassSize(uint32_t aClass) noexcept;
+
+    static State& GetState() noexcept;
+    static Cache& GetCache() noexcept;
+    static bool& IsCacheDestroyed() noexcept;
+
+    static AllocationResult Allocate(PoolStorage* aStorage, uint64_t aSize, uint32_t aAlignment);
+    static AllocationResult Reallocate(PoolStorage* aStorage, AllocationResult& aAllocation, uint64_t aSize,
+                                       uint32_t aAlignment);
+    static void Free(PoolStorage* aStorage, void* aMemory) noexcept;
+
+    static void* AllocateBlock(uint32_t aClass);
+    static void ReleaseBlock(void* aBlock, uint32_t aClass) noexcept;
+
+    static void AddBytes(PoolStorage* aStorage, uint64_t aSize) noexcept;
+    static void RemoveBytes(PoolStorage* aStorage, uint64_t aSize) noexcept;
+
+    // Emulated native functions, the vault passed to the allocation functions is the pool's storage.
+    static void VaultAlloc(Vault* aVault, AllocationResult* aResult, uint64_t aSize);
+    static void VaultAllocAligned(Vault* aVault, AllocationResult* aResult, uint64_t aSize, uint32_t aAlignment);
+    static void VaultRealloc(Vault* aVault, AllocationResult* aResult, AllocationResult& aAllocation, uint64_t aSize);
+    static void VaultReallocAligned(Vault* aVault, AllocationResult* aResult, AllocationResult& aAllocation,
+                                    uint64_t aSize, uint32_t aAlignment);
+    static void VaultFree(Vault* aVault, AllocationResult& aAllocation);
+    static void VaultUnk1(Vault* aVault, void* a2);
+    static AllocationResult PoolStorageOOM(PoolStorage* aStorage, uint64_t aSize, uint32_t aAlignment);
+
+    static void DynArrayRealloc(void* aArray, uint32_t aCapacity, uint32_t aElementSize, uint32_t aAlignment,
+                                void* aMoveFunc);
+
+    static CString* CStringCtorStr(CString* aThis, const char* aText);
+    static CString* CStringCtorSpan(CString* aThis, const char* aText, uint32_t aLength);
+    static CString* CStringCopy(CString* aThis, const CString& aOther);
+    static CString* CStringDtor(CString* aThis);
+    static void AssignString(CString* aThis, const char* aText, uint32_t aLength);
+};
+} // namespace Memory
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/Memory/NativeBackend-inl.hpp>
+#endif
@@ -80,3 +80,18 @@ struct PoolRegistry
 };
 RED4EXT_ASSERT_SIZE(PoolRegistry, 0xF008);
 } // namespace RED4ext::Memory
+
+namespace RED4ext::Detail
+{
+using PoolFactory = Memory::PoolInfo* (*)(const char* aName);
+
+/**
+ * @brief Returns the function that creates pools which are missing from the registry. It is only set when the memory
+ * is emulated outside of the game, see NativeBackend.
+ */
+inline PoolFactory& GetPoolFactory() noexcept
+{
+    static PoolFactory factory = nullptr;
+    return factory;
+}
+} // namespace RED4ext::Detail
@@ -13,7 +13,22 @@ protected:
 
     inline static T* Get(const char* aName)
     {
-        static auto pool = Vault::Get()->poolRegistry.Get<T>(aName);
+        static auto pool = Find(aName);
+        return pool;
+    }
+
+private:
+    static T* Find(const char* aName)
+    {
+        auto pool = Vault::Get()->poolRegistry.Get<T>(aName);
+        if (!pool)
+        {
+            if (auto factory = Detail::GetPoolFactory())
+            {
+                pool = reinterpret_cast<T*>(factory(aName));
+            }
+        }
+
         return pool;
     }
 };
@@ -4,8 +4,11 @@
 #include <RED4ext/NativeTypes.hpp>
 #endif
 
+#include <RED4ext/Detail/Curve.hpp>
 #include <RED4ext/RTTISystem.hpp>
 
+#include <algorithm>
+
 RED4EXT_INLINE RED4ext::TweakDBID::TweakDBID(const std::string_view aName) noexcept
 {
     size_t len = aName.size();
@@ -415,6 +418,145 @@ RED4EXT_INLINE void RED4ext::CurveData<T>::Resize(uint32_t aNewSize) noexcept
     curve->valuesOffset = newValuesOffset;
 }
 
+template<typename T>
+RED4EXT_INLINE T RED4ext::CurveData<T>::Evaluate(float aPoint) const noexcept
+{
+    uint32_t hint = 0;
+    return Evaluate(aPoint, hint);
+}
+
+template<typename T>
+RED4EXT_INLINE T RED4ext::CurveData<T>::Evaluate(float aPoint, uint32_t& aSegmentHint) const noexcept
+{
+    auto size = GetSize();
+    if (size == 0)
+    {
+        return T();
+    }
+
+    auto* curve = GetCurve();
+    const float* points = curve->GetPoints();
+    const T* values = curve->GetValues();
+
+    if (size == 1 || aPoint <= points[0])
+    {
+        return values[0];
+    }
+
+    if (aPoint >= points[size - 1])
+    {
+        return values[size - 1];
+    }
+
+    auto segment = Detail::FindCurveSegment(points, size, aPoint, aSegmentHint);
+    aSegmentHint = segment;
+
+    if constexpr (Detail::IsCurveInterpolable<T>)
+    {
+        if (interpolationType != curve::EInterpolationType::EIT_Constant)
+        {
+            float t;
+            T v0, v1, m0, m1;
+            Detail::LoadCurveSegment(points, values, size, interpolationType, segment, aPoint, t, v0, v1, m0, m1);
+
+            if (interpolationType == curve::EInterpolationType::EIT_Linear)
+            {
+                return Detail::LerpCurve(v0, v1, t);
+            }
+
+            return Detail::HermiteCurve(v0, v1, m0, m1, t);
+        }
+    }
+
+    return values[segment];
+}
+
+template<typename T>
+RED4EXT_INLINE void RED4ext::CurveData<T>::EvaluateMany(Span<const float> aPoints, Span<T> aResults) const noexcept
+{
+    auto count = static_cast<uint32_t>((std::min)(aPoints.GetSize(), aResults.GetSize()));
+    auto size = GetSize();
+
+    if (size == 0)
+    {
+        std::fill(aResults.begin(), aResults.begin() + count, T());
+        return;
+    }
+
+    auto* curve = GetCurve();
+    const float* points = curve->GetPoints();
+    const T* values = curve->GetValues();
+
+    bool isInterpolated = false;
+    if constexpr (Detail::IsCurveInterpolable<T>)
+    {
+        isInterpolated = size > 1 && interpolationType != curve::EInterpolationType::EIT_Constant;
+    }
+
+    if (!isInterpolated)
+    {
+        uint32_t hint = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            aResults[i] = Evaluate(aPoints.beginPtr[i], hint);
+        }
+
+        return;
+    }
+
+    if constexpr (Detail::IsCurveInterpolable<T>)
+    {
+        // Search the segments and gather their inputs first, then interpolate the whole batch at once. Points outside
+        // of the curve are clamped right away, they do not go through the kernels.
+        Detail::CurveBatch<T> batch;
+        uint32_t hint = 0;
+
+        for (uint32_t begin = 0; begin < count; begin += batch.Capacity)
+        {
+            auto end = (std::min)(begin + batch.Capacity, count);
+            uint32_t batchSize = 0;
+
+            for (auto i = begin; i < end; ++i)
+            {
+                auto point = aPoints.beginPtr[i];
+                if (point <= points[0])
+                {
+                    aResults[i] = values[0];
+                    continue;
+                }
+
+                if (point >= points[size - 1])
+                {
+                    aResults[i] = values[size - 1];
+                    continue;
+                }
+
+                hint = Detail::FindCurveSegment(points, size, point, hint);
+
+                batch.targets[batchSize] = i;
+                Detail::LoadCurveSegment(points, values, size, interpolationType, hint, point, batch.t[batchSize],
+                                         batch.v0[batchSize], batch.v1[batchSize], batch.m0[batchSize],
+                                         batch.m1[batchSize]);
+                batchSize++;
+            }
+
+            if (interpolationType == curve::EInterpolationType::EIT_Linear)
+            {
+                Detail::LerpCurve(batch.v0, batch.v1, batch.t, batch.results, batchSize);
+            }
+            else
+            {
+                Detail::HermiteCurve(batch.v0, batch.v1, batch.m0, batch.m1, batch.t, batch.results, batchSize);
+            }
+
+            for (uint32_t i = 0; i < batchSize; ++i)
+            {
+                aResults[batch.targets[i]] = batch.results[i];
+            }
+        }
+    }
+}
+
 template<typename T>
 RED4EXT_INLINE RED4ext::CurvePoint<T> RED4ext::CurveData<T>::operator[](uint32_t aIndex) const noexcept
 {
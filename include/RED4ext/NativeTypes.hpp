@@ -14,6 +14,7 @@
 #include <RED4ext/InstanceType.hpp>
 #include <RED4ext/NodeRef.hpp>
 #include <RED4ext/ResourceReference.hpp>
+#include <RED4ext/Span.hpp>
 #include <RED4ext/Scripting/Natives/Generated/curve/EInterpolationType.hpp>
 #include <RED4ext/Scripting/Natives/Generated/curve/ESegmentsLinkType.hpp>
 
@@ -258,6 +259,35 @@ struct CurveData
 
     void Resize(uint32_t aNewSize) noexcept;
 
+    /**
+     * @brief Samples the curve, points outside of it are clamped to the first or last key.
+     *
+     * The points of the keys must be sorted. Values that can not be interpolated (e.g. names) use constant
+     * interpolation. The interpolation link type is not taken into account.
+     *
+     * @param aPoint The point.
+     * @return The value.
+     */
+    [[nodiscard]] T Evaluate(float aPoint) const noexcept;
+
+    /**
+     * @brief Samples the curve, the hint makes sequential queries cheaper.
+     * @param aPoint The point.
+     * @param aSegmentHint The segment of the previous query, updated with the segment of this one. Start with 0.
+     * @return The value.
+     */
+    [[nodiscard]] T Evaluate(float aPoint, uint32_t& aSegmentHint) const noexcept;
+
+    /**
+     * @brief Samples the curve at many points, the results are the same as with Evaluate().
+     *
+     * Sorted points are the fastest, any order works.
+     *
+     * @param aPoints The points.
+     * @param aResults Receives one value per point.
+     */
+    void EvaluateMany(Span<const float> aPoints, Span<T> aResults) const noexcept;
+
     [[nodiscard]] inline CurvePoint<T> operator[](uint32_t aIndex) const noexcept;
 
     CName name;                                  // 00
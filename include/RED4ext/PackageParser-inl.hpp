@@ -0,0 +1,464 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/PackageParser.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/StringView.hpp>
+
+namespace RED4ext::Detail
+{
+template<typename T>
+T ReadPackageValue(const uint8_t* aData)
+{
+    // The package data is not guaranteed to be aligned.
+    T value;
+    std::memcpy(&value, aData, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void ReadPackageTable(std::vector<T>& aOut, const uint8_t* aData, uint32_t aCount)
+{
+    // Copied once so that the records can be used in place, e.g. by the spans of the header.
+    aOut.resize(aCount);
+    if (aCount > 0)
+    {
+        std::memcpy(aOut.data(), aData, sizeof(T) * aCount);
+    }
+}
+
+inline std::string_view ReadPackageString(const uint8_t* aData, uint32_t aSize)
+{
+    // The stored size includes the terminator, if there is one.
+    auto str = reinterpret_cast<const char*>(aData);
+    auto end = static_cast<const char*>(std::memchr(str, '\0', aSize));
+    return {str, end ? static_cast<size_t>(end - str) : aSize};
+}
+} // namespace RED4ext::Detail
+
+RED4EXT_INLINE bool RED4ext::PackageParser::Visitor::OnChunk(uint32_t, StringView, const uint8_t*, uint32_t)
+{
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::PackageParser::Visitor::OnField(uint32_t, uint32_t, const Field&)
+{
+}
+
+RED4EXT_INLINE bool RED4ext::PackageParser::Visitor::OnChunkEnd(uint32_t)
+{
+    return true;
+}
+
+RED4EXT_INLINE RED4ext::PackageParser::PackageParser(const void* aBuffer, uint32_t aSize)
+    : m_buffer(static_cast<const uint8_t*>(aBuffer))
+    , m_size(aBuffer ? aSize : 0)
+    , m_data(nullptr)
+    , m_dataSize(0)
+    , m_nameCount(0)
+    , m_importCount(0)
+    , m_chunkCount(0)
+    , m_rootChunkCount(0)
+    , m_chunkDataOffset(0)
+    , m_isParsed(false)
+{
+}
+
+RED4EXT_INLINE RED4ext::PackageParser::PackageParser(const RawBuffer& aBuffer)
+    : PackageParser(aBuffer.data, aBuffer.size)
+{
+}
+
+RED4EXT_INLINE RED4ext::PackageParser::PackageParser(const DataBuffer& aBuffer)
+    : PackageParser(aBuffer.buffer)
+{
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::ParseHeader(PackageHeader& aOut)
+{
+    m_isParsed = false;
+
+    constexpr uint32_t prefixSize = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint32_t);
+    if (m_size < prefixSize)
+    {
+        return PackageParseError::InvalidBuffer;
+    }
+
+    auto version = m_buffer[0];
+    auto flags = m_buffer[1];
+    auto sectionCount = Detail::ReadPackageValue<uint16_t>(m_buffer + 2);
+    auto rootChunkCount = Detail::ReadPackageValue<uint32_t>(m_buffer + 4);
+
+    if (version != SupportedVersion)
+    {
+        return PackageParseError::UnsupportedVersion;
+    }
+
+    // Packages without imports omit the two import offsets.
+    if (sectionCount != 6 && sectionCount != 7)
+    {
+        return PackageParseError::InvalidSection;
+    }
+
+    auto hasImports = sectionCount == 7;
+    auto offsetCount = hasImports ? 6u : 4u;
+    auto headerSize = prefixSize + offsetCount * static_cast<uint32_t>(sizeof(uint32_t));
+    if (m_size < headerSize)
+    {
+        return PackageParseError::InvalidBuffer;
+    }
+
+    uint32_t offsets[6] = {};
+    auto offset = offsets + (hasImports ? 0 : 2);
+    for (auto i = 0u; i < offsetCount; ++i)
+    {
+        offset[i] = Detail::ReadPackageValue<uint32_t>(m_buffer + prefixSize + i * sizeof(uint32_t));
+    }
+
+    m_data = m_buffer + headerSize;
+    m_dataSize = m_size - headerSize;
+
+    // The sections follow each other, the descriptor counts are derived from the distance to the next section.
+    auto importDescOffset = offsets[0];
+    auto importDataOffset = offsets[1];
+    auto nameDescOffset = offsets[2];
+    auto nameDataOffset = offsets[3];
+    auto chunkDescOffset = offsets[4];
+    auto chunkDataOffset = offsets[5];
+
+    if (hasImports)
+    {
+        if (importDescOffset > importDataOffset || importDataOffset > nameDescOffset)
+        {
+            return PackageParseError::InvalidSection;
+        }
+    }
+
+    if (nameDescOffset > nameDataOffset || nameDataOffset > chunkDescOffset || chunkDescOffset > chunkDataOffset ||
+        chunkDataOffset > m_dataSize)
+    {
+        return PackageParseError::InvalidSection;
+    }
+
+    auto importDescSize = importDataOffset - importDescOffset;
+    auto nameDescSize = nameDataOffset - nameDescOffset;
+    auto chunkDescSize = chunkDataOffset - chunkDescOffset;
+    if (importDescSize % sizeof(PackageHeader::Import) != 0 || nameDescSize % sizeof(PackageHeader::Name) != 0 ||
+        chunkDescSize % sizeof(PackageHeader::Chunk) != 0)
+    {
+        return PackageParseError::InvalidSection;
+    }
+
+    m_importCount = importDescSize / sizeof(PackageHeader::Import);
+    m_nameCount = nameDescSize / sizeof(PackageHeader::Name);
+    m_chunkCount = chunkDescSize / sizeof(PackageHeader::Chunk);
+    m_rootChunkCount = rootChunkCount;
+    m_chunkDataOffset = chunkDataOffset;
+
+    if (m_rootChunkCount > m_chunkCount)
+    {
+        return PackageParseError::InvalidChunk;
+    }
+
+    Detail::ReadPackageTable(m_imports, m_data + importDescOffset, m_importCount);
+    Detail::ReadPackageTable(m_names, m_data + nameDescOffset, m_nameCount);
+    Detail::ReadPackageTable(m_chunks, m_data + chunkDescOffset, m_chunkCount);
+
+    auto result = ValidateNames();
+    if (result == PackageParseError::None)
+    {
+        result = ValidateImports();
+    }
+
+    if (result == PackageParseError::None)
+    {
+        result = ValidateChunks();
+    }
+
+    if (result != PackageParseError::None)
+    {
+        return result;
+    }
+
+    aOut.version = version;
+    aOut.unk01 = flags;
+    aOut.unk02 = sectionCount;
+    aOut.root = {m_chunks.data(), m_rootChunkCount};
+    aOut.chunks = {m_chunks.data(), m_chunkCount};
+    aOut.names = {m_names.data(), m_nameCount};
+    aOut.imports = {m_imports.data(), m_importCount};
+    aOut.buffer = const_cast<uint8_t*>(m_data);
+    aOut.size = m_dataSize;
+
+    m_isParsed = true;
+    return PackageParseError::None;
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::Visit(Visitor& aVisitor) const
+{
+    if (!m_isParsed)
+    {
+        return PackageParseError::InvalidBuffer;
+    }
+
+    return VisitRange(aVisitor, 0, m_chunkCount);
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::VisitParallel(Visitor& aVisitor,
+                                                                              uint32_t aThreadCount) const
+{
+    if (!m_isParsed)
+    {
+        return PackageParseError::InvalidBuffer;
+    }
+
+    if (aThreadCount == 0)
+    {
+        aThreadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Not worth spawning threads for a handful of chunks.
+    constexpr uint32_t minChunksPerThread = 16;
+    aThreadCount = (std::min)(aThreadCount, (m_chunkCount + minChunksPerThread - 1) / minChunksPerThread);
+    if (aThreadCount <= 1)
+    {
+        return VisitRange(aVisitor, 0, m_chunkCount);
+    }
+
+    // Chunks are handed out in small batches so that a few large chunks do not stall a single thread.
+    constexpr uint32_t batchSize = 8;
+    std::atomic<uint32_t> next = 0;
+    std::atomic<PackageParseError> error = PackageParseError::None;
+
+    auto worker = [&]()
+    {
+        while (error.load(std::memory_order_relaxed) == PackageParseError::None)
+        {
+            auto begin = next.fetch_add(batchSize, std::memory_order_relaxed);
+            if (begin >= m_chunkCount)
+            {
+                break;
+            }
+
+            auto end = (std::min)(begin + batchSize, m_chunkCount);
+            auto result = VisitRange(aVisitor, begin, end);
+            if (result != PackageParseError::None)
+            {
+                auto expected = PackageParseError::None;
+                error.compare_exchange_strong(expected, result, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(aThreadCount - 1);
+
+    for (auto i = 1u; i < aThreadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return error.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::VisitChunk(Visitor& aVisitor, uint32_t aIndex) const
+{
+    const uint8_t* data;
+    uint32_t size;
+    if (!m_isParsed || !GetChunkData(aIndex, data, size))
+    {
+        return PackageParseError::InvalidChunk;
+    }
+
+    const auto& chunk = m_chunks[aIndex];
+    if (!aVisitor.OnChunk(aIndex, GetName(chunk.typeID), data, size))
+    {
+        return aVisitor.OnChunkEnd(aIndex) ? PackageParseError::None : PackageParseError::Aborted;
+    }
+
+    if (size < sizeof(uint16_t))
+    {
+        return PackageParseError::InvalidField;
+    }
+
+    auto fieldCount = Detail::ReadPackageValue<uint16_t>(data);
+    auto tableSize = sizeof(uint16_t) + fieldCount * ChunkFieldSize;
+    if (tableSize > size)
+    {
+        return PackageParseError::InvalidField;
+    }
+
+    auto table = data + sizeof(uint16_t);
+    for (uint32_t i = 0; i < fieldCount; ++i)
+    {
+        auto entry = table + i * ChunkFieldSize;
+        auto nameIndex = Detail::ReadPackageValue<uint16_t>(entry);
+        auto typeIndex = Detail::ReadPackageValue<uint16_t>(entry + 2);
+        auto valueOffset = Detail::ReadPackageValue<uint32_t>(entry + 4);
+
+        // The values are stored in the same order as the fields, the next field marks the end of the value.
+        auto valueEnd = size;
+        if (i + 1 < fieldCount)
+        {
+            valueEnd = Detail::ReadPackageValue<uint32_t>(entry + ChunkFieldSize + 4);
+        }
+
+        if (nameIndex >= m_nameCount || typeIndex >= m_nameCount || valueOffset < tableSize ||
+            valueOffset > valueEnd || valueEnd > size)
+        {
+            return PackageParseError::InvalidField;
+        }
+
+        Field field;
+        field.name = GetName(nameIndex);
+        field.typeName = GetName(typeIndex);
+        field.data = data + valueOffset;
+        field.size = valueEnd - valueOffset;
+
+        aVisitor.OnField(aIndex, i, field);
+    }
+
+    return aVisitor.OnChunkEnd(aIndex) ? PackageParseError::None : PackageParseError::Aborted;
+}
+
+RED4EXT_INLINE RED4ext::StringView RED4ext::PackageParser::GetName(uint32_t aIndex) const
+{
+    if (aIndex >= m_nameCount)
+    {
+        return {};
+    }
+
+    const auto& name = m_names[aIndex];
+    return Detail::ReadPackageString(m_data + name.offset, name.size);
+}
+
+RED4EXT_INLINE RED4ext::StringView RED4ext::PackageParser::GetImportPath(uint32_t aIndex) const
+{
+    if (aIndex >= m_importCount)
+    {
+        return {};
+    }
+
+    const auto& import = m_imports[aIndex];
+    return Detail::ReadPackageString(m_data + import.offset, import.size);
+}
+
+RED4EXT_INLINE bool RED4ext::PackageParser::IsImportSync(uint32_t aIndex) const
+{
+    if (aIndex >= m_importCount)
+    {
+        return false;
+    }
+
+    const auto& import = m_imports[aIndex];
+    return import.sync;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::PackageParser::GetChunkCount() const
+{
+    return m_chunkCount;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::PackageParser::GetRootChunkCount() const
+{
+    return m_rootChunkCount;
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::ValidateNames()
+{
+    for (uint32_t i = 0; i < m_nameCount; ++i)
+    {
+        const auto& name = m_names[i];
+        if (name.offset > m_dataSize || name.size > m_dataSize - name.offset)
+        {
+            return PackageParseError::InvalidName;
+        }
+    }
+
+    return PackageParseError::None;
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::ValidateImports()
+{
+    for (uint32_t i = 0; i < m_importCount; ++i)
+    {
+        const auto& import = m_imports[i];
+        if (import.offset > m_dataSize || import.size > m_dataSize - import.offset)
+        {
+            return PackageParseError::InvalidImport;
+        }
+    }
+
+    return PackageParseError::None;
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::ValidateChunks()
+{
+    uint32_t previousOffset = m_chunkDataOffset;
+    for (uint32_t i = 0; i < m_chunkCount; ++i)
+    {
+        const auto& chunk = m_chunks[i];
+
+        // Chunks must be sorted so that the extent of a chunk is known without a size.
+        if (chunk.typeID >= m_nameCount || chunk.offset < previousOffset || chunk.offset > m_dataSize)
+        {
+            return PackageParseError::InvalidChunk;
+        }
+
+        previousOffset = chunk.offset;
+    }
+
+    return PackageParseError::None;
+}
+
+RED4EXT_INLINE bool RED4ext::PackageParser::GetChunkData(uint32_t aIndex, const uint8_t*& aData,
+                                                        uint32_t& aSize) const
+{
+    if (aIndex >= m_chunkCount)
+    {
+        return false;
+    }
+
+    const auto& chunk = m_chunks[aIndex];
+
+    auto end = m_dataSize;
+    if (aIndex + 1 < m_chunkCount)
+    {
+        end = m_chunks[aIndex + 1].offset;
+    }
+
+    aData = m_data + chunk.offset;
+    aSize = end - chunk.offset;
+    return true;
+}
+
+RED4EXT_INLINE RED4ext::PackageParseError RED4ext::PackageParser::VisitRange(Visitor& aVisitor, uint32_t aBegin,
+                                                                           uint32_t aEnd) const
+{
+    for (auto i = aBegin; i < aEnd; ++i)
+    {
+        auto result = VisitChunk(aVisitor, i);
+        if (result != PackageParseError::None)
+        {
+            return result;
+        }
+    }
+
+    return PackageParseError::None;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Package.hpp>
+#include <RED4ext/Span.hpp>
+#include <RED4ext/StringView.hpp>
+
+namespace RED4ext
+{
+enum class PackageParseError : uint8_t
+{
+    None,
+    InvalidBuffer,
+    UnsupportedVersion,
+    InvalidSection,
+    InvalidName,
+    InvalidImport,
+    InvalidChunk,
+    InvalidField,
+    Aborted
+};
+
+/**
+ * @brief Native parser for the package format (version 4) that does not call into the game.
+ *
+ * The parser only works on the given bytes and never instantiates objects. Only the name, import and chunk descriptors
+ * are copied, they are not guaranteed to be aligned in the buffer. The offsets and sizes of every section, name,
+ * import, chunk and field are validated before they are used, so it is safe to run on untrusted data.
+ *
+ * Layout of a package, all offsets are relative to the end of the header:
+ *  - header: version (u8), flags (u8), section count (u16), root chunk count (u32), then the section offsets (u32),
+ *    import descriptors and import data (only with 7 sections), name descriptors, name data, chunk descriptors and
+ *    chunk data.
+ *  - chunk: field count (u16), then per field the name index (u16), the type name index (u16) and the offset of the
+ *    value relative to the chunk (u32). A value extends up to the next field or the end of the chunk.
+ */
+class PackageParser
+{
+public:
+    static constexpr uint8_t SupportedVersion = 4;
+
+    struct Field
+    {
+        StringView name;
+        StringView typeName;
+        const uint8_t* data;
+        uint32_t size;
+    };
+
+    /**
+     * @brief Receives the contents of a package without materializing objects.
+     *
+     * When used with VisitParallel the chunk callbacks are called from multiple threads.
+     */
+    class Visitor
+    {
+    public:
+        virtual ~Visitor() = default;
+
+        /**
+         * @brief Called for every chunk before its fields.
+         * @return False to skip the fields of the chunk.
+         */
+        virtual bool OnChunk(uint32_t aIndex, StringView aTypeName, const uint8_t* aData, uint32_t aSize);
+
+        virtual void OnField(uint32_t aChunkIndex, uint32_t aFieldIndex, const Field& aField);
+
+        /**
+         * @brief Called after all fields of a chunk were visited.
+         * @return False to stop visiting.
+         */
+        virtual bool OnChunkEnd(uint32_t aIndex);
+    };
+
+    PackageParser(const void* aBuffer, uint32_t aSize);
+    PackageParser(const RawBuffer& aBuffer);
+    PackageParser(const DataBuffer& aBuffer);
+
+    /**
+     * @brief Parses and validates the header, the name, import and chunk tables.
+     * @param aOut Receives the header. Its spans point into the parser's copies of the descriptors, its buffer into the
+     * parsed buffer, both are valid as long as the parser.
+     * @return PackageParseError::None on success.
+     */
+    PackageParseError ParseHeader(PackageHeader& aOut);
+
+    /**
+     * @brief Visits every chunk and field on the calling thread. ParseHeader must have succeeded.
+     */
+    PackageParseError Visit(Visitor& aVisitor) const;
+
+    /**
+     * @brief Visits the chunks split across multiple threads. ParseHeader must have succeeded.
+     * @param aVisitor The visitor, must be thread-safe.
+     * @param aThreadCount The number of threads, 0 to use the hardware concurrency.
+     */
+    PackageParseError VisitParallel(Visitor& aVisitor, uint32_t aThreadCount = 0) const;
+
+    /**
+     * @brief Validates the field table of a single chunk and visits its fields.
+     */
+    PackageParseError VisitChunk(Visitor& aVisitor, uint32_t aIndex) const;
+
+    StringView GetName(uint32_t aIndex) const;
+    StringView GetImportPath(uint32_t aIndex) const;
+    bool IsImportSync(uint32_t aIndex) const;
+
+    uint32_t GetChunkCount() const;
+    uint32_t GetRootChunkCount() const;
+
+private:
+    static constexpr uint32_t ChunkFieldSize = 8;
+
+    PackageParseError ValidateNames();
+    PackageParseError ValidateImports();
+    PackageParseError ValidateChunks();
+
+    bool GetChunkData(uint32_t aIndex, const uint8_t*& aData, uint32_t& aSize) const;
+    PackageParseError VisitRange(Visitor& aVisitor, uint32_t aBegin, uint32_t aEnd) const;
+
+    const uint8_t* m_buffer;
+    uint32_t m_size;
+
+    // The data following the header, all offsets are relative to it.
+    const uint8_t* m_data;
+    uint32_t m_dataSize;
+
+    std::vector<PackageHeader::Name> m_names;
+    uint32_t m_nameCount;
+    std::vector<PackageHeader::Import> m_imports;
+    uint32_t m_importCount;
+    std::vector<PackageHeader::Chunk> m_chunks;
+    uint32_t m_chunkCount;
+    uint32_t m_rootChunkCount;
+    uint32_t m_chunkDataOffset;
+    bool m_isParsed;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/PackageParser-inl.hpp>
+#endif
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/ThreadPool.hpp>
+
+namespace RED4ext
+{
+namespace Detail
+{
+/**
+ * @brief Splits [begin, end) into chunks of grain indices, the last chunk takes the remainder.
+ */
+template<std::integral I>
+struct ParallelChunks
+{
+    using Unsigned = std::make_unsigned_t<I>;
+
+    ParallelChunks(I aBegin, I aEnd, I aGrain) noexcept
+        : begin(aBegin)
+        , end(aEnd)
+        , grain(aGrain > 0 ? static_cast<Unsigned>(aGrain) : 1)
+        , count(0)
+    {
+        if (aBegin < aEnd)
+        {
+            // The difference is computed unsigned, it does not fit into a signed type for the whole range.
+            auto size = static_cast<Unsigned>(static_cast<Unsigned>(aEnd) - static_cast<Unsigned>(aBegin));
+            count = static_cast<size_t>(size / grain + (size % grain != 0));
+        }
+    }
+
+    I GetBegin(size_t aChunk) const noexcept
+    {
+        return static_cast<I>(static_cast<Unsigned>(begin) + static_cast<Unsigned>(aChunk) * grain);
+    }
+
+    I GetEnd(size_t aChunk) const noexcept
+    {
+        return aChunk + 1 < count ? GetBegin(aChunk + 1) : end;
+    }
+
+    I begin;
+    I end;
+    Unsigned grain;
+    size_t count;
+};
+
+template<std::integral I, typename F>
+struct ParallelForState
+{
+    void RunChunk(size_t aChunk)
+    {
+        for (auto i = chunks.GetBegin(aChunk), end = chunks.GetEnd(aChunk); i < end; ++i)
+        {
+            function(i);
+        }
+    }
+
+    ParallelChunks<I> chunks;
+    F function;
+};
+
+template<std::integral I, typename T, typename Map, typename Reduce>
+struct ParallelReduceState
+{
+    // Every chunk writes its own cache line.
+    struct alignas(64) Partial
+    {
+        T value;
+    };
+
+    ParallelReduceState(ParallelChunks<I> aChunks, T aIdentity, Map aMap, Reduce aReduce)
+        : chunks(aChunks)
+        , identity(std::move(aIdentity))
+        , map(std::forward<Map>(aMap))
+        , reduce(std::forward<Reduce>(aReduce))
+        , partials(aChunks.count, Partial{identity})
+    {
+    }
+
+    void RunChunk(size_t aChunk)
+    {
+        T value = identity;
+        for (auto i = chunks.GetBegin(aChunk), end = chunks.GetEnd(aChunk); i < end; ++i)
+        {
+            value = reduce(std::move(value), map(i));
+        }
+
+        partials[aChunk].value = std::move(value);
+    }
+
+    /**
+     * @brief Reduces the partial results in the order of the chunks, the result does not depend on the scheduling.
+     */
+    T Combine()
+    {
+        T result = identity;
+        for (auto& partial : partials)
+        {
+            result = reduce(std::move(result), std::move(partial.value));
+        }
+
+        return result;
+    }
+
+    ParallelChunks<I> chunks;
+    T identity;
+    Map map;
+    Reduce reduce;
+    std::vector<Partial> partials;
+};
+
+/**
+ * @brief The state of a loop that runs on the job system, the jobs take its chunks from a shared counter.
+ */
+template<typename State>
+struct ParallelJobs
+{
+    template<typename... Args>
+    explicit ParallelJobs(Args&&... aArgs)
+        : state{std::forward<Args>(aArgs)...}
+        , nextChunk(0)
+    {
+    }
+
+    State state;
+    std::atomic<size_t> nextChunk;
+};
+
+/**
+ * @brief The job that runs chunks of a parallel loop until none is left.
+ */
+template<typename State>
+struct ParallelChunkJob
+{
+    void operator()() const
+    {
+        auto count = jobs->state.chunks.count;
+        for (auto chunk = jobs->nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < count;
+             chunk = jobs->nextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            jobs->state.RunChunk(chunk);
+        }
+    }
+
+    std::shared_ptr<ParallelJobs<State>> jobs;
+};
+
+/**
+ * @brief The job that passes the result of a parallel reduction on, it runs after every chunk.
+ */
+template<typename State, typename Done>
+struct ParallelDoneJob
+{
+    void operator()()
+    {
+        done(jobs->state.Combine());
+    }
+
+    std::shared_ptr<ParallelJobs<State>> jobs;
+    Done done;
+};
+
+/**
+ * @brief Returns the number of jobs a loop is split into, one per hardware thread but not more than chunks.
+ */
+inline size_t GetParallelJobCount(size_t aChunkCount) noexcept
+{
+    return (std::min)(aChunkCount, static_cast<size_t>((std::max)(std::thread::hardware_concurrency(), 1u)));
+}
+
+/**
+ * @brief Dispatches the jobs of a loop and adds a single waiting point for all of them to the queue.
+ */
+template<typename State>
+void DispatchChunks(JobQueue& aQueue, const std::shared_ptr<ParallelJobs<State>>& aJobs)
+{
+    // Jobs of one queue run one after another, so every job gets a queue of its own. There is a job per thread rather
+    // than per chunk, a job that starts late finds the chunks taken by the others and returns.
+    auto dispatch = [&aJobs]
+    {
+        JobQueue queue;
+        queue.Dispatch(ParallelChunkJob<State>{aJobs});
+        return queue.Capture();
+    };
+
+    auto handle = dispatch();
+    for (size_t job = 1, count = GetParallelJobCount(aJobs->state.chunks.count); job < count; ++job)
+    {
+        handle.Join(dispatch());
+    }
+
+    aQueue.Wait(handle);
+}
+} // namespace Detail
+
+/**
+ * @brief Calls the function for every index in [aBegin, aEnd) from jobs of the game's job system.
+ *
+ * The range is split into chunks of aGrain indices. Up to one job per hardware thread is dispatched, each on a queue
+ * of its own, and the jobs take the chunks one after another until none is left. The function returns once all jobs
+ * are dispatched, the jobs that are added to the queue afterwards run after all chunks completed. A range
+ * that fits into a single chunk runs on the calling thread before the function returns.
+ *
+ * @param aQueue The queue that waits for the loop, usually the one passed to an update callback.
+ * @param aGrain The number of indices per job, it should be large enough to hide the cost of dispatching a job.
+ * @param aFunction The function, it is copied and called concurrently from several threads.
+ *
+ * @example
+ *
+ * aRegistrar->RegisterUpdate(RED4ext::UpdateTickGroup::EntityUpdateState, this, "MySystem/Entities",
+ *                            [this](RED4ext::FrameInfo& aFrame, RED4ext::JobQueue& aJobQueue)
+ *                            {
+ *                                // The chunks run after the callback returned, aFrame must not be captured.
+ *                                RED4ext::ParallelFor(aJobQueue, 0, m_entities.size(), 256,
+ *                                                     [this, deltaTime = aFrame.deltaTime](size_t aIndex)
+ *                                                     { Update(aIndex, deltaTime); });
+ *                            });
+ */
+template<std::integral I, typename F>
+requires std::is_invocable_v<std::decay_t<F>&, I>
+void ParallelFor(JobQueue& aQueue, std::type_identity_t<I> aBegin, I aEnd, std::type_identity_t<I> aGrain,
+                 F&& aFunction)
+{
+    Detail::ParallelChunks<I> chunks(aBegin, aEnd, aGrain);
+    if (chunks.count <= 1)
+    {
+        for (auto i = aBegin; i < aEnd; ++i)
+        {
+            aFunction(i);
+        }
+
+        return;
+    }
+
+    using State = Detail::ParallelForState<I, std::decay_t<F>>;
+    Detail::DispatchChunks(aQueue, std::make_shared<Detail::ParallelJobs<State>>(chunks, std::forward<F>(aFunction)));
+}
+
+/**
+ * @brief Calls the function for every index in [aBegin, aEnd) on the threads of the pool and waits for all calls.
+ * @see ParallelFor(JobQueue&, ...)
+ */
+template<std::integral I, typename F>
+requires std::is_invocable_v<F&, I>
+void ParallelFor(ThreadPool& aPool, std::type_identity_t<I> aBegin, I aEnd, std::type_identity_t<I> aGrain,
+                 F&& aFunction)
+{
+    Detail::ParallelForState<I, F&> state{{aBegin, aEnd, aGrain}, aFunction};
+    aPool.Run(state.chunks.count, [&state](size_t aChunk) { state.RunChunk(aChunk); });
+}
+
+/**
+ * @brief Maps every index in [aBegin, aEnd) to a value and reduces the values, using jobs of the game's job system.
+ *
+ * Every chunk reduces its values starting with aIdentity, the results of the chunks are reduced in order by a job
+ * that is added to the queue after the waiting point for the chunks. That job passes the result to aDone. The
+ * reduction has to be associative, it does not have to be commutative.
+ *
+ * @param aMap The function that turns an index into a value, T(I).
+ * @param aReduce The function that combines two values, T(T, T).
+ * @param aDone The function that receives the result, void(T).
+ *
+ * @example
+ *
+ * RED4ext::ParallelReduce(
+ *     aJobQueue, 0, m_entities.size(), 1024, 0.0f, [this](size_t aIndex) { return GetDamage(aIndex); },
+ *     [](float aLhs, float aRhs) { return aLhs + aRhs; }, [this](float aTotal) { m_totalDamage = aTotal; });
+ */
+template<std::integral I, typename T, typename Map, typename Reduce, typename Done>
+requires std::is_invocable_r_v<T, std::decay_t<Map>&, I> &&
+         std::is_invocable_r_v<T, std::decay_t<Reduce>&, T, T> && std::is_invocable_v<std::decay_t<Done>&, T>
+void ParallelReduce(JobQueue& aQueue, std::type_identity_t<I> aBegin, I aEnd, std::type_identity_t<I> aGrain,
+                    T aIdentity, Map&& aMap, Reduce&& aReduce, Done&& aDone)
+{
+    Detail::ParallelChunks<I> chunks(aBegin, aEnd, aGrain);
+
+    using State = Detail::ParallelReduceState<I, T, std::decay_t<Map>, std::decay_t<Reduce>>;
+    auto jobs = std::make_shared<Detail::ParallelJobs<State>>(chunks, std::move(aIdentity), std::forward<Map>(aMap),
+                                                              std::forward<Reduce>(aReduce));
+
+    if (chunks.count <= 1)
+    {
+        if (chunks.count)
+        {
+            jobs->state.RunChunk(0);
+        }
+
+        aDone(jobs->state.Combine());
+        return;
+    }
+
+    Detail::DispatchChunks(aQueue, jobs);
+    aQueue.Dispatch(Detail::ParallelDoneJob<State, std::decay_t<Done>>{jobs, std::forward<Done>(aDone)});
+}
+
+/**
+ * @brief Maps every index in [aBegin, aEnd) to a value and reduces the values on the threads of the pool.
+ * @see ParallelReduce(JobQueue&, ...)
+ *
+ * @return The result.
+ */
+template<std::integral I, typename T, typename Map, typename Reduce>
+requires std::is_invocable_r_v<T, Map&, I> && std::is_invocable_r_v<T, Reduce&, T, T>
+T ParallelReduce(ThreadPool& aPool, std::type_identity_t<I> aBegin, I aEnd, std::type_identity_t<I> aGrain,
+                 T aIdentity, Map&& aMap, Reduce&& aReduce)
+{
+    Detail::ParallelReduceState<I, T, Map&, Reduce&> state({aBegin, aEnd, aGrain}, std::move(aIdentity), aMap,
+                                                           aReduce);
+
+    aPool.Run(state.chunks.count, [&state](size_t aChunk) { state.RunChunk(aChunk); });
+    return state.Combine();
+}
+} // namespace RED4ext
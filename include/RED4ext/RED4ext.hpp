@@ -20,6 +20,9 @@
 #include <RED4ext/Memory/UniquePtr.hpp>
 
 #include <RED4ext/IO/BaseStream.hpp>
+#include <RED4ext/IO/BufferedWriteStream.hpp>
+#include <RED4ext/IO/MappedFileStream.hpp>
+#include <RED4ext/IO/MemoryStream.hpp>
 
 #include <RED4ext/ISerializable.hpp>
 #include <RED4ext/Scripting/IScriptable.hpp>
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/RTTINameCache.hpp>
+#endif
+
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+
+#include <RED4ext/CNamePool.hpp>
+#include <RED4ext/RTTITypes.hpp>
+
+RED4EXT_INLINE RED4ext::CName RED4ext::RTTINameCache::GetComputedName(const CBaseRTTIType* aType)
+{
+    return Get(aType).name;
+}
+
+RED4EXT_INLINE RED4ext::StringView RED4ext::RTTINameCache::GetComputedNameView(const CBaseRTTIType* aType)
+{
+    auto entry = Get(aType);
+
+    StringView view;
+    view.ptr = entry.str;
+    view.length = entry.length;
+
+    return view;
+}
+
+RED4EXT_INLINE void RED4ext::RTTINameCache::Invalidate(const CBaseRTTIType* aType)
+{
+    auto& shard = GetShard(aType);
+
+    std::lock_guard<SharedSpinLock> _(shard.lock);
+    shard.entries.erase(aType);
+}
+
+RED4EXT_INLINE void RED4ext::RTTINameCache::Clear()
+{
+    auto shards = GetShards();
+    for (uint32_t i = 0; i < ShardCount; i++)
+    {
+        auto& shard = shards[i];
+
+        std::lock_guard<SharedSpinLock> _(shard.lock);
+        shard.entries.clear();
+    }
+}
+
+RED4EXT_INLINE RED4ext::RTTINameCache::Shard* RED4ext::RTTINameCache::GetShards()
+{
+    static Shard shards[ShardCount];
+    return shards;
+}
+
+RED4EXT_INLINE RED4ext::RTTINameCache::Shard& RED4ext::RTTINameCache::GetShard(const CBaseRTTIType* aType)
+{
+    // Types are at least 16 bytes aligned, skip the bits that are always zero.
+    auto index = (reinterpret_cast<uintptr_t>(aType) >> 4) & (ShardCount - 1);
+    return GetShards()[index];
+}
+
+RED4EXT_INLINE RED4ext::RTTINameCache::Entry RED4ext::RTTINameCache::Resolve(const CBaseRTTIType* aType)
+{
+    Entry entry{};
+    entry.name = aType->GetComputedName();
+
+    // The name pool never frees its strings, so the pointer stays valid for the lifetime of the process.
+    entry.str = entry.name.IsNone() ? nullptr : CNamePool::Get(entry.name);
+    if (!entry.str)
+    {
+        entry.str = "None";
+    }
+
+    entry.length = static_cast<uint32_t>(std::strlen(entry.str));
+    return entry;
+}
+
+RED4EXT_INLINE RED4ext::RTTINameCache::Entry RED4ext::RTTINameCache::Get(const CBaseRTTIType* aType)
+{
+    if (!aType)
+    {
+        return {CName(), "None", 4};
+    }
+
+    auto& shard = GetShard(aType);
+
+    {
+        std::shared_lock<SharedSpinLock> _(shard.lock);
+
+        auto it = shard.entries.find(aType);
+        if (it != shard.entries.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Resolve outside of the lock, computing the name might call back into the RTTI system.
+    auto entry = Resolve(aType);
+
+    std::lock_guard<SharedSpinLock> _(shard.lock);
+    return shard.entries.try_emplace(aType, entry).first->second;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <RED4ext/CName.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/SharedSpinLock.hpp>
+#include <RED4ext/StringView.hpp>
+
+namespace RED4ext
+{
+struct CBaseRTTIType;
+
+/**
+ * @brief Memoizes the computed names of RTTI types.
+ *
+ * Computing the name of a type is expensive for some types (e.g. arrays and handles format the name of the inner type
+ * and add the result to the name pool on every call). The cache resolves the name once per type and keeps the hash
+ * together with the interned string. Lookups only take a shared lock on one of the shards, so concurrent readers do
+ * not contend with each other.
+ */
+class RTTINameCache
+{
+public:
+    struct Entry
+    {
+        CName name;
+        const char* str;
+        uint32_t length;
+    };
+
+    /**
+     * @brief Returns the computed name of the type.
+     * @param aType The type.
+     * @return The computed name, or "None" if the type is null.
+     */
+    static CName GetComputedName(const CBaseRTTIType* aType);
+
+    /**
+     * @brief Returns the computed name of the type as a string interned in the name pool.
+     * @param aType The type.
+     * @return The name, never null.
+     */
+    static StringView GetComputedNameView(const CBaseRTTIType* aType);
+
+    /**
+     * @brief Removes the type from the cache, must be called before a type is unregistered or renamed.
+     * @param aType The type.
+     */
+    static void Invalidate(const CBaseRTTIType* aType);
+
+    /**
+     * @brief Removes every type from the cache.
+     */
+    static void Clear();
+
+private:
+    static constexpr uint32_t ShardCount = 16;
+
+    struct Shard
+    {
+        SharedSpinLock lock;
+        std::unordered_map<const CBaseRTTIType*, Entry> entries;
+    };
+
+    static Shard* GetShards();
+    static Shard& GetShard(const CBaseRTTIType* aType);
+    static Entry Resolve(const CBaseRTTIType* aType);
+    static Entry Get(const CBaseRTTIType* aType);
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/RTTINameCache-inl.hpp>
+#endif
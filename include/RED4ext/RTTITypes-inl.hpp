@@ -9,6 +9,7 @@
 #include <RED4ext/Relocation.hpp>
 #include <RED4ext/Scripting/CProperty.hpp>
 #include <RED4ext/Scripting/Functions.hpp>
+#include <RED4ext/StringView.hpp>
 
 RED4EXT_INLINE RED4ext::CBaseRTTIType::CBaseRTTIType()
     : unk8(0)
@@ -16,6 +17,11 @@ RED4EXT_INLINE RED4ext::CBaseRTTIType::CBaseRTTIType()
 }
 
 RED4EXT_INLINE RED4ext::CString RED4ext::CBaseRTTIType::GetTypeName() const
+{
+    return GetTypeNameView().Data();
+}
+
+RED4EXT_INLINE RED4ext::StringView RED4ext::CBaseRTTIType::GetTypeNameView() const
 {
     switch (GetType())
     {
@@ -9,6 +9,7 @@
 #include <RED4ext/HashMap.hpp>
 #include <RED4ext/InstanceType.hpp>
 #include <RED4ext/Map.hpp>
+#include <RED4ext/StringView.hpp>
 #include <RED4ext/Utils.hpp>
 
 namespace RED4ext
@@ -71,6 +72,12 @@ struct CBaseRTTIType
     virtual void sub_B0(int64_t a1, int64_t a2);                                                   // B0
     virtual Memory::IAllocator* GetAllocator() const;                                              // B8
 
+    /**
+     * @brief Returns the name of the RTTI kind (e.g. "RT_Class") without allocating.
+     * @return A view to a static string.
+     */
+    StringView GetTypeNameView() const;
+
     [[deprecated("Use 'GetName()' instead.")]]
     inline void GetName(CName& aOut) const
     {
@@ -0,0 +1,167 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/RawBufferBuilder.hpp>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+RED4EXT_INLINE RED4ext::RawBufferBuilder::RawBufferBuilder(Memory::IAllocator* aAllocator, uint32_t aAlignment)
+    : m_allocator(aAllocator ? aAllocator : RawBuffer::AllocatorType::Get())
+    , m_alignment(aAlignment)
+{
+    Reset();
+}
+
+RED4EXT_INLINE RED4ext::RawBufferBuilder::~RawBufferBuilder()
+{
+    if (m_data && !IsInline())
+    {
+        m_allocator->Free(m_data);
+    }
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::Reserve(uint32_t aCapacity)
+{
+    return aCapacity <= m_capacity || Grow(aCapacity);
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::Append(Span<const uint8_t> aData)
+{
+    return Append(aData.beginPtr, static_cast<uint32_t>(aData.GetSize()));
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::Append(const void* aData, uint32_t aSize)
+{
+    uint64_t end = static_cast<uint64_t>(m_size) + aSize;
+    if (end > m_capacity && !Grow(end))
+    {
+        return false;
+    }
+
+    if (aSize)
+    {
+        std::memcpy(m_data + m_size, aData, aSize);
+        m_size = static_cast<uint32_t>(end);
+    }
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::RawBufferBuilder::Clear()
+{
+    m_size = 0;
+}
+
+RED4EXT_INLINE uint8_t* RED4ext::RawBufferBuilder::GetData()
+{
+    return m_data;
+}
+
+RED4EXT_INLINE const uint8_t* RED4ext::RawBufferBuilder::GetData() const
+{
+    return m_data;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::RawBufferBuilder::GetSize() const
+{
+    return m_size;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::RawBufferBuilder::GetCapacity() const
+{
+    return m_capacity;
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::IsInline() const
+{
+    return m_data == m_inline;
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::MoveTo(RawBuffer& aBuffer)
+{
+    if (aBuffer.data || m_size == 0)
+    {
+        return false;
+    }
+
+    if (IsInline())
+    {
+        auto data = m_allocator->AllocAligned(m_size, m_alignment).memory;
+        if (!data)
+        {
+            return false;
+        }
+
+        std::memcpy(data, m_data, m_size);
+        aBuffer.TakeOwnership(data, m_size, m_allocator, m_alignment);
+    }
+    else
+    {
+        aBuffer.TakeOwnership(m_data, m_size, m_allocator, m_alignment);
+    }
+
+    Reset();
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::MoveTo(DataBuffer& aBuffer)
+{
+    return MoveTo(aBuffer.buffer);
+}
+
+RED4EXT_INLINE bool RED4ext::RawBufferBuilder::Grow(uint64_t aCapacity)
+{
+    // RawBuffer stores its size as 32 bits.
+    if (aCapacity > UINT32_MAX)
+    {
+        return false;
+    }
+
+    auto capacity = (std::max)(aCapacity, static_cast<uint64_t>(m_capacity) * 2);
+    capacity = (std::min)(capacity, static_cast<uint64_t>(UINT32_MAX));
+
+    uint8_t* data;
+    if (IsInline() || !m_data)
+    {
+        data = static_cast<uint8_t*>(m_allocator->AllocAligned(capacity, m_alignment).memory);
+        if (data && m_size)
+        {
+            std::memcpy(data, m_data, m_size);
+        }
+    }
+    else
+    {
+        // The allocator might be able to extend the block in place.
+        Memory::AllocationResult allocation{m_data, m_capacity};
+        data = static_cast<uint8_t*>(m_allocator->ReallocAligned(allocation, capacity, m_alignment).memory);
+    }
+
+    if (!data)
+    {
+        return false;
+    }
+
+    m_data = data;
+    m_capacity = static_cast<uint32_t>(capacity);
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::RawBufferBuilder::Reset()
+{
+    m_size = 0;
+
+    // The inline storage is only as aligned as the builder itself.
+    if (m_alignment <= alignof(RawBufferBuilder))
+    {
+        m_data = m_inline;
+        m_capacity = InlineCapacity;
+    }
+    else
+    {
+        m_data = nullptr;
+        m_capacity = 0;
+    }
+}
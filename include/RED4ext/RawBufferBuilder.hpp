@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Builds the contents of a RawBuffer by appending to it.
+ *
+ * RawBuffer only knows its size, growing it one append at a time reallocates every time. The builder keeps a capacity
+ * and grows it geometrically, small payloads never leave its inline storage. When done, MoveTo() hands the memory
+ * over to a buffer without copying it.
+ */
+class RawBufferBuilder
+{
+public:
+    static constexpr uint32_t InlineCapacity = 64;
+
+    /**
+     * @param aAllocator The allocator used for the memory, the engine allocator if null.
+     * @param aAlignment The alignment of the memory.
+     */
+    explicit RawBufferBuilder(Memory::IAllocator* aAllocator = nullptr, uint32_t aAlignment = 8);
+    RawBufferBuilder(const RawBufferBuilder&) = delete;
+    RawBufferBuilder& operator=(const RawBufferBuilder&) = delete;
+    ~RawBufferBuilder();
+
+    /**
+     * @brief Makes sure that the builder can hold at least the given number of bytes without growing.
+     * @return False if the memory could not be allocated.
+     */
+    bool Reserve(uint32_t aCapacity);
+
+    bool Append(Span<const uint8_t> aData);
+    bool Append(const void* aData, uint32_t aSize);
+
+    /**
+     * @brief Forgets the contents, keeps the memory.
+     */
+    void Clear();
+
+    [[nodiscard]] uint8_t* GetData();
+    [[nodiscard]] const uint8_t* GetData() const;
+    [[nodiscard]] uint32_t GetSize() const;
+    [[nodiscard]] uint32_t GetCapacity() const;
+    [[nodiscard]] bool IsInline() const;
+
+    /**
+     * @brief Moves the contents to the buffer, the builder is empty afterwards.
+     *
+     * Allocated memory is handed over as is, including the unused capacity. Inline contents are copied to an allocation
+     * of their exact size.
+     *
+     * @param aBuffer The buffer, it must not hold any data.
+     * @return False if the buffer already holds data or the memory could not be allocated.
+     */
+    bool MoveTo(RawBuffer& aBuffer);
+    bool MoveTo(DataBuffer& aBuffer);
+
+private:
+    bool Grow(uint64_t aCapacity);
+    void Reset();
+
+    Memory::IAllocator* m_allocator;
+    uint8_t* m_data;
+    uint32_t m_size;
+    uint32_t m_capacity;
+    uint32_t m_alignment;
+    alignas(16) uint8_t m_inline[InlineCapacity];
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/RawBufferBuilder-inl.hpp>
+#endif
@@ -34,6 +34,14 @@ RED4EXT_INLINE uintptr_t RED4ext::RelocBase::GetImageBase()
 RED4EXT_INLINE
 uintptr_t RED4ext::UniversalRelocBase::Resolve(uint32_t aHash)
 {
+    if (const auto resolveOverride = GetResolveOverride())
+    {
+        if (const auto address = resolveOverride(aHash))
+        {
+            return address;
+        }
+    }
+
 #if !defined(_WIN32) && !defined(_WIN64)
     // MARKER: This is TweakXL's modified SDK Resolve function
     static bool firstCall = true;
@@ -117,6 +125,23 @@ uintptr_t RED4ext::UniversalRelocBase::Resolve(uint32_t aHash)
 #endif
 }
 
+RED4EXT_INLINE RED4ext::UniversalRelocBase::ResolveOverrideFunc_t RED4ext::UniversalRelocBase::SetResolveOverride(
+    ResolveOverrideFunc_t aFunc)
+{
+    auto& func = GetResolveOverride();
+
+    const auto previous = func;
+    func = aFunc;
+
+    return previous;
+}
+
+RED4EXT_INLINE RED4ext::UniversalRelocBase::ResolveOverrideFunc_t& RED4ext::UniversalRelocBase::GetResolveOverride()
+{
+    static ResolveOverrideFunc_t func = nullptr;
+    return func;
+}
+
 RED4EXT_INLINE HMODULE RED4ext::UniversalRelocBase::GetRED4extModule()
 {
 #if defined(_WIN32) || defined(_WIN64)
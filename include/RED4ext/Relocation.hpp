@@ -89,8 +89,19 @@ private:
 class UniversalRelocBase
 {
 public:
+    using ResolveOverrideFunc_t = std::uintptr_t (*)(std::uint32_t);
+
     static uintptr_t Resolve(uint32_t aHash);
 
+    /**
+     * @brief Sets a function that is asked first for every address, e.g. to provide native implementations when the
+     * SDK is used outside of the game. If it returns zero, the address is resolved as usual.
+     *
+     * @note Resolved addresses are cached, set the function before any address is used.
+     * @return The previously set function.
+     */
+    static ResolveOverrideFunc_t SetResolveOverride(ResolveOverrideFunc_t aFunc);
+
 private:
     using QueryFunc_t = void (*)(PluginInfo*);
     using ResolveFunc_t = std::uintptr_t (*)(std::uint32_t);
@@ -99,6 +110,7 @@ private:
 
     static ResolveFunc_t InitializeAddressResolverFunction();
     static ResolveFunc_t GetAddressResolverFunction();
+    static ResolveOverrideFunc_t& GetResolveOverride();
 
     static HMODULE GetCurrentModuleHandle();
     static std::filesystem::path GetCurrentModulePath();
@@ -0,0 +1,427 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/ResourceExistenceIndex.hpp>
+#endif
+
+#include <RED4ext/ArchiveReader.hpp>
+#include <RED4ext/ResourceDepot.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
+
+RED4EXT_INLINE RED4ext::ResourceExistenceIndex::ResourceExistenceIndex()
+    : m_capacity(0)
+{
+}
+
+RED4EXT_INLINE uint32_t RED4ext::ResourceExistenceIndex::AddDepot(const ResourceDepot* aDepot)
+{
+    if (!aDepot)
+    {
+        return 0;
+    }
+
+    // Collect the files of every archive first, rebuilding after each archive would copy the whole set every time.
+    std::vector<uint64_t> hashes;
+
+    uint32_t count = 0;
+    for (const auto& group : aDepot->groups)
+    {
+        for (const auto& archive : group.archives)
+        {
+            if (ReadArchive(archive.path.c_str(), hashes))
+            {
+                count++;
+            }
+        }
+    }
+
+    if (!hashes.empty())
+    {
+        std::lock_guard<SharedSpinLock> _(m_lock);
+        RebuildUnlocked(&hashes);
+    }
+
+    return count;
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::AddArchive(const std::filesystem::path& aPath)
+{
+    std::vector<uint64_t> hashes;
+    if (!ReadArchive(aPath, hashes))
+    {
+        return false;
+    }
+
+    std::lock_guard<SharedSpinLock> _(m_lock);
+    RebuildUnlocked(&hashes);
+
+    return true;
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::Add(ResourcePath aPath)
+{
+    std::lock_guard<SharedSpinLock> _(m_lock);
+    AddUnlocked(aPath.hash);
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::Add(Span<const ResourcePath> aPaths)
+{
+    std::vector<uint64_t> hashes;
+    hashes.reserve(aPaths.GetSize());
+
+    for (auto path : aPaths)
+    {
+        hashes.push_back(path.hash);
+    }
+
+    std::lock_guard<SharedSpinLock> _(m_lock);
+
+    // Adding the paths one by one would merge the pending list several times, rebuild once instead.
+    if (hashes.size() > MinPendingMerge)
+    {
+        RebuildUnlocked(&hashes);
+    }
+    else
+    {
+        for (auto hash : hashes)
+        {
+            AddUnlocked(hash);
+        }
+    }
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::Contains(ResourcePath aPath) const
+{
+    std::shared_lock<SharedSpinLock> _(m_lock);
+    return ContainsUnlocked(aPath.hash);
+}
+
+RED4EXT_INLINE size_t RED4ext::ResourceExistenceIndex::Contains(const ResourcePath* aPaths, bool* aResults,
+                                                                size_t aCount) const
+{
+    std::shared_lock<SharedSpinLock> _(m_lock);
+
+    // Filter everything first, the filter is small and likely to stay in cache, then confirm the possible positives.
+    for (size_t i = 0; i < aCount; ++i)
+    {
+        aResults[i] = MayContainUnlocked(aPaths[i].hash);
+    }
+
+    size_t count = 0;
+    size_t candidates[SearchGroupSize];
+    size_t candidateCount = 0;
+
+    for (size_t i = 0; i < aCount; ++i)
+    {
+        if (aResults[i])
+        {
+            candidates[candidateCount++] = i;
+            if (candidateCount == SearchGroupSize)
+            {
+                count += ConfirmUnlocked(aPaths, aResults, candidates, candidateCount);
+                candidateCount = 0;
+            }
+        }
+    }
+
+    return count + ConfirmUnlocked(aPaths, aResults, candidates, candidateCount);
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::MayContain(ResourcePath aPath) const
+{
+    std::shared_lock<SharedSpinLock> _(m_lock);
+    return MayContainUnlocked(aPath.hash);
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::Rebuild()
+{
+    std::lock_guard<SharedSpinLock> _(m_lock);
+    RebuildUnlocked();
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::Clear()
+{
+    std::lock_guard<SharedSpinLock> _(m_lock);
+
+    m_blocks.clear();
+    m_blocks.shrink_to_fit();
+    m_capacity = 0;
+    m_layout.clear();
+    m_layout.shrink_to_fit();
+    m_pending.clear();
+    m_pending.shrink_to_fit();
+}
+
+RED4EXT_INLINE size_t RED4ext::ResourceExistenceIndex::GetSize() const
+{
+    std::shared_lock<SharedSpinLock> _(m_lock);
+    return GetSizeUnlocked();
+}
+
+RED4EXT_INLINE size_t RED4ext::ResourceExistenceIndex::GetMemoryUsage() const
+{
+    std::shared_lock<SharedSpinLock> _(m_lock);
+    return m_blocks.capacity() * sizeof(Block) + m_layout.capacity() * sizeof(uint64_t) +
+           m_pending.capacity() * sizeof(uint64_t);
+}
+
+RED4EXT_INLINE double RED4ext::ResourceExistenceIndex::EstimateFalsePositiveRate() const
+{
+    std::shared_lock<SharedSpinLock> _(m_lock);
+
+    if (m_blocks.empty())
+    {
+        return 0.0;
+    }
+
+    // A query hits one block and tests one bit per word, the chance that all of them are set is the product of the fill
+    // ratio of the words.
+    double sum = 0.0;
+    for (const auto& block : m_blocks)
+    {
+        double probability = 1.0;
+        for (auto word : block.words)
+        {
+            probability *= std::popcount(word) / 64.0;
+        }
+
+        sum += probability;
+    }
+
+    return sum / m_blocks.size();
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::ReadArchive(const std::filesystem::path& aPath,
+                                                                 std::vector<uint64_t>& aHashes)
+{
+    ArchiveReader reader;
+    if (!reader.Open(aPath))
+    {
+        return false;
+    }
+
+    aHashes.reserve(aHashes.size() + reader.GetFiles().GetSize());
+    for (const auto& file : reader.GetFiles())
+    {
+        aHashes.push_back(file.path.hash);
+    }
+
+    return true;
+}
+
+RED4EXT_INLINE uint64_t RED4ext::ResourceExistenceIndex::GetBlockIndex(uint64_t aHash, size_t aBlockCount)
+{
+    // Maps the folded hash to [0, aBlockCount) without a division, the block count does not need to be a power of two.
+    auto key = (aHash ^ (aHash >> 32)) & 0xFFFFFFFF;
+    return (key * aBlockCount) >> 32;
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::SetBits(Block& aBlock, uint64_t aHash)
+{
+    // One bit per word, selected by 6 bits of the mixed hash. The upper bits of the product depend on the whole hash.
+    auto bits = (aHash * 0x9E3779B97F4A7C15ull) >> 16;
+    for (auto& word : aBlock.words)
+    {
+        word |= 1ull << (bits & 63);
+        bits >>= 6;
+    }
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::TestBits(const Block& aBlock, uint64_t aHash)
+{
+    auto bits = (aHash * 0x9E3779B97F4A7C15ull) >> 16;
+
+    // Test every word without branching, the compiler can vectorize this.
+    uint64_t missing = 0;
+    for (auto word : aBlock.words)
+    {
+        missing |= ~word & (1ull << (bits & 63));
+        bits >>= 6;
+    }
+
+    return missing == 0;
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::AddUnlocked(uint64_t aHash)
+{
+    if (ContainsUnlocked(aHash))
+    {
+        return;
+    }
+
+    auto it = std::lower_bound(m_pending.begin(), m_pending.end(), aHash);
+    m_pending.insert(it, aHash);
+
+    auto layoutSize = m_layout.empty() ? 0 : m_layout.size() - 1;
+    if (GetSizeUnlocked() > m_capacity || m_pending.size() > (std::max)(static_cast<size_t>(MinPendingMerge),
+                                                                         layoutSize / 8))
+    {
+        RebuildUnlocked();
+    }
+    else
+    {
+        SetBits(m_blocks[GetBlockIndex(aHash, m_blocks.size())], aHash);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::RebuildUnlocked(std::vector<uint64_t>* aHashes)
+{
+    std::vector<uint64_t> sorted;
+    sorted.reserve(GetSizeUnlocked() + (aHashes ? aHashes->size() : 0));
+
+    if (m_layout.size() > 1)
+    {
+        ExtractLayout(sorted, 1);
+    }
+
+    auto middle = sorted.insert(sorted.end(), m_pending.begin(), m_pending.end());
+    std::inplace_merge(sorted.begin(), middle, sorted.end());
+
+    if (aHashes)
+    {
+        std::sort(aHashes->begin(), aHashes->end());
+
+        auto size = sorted.size();
+        sorted.insert(sorted.end(), aHashes->begin(), aHashes->end());
+        std::inplace_merge(sorted.begin(), sorted.begin() + size, sorted.end());
+    }
+
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    m_pending.clear();
+    m_layout.assign(sorted.size() + 1, 0);
+
+    size_t index = 0;
+    BuildLayout(sorted, index, 1);
+
+    // Leave room for paths added later (e.g. by mods) before the filter has to be resized again.
+    auto capacity = sorted.size() + sorted.size() / 4;
+    if (capacity > m_capacity || capacity < m_capacity / 2)
+    {
+        ResizeFilter(capacity);
+    }
+    else
+    {
+        std::fill(m_blocks.begin(), m_blocks.end(), Block{});
+    }
+
+    for (auto hash : sorted)
+    {
+        SetBits(m_blocks[GetBlockIndex(hash, m_blocks.size())], hash);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::ResizeFilter(size_t aCapacity)
+{
+    constexpr size_t bitsPerBlock = sizeof(Block) * 8;
+
+    auto blockCount = (std::max)((aCapacity * BitsPerPath + bitsPerBlock - 1) / bitsPerBlock, static_cast<size_t>(1));
+    m_blocks.assign(blockCount, Block{});
+    m_capacity = blockCount * bitsPerBlock / BitsPerPath;
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::ContainsUnlocked(uint64_t aHash) const
+{
+    return MayContainUnlocked(aHash) &&
+           (SearchLayout(aHash) || std::binary_search(m_pending.begin(), m_pending.end(), aHash));
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::MayContainUnlocked(uint64_t aHash) const
+{
+    if (m_blocks.empty())
+    {
+        return false;
+    }
+
+    return TestBits(m_blocks[GetBlockIndex(aHash, m_blocks.size())], aHash);
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceExistenceIndex::SearchLayout(uint64_t aHash) const
+{
+    auto size = m_layout.size();
+    if (size <= 1)
+    {
+        return false;
+    }
+
+    // Walk down the implicit tree, then drop the trailing right turns to find the last node where we went left, which
+    // is the lower bound.
+    size_t node = 1;
+    while (node < size)
+    {
+        node = 2 * node + (m_layout[node] < aHash);
+    }
+
+    node >>= std::countr_one(node) + 1;
+    return node != 0 && m_layout[node] == aHash;
+}
+
+RED4EXT_INLINE size_t RED4ext::ResourceExistenceIndex::ConfirmUnlocked(const ResourcePath* aPaths, bool* aResults,
+                                                                       const size_t* aIndices, size_t aCount) const
+{
+    // The searches walk down the tree in lockstep, their cache misses overlap instead of waiting for each other.
+    size_t nodes[SearchGroupSize];
+    std::fill_n(nodes, aCount, static_cast<size_t>(1));
+
+    auto size = m_layout.size();
+    for (auto isWalking = size > 1; isWalking;)
+    {
+        isWalking = false;
+        for (size_t i = 0; i < aCount; ++i)
+        {
+            auto node = nodes[i];
+            if (node < size)
+            {
+                nodes[i] = 2 * node + (m_layout[node] < aPaths[aIndices[i]].hash);
+                isWalking = true;
+            }
+        }
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < aCount; ++i)
+    {
+        auto hash = aPaths[aIndices[i]].hash;
+
+        auto node = size > 1 ? nodes[i] >> (std::countr_one(nodes[i]) + 1) : 0;
+        auto result = (node != 0 && m_layout[node] == hash) ||
+                      std::binary_search(m_pending.begin(), m_pending.end(), hash);
+
+        aResults[aIndices[i]] = result;
+        count += result;
+    }
+
+    return count;
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::BuildLayout(const std::vector<uint64_t>& aSorted, size_t& aIndex,
+                                                                 size_t aNode)
+{
+    // In-order traversal of the implicit tree, the depth is log2 of the size.
+    if (aNode < m_layout.size())
+    {
+        BuildLayout(aSorted, aIndex, 2 * aNode);
+        m_layout[aNode] = aSorted[aIndex++];
+        BuildLayout(aSorted, aIndex, 2 * aNode + 1);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::ResourceExistenceIndex::ExtractLayout(std::vector<uint64_t>& aSorted, size_t aNode) const
+{
+    if (aNode < m_layout.size())
+    {
+        ExtractLayout(aSorted, 2 * aNode);
+        aSorted.push_back(m_layout[aNode]);
+        ExtractLayout(aSorted, 2 * aNode + 1);
+    }
+}
+
+RED4EXT_INLINE size_t RED4ext::ResourceExistenceIndex::GetSizeUnlocked() const
+{
+    return (m_layout.empty() ? 0 : m_layout.size() - 1) + m_pending.size();
+}
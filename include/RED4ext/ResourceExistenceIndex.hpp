@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/ResourcePath.hpp>
+#include <RED4ext/SharedSpinLock.hpp>
+#include <RED4ext/Span.hpp>
+
+namespace RED4ext
+{
+struct ResourceDepot;
+
+/**
+ * @brief An SDK-side set of resource paths that answers existence queries without calling into the game.
+ *
+ * Queries first check a blocked Bloom filter, so most negatives are answered by touching a single cache line. Possible
+ * positives are confirmed against the sorted hashes, stored in Eytzinger (breadth-first) order so the binary search
+ * walks down the array predictably. Paths added after the last rebuild are kept in a small sorted list until it is
+ * large enough to be merged.
+ */
+class ResourceExistenceIndex
+{
+public:
+    static constexpr uint32_t BitsPerPath = 12;
+
+    ResourceExistenceIndex();
+    ResourceExistenceIndex(const ResourceExistenceIndex&) = delete;
+    ResourceExistenceIndex& operator=(const ResourceExistenceIndex&) = delete;
+
+    /**
+     * @brief Adds the files of every archive mounted by the depot, the index is rebuilt once for all of them.
+     * @param aDepot The depot.
+     * @return The number of archives that were read.
+     */
+    uint32_t AddDepot(const ResourceDepot* aDepot);
+
+    /**
+     * @brief Adds the files of an archive.
+     * @return True if the archive was read.
+     */
+    bool AddArchive(const std::filesystem::path& aPath);
+
+    void Add(ResourcePath aPath);
+    void Add(Span<const ResourcePath> aPaths);
+
+    /**
+     * @brief Returns true if the path was added, the answer is exact.
+     */
+    [[nodiscard]] bool Contains(ResourcePath aPath) const;
+
+    /**
+     * @brief Answers multiple queries under a single lock.
+     * @param aPaths The paths.
+     * @param aResults Receives one result per path.
+     * @param aCount The number of paths.
+     * @return The number of paths that exist.
+     */
+    size_t Contains(const ResourcePath* aPaths, bool* aResults, size_t aCount) const;
+
+    /**
+     * @brief Checks the Bloom filter only, false positives are possible, false negatives are not.
+     */
+    [[nodiscard]] bool MayContain(ResourcePath aPath) const;
+
+    /**
+     * @brief Merges the pending paths and resizes the Bloom filter to the current number of paths.
+     */
+    void Rebuild();
+    void Clear();
+
+    [[nodiscard]] size_t GetSize() const;
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+    /**
+     * @brief Estimates the false positive rate of the Bloom filter from the number of bits set.
+     */
+    [[nodiscard]] double EstimateFalsePositiveRate() const;
+
+private:
+    static constexpr uint32_t BlockWords = 8;
+    static constexpr uint32_t MinPendingMerge = 1024;
+    static constexpr uint32_t SearchGroupSize = 16;
+
+    struct alignas(64) Block
+    {
+        uint64_t words[BlockWords];
+    };
+
+    static bool ReadArchive(const std::filesystem::path& aPath, std::vector<uint64_t>& aHashes);
+    static uint64_t GetBlockIndex(uint64_t aHash, size_t aBlockCount);
+    static void SetBits(Block& aBlock, uint64_t aHash);
+    static bool TestBits(const Block& aBlock, uint64_t aHash);
+
+    void AddUnlocked(uint64_t aHash);
+    void RebuildUnlocked(std::vector<uint64_t>* aHashes = nullptr);
+    void ResizeFilter(size_t aCapacity);
+    bool ContainsUnlocked(uint64_t aHash) const;
+    bool MayContainUnlocked(uint64_t aHash) const;
+    bool SearchLayout(uint64_t aHash) const;
+    size_t ConfirmUnlocked(const ResourcePath* aPaths, bool* aResults, const size_t* aIndices, size_t aCount) const;
+
+    void BuildLayout(const std::vector<uint64_t>& aSorted, size_t& aIndex, size_t aNode);
+    void ExtractLayout(std::vector<uint64_t>& aSorted, size_t aNode) const;
+    size_t GetSizeUnlocked() const;
+
+    mutable SharedSpinLock m_lock;
+    std::vector<Block> m_blocks;
+    size_t m_capacity;               // Number of paths the filter was sized for.
+    std::vector<uint64_t> m_layout;  // Eytzinger order, index 0 is unused.
+    std::vector<uint64_t> m_pending; // Sorted, not part of m_layout yet.
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/ResourceExistenceIndex-inl.hpp>
+#endif
@@ -6,6 +6,11 @@
 
 #include <RED4ext/Detail/AddressHashes.hpp>
 #include <RED4ext/Relocation.hpp>
+#include <RED4ext/ResourceTokenCache.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <shared_mutex>
 
 RED4EXT_INLINE RED4ext::ResourceRequest::ResourceRequest(ResourcePath aPath)
     : path(aPath)
@@ -28,3 +33,107 @@ RED4EXT_INLINE RED4ext::ResourceLoader* RED4ext::ResourceLoader::Get()
     static UniversalRelocPtr<ResourceLoader*> ptr(Detail::AddressHashes::ResourceLoader);
     return ptr;
 }
+
+RED4EXT_INLINE RED4ext::SharedPtr<RED4ext::ResourceToken<>> RED4ext::ResourceBatch::Find(ResourcePath aPath) const
+{
+    auto it = std::lower_bound(paths.begin(), paths.end(), aPath,
+                               [](ResourcePath aLhs, ResourcePath aRhs) { return aLhs.hash < aRhs.hash; });
+    if (it == paths.end() || *it != aPath)
+    {
+        return {};
+    }
+
+    return tokens[std::distance(paths.begin(), it)];
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceBatch::IsFinished() const noexcept
+{
+    return std::all_of(tokens.begin(), tokens.end(),
+                       [](const auto& aToken) { return !aToken || aToken->IsFinished(); });
+}
+
+RED4EXT_INLINE bool RED4ext::ResourceBatch::IsLoaded() const noexcept
+{
+    return std::all_of(tokens.begin(), tokens.end(), [](const auto& aToken) { return aToken && aToken->IsLoaded(); });
+}
+
+RED4EXT_INLINE uint32_t RED4ext::ResourceBatch::GetFailedCount() const noexcept
+{
+    return static_cast<uint32_t>(std::count_if(tokens.begin(), tokens.end(),
+                                               [](const auto& aToken) { return !aToken || aToken->IsFailed(); }));
+}
+
+RED4EXT_INLINE RED4ext::ResourceBatch RED4ext::ResourceLoader::LoadBatch(Span<const ResourcePath> aPaths)
+{
+    ResourceBatch batch;
+    JobQueue queue;
+
+    IssueBatch(aPaths, batch, queue);
+
+    batch.job = queue.Capture();
+    return batch;
+}
+
+RED4EXT_INLINE void RED4ext::ResourceLoader::IssueBatch(Span<const ResourcePath> aPaths, ResourceBatch& aBatch,
+                                                       JobQueue& aQueue)
+{
+    auto& paths = aBatch.paths;
+    auto& tokens = aBatch.tokens;
+
+    paths.reserve(aPaths.GetSize());
+    for (auto path : aPaths)
+    {
+        if (!path.IsEmpty())
+        {
+            paths.push_back(path);
+        }
+    }
+
+    std::sort(paths.begin(), paths.end(), [](ResourcePath aLhs, ResourcePath aRhs) { return aLhs.hash < aRhs.hash; });
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+    tokens.resize(paths.size());
+
+    std::vector<uint32_t> misses;
+    for (uint32_t i = 0; i < paths.size(); ++i)
+    {
+        tokens[i] = ResourceTokenCache::Find(paths[i]);
+        if (!tokens[i])
+        {
+            misses.push_back(i);
+        }
+    }
+
+    if (!misses.empty())
+    {
+        // Resolve every live token with a single lock instead of one FindToken() call per path.
+        std::shared_lock<SharedSpinLock> _(tokenLock);
+
+        for (auto i : misses)
+        {
+            auto weak = this->tokens.Get(paths[i]);
+            if (weak)
+            {
+                tokens[i] = weak->Lock();
+            }
+        }
+    }
+
+    for (auto i : misses)
+    {
+        if (!tokens[i])
+        {
+            tokens[i] = LoadAsync(paths[i]);
+        }
+
+        ResourceTokenCache::Store(tokens[i]);
+    }
+
+    for (const auto& token : tokens)
+    {
+        if (token && !token->IsFinished())
+        {
+            aQueue.Wait(token->job);
+        }
+    }
+}
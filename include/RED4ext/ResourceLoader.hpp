@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <vector>
 
 #include <RED4ext/Callback.hpp>
 #include <RED4ext/Common.hpp>
@@ -12,6 +13,7 @@
 #include <RED4ext/Memory/SharedPtr.hpp>
 #include <RED4ext/Relocation.hpp>
 #include <RED4ext/ResourcePath.hpp>
+#include <RED4ext/Span.hpp>
 #include <RED4ext/Scripting/Natives/Generated/CResource.hpp>
 
 namespace RED4ext
@@ -140,6 +142,25 @@ RED4EXT_ASSERT_OFFSET(ResourceRequest, disablePreInitialization, 0x11);
 RED4EXT_ASSERT_OFFSET(ResourceRequest, disablePostLoad, 0x13);
 RED4EXT_ASSERT_OFFSET(ResourceRequest, archiveHandle, 0x18);
 
+/**
+ * @brief The result of ResourceLoader::LoadBatch.
+ */
+struct ResourceBatch
+{
+    /**
+     * @brief Returns the token of a path that is part of the batch.
+     */
+    [[nodiscard]] SharedPtr<ResourceToken<>> Find(ResourcePath aPath) const;
+
+    [[nodiscard]] bool IsFinished() const noexcept;
+    [[nodiscard]] bool IsLoaded() const noexcept;
+    [[nodiscard]] uint32_t GetFailedCount() const noexcept;
+
+    std::vector<ResourcePath> paths;                // Sorted and deduplicated
+    std::vector<SharedPtr<ResourceToken<>>> tokens; // Same order as paths
+    JobHandle job;                                  // Completes when every token has finished
+};
+
 struct ResourceLoader
 {
     static ResourceLoader* Get();
@@ -182,6 +203,41 @@ struct ResourceLoader
         return token;
     }
 
+    /**
+     * @brief Loads multiple resources at once.
+     *
+     * Duplicate paths are requested once. Tokens that are alive are reused through ResourceTokenCache and the loader's
+     * token map, which is looked up under a single lock. Only the remaining paths issue a load request. Instead of one
+     * OnLoaded() registration per token, the batch gets one job handle that completes when every token has finished.
+     *
+     * @param aPaths The resources.
+     * @return The batch.
+     */
+    ResourceBatch LoadBatch(Span<const ResourcePath> aPaths);
+
+    /**
+     * @brief Loads multiple resources at once and calls a closure when all of them have finished.
+     *
+     * @tparam L The closure type.
+     * @param aPaths The resources.
+     * @param aOnFinished The closure, called once for the whole batch (also when some resources failed).
+     * @return The batch.
+     */
+    template<typename L>
+    requires Detail::IsClosure<L, void>
+    ResourceBatch LoadBatch(Span<const ResourcePath> aPaths, L&& aOnFinished)
+    {
+        ResourceBatch batch;
+        JobQueue queue;
+
+        IssueBatch(aPaths, batch, queue);
+
+        queue.Dispatch(std::move(aOnFinished));
+        batch.job = queue.Capture();
+
+        return batch;
+    }
+
     HashMap<ResourcePath, WeakPtr<ResourceToken<>>> tokens; // 00
     DynArray<SharedPtr<ResourceToken<>>> failed;            // 30
     SharedSpinLock tokenLock;                               // 40
@@ -191,6 +247,9 @@ struct ResourceLoader
     uint8_t unk60;                                          // 60
     DynArray<void*> unk68;                                  // 68
     uint8_t unk70;                                          // 70
+
+private:
+    void IssueBatch(Span<const ResourcePath> aPaths, ResourceBatch& aBatch, JobQueue& aQueue);
 };
 RED4EXT_ASSERT_SIZE(ResourceLoader, 0x80);
 RED4EXT_ASSERT_OFFSET(ResourceLoader, tokens, 0x00);
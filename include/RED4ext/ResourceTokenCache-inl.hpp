@@ -0,0 +1,119 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/ResourceTokenCache.hpp>
+#endif
+
+#include <thread>
+
+RED4EXT_INLINE RED4ext::SharedPtr<RED4ext::ResourceToken<>> RED4ext::ResourceTokenCache::Find(ResourcePath aPath)
+{
+    SharedPtr<ResourceToken<>> token;
+    if (aPath.IsEmpty())
+    {
+        return token;
+    }
+
+    auto& slot = GetSlots()[GetSlotIndex(aPath)];
+
+    // Most misses are empty slots or slots of other paths, they are answered without writing to the slot.
+    if (slot.path.load(std::memory_order_relaxed) != aPath.hash)
+    {
+        return token;
+    }
+
+    // Announce the lookup before reading the slot, a writer waits for it before releasing the reference it replaced.
+    slot.readers.fetch_add(1);
+
+    auto sequence = slot.sequence.load();
+    if ((sequence & 1) == 0 && slot.path.load(std::memory_order_relaxed) == aPath.hash)
+    {
+        auto instance = slot.instance.load(std::memory_order_relaxed);
+        auto refCount = slot.refCount.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence && refCount && refCount->IncRefIfNotZero())
+        {
+            token.instance = instance;
+            token.refCount = refCount;
+        }
+    }
+
+    slot.readers.fetch_sub(1);
+
+    // A slot can be reused for a token of another path while we were reading it, the token we got is alive, check it.
+    if (token && token->path != aPath)
+    {
+        token.Reset();
+    }
+
+    return token;
+}
+
+RED4EXT_INLINE void RED4ext::ResourceTokenCache::Store(const SharedPtr<ResourceToken<>>& aToken)
+{
+    if (!aToken || aToken->path.IsEmpty())
+    {
+        return;
+    }
+
+    auto path = aToken->path;
+    Write(GetSlots()[GetSlotIndex(path)], path, WeakPtr<ResourceToken<>>(aToken));
+}
+
+RED4EXT_INLINE void RED4ext::ResourceTokenCache::Invalidate()
+{
+    auto slots = GetSlots();
+    for (uint32_t i = 0; i < SlotCount; ++i)
+    {
+        Write(slots[i], {}, {});
+    }
+}
+
+RED4EXT_INLINE RED4ext::ResourceTokenCache::Slot* RED4ext::ResourceTokenCache::GetSlots()
+{
+    // The slots are never destroyed, the weak references they hold are released by the game's allocator which might be
+    // gone when static destructors run.
+    static auto slots = new Slot[SlotCount]{};
+    return slots;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::ResourceTokenCache::GetSlotIndex(ResourcePath aPath)
+{
+    auto key = aPath.hash * 0x9E3779B97F4A7C15ull;
+    return static_cast<uint32_t>(key >> 32) & (SlotCount - 1);
+}
+
+RED4EXT_INLINE void RED4ext::ResourceTokenCache::Write(Slot& aSlot, ResourcePath aPath,
+                                                       WeakPtr<ResourceToken<>>&& aToken)
+{
+    auto sequence = aSlot.sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !aSlot.sequence.compare_exchange_strong(sequence, sequence + 1))
+    {
+        // Another thread is filling the slot, skip it, aToken releases the reference we would have stored.
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Take over the old reference, it is released once no lookup can use it anymore.
+    WeakPtr<ResourceToken<>> old;
+    old.instance = aSlot.instance.load(std::memory_order_relaxed);
+    old.refCount = aSlot.refCount.load(std::memory_order_relaxed);
+
+    aSlot.path.store(aPath.hash, std::memory_order_relaxed);
+    aSlot.instance.store(aToken.instance, std::memory_order_relaxed);
+    aSlot.refCount.store(aToken.refCount, std::memory_order_relaxed);
+
+    // The slot owns the new reference now.
+    aToken.instance = nullptr;
+    aToken.refCount = nullptr;
+
+    aSlot.sequence.store(sequence + 2);
+
+    // Lookups that started before the update might still increment the old reference count, wait for them.
+    while (aSlot.readers.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+}
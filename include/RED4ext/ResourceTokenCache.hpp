@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Memory/SharedPtr.hpp>
+#include <RED4ext/ResourceLoader.hpp>
+#include <RED4ext/ResourcePath.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Direct-mapped cache of live resource tokens, keyed by the resource path.
+ *
+ * The cache only holds weak references, so it never keeps a resource loaded. Lookups do not take any lock, a slot that
+ * is being updated is reported as a miss and the caller falls back to the resource loader.
+ */
+class ResourceTokenCache
+{
+public:
+    static constexpr uint32_t SlotCount = 1024;
+
+    /**
+     * @brief Returns the cached token for the path if it is still alive.
+     */
+    static SharedPtr<ResourceToken<>> Find(ResourcePath aPath);
+
+    /**
+     * @brief Caches a token, replacing whatever occupies its slot.
+     */
+    static void Store(const SharedPtr<ResourceToken<>>& aToken);
+
+    /**
+     * @brief Drops every cached entry.
+     */
+    static void Invalidate();
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence; // Odd while a writer is updating the slot.
+        std::atomic<uint32_t> readers;  // Lookups in progress, the old weak reference is released after they finished.
+        std::atomic<uint64_t> path;
+        std::atomic<ResourceToken<>*> instance;
+        std::atomic<RefCnt*> refCount;
+    };
+
+    static Slot* GetSlots();
+    static uint32_t GetSlotIndex(ResourcePath aPath);
+
+    static void Write(Slot& aSlot, ResourcePath aPath, WeakPtr<ResourceToken<>>&& aToken);
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/ResourceTokenCache-inl.hpp>
+#endif
@@ -54,7 +54,7 @@ RED4EXT_INLINE bool RED4ext::ExecuteFunction(CClass* aContext, CBaseFunction* aF
     auto engine = CGameEngine::Get();
     auto gameInstance = engine->framework->gameInstance;
 
-    Handle<IScriptable> instance(gameInstance->GetSystem(aContext));
+    Handle<IScriptable> instance(GameSystemCache::Get(gameInstance, aContext));
     return ExecuteFunction(instance, aFunc, aOut, aArgs);
 }
 
@@ -114,6 +114,17 @@ struct SortedArray
         return Merge(true, aOther);
     }
 
+    /**
+     * @brief Merges a range of items in a single linear pass, items that are already in the array are kept.
+     * @param aItems The items, must be sorted with the same comparator and, for unique arrays, free of duplicates.
+     * @param aCount The number of items.
+     * @return The number of inserted items.
+     */
+    uint32_t InsertSorted(const T* aItems, uint32_t aCount)
+    {
+        return MergeSorted(aItems, aCount);
+    }
+
     T* Find(const T& aItem)
     {
         const auto it = LowerBound(aItem);
@@ -322,6 +333,89 @@ private:
         return static_cast<uint32_t>(insertions.size());
     }
 
+    uint32_t MergeSorted(const T* aItems, uint32_t aCount)
+    {
+        if (aCount == 0)
+        {
+            return 0;
+        }
+
+        if ((flags & (int32_t)Flags::NotSorted) == (int32_t)Flags::NotSorted)
+        {
+            Sort();
+        }
+
+        Compare compare{};
+
+        // First pass, count the items that are already in the array so the final size is known up front.
+        uint32_t duplicates = 0;
+        if constexpr (Unique)
+        {
+            uint32_t i = 0;
+            uint32_t j = 0;
+            while (i != size && j != aCount)
+            {
+                if (compare(entries[i], aItems[j]))
+                {
+                    ++i;
+                }
+                else if (compare(aItems[j], entries[i]))
+                {
+                    ++j;
+                }
+                else
+                {
+                    ++duplicates;
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+
+        uint32_t inserted = aCount - duplicates;
+        if (inserted == 0)
+        {
+            return 0;
+        }
+
+        uint32_t newSize = size + inserted;
+        if (newSize > capacity)
+        {
+            Reserve(newSize);
+        }
+
+        // Second pass, merge from the back so every entry is moved at most once.
+        int64_t src = static_cast<int64_t>(size) - 1;
+        int64_t item = static_cast<int64_t>(aCount) - 1;
+        int64_t dst = static_cast<int64_t>(newSize) - 1;
+
+        while (item >= 0)
+        {
+            if (src >= 0 && compare(aItems[item], entries[src]))
+            {
+                MoveEntries(&entries[src], &entries[dst], 1);
+                --src;
+            }
+            else if (Unique && src >= 0 && !compare(entries[src], aItems[item]))
+            {
+                // Already in the array, the existing item is kept.
+                MoveEntries(&entries[src], &entries[dst], 1);
+                --src;
+                --item;
+            }
+            else
+            {
+                new (&entries[dst]) T(aItems[item]);
+                --item;
+            }
+
+            --dst;
+        }
+
+        size = newSize;
+        return inserted;
+    }
+
     T* LowerBound(const T& aItem)
     {
         if ((flags & (int32_t)Flags::NotSorted) == (int32_t)Flags::NotSorted)
@@ -0,0 +1,129 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/ThreadPool.hpp>
+#endif
+
+#include <algorithm>
+
+RED4EXT_INLINE RED4ext::ThreadPool::ThreadPool(uint32_t aThreadCount)
+    : m_isStopping(false)
+{
+    if (aThreadCount == 0)
+    {
+        auto hardwareThreads = std::thread::hardware_concurrency();
+        aThreadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_threads.reserve(aThreadCount);
+    for (uint32_t i = 0; i < aThreadCount; ++i)
+    {
+        m_threads.emplace_back([this]() { RunWorker(); });
+    }
+}
+
+RED4EXT_INLINE RED4ext::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> _(m_lock);
+        m_isStopping = true;
+    }
+
+    m_workAvailable.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+RED4EXT_INLINE uint32_t RED4ext::ThreadPool::GetThreadCount() const noexcept
+{
+    return static_cast<uint32_t>(m_threads.size());
+}
+
+RED4EXT_INLINE void RED4ext::ThreadPool::Run(size_t aCount, Function aFunction, void* aContext)
+{
+    if (aCount == 0)
+    {
+        return;
+    }
+
+    Batch batch;
+    batch.function = aFunction;
+    batch.context = aContext;
+    batch.count = aCount;
+    batch.next = 0;
+    auto helpers = static_cast<uint32_t>((std::min)(aCount - 1, m_threads.size()));
+    batch.helpers = helpers;
+
+    if (helpers)
+    {
+        {
+            std::lock_guard<std::mutex> _(m_lock);
+            m_pending.insert(m_pending.end(), helpers, &batch);
+        }
+
+        if (helpers == 1)
+        {
+            m_workAvailable.notify_one();
+        }
+        else
+        {
+            m_workAvailable.notify_all();
+        }
+    }
+
+    Work(batch);
+
+    if (helpers == 0)
+    {
+        return;
+    }
+
+    // The batch lives on this stack, every worker that picked it up has to let go of it first. Requests that no worker
+    // picked up yet are withdrawn, this also keeps a loop started from inside another one from waiting for itself.
+    std::unique_lock<std::mutex> lock(m_lock);
+    batch.helpers -= static_cast<uint32_t>(std::erase(m_pending, &batch));
+    m_helperDone.wait(lock, [&batch]() { return batch.helpers == 0; });
+}
+
+RED4EXT_INLINE void RED4ext::ThreadPool::RunWorker()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true)
+    {
+        m_workAvailable.wait(lock, [this]() { return m_isStopping || !m_pending.empty(); });
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        auto batch = m_pending.front();
+        m_pending.pop_front();
+
+        lock.unlock();
+        Work(*batch);
+        lock.lock();
+
+        if (--batch->helpers == 0)
+        {
+            m_helperDone.notify_all();
+        }
+    }
+}
+
+RED4EXT_INLINE void RED4ext::ThreadPool::Work(Batch& aBatch)
+{
+    while (true)
+    {
+        auto index = aBatch.next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= aBatch.count)
+        {
+            return;
+        }
+
+        aBatch.function(aBatch.context, index);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief A small pool of worker threads that runs the chunks of a parallel loop.
+ *
+ * It is the local counterpart of the game's job system, useful where the job dispatcher is not available (e.g. tests
+ * outside of the game). The thread that starts a loop works on it too and returns once every chunk ran.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the workers.
+     * @param aThreadCount The number of workers, 0 uses one less than the hardware threads.
+     */
+    explicit ThreadPool(uint32_t aThreadCount = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    [[nodiscard]] uint32_t GetThreadCount() const noexcept;
+
+    /**
+     * @brief Calls the function once for each index in [0, aCount) and waits until all calls returned.
+     * @param aFunction The function, called concurrently from several threads. It may start a loop itself.
+     */
+    template<typename F>
+    requires std::is_invocable_v<F&, size_t>
+    void Run(size_t aCount, F&& aFunction)
+    {
+        using Type = std::remove_reference_t<F>;
+        Run(aCount, &Invoke<Type>, const_cast<void*>(static_cast<const void*>(std::addressof(aFunction))));
+    }
+
+private:
+    using Function = void (*)(void*, size_t);
+
+    struct Batch
+    {
+        Function function;
+        void* context;
+        size_t count;
+        std::atomic<size_t> next;
+        uint32_t helpers; // Workers that still hold the batch, guarded by the pool's lock.
+    };
+
+    template<typename F>
+    static void Invoke(void* aContext, size_t aIndex)
+    {
+        (*static_cast<F*>(aContext))(aIndex);
+    }
+
+    void Run(size_t aCount, Function aFunction, void* aContext);
+    void RunWorker();
+
+    static void Work(Batch& aBatch);
+
+    std::mutex m_lock;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_helperDone;
+    std::deque<Batch*> m_pending; // One entry per worker that should help with the batch.
+    bool m_isStopping;
+    std::vector<std::thread> m_threads;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/ThreadPool-inl.hpp>
+#endif
@@ -0,0 +1,609 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/Trace/TraceDecoder.hpp>
+#endif
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+RED4EXT_INLINE bool RED4ext::TraceDecoder::Open(const std::filesystem::path& aPath)
+{
+    if (!m_file.Open(aPath))
+    {
+        return false;
+    }
+
+    return Load(m_file.GetData(), m_file.GetLength());
+}
+
+RED4EXT_INLINE bool RED4ext::TraceDecoder::Load(const uint8_t* aData, size_t aSize)
+{
+    m_formats.clear();
+    m_names.clear();
+    m_chunks.clear();
+    m_clocks.clear();
+    m_firstTicks = 0;
+    m_nanosecondsPerTick = 1.0;
+
+    uint32_t magic;
+    uint16_t version;
+
+    if (!aData || aSize < 8)
+    {
+        return false;
+    }
+
+    std::memcpy(&magic, aData, sizeof(magic));
+    std::memcpy(&version, aData + 4, sizeof(version));
+
+    if (magic != Detail::TraceMagic || version != Detail::TraceVersion)
+    {
+        return false;
+    }
+
+    auto in = aData + 8;
+    auto end = aData + aSize;
+
+    while (in < end)
+    {
+        auto kind = static_cast<TraceBlockKind>(*in++);
+
+        // The last block is cut off if the writer did not shut down, keep everything in front of it.
+        uint64_t size;
+        in = Detail::ReadVarInt(in, end, size);
+        if (!in || size > static_cast<size_t>(end - in))
+        {
+            break;
+        }
+
+        if (!ReadBlock(kind, in, in + size))
+        {
+            return false;
+        }
+
+        in += size;
+    }
+
+    // The counter is assumed to run at a constant rate, the first and the last reference point give the most precise
+    // estimate of it.
+    if (!m_clocks.empty())
+    {
+        const auto& first = m_clocks.front();
+        const auto& last = m_clocks.back();
+
+        m_firstTicks = first.ticks;
+        if (last.ticks > first.ticks)
+        {
+            m_nanosecondsPerTick = static_cast<double>(last.nanoseconds - first.nanoseconds) /
+                                   static_cast<double>(last.ticks - first.ticks);
+        }
+    }
+    else if (!m_chunks.empty())
+    {
+        m_firstTicks = m_chunks.front().firstTicks;
+    }
+
+    return true;
+}
+
+RED4EXT_INLINE bool RED4ext::TraceDecoder::Decode(std::ostream& aOut, OutputFormat aFormat) const
+{
+    std::vector<Arg> args;
+    std::string message;
+    std::string line;
+
+    if (aFormat == OutputFormat::ChromeTrace)
+    {
+        aOut << "{\"traceEvents\":[";
+    }
+
+    bool isFirst = true;
+    bool isValid = true;
+
+    for (const auto& chunk : m_chunks)
+    {
+        auto ticks = chunk.firstTicks;
+        auto in = chunk.begin;
+
+        while (in < chunk.end && isValid)
+        {
+            uint64_t id;
+            uint64_t delta;
+
+            in = Detail::ReadVarInt(in, chunk.end, id);
+            in = in ? Detail::ReadVarInt(in, chunk.end, delta) : nullptr;
+
+            if (!in || id >= m_formats.size() || m_formats[id].phase == TracePhase{})
+            {
+                isValid = false;
+                break;
+            }
+
+            const auto& format = m_formats[id];
+            ticks += delta;
+
+            args.resize(format.args.size());
+            for (size_t i = 0; i < format.args.size() && in; ++i)
+            {
+                args[i].type = format.args[i];
+                in = ReadArg(in, chunk.end, format.args[i], args[i].text);
+            }
+
+            if (!in)
+            {
+                isValid = false;
+                break;
+            }
+
+            message.clear();
+            WriteMessage(message, format.text, args);
+
+            // Build the whole line first, a single write is much cheaper than many small stream insertions.
+            auto time = ToNanoseconds(ticks);
+            auto phase = static_cast<char>(format.phase);
+            auto thread = std::to_string(chunk.thread);
+
+            line.clear();
+
+            switch (aFormat)
+            {
+            case OutputFormat::Text:
+            {
+                WriteTime(line, time);
+                line.append(" [").append(thread).append("] ");
+                line.append(1, phase).append(1, ' ');
+                line.append(message).append(1, '\n');
+                break;
+            }
+            case OutputFormat::JsonLines:
+            {
+                line.append("{\"ts\":");
+                WriteTime(line, time);
+                line.append(",\"tid\":").append(thread);
+                line.append(",\"ph\":\"").append(1, phase).append("\",\"msg\":");
+                WriteJsonString(line, message);
+
+                line.append(",\"args\":[");
+                for (size_t i = 0; i < args.size(); ++i)
+                {
+                    line.append(i ? "," : "");
+                    WriteJsonValue(line, args[i]);
+                }
+                line.append("]}\n");
+                break;
+            }
+            case OutputFormat::ChromeTrace:
+            {
+                line.append(isFirst ? "\n" : ",\n");
+                line.append("{\"ph\":\"").append(1, phase).append("\",\"ts\":");
+                WriteTime(line, time);
+                line.append(",\"pid\":0,\"tid\":").append(thread).append(",\"name\":");
+                WriteJsonString(line, message);
+
+                if (format.phase == TracePhase::Instant)
+                {
+                    line.append(",\"s\":\"t\"");
+                }
+
+                if (!args.empty())
+                {
+                    line.append(",\"args\":{");
+                    for (size_t i = 0; i < args.size(); ++i)
+                    {
+                        line.append(i ? ",\"" : "\"").append(std::to_string(i)).append("\":");
+                        WriteJsonValue(line, args[i]);
+                    }
+                    line.append("}");
+                }
+
+                line.append("}");
+                break;
+            }
+            }
+
+            aOut.write(line.data(), static_cast<std::streamsize>(line.size()));
+            isFirst = false;
+        }
+    }
+
+    if (aFormat == OutputFormat::ChromeTrace)
+    {
+        aOut << "\n]}\n";
+    }
+
+    return isValid && !aOut.fail();
+}
+
+RED4EXT_INLINE size_t RED4ext::TraceDecoder::GetChunkCount() const noexcept
+{
+    return m_chunks.size();
+}
+
+RED4EXT_INLINE bool RED4ext::TraceDecoder::ReadBlock(TraceBlockKind aKind, const uint8_t* aIn, const uint8_t* aEnd)
+{
+    switch (aKind)
+    {
+    case TraceBlockKind::Format:
+    {
+        uint64_t id;
+        aIn = Detail::ReadVarInt(aIn, aEnd, id);
+        if (!aIn || aEnd - aIn < 2 || id > UINT32_MAX)
+        {
+            return false;
+        }
+
+        Format format;
+        format.phase = static_cast<TracePhase>(*aIn++);
+
+        auto count = *aIn++;
+        if (aEnd - aIn < count)
+        {
+            return false;
+        }
+
+        auto types = reinterpret_cast<const TraceArgType*>(aIn);
+        format.args.assign(types, types + count);
+        aIn += count;
+
+        uint64_t length;
+        aIn = Detail::ReadVarInt(aIn, aEnd, length);
+        if (!aIn || length > static_cast<size_t>(aEnd - aIn))
+        {
+            return false;
+        }
+
+        format.text = {reinterpret_cast<const char*>(aIn), static_cast<size_t>(length)};
+
+        // Ids are defined in order, an undefined one in between means the trace is damaged.
+        if (id >= m_formats.size())
+        {
+            m_formats.resize(id + 1, Format{TracePhase{}, {}, {}});
+        }
+
+        m_formats[id] = std::move(format);
+        return true;
+    }
+    case TraceBlockKind::Name:
+    {
+        uint64_t hash;
+        uint64_t length;
+
+        if (aEnd - aIn < static_cast<ptrdiff_t>(sizeof(hash)))
+        {
+            return false;
+        }
+
+        std::memcpy(&hash, aIn, sizeof(hash));
+        aIn = Detail::ReadVarInt(aIn + sizeof(hash), aEnd, length);
+        if (!aIn || length > static_cast<size_t>(aEnd - aIn))
+        {
+            return false;
+        }
+
+        m_names[hash] = {reinterpret_cast<const char*>(aIn), static_cast<size_t>(length)};
+        return true;
+    }
+    case TraceBlockKind::Clock:
+    {
+        Clock clock;
+        aIn = Detail::ReadVarInt(aIn, aEnd, clock.ticks);
+        aIn = aIn ? Detail::ReadVarInt(aIn, aEnd, clock.nanoseconds) : nullptr;
+        if (!aIn)
+        {
+            return false;
+        }
+
+        m_clocks.push_back(clock);
+        return true;
+    }
+    case TraceBlockKind::Chunk:
+    {
+        uint64_t thread;
+
+        Chunk chunk;
+        aIn = Detail::ReadVarInt(aIn, aEnd, thread);
+        aIn = aIn ? Detail::ReadVarInt(aIn, aEnd, chunk.firstTicks) : nullptr;
+        if (!aIn)
+        {
+            return false;
+        }
+
+        chunk.thread = static_cast<uint32_t>(thread);
+        chunk.begin = aIn;
+        chunk.end = aEnd;
+
+        m_chunks.push_back(chunk);
+        return true;
+    }
+    default:
+    {
+        // Unknown blocks are skipped, newer writers may add them without breaking older decoders.
+        return true;
+    }
+    }
+}
+
+RED4EXT_INLINE const uint8_t* RED4ext::TraceDecoder::ReadArg(const uint8_t* aIn, const uint8_t* aEnd,
+                                                             TraceArgType aType, std::string& aText) const
+{
+    char buffer[64];
+    auto bufferEnd = buffer + sizeof(buffer);
+
+    auto read = [&aIn, aEnd](void* aValue, size_t aSize)
+    {
+        if (static_cast<size_t>(aEnd - aIn) < aSize)
+        {
+            return false;
+        }
+
+        std::memcpy(aValue, aIn, aSize);
+        aIn += aSize;
+        return true;
+    };
+
+    uint64_t value;
+    switch (aType)
+    {
+    case TraceArgType::Int:
+    case TraceArgType::UInt:
+    case TraceArgType::Pointer:
+    {
+        aIn = Detail::ReadVarInt(aIn, aEnd, value);
+        if (!aIn)
+        {
+            return nullptr;
+        }
+
+        if (aType == TraceArgType::Int)
+        {
+            aText.assign(buffer, std::to_chars(buffer, bufferEnd, Detail::DecodeZigZag(value)).ptr);
+        }
+        else if (aType == TraceArgType::UInt)
+        {
+            aText.assign(buffer, std::to_chars(buffer, bufferEnd, value).ptr);
+        }
+        else
+        {
+            aText.assign("0x");
+            aText.append(buffer, std::to_chars(buffer, bufferEnd, value, 16).ptr);
+        }
+
+        return aIn;
+    }
+    case TraceArgType::Float:
+    {
+        float number;
+        if (!read(&number, sizeof(number)))
+        {
+            return nullptr;
+        }
+
+        aText.assign(buffer, std::to_chars(buffer, bufferEnd, number).ptr);
+        return aIn;
+    }
+    case TraceArgType::Double:
+    {
+        double number;
+        if (!read(&number, sizeof(number)))
+        {
+            return nullptr;
+        }
+
+        aText.assign(buffer, std::to_chars(buffer, bufferEnd, number).ptr);
+        return aIn;
+    }
+    case TraceArgType::Bool:
+    {
+        uint8_t flag;
+        if (!read(&flag, sizeof(flag)))
+        {
+            return nullptr;
+        }
+
+        aText.assign(flag ? "true" : "false");
+        return aIn;
+    }
+    case TraceArgType::String:
+    {
+        aIn = Detail::ReadVarInt(aIn, aEnd, value);
+        if (!aIn || value > static_cast<size_t>(aEnd - aIn))
+        {
+            return nullptr;
+        }
+
+        aText.assign(reinterpret_cast<const char*>(aIn), static_cast<size_t>(value));
+        return aIn + value;
+    }
+    case TraceArgType::Name:
+    {
+        if (!read(&value, sizeof(value)))
+        {
+            return nullptr;
+        }
+
+        // Fall back to the hash if the writer did not resolve the name.
+        auto it = m_names.find(value);
+        if (it != m_names.end())
+        {
+            aText.assign(it->second);
+        }
+        else
+        {
+            aText.assign(buffer, ToChars(buffer, bufferEnd, CName(value)).ptr);
+        }
+
+        return aIn;
+    }
+    case TraceArgType::TweakDBID:
+    {
+        TweakDBID id;
+        if (!read(&id.value, sizeof(id.value)))
+        {
+            return nullptr;
+        }
+
+        aText.assign(buffer, ToChars(buffer, bufferEnd, id).ptr);
+        return aIn;
+    }
+    case TraceArgType::ResourcePath:
+    {
+        if (!read(&value, sizeof(value)))
+        {
+            return nullptr;
+        }
+
+        std::snprintf(buffer, sizeof(buffer), "%016llX", static_cast<unsigned long long>(value));
+        aText.assign(buffer);
+        return aIn;
+    }
+    case TraceArgType::Vector4:
+    {
+        float components[4];
+        if (!read(components, sizeof(components)))
+        {
+            return nullptr;
+        }
+
+        aText.assign("(");
+        for (size_t i = 0; i < 4; ++i)
+        {
+            aText.append(i ? ", " : "");
+            aText.append(buffer, std::to_chars(buffer, bufferEnd, components[i]).ptr);
+        }
+        aText.append(")");
+        return aIn;
+    }
+    default:
+    {
+        return nullptr;
+    }
+    }
+}
+
+RED4EXT_INLINE int64_t RED4ext::TraceDecoder::ToNanoseconds(uint64_t aTicks) const noexcept
+{
+    auto ticks = static_cast<double>(static_cast<int64_t>(aTicks - m_firstTicks));
+    return static_cast<int64_t>(ticks * m_nanosecondsPerTick);
+}
+
+RED4EXT_INLINE void RED4ext::TraceDecoder::WriteMessage(std::string& aOut, std::string_view aFormat,
+                                                        const std::vector<Arg>& aArgs)
+{
+    size_t next = 0;
+
+    while (!aFormat.empty())
+    {
+        auto placeholder = aFormat.find("{}");
+        if (placeholder == std::string_view::npos || next == aArgs.size())
+        {
+            // Placeholders without an argument are kept as they are.
+            aOut.append(aFormat);
+            return;
+        }
+
+        aOut.append(aFormat.substr(0, placeholder));
+        aOut.append(aArgs[next++].text);
+        aFormat.remove_prefix(placeholder + 2);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::TraceDecoder::WriteTime(std::string& aOut, int64_t aNanoseconds)
+{
+    // Microseconds with three decimals, formatting the integer parts is much faster than formatting a double. The
+    // magnitude is unsigned, a damaged trace can hold any time, including the one that has no positive counterpart.
+    auto magnitude = static_cast<uint64_t>(aNanoseconds);
+    if (aNanoseconds < 0)
+    {
+        aOut.append(1, '-');
+        magnitude = 0 - magnitude;
+    }
+
+    char buffer[32];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), magnitude / 1000).ptr;
+
+    auto fraction = static_cast<uint32_t>(magnitude % 1000);
+    *end++ = '.';
+    *end++ = static_cast<char>('0' + fraction / 100);
+    *end++ = static_cast<char>('0' + fraction / 10 % 10);
+    *end++ = static_cast<char>('0' + fraction % 10);
+
+    aOut.append(buffer, end);
+}
+
+RED4EXT_INLINE void RED4ext::TraceDecoder::WriteJsonString(std::string& aOut, std::string_view aText)
+{
+    aOut.append(1, '"');
+
+    for (auto c : aText)
+    {
+        switch (c)
+        {
+        case '"':
+            aOut.append("\\\"");
+            break;
+        case '\\':
+            aOut.append("\\\\");
+            break;
+        case '\n':
+            aOut.append("\\n");
+            break;
+        case '\r':
+            aOut.append("\\r");
+            break;
+        case '\t':
+            aOut.append("\\t");
+            break;
+        default:
+        {
+            if (static_cast<uint8_t>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<uint8_t>(c));
+                aOut.append(escaped);
+            }
+            else
+            {
+                aOut.append(1, c);
+            }
+            break;
+        }
+        }
+    }
+
+    aOut.append(1, '"');
+}
+
+RED4EXT_INLINE void RED4ext::TraceDecoder::WriteJsonValue(std::string& aOut, const Arg& aArg)
+{
+    switch (aArg.type)
+    {
+    case TraceArgType::Int:
+    case TraceArgType::UInt:
+    case TraceArgType::Bool:
+    {
+        aOut.append(aArg.text);
+        break;
+    }
+    case TraceArgType::Float:
+    case TraceArgType::Double:
+    {
+        // JSON has no representation of infinity and NaN.
+        if (aArg.text.find_first_of("in") == std::string::npos)
+        {
+            aOut.append(aArg.text);
+        }
+        else
+        {
+            WriteJsonString(aOut, aArg.text);
+        }
+        break;
+    }
+    default:
+    {
+        WriteJsonString(aOut, aArg.text);
+        break;
+    }
+    }
+}
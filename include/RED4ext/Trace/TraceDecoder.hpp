@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <RED4ext/CharConv.hpp>
+#include <RED4ext/Common.hpp>
+#include <RED4ext/IO/MappedFileStream.hpp>
+#include <RED4ext/Trace/TraceFormat.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Reads traces written by TraceWriter and converts them to text, JSON lines or the Chrome trace event format.
+ *
+ * The decoder does not call into the game, it can be used by offline tools. Events are written in the order of their
+ * chunks, the events of a thread are always in order.
+ */
+class TraceDecoder
+{
+public:
+    enum class OutputFormat : uint8_t
+    {
+        Text,        // One line per event: time in microseconds, thread, message.
+        JsonLines,   // One JSON object per line with the message and the typed arguments.
+        ChromeTrace, // A JSON document for chrome://tracing and Perfetto.
+    };
+
+    TraceDecoder() = default;
+    TraceDecoder(const TraceDecoder&) = delete;
+    TraceDecoder& operator=(const TraceDecoder&) = delete;
+
+    /**
+     * @brief Maps and indexes a trace file.
+     * @return False if the file could not be opened or is not a valid trace.
+     */
+    bool Open(const std::filesystem::path& aPath);
+
+    /**
+     * @brief Indexes a trace in memory, the data must outlive the decoder.
+     * @return False if the data is not a valid trace.
+     */
+    bool Load(const uint8_t* aData, size_t aSize);
+
+    /**
+     * @brief Converts all events.
+     * @return False if an event is malformed, the events in front of it have been written.
+     */
+    bool Decode(std::ostream& aOut, OutputFormat aFormat) const;
+
+    [[nodiscard]] size_t GetChunkCount() const noexcept;
+
+private:
+    struct Format
+    {
+        TracePhase phase; // Zero if the id was not defined.
+        std::vector<TraceArgType> args;
+        std::string_view text;
+    };
+
+    struct Clock
+    {
+        uint64_t ticks;
+        uint64_t nanoseconds;
+    };
+
+    struct Chunk
+    {
+        uint32_t thread;
+        uint64_t firstTicks;
+        const uint8_t* begin;
+        const uint8_t* end;
+    };
+
+    struct Arg
+    {
+        TraceArgType type;
+        std::string text;
+    };
+
+    bool ReadBlock(TraceBlockKind aKind, const uint8_t* aIn, const uint8_t* aEnd);
+    const uint8_t* ReadArg(const uint8_t* aIn, const uint8_t* aEnd, TraceArgType aType, std::string& aText) const;
+    int64_t ToNanoseconds(uint64_t aTicks) const noexcept;
+
+    static void WriteMessage(std::string& aOut, std::string_view aFormat, const std::vector<Arg>& aArgs);
+    static void WriteTime(std::string& aOut, int64_t aNanoseconds);
+    static void WriteJsonString(std::string& aOut, std::string_view aText);
+    static void WriteJsonValue(std::string& aOut, const Arg& aArg);
+
+    MappedFileStream m_file;
+
+    std::vector<Format> m_formats;
+    std::unordered_map<uint64_t, std::string_view> m_names;
+    std::vector<Chunk> m_chunks;
+    std::vector<Clock> m_clocks;
+
+    uint64_t m_firstTicks = 0;
+    double m_nanosecondsPerTick = 1.0;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/Trace/TraceDecoder-inl.hpp>
+#endif
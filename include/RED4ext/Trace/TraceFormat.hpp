@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <RED4ext/CName.hpp>
+#include <RED4ext/Detail/Cycles.hpp>
+#include <RED4ext/NativeTypes.hpp>
+#include <RED4ext/ResourcePath.hpp>
+#include <RED4ext/Scripting/Natives/Vector4.hpp>
+
+/*
+ * The trace file is a header followed by blocks. Integers in blocks are LEB128 varints unless noted otherwise, signed
+ * integers are zigzag encoded first.
+ *
+ *  Header   uint32 magic, uint16 version, uint16 reserved
+ *  Block    uint8 kind, varint size of the payload, payload
+ *
+ *  Format   varint id, uint8 phase, uint8 argument count, uint8 argument types[count], varint length, characters
+ *  Name     uint64 hash (raw), varint length, characters
+ *  Clock    varint ticks, varint nanoseconds (steady clock), two of them map ticks to time
+ *  Chunk    varint thread, varint ticks of the first event, events until the end of the payload
+ *
+ *  Event    varint format id, varint ticks since the previous event of the chunk, arguments
+ *
+ * Format strings use "{}" as the placeholder for the next argument.
+ */
+
+namespace RED4ext
+{
+enum class TraceBlockKind : uint8_t
+{
+    Format = 1,
+    Name = 2,
+    Clock = 3,
+    Chunk = 4
+};
+
+enum class TraceArgType : uint8_t
+{
+    Int = 1,          // Zigzag varint.
+    UInt = 2,         // Varint.
+    Float = 3,        // 4 bytes.
+    Double = 4,       // 8 bytes.
+    Bool = 5,         // 1 byte.
+    String = 6,       // Varint length, characters.
+    Name = 7,         // 8 bytes, the hash.
+    TweakDBID = 8,    // 8 bytes.
+    ResourcePath = 9, // 8 bytes, the hash.
+    Vector4 = 10,     // 16 bytes.
+    Pointer = 11      // Varint.
+};
+
+enum class TracePhase : uint8_t
+{
+    Instant = 'i',
+    Begin = 'B',
+    End = 'E'
+};
+
+namespace Detail
+{
+inline constexpr uint32_t TraceMagic = 0x52545234; // 4RTR
+inline constexpr uint16_t TraceVersion = 1;
+inline constexpr size_t MaxVarIntSize = 10;
+
+inline uint8_t* WriteVarInt(uint8_t* aOut, uint64_t aValue) noexcept
+{
+    while (aValue >= 0x80)
+    {
+        *aOut++ = static_cast<uint8_t>(aValue) | 0x80;
+        aValue >>= 7;
+    }
+
+    *aOut++ = static_cast<uint8_t>(aValue);
+    return aOut;
+}
+
+/**
+ * @brief Reads a varint.
+ * @return The position after the varint, or nullptr if it is truncated or too long.
+ */
+inline const uint8_t* ReadVarInt(const uint8_t* aIn, const uint8_t* aEnd, uint64_t& aValue) noexcept
+{
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64 && aIn < aEnd; shift += 7)
+    {
+        auto byte = *aIn++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            aValue = value;
+            return aIn;
+        }
+    }
+
+    return nullptr;
+}
+
+inline uint64_t EncodeZigZag(int64_t aValue) noexcept
+{
+    return (static_cast<uint64_t>(aValue) << 1) ^ static_cast<uint64_t>(aValue >> 63);
+}
+
+inline int64_t DecodeZigZag(uint64_t aValue) noexcept
+{
+    return static_cast<int64_t>(aValue >> 1) ^ -static_cast<int64_t>(aValue & 1);
+}
+
+template<typename T>
+constexpr TraceArgType GetTraceArgType() noexcept
+{
+    using Type = std::decay_t<T>;
+
+    if constexpr (std::is_same_v<Type, bool>)
+        return TraceArgType::Bool;
+    else if constexpr (std::is_same_v<Type, float>)
+        return TraceArgType::Float;
+    else if constexpr (std::is_same_v<Type, double>)
+        return TraceArgType::Double;
+    else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+        return TraceArgType::String;
+    else if constexpr (std::is_same_v<Type, CName>)
+        return TraceArgType::Name;
+    else if constexpr (std::is_same_v<Type, TweakDBID>)
+        return TraceArgType::TweakDBID;
+    else if constexpr (std::is_same_v<Type, ResourcePath>)
+        return TraceArgType::ResourcePath;
+    else if constexpr (std::is_same_v<Type, Vector4>)
+        return TraceArgType::Vector4;
+    else if constexpr (std::is_pointer_v<Type>)
+        return TraceArgType::Pointer;
+    else if constexpr (std::is_enum_v<Type>)
+        return std::is_signed_v<std::underlying_type_t<Type>> ? TraceArgType::Int : TraceArgType::UInt;
+    else if constexpr (std::is_integral_v<Type>)
+        return std::is_signed_v<Type> ? TraceArgType::Int : TraceArgType::UInt;
+    else
+        static_assert(std::is_void_v<Type>, "The type can not be traced");
+}
+
+template<typename... Args>
+inline constexpr TraceArgType TraceSignature[sizeof...(Args) + 1] = {GetTraceArgType<Args>()..., TraceArgType{}};
+
+/**
+ * @brief Returns the length of a string argument, a null string is written as an empty one.
+ */
+template<typename T>
+size_t GetTraceStringLength(const T& aArg) noexcept
+{
+    // Arrays are never null, comparing them warns.
+    if constexpr (std::is_array_v<T>)
+        return std::strlen(aArg);
+    else
+        return aArg ? std::strlen(aArg) : 0;
+}
+
+/**
+ * @brief Returns the largest number of bytes the encoded argument can take.
+ */
+template<typename T>
+size_t GetTraceArgSize(const T& aArg) noexcept
+{
+    constexpr auto type = GetTraceArgType<T>();
+
+    if constexpr (type == TraceArgType::String)
+        return MaxVarIntSize + GetTraceStringLength(aArg);
+    else if constexpr (type == TraceArgType::Vector4)
+        return 4 * sizeof(float);
+    else
+        return MaxVarIntSize;
+}
+
+template<typename T>
+uint8_t* WriteTraceArg(uint8_t* aOut, const T& aArg) noexcept
+{
+    constexpr auto type = GetTraceArgType<T>();
+
+    if constexpr (type == TraceArgType::Int)
+    {
+        return WriteVarInt(aOut, EncodeZigZag(static_cast<int64_t>(aArg)));
+    }
+    else if constexpr (type == TraceArgType::UInt)
+    {
+        return WriteVarInt(aOut, static_cast<uint64_t>(aArg));
+    }
+    else if constexpr (type == TraceArgType::Pointer)
+    {
+        return WriteVarInt(aOut, reinterpret_cast<uintptr_t>(aArg));
+    }
+    else if constexpr (type == TraceArgType::Bool)
+    {
+        *aOut = aArg ? 1 : 0;
+        return aOut + 1;
+    }
+    else if constexpr (type == TraceArgType::String)
+    {
+        auto length = GetTraceStringLength(aArg);
+        aOut = WriteVarInt(aOut, length);
+
+        if (length)
+        {
+            std::memcpy(aOut, aArg, length);
+        }
+
+        return aOut + length;
+    }
+    else if constexpr (type == TraceArgType::Name || type == TraceArgType::ResourcePath)
+    {
+        uint64_t hash = aArg.hash;
+        std::memcpy(aOut, &hash, sizeof(hash));
+        return aOut + sizeof(hash);
+    }
+    else if constexpr (type == TraceArgType::TweakDBID)
+    {
+        std::memcpy(aOut, &aArg.value, sizeof(aArg.value));
+        return aOut + sizeof(aArg.value);
+    }
+    else if constexpr (type == TraceArgType::Vector4)
+    {
+        float values[] = {aArg.X, aArg.Y, aArg.Z, aArg.W};
+        std::memcpy(aOut, values, sizeof(values));
+        return aOut + sizeof(values);
+    }
+    else
+    {
+        std::memcpy(aOut, &aArg, sizeof(T));
+        return aOut + sizeof(T);
+    }
+}
+} // namespace Detail
+} // namespace RED4ext
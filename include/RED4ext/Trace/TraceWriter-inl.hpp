@@ -0,0 +1,313 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/Trace/TraceWriter.hpp>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+RED4EXT_INLINE RED4ext::TraceWriter::ThreadBuffer::ThreadBuffer(uint32_t aThread, uint32_t aCapacity)
+    : thread(aThread)
+    , used(0)
+    , capacity(aCapacity)
+    , firstTicks(0)
+    , lastTicks(0)
+    , data(new uint8_t[aCapacity])
+    , formats{}
+    , names{}
+{
+}
+
+RED4EXT_INLINE size_t RED4ext::TraceWriter::FormatKeyHash::operator()(const FormatKey& aKey) const noexcept
+{
+    auto hash = std::hash<const void*>()(aKey.format);
+    hash ^= std::hash<const void*>()(aKey.signature) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+    return hash ^ static_cast<size_t>(aKey.phase);
+}
+
+RED4EXT_INLINE RED4ext::TraceWriter::TraceWriter(const std::filesystem::path& aPath, uint32_t aChunkSize,
+                                                 bool aResolveNames)
+    : m_file(std::make_unique<BufferedWriteStream>(aPath))
+    , m_stream(m_file.get())
+    , m_chunkSize(aChunkSize)
+    , m_resolveNames(aResolveNames)
+    , m_hasError(m_file->HasError())
+    , m_dropped(0)
+{
+    Open();
+}
+
+RED4EXT_INLINE RED4ext::TraceWriter::TraceWriter(BaseStream& aTarget, uint32_t aChunkSize, bool aResolveNames)
+    : m_stream(&aTarget)
+    , m_chunkSize(aChunkSize)
+    , m_resolveNames(aResolveNames)
+    , m_hasError(false)
+    , m_dropped(0)
+{
+    Open();
+}
+
+RED4EXT_INLINE RED4ext::TraceWriter::~TraceWriter()
+{
+    Flush();
+
+    // Forget about the buffer of this thread, the other threads keep a stale entry that is never matched again.
+    auto& threadBuffers = GetThreadBuffers();
+    std::erase_if(threadBuffers, [this](const ThreadEntry& aEntry) { return aEntry.writerId == m_id; });
+}
+
+RED4EXT_INLINE bool RED4ext::TraceWriter::Flush()
+{
+    {
+        std::lock_guard<std::mutex> _(m_buffersLock);
+        for (const auto& buffer : m_buffers)
+        {
+            std::lock_guard<SpinLock> __(buffer->lock);
+            FlushChunk(*buffer);
+        }
+    }
+
+    std::lock_guard<std::mutex> _(m_streamLock);
+    WriteClock();
+
+    if (!m_hasError && !m_stream->Flush())
+    {
+        m_hasError = true;
+    }
+
+    return !m_hasError;
+}
+
+RED4EXT_INLINE bool RED4ext::TraceWriter::HasError() const noexcept
+{
+    return m_hasError;
+}
+
+RED4EXT_INLINE uint64_t RED4ext::TraceWriter::GetDroppedCount() const noexcept
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE std::vector<RED4ext::TraceWriter::ThreadEntry>& RED4ext::TraceWriter::GetThreadBuffers()
+{
+    static thread_local std::vector<ThreadEntry> buffers;
+    return buffers;
+}
+
+RED4EXT_INLINE RED4ext::TraceWriter::ThreadBuffer* RED4ext::TraceWriter::GetBuffer()
+{
+    auto& threadBuffers = GetThreadBuffers();
+    if (!threadBuffers.empty() && threadBuffers.front().writerId == m_id)
+    {
+        return threadBuffers.front().buffer;
+    }
+
+    // Threads usually record to a single writer, keep the last one used in front.
+    auto it = std::find_if(threadBuffers.begin(), threadBuffers.end(),
+                           [this](const ThreadEntry& aEntry) { return aEntry.writerId == m_id; });
+
+    if (it == threadBuffers.end())
+    {
+        std::lock_guard<std::mutex> _(m_buffersLock);
+
+        auto thread = static_cast<uint32_t>(m_buffers.size());
+        m_buffers.push_back(std::make_unique<ThreadBuffer>(thread, m_chunkSize));
+
+        threadBuffers.push_back({m_id, m_buffers.back().get()});
+        it = threadBuffers.end() - 1;
+    }
+
+    std::rotate(threadBuffers.begin(), it, it + 1);
+    return threadBuffers.front().buffer;
+}
+
+RED4EXT_INLINE uint32_t RED4ext::TraceWriter::GetFormatId(ThreadBuffer& aBuffer, const char* aFormat,
+                                                          const TraceArgType* aSignature, uint32_t aArgCount,
+                                                          TracePhase aPhase)
+{
+    auto& cached = aBuffer.formats[(reinterpret_cast<uintptr_t>(aFormat) >> 3) & (CacheSize - 1)];
+    if (cached.format == aFormat && cached.signature == aSignature && cached.phase == aPhase)
+    {
+        return cached.id;
+    }
+
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> _(m_formatsLock);
+
+        FormatKey key{aFormat, aSignature, aPhase};
+        auto it = m_formats.find(key);
+        if (it != m_formats.end())
+        {
+            id = it->second;
+        }
+        else
+        {
+            auto length = std::strlen(aFormat);
+            if (aArgCount > UINT8_MAX)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return InvalidFormatId;
+            }
+
+            id = static_cast<uint32_t>(m_formats.size());
+            m_formats.emplace(key, id);
+
+            std::vector<uint8_t> payload(2 * Detail::MaxVarIntSize + 2 + aArgCount + length);
+            auto out = Detail::WriteVarInt(payload.data(), id);
+            *out++ = static_cast<uint8_t>(aPhase);
+            *out++ = static_cast<uint8_t>(aArgCount);
+            std::memcpy(out, aSignature, aArgCount);
+            out = Detail::WriteVarInt(out + aArgCount, length);
+            std::memcpy(out, aFormat, length);
+
+            std::lock_guard<std::mutex> __(m_streamLock);
+            WriteBlock(TraceBlockKind::Format, payload.data(), out + length - payload.data());
+        }
+    }
+
+    cached = {aFormat, aSignature, aPhase, id};
+    return id;
+}
+
+RED4EXT_INLINE uint8_t* RED4ext::TraceWriter::Reserve(ThreadBuffer& aBuffer, size_t aSize, uint64_t& aTicks)
+{
+    if (aSize > aBuffer.capacity)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (aBuffer.used + aSize > aBuffer.capacity)
+    {
+        FlushChunk(aBuffer);
+    }
+
+    if (aBuffer.used == 0)
+    {
+        aBuffer.firstTicks = aTicks;
+        aBuffer.lastTicks = aTicks;
+    }
+
+    // The counters of different cores might be slightly off, keep the deltas of a thread positive.
+    aTicks = (std::max)(aTicks, aBuffer.lastTicks);
+    return aBuffer.data.get() + aBuffer.used;
+}
+
+RED4EXT_INLINE void RED4ext::TraceWriter::Open()
+{
+    static std::atomic<uint64_t> nextId = 1;
+    m_id = nextId.fetch_add(1, std::memory_order_relaxed);
+
+    uint8_t header[8];
+    auto magic = Detail::TraceMagic;
+    auto version = Detail::TraceVersion;
+    uint16_t reserved = 0;
+
+    std::memcpy(header, &magic, sizeof(magic));
+    std::memcpy(header + 4, &version, sizeof(version));
+    std::memcpy(header + 6, &reserved, sizeof(reserved));
+
+    std::lock_guard<std::mutex> _(m_streamLock);
+    Write(header, sizeof(header));
+    WriteClock();
+}
+
+RED4EXT_INLINE void RED4ext::TraceWriter::FlushChunk(ThreadBuffer& aBuffer)
+{
+    if (aBuffer.used == 0)
+    {
+        return;
+    }
+
+    uint8_t header[2 * Detail::MaxVarIntSize];
+    auto out = Detail::WriteVarInt(header, aBuffer.thread);
+    out = Detail::WriteVarInt(out, aBuffer.firstTicks);
+
+    auto headerSize = static_cast<size_t>(out - header);
+    auto size = headerSize + aBuffer.used;
+
+    std::lock_guard<std::mutex> _(m_streamLock);
+
+    if (m_resolveNames && !aBuffer.newNames.empty())
+    {
+        WriteNames(aBuffer.newNames);
+    }
+
+    uint8_t prefix[1 + Detail::MaxVarIntSize];
+    prefix[0] = static_cast<uint8_t>(TraceBlockKind::Chunk);
+    auto prefixEnd = Detail::WriteVarInt(prefix + 1, size);
+
+    Write(prefix, prefixEnd - prefix);
+    Write(header, headerSize);
+    Write(aBuffer.data.get(), aBuffer.used);
+
+    // Every chunk adds a reference point for the conversion of its ticks.
+    WriteClock();
+
+    aBuffer.used = 0;
+    aBuffer.newNames.clear();
+}
+
+RED4EXT_INLINE void RED4ext::TraceWriter::WriteNames(const std::vector<uint64_t>& aNames)
+{
+    for (auto hash : aNames)
+    {
+        if (!m_writtenNames.insert(hash).second)
+        {
+            continue;
+        }
+
+        auto text = CName(hash).ToString();
+        auto length = text ? std::strlen(text) : 0;
+
+        m_scratch.resize(sizeof(hash) + Detail::MaxVarIntSize + length);
+        std::memcpy(m_scratch.data(), &hash, sizeof(hash));
+        auto out = Detail::WriteVarInt(m_scratch.data() + sizeof(hash), length);
+        if (length)
+        {
+            std::memcpy(out, text, length);
+        }
+
+        WriteBlock(TraceBlockKind::Name, m_scratch.data(), out + length - m_scratch.data());
+    }
+}
+
+RED4EXT_INLINE void RED4ext::TraceWriter::WriteClock()
+{
+    auto ticks = Detail::ReadCycleCounter();
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(now);
+
+    uint8_t payload[2 * Detail::MaxVarIntSize];
+    auto out = Detail::WriteVarInt(payload, ticks);
+    out = Detail::WriteVarInt(out, static_cast<uint64_t>(time.count()));
+
+    WriteBlock(TraceBlockKind::Clock, payload, out - payload);
+}
+
+RED4EXT_INLINE void RED4ext::TraceWriter::WriteBlock(TraceBlockKind aKind, const uint8_t* aPayload, size_t aSize)
+{
+    uint8_t prefix[1 + Detail::MaxVarIntSize];
+    prefix[0] = static_cast<uint8_t>(aKind);
+    auto out = Detail::WriteVarInt(prefix + 1, aSize);
+
+    Write(prefix, out - prefix);
+    Write(aPayload, aSize);
+}
+
+RED4EXT_INLINE void RED4ext::TraceWriter::Write(const void* aData, size_t aSize)
+{
+    if (m_hasError || aSize == 0)
+    {
+        return;
+    }
+
+    if (!m_stream->ReadWrite(const_cast<void*>(aData), static_cast<uint32_t>(aSize)))
+    {
+        m_hasError = true;
+    }
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/IO/BaseStream.hpp>
+#include <RED4ext/IO/BufferedWriteStream.hpp>
+#include <RED4ext/SpinLock.hpp>
+#include <RED4ext/Trace/TraceFormat.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Records events in the binary trace format described in TraceFormat.hpp.
+ *
+ * An event stores the id of its format string, a timestamp and the encoded arguments, nothing is formatted. Each thread
+ * appends to its own chunk, full chunks are written to the stream by the thread that filled them. Format strings are
+ * assigned an id the first time they are used, names are resolved when their chunk is written.
+ *
+ * Format strings must outlive the writer (e.g. string literals), they are identified by their address.
+ */
+class TraceWriter
+{
+public:
+    static constexpr uint32_t DefaultChunkSize = 64 * 1024;
+
+    /**
+     * @param aPath The file to create.
+     * @param aChunkSize The size of the chunk of each thread in bytes.
+     * @param aResolveNames Write the text of the recorded names, this calls into the game.
+     */
+    TraceWriter(const std::filesystem::path& aPath, uint32_t aChunkSize = DefaultChunkSize, bool aResolveNames = true);
+    TraceWriter(BaseStream& aTarget, uint32_t aChunkSize = DefaultChunkSize, bool aResolveNames = true);
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /**
+     * @brief Writes the pending chunks. No thread may record anymore.
+     */
+    ~TraceWriter();
+
+    template<TracePhase P, typename... Args>
+    void Record(const char* aFormat, const Args&... aArgs)
+    {
+        auto buffer = GetBuffer();
+        auto ticks = Detail::ReadCycleCounter();
+
+        auto size = 2 * Detail::MaxVarIntSize + (size_t{0} + ... + Detail::GetTraceArgSize(aArgs));
+
+        std::lock_guard<SpinLock> _(buffer->lock);
+
+        auto id = GetFormatId(*buffer, aFormat, Detail::TraceSignature<Args...>, sizeof...(Args), P);
+        if (id == InvalidFormatId)
+        {
+            return;
+        }
+
+        auto out = Reserve(*buffer, size, ticks);
+        if (!out)
+        {
+            return;
+        }
+
+        out = Detail::WriteVarInt(out, id);
+        out = Detail::WriteVarInt(out, ticks - buffer->lastTicks);
+        ((out = Detail::WriteTraceArg(out, aArgs)), ...);
+
+        if constexpr ((... || (Detail::GetTraceArgType<Args>() == TraceArgType::Name)))
+        {
+            (AddName(*buffer, aArgs), ...);
+        }
+
+        buffer->lastTicks = ticks;
+        buffer->used = static_cast<uint32_t>(out - buffer->data.get());
+    }
+
+    template<typename... Args>
+    void Event(const char* aFormat, const Args&... aArgs)
+    {
+        Record<TracePhase::Instant>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    void Begin(const char* aFormat, const Args&... aArgs)
+    {
+        Record<TracePhase::Begin>(aFormat, aArgs...);
+    }
+
+    template<typename... Args>
+    void End(const char* aFormat, const Args&... aArgs)
+    {
+        Record<TracePhase::End>(aFormat, aArgs...);
+    }
+
+    /**
+     * @brief Writes the chunks of all threads and flushes the stream.
+     * @return False if writing failed.
+     */
+    bool Flush();
+
+    [[nodiscard]] bool HasError() const noexcept;
+
+    /**
+     * @brief Returns the number of events that were discarded because they did not fit into a chunk.
+     */
+    [[nodiscard]] uint64_t GetDroppedCount() const noexcept;
+
+private:
+    static constexpr uint32_t InvalidFormatId = UINT32_MAX;
+    static constexpr uint32_t CacheSize = 64;
+
+    struct CachedFormat
+    {
+        const char* format;
+        const TraceArgType* signature;
+        TracePhase phase;
+        uint32_t id;
+    };
+
+    struct ThreadBuffer
+    {
+        ThreadBuffer(uint32_t aThread, uint32_t aCapacity);
+
+        SpinLock lock;
+        uint32_t thread;
+        uint32_t used;
+        uint32_t capacity;
+        uint64_t firstTicks;
+        uint64_t lastTicks;
+        std::unique_ptr<uint8_t[]> data;
+
+        CachedFormat formats[CacheSize];
+        uint64_t names[CacheSize];      // Names recently seen by the thread, written or queued.
+        std::vector<uint64_t> newNames; // Names of the chunk that might not have been written yet.
+    };
+
+    struct ThreadEntry
+    {
+        uint64_t writerId;
+        ThreadBuffer* buffer;
+    };
+
+    struct FormatKey
+    {
+        const char* format;
+        const TraceArgType* signature;
+        TracePhase phase;
+
+        bool operator==(const FormatKey&) const = default;
+    };
+
+    struct FormatKeyHash
+    {
+        size_t operator()(const FormatKey& aKey) const noexcept;
+    };
+
+    static std::vector<ThreadEntry>& GetThreadBuffers();
+
+    template<typename T>
+    void AddName(ThreadBuffer& aBuffer, const T& aArg)
+    {
+        if constexpr (Detail::GetTraceArgType<T>() == TraceArgType::Name)
+        {
+            auto& slot = aBuffer.names[(aArg.hash ^ (aArg.hash >> 32)) & (CacheSize - 1)];
+            if (slot != aArg.hash)
+            {
+                slot = aArg.hash;
+                aBuffer.newNames.push_back(aArg.hash);
+            }
+        }
+    }
+
+    ThreadBuffer* GetBuffer();
+    uint32_t GetFormatId(ThreadBuffer& aBuffer, const char* aFormat, const TraceArgType* aSignature,
+                         uint32_t aArgCount, TracePhase aPhase);
+    uint8_t* Reserve(ThreadBuffer& aBuffer, size_t aSize, uint64_t& aTicks);
+
+    void Open();
+    void FlushChunk(ThreadBuffer& aBuffer);
+    void WriteNames(const std::vector<uint64_t>& aNames);
+    void WriteClock();
+    void WriteBlock(TraceBlockKind aKind, const uint8_t* aPayload, size_t aSize);
+    void Write(const void* aData, size_t aSize);
+
+    std::unique_ptr<BufferedWriteStream> m_file;
+    BaseStream* m_stream;
+    uint32_t m_chunkSize;
+    bool m_resolveNames;
+    uint64_t m_id; // Unique per writer, the address could be reused by another one.
+
+    std::mutex m_buffersLock;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    std::mutex m_formatsLock;
+    std::unordered_map<FormatKey, uint32_t, FormatKeyHash> m_formats;
+
+    std::mutex m_streamLock; // Guards the stream and the fields below.
+    std::unordered_set<uint64_t> m_writtenNames;
+    std::vector<uint8_t> m_scratch;
+    std::atomic<bool> m_hasError;
+
+    std::atomic<uint64_t> m_dropped;
+};
+
+/**
+ * @brief Records a begin event on construction and the matching end event on destruction.
+ */
+class TraceScope
+{
+public:
+    template<typename... Args>
+    TraceScope(TraceWriter& aWriter, const char* aFormat, const Args&... aArgs)
+        : m_writer(aWriter)
+        , m_format(aFormat)
+    {
+        m_writer.Begin(aFormat, aArgs...);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope()
+    {
+        m_writer.End(m_format);
+    }
+
+private:
+    TraceWriter& m_writer;
+    const char* m_format;
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/Trace/TraceWriter-inl.hpp>
+#endif
@@ -4,9 +4,13 @@
 #include <RED4ext/TweakDB.hpp>
 #endif
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <unordered_set>
 
 #include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/Hashing/FNV1a.hpp>
 #include <RED4ext/RTTISystem.hpp>
 #include <RED4ext/Relocation.hpp>
 
@@ -318,25 +322,250 @@ RED4EXT_INLINE RED4ext::TweakDB::FlatValue* RED4ext::TweakDB::GetFlatValue(Tweak
     return reinterpret_cast<FlatValue*>(flatDataBuffer + aDBID.ToTDBOffset());
 }
 
+namespace RED4ext::Detail
+{
+template<typename T>
+uint64_t HashFlatData(const T& aValue, uint64_t aSeed)
+{
+    return FNV1a64(reinterpret_cast<const uint8_t*>(&aValue), sizeof(T), aSeed);
+}
+
+RED4EXT_INLINE uint64_t HashFlatData(const CString& aValue, uint64_t aSeed)
+{
+    return FNV1a64(reinterpret_cast<const uint8_t*>(aValue.c_str()), aValue.Length(), aSeed);
+}
+
+template<typename T>
+uint64_t HashFlatData(const DynArray<T>& aValue, uint64_t aSeed)
+{
+    auto hash = HashFlatData(aValue.size, aSeed);
+    for (const auto& element : aValue)
+    {
+        hash = HashFlatData(element, hash);
+    }
+
+    return hash;
+}
+
+template<typename T>
+bool IsFlatDataEqual(const T& aLhs, const T& aRhs)
+{
+    return std::memcmp(&aLhs, &aRhs, sizeof(T)) == 0;
+}
+
+RED4EXT_INLINE bool IsFlatDataEqual(const CString& aLhs, const CString& aRhs)
+{
+    return aLhs.Length() == aRhs.Length() && std::memcmp(aLhs.c_str(), aRhs.c_str(), aLhs.Length()) == 0;
+}
+
+template<typename T>
+bool IsFlatDataEqual(const DynArray<T>& aLhs, const DynArray<T>& aRhs)
+{
+    if (aLhs.size != aRhs.size)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < aLhs.size; i++)
+    {
+        if (!IsFlatDataEqual(aLhs[i], aRhs[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Calls aFunc with a null pointer of the C++ type matching the flat type name, returns false for unknown types.
+template<typename F>
+bool VisitFlatDataType(CName aTypeName, F&& aFunc)
+{
+#define RED4EXT_TDB_POOL_CASE(N, T)                                                                                    \
+    case CName(N):                                                                                                     \
+    {                                                                                                                  \
+        aFunc(static_cast<const T*>(nullptr));                                                                         \
+        return true;                                                                                                   \
+    }                                                                                                                  \
+    case CName("array:" N):                                                                                            \
+    {                                                                                                                  \
+        aFunc(static_cast<const DynArray<T>*>(nullptr));                                                               \
+        return true;                                                                                                   \
+    }
+
+    switch (aTypeName)
+    {
+        RED4EXT_TDB_POOL_CASE("TweakDBID", TweakDBID);
+        RED4EXT_TDB_POOL_CASE("Quaternion", Quaternion);
+        RED4EXT_TDB_POOL_CASE("EulerAngles", EulerAngles);
+        RED4EXT_TDB_POOL_CASE("Vector3", Vector3);
+        RED4EXT_TDB_POOL_CASE("Vector2", Vector2);
+        RED4EXT_TDB_POOL_CASE("Color", Color);
+        RED4EXT_TDB_POOL_CASE("gamedataLocKeyWrapper", gamedataLocKeyWrapper);
+        RED4EXT_TDB_POOL_CASE("raRef:CResource", ResourceAsyncReference<CResource>);
+        RED4EXT_TDB_POOL_CASE("CName", CName);
+        RED4EXT_TDB_POOL_CASE("Bool", bool);
+        RED4EXT_TDB_POOL_CASE("String", CString);
+        RED4EXT_TDB_POOL_CASE("Float", float);
+        RED4EXT_TDB_POOL_CASE("Int32", int32_t);
+    }
+
+#undef RED4EXT_TDB_POOL_CASE
+
+    return false;
+}
+
+RED4EXT_INLINE bool HashFlatValue(CName aTypeName, const void* aValue, uint64_t& aHash)
+{
+    return VisitFlatDataType(aTypeName,
+                             [aValue, &aHash](auto aType)
+                             {
+                                 using Type = std::remove_const_t<std::remove_pointer_t<decltype(aType)>>;
+                                 aHash = HashFlatData(*static_cast<const Type*>(aValue), 0xCBF29CE484222325);
+                             });
+}
+
+RED4EXT_INLINE bool IsFlatValueEqual(CName aTypeName, const void* aLhs, const void* aRhs)
+{
+    bool isEqual = false;
+    VisitFlatDataType(aTypeName,
+                      [aLhs, aRhs, &isEqual](auto aType)
+                      {
+                          using Type = std::remove_const_t<std::remove_pointer_t<decltype(aType)>>;
+                          isEqual = IsFlatDataEqual(*static_cast<const Type*>(aLhs), *static_cast<const Type*>(aRhs));
+                      });
+
+    return isEqual;
+}
+} // namespace RED4ext::Detail
+
 RED4EXT_INLINE int32_t RED4ext::TweakDB::CreateFlatValue(const CStackType& aStackType)
 {
     std::lock_guard<SharedSpinLock> _(mutex00);
 
-    UpsizeFlatDataBuffer(MaxFlatDataBufferSize);
+    return CreateFlatValueUnlocked(aStackType);
+}
 
+RED4EXT_INLINE int32_t RED4ext::TweakDB::CreateFlatValueUnlocked(const CStackType& aStackType)
+{
     uintptr_t flatAlignment = (std::max)(static_cast<uintptr_t>(aStackType.type->GetAlignment()), static_cast<uintptr_t>(8));
     uintptr_t flatValueSize = RED4ext::AlignUp(static_cast<uintptr_t>(8) /* vftable */ + static_cast<uintptr_t>(aStackType.type->GetSize()), flatAlignment);
+
+    auto& pool = GetFlatValuePool();
+    auto typeName = aStackType.type->GetName();
+
+    uint64_t hash = 0;
+    auto isPoolable = Detail::HashFlatValue(typeName, aStackType.value, hash);
+    if (isPoolable)
+    {
+        auto offset = FindPooledFlatValue(pool, typeName, aStackType.value, hash);
+        if (offset != -1)
+        {
+            pool.stats.reusedValues++;
+            pool.stats.bytesSaved += flatValueSize;
+            return offset;
+        }
+    }
+
     uintptr_t flatDataBufferEnd_Aligned = RED4ext::AlignUp(flatDataBufferEnd, flatAlignment);
+    if (flatDataBufferEnd_Aligned + flatValueSize > flatDataBuffer + flatDataBufferCapacity)
+    {
+        // Only grow when the value does not fit, the buffer is upsized to the max capacity in one go.
+        UpsizeFlatDataBuffer(MaxFlatDataBufferSize);
+
+        flatDataBufferEnd_Aligned = RED4ext::AlignUp(flatDataBufferEnd, flatAlignment);
+        if (flatDataBufferEnd_Aligned + flatValueSize > flatDataBuffer + flatDataBufferCapacity)
+            return -1;
+    }
 
     if (AllocateFlatValue(reinterpret_cast<void*>(flatDataBufferEnd_Aligned), aStackType))
     {
         flatDataBufferEnd = flatDataBufferEnd_Aligned + flatValueSize;
-        return reinterpret_cast<FlatValue*>(flatDataBufferEnd_Aligned)->ToTDBOffset();
+
+        auto offset = static_cast<int32_t>(flatDataBufferEnd_Aligned - flatDataBuffer);
+        if (isPoolable)
+        {
+            pool.offsetsByType[typeName].emplace(hash, offset);
+            pool.stats.pooledValues++;
+        }
+
+        return offset;
+    }
+
+    return -1;
+}
+
+RED4EXT_INLINE RED4ext::TweakDB::FlatValuePool& RED4ext::TweakDB::GetFlatValuePool()
+{
+    static FlatValuePool pool{};
+
+    if (pool.owner != this)
+    {
+        pool.owner = this;
+        pool.isBuilt = false;
+        pool.offsetsByType.clear();
+        pool.stats = {};
+    }
+
+    if (pool.isBuilt)
+    {
+        return pool;
+    }
+
+    // Index the values that are already in the buffer. Offsets are relative, they survive the buffer being upsized.
+    std::unordered_set<int32_t> visited;
+    visited.reserve(flats.size);
+
+    auto bufferSize = static_cast<int32_t>(flatDataBufferEnd - flatDataBuffer);
+    for (const auto& flat : flats)
+    {
+        auto offset = flat.ToTDBOffset();
+        if (offset < 0 || offset >= bufferSize || !visited.insert(offset).second)
+            continue;
+
+        auto* flatValue = reinterpret_cast<FlatValue*>(flatDataBuffer + offset);
+
+        CName typeName;
+        flatValue->GetTypeName(&typeName);
+
+        uint64_t hash = 0;
+        if (Detail::HashFlatValue(typeName, flatValue->GetDataPtr(), hash))
+        {
+            pool.offsetsByType[typeName].emplace(hash, offset);
+            pool.stats.pooledValues++;
+        }
+    }
+
+    pool.isBuilt = true;
+    return pool;
+}
+
+RED4EXT_INLINE int32_t RED4ext::TweakDB::FindPooledFlatValue(FlatValuePool& aPool, CName aTypeName,
+                                                             const void* aValue, uint64_t aHash)
+{
+    auto offsets = aPool.offsetsByType.find(aTypeName);
+    if (offsets == aPool.offsetsByType.end())
+        return -1;
+
+    auto [begin, end] = offsets->second.equal_range(aHash);
+    for (auto it = begin; it != end; ++it)
+    {
+        // Values can be modified in place after they were indexed, always compare the actual data.
+        auto* flatValue = reinterpret_cast<FlatValue*>(flatDataBuffer + it->second);
+        if (Detail::IsFlatValueEqual(aTypeName, flatValue->GetDataPtr(), aValue))
+            return it->second;
     }
 
     return -1;
 }
 
+RED4EXT_INLINE RED4ext::TweakDB::FlatValuePoolStats RED4ext::TweakDB::GetFlatValuePoolStats()
+{
+    std::lock_guard<SharedSpinLock> _(mutex00);
+
+    return GetFlatValuePool().stats;
+}
+
 RED4EXT_INLINE bool RED4ext::TweakDB::AllocateFlatValue(void* aBuffer, const CStackType& aStackType)
 {
 #define RED4EXT_TDB_FLAT_CASE(N, T)                                                                                    \
@@ -436,6 +665,209 @@ RED4EXT_INLINE const RED4ext::TweakDB::FlatValue* RED4ext::TweakDB::GetDefaultFl
     return flatValue ? *flatValue : nullptr;
 }
 
+RED4EXT_INLINE RED4ext::TweakDB::Batch::Batch(TweakDB* aTweakDB)
+    : m_tweakDB(aTweakDB)
+{
+}
+
+RED4EXT_INLINE void RED4ext::TweakDB::Batch::Reserve(uint32_t aFlatCount, uint32_t aRecordCount)
+{
+    m_flats.reserve(aFlatCount);
+    m_records.reserve(aRecordCount);
+}
+
+RED4EXT_INLINE void RED4ext::TweakDB::Batch::AddFlat(TweakDBID aDBID)
+{
+    m_flats.push_back({aDBID, {}});
+}
+
+RED4EXT_INLINE void RED4ext::TweakDB::Batch::AddFlat(TweakDBID aDBID, const CStackType& aValue)
+{
+    if (aValue.type)
+    {
+        m_flats.push_back({aDBID, aValue});
+    }
+}
+
+RED4EXT_INLINE void RED4ext::TweakDB::Batch::AddRecord(TweakDBID aDBID, CBaseRTTIType* aType)
+{
+    m_records.push_back({aDBID, aType, 0});
+}
+
+RED4EXT_INLINE void RED4ext::TweakDB::Batch::AddRecord(TweakDBID aDBID, uint32_t aTweakBaseHash)
+{
+    m_records.push_back({aDBID, nullptr, aTweakBaseHash});
+}
+
+RED4EXT_INLINE bool RED4ext::TweakDB::Batch::Commit(std::vector<TweakDBID>* aDuplicates,
+                                                    std::vector<TweakDBID>* aFailed)
+{
+    if (!m_tweakDB)
+    {
+        Clear();
+        return false;
+    }
+
+    // Flats first, records read their flats when they are created.
+    auto addedFlats = CommitFlats(aDuplicates, aFailed);
+    auto addedRecords = CommitRecords(aFailed);
+
+    Clear();
+    return addedFlats || addedRecords;
+}
+
+RED4EXT_INLINE void RED4ext::TweakDB::Batch::Clear()
+{
+    m_flats.clear();
+    m_records.clear();
+}
+
+RED4EXT_INLINE bool RED4ext::TweakDB::Batch::CommitFlats(std::vector<TweakDBID>* aDuplicates,
+                                                         std::vector<TweakDBID>* aFailed)
+{
+    if (m_flats.empty())
+    {
+        return false;
+    }
+
+    // Sort by ID, the stable sort keeps the flats of the same ID in the order they were added.
+    std::stable_sort(m_flats.begin(), m_flats.end(),
+                     [](const PendingFlat& aLhs, const PendingFlat& aRhs) { return aLhs.dbid < aRhs.dbid; });
+
+    std::lock_guard<SharedSpinLock> _(m_tweakDB->mutex00);
+
+    // Walk the batch and TweakDB::flats side by side, only the first occurrence of a new flat is kept.
+    const auto& flats = m_tweakDB->flats;
+    auto existing = flats.begin();
+
+    uint32_t count = 0;
+    for (auto i = 0u; i < m_flats.size(); ++i)
+    {
+        auto& flat = m_flats[i];
+        if (!flat.dbid.IsValid())
+        {
+            continue;
+        }
+
+        while (existing != flats.end() && *existing < flat.dbid)
+        {
+            ++existing;
+        }
+
+        if ((existing != flats.end() && *existing == flat.dbid) || (count > 0 && m_flats[count - 1].dbid == flat.dbid))
+        {
+            if (aDuplicates)
+            {
+                aDuplicates->push_back(flat.dbid);
+            }
+
+            continue;
+        }
+
+        m_flats[count++] = flat;
+    }
+
+    // Only the values of the flats that are added end up in the buffer.
+    std::vector<TweakDBID> added;
+    added.reserve(count);
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto& [dbid, value] = m_flats[i];
+        if (value.type)
+        {
+            auto offset = m_tweakDB->CreateFlatValueUnlocked(value);
+            if (offset == -1)
+            {
+                if (aFailed)
+                {
+                    aFailed->push_back(dbid);
+                }
+
+                continue;
+            }
+
+            dbid.SetTDBOffset(offset);
+        }
+
+        added.push_back(dbid);
+    }
+
+    return m_tweakDB->flats.InsertSorted(added.data(), static_cast<uint32_t>(added.size())) > 0;
+}
+
+RED4EXT_INLINE bool RED4ext::TweakDB::Batch::CommitRecords(std::vector<TweakDBID>* aFailed)
+{
+    using CreateTDBRecord_t = void (*)(TweakDB*, uint32_t aBaseMurmur3, TweakDBID aDBID);
+    static UniversalRelocFunc<CreateTDBRecord_t> CreateTDBRecord(Detail::AddressHashes::TweakDB_CreateRecord);
+
+    if (m_records.empty())
+    {
+        return false;
+    }
+
+    // Resolve the base hashes and drop the existing records with a single lock.
+    uint32_t count = 0;
+    {
+        std::shared_lock<SharedSpinLock> _(m_tweakDB->mutex01);
+
+        CBaseRTTIType* lastType = nullptr;
+        uint32_t lastHash = 0;
+
+        for (const auto& record : m_records)
+        {
+            if (!record.dbid.IsValid() || m_tweakDB->recordsByID.Get(record.dbid))
+            {
+                continue;
+            }
+
+            auto tweakBaseHash = record.tweakBaseHash;
+            if (record.type)
+            {
+                // Records of the same type are usually added together.
+                if (record.type != lastType)
+                {
+                    const auto* records = m_tweakDB->recordsByType.Get(record.type);
+                    if (records == nullptr || records->size == 0)
+                    {
+                        if (aFailed)
+                        {
+                            aFailed->push_back(record.dbid);
+                        }
+
+                        continue;
+                    }
+
+                    lastType = record.type;
+                    lastHash = reinterpret_cast<gamedataTweakDBRecord*>((*records)[0].GetPtr())->GetTweakBaseHash();
+                }
+
+                tweakBaseHash = lastHash;
+            }
+
+            m_records[count++] = {record.dbid, nullptr, tweakBaseHash};
+        }
+    }
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<SharedSpinLock> _(m_tweakDB->mutex01);
+        m_tweakDB->recordsByID.Reserve(m_tweakDB->recordsByID.size + count);
+    }
+
+    // The game function inserts the record itself, it can not be called with the lock held.
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CreateTDBRecord(m_tweakDB, m_records[i].tweakBaseHash, m_records[i].dbid);
+    }
+
+    return true;
+}
+
 RED4EXT_INLINE RED4ext::TweakDB* RED4ext::TweakDB::Get()
 {
     using Get_t = TweakDB* (*)();
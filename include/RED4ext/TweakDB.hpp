@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <RED4ext/Common.hpp>
 #include <RED4ext/DynArray.hpp>
@@ -32,8 +34,9 @@ namespace RED4ext
 //
 // 2. Flat values are pooled.
 //    An int (or any type) value of '1' exist only once in TweakDB::flatDataBuffer. Modifying it will affect all records
-//    Implementing a value pool here is pointless. the lib isn't a shared library. Pool won't be shared between dlls
-//    Could abuse the alignment gaps in TweakDB to store custom data in the class.. like a pointer to the pool? >_>
+//    CreateFlatValue pools values too, it returns the existing value when an identical one is already in the buffer.
+//    The pool index lives in this lib (it isn't a shared library), so every dll builds its own index. That is fine,
+//    the index is built from the buffer itself and always compares the actual data before reusing a value.
 
 struct TweakDB
 {
@@ -143,6 +146,63 @@ struct TweakDB
     RED4EXT_ASSERT_OFFSET(QuaternionFlatValue, data, 0x10);
     RED4EXT_ASSERT_SIZE(QuaternionFlatValue, 0x20);
 
+    /**
+     * @brief Collects flats and records and adds them to TweakDB in bulk.
+     *
+     * Adding items one by one locks for every item and inserts each flat with a memmove of the tail of
+     * TweakDB::flats. The batch sorts the flats once, merges them in a single linear pass and creates the flat values
+     * under one lock acquisition. Records are created after the flats, since they read their flats on creation.
+     *
+     * Like TweakDB::AddFlat, existing flats are never replaced. A flat that already exists in TweakDB, or that was
+     * added earlier to the same batch, is skipped and reported as a duplicate by Commit(). Flats whose value could not
+     * be created and records whose type has no records to take the base hash from are reported as failed.
+     */
+    class Batch
+    {
+    public:
+        explicit Batch(TweakDB* aTweakDB = TweakDB::Get());
+
+        void Reserve(uint32_t aFlatCount, uint32_t aRecordCount);
+
+        // TweakDBID must include tdbOffset
+        void AddFlat(TweakDBID aDBID);
+        // The value is copied into flatDataBuffer by Commit, it must stay valid until then
+        void AddFlat(TweakDBID aDBID, const CStackType& aValue);
+
+        void AddRecord(TweakDBID aDBID, CBaseRTTIType* aType);
+        void AddRecord(TweakDBID aDBID, uint32_t aTweakBaseHash);
+
+        /**
+         * @brief Publishes everything collected so far and clears the batch.
+         * @param aDuplicates Optional, receives the flats that were skipped because they already exist.
+         * @param aFailed Optional, receives the flats and records that could not be created.
+         * @return True if at least one flat or record was added.
+         */
+        bool Commit(std::vector<TweakDBID>* aDuplicates = nullptr, std::vector<TweakDBID>* aFailed = nullptr);
+        void Clear();
+
+    private:
+        struct PendingFlat
+        {
+            TweakDBID dbid;
+            CStackType value; // Empty if the TweakDBID already includes tdbOffset.
+        };
+
+        struct PendingRecord
+        {
+            TweakDBID dbid;
+            CBaseRTTIType* type;
+            uint32_t tweakBaseHash;
+        };
+
+        bool CommitFlats(std::vector<TweakDBID>* aDuplicates, std::vector<TweakDBID>* aFailed);
+        bool CommitRecords(std::vector<TweakDBID>* aFailed);
+
+        TweakDB* m_tweakDB;
+        std::vector<PendingFlat> m_flats; // In the order they were added, the first occurrence of a flat wins.
+        std::vector<PendingRecord> m_records;
+    };
+
     uintptr_t staticFlatDataBuffer; // 00 - same as flatDataBuffer, used for direct access
     uint64_t unk08;                 // 08
     void* unkF0;                    // F0
@@ -228,12 +288,36 @@ struct TweakDB
 
     void UpsizeFlatDataBufferToMax();
 
+    struct FlatValuePoolStats
+    {
+        uint32_t pooledValues; // Number of values known to the pool.
+        uint32_t reusedValues; // Number of CreateFlatValue calls that returned an existing value.
+        uint64_t bytesSaved;   // Bytes of flatDataBuffer not used thanks to reused values.
+    };
+
+    FlatValuePoolStats GetFlatValuePoolStats();
+
     static TweakDB* Get();
 
 private:
+    // Content-hash index of the values in flatDataBuffer, partitioned by type name.
+    struct FlatValuePool
+    {
+        const TweakDB* owner;
+        bool isBuilt;
+        std::unordered_map<uint64_t, std::unordered_multimap<uint64_t, int32_t>> offsetsByType;
+        FlatValuePoolStats stats;
+    };
+
+    // Assumes mutex00 is locked
+    FlatValuePool& GetFlatValuePool();
+    int32_t FindPooledFlatValue(FlatValuePool& aPool, CName aTypeName, const void* aValue, uint64_t aHash);
+
     // Multithreads may lead to undefined behavior
     void SetFlatDataBuffer(void* aBuffer, uint32_t aSize, uint32_t aCapacity);
     bool AllocateFlatValue(void* aBuffer, const CStackType& aStackType);
+    // Assumes mutex00 is locked
+    int32_t CreateFlatValueUnlocked(const CStackType& aStackType);
     void UpsizeFlatDataBuffer(uint32_t aCapacity);
 };
 RED4EXT_ASSERT_OFFSET(TweakDB, mutex00, 0x20);
@@ -0,0 +1,257 @@
+#pragma once
+
+#ifdef RED4EXT_STATIC_LIB
+#include <RED4ext/UpdateProfiler.hpp>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+RED4EXT_INLINE void RED4ext::UpdateProfiler::RegisterUpdate(UpdateRegistrar* aRegistrar, UpdateTickGroup aGroup,
+                                                            IUpdatableSystem* aSystem, const char* aName,
+                                                            GroupUpdateCallback&& aCallback)
+{
+    aRegistrar->RegisterUpdate(aGroup, aSystem, aName, Wrap(aGroup, aName, std::move(aCallback)));
+}
+
+RED4EXT_INLINE void RED4ext::UpdateProfiler::RegisterUpdate(UpdateRegistrar* aRegistrar, UpdateBucketMask aBuckets,
+                                                            UpdateBucketStage aStage, IUpdatableSystem* aSystem,
+                                                            const char* aName, BucketUpdateCallback&& aCallback)
+{
+    aRegistrar->RegisterUpdate(aBuckets, aStage, aSystem, aName, Wrap(aBuckets, aStage, aName, std::move(aCallback)));
+}
+
+RED4EXT_INLINE RED4ext::GroupUpdateCallback RED4ext::UpdateProfiler::Wrap(UpdateTickGroup aGroup, const char* aName,
+                                                                          GroupUpdateCallback&& aCallback)
+{
+    auto entry = AddEntry(aName, false);
+    entry->group = aGroup;
+    entry->groupCallback = std::move(aCallback);
+
+    // The wrapped callback does not fit into the inline storage of another one, the closure only keeps the entry.
+    return [entry](FrameInfo& aFrame, JobQueue& aJobQueue)
+    { Invoke(*entry, 0, [&]() { entry->groupCallback(aFrame, aJobQueue); }); };
+}
+
+RED4EXT_INLINE RED4ext::BucketUpdateCallback RED4ext::UpdateProfiler::Wrap(UpdateBucketMask aBuckets,
+                                                                           UpdateBucketStage aStage, const char* aName,
+                                                                           BucketUpdateCallback&& aCallback)
+{
+    auto entry = AddEntry(aName, true);
+    entry->buckets = aBuckets;
+    entry->stage = aStage;
+    entry->bucketCallback = std::move(aCallback);
+
+    return [entry](UpdateBucketEnum aBucket, FrameInfo& aFrame, JobQueue& aJobQueue)
+    {
+        auto slot = (std::min)(static_cast<uint32_t>(aBucket), SlotCount - 1);
+        Invoke(*entry, slot, [&]() { entry->bucketCallback(std::move(aBucket), aFrame, aJobQueue); });
+    };
+}
+
+RED4EXT_INLINE void RED4ext::UpdateProfiler::RegisterFrameMarker(UpdateRegistrar* aRegistrar,
+                                                                 IUpdatableSystem* aSystem)
+{
+    aRegistrar->RegisterUpdate(UpdateTickGroup::FrameBegin, aSystem, "UpdateProfiler::NextFrame",
+                               [](FrameInfo&, JobQueue&) { NextFrame(); });
+}
+
+RED4EXT_INLINE void RED4ext::UpdateProfiler::NextFrame()
+{
+    auto& state = GetState();
+
+    auto ticks = Detail::ReadCycleCounter();
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+
+    std::lock_guard<std::mutex> _(state.lock);
+
+    // The rate of the counter is estimated over the whole session, it gets more precise with every frame.
+    if (state.frames == 0)
+    {
+        state.firstTicks = ticks;
+        state.firstNanoseconds = nanoseconds;
+    }
+    else if (ticks > state.firstTicks && nanoseconds > state.firstNanoseconds)
+    {
+        state.nanosecondsPerTick = static_cast<double>(nanoseconds - state.firstNanoseconds) /
+                                   static_cast<double>(ticks - state.firstTicks);
+    }
+
+    auto slot = state.frames % WindowSize;
+    for (const auto& entry : state.entries)
+    {
+        uint64_t total = 0;
+        for (auto& counter : entry->slots)
+        {
+            total += counter.ticks.load(std::memory_order_relaxed);
+            counter.ticks.store(0, std::memory_order_relaxed);
+        }
+
+        entry->window[slot] = total;
+    }
+
+    ++state.frames;
+
+    if (auto writer = state.traceWriter.load(std::memory_order_relaxed))
+    {
+        writer->Event("Frame {}", state.frames);
+    }
+}
+
+RED4EXT_INLINE void RED4ext::UpdateProfiler::SetEnabled(bool aEnabled) noexcept
+{
+    GetState().isEnabled.store(aEnabled, std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE bool RED4ext::UpdateProfiler::IsEnabled() noexcept
+{
+    return GetState().isEnabled.load(std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE void RED4ext::UpdateProfiler::SetTraceWriter(TraceWriter* aWriter) noexcept
+{
+    GetState().traceWriter.store(aWriter, std::memory_order_relaxed);
+}
+
+RED4EXT_INLINE std::vector<RED4ext::UpdateProfiler::Timing> RED4ext::UpdateProfiler::GetTimings()
+{
+    std::vector<const Entry*> entries;
+    {
+        auto& state = GetState();
+
+        std::lock_guard<std::mutex> _(state.lock);
+        for (const auto& entry : state.entries)
+        {
+            entries.push_back(entry.get());
+        }
+    }
+
+    // Entries are never removed, the pointers stay valid.
+    std::vector<Timing> result;
+    result.reserve(entries.size());
+
+    for (auto entry : entries)
+    {
+        auto& timing = result.emplace_back();
+        timing.name = entry->name;
+        timing.isBucketUpdate = entry->isBucketUpdate;
+        timing.group = entry->group;
+        timing.buckets = entry->buckets;
+        timing.stage = entry->stage;
+        timing.stats = Aggregate([entry](const Entry& aEntry) { return &aEntry == entry; });
+    }
+
+    return result;
+}
+
+RED4EXT_INLINE RED4ext::UpdateProfiler::Stats RED4ext::UpdateProfiler::GetNameStats(const char* aName)
+{
+    return Aggregate([aName](const Entry& aEntry) { return std::strcmp(aEntry.name, aName) == 0; });
+}
+
+RED4EXT_INLINE RED4ext::UpdateProfiler::Stats RED4ext::UpdateProfiler::GetGroupStats(UpdateTickGroup aGroup)
+{
+    return Aggregate([aGroup](const Entry& aEntry) { return !aEntry.isBucketUpdate && aEntry.group == aGroup; });
+}
+
+RED4EXT_INLINE RED4ext::UpdateProfiler::Stats RED4ext::UpdateProfiler::GetStageStats(UpdateBucketStage aStage)
+{
+    return Aggregate([aStage](const Entry& aEntry) { return aEntry.isBucketUpdate && aEntry.stage == aStage; });
+}
+
+RED4EXT_INLINE RED4ext::UpdateProfiler::State& RED4ext::UpdateProfiler::GetState()
+{
+    static State state;
+    return state;
+}
+
+RED4EXT_INLINE RED4ext::UpdateProfiler::Entry* RED4ext::UpdateProfiler::AddEntry(const char* aName,
+                                                                                 bool aIsBucketUpdate)
+{
+    auto& state = GetState();
+
+    auto entry = std::make_unique<Entry>();
+    entry->name = aName;
+    entry->isBucketUpdate = aIsBucketUpdate;
+    entry->group = UpdateTickGroup::Unknown;
+    entry->buckets = UpdateBucketMask::Everything;
+    entry->stage = UpdateBucketStage::Unknown;
+    for (auto& slot : entry->slots)
+    {
+        slot.ticks = 0;
+    }
+
+    std::fill(std::begin(entry->window), std::end(entry->window), 0);
+
+    std::lock_guard<std::mutex> _(state.lock);
+    // The current frame is only partially covered, before the first frame marker it is the time before the first frame.
+    entry->firstFrame = state.frames + 1;
+
+    state.entries.push_back(std::move(entry));
+    return state.entries.back().get();
+}
+
+template<typename Filter>
+RED4ext::UpdateProfiler::Stats RED4ext::UpdateProfiler::Aggregate(Filter&& aFilter)
+{
+    auto& state = GetState();
+
+    uint64_t totals[WindowSize];
+    uint32_t count = 0;
+    double nanosecondsPerTick;
+
+    {
+        std::lock_guard<std::mutex> _(state.lock);
+        nanosecondsPerTick = state.nanosecondsPerTick;
+
+        auto first = state.frames > WindowSize ? state.frames - WindowSize : 0;
+        for (auto frame = first; frame < state.frames; ++frame)
+        {
+            uint64_t total = 0;
+            bool isLive = false;
+
+            for (const auto& entry : state.entries)
+            {
+                if (entry->firstFrame <= frame && aFilter(*entry))
+                {
+                    total += entry->window[frame % WindowSize];
+                    isLive = true;
+                }
+            }
+
+            if (isLive)
+            {
+                totals[count++] = total;
+            }
+        }
+    }
+
+    Stats stats;
+    if (count == 0)
+    {
+        return stats;
+    }
+
+    std::sort(totals, totals + count);
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sum += totals[i];
+    }
+
+    auto toNanoseconds = [nanosecondsPerTick](uint64_t aTicks)
+    { return static_cast<uint64_t>(static_cast<double>(aTicks) * nanosecondsPerTick); };
+
+    // The smallest value that is at least as large as 99% of the frames.
+    auto p99 = (count * 99 + 99) / 100 - 1;
+
+    stats.min = toNanoseconds(totals[0]);
+    stats.avg = toNanoseconds(sum / count);
+    stats.p99 = toNanoseconds(totals[p99]);
+    stats.max = toNanoseconds(totals[count - 1]);
+    stats.frames = count;
+    return stats;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <RED4ext/Common.hpp>
+#include <RED4ext/Detail/Cycles.hpp>
+#include <RED4ext/SystemUpdate.hpp>
+#include <RED4ext/Trace/TraceWriter.hpp>
+
+namespace RED4ext
+{
+/**
+ * @brief Measures how long the updates registered through it take per frame.
+ *
+ * The callbacks are wrapped before they are passed to the UpdateRegistrar. Every call adds its duration to the
+ * current frame of its registration, the frame marker (see RegisterFrameMarker()) moves the totals into a rolling
+ * window of the last WindowSize frames. Statistics are available per registration, per name, per tick group and per
+ * bucket stage.
+ *
+ * A call reads the time stamp counter twice and adds to a counter of its registration. If a trace writer is set, each
+ * call is also recorded as a begin / end pair, which gives a frame timeline in the Chrome trace output.
+ */
+class UpdateProfiler
+{
+public:
+    static constexpr uint32_t WindowSize = 128;
+
+    /**
+     * @brief Frame times in nanoseconds.
+     */
+    struct Stats
+    {
+        uint64_t min = 0;
+        uint64_t avg = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+        uint32_t frames = 0; // Number of frames in the window.
+    };
+
+    struct Timing
+    {
+        const char* name;
+        bool isBucketUpdate;
+        UpdateTickGroup group;    // Only valid for group updates.
+        UpdateBucketMask buckets; // Only valid for bucket updates.
+        UpdateBucketStage stage;  // Only valid for bucket updates.
+        Stats stats;
+    };
+
+    static void RegisterUpdate(UpdateRegistrar* aRegistrar, UpdateTickGroup aGroup, IUpdatableSystem* aSystem,
+                               const char* aName, GroupUpdateCallback&& aCallback);
+    static void RegisterUpdate(UpdateRegistrar* aRegistrar, UpdateBucketMask aBuckets, UpdateBucketStage aStage,
+                               IUpdatableSystem* aSystem, const char* aName, BucketUpdateCallback&& aCallback);
+
+    /**
+     * @brief Wraps the callback without registering it, RegisterUpdate() passes the result to the registrar.
+     */
+    [[nodiscard]] static GroupUpdateCallback Wrap(UpdateTickGroup aGroup, const char* aName,
+                                                  GroupUpdateCallback&& aCallback);
+    [[nodiscard]] static BucketUpdateCallback Wrap(UpdateBucketMask aBuckets, UpdateBucketStage aStage,
+                                                   const char* aName, BucketUpdateCallback&& aCallback);
+
+    /**
+     * @brief Registers an update at the beginning of each frame that closes the previous frame.
+     */
+    static void RegisterFrameMarker(UpdateRegistrar* aRegistrar, IUpdatableSystem* aSystem);
+
+    /**
+     * @brief Closes the current frame, called by the frame marker. No wrapped callback may run at the same time.
+     */
+    static void NextFrame();
+
+    static void SetEnabled(bool aEnabled) noexcept;
+    [[nodiscard]] static bool IsEnabled() noexcept;
+
+    /**
+     * @brief Records every wrapped call to the writer, pass nullptr to stop. The writer must outlive its use.
+     */
+    static void SetTraceWriter(TraceWriter* aWriter) noexcept;
+
+    [[nodiscard]] static std::vector<Timing> GetTimings();
+    [[nodiscard]] static Stats GetNameStats(const char* aName);
+    [[nodiscard]] static Stats GetGroupStats(UpdateTickGroup aGroup);
+    [[nodiscard]] static Stats GetStageStats(UpdateBucketStage aStage);
+
+private:
+    static constexpr uint32_t SlotCount = static_cast<uint32_t>(UpdateBucketEnum::BucketCount);
+
+    // The ticks of the current frame, on their own cache line as different threads write them.
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> ticks;
+    };
+
+    struct Entry
+    {
+        const char* name;
+        bool isBucketUpdate;
+        UpdateTickGroup group;
+        UpdateBucketMask buckets;
+        UpdateBucketStage stage;
+        uint64_t firstFrame; // The first complete frame after the registration.
+
+        GroupUpdateCallback groupCallback;
+        BucketUpdateCallback bucketCallback;
+
+        Slot slots[SlotCount]; // One per bucket, group updates use the first.
+        uint64_t window[WindowSize];
+    };
+
+    struct State
+    {
+        std::atomic<bool> isEnabled{true};
+        std::atomic<TraceWriter*> traceWriter{nullptr};
+
+        std::mutex lock; // Guards the fields below.
+        std::vector<std::unique_ptr<Entry>> entries;
+        uint64_t frames = 0;
+
+        // Pairs of counter and steady clock readings, they convert ticks to nanoseconds.
+        uint64_t firstTicks = 0;
+        int64_t firstNanoseconds = 0;
+        double nanosecondsPerTick = 1.0;
+    };
+
+    static State& GetState();
+    static Entry* AddEntry(const char* aName, bool aIsBucketUpdate);
+
+    template<typename F>
+    static void Invoke(Entry& aEntry, uint32_t aSlot, F&& aCall)
+    {
+        auto& state = GetState();
+        if (!state.isEnabled.load(std::memory_order_relaxed))
+        {
+            aCall();
+            return;
+        }
+
+        // The name is an argument, not the format string, so that braces in it are written as they are.
+        auto writer = state.traceWriter.load(std::memory_order_relaxed);
+        if (writer)
+        {
+            writer->Begin("{}", aEntry.name);
+        }
+
+        auto start = Detail::ReadCycleCounter();
+        aCall();
+        auto ticks = Detail::ReadCycleCounter() - start;
+
+        // Bucket updates might run in parallel for different buckets, but the calls for one bucket never overlap. Only
+        // this call writes the slot, a load and a store are enough.
+        auto& slot = aEntry.slots[aSlot].ticks;
+        slot.store(slot.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+
+        if (writer)
+        {
+            writer->End("{}", aEntry.name);
+        }
+    }
+
+    template<typename Filter>
+    static Stats Aggregate(Filter&& aFilter);
+};
+} // namespace RED4ext
+
+#ifdef RED4EXT_HEADER_ONLY
+#include <RED4ext/UpdateProfiler-inl.hpp>
+#endif
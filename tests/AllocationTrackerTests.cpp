@@ -0,0 +1,255 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/Memory/AllocationTracker.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+using namespace RED4ext::Memory;
+
+// Every test uses a pool of its own, the snapshot of one test does not see the allocations of another.
+template<typename T>
+AllocationPoolStats GetPoolStats(const AllocationSnapshot& aSnapshot)
+{
+    for (const auto& stats : aSnapshot.pools)
+    {
+        if (stats.pool == T::Get())
+        {
+            return stats;
+        }
+    }
+
+    return {};
+}
+
+template<typename T>
+AllocationSiteStats GetSiteTotals(const AllocationSnapshot& aSnapshot)
+{
+    AllocationSiteStats totals;
+    for (const auto& stats : aSnapshot.sites)
+    {
+        if (stats.pool == T::Get())
+        {
+            totals.allocations += stats.allocations;
+            totals.bytes += stats.bytes;
+            totals.frees += stats.frees;
+        }
+    }
+
+    return totals;
+}
+
+// Forgets what happened before, the next snapshot only sees the test's own calls.
+void ResetSnapshot()
+{
+    static_cast<void>(AllocationTracker::Snapshot());
+}
+} // namespace
+
+#ifdef RED4EXT_ALLOCATION_TRACKING
+RED4EXT_TEST(AllocationTracker_Enable)
+{
+    RED4EXT_CHECK(!AllocationTracker::IsEnabled());
+    RED4EXT_CHECK(AllocationHooks::Get() == nullptr);
+
+    AllocationTracker::Enable(16);
+    RED4EXT_CHECK(AllocationTracker::IsEnabled());
+    RED4EXT_CHECK(AllocationTracker::GetSampleRate() == 16);
+    RED4EXT_REQUIRE(AllocationHooks::Get() != nullptr);
+    RED4EXT_CHECK(AllocationHooks::Get()->onAlloc == &AllocationTracker::OnAlloc);
+
+    AllocationTracker::Disable();
+    RED4EXT_CHECK(!AllocationTracker::IsEnabled());
+    RED4EXT_CHECK(AllocationHooks::Get() == nullptr);
+
+    // Nothing is recorded while tracking is disabled.
+    auto allocator = Allocator<PoolCPU>::Get();
+    ResetSnapshot();
+
+    auto allocation = allocator->Alloc(64);
+    allocator->Free(allocation);
+    RED4EXT_CHECK(GetPoolStats<PoolCPU>(AllocationTracker::Snapshot()).allocations == 0);
+}
+
+RED4EXT_TEST(AllocationTracker_Snapshot)
+{
+    auto allocator = Allocator<PoolEngine>::Get();
+
+    AllocationTracker::Enable(0);
+    ResetSnapshot();
+
+    std::vector<AllocationResult> allocations;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        allocations.push_back(allocator->Alloc(100));
+    }
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        allocator->Free(allocations[i]);
+    }
+
+    auto snapshot = AllocationTracker::Snapshot();
+    auto stats = GetPoolStats<PoolEngine>(snapshot);
+    RED4EXT_CHECK(stats.allocations == 10);
+    RED4EXT_CHECK(stats.bytes == 1000);
+    RED4EXT_CHECK(stats.frees == 4);
+    RED4EXT_CHECK(stats.sampledLiveBytes == 0);
+    RED4EXT_CHECK(stats.poolBytes == PoolEngine::Get()->storage->bytesAllocated);
+
+    // The sites add up to the pool.
+    auto sites = GetSiteTotals<PoolEngine>(snapshot);
+    RED4EXT_CHECK(sites.allocations == 10);
+    RED4EXT_CHECK(sites.bytes == 1000);
+    RED4EXT_CHECK(sites.frees == 4);
+
+    // A snapshot only sees what happened since the previous one.
+    for (uint32_t i = 4; i < 10; ++i)
+    {
+        allocator->Free(allocations[i]);
+    }
+
+    snapshot = AllocationTracker::Snapshot();
+    stats = GetPoolStats<PoolEngine>(snapshot);
+    RED4EXT_CHECK(stats.allocations == 0);
+    RED4EXT_CHECK(stats.frees == 6);
+    RED4EXT_CHECK(stats.poolBytesDelta == -600);
+
+    std::ostringstream stream;
+    AllocationTracker::Dump(snapshot, stream);
+    RED4EXT_CHECK(stream.str().find(PoolEngine::Name) != std::string::npos);
+
+    AllocationTracker::Disable();
+}
+
+RED4EXT_TEST(AllocationTracker_Realloc)
+{
+    auto allocator = Allocator<PoolScript>::Get();
+
+    AllocationTracker::Enable(1);
+    ResetSnapshot();
+
+    // A reallocation frees the old memory and allocates the new one.
+    auto allocation = allocator->Alloc(16);
+    allocation = allocator->Realloc(allocation, 5000);
+
+    auto stats = GetPoolStats<PoolScript>(AllocationTracker::Snapshot());
+    RED4EXT_CHECK(stats.allocations == 2);
+    RED4EXT_CHECK(stats.bytes == 5016);
+    RED4EXT_CHECK(stats.frees == 1);
+    RED4EXT_CHECK(stats.sampledLiveBytes == 5000);
+
+    allocator->Free(allocation);
+    RED4EXT_CHECK(GetPoolStats<PoolScript>(AllocationTracker::Snapshot()).sampledLiveBytes == 0);
+
+    AllocationTracker::Disable();
+}
+
+RED4EXT_TEST(AllocationTracker_ReportLeaks)
+{
+    auto allocator = Allocator<PoolGI>::Get();
+
+    // Samples every allocation.
+    AllocationTracker::Enable(1);
+
+    std::vector<AllocationResult> allocations;
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        allocations.push_back(allocator->Alloc(32));
+    }
+
+    allocator->Free(allocations[0]);
+    allocator->Free(allocations[1]);
+
+    std::ostringstream stream;
+    RED4EXT_CHECK(AllocationTracker::ReportLeaks(stream) == 3);
+    RED4EXT_CHECK(stream.str().find(PoolGI::Name) != std::string::npos);
+    RED4EXT_CHECK(stream.str().find("96 bytes") != std::string::npos);
+
+    for (uint32_t i = 2; i < 5; ++i)
+    {
+        allocator->Free(allocations[i]);
+    }
+
+    std::ostringstream empty;
+    RED4EXT_CHECK(AllocationTracker::ReportLeaks(empty) == 0);
+
+    AllocationTracker::Disable();
+}
+
+RED4EXT_TEST(AllocationTracker_Threads)
+{
+    auto allocator = Allocator<PoolDebug>::Get();
+
+    // Resolves the allocator's functions before the threads race for them.
+    auto first = allocator->Alloc(16);
+    allocator->Free(first);
+
+    AllocationTracker::Enable(1);
+    ResetSnapshot();
+
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t Count = 2000;
+
+    // Sampled memory is freed by another thread right after it was allocated.
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < ThreadCount; ++i)
+    {
+        threads.emplace_back(
+            [allocator]
+            {
+                for (uint32_t j = 0; j < Count; ++j)
+                {
+                    auto allocation = allocator->Alloc(16 + j % 256);
+                    std::thread([allocator, allocation]() mutable { allocator->Free(allocation); }).join();
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto stats = GetPoolStats<PoolDebug>(AllocationTracker::Snapshot());
+    RED4EXT_CHECK(stats.allocations == ThreadCount * Count);
+    RED4EXT_CHECK(stats.frees == ThreadCount * Count);
+    RED4EXT_CHECK(stats.sampledLiveBytes == 0);
+
+    std::ostringstream stream;
+    RED4EXT_CHECK(AllocationTracker::ReportLeaks(stream) == 0);
+
+    AllocationTracker::Disable();
+}
+#else
+RED4EXT_TEST(AllocationTracker_NotBuiltIn)
+{
+    // Without RED4EXT_ALLOCATION_TRACKING the allocators never call the hooks, enabling the tracker records nothing.
+    auto allocator = Allocator<PoolEngine>::Get();
+
+    AllocationTracker::Enable(1);
+    RED4EXT_CHECK(AllocationTracker::IsEnabled());
+    ResetSnapshot();
+
+    auto allocation = allocator->Alloc(64);
+    allocation = allocator->Realloc(allocation, 128);
+    allocator->Free(allocation);
+
+    auto snapshot = AllocationTracker::Snapshot();
+    RED4EXT_CHECK(GetPoolStats<PoolEngine>(snapshot).allocations == 0);
+    RED4EXT_CHECK(GetPoolStats<PoolEngine>(snapshot).frees == 0);
+    RED4EXT_CHECK(GetSiteTotals<PoolEngine>(snapshot).allocations == 0);
+
+    std::ostringstream stream;
+    RED4EXT_CHECK(AllocationTracker::ReportLeaks(stream) == 0);
+
+    AllocationTracker::Disable();
+}
+#endif
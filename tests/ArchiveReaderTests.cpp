@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <RED4ext/ArchiveReader.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's codec, segments are stored as pairs of a count and a byte.
+struct RunLengthDecompressor : IArchiveDecompressor
+{
+    static std::vector<uint8_t> Compress(const std::vector<uint8_t>& aData)
+    {
+        std::vector<uint8_t> compressed;
+        for (size_t i = 0; i < aData.size();)
+        {
+            uint8_t count = 1;
+            while (i + count < aData.size() && aData[i + count] == aData[i] && count < UINT8_MAX)
+            {
+                ++count;
+            }
+
+            compressed.push_back(count);
+            compressed.push_back(aData[i]);
+            i += count;
+        }
+
+        return compressed;
+    }
+
+    bool Decompress(const uint8_t* aSrc, uint32_t aSrcSize, uint8_t* aDst, uint32_t aDstSize) const override
+    {
+        uint32_t written = 0;
+        for (uint32_t i = 0; i + 1 < aSrcSize; i += 2)
+        {
+            if (aSrc[i] > aDstSize - written)
+            {
+                return false;
+            }
+
+            std::memset(aDst + written, aSrc[i + 1], aSrc[i]);
+            written += aSrc[i];
+        }
+
+        return written == aDstSize;
+    }
+};
+
+// Writes archives in the layout read by ArchiveReader.
+struct ArchiveBuilder
+{
+    struct Segment
+    {
+        std::vector<uint8_t> data;
+        bool isCompressed;
+    };
+
+    struct File
+    {
+        ResourcePath path;
+        std::vector<Segment> segments;
+        std::vector<ResourcePath> dependencies;
+    };
+
+    // Writes the archive, the tables start at an odd position so that nothing in them is aligned.
+    bool Write(const std::filesystem::path& aPath) const
+    {
+        std::vector<uint8_t> data(sizeof(ArchiveReader::Header));
+
+        std::vector<ArchiveReader::FileEntry> entries;
+        std::vector<ArchiveReader::Segment> segments;
+        std::vector<ResourcePath> dependencies;
+
+        for (const auto& file : files)
+        {
+            ArchiveReader::FileEntry entry{};
+            entry.path = file.path;
+            entry.inlineSegmentCount = 1;
+            entry.segmentsStart = static_cast<uint32_t>(segments.size());
+            entry.dependenciesStart = static_cast<uint32_t>(dependencies.size());
+
+            for (const auto& segment : file.segments)
+            {
+                auto stored = segment.isCompressed ? RunLengthDecompressor::Compress(segment.data) : segment.data;
+                segments.push_back({data.size(), static_cast<uint32_t>(stored.size()),
+                                    static_cast<uint32_t>(segment.data.size())});
+                data.insert(data.end(), stored.begin(), stored.end());
+            }
+
+            dependencies.insert(dependencies.end(), file.dependencies.begin(), file.dependencies.end());
+
+            entry.segmentsEnd = static_cast<uint32_t>(segments.size());
+            entry.dependenciesEnd = static_cast<uint32_t>(dependencies.size());
+            entries.push_back(entry);
+        }
+
+        if (data.size() % 2 == 0)
+        {
+            data.push_back(0);
+        }
+
+        ArchiveReader::Header header{};
+        header.magic = ArchiveReader::Magic;
+        header.version = 12;
+        header.indexPosition = data.size();
+
+        ArchiveReader::IndexHeader index{};
+        index.fileCount = static_cast<uint32_t>(entries.size());
+        index.segmentCount = static_cast<uint32_t>(segments.size());
+        index.dependencyCount = static_cast<uint32_t>(dependencies.size());
+
+        auto append = [&data](const void* aData, size_t aSize)
+        {
+            auto bytes = static_cast<const uint8_t*>(aData);
+            data.insert(data.end(), bytes, bytes + aSize);
+        };
+
+        append(&index, sizeof(index));
+        append(entries.data(), entries.size() * sizeof(ArchiveReader::FileEntry));
+        append(segments.data(), segments.size() * sizeof(ArchiveReader::Segment));
+        append(dependencies.data(), dependencies.size() * sizeof(ResourcePath));
+
+        header.indexSize = static_cast<uint32_t>(data.size() - header.indexPosition);
+        header.fileSize = data.size();
+        std::memcpy(data.data(), &header, sizeof(header));
+
+        if (truncatedSize)
+        {
+            data.resize(truncatedSize);
+        }
+
+        auto file = std::fopen(aPath.string().c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+
+        auto isWritten = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        std::fclose(file);
+        return isWritten;
+    }
+
+    std::vector<File> files;
+    size_t truncatedSize = 0;
+};
+
+// An archive file in the temporary directory that is removed at the end of the test.
+struct TemporaryArchive
+{
+    explicit TemporaryArchive(const char* aName)
+        : path(std::filesystem::temp_directory_path() / aName)
+    {
+    }
+
+    ~TemporaryArchive()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    std::filesystem::path path;
+};
+
+std::vector<uint8_t> MakeData(size_t aSize, uint8_t aSeed)
+{
+    std::vector<uint8_t> data(aSize);
+    for (size_t i = 0; i < aSize; ++i)
+    {
+        // Runs of equal bytes, so that the stand-in codec has something to compress.
+        data[i] = static_cast<uint8_t>(aSeed + i / 7);
+    }
+
+    return data;
+}
+
+std::string GetFilePath(uint32_t aIndex)
+{
+    return "base\\test\\file_" + std::to_string(aIndex) + ".mesh";
+}
+
+ArchiveBuilder MakeArchive(uint32_t aFileCount)
+{
+    ArchiveBuilder builder;
+    for (uint32_t i = 0; i < aFileCount; ++i)
+    {
+        ArchiveBuilder::File file;
+        file.path = ResourcePath(GetFilePath(i).c_str());
+        file.segments.push_back({MakeData(100 + i, static_cast<uint8_t>(i)), i % 2 == 1});
+        file.segments.push_back({MakeData(50, static_cast<uint8_t>(i + 1)), i % 3 == 1});
+
+        for (uint32_t j = 0; j < i % 4; ++j)
+        {
+            file.dependencies.push_back(ResourcePath(GetFilePath(i + j + 1).c_str()));
+        }
+
+        builder.files.push_back(file);
+    }
+
+    return builder;
+}
+
+std::vector<uint8_t> GetExpectedData(const ArchiveBuilder::File& aFile)
+{
+    std::vector<uint8_t> data;
+    for (const auto& segment : aFile.segments)
+    {
+        data.insert(data.end(), segment.data.begin(), segment.data.end());
+    }
+
+    return data;
+}
+} // namespace
+
+RED4EXT_TEST(ArchiveReader_FindsFiles)
+{
+    TemporaryArchive archive("RED4ext.ArchiveReader.Find.archive");
+    auto builder = MakeArchive(100);
+    RED4EXT_REQUIRE(builder.Write(archive.path));
+
+    ArchiveReader reader(archive.path);
+    RED4EXT_REQUIRE(reader.IsOpen());
+    RED4EXT_CHECK(reader.GetFiles().GetSize() == 100);
+
+    // The tables follow the 0x1C byte index header, in the mapping they are not aligned.
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(reader.GetFiles().begin()) % alignof(uint64_t) == 0);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        auto entry = reader.Find(GetFilePath(i).c_str());
+        RED4EXT_REQUIRE(entry);
+        RED4EXT_CHECK(entry->path.hash == builder.files[i].path.hash);
+        RED4EXT_CHECK(reader.GetSegments(*entry).GetSize() == 2);
+        RED4EXT_CHECK(reader.GetExtractedSize(*entry) == 150 + i);
+    }
+
+    RED4EXT_CHECK(!reader.Contains("base\\test\\missing.mesh"));
+    RED4EXT_CHECK(!reader.Contains(ResourcePath()));
+
+    reader.Close();
+    RED4EXT_CHECK(!reader.IsOpen());
+    RED4EXT_CHECK(!reader.Contains(GetFilePath(0).c_str()));
+}
+
+RED4EXT_TEST(ArchiveReader_ReadsUnalignedDependencies)
+{
+    TemporaryArchive archive("RED4ext.ArchiveReader.Dependencies.archive");
+    auto builder = MakeArchive(16);
+    RED4EXT_REQUIRE(builder.Write(archive.path));
+
+    ArchiveReader reader(archive.path);
+    RED4EXT_REQUIRE(reader.IsOpen());
+
+    for (const auto& file : builder.files)
+    {
+        auto entry = reader.Find(file.path);
+        RED4EXT_REQUIRE(entry);
+        RED4EXT_REQUIRE(reader.GetDependencyCount(*entry) == file.dependencies.size());
+
+        for (uint32_t i = 0; i < file.dependencies.size(); ++i)
+        {
+            RED4EXT_CHECK(reader.GetDependency(*entry, i) == file.dependencies[i]);
+        }
+    }
+}
+
+RED4EXT_TEST(ArchiveReader_Extract)
+{
+    TemporaryArchive archive("RED4ext.ArchiveReader.Extract.archive");
+    auto builder = MakeArchive(8);
+    RED4EXT_REQUIRE(builder.Write(archive.path));
+
+    ArchiveReader reader(archive.path);
+    RED4EXT_REQUIRE(reader.IsOpen());
+
+    RunLengthDecompressor decompressor;
+    StoredArchiveDecompressor stored;
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        std::vector<uint8_t> data;
+        RED4EXT_CHECK(reader.Extract(builder.files[i].path, decompressor, data));
+        RED4EXT_CHECK(data == GetExpectedData(builder.files[i]));
+
+        // The stored decompressor only handles files without compressed segments.
+        auto isStored = i % 2 != 1 && i % 3 != 1;
+        RED4EXT_CHECK(reader.Extract(builder.files[i].path, stored, data) == isStored);
+    }
+
+    std::vector<uint8_t> data;
+    RED4EXT_CHECK(!reader.Extract("base\\test\\missing.mesh", decompressor, data));
+}
+
+RED4EXT_TEST(ArchiveReader_ExtractParallel)
+{
+    TemporaryArchive archive("RED4ext.ArchiveReader.Parallel.archive");
+    auto builder = MakeArchive(500);
+    RED4EXT_REQUIRE(builder.Write(archive.path));
+
+    ArchiveReader reader(archive.path);
+    RED4EXT_REQUIRE(reader.IsOpen());
+
+    std::vector<ResourcePath> paths;
+    for (const auto& file : builder.files)
+    {
+        paths.push_back(file.path);
+    }
+
+    paths.push_back("base\\test\\missing.mesh");
+
+    std::mutex lock;
+    std::vector<uint32_t> extracted(builder.files.size());
+    std::atomic<uint32_t> mismatches = 0;
+
+    RunLengthDecompressor decompressor;
+    auto count = reader.ExtractParallel(
+        paths.data(), paths.size(), decompressor,
+        [&](const ArchiveReader::FileEntry& aEntry, const uint8_t* aData, size_t aSize)
+        {
+            auto index = static_cast<uint32_t>(&aEntry - reader.GetFiles().begin());
+            auto expected = GetExpectedData(builder.files[index]);
+            if (aSize != expected.size() || std::memcmp(aData, expected.data(), aSize) != 0)
+            {
+                mismatches.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> _(lock);
+            extracted[index]++;
+        },
+        4);
+
+    RED4EXT_CHECK(count == 500);
+    RED4EXT_CHECK(mismatches == 0);
+    RED4EXT_CHECK(std::all_of(extracted.begin(), extracted.end(), [](uint32_t aCount) { return aCount == 1; }));
+}
+
+RED4EXT_TEST(ArchiveReader_KeepsFirstDuplicate)
+{
+    TemporaryArchive archive("RED4ext.ArchiveReader.Duplicate.archive");
+    auto builder = MakeArchive(4);
+    builder.files[3].path = builder.files[1].path;
+    RED4EXT_REQUIRE(builder.Write(archive.path));
+
+    ArchiveReader reader(archive.path);
+    RED4EXT_REQUIRE(reader.IsOpen());
+    RED4EXT_CHECK(reader.Find(builder.files[1].path) == reader.GetFiles().begin() + 1);
+}
+
+RED4EXT_TEST(ArchiveReader_RejectsInvalidArchives)
+{
+    TemporaryArchive archive("RED4ext.ArchiveReader.Invalid.archive");
+    ArchiveReader reader;
+
+    RED4EXT_CHECK(!reader.Open(archive.path));
+
+    auto builder = MakeArchive(4);
+    RED4EXT_REQUIRE(builder.Write(archive.path));
+    RED4EXT_CHECK(reader.Open(archive.path));
+
+    // The mapped file can not be overwritten on Windows.
+    reader.Close();
+
+    // Every truncation cuts into the tables, the header or the data of the last segment.
+    auto size = std::filesystem::file_size(archive.path);
+    for (size_t truncatedSize = 1; truncatedSize < size; ++truncatedSize)
+    {
+        builder.truncatedSize = truncatedSize;
+        RED4EXT_REQUIRE(builder.Write(archive.path));
+        RED4EXT_CHECK(!reader.Open(archive.path));
+        RED4EXT_CHECK(!reader.IsOpen());
+    }
+}
@@ -0,0 +1,224 @@
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <RED4ext/CString.hpp>
+#include <RED4ext/DynArray.hpp>
+#include <RED4ext/HashMap.hpp>
+#include <RED4ext/Memory/Arena.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+using namespace RED4ext::Memory;
+
+bool IsFilled(const void* aMemory, size_t aSize, uint8_t aValue)
+{
+    auto bytes = static_cast<const uint8_t*>(aMemory);
+    for (size_t i = 0; i < aSize; ++i)
+    {
+        if (bytes[i] != aValue)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+RED4EXT_TEST(Arena_Allocate)
+{
+    Arena arena(1024);
+    RED4EXT_CHECK(arena.GetCapacity() == 0);
+
+    auto first = arena.Allocate(10);
+    auto aligned = arena.Allocate(16, 64);
+    RED4EXT_REQUIRE(first && aligned);
+
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(first) % Arena::DefaultAlignment == 0);
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    RED4EXT_CHECK(Arena::GetSize(first) == 10);
+    RED4EXT_CHECK(Arena::GetSize(aligned) == 16);
+    RED4EXT_CHECK(Arena::GetSize(nullptr) == 0);
+    RED4EXT_CHECK(arena.GetCapacity() == 1024);
+
+    // Only the last allocation is released, the next one takes its place.
+    arena.Free(first);
+    auto used = arena.GetUsedBytes();
+    arena.Free(aligned);
+    RED4EXT_CHECK(arena.GetUsedBytes() < used);
+    RED4EXT_CHECK(arena.Allocate(16, 64) == aligned);
+
+    // An allocation larger than a chunk gets a chunk of its own.
+    auto large = arena.Allocate(4096);
+    RED4EXT_REQUIRE(large != nullptr);
+    RED4EXT_CHECK(arena.GetCapacity() >= 1024 + 4096);
+
+    std::memset(large, 1, 4096);
+}
+
+RED4EXT_TEST(Arena_Reallocate)
+{
+    Arena arena(1024);
+
+    auto first = static_cast<uint8_t*>(arena.Allocate(8));
+    std::memset(first, 1, 8);
+
+    // The last allocation grows and shrinks in place.
+    auto grown = static_cast<uint8_t*>(arena.Reallocate(first, 64));
+    RED4EXT_CHECK(grown == first);
+    RED4EXT_CHECK(Arena::GetSize(grown) == 64);
+    RED4EXT_CHECK(IsFilled(grown, 8, 1));
+
+    RED4EXT_CHECK(arena.Reallocate(grown, 16) == first);
+    RED4EXT_CHECK(Arena::GetSize(first) == 16);
+
+    // Anything else is copied.
+    auto second = arena.Allocate(8);
+    auto copied = static_cast<uint8_t*>(arena.Reallocate(first, 32));
+    RED4EXT_CHECK(copied != first);
+    RED4EXT_CHECK(copied > static_cast<uint8_t*>(second));
+    RED4EXT_CHECK(IsFilled(copied, 8, 1));
+
+    // Growing past the end of the chunk moves the allocation to a new one.
+    auto moved = arena.Reallocate(copied, 2048);
+    RED4EXT_CHECK(moved != copied);
+    RED4EXT_CHECK(IsFilled(moved, 8, 1));
+
+    auto allocated = arena.Reallocate(nullptr, 8);
+    RED4EXT_CHECK(allocated != nullptr);
+    RED4EXT_CHECK(arena.Reallocate(allocated, 0) == nullptr);
+}
+
+RED4EXT_TEST(Arena_Rewind)
+{
+    Arena arena(256);
+
+    auto before = arena.Allocate(16);
+    auto marker = arena.GetMarker();
+
+    // Spans several chunks.
+    auto first = arena.Allocate(100);
+    for (uint32_t i = 0; i < 9; ++i)
+    {
+        RED4EXT_CHECK(arena.Allocate(100) != nullptr);
+    }
+
+    auto capacity = arena.GetCapacity();
+    RED4EXT_CHECK(capacity > 256);
+
+    arena.Rewind(marker);
+
+    // Allocations after the marker reuse the memory, the chunks are kept.
+    RED4EXT_CHECK(arena.Allocate(100) == first);
+    for (uint32_t i = 0; i < 9; ++i)
+    {
+        RED4EXT_CHECK(arena.Allocate(100) != nullptr);
+    }
+
+    RED4EXT_CHECK(arena.GetCapacity() == capacity);
+
+    // A marker from after the current position is ignored.
+    auto late = arena.GetMarker();
+    arena.Reset();
+    RED4EXT_CHECK(arena.GetUsedBytes() == 0);
+
+    arena.Rewind(late);
+    RED4EXT_CHECK(arena.GetUsedBytes() == 0);
+    RED4EXT_CHECK(arena.Allocate(16) == before);
+
+    arena.Trim();
+    RED4EXT_CHECK(arena.GetCapacity() == 256);
+    RED4EXT_CHECK(arena.Allocate(16) == before);
+}
+
+RED4EXT_TEST(Arena_Poisoning)
+{
+    Arena arena(1024);
+    arena.SetPoisoning(true);
+    RED4EXT_CHECK(arena.IsPoisoning());
+
+    auto memory = arena.Allocate(32);
+    RED4EXT_CHECK(IsFilled(memory, 32, Arena::AllocatedPattern));
+
+    std::memset(memory, 0, 32);
+    auto grown = arena.Reallocate(memory, 48);
+    RED4EXT_CHECK(IsFilled(static_cast<uint8_t*>(grown) + 32, 16, Arena::AllocatedPattern));
+
+    arena.Reset();
+    RED4EXT_CHECK(IsFilled(memory, 48, Arena::ReleasedPattern));
+
+    arena.SetPoisoning(false);
+    memory = arena.Allocate(32);
+    std::memset(memory, 0, 32);
+    arena.Reset();
+    RED4EXT_CHECK(IsFilled(memory, 32, 0));
+}
+
+RED4EXT_TEST(Arena_Containers)
+{
+    Arena arena;
+    Arena::Scope scope(arena);
+    RED4EXT_CHECK(&Arena::GetCurrent() == &arena);
+
+    auto allocator = ArenaAllocator::Get();
+    RED4EXT_CHECK(allocator->GetHandle() == ArenaAllocator::Handle);
+
+    {
+        DynArray<uint32_t> array(allocator);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            array.PushBack(i);
+        }
+
+        RED4EXT_CHECK(array.size == 1000);
+        RED4EXT_CHECK(array[999] == 999);
+        RED4EXT_CHECK(array.GetAllocator()->GetHandle() == ArenaAllocator::Handle);
+
+        HashMap<uint64_t, uint32_t> map(allocator);
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            map.Insert(i, i * 2);
+        }
+
+        auto value = map.Get(42);
+        RED4EXT_REQUIRE(value != nullptr);
+        RED4EXT_CHECK(*value == 84);
+
+        CString text("a string that does not fit inline", allocator);
+        RED4EXT_CHECK(std::strcmp(text.c_str(), "a string that does not fit inline") == 0);
+    }
+
+    RED4EXT_CHECK(arena.GetUsedBytes() > 0);
+    arena.Reset();
+    RED4EXT_CHECK(arena.GetUsedBytes() == 0);
+}
+
+RED4EXT_TEST(Arena_Threads)
+{
+    auto& own = Arena::GetThreadArena();
+    RED4EXT_CHECK(&Arena::GetCurrent() == &own);
+
+    // Every thread has an arena of its own.
+    Arena* other = nullptr;
+    std::thread thread(
+        [&other]
+        {
+            other = &Arena::GetCurrent();
+            RED4EXT_CHECK(ArenaAllocator::Get()->Alloc(16).memory != nullptr);
+        });
+    thread.join();
+
+    RED4EXT_CHECK(other != &own);
+
+    {
+        Arena arena;
+        Arena::Scope scope(arena);
+        RED4EXT_CHECK(&Arena::GetCurrent() == &arena);
+    }
+
+    RED4EXT_CHECK(&Arena::GetCurrent() == &own);
+}
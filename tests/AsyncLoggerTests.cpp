@@ -0,0 +1,459 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/AsyncLogger.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+struct Message
+{
+    PluginHandle handle;
+    LogLevel level;
+    std::string text;
+};
+
+// Stands in for the loader's sink. The sink can be closed to stall the consumer thread inside of a write.
+struct Sink
+{
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<Message> messages;
+    bool isOpen = true;
+    uint32_t waiting = 0;
+};
+
+Sink g_sink;
+
+void Write(PluginHandle aHandle, LogLevel aLevel, const char* aMessage)
+{
+    std::unique_lock<std::mutex> lock(g_sink.lock);
+
+    ++g_sink.waiting;
+    g_sink.changed.notify_all();
+    g_sink.changed.wait(lock, [] { return g_sink.isOpen; });
+    --g_sink.waiting;
+
+    g_sink.messages.push_back({aHandle, aLevel, aMessage});
+}
+
+template<LogLevel L>
+void WriteLevel(PluginHandle aHandle, const char* aMessage)
+{
+    Write(aHandle, L, aMessage);
+}
+
+const v0::Logger* GetLogger()
+{
+    static const v0::Logger logger = []
+    {
+        v0::Logger functions{};
+        functions.Trace = &WriteLevel<LogLevel::Trace>;
+        functions.Debug = &WriteLevel<LogLevel::Debug>;
+        functions.Info = &WriteLevel<LogLevel::Info>;
+        functions.Warn = &WriteLevel<LogLevel::Warn>;
+        functions.Error = &WriteLevel<LogLevel::Error>;
+        functions.Critical = &WriteLevel<LogLevel::Critical>;
+        return functions;
+    }();
+
+    return &logger;
+}
+
+PluginHandle MakeHandle(uintptr_t aValue)
+{
+    return reinterpret_cast<PluginHandle>(aValue);
+}
+
+std::vector<Message> TakeMessages()
+{
+    std::lock_guard<std::mutex> _(g_sink.lock);
+    return std::move(g_sink.messages);
+}
+
+// Closes the sink and waits until the consumer is stuck in it with the first message.
+void StallConsumer(AsyncLogger& aLogger)
+{
+    {
+        std::lock_guard<std::mutex> _(g_sink.lock);
+        g_sink.isOpen = false;
+    }
+
+    aLogger.Info("stall");
+
+    std::unique_lock<std::mutex> lock(g_sink.lock);
+    g_sink.changed.wait(lock, [] { return g_sink.waiting > 0; });
+}
+
+void OpenSink()
+{
+    std::lock_guard<std::mutex> _(g_sink.lock);
+    g_sink.isOpen = true;
+    g_sink.changed.notify_all();
+}
+
+enum class Color : int32_t
+{
+    Red = 7
+};
+} // namespace
+
+RED4EXT_TEST(AsyncLogger_FormatsArguments)
+{
+    TakeMessages();
+
+    {
+        AsyncLogger logger(GetLogger(), MakeHandle(1));
+
+        const char* nullString = nullptr;
+        char mutableString[] = "mutable";
+        int32_t value = 5;
+
+        RED4EXT_CHECK(logger.Info("plain"));
+        RED4EXT_CHECK(logger.Info("%d %u %lld %.2f %c", -3, 4u, -5ll, 1.5, 'x'));
+        RED4EXT_CHECK(logger.Warn("%s|%s|%s", "literal", mutableString, nullString));
+        RED4EXT_CHECK(logger.Error("%d %p", Color::Red, static_cast<void*>(&value)));
+
+        // The string is copied, changing it afterwards does not change the message.
+        mutableString[0] = 'M';
+        logger.Flush();
+
+        char pointer[32];
+        std::snprintf(pointer, sizeof(pointer), "%p", static_cast<void*>(&value));
+
+        auto messages = TakeMessages();
+        RED4EXT_REQUIRE(messages.size() == 4);
+
+        RED4EXT_CHECK(messages[0].text == "plain");
+        RED4EXT_CHECK(messages[0].level == LogLevel::Info);
+        RED4EXT_CHECK(messages[0].handle == MakeHandle(1));
+        RED4EXT_CHECK(messages[1].text == "-3 4 -5 1.50 x");
+        RED4EXT_CHECK(messages[2].text == "literal|mutable|(null)");
+        RED4EXT_CHECK(messages[2].level == LogLevel::Warn);
+        RED4EXT_CHECK(messages[3].text == std::string("7 ") + pointer);
+        RED4EXT_CHECK(messages[3].level == LogLevel::Error);
+    }
+}
+
+RED4EXT_TEST(AsyncLogger_Levels)
+{
+    TakeMessages();
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1));
+    logger.Trace("trace");
+    logger.Debug("debug");
+    logger.Info("info");
+    logger.Warn("warn");
+    logger.Error("error");
+    logger.Critical("critical");
+    logger.Flush();
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == 6);
+
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        RED4EXT_CHECK(messages[i].level == static_cast<LogLevel>(i));
+    }
+
+    RED4EXT_CHECK(messages[5].text == "critical");
+}
+
+RED4EXT_TEST(AsyncLogger_DestructorWritesPending)
+{
+    TakeMessages();
+
+    {
+        AsyncLogger logger(GetLogger(), MakeHandle(1));
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            logger.Info("%d", i);
+        }
+    }
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == 100);
+    RED4EXT_CHECK(messages[99].text == "99");
+}
+
+RED4EXT_TEST(AsyncLogger_KeepsOrderAcrossWraps)
+{
+    TakeMessages();
+
+    // Far more than the smallest ring holds, the records wrap around it many times.
+    constexpr int32_t Count = 20000;
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1), AsyncLogger::OverflowPolicy::Block, 4096);
+    for (int32_t i = 0; i < Count; ++i)
+    {
+        // Different sizes so that the end of the ring is padded at different offsets.
+        logger.Info("%d %s", i, i % 3 == 0 ? "a longer string argument" : "");
+    }
+
+    logger.Flush();
+    RED4EXT_CHECK(logger.GetDroppedCount() == 0);
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == Count);
+
+    uint32_t mismatches = 0;
+    for (int32_t i = 0; i < Count; ++i)
+    {
+        mismatches += std::atoi(messages[i].text.c_str()) != i;
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+}
+
+RED4EXT_TEST(AsyncLogger_DropsWhenFull)
+{
+    TakeMessages();
+
+    constexpr uint32_t Count = 1000;
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1), AsyncLogger::OverflowPolicy::Drop, 4096);
+    StallConsumer(logger);
+
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < Count; ++i)
+    {
+        accepted += logger.Info("%u", i);
+    }
+
+    RED4EXT_CHECK(accepted < Count);
+    RED4EXT_CHECK(logger.GetDroppedCount() == Count - accepted);
+
+    OpenSink();
+    logger.Flush();
+
+    // The stall message, then the accepted ones. Drop does not report anything.
+    auto messages = TakeMessages();
+    RED4EXT_CHECK(messages.size() == accepted + 1);
+}
+
+RED4EXT_TEST(AsyncLogger_CountsWhenFull)
+{
+    TakeMessages();
+
+    constexpr uint32_t Count = 1000;
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1), AsyncLogger::OverflowPolicy::Count, 4096);
+    StallConsumer(logger);
+
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < Count; ++i)
+    {
+        accepted += logger.Info("%u", i);
+    }
+
+    OpenSink();
+    logger.Flush();
+
+    // The report follows the drain that found the messages, wait for it.
+    std::string expected = std::to_string(Count - accepted) + " log message(s) were dropped";
+    bool isReported = false;
+    std::vector<Message> messages;
+
+    for (uint32_t i = 0; i < 1000 && !isReported; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        auto taken = TakeMessages();
+        messages.insert(messages.end(), taken.begin(), taken.end());
+
+        for (const auto& message : messages)
+        {
+            isReported |= message.level == LogLevel::Warn && message.text == expected;
+        }
+    }
+
+    RED4EXT_CHECK(isReported);
+    RED4EXT_CHECK(messages.size() == accepted + 2);
+}
+
+RED4EXT_TEST(AsyncLogger_BlocksWhenFull)
+{
+    TakeMessages();
+
+    constexpr uint32_t Count = 1000;
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1), AsyncLogger::OverflowPolicy::Block, 4096);
+    StallConsumer(logger);
+
+    std::atomic<uint32_t> logged = 0;
+    std::thread producer(
+        [&]
+        {
+            for (uint32_t i = 0; i < Count; ++i)
+            {
+                logger.Info("%u", i);
+                logged.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+    // The producer fills the ring and waits for room.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    RED4EXT_CHECK(logged.load() < Count);
+
+    OpenSink();
+    producer.join();
+    logger.Flush();
+
+    RED4EXT_CHECK(logger.GetDroppedCount() == 0);
+    RED4EXT_CHECK(TakeMessages().size() == Count + 1);
+}
+
+RED4EXT_TEST(AsyncLogger_DropsOversizedMessages)
+{
+    TakeMessages();
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1), AsyncLogger::OverflowPolicy::Block, 4096);
+
+    // A record may use a quarter of the ring at most, even if the policy is to block.
+    std::string large(2048, 'x');
+    RED4EXT_CHECK(!logger.Info("%s", large.c_str()));
+    RED4EXT_CHECK(logger.GetDroppedCount() == 1);
+
+    std::string small(512, 'x');
+    RED4EXT_CHECK(logger.Info("%s", small.c_str()));
+    logger.Flush();
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == 1);
+    RED4EXT_CHECK(messages[0].text == small);
+}
+
+RED4EXT_TEST(AsyncLogger_ThreadsKeepTheirOrder)
+{
+    TakeMessages();
+
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t Count = 5000;
+
+    AsyncLogger logger(GetLogger(), MakeHandle(1), AsyncLogger::OverflowPolicy::Block, 4096);
+
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < ThreadCount; ++thread)
+    {
+        threads.emplace_back(
+            [&logger, thread]
+            {
+                for (uint32_t i = 0; i < Count; ++i)
+                {
+                    logger.Info("%u %u", thread, i);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    logger.Flush();
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == ThreadCount * Count);
+
+    uint32_t next[ThreadCount] = {};
+    uint32_t mismatches = 0;
+
+    for (const auto& message : messages)
+    {
+        uint32_t thread = 0;
+        uint32_t index = 0;
+        if (std::sscanf(message.text.c_str(), "%u %u", &thread, &index) != 2 || thread >= ThreadCount ||
+            index != next[thread]++)
+        {
+            ++mismatches;
+        }
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+}
+
+RED4EXT_TEST(AsyncLogger_ReusesRingsOfExitedThreads)
+{
+    TakeMessages();
+
+    constexpr uint32_t Count = 100;
+
+    {
+        AsyncLogger logger(GetLogger(), MakeHandle(1));
+
+        // One short-lived thread after another, e.g. the workers of a thread pool that is resized.
+        for (uint32_t i = 0; i < Count; ++i)
+        {
+            std::thread([&logger, i] { logger.Info("%u", i); }).join();
+        }
+
+        RED4EXT_CHECK(logger.GetRingCount() == 1);
+
+        // This thread takes the ring over and keeps it, the next thread needs a ring of its own.
+        logger.Info("main");
+        RED4EXT_CHECK(logger.GetRingCount() == 1);
+        std::thread([&logger] { logger.Info("last"); }).join();
+        RED4EXT_CHECK(logger.GetRingCount() == 2);
+    }
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == Count + 2);
+
+    // The taken over ring keeps the order of the threads that used it.
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < Count; ++i)
+    {
+        mismatches += messages[i].text != std::to_string(i);
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+}
+
+RED4EXT_TEST(AsyncLogger_SeveralLoggersOnOneThread)
+{
+    TakeMessages();
+
+    {
+        AsyncLogger first(GetLogger(), MakeHandle(1));
+        AsyncLogger second(GetLogger(), MakeHandle(2));
+
+        for (int32_t i = 0; i < 10; ++i)
+        {
+            first.Info("first %d", i);
+            second.Info("second %d", i);
+        }
+
+        first.Flush();
+        second.Flush();
+    }
+
+    // A logger that takes the place of a destroyed one does not inherit its ring.
+    {
+        AsyncLogger third(GetLogger(), MakeHandle(3));
+        third.Info("third");
+    }
+
+    auto messages = TakeMessages();
+    RED4EXT_REQUIRE(messages.size() == 21);
+
+    uint32_t mismatches = 0;
+    for (const auto& message : messages)
+    {
+        auto handle = message.text[0] == 'f' ? MakeHandle(1) : message.text[0] == 's' ? MakeHandle(2) : MakeHandle(3);
+        mismatches += message.handle != handle;
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+    RED4EXT_CHECK(messages.back().text == "third");
+}
@@ -0,0 +1,264 @@
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include <RED4ext/Callback.hpp>
+#include <RED4ext/CallbackArena.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Counts its live instances, a closure that captures it shows whether every copy was destroyed.
+struct Tracked
+{
+    Tracked()
+    {
+        ++live;
+    }
+
+    Tracked(const Tracked&)
+    {
+        ++live;
+    }
+
+    Tracked(Tracked&&) noexcept
+    {
+        ++live;
+    }
+
+    ~Tracked()
+    {
+        --live;
+    }
+
+    static inline int32_t live = 0;
+};
+
+// Too large for the inline buffer of 32 bytes.
+struct Payload
+{
+    std::array<int32_t, 16> values{};
+};
+
+template<SpillPolicy Policy>
+using Sum = Callback<int32_t (*)(int32_t), DefaultFixedCallbackBufferSize, Policy>;
+
+auto MakeLarge(int32_t aBias)
+{
+    Payload payload;
+    payload.values.fill(aBias);
+
+    return [payload, tracked = Tracked()](int32_t aValue) { return aValue + payload.values[15]; };
+}
+
+// The buffer of a spilled callback holds the pointer to its closure.
+template<typename C>
+const void* GetSpilledClosure(const C& aCallback)
+{
+    return *reinterpret_cast<const void* const*>(aCallback.buffer);
+}
+
+template<SpillPolicy Policy>
+void CheckSpilled()
+{
+    using C = Sum<Policy>;
+    static_assert(sizeof(C) == DefaultFixedCallbackBufferSize + 0x8);
+
+    {
+        C callback(MakeLarge(10));
+        RED4EXT_CHECK(callback(1) == 11);
+        RED4EXT_CHECK(Tracked::live == 1);
+
+        auto copy = callback;
+        RED4EXT_CHECK(copy(2) == 12);
+        RED4EXT_CHECK(Tracked::live == 2);
+        RED4EXT_CHECK(GetSpilledClosure(copy) != GetSpilledClosure(callback));
+
+        // Moving hands over the pointer, the closure stays where it is.
+        auto closure = GetSpilledClosure(callback);
+        auto moved = std::move(callback);
+        RED4EXT_CHECK(moved(3) == 13);
+        RED4EXT_CHECK(Tracked::live == 2);
+        RED4EXT_CHECK(GetSpilledClosure(moved) == closure);
+
+        copy = moved;
+        RED4EXT_CHECK(Tracked::live == 2);
+
+        moved = C(MakeLarge(20));
+        RED4EXT_CHECK(moved(1) == 21);
+        RED4EXT_CHECK(copy(1) == 11);
+    }
+
+    RED4EXT_CHECK(Tracked::live == 0);
+}
+} // namespace
+
+RED4EXT_TEST(Callback_Inline)
+{
+    // Small closures keep the game's inline layout whatever the policy.
+    int32_t bias = 5;
+    Sum<SpillPolicy::Pool> pooled([bias](int32_t aValue) { return aValue + bias; });
+    Sum<SpillPolicy::Heap> heap([bias](int32_t aValue) { return aValue * bias; });
+
+    RED4EXT_CHECK(*reinterpret_cast<const int32_t*>(pooled.buffer) == 5);
+    RED4EXT_CHECK(pooled(1) == 6);
+    RED4EXT_CHECK(heap(2) == 10);
+
+    // The result of the target is returned.
+    Callback<int32_t (*)(int32_t)> function(+[](int32_t aValue) { return aValue - 1; });
+    RED4EXT_CHECK(function(1) == 0);
+}
+
+RED4EXT_TEST(Callback_SpillHeap)
+{
+    CheckSpilled<SpillPolicy::Heap>();
+}
+
+RED4EXT_TEST(Callback_SpillPool)
+{
+    CheckSpilled<SpillPolicy::Pool>();
+
+    using C = Sum<SpillPolicy::Pool>;
+
+    // A freed block is reused by the next closure of its size class.
+    const void* closure = nullptr;
+    {
+        C callback(MakeLarge(1));
+        closure = GetSpilledClosure(callback);
+    }
+
+    C callback(MakeLarge(2));
+    RED4EXT_CHECK(GetSpilledClosure(callback) == closure);
+    RED4EXT_CHECK(callback(0) == 2);
+}
+
+RED4EXT_TEST(Callback_SpillPoolLarge)
+{
+    using C = Sum<SpillPolicy::Pool>;
+
+    // Larger than the largest size class, the closure goes to the heap.
+    std::array<int32_t, 512> values{};
+    values[511] = 7;
+
+    C large([values](int32_t aValue) { return aValue + values[511]; });
+    RED4EXT_CHECK(large(1) == 8);
+
+    // Over-aligned closures go to the heap too, with their alignment.
+    struct alignas(64) Aligned
+    {
+        int32_t value;
+    };
+
+    C aligned([value = Aligned{3}](int32_t aValue) { return aValue + value.value; });
+    RED4EXT_CHECK(aligned(1) == 4);
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(GetSpilledClosure(aligned)) % 64 == 0);
+}
+
+RED4EXT_TEST(Callback_SpillPoolThreads)
+{
+    using C = Sum<SpillPolicy::Pool>;
+
+    // A callback created on one thread is destroyed on another, the block moves to that thread's cache.
+    auto callback = new C(MakeLarge(4));
+
+    std::thread thread(
+        [callback]
+        {
+            RED4EXT_CHECK((*callback)(1) == 5);
+            delete callback;
+        });
+    thread.join();
+
+    RED4EXT_CHECK(Tracked::live == 0);
+}
+
+RED4EXT_TEST(CallbackArena_Create)
+{
+    using C = Callback<int32_t (*)(int32_t)>;
+
+    CallbackArena arena(1024);
+
+    {
+        // Small closures stay inline and are not counted.
+        auto small = arena.Create<C>([](int32_t aValue) { return aValue + 1; });
+        RED4EXT_CHECK(small(1) == 2);
+        RED4EXT_CHECK(arena.GetLiveCount() == 0);
+        RED4EXT_CHECK(arena.GetCapacity() == 0);
+
+        auto large = arena.Create<C>(MakeLarge(10));
+        RED4EXT_CHECK(large(1) == 11);
+        RED4EXT_CHECK(arena.GetLiveCount() == 1);
+        RED4EXT_CHECK(arena.GetCapacity() == 1024);
+
+        // Copies are placed in the same arena.
+        auto copy = large;
+        RED4EXT_CHECK(copy(2) == 12);
+        RED4EXT_CHECK(arena.GetLiveCount() == 2);
+        RED4EXT_CHECK(Tracked::live == 2);
+
+        RED4EXT_CHECK(!arena.Reset());
+    }
+
+    // The closures were destroyed, the memory is released by the reset.
+    RED4EXT_CHECK(Tracked::live == 0);
+    RED4EXT_CHECK(arena.GetLiveCount() == 0);
+    RED4EXT_CHECK(arena.Reset());
+    RED4EXT_CHECK(arena.GetCapacity() == 1024);
+}
+
+RED4EXT_TEST(CallbackArena_Reset)
+{
+    using C = Callback<int32_t (*)(int32_t)>;
+
+    CallbackArena arena(256);
+
+    const void* first = nullptr;
+    {
+        auto callback = arena.Create<C>(MakeLarge(1));
+        first = GetSpilledClosure(callback);
+    }
+
+    RED4EXT_CHECK(arena.Reset());
+
+    // The memory is used again from the start.
+    auto callback = arena.Create<C>(MakeLarge(2));
+    RED4EXT_CHECK(GetSpilledClosure(callback) == first);
+
+    // A closure larger than a chunk gets a chunk of its own.
+    std::array<int32_t, 128> values{};
+    values[127] = 3;
+
+    auto large = arena.Create<C>([values](int32_t aValue) { return aValue + values[127]; });
+    RED4EXT_CHECK(large(1) == 4);
+    RED4EXT_CHECK(arena.GetCapacity() > 256 + sizeof(values));
+
+    // The closures are aligned within the chunks.
+    struct alignas(64) Aligned
+    {
+        int32_t value;
+    };
+
+    auto aligned = arena.Create<C>([value = Aligned{5}](int32_t aValue) { return aValue + value.value; });
+    RED4EXT_CHECK(aligned(1) == 6);
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(GetSpilledClosure(aligned)) % 64 == 0);
+    RED4EXT_CHECK(arena.GetLiveCount() == 3);
+}
+
+RED4EXT_TEST(CallbackArena_DestroyOnThread)
+{
+    using C = Callback<int32_t (*)(int32_t)>;
+
+    CallbackArena arena;
+
+    // Callbacks may be destroyed on another thread, e.g. the one the game runs them on.
+    auto callback = new C(arena.Create<C>(MakeLarge(1)));
+    std::thread thread([callback] { delete callback; });
+    thread.join();
+
+    RED4EXT_CHECK(arena.GetLiveCount() == 0);
+    RED4EXT_CHECK(arena.Reset());
+}
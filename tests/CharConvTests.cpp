@@ -0,0 +1,242 @@
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <RED4ext/CharConv.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+ItemID MakeItemID(std::mt19937_64& aRandom)
+{
+    ItemID id{};
+    id.tdbid = TweakDBID(aRandom());
+    id.rngSeed = static_cast<uint32_t>(aRandom());
+    id.uniqueCounter = static_cast<uint16_t>(aRandom());
+    id.structure = static_cast<uint8_t>(aRandom());
+    id.flags = static_cast<uint8_t>(aRandom());
+
+    return id;
+}
+
+bool operator==(const ItemID& aLeft, const ItemID& aRight)
+{
+    return std::memcmp(&aLeft, &aRight, sizeof(ItemID)) == 0;
+}
+
+template<typename T>
+std::string_view Format(char (&aBuffer)[64], const T& aValue)
+{
+    auto result = ToChars(aBuffer, aBuffer + sizeof(aBuffer), aValue);
+    if (result.ec != std::errc{})
+    {
+        return {};
+    }
+
+    return {aBuffer, static_cast<size_t>(result.ptr - aBuffer)};
+}
+
+template<typename T>
+bool RoundTrips(const T& aValue)
+{
+    char buffer[64];
+    auto text = Format(buffer, aValue);
+    if (text.size() != CharsSize<T>)
+    {
+        return false;
+    }
+
+    T parsed{};
+    auto result = FromChars(text.data(), text.data() + text.size(), parsed);
+    return result.ec == std::errc{} && result.ptr == text.data() + text.size() && parsed == aValue;
+}
+} // namespace
+
+RED4EXT_TEST(CharConv_Format)
+{
+    char buffer[64];
+
+    RED4EXT_CHECK(Format(buffer, CName(0x0123456789ABCDEFull)) == "0123456789ABCDEF");
+    RED4EXT_CHECK(Format(buffer, NodeRef(0xFull)) == "000000000000000F");
+
+    TweakDBID tdbid(0xDEADBEEF, 0x1A);
+    tdbid.name.tdbOffsetBE[0] = 0x01;
+    tdbid.name.tdbOffsetBE[1] = 0x02;
+    tdbid.name.tdbOffsetBE[2] = 0x03;
+    RED4EXT_CHECK(Format(buffer, tdbid) == "DEADBEEF:1A:010203");
+
+    ItemID item{};
+    item.tdbid = tdbid;
+    item.rngSeed = 0x12345678;
+    item.uniqueCounter = 0xABCD;
+    item.structure = 0x02;
+    item.flags = 0x80;
+    RED4EXT_CHECK(Format(buffer, item) == "DEADBEEF:1A:010203:12345678:ABCD:02:80");
+}
+
+RED4EXT_TEST(CharConv_RoundTrip)
+{
+    std::mt19937_64 random(1);
+
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        failures += !RoundTrips(CName(random()));
+        failures += !RoundTrips(NodeRef(random()));
+        failures += !RoundTrips(TweakDBID(random()));
+        failures += !RoundTrips(MakeItemID(random));
+    }
+
+    RED4EXT_CHECK(failures == 0);
+
+    // The extremes of every field.
+    ItemID item{};
+    RED4EXT_CHECK(RoundTrips(item));
+
+    item.tdbid = TweakDBID(~0ull);
+    item.rngSeed = 0xFFFFFFFF;
+    item.uniqueCounter = 0xFFFF;
+    item.structure = 0xFF;
+    item.flags = 0xFF;
+    RED4EXT_CHECK(RoundTrips(item));
+    RED4EXT_CHECK(RoundTrips(CName(~0ull)));
+    RED4EXT_CHECK(RoundTrips(TweakDBID(~0ull)));
+}
+
+RED4EXT_TEST(CharConv_ParseLowerCase)
+{
+    constexpr std::string_view text = "deadbeef:1a:0a0b0c";
+
+    TweakDBID tdbid;
+    auto result = FromChars(text.data(), text.data() + text.size(), tdbid);
+
+    RED4EXT_REQUIRE(result.ec == std::errc{});
+    RED4EXT_CHECK(result.ptr == text.data() + text.size());
+    RED4EXT_CHECK(tdbid.name.hash == 0xDEADBEEF);
+    RED4EXT_CHECK(tdbid.name.length == 0x1A);
+    RED4EXT_CHECK(tdbid.name.tdbOffsetBE[0] == 0x0A);
+    RED4EXT_CHECK(tdbid.name.tdbOffsetBE[1] == 0x0B);
+    RED4EXT_CHECK(tdbid.name.tdbOffsetBE[2] == 0x0C);
+}
+
+RED4EXT_TEST(CharConv_ParseStopsAfterValue)
+{
+    constexpr std::string_view text = "00000000000000FFtrailing";
+
+    CName name;
+    auto result = FromChars(text.data(), text.data() + text.size(), name);
+
+    RED4EXT_REQUIRE(result.ec == std::errc{});
+    RED4EXT_CHECK(result.ptr == text.data() + 16);
+    RED4EXT_CHECK(name.hash == 0xFF);
+}
+
+RED4EXT_TEST(CharConv_RejectsInvalidInput)
+{
+    const std::string_view invalid[] = {
+        "DEADBEEF:1A:01020",                            // Too short.
+        "DEADBEEG:1A:010203",                           // Not a hex digit.
+        "DEADBEEF-1A:010203",                           // Wrong separator.
+        "DEADBEEF:1A:01020 ",                           // Space instead of a digit.
+        std::string_view("DEADBEEF:1A:01\0" "203", 18), // Embedded null.
+        "+EADBEEF:1A:010203",                           // Signs are not digits.
+    };
+
+    for (auto text : invalid)
+    {
+        TweakDBID tdbid(0x1234);
+        auto result = FromChars(text.data(), text.data() + text.size(), tdbid);
+
+        RED4EXT_CHECK(result.ec == std::errc::invalid_argument);
+        RED4EXT_CHECK(result.ptr == text.data());
+        RED4EXT_CHECK(tdbid.value == 0x1234);
+    }
+
+    // Characters with the high bit set must not index outside of the digit table.
+    constexpr std::string_view extended = "\xC3\xA9\xFF\x80""000000000000";
+
+    CName name(5ull);
+    auto result = FromChars(extended.data(), extended.data() + extended.size(), name);
+    RED4EXT_CHECK(result.ec == std::errc::invalid_argument);
+    RED4EXT_CHECK(name.hash == 5);
+
+    ItemID item{};
+    constexpr std::string_view truncated = "DEADBEEF:1A:010203:12345678:ABCD:02:8";
+    RED4EXT_CHECK(FromChars(truncated.data(), truncated.data() + truncated.size(), item).ec ==
+                  std::errc::invalid_argument);
+}
+
+RED4EXT_TEST(CharConv_OutputTooSmall)
+{
+    char buffer[64];
+    std::memset(buffer, '#', sizeof(buffer));
+
+    auto result = ToChars(buffer, buffer + CharsSize<ItemID> - 1, ItemID{});
+    RED4EXT_CHECK(result.ec == std::errc::value_too_large);
+    RED4EXT_CHECK(result.ptr == buffer + CharsSize<ItemID> - 1);
+
+    // Nothing is written on failure.
+    RED4EXT_CHECK(buffer[0] == '#');
+
+    result = ToChars(buffer, buffer + CharsSize<CName>, CName(1ull));
+    RED4EXT_CHECK(result.ec == std::errc{});
+    RED4EXT_CHECK(result.ptr == buffer + CharsSize<CName>);
+    RED4EXT_CHECK(buffer[CharsSize<CName>] == '#');
+}
+
+RED4EXT_TEST(CharConv_Batch)
+{
+    std::mt19937_64 random(2);
+
+    std::vector<ItemID> items(100);
+    for (auto& item : items)
+    {
+        item = MakeItemID(random);
+    }
+
+    std::vector<char> text((CharsSize<ItemID> + 1) * items.size());
+    auto first = text.data();
+    auto last = text.data() + text.size();
+
+    // One character short of the whole batch fails before anything is written.
+    RED4EXT_CHECK(ToChars(first, last - 1, Span<const ItemID>(items.data(), items.size())).ec ==
+                  std::errc::value_too_large);
+
+    auto written = ToChars(first, last, Span<const ItemID>(items.data(), items.size()), ',');
+    RED4EXT_REQUIRE(written.ec == std::errc{});
+    RED4EXT_CHECK(written.ptr == last);
+    RED4EXT_CHECK(text[CharsSize<ItemID>] == ',');
+
+    std::vector<ItemID> parsed(items.size());
+    auto read = FromChars(first, last, Span<ItemID>(parsed.data(), parsed.size()), ',');
+    RED4EXT_REQUIRE(read.ec == std::errc{});
+    RED4EXT_CHECK(read.ptr == last);
+
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        mismatches += !(parsed[i] == items[i]);
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+
+    // A broken value stops the batch at its start, the values in front of it are set.
+    constexpr size_t Broken = 42;
+    text[Broken * (CharsSize<ItemID> + 1) + 3] = 'x';
+
+    std::vector<ItemID> partial(items.size());
+    read = FromChars(first, last, Span<ItemID>(partial.data(), partial.size()), ',');
+    RED4EXT_CHECK(read.ec == std::errc::invalid_argument);
+    RED4EXT_CHECK(read.ptr == first + Broken * (CharsSize<ItemID> + 1));
+    RED4EXT_CHECK(partial[Broken - 1] == items[Broken - 1]);
+
+    // The last value must be followed by the separator too.
+    auto lastValue = first + (items.size() - 1) * (CharsSize<ItemID> + 1);
+    read = FromChars(lastValue, last - 1, Span<ItemID>(parsed.data(), 1), ',');
+    RED4EXT_CHECK(read.ec == std::errc::invalid_argument);
+}
@@ -0,0 +1,379 @@
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <RED4ext/ClassLayout.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/RTTITypes.hpp>
+#include <RED4ext/Relocation.hpp>
+#include <RED4ext/Scripting/CProperty.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Properties add their names to the name pool, only the hash is needed here.
+CName* NamePoolAdd(CName& aResult, const char* aText)
+{
+    aResult = aText ? CName(aText) : CName();
+    return &aResult;
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveNamePool(uint32_t aHash)
+{
+    if (aHash == Detail::AddressHashes::CNamePool_AddCstr)
+    {
+        return reinterpret_cast<uintptr_t>(&NamePoolAdd);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+void Setup()
+{
+    [[maybe_unused]] static const auto isInstalled = []
+    {
+        g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveNamePool);
+        return true;
+    }();
+
+    ClassLayout::Clear();
+}
+
+// A value type that compares bytewise and counts how often it is compared through RTTI.
+struct StandInType : CBaseRTTIType
+{
+    StandInType(ERTTIType aType, uint32_t aSize, CName aName = {})
+        : type(aType)
+        , size(aSize)
+        , name(aName)
+    {
+    }
+
+    CName GetName() const override
+    {
+        return name;
+    }
+
+    uint32_t GetSize() const override
+    {
+        return size;
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return 1;
+    }
+
+    ERTTIType GetType() const override
+    {
+        return type;
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance aLhs, const ScriptInstance aRhs, uint32_t) override
+    {
+        comparisons.fetch_add(1, std::memory_order_relaxed);
+        return std::memcmp(aLhs, aRhs, size) == 0;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+
+    ERTTIType type;
+    uint32_t size;
+    CName name;
+    std::atomic<uint32_t> comparisons = 0;
+};
+
+struct StandInClass : CClass
+{
+    explicit StandInClass(size_t aSize)
+        : CClass(CName(), static_cast<uint32_t>(aSize), {})
+    {
+    }
+
+    void AddProperty(CBaseRTTIType* aType, const char* aName, size_t aOffset)
+    {
+        properties.emplace_back(new CProperty(aType, aName, this, static_cast<uint32_t>(aOffset)));
+        props.PushBack(properties.back().get());
+    }
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+    void ConstructCls(ScriptInstance) const override {}
+    void DestructCls(ScriptInstance) const override {}
+
+    void* AllocMemory() const override
+    {
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<CProperty>> properties;
+};
+
+struct Vector3
+{
+    float x;
+    float y;
+    float z;
+};
+
+struct Object
+{
+    int32_t count;       // 00
+    float weight;        // 04
+    uint64_t name;       // 08
+    void* handle[2];     // 10
+    uint64_t id;         // 20
+    uint8_t complex[16]; // 28
+    Vector3 position;    // 38
+};
+
+struct Types
+{
+    StandInType int32{ERTTIType::Fundamental, 4};
+    StandInType float32{ERTTIType::Fundamental, 4};
+    StandInType uint64{ERTTIType::Fundamental, 8};
+    StandInType cname{ERTTIType::Name, 8};
+    StandInType handle{ERTTIType::Handle, 16};
+    StandInType string{ERTTIType::Simple, 16, "String"};
+    StandInClass vector3{sizeof(Vector3)};
+    StandInClass object{sizeof(Object)};
+
+    Types()
+    {
+        vector3.AddProperty(&float32, "x", offsetof(Vector3, x));
+        vector3.AddProperty(&float32, "y", offsetof(Vector3, y));
+        vector3.AddProperty(&float32, "z", offsetof(Vector3, z));
+
+        // Registered out of order, the layout sorts the fields by offset.
+        object.AddProperty(&vector3, "position", offsetof(Object, position));
+        object.AddProperty(&int32, "count", offsetof(Object, count));
+        object.AddProperty(&float32, "weight", offsetof(Object, weight));
+        object.AddProperty(&cname, "name", offsetof(Object, name));
+        object.AddProperty(&handle, "handle", offsetof(Object, handle));
+        object.AddProperty(&uint64, "id", offsetof(Object, id));
+        object.AddProperty(&string, "complex", offsetof(Object, complex));
+    }
+};
+
+Object MakeObject()
+{
+    Object object{};
+    object.count = 3;
+    object.weight = 1.5f;
+    object.name = 0x1234;
+    object.id = 42;
+    object.complex[0] = 7;
+    object.position = {1.0f, 2.0f, 3.0f};
+
+    return object;
+}
+} // namespace
+
+RED4EXT_TEST(ClassLayout_BuildsSortedFieldsAndSpans)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+    RED4EXT_CHECK(layout == ClassLayout::Get(&types.object));
+    RED4EXT_CHECK(layout->GetClass() == &types.object);
+    RED4EXT_CHECK(!layout->IsPod());
+
+    const auto& fields = layout->GetFields();
+    RED4EXT_REQUIRE(fields.size() == 9);
+
+    const uint32_t offsets[] = {0x00, 0x04, 0x08, 0x10, 0x20, 0x28, 0x38, 0x3C, 0x40};
+    for (uint32_t i = 0; i < 9; ++i)
+    {
+        RED4EXT_CHECK(fields[i].offset == offsets[i]);
+    }
+
+    RED4EXT_CHECK(fields[2].kind == ClassLayout::FieldKind::Name);
+    RED4EXT_CHECK(fields[3].kind == ClassLayout::FieldKind::Handle);
+    RED4EXT_CHECK(fields[5].kind == ClassLayout::FieldKind::Complex);
+
+    // The fields of the embedded struct belong to the top-level property.
+    RED4EXT_CHECK(fields[7].property == types.object.properties[0].get());
+
+    const auto& spans = layout->GetSpans();
+    RED4EXT_REQUIRE(spans.size() == 3);
+    RED4EXT_CHECK(spans[0].offset == 0x00 && spans[0].size == 0x10);
+    RED4EXT_CHECK(spans[0].firstField == 0 && spans[0].lastField == 2);
+    RED4EXT_CHECK(spans[1].offset == 0x20 && spans[1].size == 0x08);
+    RED4EXT_CHECK(spans[1].firstField == 4 && spans[1].lastField == 4);
+    RED4EXT_CHECK(spans[2].offset == 0x38 && spans[2].size == 0x0C);
+    RED4EXT_CHECK(spans[2].firstField == 6 && spans[2].lastField == 8);
+
+    RED4EXT_CHECK(ClassLayout::Get(nullptr) == nullptr);
+}
+
+RED4EXT_TEST(ClassLayout_Equal)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+
+    auto lhs = MakeObject();
+    auto rhs = MakeObject();
+    RED4EXT_CHECK(layout->Equal(&lhs, &rhs));
+
+    rhs.position.z = 4.0f;
+    RED4EXT_CHECK(!layout->Equal(&lhs, &rhs));
+
+    rhs = MakeObject();
+    rhs.complex[15] = 1;
+    RED4EXT_CHECK(!layout->Equal(&lhs, &rhs));
+
+    rhs = MakeObject();
+    rhs.handle[0] = &lhs;
+    RED4EXT_CHECK(!layout->Equal(&lhs, &rhs));
+
+    // Handles compare by instance only, the reference count does not matter.
+    rhs = MakeObject();
+    rhs.handle[1] = &lhs;
+    RED4EXT_CHECK(layout->Equal(&lhs, &rhs));
+}
+
+RED4EXT_TEST(ClassLayout_Diff)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+
+    auto lhs = MakeObject();
+    auto rhs = MakeObject();
+
+    std::vector<uint32_t> fields;
+    RED4EXT_CHECK(layout->Diff(&lhs, &rhs, fields) == 0);
+    RED4EXT_CHECK(fields.empty());
+
+    rhs.weight = 2.0f;
+    rhs.handle[0] = &lhs;
+    rhs.complex[3] = 9;
+    rhs.position.y = 5.0f;
+
+    // Indexes are appended after the existing ones, in field order.
+    fields.push_back(100);
+    RED4EXT_CHECK(layout->Diff(&lhs, &rhs, fields) == 4);
+    RED4EXT_CHECK((fields == std::vector<uint32_t>{100, 1, 3, 5, 7}));
+}
+
+RED4EXT_TEST(ClassLayout_DiffOnlyComparesFieldsOfDifferingSpans)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+
+    auto lhs = MakeObject();
+    auto rhs = MakeObject();
+    rhs.count = 4;
+
+    std::vector<uint32_t> fields;
+    RED4EXT_CHECK(layout->Diff(&lhs, &rhs, fields) == 1);
+    RED4EXT_CHECK((fields == std::vector<uint32_t>{0}));
+
+    // Bytewise fields are never compared through RTTI, the complex field is compared once.
+    RED4EXT_CHECK(types.int32.comparisons == 0);
+    RED4EXT_CHECK(types.float32.comparisons == 0);
+    RED4EXT_CHECK(types.string.comparisons == 1);
+}
+
+RED4EXT_TEST(ClassLayout_CopyPod)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+
+    auto src = MakeObject();
+    src.handle[0] = &src;
+
+    Object dst{};
+    layout->CopyPod(&dst, &src);
+
+    RED4EXT_CHECK(dst.count == src.count);
+    RED4EXT_CHECK(dst.weight == src.weight);
+    RED4EXT_CHECK(dst.name == src.name);
+    RED4EXT_CHECK(dst.id == src.id);
+    RED4EXT_CHECK(dst.position.z == src.position.z);
+
+    // Handles and complex fields need their type to be copied.
+    RED4EXT_CHECK(dst.handle[0] == nullptr);
+    RED4EXT_CHECK(dst.complex[0] == 0);
+}
+
+RED4EXT_TEST(ClassLayout_Hash)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+
+    auto lhs = MakeObject();
+    auto rhs = MakeObject();
+    RED4EXT_CHECK(layout->Hash(&lhs) == layout->Hash(&rhs));
+    RED4EXT_CHECK(layout->Hash(&lhs, 1) != layout->Hash(&lhs, 2));
+
+    // Complex fields are not hashed, equal instances always hash the same.
+    rhs.complex[0] = 1;
+    RED4EXT_CHECK(layout->Hash(&lhs) == layout->Hash(&rhs));
+
+    rhs.id = 43;
+    RED4EXT_CHECK(layout->Hash(&lhs) != layout->Hash(&rhs));
+
+    rhs = MakeObject();
+    rhs.handle[0] = &lhs;
+    RED4EXT_CHECK(layout->Hash(&lhs) != layout->Hash(&rhs));
+}
+
+RED4EXT_TEST(ClassLayout_InvalidateKeepsOldLayoutAlive)
+{
+    Setup();
+    Types types;
+
+    auto layout = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(layout != nullptr);
+
+    ClassLayout::Invalidate(&types.object);
+
+    auto rebuilt = ClassLayout::Get(&types.object);
+    RED4EXT_REQUIRE(rebuilt != nullptr);
+    RED4EXT_CHECK(rebuilt != layout);
+
+    // The retired layout is still usable until Clear().
+    auto lhs = MakeObject();
+    auto rhs = MakeObject();
+    RED4EXT_CHECK(layout->Equal(&lhs, &rhs));
+    RED4EXT_CHECK(layout->GetFields().size() == rebuilt->GetFields().size());
+
+    ClassLayout::Clear();
+    RED4EXT_CHECK(ClassLayout::Get(&types.object) != nullptr);
+}
@@ -0,0 +1,684 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ResourceLoader.hpp is not self-contained, its CResource include needs the loader already.
+#include <RED4ext/RED4ext.hpp>
+
+#include <RED4ext/Coroutine.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's job system. Handles are reference counted through unk1C like in the game, the jobs of a
+// submitted queue run in Pump() once every handle the queue waits on has completed. Other handles are completed by the
+// test.
+struct JobSystem
+{
+    enum class Kind
+    {
+        Manual,
+        Gate, // Completes with the handles joined to it, the start of a queue.
+        Queue // Completes after the jobs of the queue ran.
+    };
+
+    struct State
+    {
+        Kind kind = Kind::Manual;
+        bool completed = false;
+        std::vector<JobInternalHandle*> waits;
+        std::vector<JobInstance> jobs;
+    };
+
+    std::recursive_mutex lock;
+    std::unordered_map<JobInternalHandle*, State> states;
+    std::vector<std::pair<JobInternalHandle*, JobInternalHandle*>> queues; // Gate and completion of submitted queues.
+    void (*runJob)(const JobInstance&) = nullptr;
+};
+
+JobSystem& GetJobSystem()
+{
+    static JobSystem system;
+    return system;
+}
+
+void AddRef(JobInternalHandle* aHandle)
+{
+    InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(1));
+}
+
+void Release(JobInternalHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(-1)) != 1)
+    {
+        return;
+    }
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto waits = std::move(system.states[aHandle].waits);
+    system.states.erase(aHandle);
+    delete aHandle;
+
+    for (auto wait : waits)
+    {
+        Release(wait);
+    }
+}
+
+bool IsCompleted(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    const auto& state = system.states[aHandle];
+    if (state.kind != JobSystem::Kind::Gate)
+    {
+        return state.completed;
+    }
+
+    return std::all_of(state.waits.begin(), state.waits.end(), &IsCompleted);
+}
+
+void Complete(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[aHandle].completed = true;
+}
+
+// Runs the jobs of one queue that is ready, outside of the lock so that several threads can run jobs at once. Returns
+// false if no queue is ready.
+bool RunQueue()
+{
+    auto& system = GetJobSystem();
+
+    JobInternalHandle* gate;
+    JobInternalHandle* queue;
+    std::vector<JobInstance> jobs;
+    {
+        std::lock_guard<std::recursive_mutex> _(system.lock);
+
+        auto it = std::find_if(system.queues.begin(), system.queues.end(),
+                               [](const auto& aQueue) { return IsCompleted(aQueue.first); });
+        if (it == system.queues.end())
+        {
+            return false;
+        }
+
+        gate = it->first;
+        queue = it->second;
+        jobs = std::move(system.states[queue].jobs);
+        system.queues.erase(it);
+    }
+
+    for (const auto& job : jobs)
+    {
+        system.runJob(job);
+    }
+
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[queue].completed = true;
+    Release(gate);
+    Release(queue);
+
+    return true;
+}
+
+// Runs queues until none is ready, returns the number of queues that completed.
+uint32_t Pump()
+{
+    uint32_t completed = 0;
+    while (RunQueue())
+    {
+        ++completed;
+    }
+
+    return completed;
+}
+
+// Releases the queues that never became ready.
+void DropQueues()
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto queues = std::move(system.queues);
+    for (auto [gate, queue] : queues)
+    {
+        Release(gate);
+        Release(queue);
+    }
+}
+
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[handle];
+
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    Release(aHandle->internal);
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle& aOther)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    AddRef(aOther.internal);
+    system.states[aHandle->internal].waits.push_back(aOther.internal);
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    // The handles were acquired by the members' constructors.
+    system.states[aQueue->unk10.internal].kind = JobSystem::Kind::Gate;
+    system.states[aQueue->unk18.internal].kind = JobSystem::Kind::Queue;
+    aQueue->captured = false;
+
+    return aQueue;
+}
+
+void DestructJobQueue(JobQueue* aQueue)
+{
+    // A queue that was not captured is submitted when it goes out of scope, the members' destructors release the
+    // handles.
+    if (!aQueue->captured)
+    {
+        auto& system = GetJobSystem();
+        std::lock_guard<std::recursive_mutex> _(system.lock);
+
+        AddRef(aQueue->unk10.internal);
+        AddRef(aQueue->unk18.internal);
+        system.queues.emplace_back(aQueue->unk10.internal, aQueue->unk18.internal);
+    }
+}
+
+JobHandle* CaptureJobQueue(JobQueue* aQueue, JobHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    Release(aHandle->internal);
+    aHandle->internal = aQueue->unk18.internal;
+    AddRef(aHandle->internal);
+
+    AddRef(aQueue->unk10.internal);
+    AddRef(aQueue->unk18.internal);
+    system.queues.emplace_back(aQueue->unk10.internal, aQueue->unk18.internal);
+    aQueue->captured = true;
+
+    return aHandle;
+}
+
+uint32_t DispatchJob(void*, const JobInstance& aJob, uint8_t, JobInternalHandle*, JobInternalHandle* aQueue)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    system.states[aQueue].jobs.push_back(aJob);
+    return 0;
+}
+
+void SyncWaitJobQueue(JobQueue*)
+{
+}
+
+// The game's handler also sets a job parameter in the game's thread local storage, which does not exist here. Run the
+// closure directly and release it like the handler does.
+template<typename L>
+bool RunClosure(const JobInstance& aJob)
+{
+    using Closure = JobClosure<L>;
+
+    if (aJob.handler != reinterpret_cast<JobInstance::HandleFunc<void>>(&Closure::HandleTarget))
+    {
+        return false;
+    }
+
+    auto closure = static_cast<L*>(aJob.target);
+    (*closure)();
+    Memory::Delete<typename Closure::AllocatorType>(closure);
+
+    return true;
+}
+
+// Coroutines are resumed by their own job, a buffer group also counts its loads down with jobs.
+void RunJob(const JobInstance& aJob)
+{
+    RED4EXT_REQUIRE(RunClosure<Detail::ResumeJob>(aJob) || RunClosure<Detail::DeferredDataBufferCountDown>(aJob));
+}
+
+void* g_jobDispatcher = nullptr;
+
+JobHandle* LoadBufferAsync(DeferredDataBuffer* aBuffer, JobHandle* aJob, int64_t)
+{
+    std::atomic_ref<DeferredDataBufferState>(aBuffer->state).store(DeferredDataBufferState::Loading);
+    return aJob;
+}
+
+void CancelTokenJob(void*)
+{
+}
+
+void DestructTokenJob(void**)
+{
+}
+
+void DecWeakRef(SharedPtrBase<void>* aPtr)
+{
+    if (InterlockedExchangeAdd(&aPtr->refCount->weakRefs, static_cast<uint32_t>(-1)) == 1)
+    {
+        Memory::Delete(aPtr->refCount);
+    }
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveScheduler(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_Capture:
+        return reinterpret_cast<uintptr_t>(&CaptureJobQueue);
+    case JobQueue_SyncWait:
+        return reinterpret_cast<uintptr_t>(&SyncWaitJobQueue);
+    case JobDispatcher_DispatchJob:
+        return reinterpret_cast<uintptr_t>(&DispatchJob);
+    case JobDispatcher:
+        return reinterpret_cast<uintptr_t>(&g_jobDispatcher);
+    case DeferredDataBuffer_LoadAsync:
+        return reinterpret_cast<uintptr_t>(&LoadBufferAsync);
+    case ResourceToken_CancelUnk38:
+        return reinterpret_cast<uintptr_t>(&CancelTokenJob);
+    case ResourceToken_DestructUnk38:
+        return reinterpret_cast<uintptr_t>(&DestructTokenJob);
+    case Handle_DecWeakRef:
+        return reinterpret_cast<uintptr_t>(&DecWeakRef);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// Installs the stand-ins once, every test runs the jobs it started before it ends.
+struct FakeScheduler
+{
+    FakeScheduler()
+    {
+        [[maybe_unused]] static const auto isInstalled = []
+        {
+            g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveScheduler);
+            return true;
+        }();
+
+        GetJobSystem().runJob = &RunJob;
+    }
+
+    ~FakeScheduler()
+    {
+        Pump();
+        DropQueues();
+    }
+};
+
+Task<int32_t> Add(int32_t aLhs, int32_t aRhs)
+{
+    co_return aLhs + aRhs;
+}
+
+Task<void> StoreSum(int32_t aLhs, int32_t aRhs, int32_t& aResult)
+{
+    aResult = co_await Add(aLhs, aRhs);
+}
+
+Task<int32_t> WaitAndReturn(JobHandle aJob, int32_t aValue)
+{
+    co_await aJob;
+    co_return aValue;
+}
+
+Task<void> Wait(JobHandle aJob)
+{
+    co_await aJob;
+}
+} // namespace
+
+RED4EXT_TEST(Coroutine_TaskRunsFromAJob)
+{
+    FakeScheduler scheduler;
+
+    int32_t result = 0;
+    Spawn(StoreSum(1, 2, result));
+
+    // Spawn() only schedules the task.
+    RED4EXT_CHECK(result == 0);
+
+    RED4EXT_CHECK(Pump() == 1);
+    RED4EXT_CHECK(result == 3);
+}
+
+RED4EXT_TEST(Coroutine_TaskIsLazy)
+{
+    FakeScheduler scheduler;
+
+    int32_t result = 0;
+    {
+        auto task = StoreSum(1, 2, result);
+        RED4EXT_CHECK(task.IsValid());
+        RED4EXT_CHECK(!task.IsFinished());
+    }
+
+    // Destroyed without being awaited, the body never ran.
+    RED4EXT_CHECK(result == 0);
+    RED4EXT_CHECK(Pump() == 0);
+}
+
+RED4EXT_TEST(Coroutine_AwaitsEmptyTasks)
+{
+    FakeScheduler scheduler;
+
+    Task<void> empty;
+    RED4EXT_CHECK(!empty.IsValid());
+    RED4EXT_CHECK(empty.IsFinished());
+
+    bool isContinued = false;
+    bool hasThrown = false;
+
+    auto awaitEmpty = [](bool& aIsContinued, bool& aHasThrown) -> Task<void>
+    {
+        auto task = Add(1, 2);
+        auto moved = std::move(task);
+
+        co_await Task<void>{};
+        aIsContinued = true;
+
+        try
+        {
+            co_await std::move(task);
+        }
+        catch (const std::logic_error&)
+        {
+            aHasThrown = true;
+        }
+
+        co_await std::move(moved);
+    };
+
+    Spawn(awaitEmpty(isContinued, hasThrown));
+    Pump();
+
+    RED4EXT_CHECK(isContinued);
+    RED4EXT_CHECK(hasThrown);
+}
+
+RED4EXT_TEST(Coroutine_ResumesAfterTheJob)
+{
+    FakeScheduler scheduler;
+
+    JobHandle job;
+    int32_t result = 0;
+
+    auto storeAfter = [](JobHandle aJob, int32_t& aResult) -> Task<void>
+    { aResult = co_await WaitAndReturn(std::move(aJob), 7); };
+
+    Spawn(storeAfter(job, result));
+    Pump();
+    RED4EXT_CHECK(result == 0);
+
+    // The coroutine is not resumed inline, a job resumes it once the handle has completed.
+    Complete(job.internal);
+    RED4EXT_CHECK(result == 0);
+
+    RED4EXT_CHECK(Pump() == 1);
+    RED4EXT_CHECK(result == 7);
+}
+
+RED4EXT_TEST(Coroutine_AwaitsResourceTokens)
+{
+    FakeScheduler scheduler;
+
+    auto finished = MakeShared<ResourceToken<>>();
+    finished->finished = 1;
+
+    auto loading = MakeShared<ResourceToken<>>();
+
+    uint32_t steps = 0;
+    auto awaitTokens = [](SharedPtr<ResourceToken<>> aFinished, SharedPtr<ResourceToken<>> aLoading,
+                          uint32_t& aSteps) -> Task<void>
+    {
+        // A finished token does not suspend.
+        auto token = co_await aFinished;
+        aSteps += token == aFinished;
+
+        token = co_await aLoading;
+        aSteps += token == aLoading;
+    };
+
+    Spawn(awaitTokens(finished, loading, steps));
+    Pump();
+    RED4EXT_CHECK(steps == 1);
+
+    loading->finished = 1;
+    Complete(loading->job.internal);
+    Pump();
+    RED4EXT_CHECK(steps == 2);
+}
+
+RED4EXT_TEST(Coroutine_AwaitsBufferGroups)
+{
+    FakeScheduler scheduler;
+
+    DeferredDataBuffer buffers[2]{};
+    DeferredDataBufferGroup group;
+
+    bool isLoaded = false;
+    auto awaitGroup = [](DeferredDataBuffer* aBuffers, DeferredDataBufferGroup& aGroup, bool& aIsLoaded) -> Task<void>
+    {
+        aGroup.Load(Span<DeferredDataBuffer>(aBuffers, 2));
+        co_await aGroup;
+
+        aIsLoaded = aGroup.IsReady();
+    };
+
+    Spawn(awaitGroup(buffers, group, isLoaded));
+    Pump();
+    RED4EXT_CHECK(!isLoaded);
+
+    // The loads are the only handles that are not queues.
+    auto& system = GetJobSystem();
+    {
+        std::lock_guard<std::recursive_mutex> _(system.lock);
+        for (auto& [handle, state] : system.states)
+        {
+            if (state.kind == JobSystem::Kind::Manual && handle != group.GetJob().internal)
+            {
+                state.completed = true;
+            }
+        }
+    }
+
+    Pump();
+    RED4EXT_CHECK(isLoaded);
+}
+
+RED4EXT_TEST(Coroutine_WhenAllKeepsTheOrder)
+{
+    FakeScheduler scheduler;
+
+    JobHandle jobs[3];
+    std::vector<int32_t> values;
+
+    auto collect = [](JobHandle* aJobs, std::vector<int32_t>& aValues) -> Task<void>
+    {
+        std::vector<Task<int32_t>> tasks;
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            tasks.push_back(WaitAndReturn(aJobs[i], i * 10));
+        }
+
+        aValues = co_await WhenAll(std::move(tasks));
+    };
+
+    Spawn(collect(jobs, values));
+    Pump();
+
+    // Finished in reverse order.
+    for (int32_t i = 2; i >= 0; --i)
+    {
+        Complete(jobs[i].internal);
+        Pump();
+    }
+
+    RED4EXT_REQUIRE(values.size() == 3);
+    RED4EXT_CHECK(values[0] == 0 && values[1] == 10 && values[2] == 20);
+}
+
+RED4EXT_TEST(Coroutine_WhenAnyReturnsTheFirst)
+{
+    FakeScheduler scheduler;
+
+    JobHandle jobs[3];
+    size_t index = 0;
+    std::pair<size_t, int32_t> first;
+
+    auto race = [](JobHandle* aJobs, size_t& aIndex, std::pair<size_t, int32_t>& aFirst) -> Task<void>
+    {
+        std::vector<Task<void>> waits;
+        std::vector<Task<int32_t>> values;
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            waits.push_back(Wait(aJobs[i]));
+            values.push_back(WaitAndReturn(aJobs[i], i * 10));
+        }
+
+        aIndex = co_await WhenAny(std::move(waits));
+        aFirst = co_await WhenAny(std::move(values));
+    };
+
+    Spawn(race(jobs, index, first));
+    Pump();
+
+    Complete(jobs[1].internal);
+    Pump();
+    RED4EXT_CHECK(index == 1);
+    RED4EXT_CHECK(first.first == 1 && first.second == 10);
+
+    // The others keep running until they finish on their own.
+    Complete(jobs[0].internal);
+    Complete(jobs[2].internal);
+    Pump();
+    RED4EXT_CHECK(index == 1);
+    RED4EXT_CHECK(first.first == 1);
+}
+
+RED4EXT_TEST(Coroutine_WhenAnyOfNothing)
+{
+    FakeScheduler scheduler;
+
+    size_t index = 0;
+    auto race = [](size_t& aIndex) -> Task<void> { aIndex = co_await WhenAny(std::vector<Task<void>>{}); };
+
+    Spawn(race(index));
+    Pump();
+    RED4EXT_CHECK(index == static_cast<size_t>(-1));
+}
+
+RED4EXT_TEST(Coroutine_RunsOnSeveralThreads)
+{
+    FakeScheduler scheduler;
+
+    constexpr uint32_t TaskCount = 64;
+    constexpr uint32_t Hops = 8;
+
+    std::atomic<uint32_t> finished = 0;
+    std::atomic<uint32_t> hops = 0;
+
+    auto hop = [](std::atomic<uint32_t>& aHops) -> Task<void>
+    {
+        for (uint32_t i = 0; i < Hops; ++i)
+        {
+            co_await Schedule();
+            aHops.fetch_add(1);
+        }
+    };
+
+    auto run = [hop](std::atomic<uint32_t>& aHops, std::atomic<uint32_t>& aFinished) -> Task<void>
+    {
+        std::vector<Task<void>> tasks;
+        tasks.push_back(hop(aHops));
+        tasks.push_back(hop(aHops));
+
+        co_await WhenAll(std::move(tasks));
+        aFinished.fetch_add(1);
+    };
+
+    std::atomic<bool> isRunning = true;
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        workers.emplace_back(
+            [&isRunning]
+            {
+                while (isRunning.load())
+                {
+                    if (!RunQueue())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    for (uint32_t i = 0; i < TaskCount; ++i)
+    {
+        Spawn(run(hops, finished));
+    }
+
+    while (finished.load() != TaskCount)
+    {
+        std::this_thread::yield();
+    }
+
+    isRunning = false;
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    RED4EXT_CHECK(hops.load() == TaskCount * 2 * Hops);
+}
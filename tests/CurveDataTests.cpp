@@ -0,0 +1,261 @@
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <RED4ext/NativeTypes.hpp>
+#include <RED4ext/Scripting/Natives/Vector3.hpp>
+#include <RED4ext/Scripting/Natives/Vector4.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+constexpr curve::EInterpolationType InterpolationTypes[] = {
+    curve::EInterpolationType::EIT_Constant,        curve::EInterpolationType::EIT_Linear,
+    curve::EInterpolationType::EIT_BezierQuadratic, curve::EInterpolationType::EIT_BezierCubic,
+    curve::EInterpolationType::EIT_Hermite,
+};
+
+template<typename T>
+struct Curve : CurveData<T>
+{
+    explicit Curve(curve::EInterpolationType aType)
+        : CurveData<T>{}
+    {
+        this->interpolationType = aType;
+    }
+
+    Curve(const Curve&) = delete;
+    Curve& operator=(const Curve&) = delete;
+};
+
+float MakeValue(std::mt19937& aRandom, float)
+{
+    return std::uniform_real_distribution<float>(-100.0f, 100.0f)(aRandom);
+}
+
+Vector3 MakeValue(std::mt19937& aRandom, Vector3)
+{
+    return {MakeValue(aRandom, 0.0f), MakeValue(aRandom, 0.0f), MakeValue(aRandom, 0.0f)};
+}
+
+Vector4 MakeValue(std::mt19937& aRandom, Vector4)
+{
+    return {MakeValue(aRandom, 0.0f), MakeValue(aRandom, 0.0f), MakeValue(aRandom, 0.0f), MakeValue(aRandom, 0.0f)};
+}
+
+// Keys at irregular points between 0 and about aSize, with random values.
+template<typename T>
+void FillCurve(CurveData<T>& aCurve, uint32_t aSize, uint32_t aSeed)
+{
+    std::mt19937 random(aSeed);
+    std::uniform_real_distribution<float> step(0.1f, 2.0f);
+
+    aCurve.Resize(aSize);
+
+    float point = 0.0f;
+    for (uint32_t i = 0; i < aSize; ++i)
+    {
+        aCurve.SetPoint(i, point, MakeValue(random, T()));
+        point += step(random);
+    }
+}
+
+// The results of EvaluateMany() must not differ in a single bit, not even in the sign of a zero.
+template<typename T>
+bool IsBitExact(const T& aLeft, const T& aRight)
+{
+    return std::memcmp(&aLeft, &aRight, sizeof(T)) == 0;
+}
+
+template<typename T>
+uint32_t CountMismatches(const CurveData<T>& aCurve, const std::vector<float>& aPoints)
+{
+    std::vector<T> results(aPoints.size());
+    aCurve.EvaluateMany(Span<const float>(aPoints.data(), aPoints.size()), Span<T>(results.data(), results.size()));
+
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < aPoints.size(); ++i)
+    {
+        mismatches += !IsBitExact(aCurve.Evaluate(aPoints[i]), results[i]);
+    }
+
+    return mismatches;
+}
+
+template<typename T>
+void CheckEvaluateMany(uint32_t aSize)
+{
+    // Counts that are not a multiple of the SIMD width or of the batch, with points before, inside and after the curve.
+    constexpr uint32_t PointCount = 1000;
+
+    std::mt19937 random(aSize);
+    std::uniform_real_distribution<float> distribution(-1.0f, static_cast<float>(aSize) * 2.2f);
+
+    std::vector<float> randomPoints(PointCount);
+    for (auto& point : randomPoints)
+    {
+        point = distribution(random);
+    }
+
+    std::vector<float> sortedPoints(PointCount);
+    for (uint32_t i = 0; i < PointCount; ++i)
+    {
+        sortedPoints[i] = -1.0f + static_cast<float>(i) * static_cast<float>(aSize) * 2.2f / PointCount;
+    }
+
+    for (auto type : InterpolationTypes)
+    {
+        Curve<T> curve(type);
+        FillCurve(curve, aSize, aSize + 1);
+
+        RED4EXT_CHECK(CountMismatches(curve, randomPoints) == 0);
+        RED4EXT_CHECK(CountMismatches(curve, sortedPoints) == 0);
+    }
+}
+} // namespace
+
+RED4EXT_TEST(CurveData_Evaluate_Empty)
+{
+    Curve<float> curve(curve::EInterpolationType::EIT_Linear);
+    RED4EXT_CHECK(curve.Evaluate(1.0f) == 0.0f);
+
+    float points[] = {0.0f, 1.0f, 2.0f};
+    float results[] = {1.0f, 1.0f, 1.0f};
+    curve.EvaluateMany(Span<const float>(points, 3), Span<float>(results, 3));
+
+    RED4EXT_CHECK(results[0] == 0.0f && results[1] == 0.0f && results[2] == 0.0f);
+}
+
+RED4EXT_TEST(CurveData_Evaluate_ClampsToEnds)
+{
+    Curve<float> curve(curve::EInterpolationType::EIT_Hermite);
+    curve.Resize(1);
+    curve.SetPoint(0, 5.0f, 3.0f);
+
+    RED4EXT_CHECK(curve.Evaluate(-10.0f) == 3.0f);
+    RED4EXT_CHECK(curve.Evaluate(5.0f) == 3.0f);
+    RED4EXT_CHECK(curve.Evaluate(10.0f) == 3.0f);
+
+    curve.Resize(2);
+    curve.SetPoint(1, 6.0f, 7.0f);
+
+    RED4EXT_CHECK(curve.Evaluate(4.0f) == 3.0f);
+    RED4EXT_CHECK(curve.Evaluate(6.0f) == 7.0f);
+    RED4EXT_CHECK(curve.Evaluate(100.0f) == 7.0f);
+}
+
+RED4EXT_TEST(CurveData_Evaluate_Linear)
+{
+    Curve<float> curve(curve::EInterpolationType::EIT_Linear);
+    curve.Resize(3);
+    curve.SetPoint(0, 0.0f, 0.0f);
+    curve.SetPoint(1, 1.0f, 10.0f);
+    curve.SetPoint(2, 3.0f, 0.0f);
+
+    RED4EXT_CHECK(curve.Evaluate(0.0f) == 0.0f);
+    RED4EXT_CHECK(curve.Evaluate(0.5f) == 5.0f);
+    RED4EXT_CHECK(curve.Evaluate(1.0f) == 10.0f);
+    RED4EXT_CHECK(curve.Evaluate(2.0f) == 5.0f);
+    RED4EXT_CHECK(curve.Evaluate(2.5f) == 2.5f);
+}
+
+RED4EXT_TEST(CurveData_Evaluate_Constant)
+{
+    Curve<float> curve(curve::EInterpolationType::EIT_Constant);
+    curve.Resize(3);
+    curve.SetPoint(0, 0.0f, 1.0f);
+    curve.SetPoint(1, 1.0f, 2.0f);
+    curve.SetPoint(2, 2.0f, 3.0f);
+
+    RED4EXT_CHECK(curve.Evaluate(0.5f) == 1.0f);
+    RED4EXT_CHECK(curve.Evaluate(1.0f) == 2.0f);
+    RED4EXT_CHECK(curve.Evaluate(1.99f) == 2.0f);
+    RED4EXT_CHECK(curve.Evaluate(2.0f) == 3.0f);
+}
+
+RED4EXT_TEST(CurveData_Evaluate_HitsKeys)
+{
+    for (auto type : InterpolationTypes)
+    {
+        Curve<float> curve(type);
+        FillCurve(curve, 16, 7);
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            auto key = curve.GetPoint(i);
+            RED4EXT_CHECK(curve.Evaluate(key.point) == key.value);
+        }
+    }
+}
+
+RED4EXT_TEST(CurveData_Evaluate_NotInterpolable)
+{
+    // Names can not be interpolated, the curve holds the value of the key in front of the point.
+    Curve<CName> curve(curve::EInterpolationType::EIT_Linear);
+    curve.Resize(2);
+    curve.SetPoint(0, 0.0f, CName(1ull));
+    curve.SetPoint(1, 1.0f, CName(2ull));
+
+    RED4EXT_CHECK(curve.Evaluate(0.5f) == CName(1ull));
+    RED4EXT_CHECK(curve.Evaluate(1.0f) == CName(2ull));
+
+    float points[] = {-1.0f, 0.5f, 2.0f};
+    CName results[3];
+    curve.EvaluateMany(Span<const float>(points, 3), Span<CName>(results, 3));
+
+    RED4EXT_CHECK(results[0] == CName(1ull));
+    RED4EXT_CHECK(results[1] == CName(1ull));
+    RED4EXT_CHECK(results[2] == CName(2ull));
+}
+
+RED4EXT_TEST(CurveData_Evaluate_HintDoesNotChangeResults)
+{
+    Curve<float> curve(curve::EInterpolationType::EIT_Hermite);
+    FillCurve(curve, 256, 3);
+
+    std::mt19937 random(4);
+    std::uniform_real_distribution<float> distribution(-1.0f, 600.0f);
+
+    // A stale hint from an unrelated query must only cost time.
+    uint32_t hint = 0;
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        auto point = distribution(random);
+        mismatches += !IsBitExact(curve.Evaluate(point, hint), curve.Evaluate(point));
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+}
+
+RED4EXT_TEST(CurveData_EvaluateMany_MatchesEvaluate)
+{
+    // A single segment, a few segments and more keys than a batch holds.
+    for (uint32_t size : {2u, 5u, 64u, 1000u})
+    {
+        CheckEvaluateMany<float>(size);
+        CheckEvaluateMany<Vector3>(size);
+        CheckEvaluateMany<Vector4>(size);
+    }
+}
+
+RED4EXT_TEST(CurveData_EvaluateMany_ShorterResults)
+{
+    Curve<float> curve(curve::EInterpolationType::EIT_Linear);
+    curve.Resize(2);
+    curve.SetPoint(0, 0.0f, 0.0f);
+    curve.SetPoint(1, 1.0f, 1.0f);
+
+    // Only as many points as there are results are evaluated.
+    float points[] = {0.25f, 0.5f, 0.75f};
+    float results[] = {-1.0f, -1.0f, -1.0f};
+    curve.EvaluateMany(Span<const float>(points, 3), Span<float>(results, 2));
+
+    RED4EXT_CHECK(results[0] == 0.25f);
+    RED4EXT_CHECK(results[1] == 0.5f);
+    RED4EXT_CHECK(results[2] == -1.0f);
+}
@@ -0,0 +1,529 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/DeferredDataBufferGroup.hpp>
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's job system. Handles are reference counted through unk1C like in the game, the jobs of a
+// captured queue run in Pump() once every handle the queue waits on has completed. Load handles are completed by the
+// test through the buffer loader.
+struct JobSystem
+{
+    enum class Kind
+    {
+        Manual,
+        Gate, // Completes with the handles joined to it, the start of a queue.
+        Queue // Completes after the jobs of the queue ran.
+    };
+
+    struct State
+    {
+        Kind kind = Kind::Manual;
+        bool completed = false;
+        std::vector<JobInternalHandle*> waits;
+        std::vector<JobInstance> jobs;
+    };
+
+    std::recursive_mutex lock;
+    std::unordered_map<JobInternalHandle*, State> states;
+    std::vector<std::pair<JobInternalHandle*, JobInternalHandle*>> queues; // Gate and completion of captured queues.
+    void (*runJob)(const JobInstance&) = nullptr;
+};
+
+JobSystem& GetJobSystem()
+{
+    static JobSystem system;
+    return system;
+}
+
+void AddRef(JobInternalHandle* aHandle)
+{
+    InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(1));
+}
+
+void Release(JobInternalHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(-1)) != 1)
+    {
+        return;
+    }
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto waits = std::move(system.states[aHandle].waits);
+    system.states.erase(aHandle);
+    delete aHandle;
+
+    for (auto wait : waits)
+    {
+        Release(wait);
+    }
+}
+
+bool IsCompleted(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    const auto& state = system.states[aHandle];
+    if (state.kind != JobSystem::Kind::Gate)
+    {
+        return state.completed;
+    }
+
+    return std::all_of(state.waits.begin(), state.waits.end(), &IsCompleted);
+}
+
+void Complete(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[aHandle].completed = true;
+}
+
+// Runs the jobs of every queue that is ready, returns the number of queues that completed.
+uint32_t Pump()
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    uint32_t completed = 0;
+    for (auto it = system.queues.begin(); it != system.queues.end();)
+    {
+        auto [gate, queue] = *it;
+        if (!IsCompleted(gate))
+        {
+            ++it;
+            continue;
+        }
+
+        auto jobs = std::move(system.states[queue].jobs);
+        for (const auto& job : jobs)
+        {
+            system.runJob(job);
+        }
+
+        system.states[queue].completed = true;
+        system.queues.erase(it);
+
+        Release(gate);
+        Release(queue);
+        ++completed;
+
+        // A completed queue can unblock queues before it.
+        it = system.queues.begin();
+    }
+
+    return completed;
+}
+
+// Releases the queues that never became ready.
+void DropQueues()
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto queues = std::move(system.queues);
+    for (auto [gate, queue] : queues)
+    {
+        Release(gate);
+        Release(queue);
+    }
+}
+
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[handle];
+
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    Release(aHandle->internal);
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle& aOther)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    AddRef(aOther.internal);
+    system.states[aHandle->internal].waits.push_back(aOther.internal);
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    // The handles were acquired by the members' constructors.
+    system.states[aQueue->unk10.internal].kind = JobSystem::Kind::Gate;
+    system.states[aQueue->unk18.internal].kind = JobSystem::Kind::Queue;
+    aQueue->captured = false;
+
+    return aQueue;
+}
+
+void DestructJobQueue(JobQueue*)
+{
+    // The members' destructors release the handles.
+}
+
+JobHandle* CaptureJobQueue(JobQueue* aQueue, JobHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    Release(aHandle->internal);
+    aHandle->internal = aQueue->unk18.internal;
+    AddRef(aHandle->internal);
+
+    AddRef(aQueue->unk10.internal);
+    AddRef(aQueue->unk18.internal);
+    system.queues.emplace_back(aQueue->unk10.internal, aQueue->unk18.internal);
+    aQueue->captured = true;
+
+    return aHandle;
+}
+
+uint32_t DispatchJob(void*, const JobInstance& aJob, uint8_t, JobInternalHandle*, JobInternalHandle* aQueue)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    system.states[aQueue].jobs.push_back(aJob);
+    return 0;
+}
+
+void SyncWaitJobQueue(JobQueue*)
+{
+}
+
+// The game's handler also sets a job parameter in the game's thread local storage, which does not exist here. Run the
+// closure directly and release it like the handler does.
+template<typename L>
+bool RunClosure(const JobInstance& aJob)
+{
+    using Closure = JobClosure<L>;
+
+    if (aJob.handler != reinterpret_cast<JobInstance::HandleFunc<void>>(&Closure::HandleTarget))
+    {
+        return false;
+    }
+
+    auto closure = static_cast<L*>(aJob.target);
+    (*closure)();
+    Memory::Delete<typename Closure::AllocatorType>(closure);
+
+    return true;
+}
+
+// A group dispatches two kinds of jobs, the count down of the loads and the callback.
+void RunGroupJob(const JobInstance& aJob)
+{
+    RED4EXT_REQUIRE(RunClosure<Detail::DeferredDataBufferCountDown>(aJob) ||
+                    RunClosure<DeferredDataBufferGroup::LoadedCallback>(aJob));
+}
+
+void* g_jobDispatcher = nullptr;
+
+// Stands in for the game's buffer loader. A load marks the buffer as loading and hands out a job handle that the test
+// completes through Finish().
+struct BufferLoader
+{
+    std::vector<std::pair<DeferredDataBuffer*, JobHandle>> loading;
+    uint32_t requests = 0;
+};
+
+BufferLoader& GetBufferLoader()
+{
+    static BufferLoader loader;
+    return loader;
+}
+
+JobHandle* LoadBufferAsync(DeferredDataBuffer* aBuffer, JobHandle* aJob, int64_t)
+{
+    std::atomic_ref<DeferredDataBufferState>(aBuffer->state).store(DeferredDataBufferState::Loading);
+
+    auto& loader = GetBufferLoader();
+    loader.loading.emplace_back(aBuffer, *aJob);
+    loader.requests++;
+
+    return aJob;
+}
+
+void Finish(DeferredDataBuffer& aBuffer)
+{
+    auto& loading = GetBufferLoader().loading;
+    auto it = std::find_if(loading.begin(), loading.end(),
+                           [&aBuffer](const auto& aLoad) { return aLoad.first == &aBuffer; });
+    if (it == loading.end())
+    {
+        return;
+    }
+
+    std::atomic_ref<DeferredDataBufferState>(aBuffer.state).store(DeferredDataBufferState::Loaded);
+    Complete(it->second.internal);
+
+    loading.erase(it);
+}
+
+void DecWeakRef(SharedPtrBase<void>* aPtr)
+{
+    if (InterlockedExchangeAdd(&aPtr->refCount->weakRefs, static_cast<uint32_t>(-1)) == 1)
+    {
+        Memory::Delete(aPtr->refCount);
+    }
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveLoader(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_Capture:
+        return reinterpret_cast<uintptr_t>(&CaptureJobQueue);
+    case JobQueue_SyncWait:
+        return reinterpret_cast<uintptr_t>(&SyncWaitJobQueue);
+    case JobDispatcher_DispatchJob:
+        return reinterpret_cast<uintptr_t>(&DispatchJob);
+    case JobDispatcher:
+        return reinterpret_cast<uintptr_t>(&g_jobDispatcher);
+    case DeferredDataBuffer_LoadAsync:
+        return reinterpret_cast<uintptr_t>(&LoadBufferAsync);
+    case Handle_DecWeakRef:
+        return reinterpret_cast<uintptr_t>(&DecWeakRef);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// Installs the stand-ins once, every test starts without loads in flight.
+struct FakeLoader
+{
+    FakeLoader()
+    {
+        [[maybe_unused]] static const auto isInstalled = []
+        {
+            g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveLoader);
+            return true;
+        }();
+
+        GetJobSystem().runJob = &RunGroupJob;
+        GetBufferLoader().requests = 0;
+    }
+
+    ~FakeLoader()
+    {
+        GetBufferLoader().loading.clear();
+        DropQueues();
+    }
+};
+
+struct CountCalls
+{
+    void operator()() const
+    {
+        ++*calls;
+    }
+
+    uint32_t* calls;
+};
+} // namespace
+
+RED4EXT_TEST(DeferredDataBufferGroup_CountsLoadsDownOnce)
+{
+    FakeLoader fake;
+
+    DeferredDataBuffer buffers[4]{};
+    buffers[2].state = DeferredDataBufferState::Loaded;
+
+    uint32_t calls = 0;
+    DeferredDataBufferGroup group;
+    RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer>(buffers, 4), CountCalls{&calls}));
+
+    // The loaded buffer is skipped.
+    RED4EXT_CHECK(GetBufferLoader().requests == 3);
+    RED4EXT_CHECK(group.GetPendingCount() == 3);
+    RED4EXT_CHECK(!group.IsReady());
+
+    Pump();
+    RED4EXT_CHECK(group.GetPendingCount() == 3);
+
+    // The loads finish in any order, they are counted down together after the last one.
+    Finish(buffers[3]);
+    Pump();
+    RED4EXT_CHECK(group.GetPendingCount() == 3);
+
+    Finish(buffers[0]);
+    Pump();
+    RED4EXT_CHECK(group.GetPendingCount() == 3);
+    RED4EXT_CHECK(!group.IsReady());
+    RED4EXT_CHECK(calls == 0);
+    RED4EXT_CHECK(!IsCompleted(group.GetJob().internal));
+
+    // One queue waits for all loads.
+    RED4EXT_CHECK(Pump() == 0);
+
+    Finish(buffers[1]);
+    RED4EXT_CHECK(Pump() == 1);
+    RED4EXT_CHECK(group.GetPendingCount() == 0);
+    RED4EXT_CHECK(group.IsReady());
+    RED4EXT_CHECK(calls == 1);
+    RED4EXT_CHECK(IsCompleted(group.GetJob().internal));
+
+    Pump();
+    RED4EXT_CHECK(calls == 1);
+}
+
+RED4EXT_TEST(DeferredDataBufferGroup_CallsRightAwayWhenNothingToLoad)
+{
+    FakeLoader fake;
+
+    DeferredDataBuffer buffers[2]{};
+    buffers[0].state = DeferredDataBufferState::Loaded;
+    buffers[1].state = DeferredDataBufferState::Loaded;
+
+    uint32_t calls = 0;
+    DeferredDataBufferGroup group;
+    RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer>(buffers, 2), CountCalls{&calls}));
+    RED4EXT_CHECK(calls == 1);
+    RED4EXT_CHECK(group.IsReady());
+    RED4EXT_CHECK(group.GetPendingCount() == 0);
+
+    RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer>(buffers, size_t{0}), CountCalls{&calls}));
+    RED4EXT_CHECK(calls == 2);
+    RED4EXT_CHECK(GetBufferLoader().requests == 0);
+    RED4EXT_CHECK(Pump() == 0);
+}
+
+RED4EXT_TEST(DeferredDataBufferGroup_SkipsNullPointers)
+{
+    FakeLoader fake;
+
+    DeferredDataBuffer first{};
+    DeferredDataBuffer second{};
+    DeferredDataBuffer* pointers[] = {&first, nullptr, &second, nullptr};
+
+    DeferredDataBufferGroup group;
+    RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer*>(pointers, 4)));
+    RED4EXT_CHECK(GetBufferLoader().requests == 2);
+    RED4EXT_CHECK(group.GetPendingCount() == 2);
+
+    Finish(first);
+    Finish(second);
+    Pump();
+    RED4EXT_CHECK(group.IsReady());
+}
+
+RED4EXT_TEST(DeferredDataBufferGroup_LoadsAgainWhenReady)
+{
+    FakeLoader fake;
+
+    DeferredDataBuffer buffers[3]{};
+
+    uint32_t calls = 0;
+    DeferredDataBufferGroup group;
+    RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer>(buffers, 2), CountCalls{&calls}));
+    RED4EXT_CHECK(!group.Load(Span<DeferredDataBuffer>(buffers + 2, 1), CountCalls{&calls}));
+
+    Finish(buffers[0]);
+    Finish(buffers[1]);
+    Pump();
+    RED4EXT_CHECK(calls == 1);
+
+    // The counter is reused, it only counts the loads of the new call.
+    RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer>(buffers, 3), CountCalls{&calls}));
+    RED4EXT_CHECK(group.GetPendingCount() == 1);
+
+    Finish(buffers[2]);
+    Pump();
+    RED4EXT_CHECK(group.IsReady());
+    RED4EXT_CHECK(calls == 2);
+}
+
+RED4EXT_TEST(DeferredDataBufferGroup_PollsFromAnotherThread)
+{
+    FakeLoader fake;
+
+    constexpr uint32_t BufferCount = 16;
+    constexpr uint32_t Rounds = 200;
+
+    std::vector<DeferredDataBuffer> buffers(BufferCount);
+    DeferredDataBufferGroup group;
+
+    // Polls while the group is loaded again and again. While Load() runs the count includes one for the call itself.
+    std::atomic<bool> isLoading = true;
+    std::atomic<uint32_t> overflows = 0;
+    std::thread poller(
+        [&]
+        {
+            while (isLoading.load())
+            {
+                if (!group.IsReady() && group.GetPendingCount() > BufferCount + 1)
+                {
+                    overflows.fetch_add(1);
+                }
+            }
+        });
+
+    for (uint32_t round = 0; round < Rounds; ++round)
+    {
+        for (auto& buffer : buffers)
+        {
+            std::atomic_ref<DeferredDataBufferState>(buffer.state).store(DeferredDataBufferState::Unloaded);
+        }
+
+        RED4EXT_REQUIRE(group.Load(Span<DeferredDataBuffer>(buffers.data(), buffers.size())));
+
+        // The count goes down once the last load has finished.
+        for (uint32_t i = 0; i < BufferCount; ++i)
+        {
+            RED4EXT_REQUIRE(group.GetPendingCount() == BufferCount);
+
+            Finish(buffers[i]);
+            Pump();
+        }
+
+        RED4EXT_REQUIRE(group.IsReady());
+    }
+
+    isLoading = false;
+    poller.join();
+
+    RED4EXT_CHECK(overflows.load() == 0);
+}
@@ -0,0 +1,201 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/EventBus.hpp>
+#include <RED4ext/HookProfiler.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+struct DamageEvent
+{
+    int32_t amount;
+};
+
+using DamageBus = EventBus<DamageEvent>;
+
+uint64_t FindCalls(const char* aName)
+{
+    for (const auto& stats : HookProfiler::Snapshot())
+    {
+        if (std::string(stats.name) == aName)
+        {
+            return stats.calls;
+        }
+    }
+
+    return 0;
+}
+
+// A subscriber that appends its letter and the event's amount to the calls.
+auto Record(std::vector<std::string>& aCalls, const char* aLetter)
+{
+    return [&aCalls, aLetter](const DamageEvent& aEvent) { aCalls.push_back(aLetter + std::to_string(aEvent.amount)); };
+}
+} // namespace
+
+RED4EXT_TEST(EventBus_Publish)
+{
+    DamageBus bus;
+    std::vector<std::string> calls;
+
+    auto first = bus.Subscribe(Record(calls, "a"));
+    auto second = bus.Subscribe(Record(calls, "b"));
+
+    RED4EXT_CHECK(first != DamageBus::InvalidSubscription);
+    RED4EXT_CHECK(first != second);
+    RED4EXT_CHECK(bus.GetSubscriberCount() == 2);
+
+    // Subscribers are called in the order they subscribed.
+    bus.Publish({1});
+    RED4EXT_CHECK((calls == std::vector<std::string>{"a1", "b1"}));
+
+    RED4EXT_CHECK(bus.Unsubscribe(first));
+    RED4EXT_CHECK(!bus.Unsubscribe(first));
+    RED4EXT_CHECK(!bus.Unsubscribe(DamageBus::InvalidSubscription));
+    RED4EXT_CHECK(bus.GetSubscriberCount() == 1);
+
+    calls.clear();
+    bus.Publish({2});
+    RED4EXT_CHECK((calls == std::vector<std::string>{"b2"}));
+}
+
+RED4EXT_TEST(EventBus_PublishBatch)
+{
+    DamageBus bus;
+    std::vector<std::string> calls;
+
+    bus.Subscribe(Record(calls, "a"));
+    bus.Subscribe(Record(calls, "b"));
+
+    // Every subscriber gets the whole batch before the next one is called.
+    DamageEvent events[] = {{1}, {2}, {3}};
+    bus.PublishBatch({events, 3});
+    RED4EXT_CHECK((calls == std::vector<std::string>{"a1", "a2", "a3", "b1", "b2", "b3"}));
+
+    calls.clear();
+    bus.PublishBatch({events, events});
+    RED4EXT_CHECK(calls.empty());
+}
+
+RED4EXT_TEST(EventBus_SubscribeDuringPublish)
+{
+    DamageBus bus;
+
+    uint32_t added = 0;
+    uint32_t selfCalls = 0;
+    DamageBus::SubscriptionId self = DamageBus::InvalidSubscription;
+
+    // The subscriber removes itself and adds another one, the publish in progress does not see either change.
+    self = bus.Subscribe(
+        [&](const DamageEvent&)
+        {
+            ++selfCalls;
+            if (bus.Unsubscribe(self))
+            {
+                bus.Subscribe([&added](const DamageEvent&) { ++added; });
+            }
+        });
+
+    DamageEvent events[] = {{1}, {2}};
+    bus.PublishBatch({events, 2});
+
+    RED4EXT_CHECK(selfCalls == 2);
+    RED4EXT_CHECK(added == 0);
+    RED4EXT_CHECK(bus.GetSubscriberCount() == 1);
+
+    bus.Publish({3});
+    RED4EXT_CHECK(selfCalls == 2);
+    RED4EXT_CHECK(added == 1);
+}
+
+RED4EXT_TEST(EventBus_Profiling)
+{
+    DamageBus bus;
+    RED4EXT_CHECK(!bus.IsProfiling());
+
+    int64_t total = 0;
+    bus.Subscribe([&total](const DamageEvent& aEvent) { total += aEvent.amount; }, "EventBusTests/Total");
+
+    // Not profiled yet.
+    bus.Publish({1});
+    RED4EXT_CHECK(FindCalls("EventBusTests/Total") == 0);
+
+    bus.SetProfiling(true);
+    RED4EXT_CHECK(bus.IsProfiling());
+
+    // A batch is measured as one call.
+    DamageEvent events[] = {{2}, {3}, {4}};
+    bus.Publish({1});
+    bus.PublishBatch({events, 3});
+    RED4EXT_CHECK(FindCalls("EventBusTests/Total") == 2);
+
+    // Subscribers added while profiling get a profile too.
+    bus.Subscribe([](const DamageEvent&) {}, "EventBusTests/Late");
+    bus.Publish({0});
+    RED4EXT_CHECK(FindCalls("EventBusTests/Total") == 3);
+    RED4EXT_CHECK(FindCalls("EventBusTests/Late") == 1);
+
+    // The profiles are destroyed with the last table that uses them.
+    bus.SetProfiling(false);
+    bus.Publish({0});
+    RED4EXT_CHECK(FindCalls("EventBusTests/Total") == 0);
+    RED4EXT_CHECK(total == 11);
+}
+
+RED4EXT_TEST(EventBus_Threads)
+{
+    DamageBus bus;
+
+    std::atomic<uint64_t> total = 0;
+    bus.Subscribe([&total](const DamageEvent& aEvent) { total.fetch_add(aEvent.amount, std::memory_order_relaxed); });
+
+    constexpr uint32_t Publishers = 4;
+    constexpr uint32_t Publishes = 2000;
+
+    std::atomic<bool> isDone = false;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < Publishers; ++i)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                DamageEvent events[] = {{1}, {1}};
+                for (uint32_t j = 0; j < Publishes; ++j)
+                {
+                    bus.Publish({1});
+                    bus.PublishBatch({events, 2});
+                }
+            });
+    }
+
+    // The tables are replaced while the publishers use them, the sanitizers catch a table released too early.
+    std::atomic<uint64_t> churn = 0;
+    std::thread writer(
+        [&]
+        {
+            while (!isDone.load())
+            {
+                auto id = bus.Subscribe([&churn](const DamageEvent&)
+                                        { churn.fetch_add(1, std::memory_order_relaxed); });
+                bus.Unsubscribe(id);
+            }
+        });
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    isDone = true;
+    writer.join();
+
+    RED4EXT_CHECK(total == Publishers * Publishes * 3);
+    RED4EXT_CHECK(bus.GetSubscriberCount() == 1);
+}
@@ -0,0 +1,232 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/GameEngine.hpp>
+#include <RED4ext/GameSystemCache.hpp>
+
+#include "Test.hpp"
+
+// The game defines the destructor, the mock below needs one to link.
+RED4ext::GameInstance::~GameInstance()
+{
+}
+
+namespace
+{
+using namespace RED4ext;
+
+// Types and systems are only compared by address, they are never dereferenced.
+struct FakeObjects
+{
+    alignas(16) uint8_t types[8][64];
+    alignas(16) uint8_t systems[8][64];
+
+    CBaseRTTIType* Type(uint32_t aIndex)
+    {
+        return reinterpret_cast<CBaseRTTIType*>(types[aIndex]);
+    }
+
+    IScriptable* System(uint32_t aIndex)
+    {
+        return reinterpret_cast<IScriptable*>(systems[aIndex]);
+    }
+};
+
+struct MockGameInstance : GameInstance
+{
+    MockGameInstance()
+    {
+        // The game creates the maps with an allocator.
+        systemMap = decltype(systemMap)(Memory::DefaultAllocator::Get());
+        systemImplementations = decltype(systemImplementations)(Memory::DefaultAllocator::Get());
+    }
+
+    // Resolves the system the way the game does, through the implementation map and the system map.
+    IScriptable* GetSystem(const CBaseRTTIType* aType) override
+    {
+        lookups.fetch_add(1, std::memory_order_relaxed);
+
+        auto type = const_cast<CBaseRTTIType*>(aType);
+        if (auto implementation = systemImplementations.Get(type))
+        {
+            type = *implementation;
+        }
+
+        auto system = systemMap.Get(type);
+        return system ? system->GetPtr() : nullptr;
+    }
+
+    void Unk_10() override {}
+    void Unk_18() override {}
+    void Unk_20() override {}
+    void Unk_28() override {}
+    void Unk_30() override {}
+    void Unk_38() override {}
+    void Unk_40() override {}
+    void Unk_48() override {}
+    void Unk_50() override {}
+    void Unk_58() override {}
+    void Unk_60() override {}
+    void Unk_68() override {}
+
+    void AddSystem(CBaseRTTIType* aType, IScriptable* aSystem)
+    {
+        // The handles do not own the fake systems, there is no reference count to release.
+        Handle<IScriptable> handle;
+        handle.instance = aSystem;
+
+        systemMap.InsertOrAssign(aType, handle);
+    }
+
+    std::atomic<uint32_t> lookups = 0;
+};
+
+FakeObjects g_objects;
+} // namespace
+
+RED4EXT_TEST(GameSystemCache_CachesHits)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance instance;
+    instance.AddSystem(g_objects.Type(0), g_objects.System(0));
+
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+    RED4EXT_CHECK(instance.lookups == 1);
+}
+
+RED4EXT_TEST(GameSystemCache_ResolvesInterfaces)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance instance;
+    instance.AddSystem(g_objects.Type(1), g_objects.System(1));
+    instance.systemImplementations.Insert(g_objects.Type(2), g_objects.Type(1));
+
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(2)) == g_objects.System(1));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(2)) == g_objects.System(1));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(1)) == g_objects.System(1));
+    RED4EXT_CHECK(instance.lookups == 2);
+}
+
+RED4EXT_TEST(GameSystemCache_DoesNotCacheMisses)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance instance;
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == nullptr);
+
+    instance.AddSystem(g_objects.Type(0), g_objects.System(0));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+
+    RED4EXT_CHECK(GameSystemCache::Get(nullptr, g_objects.Type(0)) == nullptr);
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, nullptr) == nullptr);
+}
+
+RED4EXT_TEST(GameSystemCache_RebuiltInstances)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance instance;
+    instance.AddSystem(g_objects.Type(0), g_objects.System(0));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+
+    // A rebuilt instance at the same address with a new system, hits do not ask the instance again until the cache is
+    // invalidated.
+    instance.systemMap.Clear();
+    instance.AddSystem(g_objects.Type(0), g_objects.System(3));
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+    RED4EXT_CHECK(instance.lookups == 1);
+
+    GameSystemCache::Invalidate();
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(3));
+
+    // A torn down instance without the system.
+    instance.systemMap.Clear();
+    GameSystemCache::Invalidate();
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == nullptr);
+}
+
+RED4EXT_TEST(GameSystemCache_SeparatesInstances)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance first;
+    first.AddSystem(g_objects.Type(0), g_objects.System(0));
+
+    MockGameInstance second;
+    second.AddSystem(g_objects.Type(0), g_objects.System(1));
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        RED4EXT_CHECK(GameSystemCache::Get(&first, g_objects.Type(0)) == g_objects.System(0));
+        RED4EXT_CHECK(GameSystemCache::Get(&second, g_objects.Type(0)) == g_objects.System(1));
+    }
+}
+
+RED4EXT_TEST(GameSystemCache_Invalidate)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance instance;
+    instance.AddSystem(g_objects.Type(0), g_objects.System(0));
+
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+    GameSystemCache::Invalidate();
+    RED4EXT_CHECK(GameSystemCache::Get(&instance, g_objects.Type(0)) == g_objects.System(0));
+    RED4EXT_CHECK(instance.lookups == 2);
+}
+
+RED4EXT_TEST(GameSystemCache_ConcurrentLookups)
+{
+    GameSystemCache::Invalidate();
+
+    MockGameInstance instance;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        instance.AddSystem(g_objects.Type(i), g_objects.System(i));
+    }
+
+    std::atomic<uint32_t> mismatches = 0;
+    std::atomic<bool> isDone = false;
+
+    std::vector<std::thread> readers;
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                for (uint32_t i = 0; i < 100000; ++i)
+                {
+                    auto index = i % 8;
+                    if (GameSystemCache::Get(&instance, g_objects.Type(index)) != g_objects.System(index))
+                    {
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    std::thread invalidator(
+        [&]
+        {
+            while (!isDone.load(std::memory_order_relaxed))
+            {
+                GameSystemCache::Invalidate();
+                std::this_thread::yield();
+            }
+        });
+
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    isDone = true;
+    invalidator.join();
+
+    RED4EXT_CHECK(mismatches == 0);
+}
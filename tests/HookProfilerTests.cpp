@@ -0,0 +1,261 @@
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/HookProfiler.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+int32_t Square(int32_t aValue)
+{
+    return aValue * aValue;
+}
+
+using SquareHook = ProfiledHook<decltype(Square), &Square>;
+
+// Stands in for the loader's hooking, it remembers the last detour instead of patching the target.
+void* g_detour = nullptr;
+
+bool Attach(PluginHandle, void*, void* aDetour, void** aOriginal)
+{
+    g_detour = aDetour;
+    if (aOriginal)
+    {
+        *aOriginal = nullptr;
+    }
+
+    return true;
+}
+
+bool Detach(PluginHandle, void*)
+{
+    g_detour = nullptr;
+    return true;
+}
+
+const HookStats* Find(const std::vector<HookStats>& aStats, const char* aName)
+{
+    for (const auto& stats : aStats)
+    {
+        if (stats.name && std::string(stats.name) == aName)
+        {
+            return &stats;
+        }
+    }
+
+    return nullptr;
+}
+} // namespace
+
+RED4EXT_TEST(HookProfiler_CycleCounter)
+{
+    auto first = Detail::ReadCycleCounter();
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2))
+    {
+    }
+
+    auto second = Detail::ReadCycleCounter();
+    RED4EXT_CHECK(second > first);
+
+#if (defined(_MSC_VER) && defined(_M_X64)) || defined(__x86_64__)
+    RED4EXT_CHECK(Detail::GetCycleCounterFrequency() == 0);
+#else
+    // Every counter the SDK reads ticks at least at 1 MHz, 2 ms are at least 2000 ticks.
+    RED4EXT_CHECK(Detail::GetCycleCounterFrequency() >= 1000000);
+    RED4EXT_CHECK(second - first >= 2000);
+#endif
+}
+
+RED4EXT_TEST(HookProfiler_LatencyBuckets)
+{
+    uint32_t mismatches = 0;
+    uint32_t previous = 0;
+
+    for (uint64_t value : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 100ull, 1000ull, 123456789ull, (1ull << 39) + 5})
+    {
+        auto bucket = Detail::GetLatencyBucket(value);
+
+        // The limit of a value's bucket is an upper bound of the value, the buckets grow with the value.
+        mismatches += Detail::GetLatencyBucketLimit(bucket) < value;
+        mismatches += bucket < previous;
+        previous = bucket;
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+
+    for (uint32_t bucket = 0; bucket + 1 < Detail::LatencyBucketCount; ++bucket)
+    {
+        // Each bucket starts right after the limit of the one in front of it.
+        mismatches += Detail::GetLatencyBucket(Detail::GetLatencyBucketLimit(bucket)) != bucket;
+        mismatches += Detail::GetLatencyBucket(Detail::GetLatencyBucketLimit(bucket) + 1) != bucket + 1;
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+    RED4EXT_CHECK(Detail::GetLatencyBucket(UINT64_MAX) == Detail::LatencyBucketCount - 1);
+}
+
+RED4EXT_TEST(HookProfiler_Record)
+{
+    HookProfile profile("record");
+
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        profile.Record(i * 10);
+    }
+
+    auto stats = profile.Snapshot();
+    RED4EXT_CHECK(std::string(stats.name) == "record");
+    RED4EXT_CHECK(stats.calls == 100);
+    RED4EXT_CHECK(stats.cycles == 50500);
+    RED4EXT_CHECK(stats.maxCycles == 1000);
+    RED4EXT_CHECK(stats.GetAverage() == 505);
+
+    // The percentiles are upper bounds within a quarter of a power of two.
+    auto p50 = stats.GetPercentile(0.5);
+    auto p99 = stats.GetPercentile(0.99);
+    RED4EXT_CHECK(p50 >= 500 && p50 < 500 * 5 / 4);
+    RED4EXT_CHECK(p99 >= 990 && p99 <= 1000);
+    RED4EXT_CHECK(stats.GetPercentile(1.0) == 1000);
+
+    HookStats empty;
+    RED4EXT_CHECK(empty.GetPercentile(0.5) == 0);
+    RED4EXT_CHECK(empty.GetAverage() == 0);
+}
+
+RED4EXT_TEST(HookProfiler_Reset)
+{
+    HookProfile profile("reset");
+    profile.Record(10);
+    profile.Record(20);
+
+    profile.Reset();
+
+    auto stats = profile.Snapshot();
+    RED4EXT_CHECK(stats.calls == 0);
+    RED4EXT_CHECK(stats.cycles == 0);
+
+    // The thread clears its counters on its next call.
+    profile.Record(5);
+
+    stats = profile.Snapshot();
+    RED4EXT_CHECK(stats.calls == 1);
+    RED4EXT_CHECK(stats.cycles == 5);
+    RED4EXT_CHECK(stats.maxCycles == 5);
+}
+
+RED4EXT_TEST(HookProfiler_Threads)
+{
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t Count = 10000;
+
+    HookProfile profile("threads");
+
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < ThreadCount; ++thread)
+    {
+        threads.emplace_back(
+            [&profile]
+            {
+                for (uint32_t i = 0; i < Count; ++i)
+                {
+                    HookProfile::Scope _(profile);
+                }
+            });
+    }
+
+    // Snapshots while the threads record must not disturb them.
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        RED4EXT_CHECK(profile.Snapshot().calls <= ThreadCount * Count);
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto stats = profile.Snapshot();
+    RED4EXT_CHECK(stats.calls == ThreadCount * Count);
+    RED4EXT_CHECK(stats.untrackedCalls == 0);
+
+    uint64_t histogram = 0;
+    for (auto bucket : stats.histogram)
+    {
+        histogram += bucket;
+    }
+
+    RED4EXT_CHECK(histogram == stats.calls);
+}
+
+RED4EXT_TEST(HookProfiler_UntrackedThreads)
+{
+    // Thread indices are not reused, the threads after the first MaxThreads ones are counted without a slot.
+    constexpr uint32_t ThreadCount = HookProfile::MaxThreads + 20;
+
+    HookProfile profile("untracked");
+    for (uint32_t i = 0; i < ThreadCount; ++i)
+    {
+        std::thread([&profile] { profile.Record(1); }).join();
+    }
+
+    auto stats = profile.Snapshot();
+    RED4EXT_CHECK(stats.untrackedCalls >= 20);
+    RED4EXT_CHECK(stats.calls + stats.untrackedCalls == ThreadCount);
+}
+
+RED4EXT_TEST(HookProfiler_ProfiledHook)
+{
+    v0::Hooking hooking{};
+    hooking.Attach = &Attach;
+    hooking.Detach = &Detach;
+
+    int32_t target = 0;
+    RED4EXT_REQUIRE(SquareHook::Attach(&hooking, PluginHandle{}, &target, nullptr, "Square"));
+    RED4EXT_REQUIRE(g_detour == reinterpret_cast<void*>(&SquareHook::Call));
+
+    auto detour = reinterpret_cast<int32_t (*)(int32_t)>(g_detour);
+    int32_t sum = 0;
+    for (int32_t i = 0; i < 10; ++i)
+    {
+        sum += detour(i);
+    }
+
+    RED4EXT_CHECK(sum == 285);
+
+    auto all = HookProfiler::Snapshot();
+    auto stats = Find(all, "Square");
+    RED4EXT_REQUIRE(stats != nullptr);
+    RED4EXT_CHECK(stats->calls == 10);
+
+    std::ostringstream out;
+    HookProfiler::Dump(out);
+
+    auto dump = out.str();
+    RED4EXT_CHECK(dump.starts_with("durations in "));
+    RED4EXT_CHECK(dump.find("total ticks") != std::string::npos);
+    RED4EXT_CHECK(dump.find("\nSquare ") != std::string::npos);
+
+    HookProfiler::Reset();
+    RED4EXT_CHECK(SquareHook::GetProfile().Snapshot().calls == 0);
+
+    RED4EXT_CHECK(SquareHook::Detach(&hooking, PluginHandle{}, &target));
+    RED4EXT_CHECK(g_detour == nullptr);
+}
+
+RED4EXT_TEST(HookProfiler_Unregister)
+{
+    {
+        HookProfile profile("temporary");
+        RED4EXT_CHECK(Find(HookProfiler::Snapshot(), "temporary") != nullptr);
+    }
+
+    RED4EXT_CHECK(Find(HookProfiler::Snapshot(), "temporary") == nullptr);
+}
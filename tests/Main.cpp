@@ -0,0 +1,64 @@
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#include <RED4ext/Memory/NativeBackend.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+std::atomic<uint32_t> g_failures = 0;
+} // namespace
+
+std::vector<RED4ext::Tests::TestInfo>& RED4ext::Tests::GetTests()
+{
+    static std::vector<TestInfo> tests;
+    return tests;
+}
+
+void RED4ext::Tests::ReportFailure(const char* aFile, int32_t aLine, const char* aExpression)
+{
+    std::fprintf(stderr, "%s(%d): check failed: %s\n", aFile, aLine, aExpression);
+    g_failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+int main(int aArgc, char** aArgv)
+{
+    // Tests run outside of the game, containers and allocators go through the emulated memory.
+    RED4ext::Memory::NativeBackend::Install();
+
+    // An optional argument selects the tests whose name contains it.
+    auto filter = aArgc > 1 ? aArgv[1] : nullptr;
+
+    uint32_t failedTests = 0;
+    uint32_t count = 0;
+
+    for (const auto& test : RED4ext::Tests::GetTests())
+    {
+        if (filter && !std::strstr(test.name, filter))
+        {
+            continue;
+        }
+
+        std::printf("[ RUN      ] %s\n", test.name);
+        std::fflush(stdout);
+
+        auto failures = g_failures.load();
+        test.func();
+        ++count;
+
+        if (g_failures.load() != failures)
+        {
+            ++failedTests;
+            std::printf("[  FAILED  ] %s\n", test.name);
+        }
+        else
+        {
+            std::printf("[       OK ] %s\n", test.name);
+        }
+    }
+
+    std::printf("%u tests, %u failed\n", count, failedTests);
+    return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/CString.hpp>
+#include <RED4ext/DynArray.hpp>
+#include <RED4ext/HashMap.hpp>
+#include <RED4ext/Memory/NativeBackend.hpp>
+#include <RED4ext/Memory/Vault.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+using namespace RED4ext::Memory;
+
+// Every test uses a pool of its own, the byte counts of one test are not changed by another.
+template<typename T>
+uint64_t GetBytes()
+{
+    return T::Get()->storage->bytesAllocated;
+}
+
+struct Entity
+{
+    uint64_t id;
+    float position[3];
+};
+} // namespace
+
+RED4EXT_TEST(NativeBackend_Install)
+{
+    // Main() installed the backend already.
+    RED4EXT_CHECK(NativeBackend::IsInstalled());
+    RED4EXT_CHECK(NativeBackend::GetMode() == NativeBackend::Mode::SizeClasses);
+    RED4EXT_CHECK(!NativeBackend::Install(NativeBackend::Mode::System));
+    RED4EXT_CHECK(NativeBackend::GetMode() == NativeBackend::Mode::SizeClasses);
+
+    RED4EXT_CHECK(NativeBackend::Resolve(0) == 0);
+    RED4EXT_CHECK(Vault::Get() != nullptr);
+}
+
+RED4EXT_TEST(NativeBackend_Pools)
+{
+    auto allocator = Allocator<PoolScriptCompiler>::Get();
+
+    auto pool = PoolScriptCompiler::Get();
+    RED4EXT_REQUIRE(pool != nullptr);
+    RED4EXT_REQUIRE(pool->storage != nullptr);
+    RED4EXT_CHECK(std::strcmp(pool->name, PoolScriptCompiler::Name) == 0);
+    RED4EXT_CHECK(Vault::Get()->poolRegistry.Get(PoolScriptCompiler::Name) == pool);
+    RED4EXT_CHECK(NativeBackend::AddPool(PoolScriptCompiler::Name) == pool);
+
+    // Every pool is a child of the root.
+    auto root = PoolRoot::Get();
+    RED4EXT_REQUIRE(root != nullptr);
+
+    bool isChild = false;
+    for (auto child = root->child; child; child = child->sibling)
+    {
+        isChild |= child == pool;
+    }
+
+    RED4EXT_CHECK(isChild);
+
+    // The storage counts the requested bytes and their peak.
+    auto before = GetBytes<PoolScriptCompiler>();
+
+    auto first = allocator->Alloc(100);
+    auto second = allocator->AllocAligned(1000, 64);
+    RED4EXT_REQUIRE(first.memory && second.memory);
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(second.memory) % 64 == 0);
+    RED4EXT_CHECK(NativeBackend::GetSize(first.memory) == 100);
+    RED4EXT_CHECK(GetBytes<PoolScriptCompiler>() == before + 1100);
+
+    allocator->Free(second);
+    RED4EXT_CHECK(GetBytes<PoolScriptCompiler>() == before + 100);
+    RED4EXT_CHECK(pool->storage->maxBytesAllocated >= before + 1100);
+
+    allocator->Free(first);
+    RED4EXT_CHECK(GetBytes<PoolScriptCompiler>() == before);
+}
+
+RED4EXT_TEST(NativeBackend_Realloc)
+{
+    auto allocator = Allocator<PoolScript>::Get();
+    auto before = GetBytes<PoolScript>();
+
+    auto allocation = allocator->Alloc(20);
+    std::memset(allocation.memory, 1, 20);
+
+    // Growing within the block's size class keeps the memory in place.
+    auto grown = allocator->Realloc(allocation, 24);
+    RED4EXT_CHECK(grown.memory == allocation.memory);
+    RED4EXT_CHECK(NativeBackend::GetSize(grown.memory) == 24);
+
+    // A larger class and the C runtime's blocks move it.
+    std::vector<uint64_t> sizes = {200, 5000, 100000, 200000, 64};
+    for (auto size : sizes)
+    {
+        grown = allocator->Realloc(grown, size);
+        RED4EXT_REQUIRE(grown.memory != nullptr);
+        RED4EXT_CHECK(NativeBackend::GetSize(grown.memory) == size);
+        RED4EXT_CHECK(static_cast<uint8_t*>(grown.memory)[19] == 1);
+        RED4EXT_CHECK(GetBytes<PoolScript>() == before + size);
+    }
+
+    auto aligned = allocator->ReallocAligned(grown, 300, 128);
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(aligned.memory) % 128 == 0);
+    RED4EXT_CHECK(static_cast<uint8_t*>(aligned.memory)[19] == 1);
+
+    auto freed = allocator->Realloc(aligned, 0);
+    RED4EXT_CHECK(freed.memory == nullptr);
+    RED4EXT_CHECK(GetBytes<PoolScript>() == before);
+}
+
+RED4EXT_TEST(NativeBackend_DynArray)
+{
+    auto allocator = Allocator<PoolCPU>::Get();
+    auto before = GetBytes<PoolCPU>();
+
+    {
+        DynArray<Entity> array(allocator);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            array.PushBack({i, {1.0f, 2.0f, static_cast<float>(i)}});
+        }
+
+        RED4EXT_CHECK(array.size == 1000);
+        RED4EXT_CHECK(array[999].id == 999);
+        RED4EXT_CHECK(array[999].position[2] == 999.0f);
+        RED4EXT_CHECK(GetBytes<PoolCPU>() > before);
+
+        // The allocator is kept after the entries, copies use it too.
+        auto copy = array;
+        RED4EXT_CHECK(copy.GetAllocator()->GetHandle() == allocator->GetHandle());
+        RED4EXT_CHECK(copy[500].id == 500);
+
+        auto moved = std::move(copy);
+        RED4EXT_CHECK(copy.size == 0);
+        RED4EXT_CHECK(moved.size == 1000);
+
+        array.RemoveAt(0);
+        array.ShrinkToSize();
+        RED4EXT_CHECK(array.capacity == 999);
+        RED4EXT_CHECK(array[0].id == 1);
+
+        array.Clear();
+        array.ShrinkToSize();
+        RED4EXT_CHECK(array.capacity == 0);
+        RED4EXT_CHECK(array.GetAllocator()->GetHandle() == allocator->GetHandle());
+    }
+
+    RED4EXT_CHECK(GetBytes<PoolCPU>() == before);
+
+    // Without an allocator the default pool is used.
+    DynArray<uint32_t> array;
+    array.PushBack(1);
+    RED4EXT_CHECK(array[0] == 1);
+}
+
+RED4EXT_TEST(NativeBackend_HashMap)
+{
+    auto allocator = Allocator<PoolEngine>::Get();
+    auto before = GetBytes<PoolEngine>();
+
+    {
+        HashMap<uint64_t, uint32_t> map(allocator);
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            map.Insert(i * 31, i);
+        }
+
+        RED4EXT_CHECK(map.size == 10000);
+        RED4EXT_CHECK(GetBytes<PoolEngine>() > before);
+
+        auto value = map.Get(31 * 1234);
+        RED4EXT_REQUIRE(value != nullptr);
+        RED4EXT_CHECK(*value == 1234);
+
+        RED4EXT_CHECK(map.Remove(31 * 1234));
+        RED4EXT_CHECK(map.Get(31 * 1234) == nullptr);
+
+        auto copy = map;
+        RED4EXT_CHECK(copy.size == 9999);
+        RED4EXT_CHECK(*copy.Get(31) == 1);
+    }
+
+    RED4EXT_CHECK(GetBytes<PoolEngine>() == before);
+
+    // Without an allocator none is stored like in the game, the default pool is used when memory is needed.
+    HashMap<uint64_t, uint32_t> map;
+    RED4EXT_CHECK(map.allocator == 0);
+
+    map.Insert(1, 2);
+    RED4EXT_CHECK(*map.Get(1) == 2);
+    RED4EXT_CHECK(map.GetAllocator()->GetHandle() == DefaultAllocator::Get()->GetHandle());
+
+    auto copy = map;
+    RED4EXT_CHECK(copy.allocator == 0);
+    RED4EXT_CHECK(*copy.Get(1) == 2);
+}
+
+RED4EXT_TEST(NativeBackend_CString)
+{
+    auto allocator = Allocator<PoolGI>::Get();
+    auto before = GetBytes<PoolGI>();
+
+    const std::string longText(100, 'x');
+
+    {
+        CString small("short", allocator);
+        RED4EXT_CHECK(small.IsInline());
+        RED4EXT_CHECK(small == "short");
+        RED4EXT_CHECK(GetBytes<PoolGI>() == before);
+
+        CString large(longText, allocator);
+        RED4EXT_CHECK(!large.IsInline());
+        RED4EXT_CHECK(large.Length() == 100);
+        RED4EXT_CHECK(std::string(large.c_str()) == longText);
+        RED4EXT_CHECK(GetBytes<PoolGI>() == before + 101);
+
+        auto copy = large;
+        RED4EXT_CHECK(copy == large);
+        RED4EXT_CHECK(copy.c_str() != large.c_str());
+
+        // Shrinking back to the inline buffer releases the memory.
+        copy = small;
+        RED4EXT_CHECK(copy.IsInline());
+        RED4EXT_CHECK(copy == "short");
+        RED4EXT_CHECK(GetBytes<PoolGI>() == before + 101);
+
+        auto moved = std::move(large);
+        RED4EXT_CHECK(moved.Length() == 100);
+    }
+
+    RED4EXT_CHECK(GetBytes<PoolGI>() == before);
+}
+
+RED4EXT_TEST(NativeBackend_Threads)
+{
+    auto allocator = Allocator<PoolDebug>::Get();
+    auto before = GetBytes<PoolDebug>();
+
+    constexpr uint32_t Count = 2000;
+
+    // Blocks allocated on one thread are freed on another and reused by a third.
+    std::vector<void*> blocks(Count);
+    std::thread producer(
+        [&]
+        {
+            for (uint32_t i = 0; i < Count; ++i)
+            {
+                blocks[i] = allocator->Alloc(16 + i % 512).memory;
+                std::memset(blocks[i], 1, 16);
+            }
+        });
+    producer.join();
+
+    std::thread consumer(
+        [&]
+        {
+            for (auto block : blocks)
+            {
+                allocator->Free(block);
+            }
+        });
+    consumer.join();
+
+    RED4EXT_CHECK(GetBytes<PoolDebug>() == before);
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [allocator]
+            {
+                std::vector<void*> own;
+                for (uint32_t j = 0; j < Count; ++j)
+                {
+                    own.push_back(allocator->Alloc(16 + j % 512).memory);
+                }
+
+                for (auto block : own)
+                {
+                    allocator->Free(block);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    RED4EXT_CHECK(GetBytes<PoolDebug>() == before);
+}
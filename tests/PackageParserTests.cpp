@@ -0,0 +1,499 @@
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <RED4ext/PackageParser.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Writes packages in the layout described in PackageParser.hpp.
+struct PackageBuilder
+{
+    struct Field
+    {
+        uint16_t name;
+        uint16_t type;
+        std::vector<uint8_t> value;
+    };
+
+    struct Chunk
+    {
+        uint32_t type;
+        std::vector<Field> fields;
+    };
+
+    uint16_t AddName(const std::string& aName)
+    {
+        names.push_back(aName);
+        return static_cast<uint16_t>(names.size() - 1);
+    }
+
+    template<typename T>
+    static std::vector<uint8_t> MakeValue(const T& aValue)
+    {
+        std::vector<uint8_t> value(sizeof(T));
+        std::memcpy(value.data(), &aValue, sizeof(T));
+        return value;
+    }
+
+    std::vector<uint8_t> Build() const
+    {
+        std::vector<uint8_t> data;
+
+        auto append = [&data](const void* aData, size_t aSize)
+        {
+            auto bytes = static_cast<const uint8_t*>(aData);
+            data.insert(data.end(), bytes, bytes + aSize);
+        };
+
+        auto offset = [&data]()
+        {
+            return static_cast<uint32_t>(data.size());
+        };
+
+        // The descriptors point to the strings, which follow all descriptors of the section.
+        auto appendStrings = [&](const std::vector<std::string>& aStrings, auto aMakeDescriptor)
+        {
+            auto descriptorOffset = offset();
+            auto stringOffset = descriptorOffset + static_cast<uint32_t>(aStrings.size() * sizeof(uint32_t));
+
+            for (const auto& str : aStrings)
+            {
+                auto descriptor = aMakeDescriptor(stringOffset, static_cast<uint32_t>(str.size() + 1));
+                append(&descriptor, sizeof(descriptor));
+                stringOffset += static_cast<uint32_t>(str.size() + 1);
+            }
+
+            auto dataOffset = offset();
+            for (const auto& str : aStrings)
+            {
+                append(str.c_str(), str.size() + 1);
+            }
+
+            return std::make_pair(descriptorOffset, dataOffset);
+        };
+
+        std::vector<std::string> importPaths;
+        for (const auto& import : imports)
+        {
+            importPaths.push_back(import.first);
+        }
+
+        uint32_t importIndex = 0;
+        auto [importDescOffset, importDataOffset] = appendStrings(importPaths,
+                                                                  [&](uint32_t aOffset, uint32_t aSize)
+                                                                  {
+                                                                      PackageHeader::Import import{};
+                                                                      import.offset = aOffset;
+                                                                      import.size = aSize;
+                                                                      import.sync = imports[importIndex++].second;
+                                                                      return import;
+                                                                  });
+
+        auto [nameDescOffset, nameDataOffset] = appendStrings(names,
+                                                              [](uint32_t aOffset, uint32_t aSize)
+                                                              {
+                                                                  PackageHeader::Name name{};
+                                                                  name.offset = aOffset;
+                                                                  name.size = aSize;
+                                                                  return name;
+                                                              });
+
+        // The chunk descriptors are written once the offsets of the chunks are known.
+        auto chunkDescOffset = offset();
+        data.resize(data.size() + chunks.size() * sizeof(PackageHeader::Chunk));
+
+        auto chunkDataOffset = offset();
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            const auto& chunk = chunks[i];
+
+            PackageHeader::Chunk descriptor{chunk.type, offset()};
+            std::memcpy(data.data() + chunkDescOffset + i * sizeof(descriptor), &descriptor, sizeof(descriptor));
+
+            auto fieldCount = static_cast<uint16_t>(chunk.fields.size());
+            append(&fieldCount, sizeof(fieldCount));
+
+            auto valueOffset = static_cast<uint32_t>(sizeof(uint16_t) + chunk.fields.size() * 8);
+            for (const auto& field : chunk.fields)
+            {
+                append(&field.name, sizeof(field.name));
+                append(&field.type, sizeof(field.type));
+                append(&valueOffset, sizeof(valueOffset));
+                valueOffset += static_cast<uint32_t>(field.value.size());
+            }
+
+            for (const auto& field : chunk.fields)
+            {
+                append(field.value.data(), field.value.size());
+            }
+        }
+
+        auto hasImports = !imports.empty();
+
+        std::vector<uint8_t> package;
+        package.push_back(version);
+        package.push_back(0);
+
+        auto sectionCount = static_cast<uint16_t>(hasImports ? 7 : 6);
+        package.insert(package.end(), reinterpret_cast<uint8_t*>(&sectionCount),
+                       reinterpret_cast<uint8_t*>(&sectionCount) + sizeof(sectionCount));
+        package.insert(package.end(), reinterpret_cast<const uint8_t*>(&rootChunkCount),
+                       reinterpret_cast<const uint8_t*>(&rootChunkCount) + sizeof(rootChunkCount));
+
+        std::vector<uint32_t> offsets;
+        if (hasImports)
+        {
+            offsets.push_back(importDescOffset);
+            offsets.push_back(importDataOffset);
+        }
+
+        offsets.insert(offsets.end(), {nameDescOffset, nameDataOffset, chunkDescOffset, chunkDataOffset});
+        package.insert(package.end(), reinterpret_cast<uint8_t*>(offsets.data()),
+                       reinterpret_cast<uint8_t*>(offsets.data() + offsets.size()));
+
+        package.insert(package.end(), data.begin(), data.end());
+        return package;
+    }
+
+    uint8_t version = PackageParser::SupportedVersion;
+    uint32_t rootChunkCount = 0;
+    std::vector<std::string> names;
+    std::vector<std::pair<std::string, bool>> imports;
+    std::vector<Chunk> chunks;
+};
+
+// A package like the ones the game writes for entities, a few chunks with fields of different sizes.
+PackageBuilder MakeEntityPackage(uint32_t aChunkCount = 3)
+{
+    PackageBuilder builder;
+
+    auto entity = builder.AddName("entEntity");
+    auto component = builder.AddName("entMeshComponent");
+    auto name = builder.AddName("name");
+    auto cname = builder.AddName("CName");
+    auto visible = builder.AddName("isVisible");
+    auto boolean = builder.AddName("Bool");
+    auto scale = builder.AddName("scale");
+    auto vector = builder.AddName("Vector3");
+
+    builder.imports.push_back({"base\\characters\\head\\h0_000_pwa.mesh", true});
+    builder.imports.push_back({"base\\characters\\body\\t0_000_pwa.mesh", false});
+
+    for (uint32_t i = 0; i < aChunkCount; ++i)
+    {
+        PackageBuilder::Chunk chunk{i == 0 ? entity : component, {}};
+        chunk.fields.push_back({name, cname, PackageBuilder::MakeValue(static_cast<uint64_t>(i) + 1)});
+        chunk.fields.push_back({visible, boolean, PackageBuilder::MakeValue(static_cast<uint8_t>(i % 2))});
+
+        float value[3] = {1.0f, 2.0f, static_cast<float>(i)};
+        chunk.fields.push_back({scale, vector, PackageBuilder::MakeValue(value)});
+
+        builder.chunks.push_back(chunk);
+    }
+
+    builder.rootChunkCount = 1;
+    return builder;
+}
+
+struct RecordingVisitor : PackageParser::Visitor
+{
+    bool OnChunk(uint32_t aIndex, StringView aTypeName, const uint8_t*, uint32_t) override
+    {
+        chunkTypes.push_back(std::string(aTypeName.Data(), aTypeName.Length()));
+        return aIndex != skippedChunk;
+    }
+
+    void OnField(uint32_t, uint32_t, const PackageParser::Field& aField) override
+    {
+        fields.push_back(aField);
+    }
+
+    bool OnChunkEnd(uint32_t aIndex) override
+    {
+        return aIndex != abortChunk;
+    }
+
+    std::vector<std::string> chunkTypes;
+    std::vector<PackageParser::Field> fields;
+    uint32_t skippedChunk = UINT32_MAX;
+    uint32_t abortChunk = UINT32_MAX;
+};
+
+// Checks that everything handed to the visitor lies within the parsed buffer.
+struct BoundsVisitor : PackageParser::Visitor
+{
+    BoundsVisitor(const std::vector<uint8_t>& aBuffer)
+        : begin(aBuffer.data())
+        , end(aBuffer.data() + aBuffer.size())
+    {
+    }
+
+    bool IsInBuffer(const void* aData, size_t aSize) const
+    {
+        auto data = static_cast<const uint8_t*>(aData);
+        return aSize == 0 || (data >= begin && data <= end && aSize <= static_cast<size_t>(end - data));
+    }
+
+    bool OnChunk(uint32_t, StringView aTypeName, const uint8_t* aData, uint32_t aSize) override
+    {
+        isInBounds = isInBounds && IsInBuffer(aTypeName.Data(), aTypeName.Length()) && IsInBuffer(aData, aSize);
+        return true;
+    }
+
+    void OnField(uint32_t, uint32_t, const PackageParser::Field& aField) override
+    {
+        isInBounds = isInBounds && IsInBuffer(aField.name.Data(), aField.name.Length()) &&
+                     IsInBuffer(aField.typeName.Data(), aField.typeName.Length()) &&
+                     IsInBuffer(aField.data, aField.size);
+    }
+
+    const uint8_t* begin;
+    const uint8_t* end;
+    bool isInBounds = true;
+};
+
+// Parses and visits the whole package, returns false if anything outside of the buffer was handed out.
+bool ParseAndVisit(const std::vector<uint8_t>& aBuffer)
+{
+    PackageParser parser(aBuffer.data(), static_cast<uint32_t>(aBuffer.size()));
+
+    PackageHeader header{};
+    if (parser.ParseHeader(header) != PackageParseError::None)
+    {
+        return true;
+    }
+
+    BoundsVisitor visitor(aBuffer);
+    parser.Visit(visitor);
+
+    for (uint32_t i = 0; i < header.names.GetSize(); ++i)
+    {
+        auto name = parser.GetName(i);
+        visitor.isInBounds = visitor.isInBounds && visitor.IsInBuffer(name.Data(), name.Length());
+    }
+
+    for (uint32_t i = 0; i < header.imports.GetSize(); ++i)
+    {
+        auto path = parser.GetImportPath(i);
+        visitor.isInBounds = visitor.isInBounds && visitor.IsInBuffer(path.Data(), path.Length());
+    }
+
+    return visitor.isInBounds;
+}
+} // namespace
+
+RED4EXT_TEST(PackageParser_ParsesPackage)
+{
+    auto buffer = MakeEntityPackage().Build();
+    PackageParser parser(buffer.data(), static_cast<uint32_t>(buffer.size()));
+
+    PackageHeader header{};
+    RED4EXT_REQUIRE(parser.ParseHeader(header) == PackageParseError::None);
+
+    RED4EXT_CHECK(header.version == PackageParser::SupportedVersion);
+    RED4EXT_CHECK(header.names.GetSize() == 8);
+    RED4EXT_CHECK(header.imports.GetSize() == 2);
+    RED4EXT_CHECK(header.chunks.GetSize() == 3);
+    RED4EXT_CHECK(header.root.GetSize() == 1);
+    RED4EXT_CHECK(parser.GetChunkCount() == 3);
+    RED4EXT_CHECK(parser.GetRootChunkCount() == 1);
+
+    RED4EXT_CHECK(parser.GetName(1) == "entMeshComponent");
+    RED4EXT_CHECK(parser.GetName(8).Length() == 0);
+    RED4EXT_CHECK(parser.GetImportPath(0) == "base\\characters\\head\\h0_000_pwa.mesh");
+    RED4EXT_CHECK(parser.IsImportSync(0));
+    RED4EXT_CHECK(!parser.IsImportSync(1));
+    RED4EXT_CHECK(!parser.IsImportSync(2));
+
+    RecordingVisitor visitor;
+    RED4EXT_REQUIRE(parser.Visit(visitor) == PackageParseError::None);
+
+    std::vector<std::string> chunkTypes = {"entEntity", "entMeshComponent", "entMeshComponent"};
+    RED4EXT_CHECK(visitor.chunkTypes == chunkTypes);
+    RED4EXT_REQUIRE(visitor.fields.size() == 9);
+
+    const auto& name = visitor.fields[3];
+    RED4EXT_CHECK(name.name == "name");
+    RED4EXT_CHECK(name.typeName == "CName");
+    RED4EXT_REQUIRE(name.size == sizeof(uint64_t));
+
+    uint64_t value;
+    std::memcpy(&value, name.data, sizeof(value));
+    RED4EXT_CHECK(value == 2);
+
+    RED4EXT_CHECK(visitor.fields[4].size == 1);
+    RED4EXT_CHECK(visitor.fields[5].size == 3 * sizeof(float));
+}
+
+RED4EXT_TEST(PackageParser_UnalignedBuffer)
+{
+    // The descriptors end up at odd addresses, the header spans must still be usable in place.
+    auto package = MakeEntityPackage().Build();
+    std::vector<uint8_t> buffer(package.size() + 1);
+    std::memcpy(buffer.data() + 1, package.data(), package.size());
+
+    PackageParser parser(buffer.data() + 1, static_cast<uint32_t>(package.size()));
+
+    PackageHeader header{};
+    RED4EXT_REQUIRE(parser.ParseHeader(header) == PackageParseError::None);
+    RED4EXT_REQUIRE(header.chunks.GetSize() == 3);
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(header.chunks.begin()) % alignof(PackageHeader::Chunk) == 0);
+    RED4EXT_CHECK(header.chunks[1].typeID == 1);
+    RED4EXT_CHECK(header.root.begin() == header.chunks.begin());
+    RED4EXT_CHECK(header.imports[0].sync == 1);
+
+    RecordingVisitor visitor;
+    RED4EXT_CHECK(parser.Visit(visitor) == PackageParseError::None);
+    RED4EXT_CHECK(visitor.fields.size() == 9);
+}
+
+RED4EXT_TEST(PackageParser_WithoutImports)
+{
+    auto builder = MakeEntityPackage();
+    builder.imports.clear();
+
+    auto buffer = builder.Build();
+    PackageParser parser(buffer.data(), static_cast<uint32_t>(buffer.size()));
+
+    PackageHeader header{};
+    RED4EXT_REQUIRE(parser.ParseHeader(header) == PackageParseError::None);
+    RED4EXT_CHECK(header.unk02 == 6);
+    RED4EXT_CHECK(header.imports.GetSize() == 0);
+    RED4EXT_CHECK(parser.GetImportPath(0).Length() == 0);
+
+    RecordingVisitor visitor;
+    RED4EXT_CHECK(parser.Visit(visitor) == PackageParseError::None);
+    RED4EXT_CHECK(visitor.fields.size() == 9);
+}
+
+RED4EXT_TEST(PackageParser_RejectsInvalidPackages)
+{
+    PackageHeader header{};
+
+    RED4EXT_CHECK(PackageParser(nullptr, 100).ParseHeader(header) == PackageParseError::InvalidBuffer);
+
+    auto builder = MakeEntityPackage();
+    builder.version = 3;
+    auto buffer = builder.Build();
+    RED4EXT_CHECK(PackageParser(buffer.data(), static_cast<uint32_t>(buffer.size())).ParseHeader(header) ==
+                  PackageParseError::UnsupportedVersion);
+
+    buffer = MakeEntityPackage().Build();
+    buffer[2] = 5;
+    RED4EXT_CHECK(PackageParser(buffer.data(), static_cast<uint32_t>(buffer.size())).ParseHeader(header) ==
+                  PackageParseError::InvalidSection);
+
+    builder = MakeEntityPackage();
+    builder.rootChunkCount = 4;
+    buffer = builder.Build();
+    RED4EXT_CHECK(PackageParser(buffer.data(), static_cast<uint32_t>(buffer.size())).ParseHeader(header) ==
+                  PackageParseError::InvalidChunk);
+
+    builder = MakeEntityPackage();
+    builder.chunks[1].type = 100;
+    buffer = builder.Build();
+    RED4EXT_CHECK(PackageParser(buffer.data(), static_cast<uint32_t>(buffer.size())).ParseHeader(header) ==
+                  PackageParseError::InvalidChunk);
+
+    // The field table is only validated when the chunk is visited.
+    builder = MakeEntityPackage();
+    builder.chunks[2].fields[1].name = 100;
+    buffer = builder.Build();
+
+    PackageParser parser(buffer.data(), static_cast<uint32_t>(buffer.size()));
+    RecordingVisitor visitor;
+    RED4EXT_CHECK(parser.Visit(visitor) == PackageParseError::InvalidBuffer);
+    RED4EXT_REQUIRE(parser.ParseHeader(header) == PackageParseError::None);
+    RED4EXT_CHECK(parser.VisitChunk(visitor, 1) == PackageParseError::None);
+    RED4EXT_CHECK(parser.VisitChunk(visitor, 2) == PackageParseError::InvalidField);
+    RED4EXT_CHECK(parser.VisitChunk(visitor, 3) == PackageParseError::InvalidChunk);
+}
+
+RED4EXT_TEST(PackageParser_VisitorControlsTraversal)
+{
+    auto buffer = MakeEntityPackage().Build();
+    PackageParser parser(buffer.data(), static_cast<uint32_t>(buffer.size()));
+
+    PackageHeader header{};
+    RED4EXT_REQUIRE(parser.ParseHeader(header) == PackageParseError::None);
+
+    RecordingVisitor skipping;
+    skipping.skippedChunk = 1;
+    RED4EXT_CHECK(parser.Visit(skipping) == PackageParseError::None);
+    RED4EXT_CHECK(skipping.chunkTypes.size() == 3);
+    RED4EXT_CHECK(skipping.fields.size() == 6);
+
+    RecordingVisitor aborting;
+    aborting.abortChunk = 1;
+    RED4EXT_CHECK(parser.Visit(aborting) == PackageParseError::Aborted);
+    RED4EXT_CHECK(aborting.chunkTypes.size() == 2);
+}
+
+RED4EXT_TEST(PackageParser_VisitParallel)
+{
+    auto buffer = MakeEntityPackage(1000).Build();
+    PackageParser parser(buffer.data(), static_cast<uint32_t>(buffer.size()));
+
+    PackageHeader header{};
+    RED4EXT_REQUIRE(parser.ParseHeader(header) == PackageParseError::None);
+
+    struct CountingVisitor : PackageParser::Visitor
+    {
+        void OnField(uint32_t aChunkIndex, uint32_t, const PackageParser::Field&) override
+        {
+            fields.fetch_add(1, std::memory_order_relaxed);
+            chunkSum.fetch_add(aChunkIndex, std::memory_order_relaxed);
+        }
+
+        std::atomic<uint32_t> fields = 0;
+        std::atomic<uint64_t> chunkSum = 0;
+    };
+
+    CountingVisitor visitor;
+    RED4EXT_CHECK(parser.VisitParallel(visitor, 4) == PackageParseError::None);
+    RED4EXT_CHECK(visitor.fields == 3000);
+    RED4EXT_CHECK(visitor.chunkSum == 3ull * (999 * 1000 / 2));
+}
+
+// Every truncation and single byte corruption of the corpus must be rejected or parsed within the buffer.
+RED4EXT_TEST(PackageParser_Corpus)
+{
+    std::vector<std::vector<uint8_t>> corpus;
+    corpus.push_back(MakeEntityPackage().Build());
+    corpus.push_back(MakeEntityPackage(1).Build());
+
+    auto withoutImports = MakeEntityPackage(2);
+    withoutImports.imports.clear();
+    corpus.push_back(withoutImports.Build());
+
+    for (const auto& package : corpus)
+    {
+        RED4EXT_CHECK(ParseAndVisit(package));
+
+        for (size_t size = 0; size < package.size(); ++size)
+        {
+            // Copy the truncated package so that reads past its end are caught by the sanitizers.
+            std::vector<uint8_t> truncated(package.begin(), package.begin() + static_cast<std::ptrdiff_t>(size));
+            RED4EXT_CHECK(ParseAndVisit(truncated));
+        }
+
+        auto corrupted = package;
+        for (size_t i = 0; i < package.size(); ++i)
+        {
+            for (uint8_t value : {uint8_t{0x00}, uint8_t{0x7F}, uint8_t{0xFF}, static_cast<uint8_t>(package[i] ^ 1)})
+            {
+                corrupted[i] = value;
+                RED4EXT_CHECK(ParseAndVisit(corrupted));
+            }
+
+            corrupted[i] = package[i];
+        }
+    }
+}
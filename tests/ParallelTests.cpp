@@ -0,0 +1,609 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Parallel.hpp>
+#include <RED4ext/Relocation.hpp>
+#include <RED4ext/ThreadPool.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's job system. Handles are reference counted through unk1C like in the game. A handle
+// completes once it is marked as completed and every handle joined to it completed, the start of a queue (its gate)
+// only waits for the joined handles. The jobs of a submitted queue run once its gate completed, RunQueue() may be
+// called from several threads. The newest queue that is ready runs first, so that the caller's queue of a loop runs
+// before the chunks unless it waits for them.
+struct JobSystem
+{
+    enum class Kind
+    {
+        Gate,
+        Queue
+    };
+
+    struct State
+    {
+        Kind kind = Kind::Queue;
+        bool completed = false;
+        std::vector<JobInternalHandle*> waits;
+        std::vector<JobInstance> jobs;
+    };
+
+    std::recursive_mutex lock;
+    std::unordered_map<JobInternalHandle*, State> states;
+    std::vector<std::pair<JobInternalHandle*, JobInternalHandle*>> queues; // Gate and completion of submitted queues.
+    void (*runJob)(const JobInstance&) = nullptr;
+    uint32_t dispatchedJobs = 0;
+};
+
+JobSystem& GetJobSystem()
+{
+    static JobSystem system;
+    return system;
+}
+
+void AddRef(JobInternalHandle* aHandle)
+{
+    InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(1));
+}
+
+void Release(JobInternalHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(-1)) != 1)
+    {
+        return;
+    }
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto waits = std::move(system.states[aHandle].waits);
+    system.states.erase(aHandle);
+    delete aHandle;
+
+    for (auto wait : waits)
+    {
+        Release(wait);
+    }
+}
+
+bool IsCompleted(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    const auto& state = system.states[aHandle];
+    if (state.kind != JobSystem::Kind::Gate && !state.completed)
+    {
+        return false;
+    }
+
+    return std::all_of(state.waits.begin(), state.waits.end(), &IsCompleted);
+}
+
+bool RunQueue()
+{
+    auto& system = GetJobSystem();
+
+    JobInternalHandle* gate;
+    JobInternalHandle* queue;
+    std::vector<JobInstance> jobs;
+    {
+        std::lock_guard<std::recursive_mutex> _(system.lock);
+
+        auto it = std::find_if(system.queues.rbegin(), system.queues.rend(),
+                               [](const auto& aQueue) { return IsCompleted(aQueue.first); });
+        if (it == system.queues.rend())
+        {
+            return false;
+        }
+
+        gate = it->first;
+        queue = it->second;
+        jobs = std::move(system.states[queue].jobs);
+        system.queues.erase(std::next(it).base());
+    }
+
+    for (const auto& job : jobs)
+    {
+        system.runJob(job);
+    }
+
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[queue].completed = true;
+    Release(gate);
+    Release(queue);
+
+    return true;
+}
+
+// Runs the queues on the calling thread and the given number of other threads until none is left.
+void Pump(uint32_t aThreadCount = 0)
+{
+    auto work = []
+    {
+        while (true)
+        {
+            if (RunQueue())
+            {
+                continue;
+            }
+
+            auto& system = GetJobSystem();
+            std::lock_guard<std::recursive_mutex> _(system.lock);
+            if (system.queues.empty())
+            {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < aThreadCount; ++i)
+    {
+        threads.emplace_back(work);
+    }
+
+    work();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[handle];
+
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    Release(aHandle->internal);
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle& aOther)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    AddRef(aOther.internal);
+    system.states[aHandle->internal].waits.push_back(aOther.internal);
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    // The handles were acquired by the members' constructors.
+    system.states[aQueue->unk10.internal].kind = JobSystem::Kind::Gate;
+    aQueue->captured = false;
+
+    return aQueue;
+}
+
+void Submit(JobQueue* aQueue)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    AddRef(aQueue->unk10.internal);
+    AddRef(aQueue->unk18.internal);
+    system.queues.emplace_back(aQueue->unk10.internal, aQueue->unk18.internal);
+}
+
+void DestructJobQueue(JobQueue* aQueue)
+{
+    // A queue that was not captured is submitted when it goes out of scope.
+    if (!aQueue->captured)
+    {
+        Submit(aQueue);
+    }
+}
+
+JobHandle* CaptureJobQueue(JobQueue* aQueue, JobHandle* aHandle)
+{
+    Release(aHandle->internal);
+    aHandle->internal = aQueue->unk18.internal;
+    AddRef(aHandle->internal);
+
+    Submit(aQueue);
+    aQueue->captured = true;
+
+    return aHandle;
+}
+
+uint32_t DispatchJob(void*, const JobInstance& aJob, uint8_t, JobInternalHandle*, JobInternalHandle* aQueue)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    system.states[aQueue].jobs.push_back(aJob);
+    ++system.dispatchedJobs;
+    return 0;
+}
+
+void SyncWaitJobQueue(JobQueue*)
+{
+}
+
+// The game's handler also sets a job parameter in the game's thread local storage, which does not exist here. Run the
+// closure directly and release it like the handler does.
+template<typename L>
+bool RunClosure(const JobInstance& aJob)
+{
+    using Closure = JobClosure<L>;
+
+    if (aJob.handler != reinterpret_cast<JobInstance::HandleFunc<void>>(&Closure::HandleTarget))
+    {
+        return false;
+    }
+
+    auto closure = static_cast<L*>(aJob.target);
+    (*closure)();
+    Memory::Delete<typename Closure::AllocatorType>(closure);
+
+    return true;
+}
+
+void* g_jobDispatcher = nullptr;
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveScheduler(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_Capture:
+        return reinterpret_cast<uintptr_t>(&CaptureJobQueue);
+    case JobQueue_SyncWait:
+        return reinterpret_cast<uintptr_t>(&SyncWaitJobQueue);
+    case JobDispatcher_DispatchJob:
+        return reinterpret_cast<uintptr_t>(&DispatchJob);
+    case JobDispatcher:
+        return reinterpret_cast<uintptr_t>(&g_jobDispatcher);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+// Installs the stand-ins once, every test runs its jobs before it ends.
+struct FakeScheduler
+{
+    explicit FakeScheduler(void (*aRunJob)(const JobInstance&))
+    {
+        [[maybe_unused]] static const auto isInstalled = []
+        {
+            g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveScheduler);
+            return true;
+        }();
+
+        auto& system = GetJobSystem();
+        system.runJob = aRunJob;
+        system.dispatchedJobs = 0;
+    }
+
+    ~FakeScheduler()
+    {
+        Pump();
+    }
+};
+
+// The loops of the JobQueue tests, the stand-in runs their jobs by type.
+struct Square
+{
+    void operator()(int32_t aIndex) const
+    {
+        (*values)[aIndex] = aIndex * aIndex;
+    }
+
+    std::vector<int64_t>* values;
+};
+
+struct Identity
+{
+    int64_t operator()(int32_t aIndex) const
+    {
+        return aIndex;
+    }
+};
+
+struct Concat
+{
+    std::string operator()(std::string aLhs, const std::string& aRhs) const
+    {
+        return aLhs + aRhs;
+    }
+};
+
+struct Letter
+{
+    std::string operator()(int32_t aIndex) const
+    {
+        return std::string(1, static_cast<char>('a' + aIndex));
+    }
+};
+
+struct Plus
+{
+    int64_t operator()(int64_t aLhs, int64_t aRhs) const
+    {
+        return aLhs + aRhs;
+    }
+};
+
+template<typename T>
+struct Store
+{
+    void operator()(T aValue) const
+    {
+        *result = std::move(aValue);
+    }
+
+    T* result;
+};
+
+// Records how many values of a loop were written when the job ran.
+struct CountWritten
+{
+    void operator()() const
+    {
+        counts->push_back(std::count_if(values->begin(), values->end(), [](int64_t aValue) { return aValue >= 0; }));
+    }
+
+    const std::vector<int64_t>* values;
+    std::vector<int64_t>* counts;
+};
+
+// Waits until the given number of chunks started, it gives up after a while and counts that.
+struct WaitForOthers
+{
+    void operator()(int32_t) const
+    {
+        started->fetch_add(1);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (started->load() < expected)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                timeouts->fetch_add(1);
+                return;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    std::atomic<uint32_t>* started;
+    std::atomic<uint32_t>* timeouts;
+    uint32_t expected;
+};
+
+using SquareState = Detail::ParallelForState<int32_t, Square>;
+using WaitState = Detail::ParallelForState<int32_t, WaitForOthers>;
+using SumState = Detail::ParallelReduceState<int32_t, int64_t, Identity, Plus>;
+using ConcatState = Detail::ParallelReduceState<int32_t, std::string, Letter, Concat>;
+
+void RunJob(const JobInstance& aJob)
+{
+    using SumDone = Detail::ParallelDoneJob<SumState, Store<int64_t>>;
+    using ConcatDone = Detail::ParallelDoneJob<ConcatState, Store<std::string>>;
+
+    RED4EXT_REQUIRE(RunClosure<Detail::ParallelChunkJob<SquareState>>(aJob) ||
+                    RunClosure<Detail::ParallelChunkJob<WaitState>>(aJob) ||
+                    RunClosure<Detail::ParallelChunkJob<SumState>>(aJob) ||
+                    RunClosure<Detail::ParallelChunkJob<ConcatState>>(aJob) || RunClosure<SumDone>(aJob) ||
+                    RunClosure<ConcatDone>(aJob) || RunClosure<CountWritten>(aJob));
+}
+} // namespace
+
+RED4EXT_TEST(Parallel_Chunks)
+{
+    Detail::ParallelChunks<int32_t> chunks(0, 10, 3);
+    RED4EXT_CHECK(chunks.count == 4);
+    RED4EXT_CHECK(chunks.GetBegin(3) == 9);
+    RED4EXT_CHECK(chunks.GetEnd(3) == 10);
+
+    RED4EXT_CHECK(Detail::ParallelChunks<int32_t>(5, 5, 3).count == 0);
+    RED4EXT_CHECK(Detail::ParallelChunks<int32_t>(5, 1, 3).count == 0);
+    RED4EXT_CHECK(Detail::ParallelChunks<int32_t>(0, 10, 0).count == 10);
+
+    // The size of the whole range does not fit into the signed type.
+    Detail::ParallelChunks<int8_t> wide(-128, 127, 64);
+    RED4EXT_CHECK(wide.count == 4);
+    RED4EXT_CHECK(wide.GetBegin(2) == 0);
+    RED4EXT_CHECK(wide.GetEnd(3) == 127);
+}
+
+RED4EXT_TEST(Parallel_ThreadPoolFor)
+{
+    ThreadPool pool(4);
+    RED4EXT_CHECK(pool.GetThreadCount() == 4);
+
+    for (int32_t size : {0, 1, 255, 256, 1000, 100000})
+    {
+        std::vector<std::atomic<uint32_t>> visits(static_cast<size_t>(size));
+        ParallelFor(pool, 0, size, 256, [&visits](int32_t aIndex) { visits[aIndex].fetch_add(1); });
+
+        RED4EXT_CHECK(std::all_of(visits.begin(), visits.end(), [](const auto& aVisits) { return aVisits == 1; }));
+    }
+
+    // Negative and unsigned ranges.
+    std::atomic<int64_t> sum = 0;
+    ParallelFor(pool, -500, 500, 7, [&sum](int32_t aIndex) { sum += aIndex; });
+    RED4EXT_CHECK(sum == -500);
+
+    std::atomic<uint64_t> count = 0;
+    ParallelFor(pool, size_t{10}, size_t{1010}, size_t{100}, [&count](size_t) { ++count; });
+    RED4EXT_CHECK(count == 1000);
+}
+
+RED4EXT_TEST(Parallel_ThreadPoolReduce)
+{
+    ThreadPool pool(3);
+
+    auto sum = ParallelReduce(
+        pool, 0, 1000001, 1000, int64_t{0}, [](int32_t aIndex) { return int64_t{aIndex}; },
+        [](int64_t aLhs, int64_t aRhs) { return aLhs + aRhs; });
+    RED4EXT_CHECK(sum == int64_t{1000000} * 1000001 / 2);
+
+    // The chunks are combined in order, a reduction that is not commutative gives the serial result.
+    auto text = ParallelReduce(
+        pool, 0, 26, 3, std::string(), [](int32_t aIndex) { return std::string(1, static_cast<char>('a' + aIndex)); },
+        [](std::string aLhs, const std::string& aRhs) { return aLhs + aRhs; });
+    RED4EXT_CHECK(text == "abcdefghijklmnopqrstuvwxyz");
+
+    auto empty = ParallelReduce(
+        pool, 0, 0, 10, int32_t{42}, [](int32_t) { return 1; }, [](int32_t aLhs, int32_t aRhs) { return aLhs + aRhs; });
+    RED4EXT_CHECK(empty == 42);
+}
+
+RED4EXT_TEST(Parallel_ThreadPoolNested)
+{
+    ThreadPool pool(2);
+
+    // A loop started from a chunk of another loop must not wait for workers that are busy with the outer loop.
+    std::atomic<uint32_t> count = 0;
+    ParallelFor(pool, 0, 16, 1,
+                [&](int32_t)
+                { ParallelFor(pool, 0, 64, 8, [&count](int32_t) { count.fetch_add(1, std::memory_order_relaxed); }); });
+
+    RED4EXT_CHECK(count == 16 * 64);
+
+    // The calling thread runs every chunk of a pool without workers.
+    ThreadPool single(0);
+    std::vector<int32_t> order;
+    ParallelFor(single, 0, 10, 2, [&order](int32_t aIndex) { order.push_back(aIndex); });
+
+    RED4EXT_CHECK(order.size() == 10);
+}
+
+RED4EXT_TEST(Parallel_JobQueueFor)
+{
+    FakeScheduler scheduler(&RunJob);
+
+    std::vector<int64_t> values(10000, -1);
+    std::vector<int64_t> counts;
+    {
+        JobQueue queue;
+        queue.Dispatch(CountWritten{&values, &counts});
+        ParallelFor(queue, 0, 10000, 1000, Square{&values});
+
+        // Jobs that are added after the loop wait for all chunks.
+        queue.Dispatch(CountWritten{&values, &counts});
+    }
+
+    // One job per hardware thread but not more than chunks, and the two counts.
+    auto jobCount = Detail::GetParallelJobCount(10);
+    RED4EXT_CHECK(jobCount >= 1 && jobCount <= 10);
+    RED4EXT_CHECK(GetJobSystem().dispatchedJobs == jobCount + 2);
+
+    Pump(3);
+
+    bool isComplete = true;
+    for (int32_t i = 0; i < 10000; ++i)
+    {
+        isComplete &= values[i] == int64_t{i} * i;
+    }
+
+    RED4EXT_CHECK(isComplete);
+    RED4EXT_REQUIRE(counts.size() == 2);
+    RED4EXT_CHECK(counts[1] == 10000);
+}
+
+RED4EXT_TEST(Parallel_JobQueueConcurrent)
+{
+    FakeScheduler scheduler(&RunJob);
+
+    // The jobs of a loop are on queues of their own, so they run at the same time when the queues are run by several
+    // threads. Every job waits in its first chunk until all jobs started, jobs that ran one after another time out.
+    auto jobCount = static_cast<uint32_t>(Detail::GetParallelJobCount(SIZE_MAX));
+    auto chunkCount = static_cast<int32_t>(2 * jobCount);
+
+    std::atomic<uint32_t> started = 0;
+    std::atomic<uint32_t> timeouts = 0;
+    {
+        JobQueue queue;
+        ParallelFor(queue, 0, chunkCount, 1, WaitForOthers{&started, &timeouts, jobCount});
+    }
+
+    Pump(jobCount - 1);
+
+    RED4EXT_CHECK(started == static_cast<uint32_t>(chunkCount));
+    RED4EXT_CHECK(timeouts == 0);
+}
+
+RED4EXT_TEST(Parallel_JobQueueSingleChunk)
+{
+    FakeScheduler scheduler(&RunJob);
+
+    // A range that fits into one chunk runs on the calling thread, nothing is dispatched.
+    std::vector<int64_t> values(100, -1);
+    int64_t sum = 0;
+    {
+        JobQueue queue;
+        ParallelFor(queue, 0, 100, 1000, Square{&values});
+        ParallelReduce(queue, 0, 100, 1000, int64_t{0}, Identity{}, Plus{}, Store<int64_t>{&sum});
+    }
+
+    RED4EXT_CHECK(values[99] == 99 * 99);
+    RED4EXT_CHECK(sum == 4950);
+    RED4EXT_CHECK(GetJobSystem().dispatchedJobs == 0);
+}
+
+RED4EXT_TEST(Parallel_JobQueueReduce)
+{
+    FakeScheduler scheduler(&RunJob);
+
+    int64_t sum = -1;
+    std::string text;
+    {
+        JobQueue queue;
+        ParallelReduce(queue, 0, 100001, 1000, int64_t{0}, Identity{}, Plus{}, Store<int64_t>{&sum});
+        ParallelReduce(queue, 0, 26, 4, std::string(), Letter{}, Concat{}, Store<std::string>{&text});
+
+        // The results are passed on by jobs of the queue.
+        RED4EXT_CHECK(sum == -1);
+        RED4EXT_CHECK(text.empty());
+    }
+
+    Pump(3);
+
+    RED4EXT_CHECK(sum == int64_t{100000} * 100001 / 2);
+    RED4EXT_CHECK(text == "abcdefghijklmnopqrstuvwxyz");
+}
@@ -0,0 +1,252 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/RTTINameCache.hpp>
+#include <RED4ext/RTTITypes.hpp>
+#include <RED4ext/Relocation.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's name pool, the strings are never freed like in the game.
+struct NamePool
+{
+    std::mutex lock;
+    std::unordered_map<uint64_t, std::string> names;
+};
+
+NamePool& GetNamePool()
+{
+    static NamePool pool;
+    return pool;
+}
+
+const char* NamePoolGet(const CName& aName)
+{
+    auto& pool = GetNamePool();
+    std::lock_guard<std::mutex> _(pool.lock);
+
+    auto it = pool.names.find(aName.hash);
+    return it != pool.names.end() ? it->second.c_str() : nullptr;
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveNamePool(uint32_t aHash)
+{
+    if (aHash == Detail::AddressHashes::CNamePool_Get)
+    {
+        return reinterpret_cast<uintptr_t>(&NamePoolGet);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+void Setup()
+{
+    [[maybe_unused]] static const auto isInstalled = []
+    {
+        g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveNamePool);
+        return true;
+    }();
+
+    RTTINameCache::Clear();
+}
+
+// A type with a fixed name that counts how often its name is computed.
+struct StandInType : CBaseRTTIType
+{
+    explicit StandInType(const std::string& aName)
+    {
+        Rename(aName);
+    }
+
+    void Rename(const std::string& aName)
+    {
+        name = CName(aName.c_str());
+        if (!name.IsNone())
+        {
+            auto& pool = GetNamePool();
+            std::lock_guard<std::mutex> _(pool.lock);
+            pool.names.try_emplace(name.hash, aName);
+        }
+    }
+
+    CName GetName() const override
+    {
+        return name;
+    }
+
+    uint32_t GetSize() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return 1;
+    }
+
+    ERTTIType GetType() const override
+    {
+        return ERTTIType::Simple;
+    }
+
+    CName GetComputedName() const override
+    {
+        computations.fetch_add(1, std::memory_order_relaxed);
+        return name;
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+
+    CName name;
+    mutable std::atomic<uint32_t> computations = 0;
+};
+} // namespace
+
+RED4EXT_TEST(RTTINameCache_ComputesNameOnce)
+{
+    Setup();
+
+    StandInType type("array:handle:gameObject");
+
+    RED4EXT_CHECK(RTTINameCache::GetComputedName(&type) == CName("array:handle:gameObject"));
+    RED4EXT_CHECK(RTTINameCache::GetComputedName(&type) == CName("array:handle:gameObject"));
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&type) == "array:handle:gameObject");
+    RED4EXT_CHECK(type.computations == 1);
+}
+
+RED4EXT_TEST(RTTINameCache_ViewPointsIntoNamePool)
+{
+    Setup();
+
+    StandInType type("Int32");
+
+    auto view = RTTINameCache::GetComputedNameView(&type);
+    RED4EXT_CHECK(view.Length() == 5);
+    RED4EXT_CHECK(view.Data() == NamePoolGet(CName("Int32")));
+}
+
+RED4EXT_TEST(RTTINameCache_NullAndUnnamedTypes)
+{
+    Setup();
+
+    RED4EXT_CHECK(RTTINameCache::GetComputedName(nullptr).IsNone());
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(nullptr) == "None");
+
+    StandInType type("");
+    RED4EXT_CHECK(RTTINameCache::GetComputedName(&type).IsNone());
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&type) == "None");
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&type).Length() == 4);
+}
+
+RED4EXT_TEST(RTTINameCache_Invalidate)
+{
+    Setup();
+
+    StandInType type("Float");
+    StandInType other("Bool");
+
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&type) == "Float");
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&other) == "Bool");
+
+    type.Rename("Double");
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&type) == "Float");
+
+    RTTINameCache::Invalidate(&type);
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&type) == "Double");
+    RED4EXT_CHECK(RTTINameCache::GetComputedNameView(&other) == "Bool");
+
+    RED4EXT_CHECK(type.computations == 2);
+    RED4EXT_CHECK(other.computations == 1);
+}
+
+RED4EXT_TEST(RTTINameCache_Clear)
+{
+    Setup();
+
+    std::vector<std::unique_ptr<StandInType>> types;
+    for (auto i = 0; i < 64; ++i)
+    {
+        types.emplace_back(new StandInType("Type" + std::to_string(i)));
+        RTTINameCache::GetComputedName(types.back().get());
+    }
+
+    RTTINameCache::Clear();
+
+    for (auto i = 0; i < 64; ++i)
+    {
+        RED4EXT_CHECK(RTTINameCache::GetComputedNameView(types[i].get()) == ("Type" + std::to_string(i)).c_str());
+        RED4EXT_CHECK(types[i]->computations == 2);
+    }
+}
+
+RED4EXT_TEST(RTTINameCache_ConcurrentLookups)
+{
+    Setup();
+
+    constexpr uint32_t TypeCount = 64;
+    constexpr uint32_t ThreadCount = 4;
+
+    std::vector<std::unique_ptr<StandInType>> types;
+    for (uint32_t i = 0; i < TypeCount; ++i)
+    {
+        types.emplace_back(new StandInType("Type" + std::to_string(i)));
+    }
+
+    std::atomic<uint32_t> mismatches = 0;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                for (uint32_t i = 0; i < 20000; ++i)
+                {
+                    const auto& type = *types[(i + t * 7) % TypeCount];
+                    if (RTTINameCache::GetComputedName(&type) != type.name)
+                    {
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+
+    // Threads racing on a missing entry may all compute it, but only once each.
+    for (const auto& type : types)
+    {
+        RED4EXT_CHECK(type->computations >= 1);
+        RED4EXT_CHECK(type->computations <= ThreadCount);
+    }
+}
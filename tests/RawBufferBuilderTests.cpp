@@ -0,0 +1,346 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+#include <RED4ext/RawBufferBuilder.hpp>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// RawBuffer keeps only the vtable of its allocator, the counters can not be members.
+struct AllocatorCounters
+{
+    uint32_t allocations = 0;
+    uint32_t reallocations = 0;
+    uint32_t frees = 0;
+};
+
+AllocatorCounters g_counters;
+
+// Counts the calls and forwards them to the engine allocator.
+struct CountingAllocator : Memory::IAllocator
+{
+    using IAllocator::Free;
+
+    Memory::AllocationResult Alloc(uint64_t aSize) const override
+    {
+        ++g_counters.allocations;
+        return GetInner()->Alloc(aSize);
+    }
+
+    Memory::AllocationResult AllocAligned(uint64_t aSize, uint32_t aAlignment) const override
+    {
+        ++g_counters.allocations;
+        return GetInner()->AllocAligned(aSize, aAlignment);
+    }
+
+    Memory::AllocationResult Realloc(Memory::AllocationResult& aAllocation, uint64_t aSize) const override
+    {
+        ++g_counters.reallocations;
+        return GetInner()->Realloc(aAllocation, aSize);
+    }
+
+    Memory::AllocationResult ReallocAligned(Memory::AllocationResult& aAllocation, uint64_t aSize,
+                                            uint32_t aAlignment) const override
+    {
+        ++g_counters.reallocations;
+        return GetInner()->ReallocAligned(aAllocation, aSize, aAlignment);
+    }
+
+    void Free(Memory::AllocationResult& aAllocation) const override
+    {
+        ++g_counters.frees;
+        GetInner()->Free(aAllocation);
+    }
+
+    void sub_28(void*) const override
+    {
+    }
+
+    const uint32_t GetHandle() const override
+    {
+        return GetInner()->GetHandle();
+    }
+
+    static Memory::IAllocator* GetInner()
+    {
+        return Memory::EngineAllocator::Get();
+    }
+
+    static CountingAllocator* Get()
+    {
+        static CountingAllocator allocator;
+        return &allocator;
+    }
+};
+
+std::vector<uint8_t> MakeBytes(uint32_t aSize, uint8_t aSeed)
+{
+    std::vector<uint8_t> bytes(aSize);
+    for (uint32_t i = 0; i < aSize; ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(aSeed + i * 7);
+    }
+
+    return bytes;
+}
+
+// An anonymous mapping that can be handed to RawBuffer::TakeMappingOwnership().
+void* MapView(uint32_t aSize)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    auto mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, aSize, nullptr);
+    if (!mapping)
+    {
+        return nullptr;
+    }
+
+    // The view keeps the mapping alive.
+    auto view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, aSize);
+    CloseHandle(mapping);
+    return view;
+#else
+    auto view = mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return view == MAP_FAILED ? nullptr : view;
+#endif
+}
+
+bool IsMapped(void* aView)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    MEMORY_BASIC_INFORMATION info{};
+    return VirtualQuery(aView, &info, sizeof(info)) && info.State != MEM_FREE;
+#else
+    // Fails with ENOMEM when the page is not mapped.
+    return msync(aView, 1, MS_ASYNC) == 0;
+#endif
+}
+} // namespace
+
+RED4EXT_TEST(RawBufferBuilder_KeepsSmallPayloadsInline)
+{
+    g_counters = {};
+
+    RawBufferBuilder builder(CountingAllocator::Get());
+    RED4EXT_CHECK(builder.IsInline());
+    RED4EXT_CHECK(builder.GetCapacity() == RawBufferBuilder::InlineCapacity);
+
+    auto bytes = MakeBytes(RawBufferBuilder::InlineCapacity, 1);
+    RED4EXT_REQUIRE(builder.Append(bytes.data(), 40));
+    RED4EXT_REQUIRE(builder.Append(Span<const uint8_t>(bytes.data() + 40, bytes.size() - 40)));
+
+    RED4EXT_CHECK(builder.IsInline());
+    RED4EXT_CHECK(builder.GetSize() == RawBufferBuilder::InlineCapacity);
+    RED4EXT_CHECK(std::memcmp(builder.GetData(), bytes.data(), bytes.size()) == 0);
+    RED4EXT_CHECK(g_counters.allocations == 0);
+
+    // One more byte leaves the inline storage.
+    uint8_t last = 0xFF;
+    RED4EXT_REQUIRE(builder.Append(&last, 1));
+    RED4EXT_CHECK(!builder.IsInline());
+    RED4EXT_CHECK(builder.GetCapacity() == 2 * RawBufferBuilder::InlineCapacity);
+    RED4EXT_CHECK(std::memcmp(builder.GetData(), bytes.data(), bytes.size()) == 0);
+    RED4EXT_CHECK(builder.GetData()[RawBufferBuilder::InlineCapacity] == last);
+    RED4EXT_CHECK(g_counters.allocations == 1);
+}
+
+RED4EXT_TEST(RawBufferBuilder_GrowsGeometrically)
+{
+    g_counters = {};
+
+    constexpr uint32_t ChunkSize = 64;
+    constexpr uint32_t ChunkCount = 16384;
+
+    auto chunk = MakeBytes(ChunkSize, 2);
+    {
+        RawBufferBuilder builder(CountingAllocator::Get());
+        for (uint32_t i = 0; i < ChunkCount; ++i)
+        {
+            chunk[0] = static_cast<uint8_t>(i);
+            RED4EXT_REQUIRE(builder.Append(chunk.data(), ChunkSize));
+        }
+
+        RED4EXT_REQUIRE(builder.GetSize() == ChunkSize * ChunkCount);
+        RED4EXT_CHECK(builder.GetCapacity() >= builder.GetSize());
+        RED4EXT_CHECK(builder.GetCapacity() < 2 * builder.GetSize() + RawBufferBuilder::InlineCapacity);
+
+        for (uint32_t i = 0; i < ChunkCount; ++i)
+        {
+            RED4EXT_REQUIRE(builder.GetData()[i * ChunkSize] == static_cast<uint8_t>(i));
+            RED4EXT_REQUIRE(std::memcmp(builder.GetData() + i * ChunkSize + 1, chunk.data() + 1, ChunkSize - 1) == 0);
+        }
+
+        // 1 MB from 64 bytes doubles 14 times.
+        RED4EXT_CHECK(g_counters.allocations + g_counters.reallocations <= 15);
+    }
+
+    RED4EXT_CHECK(g_counters.frees == 1);
+}
+
+RED4EXT_TEST(RawBufferBuilder_Reserve)
+{
+    g_counters = {};
+
+    RawBufferBuilder builder(CountingAllocator::Get());
+    RED4EXT_CHECK(builder.Reserve(16));
+    RED4EXT_CHECK(builder.IsInline());
+
+    RED4EXT_REQUIRE(builder.Reserve(10000));
+    RED4EXT_CHECK(builder.GetCapacity() >= 10000);
+    RED4EXT_CHECK(g_counters.allocations == 1);
+
+    auto bytes = MakeBytes(10000, 3);
+    RED4EXT_REQUIRE(builder.Append(bytes.data(), 10000));
+    RED4EXT_CHECK(g_counters.allocations == 1);
+    RED4EXT_CHECK(g_counters.reallocations == 0);
+
+    // Clear() keeps the memory.
+    auto data = builder.GetData();
+    builder.Clear();
+    RED4EXT_CHECK(builder.GetSize() == 0);
+    RED4EXT_REQUIRE(builder.Append(bytes.data(), 10000));
+    RED4EXT_CHECK(builder.GetData() == data);
+    RED4EXT_CHECK(g_counters.allocations == 1);
+}
+
+RED4EXT_TEST(RawBufferBuilder_AlignsLargeAlignments)
+{
+    RawBufferBuilder builder(nullptr, 64);
+    RED4EXT_CHECK(!builder.IsInline());
+    RED4EXT_CHECK(builder.GetCapacity() == 0);
+
+    uint8_t byte = 1;
+    RED4EXT_REQUIRE(builder.Append(&byte, 1));
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(builder.GetData()) % 64 == 0);
+
+    auto bytes = MakeBytes(5000, 4);
+    RED4EXT_REQUIRE(builder.Append(bytes.data(), 5000));
+    RED4EXT_CHECK(reinterpret_cast<uintptr_t>(builder.GetData()) % 64 == 0);
+    RED4EXT_CHECK(builder.GetData()[0] == byte);
+    RED4EXT_CHECK(std::memcmp(builder.GetData() + 1, bytes.data(), bytes.size()) == 0);
+}
+
+RED4EXT_TEST(RawBufferBuilder_MovesAllocatedMemory)
+{
+    g_counters = {};
+
+    auto bytes = MakeBytes(1000, 5);
+    {
+        RawBufferBuilder builder(CountingAllocator::Get());
+        RED4EXT_REQUIRE(builder.Append(bytes.data(), 1000));
+
+        auto data = builder.GetData();
+
+        DataBuffer buffer{};
+        RED4EXT_REQUIRE(builder.MoveTo(buffer));
+
+        // Handed over as is.
+        RED4EXT_CHECK(buffer.buffer.data == data);
+        RED4EXT_CHECK(buffer.buffer.size == 1000);
+        RED4EXT_CHECK(buffer.buffer.GetAllocator() != nullptr);
+        RED4EXT_CHECK(std::memcmp(buffer.buffer.data, bytes.data(), bytes.size()) == 0);
+
+        RED4EXT_CHECK(builder.GetSize() == 0);
+        RED4EXT_CHECK(builder.IsInline());
+
+        // The buffer already holds data, and the builder is empty.
+        RED4EXT_REQUIRE(builder.Append(bytes.data(), 10));
+        RED4EXT_CHECK(!builder.MoveTo(buffer));
+
+        RawBuffer other;
+        builder.Clear();
+        RED4EXT_CHECK(!builder.MoveTo(other));
+        RED4EXT_CHECK(!other.data);
+    }
+
+    // The buffer returned the memory to the builder's allocator.
+    RED4EXT_CHECK(g_counters.allocations == 1);
+    RED4EXT_CHECK(g_counters.frees == 1);
+}
+
+RED4EXT_TEST(RawBufferBuilder_MovesInlineContentsToAnExactAllocation)
+{
+    g_counters = {};
+
+    auto bytes = MakeBytes(20, 6);
+    {
+        RawBufferBuilder builder(CountingAllocator::Get());
+        RED4EXT_REQUIRE(builder.Append(bytes.data(), 20));
+
+        RawBuffer buffer;
+        RED4EXT_REQUIRE(builder.MoveTo(buffer));
+
+        RED4EXT_CHECK(buffer.data != builder.GetData());
+        RED4EXT_CHECK(buffer.size == 20);
+        RED4EXT_CHECK(std::memcmp(buffer.data, bytes.data(), bytes.size()) == 0);
+        RED4EXT_CHECK(g_counters.allocations == 1);
+
+        // A resize goes through the same allocator.
+        buffer.Resize(4000);
+        RED4EXT_CHECK(buffer.size == 4000);
+        RED4EXT_CHECK(std::memcmp(buffer.data, bytes.data(), bytes.size()) == 0);
+        RED4EXT_CHECK(g_counters.reallocations == 1);
+    }
+
+    RED4EXT_CHECK(g_counters.frees == 1);
+}
+
+RED4EXT_TEST(RawBuffer_TakesOwnership)
+{
+    g_counters = {};
+
+    {
+        RawBuffer buffer;
+        RED4EXT_CHECK(!buffer.TakeOwnership(nullptr, 10, CountingAllocator::Get()));
+
+        auto data = CountingAllocator::Get()->AllocAligned(100, 16).memory;
+        RED4EXT_REQUIRE(buffer.TakeOwnership(data, 100, CountingAllocator::Get(), 16));
+        RED4EXT_CHECK(buffer.data == data);
+        RED4EXT_CHECK(buffer.alignment == 16);
+
+        auto other = CountingAllocator::Get()->Alloc(10).memory;
+        RED4EXT_CHECK(!buffer.TakeOwnership(other, 10, CountingAllocator::Get()));
+        CountingAllocator::Get()->Free(other);
+    }
+
+    RED4EXT_CHECK(g_counters.frees == 2);
+}
+
+RED4EXT_TEST(RawBuffer_TakesMappingOwnership)
+{
+    constexpr uint32_t Size = 64 * 1024;
+
+    auto view = MapView(Size);
+    RED4EXT_REQUIRE(view);
+    std::memset(view, 0xAB, Size);
+    RED4EXT_CHECK(IsMapped(view));
+
+    {
+        RawBuffer buffer;
+        RED4EXT_REQUIRE(buffer.TakeMappingOwnership(view, Size));
+        RED4EXT_CHECK(buffer.data == view);
+        RED4EXT_CHECK(buffer.size == Size);
+        RED4EXT_CHECK(!buffer.GetAllocator());
+        RED4EXT_CHECK(static_cast<uint8_t*>(buffer.data)[Size - 1] == 0xAB);
+
+        // A mapping can not be reallocated, the buffer keeps it.
+        buffer.Resize(2 * Size);
+        RED4EXT_CHECK(buffer.data == view);
+        RED4EXT_CHECK(buffer.size == Size);
+
+        RED4EXT_CHECK(!buffer.TakeMappingOwnership(view, Size));
+    }
+
+    RED4EXT_CHECK(!IsMapped(view));
+}
@@ -0,0 +1,346 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/ArchiveReader.hpp>
+#include <RED4ext/ResourceDepot.hpp>
+#include <RED4ext/ResourceExistenceIndex.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+std::vector<ResourcePath> MakePaths(size_t aCount, uint64_t aSeed)
+{
+    std::mt19937_64 random(aSeed);
+
+    std::vector<ResourcePath> paths;
+    paths.reserve(aCount);
+    for (size_t i = 0; i < aCount; ++i)
+    {
+        paths.push_back(random());
+    }
+
+    return paths;
+}
+
+Span<const ResourcePath> ToSpan(const std::vector<ResourcePath>& aPaths)
+{
+    return {aPaths.data(), aPaths.size()};
+}
+
+// An archive file in the temporary directory that lists the paths without any data, it is removed at the end of the
+// test.
+struct TemporaryArchive
+{
+    TemporaryArchive(const char* aName, const std::vector<ResourcePath>& aPaths)
+        : path(std::filesystem::temp_directory_path() / aName)
+    {
+        ArchiveReader::Header header{};
+        header.magic = ArchiveReader::Magic;
+        header.version = 12;
+        header.indexPosition = sizeof(header);
+
+        ArchiveReader::IndexHeader index{};
+        index.fileCount = static_cast<uint32_t>(aPaths.size());
+
+        std::vector<ArchiveReader::FileEntry> entries(aPaths.size());
+        for (size_t i = 0; i < aPaths.size(); ++i)
+        {
+            entries[i].path = aPaths[i];
+        }
+
+        header.fileSize = sizeof(header) + sizeof(index) + entries.size() * sizeof(ArchiveReader::FileEntry);
+
+        auto file = std::fopen(path.string().c_str(), "wb");
+        if (file)
+        {
+            std::fwrite(&header, sizeof(header), 1, file);
+            std::fwrite(&index, sizeof(index), 1, file);
+            std::fwrite(entries.data(), sizeof(ArchiveReader::FileEntry), entries.size(), file);
+            std::fclose(file);
+        }
+    }
+
+    ~TemporaryArchive()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    std::filesystem::path path;
+};
+
+// ResourceDepot cannot be implemented outside of the game, its destructor is pure and GetAllocator() returns an
+// abstract type. AddDepot() only reads the archive groups, this has the same layout.
+struct StandInDepot
+{
+    void* vftable = nullptr;       // 00
+    uint64_t unk08 = 0;            // 08
+    DynArray<ArchiveGroup> groups; // 10
+    DynArray<void*> unk20;         // 20
+    CString rootPath;              // 30
+    bool hasModArchives = false;   // 50
+
+    void AddGroup(const std::vector<std::filesystem::path>& aArchives)
+    {
+        ArchiveGroup group{};
+        for (const auto& archive : aArchives)
+        {
+            Archive entry{};
+            entry.path = CString(archive.string().c_str());
+            group.archives.PushBack(entry);
+        }
+
+        groups.PushBack(group);
+    }
+
+    const ResourceDepot* Get() const
+    {
+        return reinterpret_cast<const ResourceDepot*>(this);
+    }
+};
+RED4EXT_ASSERT_OFFSET(StandInDepot, groups, 0x10);
+} // namespace
+
+RED4EXT_TEST(ResourceExistenceIndex_HasNoFalseNegatives)
+{
+    constexpr size_t Count = 50000;
+
+    auto added = MakePaths(Count, 1);
+    auto others = MakePaths(Count, 2);
+
+    ResourceExistenceIndex index;
+    index.Add(ToSpan(added));
+    RED4EXT_CHECK(index.GetSize() == Count);
+
+    size_t found = 0;
+    for (auto path : added)
+    {
+        found += index.Contains(path);
+    }
+
+    RED4EXT_CHECK(found == Count);
+
+    // Contains() is exact, MayContain() only lets a few of the other paths through.
+    size_t contained = 0;
+    size_t maybe = 0;
+    for (auto path : others)
+    {
+        contained += index.Contains(path);
+        maybe += index.MayContain(path);
+    }
+
+    RED4EXT_CHECK(contained == 0);
+
+    auto rate = static_cast<double>(maybe) / Count;
+    auto estimate = index.EstimateFalsePositiveRate();
+    RED4EXT_CHECK(rate < 0.01);
+    RED4EXT_CHECK(estimate < 0.01);
+    RED4EXT_CHECK(estimate > rate / 3 && estimate < rate * 3 + 0.0005);
+}
+
+RED4EXT_TEST(ResourceExistenceIndex_MergesIncrementalAdds)
+{
+    constexpr size_t Count = 5000;
+
+    auto paths = MakePaths(Count, 3);
+
+    // Added one by one, the pending list is merged several times on the way.
+    ResourceExistenceIndex index;
+    for (size_t i = 0; i < Count; ++i)
+    {
+        index.Add(paths[i]);
+
+        if (i % 1000 == 999)
+        {
+            for (size_t j = 0; j <= i; ++j)
+            {
+                RED4EXT_REQUIRE(index.Contains(paths[j]));
+            }
+
+            RED4EXT_CHECK(index.GetSize() == i + 1);
+        }
+    }
+
+    // Duplicates are not counted twice.
+    index.Add(paths[0]);
+    index.Add(ToSpan(paths));
+    RED4EXT_CHECK(index.GetSize() == Count);
+
+    index.Rebuild();
+    RED4EXT_CHECK(index.GetSize() == Count);
+
+    size_t found = 0;
+    for (auto path : paths)
+    {
+        found += index.Contains(path);
+    }
+
+    RED4EXT_CHECK(found == Count);
+}
+
+RED4EXT_TEST(ResourceExistenceIndex_BatchMatchesSingleQueries)
+{
+    auto added = MakePaths(20000, 4);
+
+    ResourceExistenceIndex index;
+    index.Add(ToSpan(added));
+
+    // A few paths that are only in the pending list.
+    auto pending = MakePaths(10, 5);
+    for (auto path : pending)
+    {
+        index.Add(path);
+    }
+
+    std::vector<ResourcePath> queries;
+    auto others = MakePaths(10000, 6);
+    for (size_t i = 0; i < others.size(); ++i)
+    {
+        queries.push_back(others[i]);
+        queries.push_back(added[i * 2]);
+    }
+
+    queries.insert(queries.end(), pending.begin(), pending.end());
+
+    std::unique_ptr<bool[]> results(new bool[queries.size()]);
+    auto count = index.Contains(queries.data(), results.get(), queries.size());
+
+    size_t expected = 0;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        RED4EXT_CHECK(results[i] == index.Contains(queries[i]));
+        expected += results[i];
+    }
+
+    RED4EXT_CHECK(count == expected);
+    RED4EXT_CHECK(count == 10000 + pending.size());
+
+    RED4EXT_CHECK(index.Contains(queries.data(), results.get(), 0) == 0);
+}
+
+RED4EXT_TEST(ResourceExistenceIndex_AddArchive)
+{
+    auto paths = MakePaths(3000, 7);
+
+    // The archives overlap by 1000 paths.
+    TemporaryArchive first("RED4ext.ResourceExistenceIndexTests.first.archive",
+                           std::vector<ResourcePath>(paths.begin(), paths.begin() + 2000));
+    TemporaryArchive second("RED4ext.ResourceExistenceIndexTests.second.archive",
+                            std::vector<ResourcePath>(paths.begin() + 1000, paths.end()));
+
+    ResourceExistenceIndex index;
+    RED4EXT_REQUIRE(index.AddArchive(first.path));
+    RED4EXT_REQUIRE(index.AddArchive(second.path));
+    RED4EXT_CHECK(!index.AddArchive(std::filesystem::temp_directory_path() / "RED4ext.Missing.archive"));
+
+    RED4EXT_CHECK(index.GetSize() == paths.size());
+    for (auto path : paths)
+    {
+        RED4EXT_REQUIRE(index.Contains(path));
+    }
+}
+
+RED4EXT_TEST(ResourceExistenceIndex_AddDepot)
+{
+    auto paths = MakePaths(6000, 8);
+
+    TemporaryArchive content("RED4ext.ResourceExistenceIndexTests.content.archive",
+                             std::vector<ResourcePath>(paths.begin(), paths.begin() + 3000));
+    TemporaryArchive patch("RED4ext.ResourceExistenceIndexTests.patch.archive",
+                           std::vector<ResourcePath>(paths.begin() + 2000, paths.begin() + 5000));
+    TemporaryArchive mod("RED4ext.ResourceExistenceIndexTests.mod.archive",
+                         std::vector<ResourcePath>(paths.begin() + 5000, paths.end()));
+
+    StandInDepot depot;
+    depot.AddGroup({content.path, patch.path});
+    depot.AddGroup({mod.path, std::filesystem::temp_directory_path() / "RED4ext.Missing.archive"});
+
+    ResourceExistenceIndex index;
+    RED4EXT_CHECK(index.AddDepot(nullptr) == 0);
+    RED4EXT_CHECK(index.AddDepot(depot.Get()) == 3);
+    RED4EXT_CHECK(index.GetSize() == paths.size());
+
+    for (auto path : paths)
+    {
+        RED4EXT_REQUIRE(index.Contains(path));
+    }
+
+    auto others = MakePaths(1000, 9);
+    for (auto path : others)
+    {
+        RED4EXT_REQUIRE(!index.Contains(path));
+    }
+}
+
+RED4EXT_TEST(ResourceExistenceIndex_Clear)
+{
+    auto paths = MakePaths(5000, 10);
+
+    ResourceExistenceIndex index;
+    index.Add(ToSpan(paths));
+    RED4EXT_CHECK(index.GetMemoryUsage() > 0);
+
+    index.Clear();
+    RED4EXT_CHECK(index.GetSize() == 0);
+    RED4EXT_CHECK(index.GetMemoryUsage() == 0);
+    RED4EXT_CHECK(index.EstimateFalsePositiveRate() == 0.0);
+    RED4EXT_CHECK(!index.Contains(paths[0]));
+    RED4EXT_CHECK(!index.MayContain(paths[0]));
+
+    index.Add(paths[0]);
+    RED4EXT_CHECK(index.Contains(paths[0]));
+    RED4EXT_CHECK(index.GetSize() == 1);
+}
+
+RED4EXT_TEST(ResourceExistenceIndex_ConcurrentQueriesAndAdds)
+{
+    auto initial = MakePaths(20000, 11);
+    auto added = MakePaths(5000, 12);
+
+    ResourceExistenceIndex index;
+    index.Add(ToSpan(initial));
+
+    std::atomic<bool> isAdding = true;
+    std::atomic<size_t> misses = 0;
+
+    std::vector<std::thread> readers;
+    for (uint32_t t = 0; t < 3; ++t)
+    {
+        readers.emplace_back(
+            [&, t]
+            {
+                // Paths that were there from the start are always found, whatever is merged meanwhile.
+                for (size_t i = t; isAdding.load() || i < initial.size(); i += 3)
+                {
+                    if (!index.Contains(initial[i % initial.size()]))
+                    {
+                        misses.fetch_add(1);
+                    }
+                }
+            });
+    }
+
+    for (auto path : added)
+    {
+        index.Add(path);
+    }
+
+    isAdding = false;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    RED4EXT_CHECK(misses.load() == 0);
+    RED4EXT_CHECK(index.GetSize() == initial.size() + added.size());
+}
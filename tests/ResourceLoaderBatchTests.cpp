@@ -0,0 +1,643 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ResourceLoader.hpp is not self-contained, its CResource include needs the loader already.
+#include <RED4ext/RED4ext.hpp>
+
+#include <RED4ext/Detail/AddressHashes.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Relocation.hpp>
+#include <RED4ext/ResourceLoader.hpp>
+#include <RED4ext/ResourceTokenCache.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Stands in for the game's job system. Handles are reference counted through unk1C like in the game, the jobs of a
+// captured queue run in Pump() once every handle the queue waits on has completed. Token handles are completed by the
+// test through the loader.
+struct JobSystem
+{
+    enum class Kind
+    {
+        Manual,
+        Gate, // Completes with the handles joined to it, the start of a queue.
+        Queue // Completes after the jobs of the queue ran.
+    };
+
+    struct State
+    {
+        Kind kind = Kind::Manual;
+        bool completed = false;
+        std::vector<JobInternalHandle*> waits;
+        std::vector<JobInstance> jobs;
+    };
+
+    std::recursive_mutex lock;
+    std::unordered_map<JobInternalHandle*, State> states;
+    std::vector<std::pair<JobInternalHandle*, JobInternalHandle*>> queues; // Gate and completion of captured queues.
+    void (*runJob)(const JobInstance&) = nullptr;
+};
+
+JobSystem& GetJobSystem()
+{
+    static JobSystem system;
+    return system;
+}
+
+void AddRef(JobInternalHandle* aHandle)
+{
+    InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(1));
+}
+
+void Release(JobInternalHandle* aHandle)
+{
+    if (InterlockedExchangeAdd(&aHandle->unk1C, static_cast<uint32_t>(-1)) != 1)
+    {
+        return;
+    }
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto waits = std::move(system.states[aHandle].waits);
+    system.states.erase(aHandle);
+    delete aHandle;
+
+    for (auto wait : waits)
+    {
+        Release(wait);
+    }
+}
+
+bool IsCompleted(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    const auto& state = system.states[aHandle];
+    if (state.kind != JobSystem::Kind::Gate)
+    {
+        return state.completed;
+    }
+
+    return std::all_of(state.waits.begin(), state.waits.end(), &IsCompleted);
+}
+
+void Complete(JobInternalHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[aHandle].completed = true;
+}
+
+// Runs the jobs of every queue that is ready, returns the number of queues that completed.
+uint32_t Pump()
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    uint32_t completed = 0;
+    for (auto it = system.queues.begin(); it != system.queues.end();)
+    {
+        auto [gate, queue] = *it;
+        if (!IsCompleted(gate))
+        {
+            ++it;
+            continue;
+        }
+
+        auto jobs = std::move(system.states[queue].jobs);
+        for (const auto& job : jobs)
+        {
+            system.runJob(job);
+        }
+
+        system.states[queue].completed = true;
+        system.queues.erase(it);
+
+        Release(gate);
+        Release(queue);
+        ++completed;
+
+        // A completed queue can unblock queues before it.
+        it = system.queues.begin();
+    }
+
+    return completed;
+}
+
+// Releases the queues that never became ready.
+void DropQueues()
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    auto queues = std::move(system.queues);
+    for (auto [gate, queue] : queues)
+    {
+        Release(gate);
+        Release(queue);
+    }
+}
+
+JobInternalHandle* AcquireJobHandle(void*, uintptr_t)
+{
+    auto handle = new JobInternalHandle{};
+    handle->unk1C = 1;
+
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+    system.states[handle];
+
+    return handle;
+}
+
+void ReleaseJobHandle(JobHandle* aHandle)
+{
+    Release(aHandle->internal);
+    aHandle->internal = nullptr;
+}
+
+void JoinJobHandle(JobHandle* aHandle, const JobHandle& aOther)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    AddRef(aOther.internal);
+    system.states[aHandle->internal].waits.push_back(aOther.internal);
+}
+
+JobQueue* ConstructJobQueue(JobQueue* aQueue, uint8_t, uint8_t, uint64_t)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    // The handles were acquired by the members' constructors.
+    system.states[aQueue->unk10.internal].kind = JobSystem::Kind::Gate;
+    system.states[aQueue->unk18.internal].kind = JobSystem::Kind::Queue;
+    aQueue->captured = false;
+
+    return aQueue;
+}
+
+void DestructJobQueue(JobQueue*)
+{
+    // The members' destructors release the handles.
+}
+
+JobHandle* CaptureJobQueue(JobQueue* aQueue, JobHandle* aHandle)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    Release(aHandle->internal);
+    aHandle->internal = aQueue->unk18.internal;
+    AddRef(aHandle->internal);
+
+    AddRef(aQueue->unk10.internal);
+    AddRef(aQueue->unk18.internal);
+    system.queues.emplace_back(aQueue->unk10.internal, aQueue->unk18.internal);
+    aQueue->captured = true;
+
+    return aHandle;
+}
+
+uint32_t DispatchJob(void*, const JobInstance& aJob, uint8_t, JobInternalHandle*, JobInternalHandle* aQueue)
+{
+    auto& system = GetJobSystem();
+    std::lock_guard<std::recursive_mutex> _(system.lock);
+
+    system.states[aQueue].jobs.push_back(aJob);
+    return 0;
+}
+
+void SyncWaitJobQueue(JobQueue*)
+{
+}
+
+// The game's handler also sets a job parameter in the game's thread local storage, which does not exist here. Run the
+// closure directly and release it like the handler does.
+template<typename L>
+void RunClosure(const JobInstance& aJob)
+{
+    using Closure = JobClosure<L>;
+
+    RED4EXT_REQUIRE(aJob.handler == reinterpret_cast<JobInstance::HandleFunc<void>>(&Closure::HandleTarget));
+
+    auto closure = static_cast<L*>(aJob.target);
+    (*closure)();
+    Memory::Delete<typename Closure::AllocatorType>(closure);
+}
+
+void* g_jobDispatcher = nullptr;
+
+// Stands in for the game's loader. Requested tokens are kept alive until the test finishes them, like the game does
+// while a resource is loading.
+struct LoaderBackend
+{
+    std::vector<ResourcePath> requests;
+    std::vector<SharedPtr<ResourceToken<>>> loading;
+};
+
+LoaderBackend& GetLoaderBackend()
+{
+    static LoaderBackend backend;
+    return backend;
+}
+
+uintptr_t IssueLoadingRequest(ResourceLoader* aLoader, SharedPtr<ResourceToken<>>& aToken, ResourcePath aPath)
+{
+    aToken = MakeShared<ResourceToken<>>();
+    aToken->path = aPath;
+    aLoader->tokens.InsertOrAssign(aPath, WeakPtr<ResourceToken<>>(aToken));
+
+    auto& backend = GetLoaderBackend();
+    backend.requests.push_back(aPath);
+    backend.loading.push_back(aToken);
+
+    return 0;
+}
+
+void Finish(ResourcePath aPath, bool aFailed = false)
+{
+    auto& loading = GetLoaderBackend().loading;
+    auto it = std::find_if(loading.begin(), loading.end(),
+                           [aPath](const auto& aToken) { return aToken->path == aPath; });
+    if (it == loading.end())
+    {
+        return;
+    }
+
+    auto& token = *it;
+    token->error = aFailed;
+    token->finished = 1;
+    Complete(token->job.internal);
+
+    loading.erase(it);
+}
+
+void CancelTokenJob(void*)
+{
+}
+
+void DestructTokenJob(void**)
+{
+}
+
+void DecWeakRef(SharedPtrBase<void>* aPtr)
+{
+    if (InterlockedExchangeAdd(&aPtr->refCount->weakRefs, static_cast<uint32_t>(-1)) == 1)
+    {
+        Memory::Delete(aPtr->refCount);
+    }
+}
+
+UniversalRelocBase::ResolveOverrideFunc_t g_previousResolve = nullptr;
+
+uintptr_t ResolveLoader(uint32_t aHash)
+{
+    using namespace Detail::AddressHashes;
+
+    switch (aHash)
+    {
+    case JobInternalHandle_Acquire:
+        return reinterpret_cast<uintptr_t>(&AcquireJobHandle);
+    case JobHandle_dtor:
+        return reinterpret_cast<uintptr_t>(&ReleaseJobHandle);
+    case JobHandle_Join:
+        return reinterpret_cast<uintptr_t>(&JoinJobHandle);
+    case JobQueue_ctor_FromParams:
+        return reinterpret_cast<uintptr_t>(&ConstructJobQueue);
+    case JobQueue_dtor:
+        return reinterpret_cast<uintptr_t>(&DestructJobQueue);
+    case JobQueue_Capture:
+        return reinterpret_cast<uintptr_t>(&CaptureJobQueue);
+    case JobQueue_SyncWait:
+        return reinterpret_cast<uintptr_t>(&SyncWaitJobQueue);
+    case JobDispatcher_DispatchJob:
+        return reinterpret_cast<uintptr_t>(&DispatchJob);
+    case JobDispatcher:
+        return reinterpret_cast<uintptr_t>(&g_jobDispatcher);
+    case ResourceLoader_IssueLoadingRequestByPath:
+        return reinterpret_cast<uintptr_t>(&IssueLoadingRequest);
+    case ResourceToken_CancelUnk38:
+        return reinterpret_cast<uintptr_t>(&CancelTokenJob);
+    case ResourceToken_DestructUnk38:
+        return reinterpret_cast<uintptr_t>(&DestructTokenJob);
+    case Handle_DecWeakRef:
+        return reinterpret_cast<uintptr_t>(&DecWeakRef);
+    }
+
+    return g_previousResolve ? g_previousResolve(aHash) : 0;
+}
+
+void Setup()
+{
+    [[maybe_unused]] static const auto isInstalled = []
+    {
+        g_previousResolve = UniversalRelocBase::SetResolveOverride(&ResolveLoader);
+        return true;
+    }();
+
+    ResourceTokenCache::Invalidate();
+
+    auto& backend = GetLoaderBackend();
+    backend.requests.clear();
+    backend.loading.clear();
+}
+
+struct FakeLoader
+{
+    FakeLoader()
+    {
+        loader.tokens = HashMap<ResourcePath, WeakPtr<ResourceToken<>>>(Memory::DefaultAllocator::Get());
+    }
+
+    ~FakeLoader()
+    {
+        // Drop everything that still references tokens of this loader, the cache holds weak references too.
+        ResourceTokenCache::Invalidate();
+        GetLoaderBackend().loading.clear();
+        DropQueues();
+    }
+
+    ResourceLoader loader{};
+};
+
+ResourcePath GetPath(uint32_t aIndex)
+{
+    return ResourcePath(("base\\tests\\resource_" + std::to_string(aIndex) + ".mesh").c_str());
+}
+
+Span<const ResourcePath> ToSpan(const std::vector<ResourcePath>& aPaths)
+{
+    return {aPaths.data(), aPaths.size()};
+}
+
+struct CountCalls
+{
+    void operator()()
+    {
+        ++*calls;
+    }
+
+    uint32_t* calls;
+};
+} // namespace
+
+RED4EXT_TEST(ResourceLoader_LoadBatchDeduplicatesPaths)
+{
+    Setup();
+    FakeLoader fake;
+
+    auto a = GetPath(1);
+    auto b = GetPath(2);
+    auto c = GetPath(3);
+
+    std::vector<ResourcePath> paths = {a, b, a, {}, c, b, a};
+    auto batch = fake.loader.LoadBatch(ToSpan(paths));
+
+    RED4EXT_REQUIRE(batch.paths.size() == 3);
+    RED4EXT_CHECK(std::is_sorted(batch.paths.begin(), batch.paths.end(),
+                                 [](ResourcePath aLhs, ResourcePath aRhs) { return aLhs.hash < aRhs.hash; }));
+    RED4EXT_CHECK(GetLoaderBackend().requests.size() == 3);
+
+    for (auto path : {a, b, c})
+    {
+        auto token = batch.Find(path);
+        RED4EXT_REQUIRE(token);
+        RED4EXT_CHECK(token->path == path);
+    }
+
+    RED4EXT_CHECK(!batch.Find(GetPath(4)));
+    RED4EXT_CHECK(!batch.Find({}));
+    RED4EXT_CHECK(!batch.IsFinished());
+}
+
+RED4EXT_TEST(ResourceLoader_LoadBatchReusesLiveTokens)
+{
+    Setup();
+    FakeLoader fake;
+
+    std::vector<ResourcePath> first = {GetPath(1), GetPath(2)};
+    auto firstBatch = fake.loader.LoadBatch(ToSpan(first));
+    RED4EXT_REQUIRE(GetLoaderBackend().requests.size() == 2);
+
+    // Served by the cache, only the new path is requested.
+    std::vector<ResourcePath> second = {GetPath(2), GetPath(1), GetPath(3)};
+    auto secondBatch = fake.loader.LoadBatch(ToSpan(second));
+    RED4EXT_CHECK(GetLoaderBackend().requests.size() == 3);
+    RED4EXT_CHECK(secondBatch.Find(GetPath(1)).instance == firstBatch.Find(GetPath(1)).instance);
+    RED4EXT_CHECK(secondBatch.Find(GetPath(2)).instance == firstBatch.Find(GetPath(2)).instance);
+
+    // Served by the loader's token map.
+    ResourceTokenCache::Invalidate();
+    auto thirdBatch = fake.loader.LoadBatch(ToSpan(second));
+    RED4EXT_CHECK(GetLoaderBackend().requests.size() == 3);
+    RED4EXT_CHECK(thirdBatch.Find(GetPath(3)).instance == secondBatch.Find(GetPath(3)).instance);
+
+    // The map lookup fills the cache again.
+    RED4EXT_CHECK(ResourceTokenCache::Find(GetPath(3)).instance == secondBatch.Find(GetPath(3)).instance);
+}
+
+RED4EXT_TEST(ResourceLoader_LoadBatchCallsOnceWhenAllFinished)
+{
+    Setup();
+    FakeLoader fake;
+
+    GetJobSystem().runJob = &RunClosure<CountCalls>;
+
+    uint32_t calls = 0;
+    std::vector<ResourcePath> paths = {GetPath(1), GetPath(2), GetPath(3)};
+    auto batch = fake.loader.LoadBatch(ToSpan(paths), CountCalls{&calls});
+
+    RED4EXT_CHECK(Pump() == 0);
+
+    Finish(GetPath(1));
+    Finish(GetPath(3));
+    RED4EXT_CHECK(Pump() == 0);
+    RED4EXT_CHECK(calls == 0);
+    RED4EXT_CHECK(!batch.IsFinished());
+    RED4EXT_CHECK(!IsCompleted(batch.job.internal));
+
+    Finish(GetPath(2), true);
+    RED4EXT_CHECK(Pump() == 1);
+    RED4EXT_CHECK(calls == 1);
+    RED4EXT_CHECK(batch.IsFinished());
+    RED4EXT_CHECK(!batch.IsLoaded());
+    RED4EXT_CHECK(batch.GetFailedCount() == 1);
+    RED4EXT_CHECK(IsCompleted(batch.job.internal));
+
+    RED4EXT_CHECK(Pump() == 0);
+    RED4EXT_CHECK(calls == 1);
+}
+
+RED4EXT_TEST(ResourceLoader_LoadBatchSkipsFinishedTokens)
+{
+    Setup();
+    FakeLoader fake;
+
+    GetJobSystem().runJob = &RunClosure<CountCalls>;
+
+    std::vector<ResourcePath> paths = {GetPath(1), GetPath(2)};
+    auto loading = fake.loader.LoadBatch(ToSpan(paths));
+    Finish(GetPath(1));
+    Finish(GetPath(2));
+    RED4EXT_CHECK(loading.IsLoaded());
+
+    // Only unfinished tokens are waited on, the closure is ready to run right away.
+    uint32_t calls = 0;
+    auto batch = fake.loader.LoadBatch(ToSpan(paths), CountCalls{&calls});
+
+    auto& system = GetJobSystem();
+    RED4EXT_REQUIRE(system.queues.size() == 2);
+    RED4EXT_CHECK(system.states[system.queues.back().first].waits.empty());
+
+    Pump();
+    RED4EXT_CHECK(calls == 1);
+    RED4EXT_CHECK(batch.IsLoaded());
+    RED4EXT_CHECK(batch.GetFailedCount() == 0);
+    RED4EXT_CHECK(GetLoaderBackend().requests.size() == 2);
+}
+
+RED4EXT_TEST(ResourceLoader_LoadBatchOfNothing)
+{
+    Setup();
+    FakeLoader fake;
+
+    GetJobSystem().runJob = &RunClosure<CountCalls>;
+
+    uint32_t calls = 0;
+    std::vector<ResourcePath> paths = {ResourcePath{}, ResourcePath{}};
+    auto batch = fake.loader.LoadBatch(ToSpan(paths), CountCalls{&calls});
+
+    RED4EXT_CHECK(batch.paths.empty());
+    RED4EXT_CHECK(batch.IsFinished());
+    RED4EXT_CHECK(batch.IsLoaded());
+    RED4EXT_CHECK(GetLoaderBackend().requests.empty());
+
+    Pump();
+    RED4EXT_CHECK(calls == 1);
+}
+
+RED4EXT_TEST(ResourceTokenCache_DoesNotKeepTokensAlive)
+{
+    Setup();
+    FakeLoader fake;
+
+    std::vector<ResourcePath> paths = {GetPath(1)};
+    {
+        auto batch = fake.loader.LoadBatch(ToSpan(paths));
+        Finish(GetPath(1));
+
+        RED4EXT_CHECK(ResourceTokenCache::Find(GetPath(1)));
+    }
+
+    // The batch held the last strong reference.
+    RED4EXT_CHECK(!ResourceTokenCache::Find(GetPath(1)));
+
+    auto batch = fake.loader.LoadBatch(ToSpan(paths));
+    RED4EXT_CHECK(GetLoaderBackend().requests.size() == 2);
+    RED4EXT_CHECK(batch.Find(GetPath(1)));
+}
+
+RED4EXT_TEST(ResourceTokenCache_ChecksThePathOfSharedSlots)
+{
+    Setup();
+    FakeLoader fake;
+
+    // Twice as many tokens as slots, some of them share a slot.
+    std::vector<ResourcePath> paths;
+    for (uint32_t i = 0; i < 2 * ResourceTokenCache::SlotCount; ++i)
+    {
+        paths.push_back(GetPath(i));
+    }
+
+    auto batch = fake.loader.LoadBatch(ToSpan(paths));
+
+    uint32_t found = 0;
+    for (auto path : paths)
+    {
+        auto token = ResourceTokenCache::Find(path);
+        if (token)
+        {
+            RED4EXT_CHECK(token->path == path);
+            ++found;
+        }
+    }
+
+    RED4EXT_CHECK(found > 0);
+    RED4EXT_CHECK(found <= ResourceTokenCache::SlotCount);
+
+    // The map still has every token.
+    fake.loader.LoadBatch(ToSpan(paths));
+    RED4EXT_CHECK(GetLoaderBackend().requests.size() == paths.size());
+}
+
+RED4EXT_TEST(ResourceTokenCache_ConcurrentFindAndStore)
+{
+    Setup();
+    FakeLoader fake;
+
+    constexpr uint32_t PathCount = 4 * ResourceTokenCache::SlotCount;
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t Iterations = 20000;
+
+    std::vector<ResourcePath> paths;
+    for (uint32_t i = 0; i < PathCount; ++i)
+    {
+        paths.push_back(GetPath(i));
+    }
+
+    auto batch = fake.loader.LoadBatch(ToSpan(paths));
+    RED4EXT_REQUIRE(batch.tokens.size() == PathCount);
+
+    std::atomic<uint32_t> mismatches = 0;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                for (uint32_t i = 0; i < Iterations; ++i)
+                {
+                    auto index = (i * 7919 + t * 104729) % PathCount;
+                    if (i % 4 == t % 4)
+                    {
+                        ResourceTokenCache::Store(batch.tokens[index]);
+                        continue;
+                    }
+
+                    auto path = batch.paths[index];
+                    auto token = ResourceTokenCache::Find(path);
+                    if (token && token->path != path)
+                    {
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    RED4EXT_CHECK(mismatches.load() == 0);
+
+    // The lookups did not leak references.
+    ResourceTokenCache::Invalidate();
+    for (const auto& token : batch.tokens)
+    {
+        RED4EXT_CHECK(token.GetUseCount() == 2); // The batch and the loading list.
+    }
+}
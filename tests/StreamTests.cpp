@@ -0,0 +1,272 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/IO/BufferedWriteStream.hpp>
+#include <RED4ext/IO/MappedFileStream.hpp>
+#include <RED4ext/IO/MemoryStream.hpp>
+#include <RED4ext/Memory/Allocators.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// Records what is written to it and how often it is flushed.
+struct RecordingStream : BaseStream
+{
+    void* ReadWrite(void* aBuffer, uint32_t aLength) override
+    {
+        auto data = static_cast<const uint8_t*>(aBuffer);
+        bytes.insert(bytes.end(), data, data + aLength);
+        writes++;
+        return aBuffer;
+    }
+
+    size_t GetPointerPosition() override
+    {
+        return bytes.size();
+    }
+
+    size_t GetLength() override
+    {
+        return bytes.size();
+    }
+
+    bool Seek(size_t) override
+    {
+        return false;
+    }
+
+    bool Flush() override
+    {
+        flushes++;
+        return true;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint32_t writes = 0;
+    uint32_t flushes = 0;
+};
+
+struct Record
+{
+    uint32_t id;
+    float value;
+};
+
+std::vector<uint8_t> MakeBytes(size_t aCount)
+{
+    std::vector<uint8_t> bytes(aCount);
+    std::iota(bytes.begin(), bytes.end(), static_cast<uint8_t>(0));
+    return bytes;
+}
+
+// A file in the temporary directory that is removed at the end of the test.
+struct TemporaryFile
+{
+    explicit TemporaryFile(const char* aName)
+        : path(std::filesystem::temp_directory_path() / aName)
+    {
+    }
+
+    ~TemporaryFile()
+    {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    std::filesystem::path path;
+};
+} // namespace
+
+RED4EXT_TEST(BufferedWriteStream_CombinesSmallWrites)
+{
+    RecordingStream target;
+    auto bytes = MakeBytes(1000);
+
+    {
+        BufferedWriteStream stream(target, 64);
+        RED4EXT_CHECK(stream.IsWriting() && !stream.IsReading());
+
+        for (size_t i = 0; i < bytes.size(); i += 10)
+        {
+            RED4EXT_CHECK(stream.ReadWrite(bytes.data() + i, 10) != nullptr);
+        }
+
+        RED4EXT_CHECK(stream.GetPointerPosition() == bytes.size());
+
+        // Every 60 bytes the buffer is full and written through, only the last 40 bytes are still pending.
+        RED4EXT_CHECK(target.writes == 16);
+        RED4EXT_CHECK(target.bytes.size() == 960);
+
+        // The target is only flushed on request.
+        RED4EXT_CHECK(target.flushes == 0);
+    }
+
+    // The destructor writes the rest and flushes the target.
+    RED4EXT_CHECK(target.bytes == bytes);
+    RED4EXT_CHECK(target.flushes == 1);
+}
+
+RED4EXT_TEST(BufferedWriteStream_Flush)
+{
+    RecordingStream target;
+    BufferedWriteStream stream(target, 64);
+
+    Record record{1, 2.0f};
+    stream.ReadWriteEx(&record);
+    RED4EXT_CHECK(target.bytes.empty());
+
+    RED4EXT_CHECK(stream.Flush());
+    RED4EXT_CHECK(target.bytes.size() == sizeof(Record));
+    RED4EXT_CHECK(target.flushes == 1);
+
+    // Nothing is pending, only the target is flushed.
+    RED4EXT_CHECK(stream.Flush());
+    RED4EXT_CHECK(target.writes == 1);
+    RED4EXT_CHECK(target.flushes == 2);
+}
+
+RED4EXT_TEST(BufferedWriteStream_LargeWritesBypassBuffer)
+{
+    RecordingStream target;
+    auto bytes = MakeBytes(200);
+
+    BufferedWriteStream stream(target, 64);
+    stream.ReadWrite(bytes.data(), 10);
+    stream.ReadWrite(bytes.data() + 10, 190);
+
+    // The pending bytes are written first, then the large write as a whole.
+    RED4EXT_CHECK(target.writes == 2);
+    RED4EXT_CHECK(target.bytes == bytes);
+    RED4EXT_CHECK(target.flushes == 0);
+    RED4EXT_CHECK(stream.GetLength() == 200);
+}
+
+RED4EXT_TEST(BufferedWriteStream_File)
+{
+    TemporaryFile file("RED4ext.BufferedWriteStream.bin");
+    auto bytes = MakeBytes(100000);
+
+    {
+        BufferedWriteStream stream(file.path, 4096);
+        RED4EXT_REQUIRE(stream.IsOpen());
+
+        for (size_t i = 0; i < bytes.size(); i += 100)
+        {
+            stream.ReadWrite(bytes.data() + i, 100);
+        }
+
+        RED4EXT_CHECK(!stream.HasError());
+    }
+
+    MappedFileStream stream(file.path);
+    RED4EXT_REQUIRE(stream.IsOpen());
+    RED4EXT_REQUIRE(stream.GetLength() == bytes.size());
+    RED4EXT_CHECK(std::memcmp(stream.GetData(), bytes.data(), bytes.size()) == 0);
+}
+
+RED4EXT_TEST(MappedFileStream_Read)
+{
+    TemporaryFile file("RED4ext.MappedFileStream.bin");
+
+    std::vector<Record> records;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        records.push_back({i, static_cast<float>(i) * 0.5f});
+    }
+
+    {
+        BufferedWriteStream stream(file.path);
+        stream.ReadWriteSpan(records.data(), static_cast<uint32_t>(records.size()));
+    }
+
+    MappedFileStream stream(file.path);
+    RED4EXT_REQUIRE(stream.IsOpen());
+    RED4EXT_CHECK(stream.IsReading() && !stream.IsWriting());
+    RED4EXT_CHECK(stream.GetFileName() != nullptr);
+
+    Record first{};
+    stream.ReadWriteEx(&first);
+    RED4EXT_CHECK(first.id == 0);
+
+    // Peek does not advance the stream.
+    RED4EXT_REQUIRE(stream.Peek(sizeof(Record)) != nullptr);
+    RED4EXT_CHECK(stream.Peek(sizeof(Record)) == stream.GetData() + sizeof(Record));
+    RED4EXT_CHECK(stream.GetPointerPosition() == sizeof(Record));
+
+    auto span = stream.ReadSpan<Record>(99);
+    RED4EXT_REQUIRE(span.GetSize() == 99);
+    RED4EXT_CHECK(span[98].id == 99);
+    RED4EXT_CHECK(span[98].value == 49.5f);
+    RED4EXT_CHECK(stream.GetRemaining() == 0);
+    RED4EXT_CHECK(!stream.HasError());
+
+    // Reading past the end fails without advancing.
+    RED4EXT_CHECK(stream.Peek(1) == nullptr);
+    RED4EXT_CHECK(stream.ReadSpan<Record>(1).IsEmpty());
+    RED4EXT_CHECK(stream.HasError());
+
+    stream.Close();
+    RED4EXT_CHECK(!stream.IsOpen());
+    RED4EXT_CHECK(!MappedFileStream(file.path / "missing").IsOpen());
+}
+
+RED4EXT_TEST(MemoryStream_Read)
+{
+    Record records[] = {{1, 1.0f}, {2, 2.0f}, {3, 3.0f}};
+
+    MemoryStream stream(records, sizeof(records));
+    RED4EXT_CHECK(stream.IsReading() && !stream.IsWriting());
+
+    Record first{};
+    RED4EXT_CHECK(stream.ReadWriteEx(&first) != nullptr);
+    RED4EXT_CHECK(first.id == 1);
+
+    auto span = stream.ReadSpan<Record>(2);
+    RED4EXT_REQUIRE(span.GetSize() == 2);
+    RED4EXT_CHECK(span.begin() == &records[1]);
+    RED4EXT_CHECK(span[1].id == 3);
+
+    RED4EXT_CHECK(stream.ReadWriteEx(&first) == nullptr);
+    RED4EXT_CHECK(stream.HasError());
+}
+
+RED4EXT_TEST(MemoryStream_WriteGrowsBuffer)
+{
+    RawBuffer buffer;
+    buffer.Initialize(Memory::DefaultAllocator::Get(), 16);
+
+    {
+        MemoryStream stream(buffer, true);
+        RED4EXT_CHECK(stream.IsWriting() && !stream.IsReading());
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            Record record{i, 0.0f};
+            RED4EXT_CHECK(stream.ReadWriteEx(&record) != nullptr);
+        }
+
+        RED4EXT_CHECK(stream.GetLength() == 100 * sizeof(Record));
+        RED4EXT_CHECK(stream.Flush());
+        RED4EXT_CHECK(!stream.HasError());
+    }
+
+    // Flush trims the buffer to the written length.
+    RED4EXT_REQUIRE(buffer.size == 100 * sizeof(Record));
+    RED4EXT_CHECK(static_cast<Record*>(buffer.data)[99].id == 99);
+
+    // Memory that the stream does not own can not grow.
+    uint8_t fixed[4];
+    RawBuffer view(fixed, sizeof(fixed));
+    MemoryStream stream(view, true);
+
+    Record record{};
+    RED4EXT_CHECK(stream.ReadWriteEx(&record) == nullptr);
+    RED4EXT_CHECK(stream.HasError());
+}
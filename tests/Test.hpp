@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace RED4ext::Tests
+{
+using TestFunc = void (*)();
+
+struct TestInfo
+{
+    const char* name;
+    TestFunc func;
+};
+
+std::vector<TestInfo>& GetTests();
+void ReportFailure(const char* aFile, int32_t aLine, const char* aExpression);
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* aName, TestFunc aFunc)
+    {
+        GetTests().push_back({aName, aFunc});
+    }
+};
+} // namespace RED4ext::Tests
+
+/**
+ * @brief Defines a test case, it is run by the test executable the file is linked into.
+ *
+ * @example
+ *
+ * RED4EXT_TEST(DynArray_PushBack)
+ * {
+ *     RED4ext::DynArray<int32_t> array;
+ *     array.PushBack(1);
+ *
+ *     RED4EXT_REQUIRE(array.size == 1);
+ *     RED4EXT_CHECK(array[0] == 1);
+ * }
+ */
+#define RED4EXT_TEST(aName)                                                                                            \
+    static void aName();                                                                                               \
+    static const RED4ext::Tests::TestRegistrar aName##_Registrar(#aName, &aName);                                      \
+    static void aName()
+
+/**
+ * @brief Records a failure and continues the test if the expression is false.
+ */
+#define RED4EXT_CHECK(aExpression)                                                                                     \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(aExpression))                                                                                            \
+        {                                                                                                              \
+            RED4ext::Tests::ReportFailure(__FILE__, __LINE__, #aExpression);                                           \
+        }                                                                                                              \
+    } while (false)
+
+/**
+ * @brief Records a failure and leaves the test if the expression is false.
+ */
+#define RED4EXT_REQUIRE(aExpression)                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(aExpression))                                                                                            \
+        {                                                                                                              \
+            RED4ext::Tests::ReportFailure(__FILE__, __LINE__, #aExpression);                                           \
+            return;                                                                                                    \
+        }                                                                                                              \
+    } while (false)
@@ -0,0 +1,365 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/IO/MemoryStream.hpp>
+#include <RED4ext/Trace/TraceDecoder.hpp>
+#include <RED4ext/Trace/TraceWriter.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+enum class Stage : int8_t
+{
+    Late = -2
+};
+
+std::vector<uint8_t> ToBytes(const DataBuffer& aBuffer)
+{
+    auto data = static_cast<const uint8_t*>(aBuffer.buffer.data);
+    return {data, data + aBuffer.buffer.size};
+}
+
+std::string Decode(const std::vector<uint8_t>& aTrace, TraceDecoder::OutputFormat aFormat, bool* aIsValid = nullptr)
+{
+    TraceDecoder decoder;
+    if (!decoder.Load(aTrace.data(), aTrace.size()))
+    {
+        return "not a trace";
+    }
+
+    std::ostringstream out;
+    auto isValid = decoder.Decode(out, aFormat);
+    if (aIsValid)
+    {
+        *aIsValid = isValid;
+    }
+
+    return out.str();
+}
+
+std::vector<std::string> SplitLines(const std::string& aText)
+{
+    std::vector<std::string> lines;
+    std::istringstream in(aText);
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+// The message of a text line, after the time, the thread and the phase.
+std::string GetMessage(const std::string& aLine)
+{
+    auto thread = aLine.find("] ");
+    return thread == std::string::npos ? std::string() : aLine.substr(thread + 4);
+}
+
+// A trace written by hand after the description in TraceFormat.hpp.
+struct TraceBuilder
+{
+    TraceBuilder()
+    {
+        uint8_t header[8] = {};
+        std::memcpy(header, &Detail::TraceMagic, sizeof(Detail::TraceMagic));
+        std::memcpy(header + 4, &Detail::TraceVersion, sizeof(Detail::TraceVersion));
+        bytes.assign(header, header + sizeof(header));
+    }
+
+    void AddBlock(TraceBlockKind aKind, const std::vector<uint8_t>& aPayload)
+    {
+        bytes.push_back(static_cast<uint8_t>(aKind));
+        AddVarInt(bytes, aPayload.size());
+        bytes.insert(bytes.end(), aPayload.begin(), aPayload.end());
+    }
+
+    static void AddVarInt(std::vector<uint8_t>& aOut, uint64_t aValue)
+    {
+        uint8_t buffer[Detail::MaxVarIntSize];
+        aOut.insert(aOut.end(), buffer, Detail::WriteVarInt(buffer, aValue));
+    }
+
+    static void AddText(std::vector<uint8_t>& aOut, const char* aText)
+    {
+        AddVarInt(aOut, std::strlen(aText));
+        aOut.insert(aOut.end(), aText, aText + std::strlen(aText));
+    }
+
+    std::vector<uint8_t> bytes;
+};
+} // namespace
+
+RED4EXT_TEST(Trace_RoundTrip)
+{
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+        TraceWriter writer(stream, TraceWriter::DefaultChunkSize, false);
+
+        Vector4 position{1.0f, -2.5f, 0.0f, 1.0f};
+        const char* nullString = nullptr;
+
+        writer.Event("ints {} {} {} {}", int32_t{-1}, uint64_t{UINT64_MAX}, int64_t{INT64_MIN}, Stage::Late);
+        writer.Event("floats {} {}", 0.5f, 1.0 / 3.0);
+        writer.Event("flags {} {}", true, false);
+        writer.Event("text '{}' '{}' '{}'", "quoted \"value\"", "", nullString);
+        writer.Event("ids {} {} {}", CName(0x1234ull), TweakDBID(0xDEADBEEFull), ResourcePath(0xABCDull));
+        writer.Event("position {}", position);
+        writer.Event("missing {} {}", 7);
+        writer.Event("no placeholders", 1, 2);
+
+        RED4EXT_CHECK(writer.Flush());
+        RED4EXT_CHECK(!writer.HasError());
+        RED4EXT_CHECK(writer.GetDroppedCount() == 0);
+    }
+
+    auto trace = ToBytes(buffer);
+
+    bool isValid = false;
+    auto lines = SplitLines(Decode(trace, TraceDecoder::OutputFormat::Text, &isValid));
+    RED4EXT_CHECK(isValid);
+    RED4EXT_REQUIRE(lines.size() == 8);
+
+    RED4EXT_CHECK(GetMessage(lines[0]) == "ints -1 18446744073709551615 -9223372036854775808 -2");
+    RED4EXT_CHECK(GetMessage(lines[1]) == "floats 0.5 0.3333333333333333");
+    RED4EXT_CHECK(GetMessage(lines[2]) == "flags true false");
+    RED4EXT_CHECK(GetMessage(lines[3]) == "text 'quoted \"value\"' '' ''");
+    RED4EXT_CHECK(GetMessage(lines[4]) == "ids 0000000000001234 DEADBEEF:00:000000 000000000000ABCD");
+    RED4EXT_CHECK(GetMessage(lines[5]) == "position (1, -2.5, 0, 1)");
+
+    // Placeholders without an argument are kept, arguments without a placeholder are not shown.
+    RED4EXT_CHECK(GetMessage(lines[6]) == "missing 7 {}");
+    RED4EXT_CHECK(GetMessage(lines[7]) == "no placeholders");
+
+    RED4EXT_CHECK(lines[0].find(" i ints") != std::string::npos);
+
+    auto json = SplitLines(Decode(trace, TraceDecoder::OutputFormat::JsonLines));
+    RED4EXT_REQUIRE(json.size() == 8);
+
+    RED4EXT_CHECK(json[0].find("\"args\":[-1,18446744073709551615,-9223372036854775808,-2]") != std::string::npos);
+    RED4EXT_CHECK(json[2].find("\"args\":[true,false]") != std::string::npos);
+    RED4EXT_CHECK(json[3].find("\"msg\":\"text 'quoted \\\"value\\\"' '' ''\"") != std::string::npos);
+    RED4EXT_CHECK(json[4].find("\"args\":[\"0000000000001234\",\"DEADBEEF:00:000000\",\"000000000000ABCD\"]") !=
+                  std::string::npos);
+}
+
+RED4EXT_TEST(Trace_Scopes)
+{
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+        TraceWriter writer(stream, TraceWriter::DefaultChunkSize, false);
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            TraceScope scope(writer, "frame {}", i);
+            writer.Event("work");
+        }
+    }
+
+    auto trace = ToBytes(buffer);
+    auto lines = SplitLines(Decode(trace, TraceDecoder::OutputFormat::Text));
+    RED4EXT_REQUIRE(lines.size() == 9);
+
+    RED4EXT_CHECK(lines[0].find(" B frame 0") != std::string::npos);
+    RED4EXT_CHECK(lines[1].find(" i work") != std::string::npos);
+    RED4EXT_CHECK(lines[2].find(" E frame {}") != std::string::npos);
+
+    // The timestamps of a thread do not go backwards.
+    double previous = -1.0;
+    uint32_t backwards = 0;
+    for (const auto& line : lines)
+    {
+        auto time = std::stod(line);
+        backwards += time < previous;
+        previous = time;
+    }
+
+    RED4EXT_CHECK(backwards == 0);
+
+    auto chrome = Decode(trace, TraceDecoder::OutputFormat::ChromeTrace);
+    RED4EXT_CHECK(chrome.starts_with("{\"traceEvents\":["));
+    RED4EXT_CHECK(chrome.ends_with("\n]}\n"));
+    RED4EXT_CHECK(chrome.find("{\"ph\":\"B\",") != std::string::npos);
+    RED4EXT_CHECK(chrome.find("\"s\":\"t\"") != std::string::npos);
+}
+
+RED4EXT_TEST(Trace_Threads)
+{
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t Count = 5000;
+
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+
+        // Small chunks, every thread writes many of them while the others record.
+        TraceWriter writer(stream, 1024, false);
+
+        std::vector<std::thread> threads;
+        for (uint32_t thread = 0; thread < ThreadCount; ++thread)
+        {
+            threads.emplace_back(
+                [&writer, thread]
+                {
+                    for (uint32_t i = 0; i < Count; ++i)
+                    {
+                        writer.Event("{} {}", thread, i);
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        RED4EXT_CHECK(writer.GetDroppedCount() == 0);
+    }
+
+    auto trace = ToBytes(buffer);
+
+    TraceDecoder decoder;
+    RED4EXT_REQUIRE(decoder.Load(trace.data(), trace.size()));
+    RED4EXT_CHECK(decoder.GetChunkCount() > ThreadCount);
+
+    auto lines = SplitLines(Decode(trace, TraceDecoder::OutputFormat::Text));
+    RED4EXT_REQUIRE(lines.size() == ThreadCount * Count);
+
+    uint32_t next[ThreadCount] = {};
+    uint32_t mismatches = 0;
+
+    for (const auto& line : lines)
+    {
+        uint32_t thread = 0;
+        uint32_t index = 0;
+        if (std::sscanf(GetMessage(line).c_str(), "%u %u", &thread, &index) != 2 || thread >= ThreadCount ||
+            index != next[thread]++)
+        {
+            ++mismatches;
+        }
+    }
+
+    RED4EXT_CHECK(mismatches == 0);
+}
+
+RED4EXT_TEST(Trace_DropsOversizedEvents)
+{
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+        TraceWriter writer(stream, 1024, false);
+
+        std::string large(2000, 'x');
+        writer.Event("{}", large.c_str());
+        writer.Event("small");
+
+        RED4EXT_CHECK(writer.GetDroppedCount() == 1);
+    }
+
+    auto lines = SplitLines(Decode(ToBytes(buffer), TraceDecoder::OutputFormat::Text));
+    RED4EXT_REQUIRE(lines.size() == 1);
+    RED4EXT_CHECK(GetMessage(lines[0]) == "small");
+}
+
+RED4EXT_TEST(Trace_ResolvesNamesFromTheTable)
+{
+    TraceBuilder builder;
+
+    std::vector<uint8_t> format;
+    TraceBuilder::AddVarInt(format, 0);
+    format.push_back(static_cast<uint8_t>(TracePhase::Instant));
+    format.push_back(2);
+    format.push_back(static_cast<uint8_t>(TraceArgType::Name));
+    format.push_back(static_cast<uint8_t>(TraceArgType::Name));
+    TraceBuilder::AddText(format, "{} and {}");
+    builder.AddBlock(TraceBlockKind::Format, format);
+
+    uint64_t hash = 0x1111;
+    std::vector<uint8_t> name(reinterpret_cast<uint8_t*>(&hash), reinterpret_cast<uint8_t*>(&hash) + sizeof(hash));
+    TraceBuilder::AddText(name, "Player");
+    builder.AddBlock(TraceBlockKind::Name, name);
+
+    std::vector<uint8_t> chunk;
+    TraceBuilder::AddVarInt(chunk, 3);   // Thread.
+    TraceBuilder::AddVarInt(chunk, 100); // Ticks of the first event.
+    TraceBuilder::AddVarInt(chunk, 0);   // Format id.
+    TraceBuilder::AddVarInt(chunk, 0);   // Ticks since the previous event.
+
+    uint64_t hashes[] = {0x1111, 0x2222};
+    chunk.insert(chunk.end(), reinterpret_cast<uint8_t*>(hashes), reinterpret_cast<uint8_t*>(hashes + 2));
+    builder.AddBlock(TraceBlockKind::Chunk, chunk);
+
+    bool isValid = false;
+    auto lines = SplitLines(Decode(builder.bytes, TraceDecoder::OutputFormat::Text, &isValid));
+    RED4EXT_CHECK(isValid);
+    RED4EXT_REQUIRE(lines.size() == 1);
+
+    // A name without text in the table falls back to its hash.
+    RED4EXT_CHECK(GetMessage(lines[0]) == "Player and 0000000000002222");
+    RED4EXT_CHECK(lines[0].find("[3]") != std::string::npos);
+}
+
+RED4EXT_TEST(Trace_DamagedTraces)
+{
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+        TraceWriter writer(stream, 256, false);
+
+        for (uint32_t i = 0; i < 200; ++i)
+        {
+            writer.Event("event {} {}", i, "text");
+        }
+    }
+
+    auto trace = ToBytes(buffer);
+    auto complete = SplitLines(Decode(trace, TraceDecoder::OutputFormat::Text)).size();
+    RED4EXT_CHECK(complete == 200);
+
+    // A cut off trace keeps the complete blocks in front of the cut.
+    size_t previous = 0;
+    uint32_t growing = 0;
+    for (size_t size = 8; size <= trace.size(); size += 7)
+    {
+        std::vector<uint8_t> cut(trace.begin(), trace.begin() + size);
+        auto count = SplitLines(Decode(cut, TraceDecoder::OutputFormat::Text)).size();
+
+        growing += count >= previous;
+        previous = count;
+    }
+
+    RED4EXT_CHECK(growing == (trace.size() - 8) / 7 + 1);
+
+    // Damaged bytes must not crash the decoder, whatever it makes of them.
+    for (size_t offset = 8; offset < trace.size(); offset += 3)
+    {
+        auto damaged = trace;
+        damaged[offset] ^= 0xA5;
+
+        for (auto format : {TraceDecoder::OutputFormat::Text, TraceDecoder::OutputFormat::JsonLines,
+                            TraceDecoder::OutputFormat::ChromeTrace})
+        {
+            Decode(damaged, format);
+        }
+    }
+
+    std::vector<uint8_t> wrongMagic = trace;
+    wrongMagic[0] ^= 1;
+
+    TraceDecoder decoder;
+    RED4EXT_CHECK(!decoder.Load(wrongMagic.data(), wrongMagic.size()));
+    RED4EXT_CHECK(!decoder.Load(trace.data(), 4));
+}
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <RED4ext/TweakDB.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+struct StandInInt32Type : CBaseRTTIType
+{
+    CName GetName() const override
+    {
+        return "Int32";
+    }
+
+    uint32_t GetSize() const override
+    {
+        return sizeof(int32_t);
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return alignof(int32_t);
+    }
+
+    ERTTIType GetType() const override
+    {
+        return ERTTIType::Fundamental;
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+};
+
+// A type TweakDB has no flat values for.
+struct StandInUnknownType : StandInInt32Type
+{
+    CName GetName() const override
+    {
+        return "Int128";
+    }
+};
+
+// Stands in for the game's TweakDB, only the flats and the flat data buffer are used.
+struct StandInTweakDB
+{
+    static constexpr uint32_t BufferSize = 1024 * 1024;
+
+    StandInTweakDB()
+        : buffer(BufferSize)
+    {
+        db.flats = SortedUniqueArray<TweakDBID>(Memory::DefaultAllocator::Get());
+        db.defaultValues = decltype(db.defaultValues)(Memory::DefaultAllocator::Get());
+
+        db.flatDataBuffer = reinterpret_cast<uintptr_t>(buffer.data());
+        db.staticFlatDataBuffer = db.flatDataBuffer;
+        db.flatDataBufferEnd = db.flatDataBuffer;
+        db.flatDataBufferCapacity = BufferSize;
+    }
+
+    int32_t GetValue(TweakDBID aDBID)
+    {
+        auto it = db.flats.Find(aDBID);
+        if (it == db.flats.end())
+        {
+            return -1;
+        }
+
+        auto flatValue = reinterpret_cast<TweakDB::FlatValue*>(db.flatDataBuffer + it->ToTDBOffset());
+        return *static_cast<int32_t*>(flatValue->GetDataPtr());
+    }
+
+    int32_t GetOffset(TweakDBID aDBID)
+    {
+        auto it = db.flats.Find(aDBID);
+        return it == db.flats.end() ? -1 : it->ToTDBOffset();
+    }
+
+    std::vector<uint64_t> buffer;
+    TweakDB db{};
+};
+
+// The flat value pool is keyed on the TweakDB, share one instance so the pooled offsets stay valid between tests.
+StandInTweakDB& GetTweakDB()
+{
+    static auto tweakDB = new StandInTweakDB();
+    tweakDB->db.flats.Clear();
+    return *tweakDB;
+}
+
+// Flats without a value, their offsets point past the buffer so they are never read.
+TweakDBID MakeFlat(const char* aName, int32_t aOffset)
+{
+    TweakDBID dbid(aName);
+    dbid.SetTDBOffset(0x800000 + aOffset);
+    return dbid;
+}
+} // namespace
+
+RED4EXT_TEST(TweakDBBatch_AddsNewFlatsSorted)
+{
+    auto& tweakDB = GetTweakDB();
+
+    std::mt19937 random(1);
+    TweakDB::Batch batch(&tweakDB.db);
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        TweakDBID dbid(static_cast<uint32_t>(random()), 8);
+        dbid.SetTDBOffset(0x800000);
+        batch.AddFlat(dbid);
+    }
+
+    RED4EXT_CHECK(batch.Commit());
+    RED4EXT_CHECK(tweakDB.db.flats.size == 1000);
+    RED4EXT_CHECK(std::is_sorted(tweakDB.db.flats.begin(), tweakDB.db.flats.end()));
+
+    // The batch is cleared by Commit.
+    RED4EXT_CHECK(!batch.Commit());
+}
+
+RED4EXT_TEST(TweakDBBatch_KeepsExistingFlats)
+{
+    auto& tweakDB = GetTweakDB();
+    tweakDB.db.AddFlat(MakeFlat("Items.A.damage", 1));
+
+    TweakDB::Batch batch(&tweakDB.db);
+    batch.AddFlat(MakeFlat("Items.A.damage", 2));
+    batch.AddFlat(MakeFlat("Items.B.damage", 3));
+
+    std::vector<TweakDBID> duplicates;
+    RED4EXT_CHECK(batch.Commit(&duplicates));
+
+    RED4EXT_CHECK(tweakDB.db.flats.size == 2);
+    RED4EXT_CHECK(tweakDB.GetOffset("Items.A.damage") == 0x800000 + 1);
+    RED4EXT_CHECK(tweakDB.GetOffset("Items.B.damage") == 0x800000 + 3);
+    RED4EXT_CHECK((duplicates == std::vector<TweakDBID>{"Items.A.damage"}));
+}
+
+RED4EXT_TEST(TweakDBBatch_FirstOccurrenceWins)
+{
+    auto& tweakDB = GetTweakDB();
+
+    TweakDB::Batch batch(&tweakDB.db);
+    batch.AddFlat(MakeFlat("Items.C.damage", 1));
+    batch.AddFlat(MakeFlat("Items.D.damage", 2));
+    batch.AddFlat(MakeFlat("Items.C.damage", 3));
+    batch.AddFlat(MakeFlat("Items.C.damage", 4));
+
+    std::vector<TweakDBID> duplicates;
+    RED4EXT_CHECK(batch.Commit(&duplicates));
+
+    RED4EXT_CHECK(tweakDB.db.flats.size == 2);
+    RED4EXT_CHECK(tweakDB.GetOffset("Items.C.damage") == 0x800000 + 1);
+    RED4EXT_CHECK(duplicates.size() == 2);
+}
+
+RED4EXT_TEST(TweakDBBatch_NothingAdded)
+{
+    auto& tweakDB = GetTweakDB();
+    tweakDB.db.AddFlat(MakeFlat("Items.E.damage", 1));
+
+    TweakDB::Batch batch(&tweakDB.db);
+    batch.AddFlat(MakeFlat("Items.E.damage", 2));
+    batch.AddFlat(TweakDBID());
+
+    std::vector<TweakDBID> duplicates;
+    RED4EXT_CHECK(!batch.Commit(&duplicates));
+    RED4EXT_CHECK(tweakDB.db.flats.size == 1);
+    RED4EXT_CHECK(duplicates.size() == 1);
+
+    TweakDB::Batch empty(nullptr);
+    empty.AddFlat(MakeFlat("Items.F.damage", 1));
+    RED4EXT_CHECK(!empty.Commit());
+}
+
+RED4EXT_TEST(TweakDBBatch_CreatesValues)
+{
+    auto& tweakDB = GetTweakDB();
+    StandInInt32Type type;
+
+    int32_t five = 5;
+    int32_t six = 6;
+    int32_t seven = 7;
+
+    TweakDB::Batch batch(&tweakDB.db);
+    batch.AddFlat("Items.G.damage", {&type, &five});
+    batch.AddFlat("Items.H.damage", {&type, &five});
+    batch.AddFlat("Items.I.damage", {&type, &six});
+    batch.AddFlat("Items.G.damage", {&type, &seven});
+    batch.AddFlat("Items.J.damage", {nullptr, &seven});
+
+    std::vector<TweakDBID> duplicates;
+    RED4EXT_CHECK(batch.Commit(&duplicates));
+
+    RED4EXT_CHECK(tweakDB.db.flats.size == 3);
+    RED4EXT_CHECK(tweakDB.GetValue("Items.G.damage") == 5);
+    RED4EXT_CHECK(tweakDB.GetValue("Items.H.damage") == 5);
+    RED4EXT_CHECK(tweakDB.GetValue("Items.I.damage") == 6);
+    RED4EXT_CHECK((duplicates == std::vector<TweakDBID>{"Items.G.damage"}));
+
+    // Equal values are pooled.
+    RED4EXT_CHECK(tweakDB.GetOffset("Items.G.damage") == tweakDB.GetOffset("Items.H.damage"));
+
+    // The values of skipped flats are not written to the buffer.
+    auto bufferEnd = tweakDB.db.flatDataBufferEnd;
+
+    int32_t eight = 8;
+    batch.AddFlat("Items.I.damage", {&type, &eight});
+    RED4EXT_CHECK(!batch.Commit());
+    RED4EXT_CHECK(tweakDB.db.flatDataBufferEnd == bufferEnd);
+    RED4EXT_CHECK(tweakDB.GetValue("Items.I.damage") == 6);
+}
+
+RED4EXT_TEST(TweakDBBatch_ReportsFailures)
+{
+    auto& tweakDB = GetTweakDB();
+    StandInInt32Type type;
+    StandInUnknownType unknownType;
+
+    int32_t five = 5;
+
+    TweakDB::Batch batch(&tweakDB.db);
+    batch.AddFlat("Items.K.damage", {&type, &five});
+    batch.AddFlat("Items.L.damage", {&unknownType, &five});
+
+    // Without any record of the type there is no base hash to create the record from.
+    batch.AddRecord("Items.M", &type);
+
+    std::vector<TweakDBID> duplicates;
+    std::vector<TweakDBID> failed;
+    RED4EXT_CHECK(batch.Commit(&duplicates, &failed));
+
+    RED4EXT_CHECK(duplicates.empty());
+    RED4EXT_CHECK((failed == std::vector<TweakDBID>{"Items.L.damage", "Items.M"}));
+    RED4EXT_CHECK(tweakDB.db.flats.size == 1);
+    RED4EXT_CHECK(tweakDB.GetValue("Items.K.damage") == 5);
+    RED4EXT_CHECK(tweakDB.GetOffset("Items.L.damage") == -1);
+}
+
+RED4EXT_TEST(TweakDBBatch_MatchesAddFlat)
+{
+    auto& tweakDB = GetTweakDB();
+
+    std::mt19937 random(2);
+    std::vector<TweakDBID> sequence;
+    for (auto i = 0; i < 2000; ++i)
+    {
+        // Few distinct names, most of them are added more than once.
+        TweakDBID dbid(static_cast<uint32_t>(random() % 500 + 1), 8);
+        dbid.SetTDBOffset(0x800000 + i);
+        sequence.push_back(dbid);
+    }
+
+    for (const auto& dbid : sequence)
+    {
+        tweakDB.db.AddFlat(dbid);
+    }
+
+    std::vector<TweakDBID> expected(tweakDB.db.flats.begin(), tweakDB.db.flats.end());
+
+    tweakDB.db.flats.Clear();
+
+    TweakDB::Batch batch(&tweakDB.db);
+    batch.Reserve(static_cast<uint32_t>(sequence.size()), 0);
+    for (const auto& dbid : sequence)
+    {
+        batch.AddFlat(dbid);
+    }
+
+    std::vector<TweakDBID> duplicates;
+    RED4EXT_CHECK(batch.Commit(&duplicates));
+
+    RED4EXT_REQUIRE(tweakDB.db.flats.size == expected.size());
+    RED4EXT_CHECK(duplicates.size() == sequence.size() - expected.size());
+
+    // Compare the offsets too, operator== only compares the names.
+    for (uint32_t i = 0; i < expected.size(); ++i)
+    {
+        RED4EXT_CHECK(tweakDB.db.flats.entries[i].value == expected[i].value);
+    }
+}
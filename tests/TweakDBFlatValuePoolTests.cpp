@@ -0,0 +1,231 @@
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <RED4ext/TweakDB.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+struct StandInType : CBaseRTTIType
+{
+    StandInType(CName aName, uint32_t aSize, uint32_t aAlignment)
+        : name(aName)
+        , size(aSize)
+        , alignment(aAlignment)
+    {
+    }
+
+    CName GetName() const override
+    {
+        return name;
+    }
+
+    uint32_t GetSize() const override
+    {
+        return size;
+    }
+
+    uint32_t GetAlignment() const override
+    {
+        return alignment;
+    }
+
+    ERTTIType GetType() const override
+    {
+        return ERTTIType::Fundamental;
+    }
+
+    void Construct(ScriptInstance) const override {}
+    void Destruct(ScriptInstance) const override {}
+
+    const bool IsEqual(const ScriptInstance, const ScriptInstance, uint32_t) override
+    {
+        return false;
+    }
+
+    void Assign(ScriptInstance, const ScriptInstance) const override {}
+
+    bool Unserialize(BaseStream*, ScriptInstance, int64_t) const override
+    {
+        return false;
+    }
+
+    CName name;
+    uint32_t size;
+    uint32_t alignment;
+};
+
+struct Types
+{
+    StandInType int32{"Int32", 4, 4};
+    StandInType float32{"Float", 4, 4};
+    StandInType cname{"CName", 8, 8};
+    StandInType tweakDBID{"TweakDBID", 8, 8};
+    StandInType int32Array{"array:Int32", sizeof(DynArray<int32_t>), 8};
+};
+
+// Stands in for the game's TweakDB, only the flats and the flat data buffer are used.
+struct StandInTweakDB
+{
+    static constexpr uint32_t BufferSize = 1024 * 1024;
+
+    StandInTweakDB()
+        : buffer(BufferSize / sizeof(uint64_t))
+    {
+        db.flats = SortedUniqueArray<TweakDBID>(Memory::DefaultAllocator::Get());
+        db.defaultValues = decltype(db.defaultValues)(Memory::DefaultAllocator::Get());
+
+        db.flatDataBuffer = reinterpret_cast<uintptr_t>(buffer.data());
+        db.staticFlatDataBuffer = db.flatDataBuffer;
+        db.flatDataBufferEnd = db.flatDataBuffer;
+        db.flatDataBufferCapacity = BufferSize;
+    }
+
+    template<typename T>
+    T& GetData(int32_t aOffset)
+    {
+        auto flatValue = reinterpret_cast<TweakDB::FlatValue*>(db.flatDataBuffer + aOffset);
+        return *static_cast<T*>(flatValue->GetDataPtr());
+    }
+
+    std::vector<uint64_t> buffer;
+    TweakDB db{};
+};
+
+// The pool is keyed on the address of the TweakDB, keep every instance alive so no address is reused.
+StandInTweakDB& CreateTweakDB()
+{
+    static std::vector<std::unique_ptr<StandInTweakDB>> instances;
+    instances.emplace_back(new StandInTweakDB());
+    return *instances.back();
+}
+
+DynArray<int32_t> MakeArray(std::initializer_list<int32_t> aValues)
+{
+    DynArray<int32_t> array(Memory::DefaultAllocator::Get());
+    for (auto value : aValues)
+    {
+        array.PushBack(value);
+    }
+
+    return array;
+}
+} // namespace
+
+RED4EXT_TEST(TweakDBFlatValuePool_ReusesEqualValues)
+{
+    auto& tweakDB = CreateTweakDB();
+    Types types;
+
+    int32_t five = 5;
+    int32_t otherFive = 5;
+    int32_t six = 6;
+
+    auto first = tweakDB.db.CreateFlatValue({&types.int32, &five});
+    auto second = tweakDB.db.CreateFlatValue({&types.int32, &otherFive});
+    auto third = tweakDB.db.CreateFlatValue({&types.int32, &six});
+
+    RED4EXT_REQUIRE(first != -1 && third != -1);
+    RED4EXT_CHECK(first == second);
+    RED4EXT_CHECK(first != third);
+    RED4EXT_CHECK(tweakDB.GetData<int32_t>(first) == 5);
+    RED4EXT_CHECK(tweakDB.GetData<int32_t>(third) == 6);
+
+    auto stats = tweakDB.db.GetFlatValuePoolStats();
+    RED4EXT_CHECK(stats.pooledValues == 2);
+    RED4EXT_CHECK(stats.reusedValues == 1);
+    RED4EXT_CHECK(stats.bytesSaved == 16);
+}
+
+RED4EXT_TEST(TweakDBFlatValuePool_PartitionsByType)
+{
+    auto& tweakDB = CreateTweakDB();
+    Types types;
+
+    // The same bytes as different types are different values.
+    int32_t integer = 1;
+    float number;
+    std::memcpy(&number, &integer, sizeof(number));
+
+    auto first = tweakDB.db.CreateFlatValue({&types.int32, &integer});
+    auto second = tweakDB.db.CreateFlatValue({&types.float32, &number});
+    RED4EXT_CHECK(first != second);
+
+    CName name = "Items.Preset_Ajax_Default";
+    TweakDBID dbid(name.hash);
+
+    auto third = tweakDB.db.CreateFlatValue({&types.cname, &name});
+    auto fourth = tweakDB.db.CreateFlatValue({&types.tweakDBID, &dbid});
+    RED4EXT_CHECK(third != fourth);
+
+    CName sameName = "Items.Preset_Ajax_Default";
+    RED4EXT_CHECK(tweakDB.db.CreateFlatValue({&types.cname, &sameName}) == third);
+}
+
+RED4EXT_TEST(TweakDBFlatValuePool_ComparesArrays)
+{
+    auto& tweakDB = CreateTweakDB();
+    Types types;
+
+    // Creating a value takes over the array's storage, every value needs its own array.
+    auto array = MakeArray({1, 2, 3});
+    auto equal = MakeArray({1, 2, 3});
+    auto differentElement = MakeArray({1, 2, 4});
+    auto shorter = MakeArray({1, 2});
+
+    auto first = tweakDB.db.CreateFlatValue({&types.int32Array, &array});
+    RED4EXT_REQUIRE(first != -1);
+
+    RED4EXT_CHECK(tweakDB.db.CreateFlatValue({&types.int32Array, &equal}) == first);
+    RED4EXT_CHECK(tweakDB.db.CreateFlatValue({&types.int32Array, &differentElement}) != first);
+    RED4EXT_CHECK(tweakDB.db.CreateFlatValue({&types.int32Array, &shorter}) != first);
+
+    const auto& stored = tweakDB.GetData<DynArray<int32_t>>(first);
+    RED4EXT_REQUIRE(stored.size == 3);
+    RED4EXT_CHECK(stored[2] == 3);
+}
+
+RED4EXT_TEST(TweakDBFlatValuePool_IndexesExistingValues)
+{
+    auto& tweakDB = CreateTweakDB();
+    Types types;
+
+    int32_t value = 42;
+    auto offset = tweakDB.db.CreateFlatValue({&types.int32, &value});
+    RED4EXT_REQUIRE(offset != -1);
+
+    TweakDBID dbid("Items.Existing.value");
+    dbid.SetTDBOffset(offset);
+    tweakDB.db.AddFlat(dbid);
+
+    // Using another TweakDB drops the index, it is rebuilt from the flats of the buffer on the next use.
+    auto& other = CreateTweakDB();
+    other.db.CreateFlatValue({&types.int32, &value});
+
+    RED4EXT_CHECK(tweakDB.db.CreateFlatValue({&types.int32, &value}) == offset);
+
+    auto stats = tweakDB.db.GetFlatValuePoolStats();
+    RED4EXT_CHECK(stats.pooledValues == 1);
+    RED4EXT_CHECK(stats.reusedValues == 1);
+}
+
+RED4EXT_TEST(TweakDBFlatValuePool_ComparesCurrentData)
+{
+    auto& tweakDB = CreateTweakDB();
+    Types types;
+
+    int32_t value = 7;
+    auto offset = tweakDB.db.CreateFlatValue({&types.int32, &value});
+    RED4EXT_REQUIRE(offset != -1);
+
+    // A value modified in place no longer matches its old hash's content.
+    tweakDB.GetData<int32_t>(offset) = 8;
+
+    auto created = tweakDB.db.CreateFlatValue({&types.int32, &value});
+    RED4EXT_CHECK(created != offset);
+    RED4EXT_CHECK(tweakDB.GetData<int32_t>(created) == 7);
+}
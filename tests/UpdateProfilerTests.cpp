@@ -0,0 +1,230 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <RED4ext/Buffer.hpp>
+#include <RED4ext/IO/MemoryStream.hpp>
+#include <RED4ext/JobQueue.hpp>
+#include <RED4ext/Trace/TraceDecoder.hpp>
+#include <RED4ext/UpdateProfiler.hpp>
+
+#include "Test.hpp"
+
+namespace
+{
+using namespace RED4ext;
+
+// The profiled callbacks do not use the frame's job queue, it only has to be a reference.
+struct FakeFrame
+{
+    FakeFrame()
+    {
+        info.deltaTime = 1.0f / 60.0f;
+        info.details = &details;
+    }
+
+    JobQueue& GetJobQueue()
+    {
+        return *reinterpret_cast<JobQueue*>(storage);
+    }
+
+    FrameDetailedInfo details{};
+    FrameInfo info{};
+    alignas(JobQueue) std::byte storage[sizeof(JobQueue)] = {};
+};
+
+void Spin(std::chrono::microseconds aDuration)
+{
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < aDuration)
+    {
+    }
+}
+
+const UpdateProfiler::Timing* Find(const std::vector<UpdateProfiler::Timing>& aTimings, const char* aName)
+{
+    for (const auto& timing : aTimings)
+    {
+        if (std::string(timing.name) == aName)
+        {
+            return &timing;
+        }
+    }
+
+    return nullptr;
+}
+} // namespace
+
+RED4EXT_TEST(UpdateProfiler_GroupUpdate)
+{
+    FakeFrame frame;
+
+    uint32_t calls = 0;
+    auto callback = UpdateProfiler::Wrap(UpdateTickGroup::PreRenderUpdate, "spin 200us",
+                                         [&calls](FrameInfo& aFrame, JobQueue&)
+                                         {
+                                             calls += aFrame.deltaTime > 0.0f;
+                                             Spin(std::chrono::microseconds(200));
+                                         });
+
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        UpdateProfiler::NextFrame();
+        callback(frame.info, frame.GetJobQueue());
+    }
+
+    UpdateProfiler::NextFrame();
+    RED4EXT_CHECK(calls == 20);
+
+    auto stats = UpdateProfiler::GetNameStats("spin 200us");
+    RED4EXT_CHECK(stats.frames == 20);
+    RED4EXT_CHECK(stats.min <= stats.avg && stats.avg <= stats.p99 && stats.p99 <= stats.max);
+
+    // The ticks are converted with the rate measured between the frames, a wide margin is left for a busy machine.
+    RED4EXT_CHECK(stats.min >= 150000);
+    RED4EXT_CHECK(stats.avg < 50000000);
+
+    auto group = UpdateProfiler::GetGroupStats(UpdateTickGroup::PreRenderUpdate);
+    RED4EXT_CHECK(group.frames == 20);
+    RED4EXT_CHECK(group.max == stats.max);
+
+    auto timings = UpdateProfiler::GetTimings();
+    auto timing = Find(timings, "spin 200us");
+    RED4EXT_REQUIRE(timing != nullptr);
+    RED4EXT_CHECK(!timing->isBucketUpdate);
+    RED4EXT_CHECK(timing->group == UpdateTickGroup::PreRenderUpdate);
+    RED4EXT_CHECK(timing->stats.frames == 20);
+}
+
+RED4EXT_TEST(UpdateProfiler_BucketUpdates)
+{
+    FakeFrame frame;
+
+    std::atomic<uint32_t> calls = 0;
+    auto callback = UpdateProfiler::Wrap(UpdateBucketMask::Everything, UpdateBucketStage::AnimationUpdate,
+                                         "bucket spin",
+                                         [&calls](UpdateBucketEnum, FrameInfo&, JobQueue&)
+                                         {
+                                             calls.fetch_add(1, std::memory_order_relaxed);
+                                             Spin(std::chrono::microseconds(50));
+                                         });
+
+    constexpr uint32_t Frames = 10;
+    constexpr uint32_t BucketCount = static_cast<uint32_t>(UpdateBucketEnum::BucketCount);
+
+    for (uint32_t i = 0; i < Frames; ++i)
+    {
+        UpdateProfiler::NextFrame();
+
+        // The buckets run in parallel, each on its own thread.
+        std::vector<std::thread> threads;
+        for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            threads.emplace_back([&, bucket]
+                                 { callback(static_cast<UpdateBucketEnum>(bucket), frame.info, frame.GetJobQueue()); });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    UpdateProfiler::NextFrame();
+    RED4EXT_CHECK(calls == Frames * BucketCount);
+
+    // Every frame holds the time of all three buckets.
+    auto stats = UpdateProfiler::GetStageStats(UpdateBucketStage::AnimationUpdate);
+    RED4EXT_CHECK(stats.frames == Frames);
+    RED4EXT_CHECK(stats.min >= 3 * 40000);
+
+    auto timings = UpdateProfiler::GetTimings();
+    auto timing = Find(timings, "bucket spin");
+    RED4EXT_REQUIRE(timing != nullptr);
+    RED4EXT_CHECK(timing->isBucketUpdate);
+    RED4EXT_CHECK(timing->buckets == UpdateBucketMask::Everything);
+    RED4EXT_CHECK(timing->stage == UpdateBucketStage::AnimationUpdate);
+}
+
+RED4EXT_TEST(UpdateProfiler_Window)
+{
+    FakeFrame frame;
+
+    auto callback = UpdateProfiler::Wrap(UpdateTickGroup::PreRenderUpdate, "window", [](FrameInfo&, JobQueue&) {});
+
+    // Frames before the registration are not part of its statistics.
+    RED4EXT_CHECK(UpdateProfiler::GetNameStats("window").frames == 0);
+
+    for (uint32_t i = 0; i < UpdateProfiler::WindowSize + 10; ++i)
+    {
+        UpdateProfiler::NextFrame();
+        callback(frame.info, frame.GetJobQueue());
+    }
+
+    RED4EXT_CHECK(UpdateProfiler::GetNameStats("window").frames == UpdateProfiler::WindowSize);
+    RED4EXT_CHECK(UpdateProfiler::GetNameStats("unknown name").frames == 0);
+}
+
+RED4EXT_TEST(UpdateProfiler_Disabled)
+{
+    FakeFrame frame;
+
+    uint32_t calls = 0;
+    auto callback = UpdateProfiler::Wrap(UpdateTickGroup::PreRenderUpdate, "disabled",
+                                         [&calls](FrameInfo&, JobQueue&) { ++calls; });
+
+    UpdateProfiler::SetEnabled(false);
+    RED4EXT_CHECK(!UpdateProfiler::IsEnabled());
+
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        UpdateProfiler::NextFrame();
+        callback(frame.info, frame.GetJobQueue());
+    }
+
+    UpdateProfiler::NextFrame();
+    UpdateProfiler::SetEnabled(true);
+
+    // The callback still runs, nothing is recorded.
+    RED4EXT_CHECK(calls == 5);
+    RED4EXT_CHECK(UpdateProfiler::GetNameStats("disabled").max == 0);
+}
+
+RED4EXT_TEST(UpdateProfiler_Trace)
+{
+    FakeFrame frame;
+
+    auto callback = UpdateProfiler::Wrap(UpdateTickGroup::PreRenderUpdate, "ui {hud}", [](FrameInfo&, JobQueue&) {});
+
+    DataBuffer buffer{};
+    {
+        MemoryStream stream(buffer, true);
+        TraceWriter writer(stream, TraceWriter::DefaultChunkSize, false);
+
+        UpdateProfiler::SetTraceWriter(&writer);
+        UpdateProfiler::NextFrame();
+        callback(frame.info, frame.GetJobQueue());
+        UpdateProfiler::SetTraceWriter(nullptr);
+
+        // Not recorded anymore.
+        callback(frame.info, frame.GetJobQueue());
+    }
+
+    TraceDecoder decoder;
+    RED4EXT_REQUIRE(decoder.Load(static_cast<const uint8_t*>(buffer.buffer.data), buffer.buffer.size));
+
+    std::ostringstream out;
+    RED4EXT_CHECK(decoder.Decode(out, TraceDecoder::OutputFormat::Text));
+
+    // The braces of the name are not a placeholder.
+    auto text = out.str();
+    RED4EXT_CHECK(text.find(" i Frame ") != std::string::npos);
+    RED4EXT_CHECK(text.find(" B ui {hud}\n") != std::string::npos);
+    RED4EXT_CHECK(text.find(" E ui {hud}\n") != std::string::npos);
+    RED4EXT_CHECK(text.find(" B ui {hud}\n") == text.rfind(" B ui {hud}\n"));
+}
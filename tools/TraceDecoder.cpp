@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include <RED4ext/Trace/TraceDecoder.hpp>
+
+namespace
+{
+void PrintUsage()
+{
+    std::fprintf(stderr, "Usage: TraceDecoder <trace> [--format text|jsonl|chrome] [--output <file>]\n"
+                         "\n"
+                         "Converts a trace written by RED4ext::TraceWriter, to the standard output by default.\n"
+                         "  text    One line per event: time in microseconds, thread, message (default).\n"
+                         "  jsonl   One JSON object per event with the message and the typed arguments.\n"
+                         "  chrome  A Chrome trace event document for chrome://tracing and Perfetto.\n");
+}
+
+bool ParseFormat(std::string_view aName, RED4ext::TraceDecoder::OutputFormat& aFormat)
+{
+    using OutputFormat = RED4ext::TraceDecoder::OutputFormat;
+
+    if (aName == "text")
+    {
+        aFormat = OutputFormat::Text;
+    }
+    else if (aName == "jsonl")
+    {
+        aFormat = OutputFormat::JsonLines;
+    }
+    else if (aName == "chrome")
+    {
+        aFormat = OutputFormat::ChromeTrace;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+int main(int aArgc, char** aArgv)
+{
+    const char* input = nullptr;
+    const char* output = nullptr;
+    auto format = RED4ext::TraceDecoder::OutputFormat::Text;
+
+    for (int i = 1; i < aArgc; ++i)
+    {
+        std::string_view arg = aArgv[i];
+
+        if (arg == "--format" && i + 1 < aArgc)
+        {
+            if (!ParseFormat(aArgv[++i], format))
+            {
+                std::fprintf(stderr, "Unknown format '%s'.\n\n", aArgv[i]);
+                PrintUsage();
+                return 2;
+            }
+        }
+        else if (arg == "--output" && i + 1 < aArgc)
+        {
+            output = aArgv[++i];
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage();
+            return 0;
+        }
+        else if (!input && !arg.starts_with("--"))
+        {
+            input = aArgv[i];
+        }
+        else
+        {
+            std::fprintf(stderr, "Unexpected argument '%s'.\n\n", aArgv[i]);
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (!input)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    RED4ext::TraceDecoder decoder;
+    if (!decoder.Open(input))
+    {
+        std::fprintf(stderr, "'%s' could not be opened or is not a trace.\n", input);
+        return 1;
+    }
+
+    std::ofstream file;
+    if (output)
+    {
+        file.open(output, std::ios::binary);
+        if (!file)
+        {
+            std::fprintf(stderr, "'%s' could not be created.\n", output);
+            return 1;
+        }
+    }
+
+    std::ostream& out = output ? static_cast<std::ostream&>(file) : std::cout;
+
+    // A malformed event ends the output, everything in front of it was written.
+    auto isValid = decoder.Decode(out, format);
+    out.flush();
+
+    if (!isValid)
+    {
+        std::fprintf(stderr, "The trace contains a malformed event, the output ends in front of it.\n");
+        return 1;
+    }
+
+    if (!out)
+    {
+        std::fprintf(stderr, "The output could not be written.\n");
+        return 1;
+    }
+
+    return 0;
+}